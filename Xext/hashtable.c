@@ -1,6 +1,7 @@
 #include <dix-config.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "dix/resource_priv.h"
 
@@ -11,15 +12,31 @@
 #include "resource.h"
 
 #define INITHASHSIZE 6
-#define MAXHASHSIZE 11
 
+/* slot states; DELETED keeps linear probe runs intact across removals,
+   the same scheme the DIX resource table uses */
+#define SLOT_EMPTY   0
+#define SLOT_DELETED 1
+#define SLOT_LIVE    2
+
+/* Open-addressing hash table with linear probing.  The slots live in
+ * parallel arrays: a probe scans the one-byte states first and only
+ * touches a key on a live slot, and keys are stored inline so neither
+ * costs an allocation or a pointer chase.  Data stays in a per-entry
+ * allocation, so the pointers handed out by ht_add and ht_find remain
+ * valid across a rehash.
+ */
 struct HashTableRec {
     int             keySize;
     int             dataSize;
 
-    int             elements;   /* number of elements inserted */
+    int             elements;   /* live entries */
+    int             occupied;   /* live entries plus deleted slots */
     int             bucketBits; /* number of buckets is 1 << bucketBits */
-    struct xorg_list *buckets;  /* array of bucket list heads */
+
+    unsigned char   *states;
+    char            *keys;      /* numBuckets keys of keySize bytes each */
+    void            **data;     /* NULL if dataSize is 0 */
 
     HashFunc        hash;
     HashCompareFunc compare;
@@ -27,11 +44,25 @@ struct HashTableRec {
     void            *cdata;
 };
 
-typedef struct {
-    struct xorg_list l;
-    void *key;
-    void *data;
-} BucketRec, *BucketPtr;
+#define SlotKey(ht, i) ((ht)->keys + (size_t) (i) * (ht)->keySize)
+
+static Bool
+ht_alloc_slots(HashTable ht, int bucketBits,
+               unsigned char **states, char **keys, void ***data)
+{
+    int numBuckets = 1 << bucketBits;
+
+    *states = calloc(numBuckets, sizeof(**states));
+    *keys = calloc(numBuckets, ht->keySize);
+    *data = ht->dataSize ? calloc(numBuckets, sizeof(**data)) : NULL;
+    if (!*states || !*keys || (ht->dataSize && !*data)) {
+        free(*states);
+        free(*keys);
+        free(*data);
+        return FALSE;
+    }
+    return TRUE;
+}
 
 HashTable
 ht_create(int             keySize,
@@ -40,8 +71,6 @@ ht_create(int             keySize,
           HashCompareFunc compare,
           void            *cdata)
 {
-    int c;
-    int numBuckets;
     HashTable ht = calloc(1, sizeof(struct HashTableRec));
 
     if (!ht) {
@@ -52,151 +81,173 @@ ht_create(int             keySize,
     ht->dataSize = dataSize;
     ht->hash = hash;
     ht->compare = compare;
-    ht->elements = 0;
     ht->bucketBits = INITHASHSIZE;
-    numBuckets = 1 << ht->bucketBits;
-    ht->buckets = calloc(numBuckets, sizeof(*ht->buckets));
     ht->cdata = cdata;
 
-    if (ht->buckets) {
-        for (c = 0; c < numBuckets; ++c) {
-            xorg_list_init(&ht->buckets[c]);
-        }
-        return ht;
-    } else {
+    if (!ht_alloc_slots(ht, ht->bucketBits, &ht->states, &ht->keys,
+                        &ht->data)) {
         free(ht);
         return NULL;
     }
+    return ht;
+}
+
+void
+ht_clear(HashTable ht)
+{
+    int numBuckets = 1 << ht->bucketBits;
+
+    if (ht->data) {
+        for (int c = 0; c < numBuckets; ++c) {
+            if (ht->states[c] == SLOT_LIVE)
+                free(ht->data[c]);
+        }
+        memset(ht->data, 0, numBuckets * sizeof(*ht->data));
+    }
+    memset(ht->states, SLOT_EMPTY, numBuckets);
+    ht->elements = 0;
+    ht->occupied = 0;
 }
 
 void
 ht_destroy(HashTable ht)
 {
-    int c;
-    BucketPtr it, tmp;
     int numBuckets = 1 << ht->bucketBits;
-    for (c = 0; c < numBuckets; ++c) {
-        xorg_list_for_each_entry_safe(it, tmp, &ht->buckets[c], l) {
-            xorg_list_del(&it->l);
-            free(it->key);
-            free(it->data);
-            free(it);
+
+    if (ht->data) {
+        for (int c = 0; c < numBuckets; ++c) {
+            if (ht->states[c] == SLOT_LIVE)
+                free(ht->data[c]);
         }
     }
-    free(ht->buckets);
+    free(ht->states);
+    free(ht->keys);
+    free(ht->data);
     free(ht);
 }
 
 static Bool
-double_size(HashTable ht)
+ht_rehash(HashTable ht)
 {
-    struct xorg_list *newBuckets;
+    unsigned char *states;
+    char *keys;
+    void **data;
     int numBuckets = 1 << ht->bucketBits;
-    int newBucketBits = ht->bucketBits + 1;
-    int newNumBuckets = 1 << newBucketBits;
-    int c;
-
-    newBuckets = calloc(newNumBuckets, sizeof(*ht->buckets));
-    if (newBuckets) {
-        for (c = 0; c < newNumBuckets; ++c) {
-            xorg_list_init(&newBuckets[c]);
-        }
+    int bucketBits = ht->bucketBits;
 
-        for (c = 0; c < numBuckets; ++c) {
-            BucketPtr it, tmp;
-            xorg_list_for_each_entry_safe(it, tmp, &ht->buckets[c], l) {
-                struct xorg_list *newBucket =
-                    &newBuckets[ht->hash(ht->cdata, it->key, newBucketBits)];
-                xorg_list_del(&it->l);
-                xorg_list_add(&it->l, newBucket);
-            }
-        }
-        free(ht->buckets);
+    /* grow when the live load is high; otherwise rehash at the same size
+       just to flush out the deleted slots linear probing leaves behind */
+    if (2 * ht->elements >= numBuckets)
+        bucketBits++;
 
-        ht->buckets = newBuckets;
-        ht->bucketBits = newBucketBits;
-        return TRUE;
-    } else {
+    if (!ht_alloc_slots(ht, bucketBits, &states, &keys, &data)) {
         return FALSE;
     }
+
+    int mask = (1 << bucketBits) - 1;
+    for (int c = 0; c < numBuckets; ++c) {
+        if (ht->states[c] != SLOT_LIVE)
+            continue;
+        int i = ht->hash(ht->cdata, SlotKey(ht, c), bucketBits);
+        while (states[i] != SLOT_EMPTY)
+            i = (i + 1) & mask;
+        states[i] = SLOT_LIVE;
+        memcpy(keys + (size_t) i * ht->keySize, SlotKey(ht, c), ht->keySize);
+        if (data)
+            data[i] = ht->data[c];
+    }
+    free(ht->states);
+    free(ht->keys);
+    free(ht->data);
+
+    ht->states = states;
+    ht->keys = keys;
+    ht->data = data;
+    ht->bucketBits = bucketBits;
+    ht->occupied = ht->elements;
+    return TRUE;
 }
 
 void *
 ht_add(HashTable ht, const void *key)
 {
-    unsigned index = ht->hash(ht->cdata, key, ht->bucketBits);
-    struct xorg_list *bucket = &ht->buckets[index];
-    BucketRec *elem = calloc(1, sizeof(BucketRec));
-    if (!elem) {
-        goto outOfMemory;
-    }
-    elem->key = calloc(1, ht->keySize);
-    if (!elem->key) {
-        goto outOfMemory;
-    }
-    /* we avoid signaling an out-of-memory error if dataSize is 0 */
-    elem->data = calloc(1, ht->dataSize);
-    if (ht->dataSize && !elem->data) {
-        goto outOfMemory;
-    }
-    xorg_list_add(&elem->l, bucket);
-    ++ht->elements;
-
-    memcpy(elem->key, key, ht->keySize);
+    int numBuckets = 1 << ht->bucketBits;
 
-    if (ht->elements > 4 * (1 << ht->bucketBits) &&
-        ht->bucketBits < MAXHASHSIZE) {
-        if (!double_size(ht)) {
-            --ht->elements;
-            xorg_list_del(&elem->l);
-            goto outOfMemory;
+    if (4 * ht->occupied >= 3 * numBuckets) {
+        if (!ht_rehash(ht) && ht->occupied == numBuckets) {
+            /* the rehash failed and every slot is taken */
+            return NULL;
         }
+        numBuckets = 1 << ht->bucketBits;
     }
 
-    /* if memory allocation has failed due to dataSize being 0, return
-       a "dummy" pointer pointing at the of the key */
-    return elem->data ? elem->data : ((char*) elem->key + ht->keySize);
+    int mask = numBuckets - 1;
+    int i = ht->hash(ht->cdata, key, ht->bucketBits);
 
- outOfMemory:
-    if (elem) {
-        free(elem->key);
-        free(elem->data);
-        free(elem);
+    /* duplicate keys are allowed, so just take the first free slot on
+       the probe path */
+    while (ht->states[i] == SLOT_LIVE)
+        i = (i + 1) & mask;
+
+    void *data = NULL;
+    /* we avoid signaling an out-of-memory error if dataSize is 0 */
+    if (ht->dataSize) {
+        data = calloc(1, ht->dataSize);
+        if (!data) {
+            return NULL;
+        }
+        ht->data[i] = data;
     }
+    if (ht->states[i] == SLOT_EMPTY)
+        ht->occupied++;
+    ht->states[i] = SLOT_LIVE;
+    memcpy(SlotKey(ht, i), key, ht->keySize);
+    ++ht->elements;
 
-    return NULL;
+    /* if memory allocation has been skipped due to dataSize being 0,
+       return a "dummy" pointer pointing at the end of the key */
+    return data ? data : (SlotKey(ht, i) + ht->keySize);
 }
 
 void
 ht_remove(HashTable ht, const void *key)
 {
-    unsigned index = ht->hash(ht->cdata, key, ht->bucketBits);
-    struct xorg_list *bucket = &ht->buckets[index];
-    BucketPtr it;
-
-    xorg_list_for_each_entry(it, bucket, l) {
-        if (ht->compare(ht->cdata, key, it->key) == 0) {
-            xorg_list_del(&it->l);
-            --ht->elements;
-            free(it->key);
-            free(it->data);
-            free(it);
-            return;
+    int numBuckets = 1 << ht->bucketBits;
+    int mask = numBuckets - 1;
+    int i = ht->hash(ht->cdata, key, ht->bucketBits);
+
+    for (int probes = numBuckets; probes > 0; probes--, i = (i + 1) & mask) {
+        if (ht->states[i] == SLOT_EMPTY)
+            break;
+        if (ht->states[i] != SLOT_LIVE ||
+            ht->compare(ht->cdata, key, SlotKey(ht, i)) != 0)
+            continue;
+
+        ht->states[i] = SLOT_DELETED;
+        if (ht->data) {
+            free(ht->data[i]);
+            ht->data[i] = NULL;
         }
+        --ht->elements;
+        return;
     }
 }
 
 void *
 ht_find(HashTable ht, const void *key)
 {
-    unsigned index = ht->hash(ht->cdata, key, ht->bucketBits);
-    struct xorg_list *bucket = &ht->buckets[index];
-    BucketPtr it;
+    int numBuckets = 1 << ht->bucketBits;
+    int mask = numBuckets - 1;
+    int i = ht->hash(ht->cdata, key, ht->bucketBits);
 
-    xorg_list_for_each_entry(it, bucket, l) {
-        if (ht->compare(ht->cdata, key, it->key) == 0) {
-            return it->data ? it->data : ((char*) it->key + ht->keySize);
-        }
+    for (int probes = numBuckets; probes > 0; probes--, i = (i + 1) & mask) {
+        if (ht->states[i] == SLOT_EMPTY)
+            break;
+        if (ht->states[i] != SLOT_LIVE ||
+            ht->compare(ht->cdata, key, SlotKey(ht, i)) != 0)
+            continue;
+
+        return ht->data ? ht->data[i] : (SlotKey(ht, i) + ht->keySize);
     }
 
     return NULL;
@@ -205,16 +256,9 @@ ht_find(HashTable ht, const void *key)
 void
 ht_dump_distribution(HashTable ht)
 {
-    int c;
     int numBuckets = 1 << ht->bucketBits;
-    for (c = 0; c < numBuckets; ++c) {
-        BucketPtr it;
-        int n = 0;
-
-        xorg_list_for_each_entry(it, &ht->buckets[c], l) {
-            ++n;
-        }
-        printf("%d: %d\n", c, n);
+    for (int c = 0; c < numBuckets; ++c) {
+        printf("%d: %d\n", c, ht->states[c] == SLOT_LIVE ? 1 : 0);
     }
 }
 
@@ -278,21 +322,13 @@ ht_dump_contents(HashTable ht,
                  void (*print_value)(void *opaque, void *value),
                  void* opaque)
 {
-    int c;
     int numBuckets = 1 << ht->bucketBits;
-    for (c = 0; c < numBuckets; ++c) {
-        BucketPtr it;
-        int n = 0;
-
+    for (int c = 0; c < numBuckets; ++c) {
         printf("%d: ", c);
-        xorg_list_for_each_entry(it, &ht->buckets[c], l) {
-            if (n > 0) {
-                printf(", ");
-            }
-            print_key(opaque, it->key);
+        if (ht->states[c] == SLOT_LIVE) {
+            print_key(opaque, SlotKey(ht, c));
             printf("->");
-            print_value(opaque, it->data);
-            ++n;
+            print_value(opaque, ht->data ? ht->data[c] : NULL);
         }
         printf("\n");
     }
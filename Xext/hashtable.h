@@ -61,6 +61,13 @@ HashTable ht_create(int             keySize,
 */
 void ht_destroy(HashTable ht);
 
+/** @brief  Removes all keys from the hash table along with their
+            associated data, which will be free'd, keeping the bucket
+            storage for reuse. Cheaper than destroying and re-creating
+            the table when tearing down a client's entries in bulk.
+*/
+void ht_clear(HashTable ht);
+
 /** @brief  Adds a new key to the hash table. The key will be copied
             and a pointer to the value will be returned. The data will
             be initialized with zeroes.
@@ -8,15 +8,10 @@
 #include "namespace.h"
 
 struct Xnamespace ns_root = {
-    .allowMouseMotion = TRUE,
-    .allowShape = TRUE,
-    .allowTransparency = TRUE,
-    .allowXInput = TRUE,
-    .allowXKeyboard = TRUE,
+    .allowMask = NS_ALLOW_ALL | NS_SUPERPOWER,
     .builtin = TRUE,
     .name = NS_NAME_ROOT,
     .refcnt = 1,
-    .superPower = TRUE,
 };
 
 struct Xnamespace ns_anon = {
@@ -136,15 +131,15 @@ static void parseLine(char *line, struct Xnamespace **walk_ns)
         while ((token = strtok(NULL, " ")) != NULL)
         {
             if (strcmp(token, "mouse-motion") == 0)
-                curr->allowMouseMotion = TRUE;
+                curr->allowMask |= NS_ALLOW_MOUSE_MOTION;
             else if (strcmp(token, "shape") == 0)
-                curr->allowShape = TRUE;
+                curr->allowMask |= NS_ALLOW_SHAPE;
             else if (strcmp(token, "transparency") == 0)
-                curr->allowTransparency = TRUE;
+                curr->allowMask |= NS_ALLOW_TRANSPARENCY;
             else if (strcmp(token, "xinput") == 0)
-                curr->allowXInput = TRUE;
+                curr->allowMask |= NS_ALLOW_XINPUT;
             else if (strcmp(token, "xkeyboard") == 0)
-                curr->allowXKeyboard = TRUE;
+                curr->allowMask |= NS_ALLOW_XKEYBOARD;
             else
                 XNS_LOG("unknown allow: %s\n", token);
         }
@@ -153,7 +148,7 @@ static void parseLine(char *line, struct Xnamespace **walk_ns)
 
     if (strcmp(token, "superpower") == 0)
     {
-        curr->superPower = TRUE;
+        curr->allowMask |= NS_SUPERPOWER;
         return;
     }
 
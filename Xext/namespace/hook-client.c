@@ -24,7 +24,7 @@ void hookClient(CallbackListPtr *pcbl, void *unused, void *calldata)
     XNS_HOOK_HEAD(ClientAccessCallbackParam);
     struct XnamespaceClientPriv *obj = XnsClientPriv(param->target);
 
-    if (subj->ns->superPower || XnsClientSameNS(subj, obj))
+    if (XnsAllowed(subj->ns, NS_SUPERPOWER) || XnsClientSameNS(subj, obj))
         return;
 
     XNS_HOOK_LOG("BLOCKED access on client %d\n", param->target->index);
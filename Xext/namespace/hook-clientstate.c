@@ -50,6 +50,14 @@ void hookClientDestroy(CallbackListPtr *pcbl, void *unused, void *calldata)
     if (!subj)
         return; /* no XNS devprivate assigned ? */
 
+    /* report the event filter accounting, so the fast-path ratio can be
+       checked in the log */
+    if (subj->ns && (subj->ns->eventsFastPath || subj->ns->eventsFiltered ||
+                     subj->ns->eventsBlocked))
+        XNS_LOG("namespace %s: events fast-path=%lu filtered=%lu blocked=%lu\n",
+            subj->ns->name, subj->ns->eventsFastPath,
+            subj->ns->eventsFiltered, subj->ns->eventsBlocked);
+
     XnamespaceAssignClient(subj, NULL);
     /* the devprivate is embedded, so no free() necessary */
 }
@@ -18,7 +18,7 @@ void hookDevice(CallbackListPtr *pcbl, void *unused, void *calldata)
 {
     XNS_HOOK_HEAD(DeviceAccessCallbackParam);
 
-    if (subj->ns->superPower)
+    if (XnsAllowed(subj->ns, NS_SUPERPOWER))
         goto pass;
 
     // should be safe to pass for anybody
@@ -16,7 +16,7 @@ void hookExtAccess(CallbackListPtr *pcbl, void *unused, void *calldata)
     XNS_HOOK_HEAD(ExtensionAccessCallbackParam);
 
     /* root NS has super powers */
-    if (subj->ns->superPower)
+    if (XnsAllowed(subj->ns, NS_SUPERPOWER))
         goto pass;
 
     switch (param->ext->index + EXTENSION_BASE) {
@@ -43,13 +43,13 @@ void hookExtAccess(CallbackListPtr *pcbl, void *unused, void *calldata)
 
         /* only allowed if namespace has flag set */
         case EXTENSION_MAJOR_SHAPE:
-            if (subj->ns->allowShape)
+            if (XnsAllowed(subj->ns, NS_ALLOW_SHAPE))
                 goto pass;
             goto reject;
 
         /* only allowed if namespace has flag set */
         case EXTENSION_MAJOR_XINPUT:
-            if (subj->ns->allowXInput)
+            if (XnsAllowed(subj->ns, NS_ALLOW_XINPUT))
                 goto pass;
             goto reject;
     }
@@ -23,7 +23,7 @@ void hookExtDispatch(CallbackListPtr *pcbl, void *unused, void *calldata)
     XNS_HOOK_HEAD(ExtensionAccessCallbackParam);
 
     /* root NS has super powers */
-    if (subj->ns->superPower)
+    if (XnsAllowed(subj->ns, NS_SUPERPOWER))
         goto pass;
 
     switch (client->majorOp) {
@@ -39,7 +39,7 @@ void hookExtDispatch(CallbackListPtr *pcbl, void *unused, void *calldata)
 
         /* allow several operations */
         case EXTENSION_MAJOR_XKEYBOARD:
-            if (subj->ns->allowXKeyboard)
+            if (XnsAllowed(subj->ns, NS_ALLOW_XKEYBOARD))
                 goto pass;
             switch (client->minorOp) {
                 case X_kbUseExtension:
@@ -56,11 +56,11 @@ void hookExtDispatch(CallbackListPtr *pcbl, void *unused, void *calldata)
 
         /* allow if namespace has flag set */
         case EXTENSION_MAJOR_SHAPE:
-            if (subj->ns->allowShape)
+            if (XnsAllowed(subj->ns, NS_ALLOW_SHAPE))
                 goto pass;
         break;
         case EXTENSION_MAJOR_XINPUT:
-            if (subj->ns->allowXInput)
+            if (XnsAllowed(subj->ns, NS_ALLOW_XINPUT))
                 goto pass;
             switch (client->minorOp) {
                 case X_ListInputDevices:
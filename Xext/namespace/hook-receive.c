@@ -23,8 +23,10 @@ hookReceive(CallbackListPtr *pcbl, void *unused, void *calldata)
     struct XnamespaceClientPriv *obj = XnsClientPriv(dixClientForWindow(param->pWin));
 
     // send and receive within same namespace permitted without restrictions
-    if (XnsClientSameNS(subj, obj))
-        goto pass;
+    if (XnsClientSameNS(subj, obj)) {
+        subj->ns->eventsFastPath += param->count;
+        return;
+    }
 
     for (int i=0; i<param->count; i++) {
         const int type = param->events[i].u.u.type;
@@ -34,7 +36,7 @@ hookReceive(CallbackListPtr *pcbl, void *unused, void *calldata)
                 if (gev->extension == EXTENSION_MAJOR_XINPUT) {
                     switch (gev->evtype) {
                         case XI_RawMotion:
-                            if ((!subj->ns->allowMouseMotion) || !isRootWin(param->pWin))
+                            if ((!XnsAllowed(subj->ns, NS_ALLOW_MOUSE_MOTION)) || !isRootWin(param->pWin))
                                 goto reject;
                             continue;
                         case XI_RawKeyPress:
@@ -60,9 +62,11 @@ hookReceive(CallbackListPtr *pcbl, void *unused, void *calldata)
     }
 
 pass:
+    subj->ns->eventsFiltered += param->count;
     return;
 
 reject:
+    subj->ns->eventsBlocked += param->count;
     param->status = BadAccess;
     XNS_HOOK_LOG("BLOCKED client %d [NS %s] receiving event sent to window 0x%lx of client %d [NS %s]\n",
         client->index,
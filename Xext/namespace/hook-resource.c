@@ -32,7 +32,7 @@ void hookResourceAccess(CallbackListPtr *pcbl, void *unused, void *calldata)
     if (param->rtype == X11_RESTYPE_WINDOW) {
         WindowPtr pWindow = (WindowPtr) param->res;
         if (param->access_mode & DixCreateAccess) {
-            if (!subj->ns->allowTransparency) {
+            if (!XnsAllowed(subj->ns, NS_ALLOW_TRANSPARENCY)) {
                 pWindow->forcedBG = TRUE;
             }
         }
@@ -34,7 +34,7 @@ void hookSelectionFilter(CallbackListPtr *pcbl, void *unused, void *calldata)
     XNS_HOOK_HEAD(SelectionFilterParamRec);
 
     /* no rewrite if client is in root namespace */
-    if (subj->ns->superPower)
+    if (XnsAllowed(subj->ns, NS_SUPERPOWER))
         return;
 
     const char *origSelectionName = NameForAtom(param->selection);
@@ -17,7 +17,7 @@ static Bool clientAllowedOnClient(ClientPtr subj, ClientPtr obj) {
     struct XnamespaceClientPriv *subjPriv = XnsClientPriv(subj);
     struct XnamespaceClientPriv *objPriv = XnsClientPriv(obj);
 
-    if (subjPriv && subjPriv->ns->superPower)
+    if (subjPriv && XnsAllowed(subjPriv->ns, NS_SUPERPOWER))
         return TRUE;
 
     return XnsClientSameNS(subjPriv, objPriv);
@@ -33,8 +33,10 @@ void hookSend(CallbackListPtr *pcbl, void *unused, void *calldata)
 
     ClientPtr targetClient = dixClientForWindow(param->pWin);
     struct XnamespaceClientPriv *obj = XnsClientPriv(targetClient);
-    if (clientAllowedOnClient(client, targetClient))
+    if (clientAllowedOnClient(client, targetClient)) {
+        subj->ns->eventsFastPath += param->count;
         goto pass;
+    }
 
     XNS_HOOK_LOG("BLOCK target @ %s\n", obj->ns->name);
     for (int i = 0; i < param->count; i++) {
@@ -44,6 +46,7 @@ void hookSend(CallbackListPtr *pcbl, void *unused, void *calldata)
             targetClient->index);
     }
 
+    subj->ns->eventsBlocked += param->count;
     param->status = BadAccess;
     return;
 
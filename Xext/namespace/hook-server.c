@@ -14,7 +14,7 @@ void hookServerAccess(CallbackListPtr *pcbl, void *unused, void *calldata)
 {
     XNS_HOOK_HEAD(ServerAccessCallbackParam);
 
-    if (subj->ns->superPower)
+    if (XnsAllowed(subj->ns, NS_SUPERPOWER))
         goto pass;
 
     switch (client->majorOp) {
@@ -17,7 +17,7 @@ void hookWindowProperty(CallbackListPtr *pcbl, void *unused, void *calldata)
     XNS_HOOK_HEAD(PropertyFilterParam);
 
     // no redirect on super power
-    if (subj->ns->superPower)
+    if (XnsAllowed(subj->ns, NS_SUPERPOWER))
         return;
 
     const ClientPtr owner = dixLookupXIDOwner(param->window);
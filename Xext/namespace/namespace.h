@@ -18,19 +18,34 @@ struct auth_token {
     XID authId;
 };
 
+/* policy bits compiled from the "allow" / "superpower" config statements
+   at load time, so the hooks decide with a single mask test instead of
+   walking several flags on every event or resource access */
+#define NS_ALLOW_MOUSE_MOTION   (1 << 0)
+#define NS_ALLOW_SHAPE          (1 << 1)
+#define NS_ALLOW_TRANSPARENCY   (1 << 2)
+#define NS_ALLOW_XINPUT         (1 << 3)
+#define NS_ALLOW_XKEYBOARD      (1 << 4)
+#define NS_SUPERPOWER           (1 << 5)
+
+#define NS_ALLOW_ALL (NS_ALLOW_MOUSE_MOTION | NS_ALLOW_SHAPE | \
+                      NS_ALLOW_TRANSPARENCY | NS_ALLOW_XINPUT | \
+                      NS_ALLOW_XKEYBOARD)
+
 struct Xnamespace {
     struct xorg_list entry;
     const char *name;
     Bool builtin;
-    Bool allowMouseMotion;
-    Bool allowShape;
-    Bool allowTransparency;
-    Bool allowXInput;
-    Bool allowXKeyboard;
-    Bool superPower;
+    unsigned int allowMask;
     struct xorg_list auth_tokens;
     size_t refcnt;
     WindowPtr rootWindow;
+    /* hot-path accounting, bumped by the receive/send hooks: events waved
+       through on the same-namespace fast path, events that went through
+       the full filter, and events blocked */
+    unsigned long eventsFastPath;
+    unsigned long eventsFiltered;
+    unsigned long eventsBlocked;
 };
 
 extern struct xorg_list ns_list;
@@ -59,6 +74,11 @@ static inline struct XnamespaceClientPriv *XnsClientPriv(ClientPtr client) {
     return dixLookupPrivate(&client->devPrivates, &namespaceClientPrivKeyRec);
 }
 
+static inline Bool XnsAllowed(struct Xnamespace *ns, unsigned int flags)
+{
+    return (ns->allowMask & flags) == flags;
+}
+
 static inline Bool XnsClientSameNS(struct XnamespaceClientPriv *p1, struct XnamespaceClientPriv *p2)
 {
     if (!p1 && !p2)
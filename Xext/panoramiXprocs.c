@@ -27,6 +27,7 @@ Equipment Corporation.
 
 #include <dix-config.h>
 
+#include <limits.h>
 #include <stdio.h>
 #include <X11/X.h>
 #include <X11/Xproto.h>
@@ -57,6 +58,79 @@ Equipment Corporation.
 #define INPUTONLY_LEGAL_MASK (CWWinGravity | CWEventMask | \
                               CWDontPropagate | CWOverrideRedirect | CWCursor )
 
+/* Bounding-box culling for draw requests against the panoramic root
+ * window.  The fan-out loops below redispatch the core proc once per
+ * screen, and on a wide screen layout most of those dispatches only
+ * find out during clipping that the operation lands entirely on some
+ * other screen.  Computing the request's bounding box up front lets the
+ * loop skip such screens before paying for lookup and GC validation.
+ *
+ * Coordinates can walk out of INT16 range while accumulating
+ * CoordModePrevious deltas, so the bounds are kept in ints rather than
+ * a BoxRec.
+ */
+typedef struct {
+    int x1, y1, x2, y2;
+} PanoramiXBounds;
+
+#define PANORAMIX_BOUNDS_INIT \
+    { .x1 = INT_MAX, .y1 = INT_MAX, .x2 = INT_MIN, .y2 = INT_MIN }
+
+static void
+XineramaBoundsAddPoint(PanoramiXBounds *bounds, int x, int y)
+{
+    if (x < bounds->x1)
+        bounds->x1 = x;
+    if (y < bounds->y1)
+        bounds->y1 = y;
+    if (x > bounds->x2)
+        bounds->x2 = x;
+    if (y > bounds->y2)
+        bounds->y2 = y;
+}
+
+static void
+XineramaPointBounds(const xPoint *pts, int npoint, int mode,
+                    PanoramiXBounds *bounds)
+{
+    int x = 0, y = 0;
+
+    for (int i = 0; i < npoint; i++) {
+        if (mode == CoordModePrevious) {
+            x += pts[i].x;
+            y += pts[i].y;
+        }
+        else {
+            x = pts[i].x;
+            y = pts[i].y;
+        }
+        XineramaBoundsAddPoint(bounds, x, y);
+    }
+}
+
+/* Padded by one pixel, which covers everything a thin (zero-width) line
+   may touch beyond its control points.  Wide lines can overshoot much
+   further (miter joins project up to lineWidth / (2 sin(theta/2))), so
+   callers must not cull outline primitives drawn with a wide GC. */
+static Bool
+XineramaScreenHitsBounds(ScreenPtr screen, const PanoramiXBounds *bounds)
+{
+    return bounds->x2 + 1 >= screen->x &&
+           bounds->y2 + 1 >= screen->y &&
+           bounds->x1 - 1 < screen->x + screen->width &&
+           bounds->y1 - 1 < screen->y + screen->height;
+}
+
+static Bool
+XineramaGCIsThin(ClientPtr client, XID gcid)
+{
+    GCPtr pGC;
+
+    if (dixLookupGC(&pGC, gcid, client, DixReadAccess) != Success)
+        return FALSE;
+    return pGC->lineWidth == 0;
+}
+
 int
 PanoramiXCreateWindow(ClientPtr client)
 {
@@ -1428,7 +1502,16 @@ PanoramiXPolyPoint(ClientPtr client)
 
         memcpy((char *) origPts, (char *) &stuff[1], npoint * sizeof(xPoint));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot;
+
+        if (cull)
+            XineramaPointBounds(origPts, npoint, stuff->coordMode, &bounds);
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx)
                 memcpy(&stuff[1], origPts, npoint * sizeof(xPoint));
 
@@ -1495,7 +1578,16 @@ PanoramiXPolyLine(ClientPtr client)
             return BadAlloc;
         memcpy((char *) origPts, (char *) &stuff[1], npoint * sizeof(xPoint));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot && XineramaGCIsThin(client, stuff->gc);
+
+        if (cull)
+            XineramaPointBounds(origPts, npoint, stuff->coordMode, &bounds);
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx)
                 memcpy(&stuff[1], origPts, npoint * sizeof(xPoint));
 
@@ -1566,7 +1658,20 @@ PanoramiXPolySegment(ClientPtr client)
             return BadAlloc;
         memcpy((char *) origSegs, (char *) &stuff[1], nsegs * sizeof(xSegment));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot && XineramaGCIsThin(client, stuff->gc);
+
+        if (cull) {
+            for (i = 0; i < nsegs; i++) {
+                XineramaBoundsAddPoint(&bounds, origSegs[i].x1, origSegs[i].y1);
+                XineramaBoundsAddPoint(&bounds, origSegs[i].x2, origSegs[i].y2);
+            }
+        }
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx) /* skip on screen #0 */
                 memcpy(&stuff[1], origSegs, nsegs * sizeof(xSegment));
 
@@ -1637,7 +1742,22 @@ PanoramiXPolyRectangle(ClientPtr client)
         memcpy((char *) origRecs, (char *) &stuff[1],
                nrects * sizeof(xRectangle));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot && XineramaGCIsThin(client, stuff->gc);
+
+        if (cull) {
+            for (i = 0; i < nrects; i++) {
+                XineramaBoundsAddPoint(&bounds, origRecs[i].x, origRecs[i].y);
+                XineramaBoundsAddPoint(&bounds,
+                                       origRecs[i].x + origRecs[i].width,
+                                       origRecs[i].y + origRecs[i].height);
+            }
+        }
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx) /* skip on screen #0 */
                 memcpy(&stuff[1], origRecs, nrects * sizeof(xRectangle));
 
@@ -1705,7 +1825,22 @@ PanoramiXPolyArc(ClientPtr client)
             return BadAlloc;
         memcpy((char *) origArcs, (char *) &stuff[1], narcs * sizeof(xArc));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot && XineramaGCIsThin(client, stuff->gc);
+
+        if (cull) {
+            for (i = 0; i < narcs; i++) {
+                XineramaBoundsAddPoint(&bounds, origArcs[i].x, origArcs[i].y);
+                XineramaBoundsAddPoint(&bounds,
+                                       origArcs[i].x + origArcs[i].width,
+                                       origArcs[i].y + origArcs[i].height);
+            }
+        }
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx) /* skip screen #0 */
                 memcpy(&stuff[1], origArcs, narcs * sizeof(xArc));
 
@@ -1770,7 +1905,17 @@ PanoramiXFillPoly(ClientPtr client)
         memcpy((char *) locPts, (char *) &stuff[1],
                count * sizeof(DDXPointRec));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot;
+
+        if (cull)
+            XineramaPointBounds((xPoint *) locPts, count, stuff->coordMode,
+                                &bounds);
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx) /* skip screen #0 */
                 memcpy(&stuff[1], locPts, count * sizeof(DDXPointRec));
 
@@ -1840,7 +1985,22 @@ PanoramiXPolyFillRectangle(ClientPtr client)
         memcpy((char *) origRects, (char *) &stuff[1],
                things * sizeof(xRectangle));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot;
+
+        if (cull) {
+            for (i = 0; i < things; i++) {
+                XineramaBoundsAddPoint(&bounds, origRects[i].x, origRects[i].y);
+                XineramaBoundsAddPoint(&bounds,
+                                       origRects[i].x + origRects[i].width,
+                                       origRects[i].y + origRects[i].height);
+            }
+        }
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx) /* skip screen #0 */
                 memcpy(&stuff[1], origRects, things * sizeof(xRectangle));
 
@@ -1908,7 +2068,22 @@ PanoramiXPolyFillArc(ClientPtr client)
             return BadAlloc;
         memcpy((char *) origArcs, (char *) &stuff[1], narcs * sizeof(xArc));
 
+        PanoramiXBounds bounds = PANORAMIX_BOUNDS_INIT;
+        Bool cull = isRoot;
+
+        if (cull) {
+            for (i = 0; i < narcs; i++) {
+                XineramaBoundsAddPoint(&bounds, origArcs[i].x, origArcs[i].y);
+                XineramaBoundsAddPoint(&bounds,
+                                       origArcs[i].x + origArcs[i].width,
+                                       origArcs[i].y + origArcs[i].height);
+            }
+        }
+
         XINERAMA_FOR_EACH_SCREEN_FORWARD({
+            if (cull && !XineramaScreenHitsBounds(walkScreen, &bounds))
+                continue;
+
             if (walkScreenIdx) /* skip screen #0 */
                 memcpy(&stuff[1], origArcs, narcs * sizeof(xArc));
 
@@ -138,7 +138,21 @@ RegionOperate(ClientPtr client,
             return Success;
         }
     }
-    else
+    else {
+        /* Snapshot the current shape so a combine that ends up producing
+         * the same region again can skip the SetShape revalidation below.
+         * Toolkits that reshape on every frame routinely resubmit an
+         * unchanged shape, and revalidating the window tree is far more
+         * expensive than one region copy and compare. */
+        RegionPtr oldRgn = NULL;
+        if (*destRgnp) {
+            oldRgn = RegionCreate(NullBox, 1);
+            if (oldRgn && !RegionCopy(oldRgn, *destRgnp)) {
+                RegionDestroy(oldRgn);
+                oldRgn = NULL;
+            }
+        }
+
         switch (op) {
         case ShapeSet:
             if (*destRgnp)
@@ -170,9 +184,25 @@ RegionOperate(ClientPtr client,
                 RegionSubtract(*destRgnp, srcRgn, *destRgnp);
             break;
         default:
+            if (oldRgn)
+                RegionDestroy(oldRgn);
             client->errorValue = op;
             return BadValue;
         }
+
+        if (oldRgn) {
+            Bool unchanged = *destRgnp && RegionEqual(oldRgn, *destRgnp);
+
+            RegionDestroy(oldRgn);
+            if (unchanged) {
+                /* shape not modified: skip revalidation, and per the
+                 * May/30/2001 note above no ShapeNotify either */
+                if (srcRgn)
+                    RegionDestroy(srcRgn);
+                return Success;
+            }
+        }
+    }
     if (srcRgn)
         RegionDestroy(srcRgn);
     (*pWin->drawable.pScreen->SetShape) (pWin, kind);
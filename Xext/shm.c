@@ -108,6 +108,7 @@ Bool noMITShmExtension = FALSE;
 
 static PixmapPtr fbShmCreatePixmap(XSHM_CREATE_PIXMAP_ARGS);
 static int ShmDetachSegment(void *value, XID shmseg);
+static void ShmFreeSegment(ShmDescPtr shmdesc);
 static void ShmResetProc(ExtensionEntry *extEntry);
 static void SShmCompletionEvent(xShmCompletionEvent *from,
                                 xShmCompletionEvent *to);
@@ -119,6 +120,15 @@ int ShmCompletionCode;
 int BadShmSegCode;
 RESTYPE ShmSegType;
 static ShmDescPtr Shmsegs;
+
+/*
+ * Recently detached SysV segments stay on Shmsegs with refcnt 0 so a
+ * re-attach of the same shmid (common toolkit behavior) can revive the
+ * existing mapping instead of paying for shmat and revalidation from
+ * scratch.  Bounded so orphaned segments can't pile up.
+ */
+#define SHM_RETIRED_MAX 4
+static int ShmRetiredCount;
 static Bool sharedPixmaps;
 static DevPrivateKeyRec shmScrPrivateKeyRec;
 
@@ -214,6 +224,17 @@ ShmRegisterPrivates(void)
  /*ARGSUSED*/ static void
 ShmResetProc(ExtensionEntry * extEntry)
 {
+    ShmDescPtr shmdesc, next;
+
+    /* Drop retired segment mappings kept around for reuse */
+    for (shmdesc = Shmsegs; shmdesc; shmdesc = next) {
+        next = shmdesc->next;
+        if (shmdesc->refcnt == 0) {
+            ShmFreeSegment(shmdesc);
+            ShmRetiredCount--;
+        }
+    }
+
     DIX_FOR_EACH_SCREEN({
         ShmRegisterFuncs(walkScreen, NULL);
     });
@@ -347,6 +368,21 @@ ProcShmAttach(ClientPtr client)
         if (!SHMDESC_IS_FD(shmdesc) && shmdesc->shmid == stuff->shmid)
             break;
     }
+    if (shmdesc && shmdesc->refcnt == 0) {
+        /* Reviving a retired mapping: make sure the segment still
+         * exists (the shmid may have been removed since we last saw
+         * it) and that this client may access it with these rights.
+         */
+        if (SHMSTAT(stuff->shmid, &buf) ||
+            shm_access(client, &(SHM_PERM(buf)), stuff->readOnly) == -1 ||
+            (!stuff->readOnly && !shmdesc->writable)) {
+            ShmFreeSegment(shmdesc);
+            ShmRetiredCount--;
+            shmdesc = NULL;
+        }
+        else
+            ShmRetiredCount--;
+    }
     if (shmdesc) {
         if (!stuff->readOnly && !shmdesc->writable)
             return BadAccess;
@@ -388,18 +424,11 @@ ProcShmAttach(ClientPtr client)
     return Success;
 }
 
- /*ARGSUSED*/ static int
-ShmDetachSegment(void *value, /* must conform to DeleteType */
-                 XID unused)
+static void
+ShmFreeSegment(ShmDescPtr shmdesc)
 {
-    ShmDescPtr shmdesc = (ShmDescPtr) value;
     ShmDescPtr *prev;
 
-    if (!shmdesc)
-        return Success;
-
-    if (--shmdesc->refcnt)
-        return TRUE;
 #if SHM_FD_PASSING
     if (shmdesc->is_fd) {
         if (shmdesc->busfault)
@@ -411,6 +440,43 @@ ShmDetachSegment(void *value, /* must conform to DeleteType */
     for (prev = &Shmsegs; *prev != shmdesc; prev = &(*prev)->next);
     *prev = shmdesc->next;
     free(shmdesc);
+}
+
+ /*ARGSUSED*/ static int
+ShmDetachSegment(void *value, /* must conform to DeleteType */
+                 XID unused)
+{
+    ShmDescPtr shmdesc = (ShmDescPtr) value;
+
+    if (!shmdesc)
+        return Success;
+
+    if (--shmdesc->refcnt)
+        return TRUE;
+
+#if SHM_FD_PASSING
+    if (shmdesc->is_fd) {
+        ShmFreeSegment(shmdesc);
+        return Success;
+    }
+#endif
+
+    /* Retire the mapping instead of tearing it down; entries are
+     * pushed at the head of Shmsegs, so the deepest retired one is
+     * the oldest and gets evicted when the cache is full.
+     */
+    if (ShmRetiredCount >= SHM_RETIRED_MAX) {
+        ShmDescPtr oldest = NULL;
+
+        for (ShmDescPtr cur = Shmsegs; cur; cur = cur->next)
+            if (cur != shmdesc && cur->refcnt == 0 && !SHMDESC_IS_FD(cur))
+                oldest = cur;
+        if (oldest) {
+            ShmFreeSegment(oldest);
+            ShmRetiredCount--;
+        }
+    }
+    ShmRetiredCount++;
     return Success;
 }
 
@@ -1128,6 +1194,22 @@ ShmCreatePixmap(ClientPtr client, xShmCreatePixmapReq *stuff)
 
 #ifdef SHM_FD_PASSING
 
+/* A segment whose fd carries F_SEAL_SHRINK can never be truncated under
+ * us, so the SIGBUS guard around its mapping is pure overhead: pixmaps
+ * created on top of it (ShmCreatePixmap) read the client pages directly
+ * without any defensive machinery in the fault path. */
+static Bool
+shm_fd_sealed(int fd)
+{
+#ifdef F_GET_SEALS
+    int seals = fcntl(fd, F_GET_SEALS);
+
+    return seals != -1 && (seals & F_SEAL_SHRINK);
+#else
+    return FALSE;
+#endif
+}
+
 static void
 ShmBusfaultNotify(void *context)
 {
@@ -1174,6 +1256,7 @@ ProcShmAttachFd(ClientPtr client)
         return BadAlloc;
     }
     shmdesc->is_fd = TRUE;
+    shmdesc->sealed = shm_fd_sealed(fd);
     shmdesc->addr = mmap(NULL, statb.st_size,
                          stuff->readOnly ? PROT_READ : PROT_READ|PROT_WRITE,
                          MAP_SHARED,
@@ -1190,11 +1273,13 @@ ProcShmAttachFd(ClientPtr client)
     shmdesc->size = statb.st_size;
     shmdesc->resource = stuff->shmseg;
 
-    shmdesc->busfault = busfault_register_mmap(shmdesc->addr, shmdesc->size, ShmBusfaultNotify, shmdesc);
-    if (!shmdesc->busfault) {
-        munmap(shmdesc->addr, shmdesc->size);
-        free(shmdesc);
-        return BadAlloc;
+    if (!shmdesc->sealed) {
+        shmdesc->busfault = busfault_register_mmap(shmdesc->addr, shmdesc->size, ShmBusfaultNotify, shmdesc);
+        if (!shmdesc->busfault) {
+            munmap(shmdesc->addr, shmdesc->size);
+            free(shmdesc);
+            return BadAlloc;
+        }
     }
 
     shmdesc->next = Shmsegs;
@@ -1293,6 +1378,7 @@ ProcShmCreateSegment(ClientPtr client)
         return BadAlloc;
     }
     shmdesc->is_fd = TRUE;
+    shmdesc->sealed = shm_fd_sealed(fd);
     shmdesc->addr = mmap(NULL, stuff->size,
                          stuff->readOnly ? PROT_READ : PROT_READ|PROT_WRITE,
                          MAP_SHARED,
@@ -1308,12 +1394,14 @@ ProcShmCreateSegment(ClientPtr client)
     shmdesc->writable = !stuff->readOnly;
     shmdesc->size = stuff->size;
 
-    shmdesc->busfault = busfault_register_mmap(shmdesc->addr, shmdesc->size, ShmBusfaultNotify, shmdesc);
-    if (!shmdesc->busfault) {
-        close(fd);
-        munmap(shmdesc->addr, shmdesc->size);
-        free(shmdesc);
-        return BadAlloc;
+    if (!shmdesc->sealed) {
+        shmdesc->busfault = busfault_register_mmap(shmdesc->addr, shmdesc->size, ShmBusfaultNotify, shmdesc);
+        if (!shmdesc->busfault) {
+            close(fd);
+            munmap(shmdesc->addr, shmdesc->size);
+            free(shmdesc);
+            return BadAlloc;
+        }
     }
 
     shmdesc->next = Shmsegs;
@@ -18,6 +18,7 @@ typedef struct _ShmDesc {
     unsigned long size;
 #ifdef SHM_FD_PASSING
     Bool is_fd;
+    Bool sealed;
     struct busfault *busfault;
     XID resource;
 #endif
@@ -108,6 +108,7 @@ static const char *WARN_INVALID_COUNTER_ALARM =
     (XSyncCACounter | XSyncCAValueType | XSyncCAValue | XSyncCATestType)
 
 static void SyncComputeBracketValues(SyncCounter *);
+static void SyncTightenBracketValues(SyncCounter *, SyncTrigger *);
 
 static void SyncInitServerTime(void);
 
@@ -209,7 +210,7 @@ SyncAddTriggerToSyncObject(SyncTrigger * pTrigger)
         pCounter = (SyncCounter *) pTrigger->pSync;
 
         if (IsSystemCounter(pCounter))
-            SyncComputeBracketValues(pCounter);
+            SyncTightenBracketValues(pCounter, pTrigger);
     }
     else if (SYNC_FENCE == pTrigger->pSync->type) {
         SyncFence *pFence = (SyncFence *) pTrigger->pSync;
@@ -1054,97 +1055,128 @@ SyncDestroySystemCounter(void *pSysCounter)
     FreeResource(pCounter->sync.id, X11_RESTYPE_NONE);
 }
 
+/*
+ * Fold one trigger into the counter's bracket values, which only ever
+ * tightens them.  Sets *pnewltval/*pnewgtval when the corresponding
+ * bracket moved so callers know what to hand to the BracketValues hook.
+ */
+static void
+SyncBracketTrigger(SyncCounter * pCounter, SyncTrigger * pTrigger,
+                   int64_t **pnewltval, int64_t **pnewgtval)
+{
+    SysCounterInfo *psci = pCounter->pSysCounterInfo;
+    SyncCounterType ct = psci->counterType;
+
+    if (pTrigger->test_type == XSyncPositiveComparison &&
+        ct != XSyncCounterNeverIncreases) {
+        if (pCounter->value < pTrigger->test_value &&
+            pTrigger->test_value < psci->bracket_greater) {
+            psci->bracket_greater = pTrigger->test_value;
+            *pnewgtval = &psci->bracket_greater;
+        }
+        else if (pCounter->value > pTrigger->test_value &&
+                 pTrigger->test_value > psci->bracket_less) {
+                psci->bracket_less = pTrigger->test_value;
+                *pnewltval = &psci->bracket_less;
+        }
+    }
+    else if (pTrigger->test_type == XSyncNegativeComparison &&
+             ct != XSyncCounterNeverDecreases) {
+        if (pCounter->value > pTrigger->test_value &&
+            pTrigger->test_value > psci->bracket_less) {
+            psci->bracket_less = pTrigger->test_value;
+            *pnewltval = &psci->bracket_less;
+        }
+        else if (pCounter->value < pTrigger->test_value &&
+                 pTrigger->test_value < psci->bracket_greater) {
+                psci->bracket_greater = pTrigger->test_value;
+                *pnewgtval = &psci->bracket_greater;
+        }
+    }
+    else if (pTrigger->test_type == XSyncNegativeTransition &&
+             ct != XSyncCounterNeverIncreases) {
+        if (pCounter->value >= pTrigger->test_value &&
+            pTrigger->test_value > psci->bracket_less) {
+                /*
+                 * If the value is exactly equal to our threshold, we want one
+                 * more event in the negative direction to ensure we pick up
+                 * when the value is less than this threshold.
+                 */
+                psci->bracket_less = pTrigger->test_value;
+                *pnewltval = &psci->bracket_less;
+        }
+        else if (pCounter->value < pTrigger->test_value &&
+                 pTrigger->test_value < psci->bracket_greater) {
+                psci->bracket_greater = pTrigger->test_value;
+                *pnewgtval = &psci->bracket_greater;
+        }
+    }
+    else if (pTrigger->test_type == XSyncPositiveTransition &&
+             ct != XSyncCounterNeverDecreases) {
+        if (pCounter->value <= pTrigger->test_value &&
+            pTrigger->test_value < psci->bracket_greater) {
+                /*
+                 * If the value is exactly equal to our threshold, we
+                 * want one more event in the positive direction to
+                 * ensure we pick up when the value *exceeds* this
+                 * threshold.
+                 */
+                psci->bracket_greater = pTrigger->test_value;
+                *pnewgtval = &psci->bracket_greater;
+        }
+        else if (pCounter->value > pTrigger->test_value &&
+                 pTrigger->test_value > psci->bracket_less) {
+                psci->bracket_less = pTrigger->test_value;
+                *pnewltval = &psci->bracket_less;
+        }
+    }
+}
+
 static void
 SyncComputeBracketValues(SyncCounter * pCounter)
 {
     SyncTriggerList *pCur;
-    SyncTrigger *pTrigger;
     SysCounterInfo *psci;
     int64_t *pnewgtval = NULL;
     int64_t *pnewltval = NULL;
-    SyncCounterType ct;
 
     if (!pCounter)
         return;
 
     psci = pCounter->pSysCounterInfo;
-    ct = pCounter->pSysCounterInfo->counterType;
-    if (ct == XSyncCounterNeverChanges)
+    if (psci->counterType == XSyncCounterNeverChanges)
         return;
 
     psci->bracket_greater = LLONG_MAX;
     psci->bracket_less = LLONG_MIN;
 
-    for (pCur = pCounter->sync.pTriglist; pCur; pCur = pCur->next) {
-        pTrigger = pCur->pTrigger;
-
-        if (pTrigger->test_type == XSyncPositiveComparison &&
-            ct != XSyncCounterNeverIncreases) {
-            if (pCounter->value < pTrigger->test_value &&
-                pTrigger->test_value < psci->bracket_greater) {
-                psci->bracket_greater = pTrigger->test_value;
-                pnewgtval = &psci->bracket_greater;
-            }
-            else if (pCounter->value > pTrigger->test_value &&
-                     pTrigger->test_value > psci->bracket_less) {
-                    psci->bracket_less = pTrigger->test_value;
-                    pnewltval = &psci->bracket_less;
-            }
-        }
-        else if (pTrigger->test_type == XSyncNegativeComparison &&
-                 ct != XSyncCounterNeverDecreases) {
-            if (pCounter->value > pTrigger->test_value &&
-                pTrigger->test_value > psci->bracket_less) {
-                psci->bracket_less = pTrigger->test_value;
-                pnewltval = &psci->bracket_less;
-            }
-            else if (pCounter->value < pTrigger->test_value &&
-                     pTrigger->test_value < psci->bracket_greater) {
-                    psci->bracket_greater = pTrigger->test_value;
-                    pnewgtval = &psci->bracket_greater;
-            }
-        }
-        else if (pTrigger->test_type == XSyncNegativeTransition &&
-                 ct != XSyncCounterNeverIncreases) {
-            if (pCounter->value >= pTrigger->test_value &&
-                pTrigger->test_value > psci->bracket_less) {
-                    /*
-                     * If the value is exactly equal to our threshold, we want one
-                     * more event in the negative direction to ensure we pick up
-                     * when the value is less than this threshold.
-                     */
-                    psci->bracket_less = pTrigger->test_value;
-                    pnewltval = &psci->bracket_less;
-            }
-            else if (pCounter->value < pTrigger->test_value &&
-                     pTrigger->test_value < psci->bracket_greater) {
-                    psci->bracket_greater = pTrigger->test_value;
-                    pnewgtval = &psci->bracket_greater;
-            }
-        }
-        else if (pTrigger->test_type == XSyncPositiveTransition &&
-                 ct != XSyncCounterNeverDecreases) {
-            if (pCounter->value <= pTrigger->test_value &&
-                pTrigger->test_value < psci->bracket_greater) {
-                    /*
-                     * If the value is exactly equal to our threshold, we
-                     * want one more event in the positive direction to
-                     * ensure we pick up when the value *exceeds* this
-                     * threshold.
-                     */
-                    psci->bracket_greater = pTrigger->test_value;
-                    pnewgtval = &psci->bracket_greater;
-            }
-            else if (pCounter->value > pTrigger->test_value &&
-                     pTrigger->test_value > psci->bracket_less) {
-                    psci->bracket_less = pTrigger->test_value;
-                    pnewltval = &psci->bracket_less;
-            }
-        }
-    }                           /* end for each trigger */
+    for (pCur = pCounter->sync.pTriglist; pCur; pCur = pCur->next)
+        SyncBracketTrigger(pCounter, pCur->pTrigger, &pnewltval, &pnewgtval);
 
     (*psci->BracketValues) ((void *) pCounter, pnewltval, pnewgtval);
+}
+
+/*
+ * Adding a trigger can only tighten the existing brackets, so fold just
+ * the new trigger in instead of rescanning the whole wait list.  This
+ * keeps per-frame SyncAwait on busy system counters O(1); the full
+ * recompute is still needed when a trigger goes away or the counter
+ * value moves past a bracket.
+ */
+static void
+SyncTightenBracketValues(SyncCounter * pCounter, SyncTrigger * pTrigger)
+{
+    SysCounterInfo *psci = pCounter->pSysCounterInfo;
+    int64_t *pnewgtval = NULL;
+    int64_t *pnewltval = NULL;
+
+    if (psci->counterType == XSyncCounterNeverChanges)
+        return;
+
+    SyncBracketTrigger(pCounter, pTrigger, &pnewltval, &pnewgtval);
 
+    if (pnewltval || pnewgtval)
+        (*psci->BracketValues) ((void *) pCounter, pnewltval, pnewgtval);
 }
 
 /*
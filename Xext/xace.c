@@ -21,6 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <stdarg.h>
 
+#include "dix/callback_priv.h"
 #include "os/client_priv.h"
 
 #include "scrnintstr.h"
@@ -30,12 +31,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "gcstruct.h"
 #include "xacestr.h"
 
-CallbackListPtr XaceHooks[XACE_NUM_HOOKS] = { 0 };
+static CallbackListPtr XaceHooks[XACE_NUM_HOOKS] = { 0 };
+
+unsigned int XaceHookMask;
 
 /* Special-cased hook functions.  Called by Xserver.
  */
 int
-XaceHookPropertyAccess(ClientPtr client, WindowPtr pWin,
+XaceCallPropertyAccess(ClientPtr client, WindowPtr pWin,
                        PropertyPtr *ppProp, Mask access_mode)
 {
     XacePropertyAccessRec rec = { client, pWin, ppProp, access_mode, Success };
@@ -44,14 +47,14 @@ XaceHookPropertyAccess(ClientPtr client, WindowPtr pWin,
 }
 
 int
-XaceHookSelectionAccess(ClientPtr client, Selection ** ppSel, Mask access_mode)
+XaceCallSelectionAccess(ClientPtr client, Selection ** ppSel, Mask access_mode)
 {
     XaceSelectionAccessRec rec = { client, ppSel, access_mode, Success };
     CallCallbacks(&XaceHooks[XACE_SELECTION_ACCESS], &rec);
     return rec.status;
 }
 
-int XaceHookResourceAccess(ClientPtr client, XID id, RESTYPE rtype, void *res,
+int XaceCallResourceAccess(ClientPtr client, XID id, RESTYPE rtype, void *res,
                            RESTYPE ptype, void *parent, Mask access_mode)
 {
     XaceResourceAccessRec rec = { client, id, rtype, res, ptype, parent,
@@ -60,7 +63,7 @@ int XaceHookResourceAccess(ClientPtr client, XID id, RESTYPE rtype, void *res,
     return rec.status;
 }
 
-int XaceHookSendAccess(ClientPtr client, DeviceIntPtr dev, WindowPtr win,
+int XaceCallSendAccess(ClientPtr client, DeviceIntPtr dev, WindowPtr win,
                        xEventPtr ev, int count)
 {
     XaceSendAccessRec rec = { client, dev, win, ev, count, Success };
@@ -68,7 +71,7 @@ int XaceHookSendAccess(ClientPtr client, DeviceIntPtr dev, WindowPtr win,
     return rec.status;
 }
 
-int XaceHookReceiveAccess(ClientPtr client, WindowPtr win,
+int XaceCallReceiveAccess(ClientPtr client, WindowPtr win,
                           xEventPtr ev, int count)
 {
     XaceReceiveAccessRec rec = { client, win, ev, count, Success };
@@ -76,21 +79,6 @@ int XaceHookReceiveAccess(ClientPtr client, WindowPtr win,
     return rec.status;
 }
 
-/* XaceHookIsSet
- *
- * Utility function to determine whether there are any callbacks listening on a
- * particular XACE hook.
- *
- * Returns non-zero if there is a callback, zero otherwise.
- */
-int
-XaceHookIsSet(int hook)
-{
-    if (hook < 0 || hook >= XACE_NUM_HOOKS)
-        return 0;
-    return XaceHooks[hook] != NULL;
-}
-
 /* XaceCensorImage
  *
  * Called after pScreen->GetImage to prevent pieces or trusted windows from
@@ -201,11 +189,25 @@ XaceCensorImage(ClientPtr client,
 Bool
 XaceRegisterCallback(int hook, CallbackProcPtr callback, void *data)
 {
-    return AddCallback(XaceHooks+(hook), callback, data);
+    if (hook < 0 || hook >= XACE_NUM_HOOKS)
+        return FALSE;
+    if (!AddCallback(XaceHooks + hook, callback, data))
+        return FALSE;
+    XaceHookMask |= 1u << hook;
+    return TRUE;
 }
 
 Bool
 XaceDeleteCallback(int hook, CallbackProcPtr callback, void *data)
 {
-    return DeleteCallback(XaceHooks+(hook), callback, data);
+    if (hook < 0 || hook >= XACE_NUM_HOOKS)
+        return FALSE;
+    if (!DeleteCallback(XaceHooks + hook, callback, data))
+        return FALSE;
+    /* a delete during callback execution is only marked at this point;
+       leaving the bit set until the list really drains just means the
+       empty list gets walked, which is still correct */
+    if (!XaceHooks[hook] || !XaceHooks[hook]->list)
+        XaceHookMask &= ~(1u << hook);
+    return TRUE;
 }
@@ -45,7 +45,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define XACE_SELECTION_ACCESS		10
 #define XACE_NUM_HOOKS			13
 
-extern CallbackListPtr XaceHooks[XACE_NUM_HOOKS];
+/* Bitmap with one bit per hook that has at least one registered
+ * callback, maintained by XaceRegisterCallback / XaceDeleteCallback.
+ * It lets the hook entry points below collapse into a single predictable
+ * branch when no security module is loaded, instead of entering the
+ * callback list machinery on every access decision.
+ */
+extern _X_EXPORT unsigned int XaceHookMask;
 
 /* Entry point for hook functions.  Called by Xserver.
  * Required by several modules
@@ -54,21 +60,73 @@ _X_EXPORT Bool XaceRegisterCallback(int hook, CallbackProcPtr callback, void *da
 _X_EXPORT Bool XaceDeleteCallback(int hook, CallbackProcPtr callback, void *data);
 
 /* determine whether any callbacks are present for the XACE hook */
-int XaceHookIsSet(int hook);
-
-/* Special-cased hook functions
+static inline int
+XaceHookIsSet(int hook)
+{
+    if (hook < 0 || hook >= XACE_NUM_HOOKS)
+        return 0;
+    return (XaceHookMask >> hook) & 1;
+}
+
+/* Special-cased hook functions.  The XaceCall* workers run the callback
+ * list; the inline wrappers skip the call entirely when nothing is
+ * registered for the hook.
  */
-int XaceHookPropertyAccess(ClientPtr ptr, WindowPtr pWin, PropertyPtr *ppProp,
+int XaceCallPropertyAccess(ClientPtr ptr, WindowPtr pWin, PropertyPtr *ppProp,
                            Mask access_mode);
-int XaceHookSelectionAccess(ClientPtr ptr, Selection ** ppSel, Mask access_mode);
+int XaceCallSelectionAccess(ClientPtr ptr, Selection ** ppSel, Mask access_mode);
 
 /* needs to be exported for in-tree modesetting, but not part of public API */
-_X_EXPORT int XaceHookResourceAccess(ClientPtr client, XID id, RESTYPE rtype, void *res,
+_X_EXPORT int XaceCallResourceAccess(ClientPtr client, XID id, RESTYPE rtype, void *res,
                            RESTYPE ptype, void *parent, Mask access_mode);
 
-int XaceHookSendAccess(ClientPtr client, DeviceIntPtr dev, WindowPtr win,
+int XaceCallSendAccess(ClientPtr client, DeviceIntPtr dev, WindowPtr win,
                        xEventPtr ev, int count);
-int XaceHookReceiveAccess(ClientPtr client, WindowPtr win, xEventPtr ev, int count);
+int XaceCallReceiveAccess(ClientPtr client, WindowPtr win, xEventPtr ev, int count);
+
+static inline int
+XaceHookPropertyAccess(ClientPtr client, WindowPtr pWin, PropertyPtr *ppProp,
+                       Mask access_mode)
+{
+    if (!XaceHookIsSet(XACE_PROPERTY_ACCESS))
+        return Success;
+    return XaceCallPropertyAccess(client, pWin, ppProp, access_mode);
+}
+
+static inline int
+XaceHookSelectionAccess(ClientPtr client, Selection ** ppSel, Mask access_mode)
+{
+    if (!XaceHookIsSet(XACE_SELECTION_ACCESS))
+        return Success;
+    return XaceCallSelectionAccess(client, ppSel, access_mode);
+}
+
+static inline int
+XaceHookResourceAccess(ClientPtr client, XID id, RESTYPE rtype, void *res,
+                       RESTYPE ptype, void *parent, Mask access_mode)
+{
+    if (!XaceHookIsSet(XACE_RESOURCE_ACCESS))
+        return Success;
+    return XaceCallResourceAccess(client, id, rtype, res, ptype, parent,
+                                  access_mode);
+}
+
+static inline int
+XaceHookSendAccess(ClientPtr client, DeviceIntPtr dev, WindowPtr win,
+                   xEventPtr ev, int count)
+{
+    if (!XaceHookIsSet(XACE_SEND_ACCESS))
+        return Success;
+    return XaceCallSendAccess(client, dev, win, ev, count);
+}
+
+static inline int
+XaceHookReceiveAccess(ClientPtr client, WindowPtr win, xEventPtr ev, int count)
+{
+    if (!XaceHookIsSet(XACE_RECEIVE_ACCESS))
+        return Success;
+    return XaceCallReceiveAccess(client, win, ev, count);
+}
 
 /* Register / unregister a callback for a given hook. */
 
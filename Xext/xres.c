@@ -227,14 +227,6 @@ ProcXResQueryClients(ClientPtr client)
     return X_SEND_REPLY_WITH_RPCBUF(client, reply, rpcbuf);
 }
 
-static void
-ResFindAllRes(void *value, XID id, RESTYPE type, void *cdata)
-{
-    int *counts = (int *) cdata;
-
-    counts[(type & TypeMask) - 1]++;
-}
-
 static CARD32
 resourceTypeAtom(int i)
 {
@@ -268,16 +260,15 @@ ProcXResQueryClientResources(ClientPtr client)
         return BadValue;
     }
 
-    int *counts = calloc(lastResourceType + 1, sizeof(int));
-    if (!counts)
-        return BadAlloc;
-
-    FindAllClientResources(resClient, ResFindAllRes, counts);
+    /* the resource table counts live resources per type as they are
+       added and freed, so there is no need to walk the whole table */
+    int numCounts;
+    const int *counts = dixClientResourceTypeCounts(resClient, &numCounts);
 
     x_rpcbuf_t rpcbuf = { .swapped = client->swapped, .err_clear = TRUE };
 
     int num_types = 0;
-    for (int i = 0; i <= lastResourceType; i++) {
+    for (int i = 0; i < numCounts; i++) {
         /* dont report currently unused resource types */
         if (!(counts[i]))
             continue;
@@ -289,8 +280,6 @@ ProcXResQueryClientResources(ClientPtr client)
         num_types++;
     }
 
-    free(counts);
-
     xXResQueryClientResourcesReply reply = {
         .num_types = num_types
     };
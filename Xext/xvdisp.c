@@ -680,7 +680,7 @@ SingleXvPutImage(ClientPtr client)
     XvPortPtr pPort;
     XvImagePtr pImage = NULL;
     GCPtr pGC;
-    int status, i, size;
+    int status, size;
     CARD16 width, height;
 
     REQUEST(xvPutImageReq);
@@ -699,13 +699,7 @@ SingleXvPutImage(ClientPtr client)
         return status;
     }
 
-    for (i = 0; i < pPort->pAdaptor->nImages; i++) {
-        if (pPort->pAdaptor->pImages[i].id == stuff->id) {
-            pImage = &(pPort->pAdaptor->pImages[i]);
-            break;
-        }
-    }
-
+    pImage = XvdiFindImage(pPort, stuff->id);
     if (!pImage)
         return BadMatch;
 
@@ -774,7 +768,7 @@ SingleXvShmPutImage(ClientPtr client)
     XvPortPtr pPort;
     XvImagePtr pImage = NULL;
     GCPtr pGC;
-    int status, size_needed, i;
+    int status, size_needed;
     CARD16 width, height;
 
     REQUEST(xvShmPutImageReq);
@@ -793,13 +787,7 @@ SingleXvShmPutImage(ClientPtr client)
         return status;
     }
 
-    for (i = 0; i < pPort->pAdaptor->nImages; i++) {
-        if (pPort->pAdaptor->pImages[i].id == stuff->id) {
-            pImage = &(pPort->pAdaptor->pImages[i]);
-            break;
-        }
-    }
-
+    pImage = XvdiFindImage(pPort, stuff->id);
     if (!pImage)
         return BadMatch;
 
@@ -902,19 +890,14 @@ ProcXvQueryImageAttributes(ClientPtr client)
         swaps(&stuff->height);
     }
 
-    int size, num_planes, i;
+    int size, num_planes;
     CARD16 width, height;
     XvImagePtr pImage = NULL;
     XvPortPtr pPort;
 
     VALIDATE_XV_PORT(stuff->port, pPort, DixReadAccess);
 
-    for (i = 0; i < pPort->pAdaptor->nImages; i++) {
-        if (pPort->pAdaptor->pImages[i].id == stuff->id) {
-            pImage = &(pPort->pAdaptor->pImages[i]);
-            break;
-        }
-    }
+    pImage = XvdiFindImage(pPort, stuff->id);
 
 #ifdef XvMCExtension
     if (!pImage)
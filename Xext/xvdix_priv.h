@@ -77,6 +77,10 @@ int XvdiStopVideo(ClientPtr client, XvPortPtr pPort, DrawablePtr pDraw);
 
 int XvdiMatchPort(XvPortPtr pPort, DrawablePtr pDraw);
 
+/* look up an image format by id on the port's adaptor; caches the last
+   hit, since PutImage streams repeat the same id on every frame */
+XvImagePtr XvdiFindImage(XvPortPtr pPort, CARD32 id);
+
 int XvdiGrabPort(ClientPtr client, XvPortPtr pPort, Time ctime, int *p_result);
 int XvdiUngrabPort(ClientPtr client, XvPortPtr pPort, Time ctime);
 
@@ -888,6 +888,26 @@ XvdiStopVideo(ClientPtr client, XvPortPtr pPort, DrawablePtr pDraw)
 
 }
 
+/* One-entry caches for the per-frame lookups on the PutImage path.  An
+   image stream repeats the same adaptor, depth and image id on every
+   frame, so remembering the last hit turns the format and image list
+   scans into a couple of compares.  An adaptor's format and image lists
+   are fixed once it is registered, so the caches only need flushing
+   when the adaptor itself goes away (XvFreeAdaptor). */
+static const XvAdaptorRec *xvMatchCacheAdaptor;
+static char xvMatchCacheDepth;
+static const XvAdaptorRec *xvImageCacheAdaptor;
+static XvImagePtr xvImageCacheImage;
+
+static void
+XvFlushAdaptorCaches(const XvAdaptorRec *pAdaptor)
+{
+    if (xvMatchCacheAdaptor == pAdaptor)
+        xvMatchCacheAdaptor = NULL;
+    if (xvImageCacheAdaptor == pAdaptor)
+        xvImageCacheAdaptor = NULL;
+}
+
 int
 XvdiMatchPort(XvPortPtr pPort, DrawablePtr pDraw)
 {
@@ -901,12 +921,18 @@ XvdiMatchPort(XvPortPtr pPort, DrawablePtr pDraw)
     if (pa->pScreen != pDraw->pScreen)
         return BadMatch;
 
+    if (pa == xvMatchCacheAdaptor && pDraw->depth == xvMatchCacheDepth)
+        return Success;
+
     nf = pa->nFormats;
     pf = pa->pFormats;
 
     while (nf--) {
-        if (pf->depth == pDraw->depth)
+        if (pf->depth == pDraw->depth) {
+            xvMatchCacheAdaptor = pa;
+            xvMatchCacheDepth = pf->depth;
             return Success;
+        }
         pf++;
     }
 
@@ -914,6 +940,25 @@ XvdiMatchPort(XvPortPtr pPort, DrawablePtr pDraw)
 
 }
 
+XvImagePtr
+XvdiFindImage(XvPortPtr pPort, CARD32 id)
+{
+    XvAdaptorPtr pa = pPort->pAdaptor;
+
+    if (pa == xvImageCacheAdaptor && xvImageCacheImage->id == id)
+        return xvImageCacheImage;
+
+    for (int i = 0; i < pa->nImages; i++) {
+        if (pa->pImages[i].id == id) {
+            xvImageCacheAdaptor = pa;
+            xvImageCacheImage = &pa->pImages[i];
+            return xvImageCacheImage;
+        }
+    }
+
+    return NULL;
+}
+
 int
 XvdiSetPortAttribute(ClientPtr client,
                      XvPortPtr pPort, Atom attribute, INT32 value)
@@ -972,6 +1017,8 @@ XvFreeAdaptor(XvAdaptorPtr pAdaptor)
 {
     int i;
 
+    XvFlushAdaptorCaches(pAdaptor);
+
     free(pAdaptor->name);
     pAdaptor->name = NULL;
 
@@ -755,6 +755,8 @@ XISendDeviceChangedEvent(DeviceIntPtr device, DeviceChangedEvent *dce)
     xXIDeviceChangedEvent *dcce;
     int rc;
 
+    XIQueryDeviceInvalidateCache();
+
     rc = EventToXI2((InternalEvent *) dce, (xEvent **) &dcce);
     if (rc != Success) {
         ErrorF("[Xi] event conversion from DCE failed with code %d\n", rc);
@@ -764,7 +766,6 @@ XISendDeviceChangedEvent(DeviceIntPtr device, DeviceChangedEvent *dce)
     /* we don't actually swap if there's a NULL client, swapping is done
      * later when event is delivered. */
     SendEventToAllWindows(device, XI_DeviceChangedMask, (xEvent *) dcce, 1);
-    free(dcce);
 }
 
 static void
@@ -1062,13 +1063,13 @@ TouchSendOwnershipEvent(DeviceIntPtr dev, TouchPointInfoPtr ti, int reason,
                         XID resource)
 {
     int nev, i;
-    InternalEvent *tel = InitEventList(GetMaximumEventsNum());
+    InternalEvent *tel = AcquireEventList(dev);
 
     nev = GetTouchOwnershipEvents(tel, dev, ti, reason, resource, 0);
     for (i = 0; i < nev; i++)
         mieqProcessDeviceEvent(dev, tel + i, NULL);
 
-    FreeEventList(tel, GetMaximumEventsNum());
+    ReleaseEventList(dev, tel);
 }
 
 /**
@@ -1102,7 +1103,6 @@ DeliverOneTouchEvent(ClientPtr client, DeviceIntPtr dev, TouchPointInfoPtr ti,
     if (XaceHookReceiveAccess(client, win, xi2, 1) != Success)
         return FALSE;
     TryClientEvents(client, dev, xi2, 1, filter, filter, NullGrab);
-    free(xi2);
 
     /* Returning the value from TryClientEvents isn't useful, since all our
      * resource-gone cleanups will update the delivery list anyway. */
@@ -1376,6 +1376,21 @@ RetrieveTouchDeliveryData(DeviceIntPtr dev, TouchPointInfoPtr ti,
         *mask = (*grab)->xi2mask;
     }
     else {
+        /* a touch frame can carry ten updates and each one used to redo
+           the resource lookup and interest-list walk below; the result
+           only changes when selections or the window tree do, so reuse
+           the last resolution across the burst */
+        if (listener->resolveInterestGen == dixEventInterestGeneration &&
+            listener->resolveTreeGen == dixWindowTreeGeneration &&
+            listener->resolveEvtype == ev->any.type &&
+            listener->resolveEmulated == ti->emulate_pointer) {
+            *win = listener->resolveWin;
+            *client = listener->resolveClient;
+            *mask = listener->resolveMask;
+            *grab = NULL;
+            return TRUE;
+        }
+
         rc = dixLookupResourceByType((void **) win, listener->listener,
                                      listener->resource_type,
                                      serverClient, DixSendAccess);
@@ -1434,6 +1449,14 @@ RetrieveTouchDeliveryData(DeviceIntPtr dev, TouchPointInfoPtr ti,
             *client = oclients ? dixClientForOtherClients(oclients) : dixClientForWindow(*win);
         }
 
+        listener->resolveInterestGen = dixEventInterestGeneration;
+        listener->resolveTreeGen = dixWindowTreeGeneration;
+        listener->resolveEvtype = ev->any.type;
+        listener->resolveEmulated = ti->emulate_pointer;
+        listener->resolveWin = *win;
+        listener->resolveClient = *client;
+        listener->resolveMask = *mask;
+
         *grab = NULL;
     }
 
@@ -1755,7 +1778,6 @@ ProcessBarrierEvent(InternalEvent *e, DeviceIntPtr dev)
         DeliverEventsToWindow(dev, pWin, ev, 1,
                               filter, NullGrab);
     }
-    free(ev);
 }
 
 static BOOL
@@ -2241,7 +2263,6 @@ DeliverOneGestureEvent(ClientPtr client, DeviceIntPtr dev, GestureInfoPtr gi,
     if (XaceHookReceiveAccess(client, win, xi2, 1) != Success)
         return FALSE;
     TryClientEvents(client, dev, xi2, 1, filter, filter, NullGrab);
-    free(xi2);
 
     /* Returning the value from TryClientEvents isn't useful, since all our
      * resource-gone cleanups will update the delivery list anyway. */
@@ -2279,6 +2300,17 @@ RetrieveGestureDeliveryData(DeviceIntPtr dev, InternalEvent *ev, GestureListener
         *win = (*grab)->window;
     }
     else {
+        /* pinch/swipe updates stream at input rate and the listener is
+           pinned for the whole gesture; reuse the last resolution until
+           selections or the window tree change */
+        if (listener->resolveInterestGen == dixEventInterestGeneration &&
+            listener->resolveTreeGen == dixWindowTreeGeneration &&
+            listener->resolveEvtype == ev->any.type) {
+            *win = listener->resolveWin;
+            *client = listener->resolveClient;
+            return TRUE;
+        }
+
         rc = dixLookupResourceByType((void **) win, listener->listener, listener->resource_type,
                                      serverClient, DixSendAccess);
         if (rc != Success)
@@ -2296,6 +2328,12 @@ RetrieveGestureDeliveryData(DeviceIntPtr dev, InternalEvent *ev, GestureListener
         BUG_RETURN_VAL(!iclients, FALSE);
 
         *client = dixClientForInputClients(iclients);
+
+        listener->resolveInterestGen = dixEventInterestGeneration;
+        listener->resolveTreeGen = dixWindowTreeGeneration;
+        listener->resolveEvtype = ev->any.type;
+        listener->resolveWin = *win;
+        listener->resolveClient = *client;
     }
 
     return TRUE;
@@ -2791,6 +2829,8 @@ RecalculateDeviceDeliverableEvents(WindowPtr pWin)
     WindowPtr pChild, tmp;
     int i;
 
+    dixEventInterestGeneration++;
+
     pChild = pWin;
     while (1) {
         if ((inputMasks = wOtherInputMasks(pChild)) != 0) {
@@ -95,8 +95,25 @@ struct PointerBarrierClient {
     struct xorg_list per_device;
 };
 
+/* The screen is divided into BARRIER_GRID_SIZE x BARRIER_GRID_SIZE cells
+ * so motion processing only has to test barriers near the movement vector
+ * instead of every barrier on the screen.
+ */
+#define BARRIER_GRID_SIZE 16
+#define BARRIER_GRID_CELLS (BARRIER_GRID_SIZE * BARRIER_GRID_SIZE)
+
 typedef struct _BarrierScreen {
     struct xorg_list barriers;
+
+    /* Spatial index over barriers, rebuilt on barrier create/destroy and
+     * when the screen size changes.  grid_entries holds the barriers of
+     * cell n at indices [grid_start[n], grid_start[n+1]); when it is NULL
+     * (no barriers, or allocation failure) the full list is walked instead.
+     */
+    int grid_width;
+    int grid_height;
+    int grid_start[BARRIER_GRID_CELLS + 1];
+    PointerBarrierClientPtr *grid_entries;
 } BarrierScreenRec, *BarrierScreenPtr;
 
 #define GetBarrierScreen(s) ((BarrierScreenPtr)dixLookupPrivate(&(s)->devPrivates, BarrierScreenPrivateKey))
@@ -293,6 +310,132 @@ barrier_inside_hit_box(struct PointerBarrier *barrier, int x, int y)
     return x >= x1 && x <= x2 && y >= y1 && y <= y2;
 }
 
+static int
+barrier_grid_pos(int v, int extent)
+{
+    int c = (v * BARRIER_GRID_SIZE) / extent;
+
+    if (c < 0)
+        c = 0;
+    if (c >= BARRIER_GRID_SIZE)
+        c = BARRIER_GRID_SIZE - 1;
+    return c;
+}
+
+/**
+ * Resolve one barrier axis to the extent it actually covers on screen.
+ * Negative endpoints mean the barrier extends to infinity along that axis
+ * (see inside_segment()).
+ */
+static void
+barrier_axis_extent(int v1, int v2, int screen_extent, int *lo, int *hi)
+{
+    if (v1 < 0 && v2 < 0) {
+        *lo = 0;
+        *hi = screen_extent;
+    }
+    else if (v1 < 0) {
+        *lo = 0;
+        *hi = v2;
+    }
+    else if (v2 < 0) {
+        *lo = v1;
+        *hi = screen_extent;
+    }
+    else {
+        *lo = v1;
+        *hi = v2;
+    }
+}
+
+/**
+ * Compute the grid cell range covered by the box x1/y1 → x2/y2.
+ */
+static void
+barrier_grid_box(BarrierScreenPtr cs, int x1, int y1, int x2, int y2,
+                 int *cx1, int *cy1, int *cx2, int *cy2)
+{
+    *cx1 = barrier_grid_pos(x1, cs->grid_width);
+    *cx2 = barrier_grid_pos(x2, cs->grid_width);
+    *cy1 = barrier_grid_pos(y1, cs->grid_height);
+    *cy2 = barrier_grid_pos(y2, cs->grid_height);
+}
+
+/**
+ * Rebuild the spatial index from the barrier list.  Each barrier is entered
+ * into every grid cell its extended hit box overlaps; a barrier spanning
+ * several cells of the lookup range is simply tested more than once.
+ */
+static void
+barrier_grid_rebuild(ScreenPtr screen, BarrierScreenPtr cs)
+{
+    struct PointerBarrierClient *c;
+    int counts[BARRIER_GRID_CELLS];
+    int fill[BARRIER_GRID_CELLS];
+    int cx1, cy1, cx2, cy2, cx, cy;
+    int total = 0;
+    int i;
+
+    free(cs->grid_entries);
+    cs->grid_entries = NULL;
+    cs->grid_width = screen->width;
+    cs->grid_height = screen->height;
+
+    if (cs->grid_width <= 0 || cs->grid_height <= 0)
+        return;
+
+    memset(counts, 0, sizeof(counts));
+    xorg_list_for_each_entry(c, &cs->barriers, entry) {
+        struct PointerBarrier *b = &c->barrier;
+        int lo_x, hi_x, lo_y, hi_y;
+
+        barrier_axis_extent(b->x1, b->x2, cs->grid_width, &lo_x, &hi_x);
+        barrier_axis_extent(b->y1, b->y2, cs->grid_height, &lo_y, &hi_y);
+        barrier_grid_box(cs,
+                         lo_x - HIT_EDGE_EXTENTS, lo_y - HIT_EDGE_EXTENTS,
+                         hi_x + HIT_EDGE_EXTENTS, hi_y + HIT_EDGE_EXTENTS,
+                         &cx1, &cy1, &cx2, &cy2);
+
+        for (cy = cy1; cy <= cy2; cy++) {
+            for (cx = cx1; cx <= cx2; cx++) {
+                counts[cy * BARRIER_GRID_SIZE + cx]++;
+                total++;
+            }
+        }
+    }
+
+    if (total == 0)
+        return;
+
+    cs->grid_entries = calloc(total, sizeof(PointerBarrierClientPtr));
+    if (!cs->grid_entries)
+        return;                 /* fall back to walking the full list */
+
+    cs->grid_start[0] = 0;
+    for (i = 0; i < BARRIER_GRID_CELLS; i++) {
+        fill[i] = cs->grid_start[i];
+        cs->grid_start[i + 1] = cs->grid_start[i] + counts[i];
+    }
+
+    xorg_list_for_each_entry(c, &cs->barriers, entry) {
+        struct PointerBarrier *b = &c->barrier;
+        int lo_x, hi_x, lo_y, hi_y;
+
+        barrier_axis_extent(b->x1, b->x2, cs->grid_width, &lo_x, &hi_x);
+        barrier_axis_extent(b->y1, b->y2, cs->grid_height, &lo_y, &hi_y);
+        barrier_grid_box(cs,
+                         lo_x - HIT_EDGE_EXTENTS, lo_y - HIT_EDGE_EXTENTS,
+                         hi_x + HIT_EDGE_EXTENTS, hi_y + HIT_EDGE_EXTENTS,
+                         &cx1, &cy1, &cx2, &cy2);
+
+        for (cy = cy1; cy <= cy2; cy++) {
+            for (cx = cx1; cx <= cx2; cx++) {
+                cs->grid_entries[fill[cy * BARRIER_GRID_SIZE + cx]++] = c;
+            }
+        }
+    }
+}
+
 static BOOL
 barrier_blocks_device(struct PointerBarrierClient *client,
                       DeviceIntPtr dev)
@@ -328,6 +471,37 @@ barrier_blocks_device(struct PointerBarrierClient *client,
  * @param y2 Y end coordinate of movement vector
  * @return The barrier nearest to the movement origin that blocks this movement.
  */
+static void
+barrier_update_nearest(struct PointerBarrierClient *c, DeviceIntPtr dev,
+                       int dir, int x1, int y1, int x2, int y2,
+                       struct PointerBarrierClient **nearest,
+                       double *min_distance)
+{
+    struct PointerBarrier *b = &c->barrier;
+    struct PointerBarrierDevice *pbd;
+    double distance;
+
+    pbd = GetBarrierDevice(c, dev->id);
+    if (!pbd)
+        return;
+
+    if (pbd->seen)
+        return;
+
+    if (!barrier_is_blocking_direction(b, dir))
+        return;
+
+    if (!barrier_blocks_device(c, dev))
+        return;
+
+    if (barrier_is_blocking(b, x1, y1, x2, y2, &distance)) {
+        if (*min_distance > distance) {
+            *min_distance = distance;
+            *nearest = c;
+        }
+    }
+}
+
 static struct PointerBarrierClient *
 barrier_find_nearest(BarrierScreenPtr cs, DeviceIntPtr dev,
                      int dir,
@@ -336,31 +510,33 @@ barrier_find_nearest(BarrierScreenPtr cs, DeviceIntPtr dev,
     struct PointerBarrierClient *c, *nearest = NULL;
     double min_distance = INT_MAX;      /* can't get higher than that in X anyway */
 
-    xorg_list_for_each_entry(c, &cs->barriers, entry) {
-        struct PointerBarrier *b = &c->barrier;
-        struct PointerBarrierDevice *pbd;
-        double distance;
-
-        pbd = GetBarrierDevice(c, dev->id);
-        if (!pbd)
-            continue;
-
-        if (pbd->seen)
-            continue;
-
-        if (!barrier_is_blocking_direction(b, dir))
-            continue;
-
-        if (!barrier_blocks_device(c, dev))
-            continue;
-
-        if (barrier_is_blocking(b, x1, y1, x2, y2, &distance)) {
-            if (min_distance > distance) {
-                min_distance = distance;
-                nearest = c;
+    if (cs->grid_entries) {
+        /* Only test barriers in the cells the movement vector passes
+         * through.  Barriers spanning several of these cells are tested
+         * more than once, which is harmless for a minimum search.
+         */
+        int cx1, cy1, cx2, cy2, cx, cy, i;
+
+        barrier_grid_box(cs, min(x1, x2), min(y1, y2),
+                         max(x1, x2), max(y1, y2), &cx1, &cy1, &cx2, &cy2);
+
+        for (cy = cy1; cy <= cy2; cy++) {
+            for (cx = cx1; cx <= cx2; cx++) {
+                int cell = cy * BARRIER_GRID_SIZE + cx;
+
+                for (i = cs->grid_start[cell]; i < cs->grid_start[cell + 1];
+                     i++)
+                    barrier_update_nearest(cs->grid_entries[i], dev, dir,
+                                           x1, y1, x2, y2,
+                                           &nearest, &min_distance);
             }
         }
     }
+    else {
+        xorg_list_for_each_entry(c, &cs->barriers, entry)
+            barrier_update_nearest(c, dev, dir, x1, y1, x2, y2,
+                                   &nearest, &min_distance);
+    }
 
     return nearest;
 }
@@ -426,6 +602,11 @@ input_constrain_cursor(DeviceIntPtr dev, ScreenPtr screen,
     if (xorg_list_is_empty(&cs->barriers) || InputDevIsFloating(dev))
         goto out;
 
+    /* RandR may have resized the screen since the index was built. */
+    if (cs->grid_entries &&
+        (cs->grid_width != screen->width || cs->grid_height != screen->height))
+        barrier_grid_rebuild(screen, cs);
+
     /**
      * This function is only called for slave devices, but pointer-barriers
      * are for master-devices only. Flip the device to the master here,
@@ -642,6 +823,7 @@ CreatePointerBarrierClient(ClientPtr client,
         ret->barrier.directions &= ~(BarrierPositiveY | BarrierNegativeY);
     input_lock();
     xorg_list_add(&ret->entry, &cs->barriers);
+    barrier_grid_rebuild(screen, cs);
     input_unlock();
 
     *client_out = ret;
@@ -710,6 +892,7 @@ BarrierFreeBarrier(void *data, XID id)
 
     input_lock();
     xorg_list_del(&c->entry);
+    barrier_grid_rebuild(screen, GetBarrierScreen(screen));
     input_unlock();
 
     FreePointerBarrierClient(c);
@@ -945,6 +1128,8 @@ XIBarrierReset(void)
 {
     DIX_FOR_EACH_SCREEN({
         BarrierScreenPtr cs = GetBarrierScreen(walkScreen);
+        if (cs)
+            free(cs->grid_entries);
         free(cs);
         SetBarrierScreen(walkScreen, NULL);
     });
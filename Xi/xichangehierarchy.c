@@ -72,6 +72,8 @@ XISendDeviceHierarchyEvent(int flags[MAXDEVICES])
     if (!flags)
         return;
 
+    XIQueryDeviceInvalidateCache();
+
     ev = calloc(1, sizeof(xXIHierarchyEvent) +
                 MAXDEVICES * sizeof(xXIHierarchyInfo));
     if (!ev)
@@ -57,6 +57,8 @@ static int
  ListDeviceInfo(ClientPtr client, DeviceIntPtr dev, xXIDeviceInfo * info);
 static int SizeDeviceInfo(DeviceIntPtr dev);
 static void SwapDeviceInfo(DeviceIntPtr dev, xXIDeviceInfo * info);
+static int CopyDeviceInfo(ClientPtr client, DeviceIntPtr dev,
+                          xXIDeviceInfo * info);
 
 int
 ProcXIQueryDevice(ClientPtr client)
@@ -113,9 +115,7 @@ ProcXIQueryDevice(ClientPtr client)
     };
 
     if (dev) {
-        len = ListDeviceInfo(client, dev, (xXIDeviceInfo *) info);
-        if (client->swapped)
-            SwapDeviceInfo(dev, (xXIDeviceInfo *) info);
+        len = CopyDeviceInfo(client, dev, (xXIDeviceInfo *) info);
         info += len;
         reply.num_devices = 1;
     }
@@ -123,9 +123,7 @@ ProcXIQueryDevice(ClientPtr client)
         i = 0;
         for (dev = inputInfo.devices; dev; dev = dev->next, i++) {
             if (!skip[i]) {
-                len = ListDeviceInfo(client, dev, (xXIDeviceInfo *) info);
-                if (client->swapped)
-                    SwapDeviceInfo(dev, (xXIDeviceInfo *) info);
+                len = CopyDeviceInfo(client, dev, (xXIDeviceInfo *) info);
                 info += len;
                 reply.num_devices++;
             }
@@ -133,9 +131,7 @@ ProcXIQueryDevice(ClientPtr client)
 
         for (dev = inputInfo.off_devices; dev; dev = dev->next, i++) {
             if (!skip[i]) {
-                len = ListDeviceInfo(client, dev, (xXIDeviceInfo *) info);
-                if (client->swapped)
-                    SwapDeviceInfo(dev, (xXIDeviceInfo *) info);
+                len = CopyDeviceInfo(client, dev, (xXIDeviceInfo *) info);
                 info += len;
                 reply.num_devices++;
             }
@@ -647,3 +643,137 @@ SwapDeviceInfo(DeviceIntPtr dev, xXIDeviceInfo * info)
     swaps(&info->name_len);
 
 }
+
+/*
+ * The serialized device description only changes on hierarchy or class
+ * changes, but toolkits re-query every device on every hierarchy event, so
+ * one hotplug multiplies the serialization work across all connected
+ * clients. Cache the wire description per device, keyed on a serial bumped
+ * by the hierarchy/device-changed event sources, and patch the live
+ * button/valuator state into the copy on each hit. The reportState and
+ * gesture visibility both change the blob per client, so they are part of
+ * the key.
+ */
+typedef struct {
+    unsigned long serial;       /* 0 = empty */
+    Bool reportState;
+    Bool listGestures;
+    char *blob;                 /* unswapped wire description */
+    int len;
+    int buttonOfs;              /* offset of the xXIButtonInfo, or -1 */
+    int numAxes;
+    int axisOfs[MAX_VALUATORS]; /* offsets of the xXIValuatorInfos */
+} XIDeviceInfoCacheRec;
+
+static XIDeviceInfoCacheRec xiDeviceInfoCache[MAXDEVICES];
+static unsigned long xiDeviceInfoSerial = 1;
+
+void
+XIQueryDeviceInvalidateCache(void)
+{
+    xiDeviceInfoSerial++;
+}
+
+static void
+XIDeviceInfoCacheStore(DeviceIntPtr dev, Bool reportState, Bool listGestures,
+                       const char *data, int len)
+{
+    XIDeviceInfoCacheRec *entry = &xiDeviceInfoCache[dev->id];
+    const xXIDeviceInfo *info = (const xXIDeviceInfo *) data;
+    const char *any;
+    int i;
+
+    entry->serial = 0;
+    free(entry->blob);
+    entry->blob = malloc(len);
+    if (!entry->blob)
+        return;
+    memcpy(entry->blob, data, len);
+    entry->len = len;
+    entry->reportState = reportState;
+    entry->listGestures = listGestures;
+    entry->buttonOfs = -1;
+    entry->numAxes = 0;
+
+    /* remember where the live state lives, so hits can patch it */
+    any = data + sizeof(xXIDeviceInfo) + pad_to_int32(info->name_len);
+    for (i = 0; i < info->num_classes; i++) {
+        const xXIAnyInfo *any_info = (const xXIAnyInfo *) any;
+
+        switch (any_info->type) {
+        case XIButtonClass:
+            entry->buttonOfs = any - data;
+            break;
+        case XIValuatorClass:
+            if (entry->numAxes < MAX_VALUATORS)
+                entry->axisOfs[entry->numAxes++] = any - data;
+            break;
+        }
+        any += any_info->length * 4;
+    }
+
+    entry->serial = xiDeviceInfoSerial;
+}
+
+static void
+XIDeviceInfoPatchState(DeviceIntPtr dev, XIDeviceInfoCacheRec *entry,
+                       char *data)
+{
+    int i;
+
+    if (entry->buttonOfs >= 0 && dev->button) {
+        xXIButtonInfo *binfo = (xXIButtonInfo *) (data + entry->buttonOfs);
+        int mask_len;
+        unsigned char *bits;
+        Atom *labels;
+
+        ButtonInfoData(binfo, &mask_len, &bits, &labels);
+        memset(bits, 0, mask_len * 4);
+        for (i = 0; i < binfo->num_buttons; i++)
+            if (BitIsOn(dev->button->down, i))
+                SetBit(bits, i);
+    }
+
+    for (i = 0; i < entry->numAxes; i++) {
+        xXIValuatorInfo *vinfo =
+            (xXIValuatorInfo *) (data + entry->axisOfs[i]);
+
+        if (dev->valuator && vinfo->number < dev->valuator->numAxes)
+            vinfo->value =
+                double_to_fp3232(dev->valuator->axisVal[vinfo->number]);
+    }
+}
+
+/**
+ * Write the info for device dev into the buffer pointed to by info, using
+ * the cached wire description when it is still current.
+ *
+ * @return The number of bytes used.
+ */
+static int
+CopyDeviceInfo(ClientPtr client, DeviceIntPtr dev, xXIDeviceInfo * info)
+{
+    Bool reportState =
+        dixCallDeviceAccessCallback(client, dev, DixReadAccess) == Success;
+    Bool listGestures = dev->gesture && ShouldListGestureInfo(client);
+    XIDeviceInfoCacheRec *entry = &xiDeviceInfoCache[dev->id];
+    int len;
+
+    if (entry->serial == xiDeviceInfoSerial &&
+        entry->reportState == reportState &&
+        entry->listGestures == listGestures) {
+        memcpy(info, entry->blob, entry->len);
+        if (reportState)
+            XIDeviceInfoPatchState(dev, entry, (char *) info);
+        len = entry->len;
+    }
+    else {
+        len = ListDeviceInfo(client, dev, info);
+        XIDeviceInfoCacheStore(dev, reportState, listGestures,
+                               (const char *) info, len);
+    }
+
+    if (client->swapped)
+        SwapDeviceInfo(dev, info);
+    return len;
+}
@@ -36,4 +36,9 @@ int ListValuatorInfo(DeviceIntPtr dev, xXIValuatorInfo * info,
                      int axisnumber, Bool reportState);
 int ListScrollInfo(DeviceIntPtr dev, xXIScrollInfo * info, int axisnumber);
 int ListTouchInfo(DeviceIntPtr dev, xXITouchInfo * info);
+
+/* Drop the cached wire device descriptions; called by the sources of
+ * hierarchy and device-changed events, which are the points where the
+ * descriptions can change. */
+void XIQueryDeviceInvalidateCache(void);
 #endif                          /* QUERYDEV_H */
@@ -313,7 +313,7 @@ compFreeClientWindow(WindowPtr pWin, XID id)
 
     if (pPixmap) {
         compRestoreWindow(pWin, pPixmap);
-        dixDestroyPixmap(pPixmap, 0);
+        compRetirePixmap(pPixmap);
     }
 }
 
@@ -524,6 +524,80 @@ compUnredirectOneSubwindow(WindowPtr pParent, WindowPtr pWin)
     return Success;
 }
 
+/*
+ * Look for a retired backing pixmap of exactly the right geometry.  The
+ * contents are stale, but a freshly created pixmap is uninitialized too,
+ * so callers treat both the same way.
+ */
+static PixmapPtr
+compFetchRetiredPixmap(ScreenPtr pScreen, int w, int h, int depth)
+{
+    CompScreenPtr cs = GetCompScreen(pScreen);
+
+    for (int i = 0; i < COMP_PIXMAP_POOL_SIZE; i++) {
+        PixmapPtr pPixmap = cs->retiredPixmaps[i].pPixmap;
+
+        if (pPixmap &&
+            pPixmap->drawable.width == w &&
+            pPixmap->drawable.height == h &&
+            pPixmap->drawable.depth == depth) {
+            cs->retiredPixmaps[i].pPixmap = NullPixmap;
+            pPixmap->drawable.serialNumber = NEXT_SERIAL_NUMBER;
+            return pPixmap;
+        }
+    }
+    return NullPixmap;
+}
+
+/*
+ * Offer a backing pixmap that is no longer needed to the pool; destroy
+ * it if it cannot be pooled.  Only pixmaps nothing else references are
+ * kept -- a client may still hold the old storage via NameWindowPixmap.
+ */
+void
+compRetirePixmap(PixmapPtr pPixmap)
+{
+    CompScreenPtr cs = GetCompScreen(pPixmap->drawable.pScreen);
+    CompRetiredPixmapRec *victim = NULL;
+    unsigned long bytes = (unsigned long) pPixmap->devKind *
+        pPixmap->drawable.height;
+
+    if (pPixmap->refcnt != 1 || bytes > COMP_PIXMAP_POOL_MAX_BYTES) {
+        dixDestroyPixmap(pPixmap, 0);
+        return;
+    }
+
+    for (int i = 0; i < COMP_PIXMAP_POOL_SIZE; i++) {
+        CompRetiredPixmapRec *entry = &cs->retiredPixmaps[i];
+
+        if (!entry->pPixmap) {
+            victim = entry;
+            break;
+        }
+        if (!victim || (INT32) (entry->serial - victim->serial) < 0)
+            victim = entry;
+    }
+    if (victim->pPixmap)
+        dixDestroyPixmap(victim->pPixmap, 0);
+
+    pPixmap->drawable.id = 0;
+    victim->pPixmap = pPixmap;
+    victim->serial = ++cs->retiredPixmapSerial;
+}
+
+void
+compFreeRetiredPixmaps(ScreenPtr pScreen)
+{
+    CompScreenPtr cs = GetCompScreen(pScreen);
+
+    for (int i = 0; i < COMP_PIXMAP_POOL_SIZE; i++) {
+        if (cs->retiredPixmaps[i].pPixmap) {
+            dixDestroyPixmap(cs->retiredPixmaps[i].pPixmap, 0);
+            cs->retiredPixmaps[i].pPixmap = NullPixmap;
+        }
+    }
+}
+
 static PixmapPtr
 compNewPixmap(WindowPtr pWin, int x, int y, int w, int h)
 {
@@ -531,8 +605,11 @@ compNewPixmap(WindowPtr pWin, int x, int y, int w, int h)
     WindowPtr pParent = pWin->parent;
     PixmapPtr pPixmap;
 
-    pPixmap = (*pScreen->CreatePixmap) (pScreen, w, h, pWin->drawable.depth,
-                                        CREATE_PIXMAP_USAGE_BACKING_PIXMAP);
+    pPixmap = compFetchRetiredPixmap(pScreen, w, h, pWin->drawable.depth);
+    if (!pPixmap)
+        pPixmap = (*pScreen->CreatePixmap) (pScreen, w, h,
+                                            pWin->drawable.depth,
+                                            CREATE_PIXMAP_USAGE_BACKING_PIXMAP);
 
     if (!pPixmap)
         return 0;
@@ -119,6 +119,20 @@ typedef struct _CompImplicitRedirectException {
     XID winVisual;
 } CompImplicitRedirectException;
 
+/*
+ * Retired backing pixmaps kept around for reuse, so that windows which
+ * map and unmap frequently (menus, tooltips) don't pay for a fresh
+ * pixmap allocation on every cycle.
+ */
+#define COMP_PIXMAP_POOL_SIZE           8
+/* Largest backing pixmap worth keeping in the pool, in bytes */
+#define COMP_PIXMAP_POOL_MAX_BYTES      (4 * 1024 * 1024)
+
+typedef struct _CompRetiredPixmap {
+    PixmapPtr pPixmap;
+    CARD32 serial;              /* for LRU eviction */
+} CompRetiredPixmapRec;
+
 typedef struct _CompScreen {
     CopyWindowProcPtr CopyWindow;
     CreateWindowProcPtr CreateWindow;
@@ -160,6 +174,9 @@ typedef struct _CompScreen {
     Window overlayWid;
     CompOverlayClientPtr pOverlayClients;
 
+    CompRetiredPixmapRec retiredPixmaps[COMP_PIXMAP_POOL_SIZE];
+    CARD32 retiredPixmapSerial;
+
     SourceValidateProcPtr SourceValidate;
 } CompScreenRec, *CompScreenPtr;
 
@@ -216,6 +233,12 @@ int
 Bool
  compAllocPixmap(WindowPtr pWin);
 
+void
+ compRetirePixmap(PixmapPtr pPixmap);
+
+void
+ compFreeRetiredPixmaps(ScreenPtr pScreen);
+
 void
  compSetParentPixmap(WindowPtr pWin);
 
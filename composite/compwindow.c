@@ -181,7 +181,7 @@ compCheckRedirect(WindowPtr pWin)
 
             compSetParentPixmap(pWin);
             compRestoreWindow(pWin, pPixmap);
-            dixDestroyPixmap(pPixmap, 0);
+            compRetirePixmap(pPixmap);
         }
     }
     else if (should) {
@@ -370,7 +370,7 @@ compFreeOldPixmap(WindowPtr pWin)
         CompWindowPtr cw = GetCompWindow(pWin);
 
         if (cw->pOldPixmap) {
-            dixDestroyPixmap(cw->pOldPixmap, 0);
+            compRetirePixmap(cw->pOldPixmap);
             cw->pOldPixmap = NullPixmap;
         }
     }
@@ -598,7 +598,7 @@ void compWindowDestroy(CallbackListPtr *pcbl, ScreenPtr pScreen, WindowPtr pWin)
         PixmapPtr pPixmap = (*pScreen->GetWindowPixmap) (pWin);
 
         compSetParentPixmap(pWin);
-        dixDestroyPixmap(pPixmap, 0);
+        compRetirePixmap(pPixmap);
     }
 
     /* Did we just destroy the overlay window? */
@@ -657,18 +657,9 @@ compWindowUpdateAutomatic(WindowPtr pWin)
     PictFormatPtr pDstFormat = PictureWindowFormat(pWin->parent);
     int error;
     RegionPtr pRegion = DamageRegion(cw->damage);
-    PicturePtr pSrcPicture = CreatePicture(0, &pSrcPixmap->drawable,
-                                           pSrcFormat,
-                                           0, 0,
-                                           serverClient,
-                                           &error);
+    PicturePtr pSrcPicture;
+    PicturePtr pDstPicture;
     XID subwindowMode = IncludeInferiors;
-    PicturePtr pDstPicture = CreatePicture(0, &pParent->drawable,
-                                           pDstFormat,
-                                           CPSubwindowMode,
-                                           &subwindowMode,
-                                           serverClient,
-                                           &error);
 
     /*
      * First move the region from window to screen coordinates
@@ -680,11 +671,33 @@ compWindowUpdateAutomatic(WindowPtr pWin)
      */
     RegionIntersect(pRegion, pRegion, &cw->borderClip);
 
+    /*
+     * Nothing survived the clip -- common for obscured windows in a
+     * nested-redirection chain.  Skip the picture setup and composite
+     * entirely; emptying the damage below is all that's needed.
+     */
+    if (!RegionNotEmpty(pRegion)) {
+        DamageEmpty(cw->damage);
+        return;
+    }
+
     /*
      * Now translate from screen to dest coordinates
      */
     RegionTranslate(pRegion, -pParent->drawable.x, -pParent->drawable.y);
 
+    pSrcPicture = CreatePicture(0, &pSrcPixmap->drawable,
+                                pSrcFormat,
+                                0, 0,
+                                serverClient,
+                                &error);
+    pDstPicture = CreatePicture(0, &pParent->drawable,
+                                pDstFormat,
+                                CPSubwindowMode,
+                                &subwindowMode,
+                                serverClient,
+                                &error);
+
     /*
      * Clip the picture
      */
@@ -59,6 +59,29 @@
 
 static struct udev_monitor *udev_monitor;
 
+/* Hotplug events are not handled as they arrive but collected into this
+ * list and processed in one go once the bus has settled, so a dock or hub
+ * delivering a burst of devices does not stall the server once per device.
+ * Entries are coalesced by syspath: only the last event for a device is
+ * kept, which is correct because processing an "add" always removes any
+ * previous instance first.
+ */
+struct pending_udev_event {
+    struct pending_udev_event *next;
+    struct udev_device *udev_device;
+    const char *action;
+};
+
+static struct pending_udev_event *pending_events;
+static int num_pending_events;
+static OsTimerPtr settle_timer;
+
+/* How long to wait for further events before configuring devices, and how
+ * many events to queue up before configuring regardless.
+ */
+#define UDEV_SETTLE_MS 50
+#define UDEV_SETTLE_MAX_PENDING 32
+
 #ifdef CONFIG_UDEV_KMS
 static void
 config_udev_odev_setup_attribs(struct udev_device *udev_device, const char *path, const char *syspath,
@@ -346,6 +369,92 @@ device_removed(struct udev_device *device)
     free(value);
 }
 
+static void
+process_event(struct udev_device *udev_device, const char *action)
+{
+    if (!strcmp(action, "add")) {
+        device_removed(udev_device);
+        device_added(udev_device);
+    } else if (!strcmp(action, "change")) {
+        /* ignore change for the drm devices */
+        const char *subsys = udev_device_get_subsystem(udev_device);
+
+        if (subsys && strcmp(subsys, "drm")) {
+            device_removed(udev_device);
+            device_added(udev_device);
+        }
+    }
+    else if (!strcmp(action, "remove"))
+        device_removed(udev_device);
+}
+
+static void
+process_pending_events(void)
+{
+    struct pending_udev_event *ev, *next;
+
+    input_lock();
+    for (ev = pending_events; ev; ev = next) {
+        next = ev->next;
+        process_event(ev->udev_device, ev->action);
+        udev_device_unref(ev->udev_device);
+        free(ev);
+    }
+    pending_events = NULL;
+    num_pending_events = 0;
+    input_unlock();
+}
+
+static void
+drop_pending_events(void)
+{
+    struct pending_udev_event *ev, *next;
+
+    for (ev = pending_events; ev; ev = next) {
+        next = ev->next;
+        udev_device_unref(ev->udev_device);
+        free(ev);
+    }
+    pending_events = NULL;
+    num_pending_events = 0;
+}
+
+static CARD32
+settle_timer_expired(OsTimerPtr timer, CARD32 time, void *arg)
+{
+    process_pending_events();
+    return 0;
+}
+
+static void
+queue_event(struct udev_device *udev_device, const char *action)
+{
+    const char *syspath = udev_device_get_syspath(udev_device);
+    struct pending_udev_event *ev, **tail = &pending_events;
+
+    /* Coalesce with an earlier pending event for the same device. */
+    for (ev = pending_events; ev; ev = ev->next) {
+        const char *pending_syspath =
+            udev_device_get_syspath(ev->udev_device);
+
+        if (syspath && pending_syspath && !strcmp(pending_syspath, syspath)) {
+            udev_device_unref(ev->udev_device);
+            ev->udev_device = udev_device;
+            ev->action = action;
+            return;
+        }
+        tail = &ev->next;
+    }
+
+    /* Append, so devices are configured in arrival order. */
+    ev = XNFalloc(sizeof(struct pending_udev_event));
+    ev->udev_device = udev_device;
+    ev->action = action;
+    ev->next = NULL;
+    *tail = ev;
+    num_pending_events++;
+}
+
 static void
 socket_handler(int fd, int ready, void *data)
 {
@@ -355,31 +464,23 @@ socket_handler(int fd, int ready, void *data)
     struct udev_device *udev_device;
     const char *action;
 
-    input_lock();
-    udev_device = udev_monitor_receive_device(udev_monitor);
-    if (!udev_device) {
-        input_unlock();
-        return;
+    /* Drain everything the kernel has queued up in one go. */
+    while ((udev_device = udev_monitor_receive_device(udev_monitor))) {
+        action = udev_device_get_action(udev_device);
+        if (action)
+            queue_event(udev_device, action);
+        else
+            udev_device_unref(udev_device);
     }
-    action = udev_device_get_action(udev_device);
-    if (action) {
-        if (!strcmp(action, "add")) {
-            device_removed(udev_device);
-            device_added(udev_device);
-        } else if (!strcmp(action, "change")) {
-            /* ignore change for the drm devices */
-            const char *subsys = udev_device_get_subsystem(udev_device);
 
-            if (subsys && strcmp(subsys, "drm")) {
-                device_removed(udev_device);
-                device_added(udev_device);
-            }
-        }
-        else if (!strcmp(action, "remove"))
-            device_removed(udev_device);
-    }
-    udev_device_unref(udev_device);
-    input_unlock();
+    if (!pending_events)
+        return;
+
+    if (num_pending_events >= UDEV_SETTLE_MAX_PENDING)
+        process_pending_events();
+    else
+        settle_timer = TimerSet(settle_timer, 0, UDEV_SETTLE_MS,
+                                settle_timer_expired, NULL);
 }
 
 int
@@ -469,6 +570,12 @@ config_udev_fini(void)
 
     udev = udev_monitor_get_udev(udev_monitor);
 
+    if (settle_timer) {
+        TimerFree(settle_timer);
+        settle_timer = NULL;
+    }
+    drop_pending_events();
+
     RemoveNotifyFd(udev_monitor_get_fd(udev_monitor));
     udev_monitor_unref(udev_monitor);
     udev_monitor = NULL;
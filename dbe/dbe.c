@@ -949,6 +949,7 @@ DbeResetProc(ExtensionEntry * extEntry)
     DIX_FOR_EACH_SCREEN({
         DbeScreenPrivPtr pDbeScreenPriv = DBE_SCREEN_PRIV(walkScreen);
         if (pDbeScreenPriv) {
+            miDbeDrainBufferPool(walkScreen);
             dixScreenUnhookWindowDestroy(walkScreen, miDbeWindowDestroy);
             dixScreenUnhookWindowPosition(walkScreen, miDbeWindowPosition);
             free(pDbeScreenPriv);
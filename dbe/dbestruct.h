@@ -168,6 +168,9 @@ typedef struct _DbeWindowPrivRec {
  ******************************************************************************
  */
 
+/* Number of released buffer pixmaps kept around per screen for reuse. */
+#define DBE_NUM_POOLED_BUFFERS	8
+
 typedef struct _DbeScreenPrivRec {
     /* Per-screen DIX routines */
     Bool (*SetupBackgroundPainter) (WindowPtr /*pWin */ ,
@@ -189,6 +192,14 @@ typedef struct _DbeScreenPrivRec {
     void (*WinPrivDelete) (DbeWindowPrivPtr /*pDbeWindowPriv */ ,
                            XID  /*bufId */
         );
+
+    /* Cache of recently released buffer pixmaps, so that windows being
+     * resized (or created/destroyed in bursts) can reuse a pixmap of
+     * matching geometry instead of allocating a fresh one.  Maintained
+     * by the MI code; drained by DbeResetProc().
+     */
+    PixmapPtr pooledBuffers[DBE_NUM_POOLED_BUFFERS];
+    int pooledBufferNext;       /* round-robin eviction slot */
 } DbeScreenPrivRec, *DbeScreenPrivPtr;
 
 #endif                          /* DBE_STRUCT_H */
@@ -113,6 +113,109 @@ miDbeGetVisualInfo(ScreenPtr pScreen, XdbeScreenVisualInfo * pScrVisInfo)
     return TRUE;                /* success */
 }
 
+/******************************************************************************
+ *
+ * DBE MI Procedure: miDbeGetBufferPixmap
+ *
+ * Description:
+ *
+ *     Allocate a buffer pixmap, preferring a pooled pixmap of matching
+ *     geometry over a fresh allocation.  Pooled pixmaps carry stale
+ *     contents; all callers either clear the buffer afterwards or treat
+ *     its initial contents as undefined, which matches what CreatePixmap
+ *     hands back anyway.
+ *
+ *****************************************************************************/
+
+static PixmapPtr
+miDbeGetBufferPixmap(ScreenPtr pScreen, int width, int height, int depth)
+{
+    DbeScreenPrivPtr pDbeScreenPriv = DBE_SCREEN_PRIV(pScreen);
+    int i;
+
+    for (i = 0; i < DBE_NUM_POOLED_BUFFERS; i++) {
+        PixmapPtr pPixmap = pDbeScreenPriv->pooledBuffers[i];
+
+        if (pPixmap &&
+            pPixmap->drawable.width == width &&
+            pPixmap->drawable.height == height &&
+            pPixmap->drawable.depth == depth) {
+            pDbeScreenPriv->pooledBuffers[i] = NULL;
+            return pPixmap;
+        }
+    }
+
+    return (*pScreen->CreatePixmap) (pScreen, width, height, depth, 0);
+}
+
+/******************************************************************************
+ *
+ * DBE MI Procedure: miDbeReleaseBufferPixmap
+ *
+ * Description:
+ *
+ *     Return a buffer pixmap to the per-screen pool for later reuse,
+ *     evicting the oldest pooled pixmap if the pool is full.  Pixmaps
+ *     with additional references cannot be recycled and are destroyed
+ *     the usual way.
+ *
+ *****************************************************************************/
+
+static void
+miDbeReleaseBufferPixmap(ScreenPtr pScreen, PixmapPtr pPixmap)
+{
+    DbeScreenPrivPtr pDbeScreenPriv = DBE_SCREEN_PRIV(pScreen);
+    int i, slot;
+
+    if (!pPixmap)
+        return;
+
+    if (pPixmap->refcnt != 1) {
+        dixDestroyPixmap(pPixmap, 0);
+        return;
+    }
+
+    /* Prefer an empty slot; otherwise evict round-robin. */
+    slot = pDbeScreenPriv->pooledBufferNext;
+    for (i = 0; i < DBE_NUM_POOLED_BUFFERS; i++) {
+        if (!pDbeScreenPriv->pooledBuffers[i]) {
+            slot = i;
+            break;
+        }
+    }
+
+    if (pDbeScreenPriv->pooledBuffers[slot])
+        dixDestroyPixmap(pDbeScreenPriv->pooledBuffers[slot], 0);
+
+    pDbeScreenPriv->pooledBuffers[slot] = pPixmap;
+    pDbeScreenPriv->pooledBufferNext = (slot + 1) % DBE_NUM_POOLED_BUFFERS;
+}
+
+/******************************************************************************
+ *
+ * DBE MI Procedure: miDbeDrainBufferPool
+ *
+ * Description:
+ *
+ *     Destroy all pooled buffer pixmaps for a screen.  Called by
+ *     DbeResetProc() at the end of each server generation.
+ *
+ *****************************************************************************/
+
+void
+miDbeDrainBufferPool(ScreenPtr pScreen)
+{
+    DbeScreenPrivPtr pDbeScreenPriv = DBE_SCREEN_PRIV(pScreen);
+    int i;
+
+    for (i = 0; i < DBE_NUM_POOLED_BUFFERS; i++) {
+        if (pDbeScreenPriv->pooledBuffers[i]) {
+            dixDestroyPixmap(pDbeScreenPriv->pooledBuffers[i], 0);
+            pDbeScreenPriv->pooledBuffers[i] = NULL;
+        }
+    }
+}
+
 /******************************************************************************
  *
  * DBE MI Procedure: miAllocBackBufferName
@@ -147,18 +250,18 @@ miDbeAllocBackBufferName(WindowPtr pWin, XID bufId, int swapAction)
 
         /* Get a front pixmap. */
         if (!(pDbeWindowPriv->pFrontBuffer =
-              (*pScreen->CreatePixmap) (pScreen, pDbeWindowPriv->width,
-                                        pDbeWindowPriv->height,
-                                        pWin->drawable.depth, 0))) {
+              miDbeGetBufferPixmap(pScreen, pDbeWindowPriv->width,
+                                   pDbeWindowPriv->height,
+                                   pWin->drawable.depth))) {
             return BadAlloc;
         }
 
         /* Get a back pixmap. */
         if (!(pDbeWindowPriv->pBackBuffer =
-              (*pScreen->CreatePixmap) (pScreen, pDbeWindowPriv->width,
-                                        pDbeWindowPriv->height,
-                                        pWin->drawable.depth, 0))) {
-            dixDestroyPixmap(pDbeWindowPriv->pFrontBuffer, 0);
+              miDbeGetBufferPixmap(pScreen, pDbeWindowPriv->width,
+                                   pDbeWindowPriv->height,
+                                   pWin->drawable.depth))) {
+            miDbeReleaseBufferPixmap(pScreen, pDbeWindowPriv->pFrontBuffer);
             return BadAlloc;
         }
 
@@ -417,12 +520,14 @@ miDbeWinPrivDelete(DbeWindowPrivPtr pDbeWindowPriv, XID bufId)
      * free some stuff.
      */
 
-    /* Destroy the front and back pixmaps. */
+    /* Recycle the front and back pixmaps. */
     if (pDbeWindowPriv->pFrontBuffer)
-         dixDestroyPixmap(pDbeWindowPriv->pFrontBuffer, 0);
+        miDbeReleaseBufferPixmap(pDbeWindowPriv->pWindow->drawable.pScreen,
+                                 pDbeWindowPriv->pFrontBuffer);
 
     if (pDbeWindowPriv->pBackBuffer)
-        dixDestroyPixmap(pDbeWindowPriv->pBackBuffer, 0);
+        miDbeReleaseBufferPixmap(pDbeWindowPriv->pWindow->drawable.pScreen,
+                                 pDbeWindowPriv->pBackBuffer);
 }
 
 /******************************************************************************
@@ -526,12 +631,12 @@ void miDbeWindowPosition(CallbackListPtr *pcbl, ScreenPtr pScreen, XorgScreenWin
         }
     }
 
-    /* Create DBE buffer pixmaps equal to size of resized window. */
-    pFrontBuffer = (*pScreen->CreatePixmap) (pScreen, width, height,
-                                             pWin->drawable.depth, 0);
+    /* Get DBE buffer pixmaps equal to size of resized window. */
+    pFrontBuffer = miDbeGetBufferPixmap(pScreen, width, height,
+                                        pWin->drawable.depth);
 
-    pBackBuffer = (*pScreen->CreatePixmap) (pScreen, width, height,
-                                            pWin->drawable.depth, 0);
+    pBackBuffer = miDbeGetBufferPixmap(pScreen, width, height,
+                                       pWin->drawable.depth);
 
     if (!pFrontBuffer || !pBackBuffer) {
         /* We failed at creating 1 or 2 of the pixmaps. */
@@ -582,12 +687,12 @@ void miDbeWindowPosition(CallbackListPtr *pcbl, ScreenPtr pScreen, XorgScreenWin
                                           destx, desty);
         }
 
-        /* Destroy the old pixmaps, and point the DBE window priv to the new
+        /* Recycle the old pixmaps, and point the DBE window priv to the new
          * pixmaps.
          */
 
-        dixDestroyPixmap(pDbeWindowPriv->pFrontBuffer, 0);
-        dixDestroyPixmap(pDbeWindowPriv->pBackBuffer, 0);
+        miDbeReleaseBufferPixmap(pScreen, pDbeWindowPriv->pFrontBuffer);
+        miDbeReleaseBufferPixmap(pScreen, pDbeWindowPriv->pBackBuffer);
 
         pDbeWindowPriv->pFrontBuffer = pFrontBuffer;
         pDbeWindowPriv->pBackBuffer = pBackBuffer;
@@ -46,4 +46,6 @@ extern RESTYPE dbeWindowPrivResType;
 
 void miDbeWindowPosition(CallbackListPtr *pcbl, ScreenPtr pScreen, XorgScreenWindowPositionParamRec *param);
 
+void miDbeDrainBufferPool(ScreenPtr pScreen);
+
 #endif                          /* MIDBE_H */
@@ -59,45 +59,83 @@ SOFTWARE.
 #include "dix.h"
 
 #define InitialTableSize 256
+#define InitialHashSize 512     /* slots; power of two, fits the built-ins */
 
 typedef struct _Node {
-    struct _Node *left, *right;
     Atom a;
-    unsigned int fingerPrint;
+    unsigned int hash;
+    unsigned int len;
     const char *string;
 } NodeRec, *NodePtr;
 
 static Atom lastAtom = None;
-static NodePtr atomRoot = NULL;
 static unsigned long tableLength;
-static NodePtr *nodeTable;
+static NodePtr *nodeTable;      /* atom -> node */
+
+/* String-interning table, open addressing with linear probing.  Atoms
+ * are never freed individually, so the table only ever gains entries;
+ * lookups therefore read it without any locking while MakeAtom appends.
+ */
+static unsigned long hashSize;  /* slots; power of two */
+static unsigned long hashUsed;
+static NodePtr *hashTable;
+
+static unsigned int
+HashString(const char *string, unsigned len)
+{
+    unsigned int h = 2166136261u;       /* FNV-1a */
+
+    for (unsigned int i = 0; i < len; i++) {
+        h ^= (unsigned char) string[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void
+HashInsert(NodePtr node)
+{
+    unsigned long mask = hashSize - 1;
+    unsigned long i = node->hash & mask;
+
+    while (hashTable[i])
+        i = (i + 1) & mask;
+    hashTable[i] = node;
+    hashUsed++;
+}
+
+static Bool
+GrowHashTable(void)
+{
+    unsigned long oldSize = hashSize;
+    NodePtr *oldTable = hashTable;
+    NodePtr *table = calloc(2 * oldSize, sizeof(NodePtr));
+
+    if (!table)
+        return FALSE;
+    hashTable = table;
+    hashSize = 2 * oldSize;
+    hashUsed = 0;
+    for (unsigned long i = 0; i < oldSize; i++) {
+        if (oldTable[i])
+            HashInsert(oldTable[i]);
+    }
+    free(oldTable);
+    return TRUE;
+}
 
 Atom
 MakeAtom(const char *string, unsigned len, Bool makeit)
 {
-    NodePtr *np;
-    int comp;
-    unsigned int fp = 0;
-
-    np = &atomRoot;
-    for (unsigned int i = 0; i < (len + 1) / 2; i++) {
-        fp = fp * 27 + (unsigned int)string[i];
-        fp = fp * 27 + (unsigned int)string[len - 1 - i];
-    }
-    while (*np != NULL) {
-        if (fp < (*np)->fingerPrint)
-            np = &((*np)->left);
-        else if (fp > (*np)->fingerPrint)
-            np = &((*np)->right);
-        else {                  /* now start testing the strings */
-            comp = strncmp(string, (*np)->string, len);
-            if ((comp < 0) || ((comp == 0) && (len < strlen((*np)->string))))
-                np = &((*np)->left);
-            else if (comp > 0)
-                np = &((*np)->right);
-            else
-                return (*np)->a;
-        }
+    unsigned int h = HashString(string, len);
+    unsigned long mask = hashSize - 1;
+    unsigned long i = h & mask;
+    NodePtr node;
+
+    for (; (node = hashTable[i]); i = (i + 1) & mask) {
+        if (node->hash == h && node->len == len &&
+            !memcmp(string, node->string, len))
+            return node->a;
     }
     if (makeit) {
         NodePtr nd = calloc(1, sizeof(NodeRec));
@@ -113,6 +151,16 @@ MakeAtom(const char *string, unsigned len, Bool makeit)
                 return BAD_RESOURCE;
             }
         }
+        if (4 * (hashUsed + 1) >= 3 * hashSize && !GrowHashTable() &&
+            hashUsed + 1 >= hashSize) {
+            /* the grow failed and every slot is taken */
+            if (nd->string != string) {
+                /* nd->string has been strdup'ed */
+                free((char *) nd->string);
+            }
+            free(nd);
+            return BAD_RESOURCE;
+        }
         if ((lastAtom + 1) >= tableLength) {
             NodePtr *table;
 
@@ -128,11 +176,11 @@ MakeAtom(const char *string, unsigned len, Bool makeit)
             tableLength <<= 1;
             nodeTable = table;
         }
-        *np = nd;
-        nd->left = nd->right = NULL;
-        nd->fingerPrint = fp;
+        nd->hash = h;
+        nd->len = len;
         nd->a = ++lastAtom;
         nodeTable[lastAtom] = nd;
+        HashInsert(nd);
         return nd->a;
     }
     else
@@ -157,32 +205,31 @@ NameForAtom(Atom atom)
     return node->string;
 }
 
-static void
-FreeAtom(NodePtr patom)
-{
-    if (patom->left)
-        FreeAtom(patom->left);
-    if (patom->right)
-        FreeAtom(patom->right);
-    if (patom->a > XA_LAST_PREDEFINED) {
-        /*
-         * All strings above XA_LAST_PREDEFINED are strdup'ed, so it's safe to
-         * cast here
-         */
-        free((char *) patom->string);
-    }
-    free(patom);
-}
-
 void
 FreeAllAtoms(void)
 {
-    if (atomRoot == NULL)
+    if (nodeTable == NULL)
         return;
-    FreeAtom(atomRoot);
-    atomRoot = NULL;
+    for (Atom a = 1; a <= lastAtom; a++) {
+        NodePtr node = nodeTable[a];
+
+        if (!node)
+            continue;
+        if (node->a > XA_LAST_PREDEFINED) {
+            /*
+             * All strings above XA_LAST_PREDEFINED are strdup'ed, so it's
+             * safe to cast here
+             */
+            free((char *) node->string);
+        }
+        free(node);
+    }
     free(nodeTable);
     nodeTable = NULL;
+    free(hashTable);
+    hashTable = NULL;
+    hashSize = 0;
+    hashUsed = 0;
     lastAtom = None;
 }
 
@@ -192,7 +239,10 @@ InitAtoms(void)
     FreeAllAtoms();
     tableLength = InitialTableSize;
     nodeTable = calloc(InitialTableSize, sizeof(NodePtr));
-    if (!nodeTable)
+    hashSize = InitialHashSize;
+    hashUsed = 0;
+    hashTable = calloc(InitialHashSize, sizeof(NodePtr));
+    if (!nodeTable || !hashTable)
         FatalError("creating atom table");
     nodeTable[None] = NULL;
     MakePredeclaredAtoms();
@@ -0,0 +1,117 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * startup phase timing
+ *
+ * records monotonic timestamps around the defined startup milestones
+ * (OsInit, module loads, screen and input bring-up, ...) and logs a
+ * structured, indented summary when the first client connects, so cold
+ * start regressions can be attributed to a phase without sprinkling
+ * printfs across dix, the DDX and glamor.  recording stops after the
+ * first dump; later server generations pay nothing.
+ */
+#include <dix-config.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "dix/bootprof_priv.h"
+#include "dix/reqprof_priv.h"
+
+#include "os.h"
+
+#define BOOT_PHASE_MAX          128
+#define BOOT_PHASE_NAME_LEN     48
+#define BOOT_PHASE_DEPTH_MAX    8
+
+typedef struct {
+    char name[BOOT_PHASE_NAME_LEN];
+    int depth;
+    uint64_t start_ns;
+    uint64_t dur_ns;
+} BootPhaseEntry;
+
+static BootPhaseEntry phases[BOOT_PHASE_MAX];
+static int numPhases;
+
+/* indices of the currently open phases, innermost last; -1 marks a
+   phase that didn't fit in the table but still needs its End matched */
+static int openPhase[BOOT_PHASE_DEPTH_MAX];
+static int curDepth;
+
+static uint64_t bootStartNs;
+static Bool bootDone;
+
+/* whole milliseconds and one decimal, for the log lines */
+#define MS(ns)      ((unsigned long) ((ns) / 1000000))
+#define MS_TENTH(ns) ((unsigned long) ((ns) / 100000 % 10))
+
+void
+BootPhaseBegin(const char *fmt, ...)
+{
+    int idx = -1;
+
+    if (bootDone)
+        return;
+    if (!bootStartNs)
+        bootStartNs = RequestProfileNow();
+
+    if (numPhases < BOOT_PHASE_MAX && curDepth < BOOT_PHASE_DEPTH_MAX) {
+        va_list args;
+
+        idx = numPhases++;
+        va_start(args, fmt);
+        vsnprintf(phases[idx].name, sizeof(phases[idx].name), fmt, args);
+        va_end(args);
+        phases[idx].depth = curDepth;
+        phases[idx].start_ns = RequestProfileNow();
+    }
+
+    if (curDepth < BOOT_PHASE_DEPTH_MAX)
+        openPhase[curDepth] = idx;
+    curDepth++;
+}
+
+void
+BootPhaseEnd(void)
+{
+    if (bootDone || !curDepth)
+        return;
+
+    curDepth--;
+    if (curDepth < BOOT_PHASE_DEPTH_MAX) {
+        int idx = openPhase[curDepth];
+
+        if (idx >= 0)
+            phases[idx].dur_ns = RequestProfileNow() - phases[idx].start_ns;
+    }
+}
+
+void
+BootPhaseDone(void)
+{
+    uint64_t total;
+
+    if (bootDone)
+        return;
+    bootDone = TRUE;
+
+    if (!numPhases)
+        return;
+
+    total = RequestProfileNow() - bootStartNs;
+    LogMessageVerb(X_INFO, 1,
+                   "startup took %lu.%01lu ms to first client:\n",
+                   MS(total), MS_TENTH(total));
+
+    for (int i = 0; i < numPhases; i++) {
+        BootPhaseEntry *phase = &phases[i];
+        int indent = phase->depth * 2;
+
+        LogMessageVerb(X_NONE, 1, "  %*s%-*s %7lu.%01lu ms at +%lu.%01lu ms\n",
+                       indent, "",
+                       BOOT_PHASE_NAME_LEN - indent, phase->name,
+                       MS(phase->dur_ns), MS_TENTH(phase->dur_ns),
+                       MS(phase->start_ns - bootStartNs),
+                       MS_TENTH(phase->start_ns - bootStartNs));
+    }
+}
@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * startup phase timing
+ */
+#ifndef _XSERVER_DIX_BOOTPROF_PRIV_H
+#define _XSERVER_DIX_BOOTPROF_PRIV_H
+
+#include <X11/Xfuncproto.h>
+
+#include "include/dix.h"
+
+/* open a (possibly nested) startup phase; the name is printf-formatted
+   so per-screen/per-module phases can carry their identity */
+void BootPhaseBegin(const char *fmt, ...) _X_ATTRIBUTE_PRINTF(1, 2);
+
+/* close the most recently opened phase */
+void BootPhaseEnd(void);
+
+/* log the phase summary and stop recording; called when the first
+   client connection is accepted */
+void BootPhaseDone(void);
+
+#endif /* _XSERVER_DIX_BOOTPROF_PRIV_H */
@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * hit/miss/eviction counters for server-side caches
+ *
+ * a uniform registry the per-module caches (glyph hash, glamor FBO
+ * cache, glyph atlas, cursor realization, ...) feed, so cache sizes
+ * can be tuned against real workloads instead of guesswork.  SIGUSR2
+ * dumps the table to the log next to the request profile.
+ */
+#include <dix-config.h>
+
+#include "dix/cachestats_priv.h"
+
+#include "os.h"
+
+static CacheStatsPtr cacheStatsList;
+
+void
+CacheStatsRegister(CacheStatsPtr stats, const char *name)
+{
+    if (stats->name)            /* already registered */
+        return;
+
+    stats->name = name;
+    stats->next = cacheStatsList;
+    cacheStatsList = stats;
+}
+
+void
+CacheStatsDump(void)
+{
+    if (!cacheStatsList)
+        return;
+
+    LogMessage(X_INFO, "cache effectiveness:\n");
+    LogMessage(X_NONE, "  %-24s %12s %12s %8s %10s\n",
+               "cache", "hits", "misses", "hit-%", "evictions");
+
+    for (CacheStatsPtr stats = cacheStatsList; stats; stats = stats->next) {
+        uint64_t lookups = stats->hits + stats->misses;
+
+        LogMessage(X_NONE, "  %-24s %12lu %12lu %8lu %10lu\n",
+                   stats->name,
+                   (unsigned long) stats->hits,
+                   (unsigned long) stats->misses,
+                   (unsigned long) (lookups ? stats->hits * 100 / lookups : 0),
+                   (unsigned long) stats->evictions);
+    }
+}
@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * hit/miss/eviction counters for server-side caches
+ */
+#ifndef _XSERVER_DIX_CACHESTATS_PRIV_H
+#define _XSERVER_DIX_CACHESTATS_PRIV_H
+
+#include <stdint.h>
+
+#include "include/dix.h"
+
+/* One set of counters per cache.  Define the record statically at the
+   cache site, register it from the lookup path (re-registration is a
+   no-op, so no init hook is needed) and count through the inline
+   helpers.  Counters are cumulative over the server generation. */
+typedef struct _CacheStats {
+    struct _CacheStats *next;
+    const char *name;           /* NULL until registered */
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} CacheStatsRec, *CacheStatsPtr;
+
+void CacheStatsRegister(CacheStatsPtr stats, const char *name);
+
+/* log all registered caches; triggered by SIGUSR2 together with the
+   request profile dump */
+void CacheStatsDump(void);
+
+static inline void CacheStatsHit(CacheStatsPtr stats) { stats->hits++; }
+static inline void CacheStatsMiss(CacheStatsPtr stats) { stats->misses++; }
+static inline void CacheStatsEvict(CacheStatsPtr stats) { stats->evictions++; }
+
+#endif /* _XSERVER_DIX_CACHESTATS_PRIV_H */
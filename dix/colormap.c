@@ -81,7 +81,8 @@ SOFTWARE.
 typedef int (*ColorCompareProcPtr) (EntryPtr /*pent */ ,
                                     xrgb * /*prgb */ );
 
-static Pixel FindBestPixel(EntryPtr /*pentFirst */ ,
+static Pixel FindBestPixel(ColormapPtr /*pmap */ ,
+                           EntryPtr /*pentFirst */ ,
                            int /*size */ ,
                            xrgb * /*prgb */ ,
                            int  /*channel */
@@ -448,6 +449,7 @@ FreeColormap(void *value, XID mid)
         }
     }
 
+    free(pmap->rgbCache);
     if (pmap->flags & CM_IsDefault) {
         dixFreePrivates(pmap->devPrivates, PRIVATE_COLORMAP);
         free(pmap);
@@ -759,6 +761,30 @@ doUpdateColors(ColormapPtr pmap)
     free(defs);
 }
 
+/* Return the cache slot for a given channel/rgb lookup, allocating the
+ * cache on first use.  The caller compares *keyret against the slot key:
+ * channel tags run 1..4 so an empty slot (key 0) never matches.
+ */
+static CMapRgbCacheEntry *
+CmapRgbCacheSlot(ColormapPtr pmap, int channel, xrgb * prgb, CARD64 *keyret)
+{
+    CARD64 key;
+
+    if (!pmap->rgbCache) {
+        pmap->rgbCache = calloc(CMAP_RGB_CACHE_SIZE,
+                                sizeof(CMapRgbCacheEntry));
+        if (!pmap->rgbCache)
+            return NULL;
+    }
+    key = ((CARD64) (channel + 1) << 48) |
+          ((CARD64) prgb->red << 32) |
+          ((CARD64) prgb->green << 16) |
+          (CARD64) prgb->blue;
+    *keyret = key;
+    return &pmap->rgbCache[(CARD32) (key ^ (key >> 17) ^ (key >> 33)) &
+                           (CMAP_RGB_CACHE_SIZE - 1)];
+}
+
 /* Tries to find a color in pmap that exactly matches the one requested in prgb
  * if it can't it allocates one.
  * Starts looking at pentFirst + *pPixel, so if you want a specific pixel,
@@ -774,9 +800,38 @@ FindColor(ColormapPtr pmap, EntryPtr pentFirst, int size, xrgb * prgb,
     int npix, count, *nump = NULL;
     Pixel **pixp = NULL, *ppix;
     xColorItem def;
+    CMapRgbCacheEntry *slot;
+    CARD64 key = 0;
 
     foundFree = FALSE;
 
+    /* The cache is only a hint: a hit must be verified against the live
+     * entry, so stale slots simply miss and there is nothing to
+     * invalidate when cells are stored or freed. */
+    slot = CmapRgbCacheSlot(pmap, channel, prgb, &key);
+    if (slot && slot->key == key && slot->pixel < size) {
+        pent = pentFirst + slot->pixel;
+        if (pent->refcnt > 0 && (*comp) (pent, prgb)) {
+            if (client >= 0)
+                pent->refcnt++;
+            pixel = slot->pixel;
+            *pPixel = pixel;
+            switch (channel) {
+            case REDMAP:
+                *pPixel <<= pmap->pVisual->offsetRed;
+            case PSEUDOMAP:
+                break;
+            case GREENMAP:
+                *pPixel <<= pmap->pVisual->offsetGreen;
+                break;
+            case BLUEMAP:
+                *pPixel <<= pmap->pVisual->offsetBlue;
+                break;
+            }
+            goto gotit;
+        }
+    }
+
     if ((pixel = *pPixel) >= size)
         pixel = 0;
     /* see if there is a match, and also look for a free entry */
@@ -786,6 +841,10 @@ FindColor(ColormapPtr pmap, EntryPtr pentFirst, int size, xrgb * prgb,
                 if (client >= 0)
                     pent->refcnt++;
                 *pPixel = pixel;
+                if (slot) {
+                    slot->key = key;
+                    slot->pixel = pixel;
+                }
                 switch (channel) {
                 case REDMAP:
                     *pPixel <<= pmap->pVisual->offsetRed;
@@ -878,6 +937,10 @@ FindColor(ColormapPtr pmap, EntryPtr pentFirst, int size, xrgb * prgb,
     (*pmap->pScreen->StoreColors) (pmap, 1, &def);
     pixel = Free;
     *pPixel = def.pixel;
+    if (slot) {
+        slot->key = key;
+        slot->pixel = pixel;
+    }
 
  gotit:
     if (pmap->flags & CM_BeingCreated || client == -1)
@@ -965,7 +1028,7 @@ AllocColor(ColormapPtr pmap,
     case StaticColor:
     case StaticGray:
         /* Look up all three components in the same pmap */
-        *pPix = pixR = FindBestPixel(pmap->red, entries, &rgb, PSEUDOMAP);
+        *pPix = pixR = FindBestPixel(pmap, pmap->red, entries, &rgb, PSEUDOMAP);
         *pred = pmap->red[pixR].co.local.red;
         *pgreen = pmap->red[pixR].co.local.green;
         *pblue = pmap->red[pixR].co.local.blue;
@@ -981,9 +1044,9 @@ AllocColor(ColormapPtr pmap,
 
     case TrueColor:
         /* Look up each component in its own map, then OR them together */
-        pixR = FindBestPixel(pmap->red, NUMRED(pVisual), &rgb, REDMAP);
-        pixG = FindBestPixel(pmap->green, NUMGREEN(pVisual), &rgb, GREENMAP);
-        pixB = FindBestPixel(pmap->blue, NUMBLUE(pVisual), &rgb, BLUEMAP);
+        pixR = FindBestPixel(pmap, pmap->red, NUMRED(pVisual), &rgb, REDMAP);
+        pixG = FindBestPixel(pmap, pmap->green, NUMGREEN(pVisual), &rgb, GREENMAP);
+        pixB = FindBestPixel(pmap, pmap->blue, NUMBLUE(pVisual), &rgb, BLUEMAP);
         *pPix = (pixR << pVisual->offsetRed) |
             (pixG << pVisual->offsetGreen) |
             (pixB << pVisual->offsetBlue) | ALPHAMASK(pVisual);
@@ -1139,7 +1202,7 @@ FakeAllocColor(ColormapPtr pmap, xColorItem * item)
         /* fall through ... */
     case StaticColor:
     case StaticGray:
-        item->pixel = FindBestPixel(pmap->red, entries, &rgb, PSEUDOMAP);
+        item->pixel = FindBestPixel(pmap, pmap->red, entries, &rgb, PSEUDOMAP);
         break;
 
     case DirectColor:
@@ -1149,24 +1212,24 @@ FakeAllocColor(ColormapPtr pmap, xColorItem * item)
         pixB = (item->pixel & pVisual->blueMask) >> pVisual->offsetBlue;
         if (FindColor(pmap, pmap->red, NUMRED(pVisual), &rgb, &pixR, REDMAP,
                       -1, RedComp) != Success)
-            pixR = FindBestPixel(pmap->red, NUMRED(pVisual), &rgb, REDMAP)
+            pixR = FindBestPixel(pmap, pmap->red, NUMRED(pVisual), &rgb, REDMAP)
                 << pVisual->offsetRed;
         if (FindColor(pmap, pmap->green, NUMGREEN(pVisual), &rgb, &pixG,
                       GREENMAP, -1, GreenComp) != Success)
-            pixG = FindBestPixel(pmap->green, NUMGREEN(pVisual), &rgb,
+            pixG = FindBestPixel(pmap, pmap->green, NUMGREEN(pVisual), &rgb,
                                  GREENMAP) << pVisual->offsetGreen;
         if (FindColor(pmap, pmap->blue, NUMBLUE(pVisual), &rgb, &pixB, BLUEMAP,
                       -1, BlueComp) != Success)
-            pixB = FindBestPixel(pmap->blue, NUMBLUE(pVisual), &rgb, BLUEMAP)
+            pixB = FindBestPixel(pmap, pmap->blue, NUMBLUE(pVisual), &rgb, BLUEMAP)
                 << pVisual->offsetBlue;
         item->pixel = pixR | pixG | pixB;
         break;
 
     case TrueColor:
         /* Look up each component in its own map, then OR them together */
-        pixR = FindBestPixel(pmap->red, NUMRED(pVisual), &rgb, REDMAP);
-        pixG = FindBestPixel(pmap->green, NUMGREEN(pVisual), &rgb, GREENMAP);
-        pixB = FindBestPixel(pmap->blue, NUMBLUE(pVisual), &rgb, BLUEMAP);
+        pixR = FindBestPixel(pmap, pmap->red, NUMRED(pVisual), &rgb, REDMAP);
+        pixG = FindBestPixel(pmap, pmap->green, NUMGREEN(pVisual), &rgb, GREENMAP);
+        pixB = FindBestPixel(pmap, pmap->blue, NUMBLUE(pVisual), &rgb, BLUEMAP);
         item->pixel = (pixR << pVisual->offsetRed) |
             (pixG << pVisual->offsetGreen) | (pixB << pVisual->offsetBlue);
         break;
@@ -1240,13 +1303,24 @@ BigNumAdd(BigNumPtr x, BigNumPtr y, BigNumPtr r)
 }
 
 static Pixel
-FindBestPixel(EntryPtr pentFirst, int size, xrgb * prgb, int channel)
+FindBestPixel(ColormapPtr pmap, EntryPtr pentFirst, int size, xrgb * prgb,
+              int channel)
 {
     EntryPtr pent;
     Pixel pixel, final;
     long dr, dg, db;
     unsigned long sq;
     BigNumRec minval, sum, temp;
+    CMapRgbCacheEntry *slot = NULL;
+    CARD64 key = 0;
+
+    /* static maps never change once created, so the closest match for a
+     * given rgb can be remembered outright */
+    if (!(pmap->class & DynamicClass) && !(pmap->flags & CM_BeingCreated)) {
+        slot = CmapRgbCacheSlot(pmap, channel, prgb, &key);
+        if (slot && slot->key == key && slot->pixel < size)
+            return slot->pixel;
+    }
 
     final = 0;
     MaxBigNum(&minval);
@@ -1281,6 +1355,10 @@ FindBestPixel(EntryPtr pentFirst, int size, xrgb * prgb, int channel)
             minval = sum;
         }
     }
+    if (slot) {
+        slot->key = key;
+        slot->pixel = final;
+    }
     return final;
 }
 
@@ -44,6 +44,15 @@ typedef struct _CMEntry {
     Bool fShared;
 } Entry, *EntryPtr;
 
+/* direct-mapped cache of recent rgb -> pixel lookups, allocated lazily
+ * on the first AllocColor; see FindBestPixel/FindColor in dix/colormap.c */
+typedef struct _CMapRgbCacheEntry {
+    CARD64 key;                 /* channel tag + packed rgb; 0 = empty */
+    Pixel pixel;
+} CMapRgbCacheEntry;
+
+#define CMAP_RGB_CACHE_SIZE 256
+
 /* COLORMAPs can be used for either Direct or Pseudo color.  PseudoColor
  * only needs one cell table, we arbitrarily pick red.  We keep track
  * of that table with freeRed, numPixelsRed, and clientPixelsRed */
@@ -67,6 +76,7 @@ typedef struct _ColormapRec {
     Entry *red;
     Entry *green;
     Entry *blue;
+    CMapRgbCacheEntry *rgbCache;
     PrivateRec *devPrivates;
 } ColormapRec;
 
@@ -49,6 +49,7 @@ SOFTWARE.
 #include <X11/X.h>
 #include <X11/Xmd.h>
 
+#include "dix/cachestats_priv.h"
 #include "dix/cursor_priv.h"
 #include "dix/dix_priv.h"
 #include "dix/screenint_priv.h"
@@ -73,8 +74,81 @@ typedef struct _GlyphShare {
 
 static GlyphSharePtr sharedGlyphs = (GlyphSharePtr) NULL;
 
+/* Cursors created from identical images share one CursorBits: apps that
+ * animate custom ARGB cursors recreate the same handful of frames over
+ * and over, and sharing the bits also lets layers that key their
+ * converted image off the CursorBits (software sprite, cursor-bits
+ * privates) reuse their work instead of converting per frame.  Entries
+ * are live bits only; FreeCursorBits unlinks them.
+ */
+typedef struct _ImageShare {
+    CARD32 hash;
+    CursorBitsPtr bits;
+    struct _ImageShare *next;
+} ImageShare, *ImageSharePtr;
+
+static ImageSharePtr sharedImages = (ImageSharePtr) NULL;
+static CacheStatsRec cursorBitsStats;
+
 static CARD32 cursorSerial;
 
+/* FNV-1a, folded over the metrics and all image planes */
+static CARD32
+cursorImageHash(CARD32 hash, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+
+    while (len--)
+        hash = (hash ^ *p++) * 0x01000193;
+    return hash;
+}
+
+static CARD32
+cursorImageHashAll(CursorMetricPtr cm, size_t bitmapBytes,
+                   const unsigned char *src, const unsigned char *msk,
+                   const CARD32 *argb)
+{
+    CARD32 hash = 0x811c9dc5;
+
+    hash = cursorImageHash(hash, cm, sizeof(*cm));
+    if (src)
+        hash = cursorImageHash(hash, src, bitmapBytes);
+    if (msk)
+        hash = cursorImageHash(hash, msk, bitmapBytes);
+    if (argb)
+        hash = cursorImageHash(hash, argb,
+                               (size_t) cm->width * cm->height * 4);
+    return hash;
+}
+
+static CursorBitsPtr
+lookupSharedImage(CARD32 hash, CursorMetricPtr cm, size_t bitmapBytes,
+                  const unsigned char *src, const unsigned char *msk,
+                  const CARD32 *argb)
+{
+    for (ImageSharePtr this = sharedImages; this; this = this->next) {
+        CursorBitsPtr bits = this->bits;
+
+        if (this->hash != hash ||
+            bits->width != cm->width || bits->height != cm->height ||
+            bits->xhot != cm->xhot || bits->yhot != cm->yhot)
+            continue;
+        if ((bits->source != NULL) != (src != NULL) ||
+            (bits->mask != NULL) != (msk != NULL) ||
+            (bits->argb != NULL) != (argb != NULL))
+            continue;
+        if (src && memcmp(bits->source, src, bitmapBytes) != 0)
+            continue;
+        if (msk && memcmp(bits->mask, msk, bitmapBytes) != 0)
+            continue;
+        if (argb && memcmp(bits->argb, argb,
+                           (size_t) cm->width * cm->height * 4) != 0)
+            continue;
+        return bits;
+    }
+    return NULL;
+}
+
 static void
 FreeCursorBits(CursorBitsPtr bits)
 {
@@ -86,6 +160,7 @@ FreeCursorBits(CursorBitsPtr bits)
     dixFiniPrivates(bits, PRIVATE_CURSOR_BITS);
     if (bits->refcnt == 0) {
         GlyphSharePtr *prev, this;
+        ImageSharePtr *iprev, ithis;
 
         for (prev = &sharedGlyphs;
              (this = *prev) && (this->bits != bits); prev = &this->next);
@@ -94,6 +169,13 @@ FreeCursorBits(CursorBitsPtr bits)
             CloseFont(this->font, (Font) 0);
             free(this);
         }
+        for (iprev = &sharedImages;
+             (ithis = *iprev) && (ithis->bits != bits); iprev = &ithis->next);
+        if (ithis) {
+            *iprev = ithis->next;
+            CacheStatsEvict(&cursorBitsStats);
+            free(ithis);
+        }
         free(bits);
     }
 }
@@ -239,25 +321,85 @@ AllocARGBCursor(unsigned char *psrcbits, unsigned char *pmaskbits,
     CursorBitsPtr bits;
     CursorPtr pCurs;
     int rc;
+    size_t bitmapBytes = (size_t) BitmapBytePad(cm->width) * cm->height;
 
     *ppCurs = NULL;
-    pCurs = (CursorPtr) calloc(CURSOR_REC_SIZE + CURSOR_BITS_SIZE, 1);
+
+    /* fix non-premultiplied ARGB data before it is hashed or realized,
+       so identical uploads always match the cached copy */
+    if (argb) {
+        size_t size = (size_t) cm->width * cm->height;
+
+        for (size_t i = 0; i < size; i++) {
+            if ((argb[i] & 0xff000000) == 0 && (argb[i] & 0xffffff) != 0) {
+                for (size_t j = 0; j < size; j++) {
+                    CARD32 a, ar, ag, ab;
+
+                    a = argb[j] >> 24;
+                    ar = a * ((argb[j] >> 16) & 0xff) / 0xff;
+                    ag = a * ((argb[j] >> 8) & 0xff) / 0xff;
+                    ab = a * (argb[j] & 0xff) / 0xff;
+
+                    argb[j] = a << 24 | ar << 16 | ag << 8 | ab;
+                }
+
+                break;
+            }
+        }
+    }
+
+    CacheStatsRegister(&cursorBitsStats, "dix-cursor-bits");
+
+    CARD32 hash = cursorImageHashAll(cm, bitmapBytes, psrcbits, pmaskbits,
+                                     argb);
+    bits = lookupSharedImage(hash, cm, bitmapBytes, psrcbits, pmaskbits,
+                             argb);
+
+    pCurs = (CursorPtr) calloc(CURSOR_REC_SIZE, 1);
     if (!pCurs)
         return BadAlloc;
-
-    bits = (CursorBitsPtr) ((char *) pCurs + CURSOR_REC_SIZE);
     dixInitPrivates(pCurs, pCurs + 1, PRIVATE_CURSOR);
-    dixInitPrivates(bits, bits + 1, PRIVATE_CURSOR_BITS)
+
+    if (bits) {
+        /* same image as a live cursor: share its CursorBits and drop
+           the duplicate planes */
+        CacheStatsHit(&cursorBitsStats);
+        bits->refcnt++;
+        free(psrcbits);
+        free(pmaskbits);
+        free(argb);
+    }
+    else {
+        CacheStatsMiss(&cursorBitsStats);
+        bits = (CursorBitsPtr) calloc(CURSOR_BITS_SIZE, 1);
+        if (!bits) {
+            dixFiniPrivates(pCurs, PRIVATE_CURSOR);
+            free(pCurs);
+            return BadAlloc;
+        }
+        dixInitPrivates(bits, bits + 1, PRIVATE_CURSOR_BITS);
         bits->source = psrcbits;
-    bits->mask = pmaskbits;
-    bits->argb = argb;
-    bits->width = cm->width;
-    bits->height = cm->height;
-    bits->xhot = cm->xhot;
-    bits->yhot = cm->yhot;
+        bits->mask = pmaskbits;
+        bits->argb = argb;
+        bits->width = cm->width;
+        bits->height = cm->height;
+        bits->xhot = cm->xhot;
+        bits->yhot = cm->yhot;
+        bits->refcnt = 1;
+        CheckForEmptyMask(bits);
+
+        ImageSharePtr share = calloc(1, sizeof(ImageShare));
+        if (share) {
+            /* cache registration is best-effort; without it the bits
+               are simply private to this cursor */
+            share->hash = hash;
+            share->bits = bits;
+            share->next = sharedImages;
+            sharedImages = share;
+        }
+    }
+
     pCurs->refcnt = 1;
-    bits->refcnt = -1;
-    CheckForEmptyMask(bits);
     pCurs->bits = bits;
     pCurs->serialNumber = ++cursorSerial;
     pCurs->name = None;
@@ -284,28 +426,6 @@ AllocARGBCursor(unsigned char *psrcbits, unsigned char *pmaskbits,
 
     *ppCurs = pCurs;
 
-    if (argb) {
-        size_t size = bits->width * bits->height;
-
-        for (size_t i = 0; i < size; i++) {
-            if ((argb[i] & 0xff000000) == 0 && (argb[i] & 0xffffff) != 0) {
-                /* ARGB data doesn't seem pre-multiplied, fix it */
-                for (size_t j = 0; j < size; j++) {
-                    CARD32 a, ar, ag, ab;
-
-                    a = argb[j] >> 24;
-                    ar = a * ((argb[j] >> 16) & 0xff) / 0xff;
-                    ag = a * ((argb[j] >> 8) & 0xff) / 0xff;
-                    ab = a * (argb[j] & 0xff) / 0xff;
-
-                    argb[j] = a << 24 | ar << 16 | ag << 8 | ab;
-                }
-
-                break;
-            }
-        }
-    }
-
     return Success;
 
  error:
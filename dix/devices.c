@@ -99,6 +99,22 @@ CallbackListPtr DeviceAccessCallback = NULL;
 
 static void RecalculateMasterButtons(DeviceIntPtr slave);
 
+static Bool
+TransformIsIdentity(const struct pixman_f_transform *m)
+{
+    static const struct pixman_f_transform identity =
+        {.m = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}} };
+
+    return memcmp(m, &identity, sizeof(identity)) == 0;
+}
+
+static Bool
+TransformIsScaleTranslate(const struct pixman_f_transform *m)
+{
+    return m->m[0][1] == 0 && m->m[1][0] == 0 &&
+        m->m[2][0] == 0 && m->m[2][1] == 0 && m->m[2][2] == 1;
+}
+
 static void
 DeviceSetTransform(DeviceIntPtr dev, float *transform_data)
 {
@@ -144,6 +160,13 @@ DeviceSetTransform(DeviceIntPtr dev, float *transform_data)
     dev->relative_transform = transform;
     dev->relative_transform.m[0][2] = 0;
     dev->relative_transform.m[1][2] = 0;
+
+    dev->relative_transform_identity =
+        TransformIsIdentity(&dev->relative_transform);
+    dev->scale_and_transform_identity =
+        TransformIsIdentity(&dev->scale_and_transform);
+    dev->scale_and_transform_st =
+        TransformIsScaleTranslate(&dev->scale_and_transform);
 }
 
 /**
@@ -289,6 +312,10 @@ AddInputDevice(ClientPtr client, DeviceProc deviceProc, Bool autoStart)
         return NULL;
     }
 
+    /* scratch list for AcquireEventList(); if it fails the acquirers
+       simply fall back to per-call allocations */
+    dev->scratchEvents = InitEventList(GetMaximumEventsNum());
+
     dev->sendEventsProc = XTestDeviceSendEvents;
 
     XkbSetExtension(dev, ProcessKeyboardEvent);
@@ -301,6 +328,7 @@ AddInputDevice(ClientPtr client, DeviceProc deviceProc, Bool autoStart)
     /*  security creation/labeling check
      */
     if (dixCallDeviceAccessCallback(client, dev, DixCreateAccess)) {
+        FreeEventList(dev->scratchEvents, GetMaximumEventsNum());
         dixFreePrivates(dev->devPrivates, PRIVATE_DEVICE);
         free(dev);
         return NULL;
@@ -325,6 +353,9 @@ AddInputDevice(ClientPtr client, DeviceProc deviceProc, Bool autoStart)
     dev->relative_transform.m[1][1] = 1.0;
     dev->relative_transform.m[2][2] = 1.0;
     dev->scale_and_transform = dev->relative_transform;
+    dev->relative_transform_identity = TRUE;
+    dev->scale_and_transform_identity = TRUE;
+    dev->scale_and_transform_st = TRUE;
 
     XIChangeDeviceProperty(dev, XIGetKnownProperty(XI_PROP_TRANSFORM),
                            XIGetKnownProperty(XATOM_FLOAT), 32,
@@ -1036,6 +1067,7 @@ CloseDevice(DeviceIntPtr dev)
 
     FreeGrab(dev->deviceGrab.grab);
     free(dev->deviceGrab.sync.event);
+    FreeEventList(dev->scratchEvents, GetMaximumEventsNum());
     free(dev->config_info);     /* Allocated in xf86ActivateDevice. */
     free(dev->last.scroll);
     for (int j = 0; j < dev->last.num_touches; j++)
@@ -2555,7 +2587,7 @@ RecalculateMasterButtons(DeviceIntPtr slave)
 void
 ReleaseButtonsAndKeys(DeviceIntPtr dev)
 {
-    InternalEvent *eventlist = InitEventList(GetMaximumEventsNum());
+    InternalEvent *eventlist = AcquireEventList(dev);
     ButtonClassPtr b = dev->button;
     KeyClassPtr k = dev->key;
     int nevents;
@@ -2582,7 +2614,7 @@ ReleaseButtonsAndKeys(DeviceIntPtr dev)
         }
     }
 
-    FreeEventList(eventlist, GetMaximumEventsNum());
+    ReleaseEventList(dev, eventlist);
 }
 
 /**
@@ -103,15 +103,20 @@ Equipment Corporation.
 #include <X11/fonts/fontstruct.h>
 #include <X11/fonts/libxfont2.h>
 
+#include "dix/bootprof_priv.h"
 #include "dix/client_priv.h"
 #include "dix/colormap_priv.h"
 #include "dix/cursor_priv.h"
 #include "dix/dix_priv.h"
+#include "dix/eventconvert.h"
 #include "dix/extension_priv.h"
 #include "dix/input_priv.h"
 #include "dix/gc_priv.h"
 #include "dix/registry_priv.h"
+#include "dix/reqcapture_priv.h"
+#include "dix/reqprof_priv.h"
 #include "dix/request_priv.h"
+#include "dix/resacct_priv.h"
 #include "dix/resource_priv.h"
 #include "dix/screenint_priv.h"
 #include "dix/screensaver_priv.h"
@@ -247,10 +252,6 @@ UpdateCurrentTimeIf(void)
 #define SMART_SCHEDULE_DEFAULT_INTERVAL	5
 #define SMART_SCHEDULE_MAX_SLICE	15
 
-#ifdef HAVE_SETITIMER
-Bool SmartScheduleSignalEnable = TRUE;
-#endif
-
 long SmartScheduleSlice = SMART_SCHEDULE_DEFAULT_INTERVAL;
 long SmartScheduleInterval = SMART_SCHEDULE_DEFAULT_INTERVAL;
 long SmartScheduleMaxSlice = SMART_SCHEDULE_MAX_SLICE;
@@ -265,6 +266,8 @@ long SmartLastPrint;
 
 void Dispatch(void);
 
+static Bool PutImageStreamCheck(ClientPtr client, const void *req);
+
 static struct xorg_list ready_clients;
 static struct xorg_list saved_ready_clients;
 struct xorg_list output_pending_clients;
@@ -287,8 +290,14 @@ clients_are_ready(void)
 void
 mark_client_ready(ClientPtr client)
 {
-    if (xorg_list_is_empty(&client->ready))
+    if (xorg_list_is_empty(&client->ready)) {
+        client->smart_ready_tick = SmartScheduleTime;
         xorg_list_append(&client->ready, &ready_clients);
+        /* a slice grown for a lone client must not delay this one */
+        if (SmartScheduleSlice > SmartScheduleInterval &&
+            client != SmartLastClient)
+            SmartScheduleSlice = SmartScheduleInterval;
+    }
 }
 
 /*
@@ -353,6 +362,16 @@ SmartScheduleClient(void)
                 pClient->smart_priority++;
         }
 
+        /* Age clients stuck waiting while ready, so a flood of
+         * higher-priority work cannot starve them indefinitely; one
+         * step per idle period keeps the aging rate bounded.
+         */
+        if ((now - pClient->smart_ready_tick) >= idle &&
+            pClient->smart_priority < SMART_MAX_PRIORITY) {
+            pClient->smart_priority++;
+            pClient->smart_ready_tick = now;
+        }
+
         /* check priority to select best client */
         robin =
             (pClient->index -
@@ -475,6 +494,46 @@ DisableLimitedSchedulingLatency(void)
         SmartScheduleLatencyLimited = 0;
 }
 
+/* log2 histogram of dispatch iteration durations in microseconds;
+   bucket n holds iterations that took less than 2^n us */
+#define DISPATCH_HIST_BUCKETS 16
+static uint64_t dispatchDurationHist[DISPATCH_HIST_BUCKETS];
+
+static void
+DispatchRecordIteration(uint64_t start_ns)
+{
+    uint64_t us = (RequestProfileNow() - start_ns) / 1000;
+    int bucket = 0;
+
+    while (us && bucket < DISPATCH_HIST_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    dispatchDurationHist[bucket]++;
+}
+
+void
+DispatchStatsDump(void)
+{
+    WakeupStatsDump();
+
+    LogMessage(X_INFO, "dispatch iteration durations:\n");
+    for (int bucket = 0; bucket < DISPATCH_HIST_BUCKETS; bucket++) {
+        if (!dispatchDurationHist[bucket])
+            continue;
+        LogMessage(X_NONE, "  < %8lu us: %lu\n",
+                   1ul << bucket,
+                   (unsigned long) dispatchDurationHist[bucket]);
+    }
+    memset(dispatchDurationHist, 0, sizeof(dispatchDurationHist));
+
+    LogMessage(X_INFO,
+               "smart scheduler: slice %ld ms, interval %ld ms, "
+               "max slice %ld ms\n",
+               SmartScheduleSlice, SmartScheduleInterval,
+               SmartScheduleMaxSlice);
+}
+
 void
 Dispatch(void)
 {
@@ -488,7 +547,22 @@ Dispatch(void)
     SmartScheduleSlice = SmartScheduleInterval;
     init_client_ready();
 
+    RequestCaptureInit();
+    RequestProfileInit();
+    ResourceAccountInit();
+
+    /* huge PutImage payloads can be consumed row-wise as they arrive */
+    RegisterStreamableRequest(X_PutImage, sizeof(xPutImageReq),
+                              PutImageStreamCheck);
+
     while (!dispatchException) {
+        /* wire events converted last iteration have all been copied into
+           client buffers by now; recycle their scratch space */
+        ResetEventConversionArena();
+        RegionPoolTrim();
+
+        RequestProfileCheckDump();
+
         if (InputCheckPending()) {
             ProcessInputEvents();
             FlushIfCriticalOutputPending();
@@ -497,12 +571,15 @@ Dispatch(void)
         if (!WaitForSomething(clients_are_ready()))
             continue;
 
+        uint64_t round_start = RequestProfileNow();
+
         /*****************
          *  Handle events in round robin fashion, doing input between
          *  each round
          *****************/
 
         if (!dispatchException && clients_are_ready()) {
+            SmartScheduleTime = GetTimeInMillis();
             client = SmartScheduleClient();
 
             isItTimeToYield = FALSE;
@@ -530,6 +607,10 @@ Dispatch(void)
                     break;
                 }
 
+#ifdef XSERVER_DTRACE
+                if (XSERVER_REQUEST_READ_ENABLED())
+                    XSERVER_REQUEST_READ(client->index, (int) read_result);
+#endif
                 client->sequence++;
                 client->majorOp = ((xReq *) client->requestBuffer)->reqType;
                 client->minorOp = 0;
@@ -539,6 +620,13 @@ Dispatch(void)
                     if (ext)
                         client->minorOp = ext->MinorOpcode(client);
                 }
+                if (RequestCaptureActive)
+                    RequestCaptureRequest(client, client->requestBuffer,
+                                          (size_t) read_result);
+
+                uint64_t prof_start = 0;
+                if (RequestProfileActive)
+                    prof_start = RequestProfileNow();
 #ifdef XSERVER_DTRACE
                 if (XSERVER_REQUEST_START_ENABLED())
                     XSERVER_REQUEST_START(LookupMajorName(client->majorOp),
@@ -567,8 +655,13 @@ Dispatch(void)
                         currentClient = NULL;
                     }
                 }
-                if (!SmartScheduleSignalEnable)
-                    SmartScheduleTime = GetTimeInMillis();
+                if (RequestProfileActive)
+                    RequestProfileRecord(client->majorOp, client->minorOp,
+                                         prof_start);
+
+                /* slice accounting reads the (coarse) monotonic clock
+                 * directly; no SIGALRM tick is involved */
+                SmartScheduleTime = GetTimeInMillis();
 
 #ifdef XSERVER_DTRACE
                 if (XSERVER_REQUEST_DONE_ENABLED())
@@ -582,6 +675,7 @@ Dispatch(void)
                     break;
                 }
                 else if (result != Success) {
+                    StreamedRequestAbort(client);
                     SendErrorToClient(client, client->majorOp,
                                       client->minorOp,
                                       client->errorValue, result);
@@ -592,10 +686,12 @@ Dispatch(void)
             if (client == SmartLastClient)
                 client->smart_stop_tick = SmartScheduleTime;
         }
+        DispatchRecordIteration(round_start);
         dispatchException &= ~DE_PRIORITYCHANGE;
     }
     ddxBeforeReset();
     KillAllClients();
+    RequestCaptureFini();
     SmartScheduleLatencyLimited = 0;
     ResetOsBuffers();
 }
@@ -2157,6 +2253,22 @@ ReformatImage(char *base, int nbytes, int bpp, int order)
  * Also, we need to make sure that the image is aligned on a 64-bit
  * boundary, even if the scanlines are padded to our satisfaction.
  */
+/* Decide whether a large PutImage may be streamed chunk-wise from the
+ * socket.  XY formats interleave planes across the whole payload, and a
+ * single row must fit comfortably inside one streamed chunk.
+ */
+static Bool
+PutImageStreamCheck(ClientPtr client, const void *req)
+{
+    const xPutImageReq *stuff = req;
+    CARD16 width = stuff->width;
+
+    if (client->swapped)
+        swaps(&width);
+    return stuff->format == ZPixmap &&
+        PixmapBytePad(width, stuff->depth) <= 16384;
+}
+
 int
 ProcPutImage(ClientPtr client)
 {
@@ -2203,6 +2315,31 @@ ProcPutImage(ClientPtr client)
          bytes_to_int32(sizeof(xPutImageReq))) != client->req_len)
         return BadLength;
 
+    int streamAvail = StreamedRequestAvail(client);
+
+    if (streamAvail >= 0) {
+        /* payload arrives in chunks; push whole rows as they come and
+         * re-queue ourselves until the image is complete */
+        int rowsDone = StreamedRequestDone(client) / lengthProto;
+        int nrows = streamAvail / lengthProto;
+
+        if (nrows > stuff->height - rowsDone)
+            nrows = stuff->height - rowsDone;
+        if (nrows) {
+            ReformatImage(tmpImage, lengthProto * nrows,
+                          BitsPerPixel(stuff->depth), ClientOrder(client));
+            (*pGC->ops->PutImage) (pDraw, pGC, stuff->depth, stuff->dstX,
+                                   stuff->dstY + rowsDone, stuff->width,
+                                   nrows, stuff->leftPad, ZPixmap, tmpImage);
+        }
+        StreamedRequestConsume(client, nrows * lengthProto);
+        if (rowsDone + nrows < stuff->height) {
+            ResetCurrentRequest(client);
+            client->sequence--;
+        }
+        return Success;
+    }
+
     ReformatImage(tmpImage, lengthProto * stuff->height,
                   stuff->format == ZPixmap ? BitsPerPixel(stuff->depth) : 1,
                   ClientOrder(client));
@@ -3460,8 +3597,9 @@ ProcListHosts(ClientPtr client)
         swaps(&reply.nHosts);
     }
 
-    x_rpcbuf_write_CARD8s(&rpcbuf, pdata, len);
-    free(pdata);
+    /* hand the host list over by reference -- the output layer frees it
+       once the bytes have left the server */
+    x_rpcbuf_write_ref_pad(&rpcbuf, pdata, len, free, pdata);
 
     return X_SEND_REPLY_WITH_RPCBUF(client, reply, rpcbuf);
 }
@@ -4156,7 +4294,10 @@ AddScreen(Bool (*pfnInit) (ScreenPtr /*pScreen */ ,
      */
     screenInfo.screens[i] = pScreen;
     screenInfo.numScreens++;
-    if (!(*pfnInit) (pScreen, argc, argv)) {
+    BootPhaseBegin("screen %d init", i);
+    ret = (*pfnInit) (pScreen, argc, argv);
+    BootPhaseEnd();
+    if (!ret) {
         dixFreeScreenSpecificPrivates(pScreen);
         dixFreePrivates(pScreen->devPrivates, PRIVATE_SCREEN);
         free(pScreen);
@@ -4204,7 +4345,10 @@ AddGPUScreen(Bool (*pfnInit) (ScreenPtr /*pScreen */ ,
      */
     screenInfo.gpuscreens[i] = pScreen;
     screenInfo.numGPUScreens++;
-    if (!(*pfnInit) (pScreen, argc, argv)) {
+    BootPhaseBegin("gpu screen %d init", i);
+    ret = (*pfnInit) (pScreen, argc, argv);
+    BootPhaseEnd();
+    if (!ret) {
         dixFreePrivates(pScreen->devPrivates, PRIVATE_SCREEN);
         free(pScreen);
         screenInfo.numGPUScreens--;
@@ -96,6 +96,19 @@ void ClearWorkQueue(void);
 void ProcessWorkQueue(void);
 void ProcessWorkQueueZombies(void);
 
+/* log and reset the wakeup counters, the dispatch iteration duration
+   histogram and the smart scheduler state; part of the SIGUSR2
+   statistics dump */
+void DispatchStatsDump(void);
+
+/* release region header/data pool entries above the keep watermark;
+   called once per dispatch round so transient regions are reused
+   within a round without bursts pinning memory */
+void RegionPoolTrim(void);
+
+/* log the region pool occupancy; part of the SIGUSR2 statistics dump */
+void RegionPoolStatsDump(void);
+
 void CloseDownClient(ClientPtr client);
 ClientPtr GetCurrentClient(void);
 void InitClient(ClientPtr client, int i, void *ospriv);
@@ -130,6 +143,10 @@ int dixLookupGC(GCPtr *result,
                 ClientPtr client,
                 Mask access_mode);
 
+/* bumped on every resource free or value change; invalidates all
+   per-client drawable lookup caches at once */
+extern CARD32 dixLookupCacheGeneration;
+
 int dixLookupResourceOwner(ClientPtr *result,
                     XID id,
                     ClientPtr client,
@@ -220,6 +237,26 @@ void FixKeyState(DeviceEvent *event, DeviceIntPtr keybd);
 
 void RecalculateDeliverableEvents(WindowPtr pWin);
 
+/* bumped whenever any window's event interest can change (event mask
+ * selection, dont-propagate changes, device masks, per-device filters);
+ * invalidates the per-window EventIsDeliverable() memo at once */
+extern CARD32 dixEventInterestGeneration;
+
+/* bumped whenever a passive grab list changes or any device's grab
+ * modifier state is recomputed to a new value; together with
+ * dixWindowTreeGeneration this validates the per-device negative
+ * CheckDeviceGrabs() memo */
+extern CARD32 dixPassiveGrabGeneration;
+
+/* bumped on every window tree restructure (create/destroy/reparent/
+ * restack); maintained in dix/window.c */
+extern CARD32 dixWindowTreeGeneration;
+
+/* bumped from WindowsRestructured() whenever window hit-test geometry
+ * may have changed (configure, map/unmap, stacking, shapes); validates
+ * the per-sprite XYToWindow() trace cache */
+extern CARD32 dixHitGeometryGeneration;
+
 void DoFocusEvents(DeviceIntPtr dev,
                    WindowPtr fromWin,
                    WindowPtr toWin,
@@ -235,6 +235,25 @@ FreeFPE(FontPathElementPtr fpe)
     }
 }
 
+/* Synchronous FPEs (the fontfile renderer in particular) do their
+ * directory I/O inline, so scanning a long font path in one go stalls
+ * dispatch for every other client.  Each closure gets a budget of this
+ * many synchronous probes per slice; when it runs out we park the client
+ * on the sleep queue and reschedule the continuation through the work
+ * queue, letting other clients' requests interleave.  Async FPEs are
+ * unaffected: they return Suspended and resume via dixClientSignal()
+ * as before. */
+#define FONT_FPE_PROBE_BUDGET 4
+
+static Bool
+fontYieldToDispatch(ClientPtr client, ClientSleepProcPtr function,
+                    void *closure)
+{
+    if (!ClientIsAsleep(client) && !ClientSleep(client, function, closure))
+        return FALSE;
+    return dixClientSignal(client);
+}
+
 static Bool
 doOpenFont(ClientPtr client, OFclosurePtr c)
 {
@@ -244,6 +263,7 @@ doOpenFont(ClientPtr client, OFclosurePtr c)
     char *alias, *newname;
     int newlen;
     int aliascount = 20;
+    int probes = FONT_FPE_PROBE_BUDGET;
 
     /*
      * Decide at runtime what FontFormat to use.
@@ -277,6 +297,9 @@ doOpenFont(ClientPtr client, OFclosurePtr c)
         goto bail;
     }
     while (c->current_fpe < c->num_fpes) {
+        if (--probes < 0 &&
+            fontYieldToDispatch(client, (ClientSleepProcPtr) doOpenFont, c))
+            return TRUE;
         fpe = c->fpe_list[c->current_fpe];
         err = (*fpe_functions[fpe->type]->open_font)
             ((void *) client, fpe, c->flags,
@@ -555,6 +578,7 @@ doListFontsAndAliases(ClientPtr client, LFclosurePtr c)
     char *name, *resolved = NULL;
     int namelen, resolvedlen;
     int aliascount = 0;
+    int probes = FONT_FPE_PROBE_BUDGET;
 
     if (client->clientGone) {
         if (c->current.current_fpe < c->num_fpes) {
@@ -575,6 +599,13 @@ doListFontsAndAliases(ClientPtr client, LFclosurePtr c)
         if (!fpe_functions[fpe->type]->start_list_fonts_and_aliases) {
             /* This FPE doesn't support/require list_fonts_and_aliases */
 
+            if (--probes < 0 &&
+                fontYieldToDispatch(client,
+                                    (ClientSleepProcPtr) doListFontsAndAliases,
+                                    c)) {
+                free(resolved);
+                return TRUE;
+            }
             err = (*fpe_functions[fpe->type]->list_fonts)
                 ((void *) c->client, fpe, c->current.pattern,
                  c->current.patlen, c->current.max_names - c->names->nnames,
@@ -600,6 +631,13 @@ doListFontsAndAliases(ClientPtr client, LFclosurePtr c)
                the FPEs.  */
 
             if (!c->current.list_started) {
+                if (--probes < 0 &&
+                    fontYieldToDispatch(client,
+                                        (ClientSleepProcPtr)
+                                        doListFontsAndAliases, c)) {
+                    free(resolved);
+                    return TRUE;
+                }
                 err = (*fpe_functions[fpe->type]->start_list_fonts_and_aliases)
                     ((void *) c->client, fpe, c->current.pattern,
                      c->current.patlen, c->current.max_names - c->names->nnames,
@@ -832,6 +870,7 @@ doListFontsWithInfo(ClientPtr client, LFWIclosurePtr c)
     int length;
     xFontProp *pFP;
     int aliascount = 0;
+    int probes = FONT_FPE_PROBE_BUDGET;
 
     if (client->clientGone) {
         if (c->current.current_fpe < c->num_fpes) {
@@ -847,6 +886,11 @@ doListFontsWithInfo(ClientPtr client, LFWIclosurePtr c)
         fpe = c->fpe_list[c->current.current_fpe];
         err = Successful;
         if (!c->current.list_started) {
+            if (--probes < 0 &&
+                fontYieldToDispatch(client,
+                                    (ClientSleepProcPtr) doListFontsWithInfo,
+                                    c))
+                return TRUE;
             err = (*fpe_functions[fpe->type]->start_list_fonts_with_info)
                 (client, fpe, c->current.pattern, c->current.patlen,
                  c->current.max_names, &c->current.private);
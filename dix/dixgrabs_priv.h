@@ -146,6 +146,34 @@ Bool GrabMatchesSecond(GrabPtr pFirstGrab,
                        GrabPtr pSecondGrab,
                        Bool ignoreDevice);
 
+/**
+ * @brief probe a window's passive grab detail summary
+ *
+ * Check the precomputed per-window bitmap of grabbed detail (keycode or
+ * button) values. If this returns FALSE, no passive grab on the window
+ * can match an event with the given detail and the whole grab list may
+ * be skipped. TRUE means "possibly matches" and mandates the full walk.
+ *
+ * @param pWin the window whose passive grabs are being considered
+ * @param detail the event's keycode or button (0 = no detail, never filter)
+ * @return FALSE only if no grab on the window can match the detail
+ */
+Bool PassiveGrabsMayMatchDetail(WindowPtr pWin, unsigned int detail);
+
+/**
+ * @brief cheap per-grab detail pre-check
+ *
+ * Check just the detail field of one grab against an event's keycode or
+ * button, honoring AnyKey/AnyButton and detail masks. FALSE means the
+ * grab can never match the event, whatever its type, device or
+ * modifiers, so the full comparison can be skipped.
+ *
+ * @param grab the passive grab to test
+ * @param detail the event's keycode or button (0 = no detail, never filter)
+ * @return FALSE only if the grab's detail rules out the event
+ */
+Bool GrabMayMatchDetail(GrabPtr grab, unsigned int detail);
+
 /**
  * @brief add passive grab to a client
  *
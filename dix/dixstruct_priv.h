@@ -30,13 +30,6 @@ extern long SmartScheduleTime;
 extern long SmartScheduleInterval;
 extern long SmartScheduleSlice;
 extern long SmartScheduleMaxSlice;
-#ifdef HAVE_SETITIMER
-extern Bool SmartScheduleSignalEnable;
-#else
-#define SmartScheduleSignalEnable FALSE
-#endif
-void SmartScheduleStartTimer(void);
-void SmartScheduleStopTimer(void);
 
 /* Client has requests queued or data on the network */
 void mark_client_ready(ClientPtr client);
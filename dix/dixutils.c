@@ -152,6 +152,8 @@ ClientTimeToServerTime(CARD32 c)
  * access mask values are defined in resource.h.  The type mask values are
  * defined in pixmap.h, with zero equivalent to M_DRAWABLE.
  */
+CARD32 dixLookupCacheGeneration = 1;
+
 int
 dixLookupDrawable(DrawablePtr *pDraw, XID id, ClientPtr client,
                   Mask type, Mask access)
@@ -161,6 +163,29 @@ dixLookupDrawable(DrawablePtr *pDraw, XID id, ClientPtr client,
 
     *pDraw = NULL;
 
+    /* Requests overwhelmingly target the same few drawables over and
+       over, and each of them gets looked up several times per request,
+       so keep a small MRU cache of validated lookups.  Any resource
+       free or value change bumps the generation and thereby drops all
+       cached entries.  Bypassed while a security module has a resource
+       hook registered, since the hook must then see every lookup. */
+    if (!XaceHookIsSet(XACE_RESOURCE_ACCESS)) {
+        for (int i = 0; i < DIX_LOOKUP_CACHE_SIZE; i++) {
+            DrawableLookupCacheEntry ent = client->lookupCache[i];
+
+            if (ent.generation != dixLookupCacheGeneration || ent.id != id)
+                continue;
+            for (; i > 0; i--)
+                client->lookupCache[i] = client->lookupCache[i - 1];
+            client->lookupCache[0] = ent;
+            pTmp = (DrawablePtr) ent.pDraw;
+            if (!((1 << pTmp->type) & (type ? type : M_DRAWABLE)))
+                return BadMatch;
+            *pDraw = pTmp;
+            return Success;
+        }
+    }
+
     rc = dixLookupResourceByClass((void **) &pTmp, id, RC_DRAWABLE, client,
                                   access);
 
@@ -171,6 +196,17 @@ dixLookupDrawable(DrawablePtr *pDraw, XID id, ClientPtr client,
         return BadDrawable;
     if (rc != Success)
         return rc;
+
+    if (!XaceHookIsSet(XACE_RESOURCE_ACCESS)) {
+        for (int i = DIX_LOOKUP_CACHE_SIZE - 1; i > 0; i--)
+            client->lookupCache[i] = client->lookupCache[i - 1];
+        client->lookupCache[0] = (DrawableLookupCacheEntry) {
+            .id = id,
+            .pDraw = pTmp,
+            .generation = dixLookupCacheGeneration,
+        };
+    }
+
     if (!((1 << pTmp->type) & (type ? type : M_DRAWABLE)))
         return BadMatch;
 
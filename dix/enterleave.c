@@ -214,10 +214,24 @@ SetFocusOut(DeviceIntPtr dev)
 static WindowPtr
 CommonAncestor(WindowPtr a, WindowPtr b)
 {
-    for (b = b->parent; b; b = b->parent)
-        if (WindowIsParent(b, a))
-            return b;
-    return NullWindow;
+    /* climb the deeper chain to the other's depth, then walk both in
+       lockstep; one linear pass instead of a parent-chain walk per
+       candidate ancestor */
+    a = a->parent;
+    b = b->parent;
+    if (!a || !b)
+        return NullWindow;
+    while (a->treeDepth > b->treeDepth)
+        a = a->parent;
+    while (b->treeDepth > a->treeDepth)
+        b = b->parent;
+    while (a != b) {
+        a = a->parent;
+        b = b->parent;
+        if (!a || !b)
+            return NullWindow;
+    }
+    return a;
 }
 
 /**
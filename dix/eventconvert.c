@@ -65,6 +65,69 @@ static int eventToGesturePinchEvent(GestureEvent *ev, xEvent **xi);
 /* Do not use, read comments below */
 BOOL EventIsKeyRepeat(xEvent *event);
 
+/*
+ * Scratch arena backing all event conversions.  Every delivery converts
+ * an internal event into one or more wire events, hands them to the
+ * client's output buffer and discards them, which made per-conversion
+ * calloc/free the hottest allocation site on input-bound profiles.
+ * Conversions are bump-allocated from these chunks instead; the chunks
+ * are kept forever and rewound once per dispatch iteration via
+ * ResetEventConversionArena(), so the steady state allocates nothing.
+ */
+#define CONV_CHUNK_SIZE 16384
+
+typedef struct _ConvChunk {
+    struct _ConvChunk *next;
+    size_t used;
+    char data[CONV_CHUNK_SIZE];
+} ConvChunk;
+
+static ConvChunk *convChunks;   /* every chunk ever allocated */
+static ConvChunk *convCurrent;  /* chunk currently being bumped */
+
+static void *
+convAlloc(size_t len)
+{
+    ConvChunk *chunk = convCurrent;
+    void *ret;
+
+    len = (len + 15) & ~(size_t) 15;
+    if (len > CONV_CHUNK_SIZE)  /* no conversion comes anywhere close */
+        return NULL;
+
+    if (!chunk || chunk->used + len > CONV_CHUNK_SIZE) {
+        if (chunk && chunk->next) {
+            chunk = chunk->next;
+            chunk->used = 0;
+        }
+        else {
+            ConvChunk *fresh = calloc(1, sizeof(ConvChunk));
+
+            if (!fresh)
+                return NULL;
+            if (chunk)
+                chunk->next = fresh;
+            else
+                convChunks = fresh;
+            chunk = fresh;
+        }
+        convCurrent = chunk;
+    }
+
+    ret = chunk->data + chunk->used;
+    chunk->used += len;
+    memset(ret, 0, len);        /* callers rely on calloc-style zeroing */
+    return ret;
+}
+
+void
+ResetEventConversionArena(void)
+{
+    convCurrent = convChunks;
+    if (convCurrent)
+        convCurrent->used = 0;
+}
+
 /**
  * Hack to allow detectable autorepeat for core and XI1 events.
  * The sequence number is unused until we send to the client and can be
@@ -134,7 +197,7 @@ EventToCore(InternalEvent *event, xEvent **core_out, int *count_out)
             goto out;
         }
 
-        core = calloc(1, sizeof(*core));
+        core = convAlloc(sizeof(*core));
         if (!core)
             return BadAlloc;
         count = 1;
@@ -350,7 +413,7 @@ eventToKeyButtonPointer(DeviceEvent *ev, xEvent **xi, int *count)
 
     num_events++;               /* the actual event event */
 
-    *xi = calloc(num_events, sizeof(xEvent));
+    *xi = convAlloc(num_events * sizeof(xEvent));
     if (!(*xi)) {
         return BadAlloc;
     }
@@ -591,7 +654,7 @@ eventToDeviceChanged(DeviceChangedEvent *dce, xEvent **xi)
         len += sizeof(CARD32) * nkeys;  /* keycodes */
     }
 
-    dcce = calloc(1, len);
+    dcce = convAlloc(len);
     if (!dcce) {
         ErrorF("[Xi] BadAlloc in SendDeviceChangedEvent.\n");
         return BadAlloc;
@@ -673,7 +736,7 @@ eventToDeviceEvent(DeviceEvent *ev, xEvent **xi)
     vallen = bytes_to_int32(bits_to_bytes(MAX_VALUATORS));
     len += vallen * 4;          /* valuators mask */
 
-    *xi = calloc(1, len);
+    *xi = convAlloc(len);
     if (*xi == NULL)
         return BadAlloc;
     xde = (xXIDeviceEvent *) * xi;
@@ -743,7 +806,7 @@ eventToTouchOwnershipEvent(TouchOwnershipEvent *ev, xEvent **xi)
     int len = sizeof(xXITouchOwnershipEvent);
     xXITouchOwnershipEvent *xtoe;
 
-    *xi = calloc(1, len);
+    *xi = convAlloc(len);
     if (*xi == NULL)
         return BadAlloc;
     xtoe = (xXITouchOwnershipEvent *) * xi;
@@ -775,7 +838,7 @@ eventToRawEvent(RawDeviceEvent *ev, xEvent **xi)
     vallen = bytes_to_int32(bits_to_bytes(MAX_VALUATORS));
     len += vallen * 4;          /* valuators mask */
 
-    *xi = calloc(1, len);
+    *xi = convAlloc(len);
     if (*xi == NULL)
         return BadAlloc;
     raw = (xXIRawEvent *) * xi;
@@ -812,7 +875,7 @@ eventToBarrierEvent(BarrierEvent *ev, xEvent **xi)
     xXIBarrierEvent *barrier;
     int len = sizeof(xXIBarrierEvent);
 
-    *xi = calloc(1, len);
+    *xi = convAlloc(len);
     if (*xi == NULL)
         return BadAlloc;
     barrier = (xXIBarrierEvent*) *xi;
@@ -843,7 +906,7 @@ eventToGesturePinchEvent(GestureEvent *ev, xEvent **xi)
     int len = sizeof(xXIGesturePinchEvent);
     xXIGesturePinchEvent *xpe;
 
-    *xi = calloc(1, len);
+    *xi = convAlloc(len);
     if (*xi == NULL)
         return BadAlloc;
     xpe = (xXIGesturePinchEvent *) * xi;
@@ -887,7 +950,7 @@ eventToGestureSwipeEvent(GestureEvent *ev, xEvent **xi)
     int len = sizeof(xXIGestureSwipeEvent);
     xXIGestureSwipeEvent *xde;
 
-    *xi = calloc(1, len);
+    *xi = convAlloc(len);
     if (*xi == NULL)
         return BadAlloc;
     xde = (xXIGestureSwipeEvent *) * xi;
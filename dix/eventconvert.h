@@ -32,9 +32,17 @@
 #include "events.h"
 #include "eventstr.h"
 
+/*
+ * The wire events returned by the conversion routines live in a scratch
+ * arena owned by eventconvert.c: do not free them and do not keep them
+ * across dispatch iterations. The arena is rewound by the dispatch loop
+ * through ResetEventConversionArena() once all pending input has been
+ * processed and delivered.
+ */
 int EventToCore(InternalEvent *event, xEvent **core, int *count);
 int EventToXI(InternalEvent *ev, xEvent **xi, int *count);
 int EventToXI2(InternalEvent *ev, xEvent **xi);
+void ResetEventConversionArena(void);
 int GetCoreType(enum EventType type);
 int GetXIType(enum EventType type);
 int GetXI2Type(enum EventType type);
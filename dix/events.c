@@ -126,6 +126,7 @@ Equipment Corporation.
 #include "dix/exevents_priv.h"
 #include "dix/extension_priv.h"
 #include "dix/input_priv.h"
+#include "dix/inputlatency_priv.h"
 #include "dix/inpututils_priv.h"
 #include "dix/reqhandlers_priv.h"
 #include "dix/request_priv.h"
@@ -381,6 +382,10 @@ extern int lastEvent;
  */
 Mask event_filters[MAXDEVICES][MAXEVENTS];
 
+CARD32 dixEventInterestGeneration = 1;
+
+CARD32 dixHitGeometryGeneration = 1;
+
 static const Mask default_filter[MAXEVENTS] = {
     NoSuchEvent,                /* 0 */
     NoSuchEvent,                /* 1 */
@@ -690,6 +695,7 @@ SetMaskForEvent(int deviceid, Mask mask, int event)
     if (deviceid < 0 || deviceid >= MAXDEVICES)
         FatalError("SetMaskForEvent: bogus device id");
     event_filters[deviceid][event] = mask;
+    dixEventInterestGeneration++;
 }
 
 void
@@ -981,10 +987,12 @@ ChangeToCursor(DeviceIntPtr pDev, CursorPtr cursor)
 Bool
 WindowIsParent(WindowPtr a, WindowPtr b)
 {
-    for (b = b->parent; b; b = b->parent)
-        if (b == a)
-            return TRUE;
-    return FALSE;
+    /* an ancestor is strictly shallower; climb b to a's depth and
+       compare once instead of testing every ancestor */
+    if (a->treeDepth >= b->treeDepth)
+        return FALSE;
+    for (b = b->parent; b->treeDepth > a->treeDepth; b = b->parent);
+    return b == a;
 }
 
 /**
@@ -2428,8 +2436,18 @@ DeliverEventsToWindow(DeviceIntPtr pDev, WindowPtr pWin, xEvent
             CheckDeviceGrabAndHintWindow(pWin, type,
                                          (deviceKeyButtonPointer *) pEvents,
                                          grab, client, deliveryMask);
+#ifdef XSERVER_DTRACE
+        if (XSERVER_DELIVER_EVENT_ENABLED())
+            XSERVER_DELIVER_EVENT(pWin->drawable.id, type, (int) count,
+                                  deliveries);
+#endif
         return deliveries;
     }
+#ifdef XSERVER_DTRACE
+    if (XSERVER_DELIVER_EVENT_ENABLED())
+        XSERVER_DELIVER_EVENT(pWin->drawable.id, type, (int) count,
+                              nondeliveries);
+#endif
     return nondeliveries;
 }
 
@@ -2517,7 +2535,6 @@ DeliverRawEvent(RawDeviceEvent *ev, DeviceIntPtr device)
         }
     });
 
-    free(xi);
 }
 
 /* If the event goes to dontClient, don't send it and return 0.  if
@@ -2760,6 +2777,11 @@ FixUpEventFromWindow(SpritePtr pSprite,
  * @param[in] evtype The event type of the event that is to be sent.
  * @param[in] win The current event window.
  *
+ * The result is memoized in the window: at 60 FPS a motion stream asks the
+ * same question about the same windows over and over, and the answer only
+ * changes when some client's event selection does.  Any such change bumps
+ * dixEventInterestGeneration, which invalidates all memos at once.
+ *
  * @return Bitmask of ::EVENT_XI2_MASK, ::EVENT_XI1_MASK, ::EVENT_CORE_MASK, and
  *         ::EVENT_DONT_PROPAGATE_MASK.
  */
@@ -2771,6 +2793,10 @@ EventIsDeliverable(DeviceIntPtr dev, int evtype, WindowPtr win)
     int type;
     OtherInputMasks *inputMasks = wOtherInputMasks(win);
 
+    if (win->interestGeneration == dixEventInterestGeneration &&
+        win->interestDevice == dev->id && win->interestEvtype == evtype)
+        return win->interestMask;
+
     if ((type = GetXI2Type(evtype)) != 0) {
         if (inputMasks && xi2mask_isset(inputMasks->xi2mask, dev, type))
             rc |= EVENT_XI2_MASK;
@@ -2804,6 +2830,11 @@ EventIsDeliverable(DeviceIntPtr dev, int evtype, WindowPtr win)
             rc |= EVENT_DONT_PROPAGATE_MASK;
     }
 
+    win->interestGeneration = dixEventInterestGeneration;
+    win->interestDevice = dev->id;
+    win->interestEvtype = evtype;
+    win->interestMask = rc;
+
     return rc;
 }
 
@@ -2851,7 +2882,6 @@ DeliverOneEvent(InternalEvent *event, DeviceIntPtr dev, enum InputLevel level,
 
     if (rc == Success) {
         deliveries = DeliverEvent(dev, xE, count, win, child, grab, level);
-        free(xE);
     }
     else
         BUG_WARN_MSG(rc != BadMatch,
@@ -3270,6 +3300,8 @@ WindowsRestructured(void)
 {
     DeviceIntPtr pDev = inputInfo.devices;
 
+    dixHitGeometryGeneration++;
+
     while (pDev) {
         if (InputDevIsMaster(pDev) || InputDevIsFloating(pDev))
             CheckMotion(NULL, pDev);
@@ -3333,6 +3365,7 @@ InitializeSprite(DeviceIntPtr pDev, WindowPtr pWin)
 
     pSprite->hot = pSprite->hotPhys;
     pSprite->win = pWin;
+    pSprite->traceGeneration = 0;       /* drop any cached XYToWindow box */
 
     if (pWin) {
         pCursor = wCursor(pWin);
@@ -3839,7 +3872,6 @@ ActivatePassiveGrab(DeviceIntPtr device, GrabPtr grab, InternalEvent *event,
                         GetEventFilter(device, xE), grab);
     }
 
-    free(xE);
     return TRUE;
 }
 
@@ -4056,31 +4088,38 @@ CheckPassiveGrabsOnWindow(WindowPtr pWin,
 {
     GrabPtr grab = wPassiveGrabs(pWin);
     GrabPtr tempGrab;
+    unsigned int detail;
 
     if (!grab)
         return NULL;
 
-    tempGrab = AllocGrab(NULL);
-    if (tempGrab == NULL)
-        return NULL;
-
-    /* Fill out the grab details, but leave the type for later before
-     * comparing */
     switch (event->any.type) {
     case ET_KeyPress:
     case ET_KeyRelease:
-        tempGrab->detail.exact = event->device_event.detail.key;
+        detail = event->device_event.detail.key;
         break;
     case ET_ButtonPress:
     case ET_ButtonRelease:
     case ET_TouchBegin:
     case ET_TouchEnd:
-        tempGrab->detail.exact = event->device_event.detail.button;
+        detail = event->device_event.detail.button;
         break;
     default:
-        tempGrab->detail.exact = 0;
+        detail = 0;
         break;
     }
+
+    /* no grab on this window claims the event's keycode/button */
+    if (!PassiveGrabsMayMatchDetail(pWin, detail))
+        return NULL;
+
+    tempGrab = AllocGrab(NULL);
+    if (tempGrab == NULL)
+        return NULL;
+
+    /* Fill out the grab details, but leave the type for later before
+     * comparing */
+    tempGrab->detail.exact = detail;
     tempGrab->window = pWin;
     tempGrab->device = device;
     tempGrab->detail.pMask = NULL;
@@ -4088,6 +4127,9 @@ CheckPassiveGrabsOnWindow(WindowPtr pWin,
     tempGrab->next = NULL;
 
     for (; grab; grab = grab->next) {
+        if (!GrabMayMatchDetail(grab, detail))
+            continue;
+
         if (!CheckPassiveGrab(device, grab, event, checkCore, tempGrab))
             continue;
 
@@ -4147,6 +4189,22 @@ CheckDeviceGrabs(DeviceIntPtr device, InternalEvent *ievent, WindowPtr ancestor)
     if (device->deviceGrab.grab)
         return FALSE;
 
+    WindowPtr deepest = device->spriteInfo->sprite->spriteTraceGood ?
+        device->spriteInfo->sprite->
+            spriteTrace[device->spriteInfo->sprite->spriteTraceGood - 1] : NULL;
+
+    /* If the identical press already walked the grab lists and activated
+     * nothing, and neither the lists, the modifier state nor the window
+     * tree changed since, the walk can only come up empty again. */
+    if (!ancestor &&
+        device->noGrabGeneration == dixPassiveGrabGeneration &&
+        device->noGrabTreeGeneration == dixWindowTreeGeneration &&
+        device->noGrabEvtype == event->type &&
+        device->noGrabDetail == event->detail.button &&
+        device->noGrabSpriteWin == deepest &&
+        device->noGrabFocusWin == (focus ? focus->win : NULL))
+        return FALSE;
+
     i = 0;
     if (ancestor) {
         while (i < device->spriteInfo->sprite->spriteTraceGood)
@@ -4184,6 +4242,14 @@ CheckDeviceGrabs(DeviceIntPtr device, InternalEvent *ievent, WindowPtr ancestor)
  out:
     if (ret == TRUE && event->type == ET_KeyPress)
         device->deviceGrab.activatingKey = event->detail.key;
+    else if (!ret && !ancestor) {
+        device->noGrabGeneration = dixPassiveGrabGeneration;
+        device->noGrabTreeGeneration = dixWindowTreeGeneration;
+        device->noGrabEvtype = event->type;
+        device->noGrabDetail = event->detail.button;
+        device->noGrabSpriteWin = deepest;
+        device->noGrabFocusWin = focus ? focus->win : NULL;
+    }
     return ret;
 }
 
@@ -4274,9 +4340,6 @@ DeliverFocusedEvent(DeviceIntPtr keybd, InternalEvent *event, WindowPtr window)
     }
 
  unwind:
-    free(core);
-    free(xE);
-    free(xi2);
     return;
 }
 
@@ -4342,7 +4405,6 @@ DeliverOneGrabbedEvent(InternalEvent *event, DeviceIntPtr dev,
                      "%s: conversion to mode %d failed on %d with %d\n",
                      dev->name, level, event->any.type, rc);
 
-    free(xE);
     return deliveries;
 }
 
@@ -4487,6 +4549,8 @@ RecalculateDeliverableEvents(WindowPtr pWin)
 {
     WindowPtr pChild;
 
+    dixEventInterestGeneration++;
+
     pChild = pWin;
     while (1) {
         if (pChild->optional) {
@@ -6051,6 +6115,10 @@ WriteEventsToClient(ClientPtr pClient, int count, xEvent *events)
     if (!pClient || pClient == serverClient || pClient->clientGone)
         return;
 
+    /* if an input event is being processed, this write completes its
+       enqueue-to-delivery latency measurement */
+    InputLatencyRecordDelivery();
+
     for (int i = 0; i < count; i++)
         if ((events[i].u.u.type & 0x7f) != KeymapNotify)
             events[i].u.u.sequenceNumber = pClient->sequence;
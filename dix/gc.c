@@ -74,6 +74,9 @@ static unsigned char DefaultDash[2] = { 4, 4 };
 void
 ValidateGC(DrawablePtr pDraw, GCPtr pGC)
 {
+    /* nothing changed since the last validation against this drawable */
+    if (!pGC->stateChanges && pGC->serialNumber == (unsigned)pDraw->serialNumber)
+        return;
     (*pGC->funcs->ValidateGC) (pGC, pGC->stateChanges, pDraw);
     pGC->stateChanges = 0;
     pGC->serialNumber = (unsigned)pDraw->serialNumber;
@@ -126,23 +129,26 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
     int error = 0;
     PixmapPtr pPixmap;
     BITS32 maskQ;
+    BITS32 changed = 0;         /* fields whose stored value actually changed */
 
     assert(pUnion);
-    pGC->serialNumber |= GC_CHANGE_SERIAL_BIT;
 
     maskQ = mask;               /* save these for when we walk the GCque */
     while (mask && !error) {
         index2 = (BITS32) lowbit(mask);
         mask &= ~index2;
-        pGC->stateChanges |= index2;
         switch (index2) {
         case GCFunction:
         {
             CARD8 newalu;
             NEXTVAL(CARD8, newalu);
 
-            if (newalu <= GXset)
-                pGC->alu = newalu;
+            if (newalu <= GXset) {
+                if (pGC->alu != newalu) {
+                    pGC->alu = newalu;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newalu;
@@ -151,35 +157,68 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             break;
         }
         case GCPlaneMask:
-            NEXTVAL(unsigned long, pGC->planemask);
+        {
+            unsigned long newpm;
+            NEXTVAL(unsigned long, newpm);
 
+            if (pGC->planemask != newpm) {
+                pGC->planemask = newpm;
+                changed |= index2;
+            }
             break;
+        }
         case GCForeground:
-            NEXTVAL(unsigned long, pGC->fgPixel);
+        {
+            unsigned long newfg;
+            NEXTVAL(unsigned long, newfg);
 
+            if (pGC->fgPixel != newfg) {
+                pGC->fgPixel = newfg;
+                changed |= index2;
+            }
             /*
              * this is for CreateGC
              */
             if (!pGC->tileIsPixel && !pGC->tile.pixmap) {
                 pGC->tileIsPixel = TRUE;
                 pGC->tile.pixel = pGC->fgPixel;
+                changed |= index2;
             }
             break;
+        }
         case GCBackground:
-            NEXTVAL(unsigned long, pGC->bgPixel);
+        {
+            unsigned long newbg;
+            NEXTVAL(unsigned long, newbg);
 
+            if (pGC->bgPixel != newbg) {
+                pGC->bgPixel = newbg;
+                changed |= index2;
+            }
             break;
+        }
         case GCLineWidth:      /* ??? line width is a CARD16 */
-            NEXTVAL(CARD16, pGC->lineWidth);
+        {
+            CARD16 newwidth;
+            NEXTVAL(CARD16, newwidth);
 
+            if (pGC->lineWidth != newwidth) {
+                pGC->lineWidth = newwidth;
+                changed |= index2;
+            }
             break;
+        }
         case GCLineStyle:
         {
             unsigned int newlinestyle;
             NEXTVAL(unsigned int, newlinestyle);
 
-            if (newlinestyle <= LineDoubleDash)
-                pGC->lineStyle = newlinestyle;
+            if (newlinestyle <= LineDoubleDash) {
+                if (pGC->lineStyle != newlinestyle) {
+                    pGC->lineStyle = newlinestyle;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newlinestyle;
@@ -192,8 +231,12 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             unsigned int newcapstyle;
             NEXTVAL(unsigned int, newcapstyle);
 
-            if (newcapstyle <= CapProjecting)
-                pGC->capStyle = newcapstyle;
+            if (newcapstyle <= CapProjecting) {
+                if (pGC->capStyle != newcapstyle) {
+                    pGC->capStyle = newcapstyle;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newcapstyle;
@@ -206,8 +249,12 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             unsigned int newjoinstyle;
             NEXTVAL(unsigned int, newjoinstyle);
 
-            if (newjoinstyle <= JoinBevel)
-                pGC->joinStyle = newjoinstyle;
+            if (newjoinstyle <= JoinBevel) {
+                if (pGC->joinStyle != newjoinstyle) {
+                    pGC->joinStyle = newjoinstyle;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newjoinstyle;
@@ -220,8 +267,12 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             unsigned int newfillstyle;
             NEXTVAL(unsigned int, newfillstyle);
 
-            if (newfillstyle <= FillOpaqueStippled)
-                pGC->fillStyle = newfillstyle;
+            if (newfillstyle <= FillOpaqueStippled) {
+                if (pGC->fillStyle != newfillstyle) {
+                    pGC->fillStyle = newfillstyle;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newfillstyle;
@@ -234,8 +285,12 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             unsigned int newfillrule;
             NEXTVAL(unsigned int, newfillrule);
 
-            if (newfillrule <= WindingRule)
-                pGC->fillRule = newfillrule;
+            if (newfillrule <= WindingRule) {
+                if (pGC->fillRule != newfillrule) {
+                    pGC->fillRule = newfillrule;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newfillrule;
@@ -256,6 +311,10 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
                     dixDestroyPixmap(pGC->tile.pixmap, 0);
                 pGC->tileIsPixel = FALSE;
                 pGC->tile.pixmap = pPixmap;
+                /* re-setting the same pixmap still counts as a change:
+                   the ddx may need to re-pad contents drawn since the
+                   tile was last validated */
+                changed |= index2;
             }
             break;
         case GCStipple:
@@ -272,25 +331,43 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
                 if (pGC->stipple)
                     dixDestroyPixmap(pGC->stipple, 0);
                 pGC->stipple = pPixmap;
+                changed |= index2;
             }
             break;
         case GCTileStipXOrigin:
-            NEXTVAL(INT16, pGC->patOrg.x);
+        {
+            INT16 newx;
+            NEXTVAL(INT16, newx);
 
+            if (pGC->patOrg.x != newx) {
+                pGC->patOrg.x = newx;
+                changed |= index2;
+            }
             break;
+        }
         case GCTileStipYOrigin:
-            NEXTVAL(INT16, pGC->patOrg.y);
+        {
+            INT16 newy;
+            NEXTVAL(INT16, newy);
 
+            if (pGC->patOrg.y != newy) {
+                pGC->patOrg.y = newy;
+                changed |= index2;
+            }
             break;
+        }
         case GCFont:
         {
             FontPtr pFont;
             NEXT_PTR(FontPtr, pFont);
 
-            pFont->refcnt++;
-            if (pGC->font)
-                CloseFont(pGC->font, (Font) 0);
-            pGC->font = pFont;
+            if (pGC->font != pFont) {
+                pFont->refcnt++;
+                if (pGC->font)
+                    CloseFont(pGC->font, (Font) 0);
+                pGC->font = pFont;
+                changed |= index2;
+            }
             break;
         }
         case GCSubwindowMode:
@@ -298,8 +375,12 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             unsigned int newclipmode;
             NEXTVAL(unsigned int, newclipmode);
 
-            if (newclipmode <= IncludeInferiors)
-                pGC->subWindowMode = newclipmode;
+            if (newclipmode <= IncludeInferiors) {
+                if (pGC->subWindowMode != newclipmode) {
+                    pGC->subWindowMode = newclipmode;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newclipmode;
@@ -312,8 +393,12 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             unsigned int newge;
             NEXTVAL(unsigned int, newge);
 
-            if (newge <= xTrue)
-                pGC->graphicsExposures = newge;
+            if (newge <= xTrue) {
+                if (pGC->graphicsExposures != newge) {
+                    pGC->graphicsExposures = newge;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newge;
@@ -322,13 +407,27 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             break;
         }
         case GCClipXOrigin:
-            NEXTVAL(INT16, pGC->clipOrg.x);
+        {
+            INT16 newx;
+            NEXTVAL(INT16, newx);
 
+            if (pGC->clipOrg.x != newx) {
+                pGC->clipOrg.x = newx;
+                changed |= index2;
+            }
             break;
+        }
         case GCClipYOrigin:
-            NEXTVAL(INT16, pGC->clipOrg.y);
+        {
+            INT16 newy;
+            NEXTVAL(INT16, newy);
 
+            if (pGC->clipOrg.y != newy) {
+                pGC->clipOrg.y = newy;
+                changed |= index2;
+            }
             break;
+        }
         case GCClipMask:
             NEXT_PTR(PixmapPtr, pPixmap);
 
@@ -342,11 +441,19 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             }
             (*pGC->funcs->ChangeClip) (pGC, pPixmap ? CT_PIXMAP : CT_NONE,
                                        (void *) pPixmap, 0);
+            changed |= index2;
             break;
         case GCDashOffset:
-            NEXTVAL(INT16, pGC->dashOffset);
+        {
+            INT16 newoff;
+            NEXTVAL(INT16, newoff);
 
+            if (pGC->dashOffset != newoff) {
+                pGC->dashOffset = newoff;
+                changed |= index2;
+            }
             break;
+        }
         case GCDashList:
         {
             CARD8 newdash;
@@ -357,9 +464,13 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
                     free(pGC->dash);
                     pGC->numInDashList = 2;
                     pGC->dash = DefaultDash;
+                    changed |= index2;
                 }
             }
             else if (newdash != 0) {
+                if (pGC->numInDashList == 2 &&
+                    pGC->dash[0] == newdash && pGC->dash[1] == newdash)
+                    break;
                 unsigned char *dash = calloc(2, sizeof(unsigned char));
                 if (dash) {
                     if (pGC->dash != DefaultDash)
@@ -368,6 +479,7 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
                     pGC->dash = dash;
                     dash[0] = newdash;
                     dash[1] = newdash;
+                    changed |= index2;
                 }
                 else
                     error = BadAlloc;
@@ -384,8 +496,12 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
             unsigned int newarcmode;
             NEXTVAL(unsigned int, newarcmode);
 
-            if (newarcmode <= ArcPieSlice)
-                pGC->arcMode = newarcmode;
+            if (newarcmode <= ArcPieSlice) {
+                if (pGC->arcMode != newarcmode) {
+                    pGC->arcMode = newarcmode;
+                    changed |= index2;
+                }
+            }
             else {
                 if (client)
                     client->errorValue = newarcmode;
@@ -405,9 +521,19 @@ ChangeGC(ClientPtr client, GCPtr pGC, BITS32 mask, ChangeGCValPtr pUnion)
         if (!CreateDefaultTile(pGC)) {
             pGC->fillStyle = FillSolid;
             error = BadAlloc;
+            changed |= GCFillStyle;
         }
+        else
+            changed |= GCTile;
+    }
+    /* only a real change dirties the GC; a no-op ChangeGC leaves the
+       serial number intact so the next drawing request skips ValidateGC
+       entirely */
+    if (changed) {
+        pGC->stateChanges |= changed;
+        pGC->serialNumber |= GC_CHANGE_SERIAL_BIT;
+        (*pGC->funcs->ChangeGC) (pGC, changed);
     }
-    (*pGC->funcs->ChangeGC) (pGC, maskQ);
     return error;
 }
 
@@ -180,6 +180,8 @@ GestureAddListener(GestureInfoPtr gi, XID resource, int resource_type,
     gi->listener.type = type;
     gi->listener.window = window;
     gi->listener.grab = g;
+    gi->listener.resolveInterestGen = 0;
+    gi->listener.resolveTreeGen = 0;
     gi->has_listener = TRUE;
 }
 
@@ -332,7 +334,7 @@ GestureEndActiveGestures(DeviceIntPtr dev)
     if (!g)
         return;
 
-    eventlist = InitEventList(GetMaximumEventsNum());
+    eventlist = AcquireEventList(dev);
 
     input_lock();
     mieqProcessInputEvents();
@@ -346,7 +348,7 @@ GestureEndActiveGestures(DeviceIntPtr dev)
     }
     input_unlock();
 
-    FreeEventList(eventlist, GetMaximumEventsNum());
+    ReleaseEventList(dev, eventlist);
 }
 
 /**
@@ -1144,6 +1144,35 @@ FreeEventList(InternalEvent *list, int num_events)
     free(list);
 }
 
+/**
+ * Return a GetMaximumEventsNum()-sized event list for assembling events
+ * on behalf of dev, preferring the device's preallocated scratch list so
+ * the hot paths stay free of heap traffic.  Falls back to a fresh
+ * allocation when the scratch list is already handed out (nested use) or
+ * when there is no device.  Pair every call with ReleaseEventList().
+ */
+InternalEvent *
+AcquireEventList(DeviceIntPtr dev)
+{
+    if (dev && dev->scratchEvents && !dev->scratchEventsInUse) {
+        dev->scratchEventsInUse = TRUE;
+        return dev->scratchEvents;
+    }
+    return InitEventList(GetMaximumEventsNum());
+}
+
+/**
+ * Hand back an event list obtained from AcquireEventList().
+ */
+void
+ReleaseEventList(DeviceIntPtr dev, InternalEvent *list)
+{
+    if (dev && list == dev->scratchEvents)
+        dev->scratchEventsInUse = FALSE;
+    else
+        FreeEventList(list, GetMaximumEventsNum());
+}
+
 /**
  * Transform vector x/y according to matrix m and drop the rounded coords
  * back into x/y.
@@ -1163,6 +1192,15 @@ transformRelative(DeviceIntPtr dev, ValuatorMask *mask)
 {
     double x = 0, y = 0;
 
+    if (dev->relative_transform_identity) {
+        /* keep the side effect of the full path: zero deltas are dropped */
+        if (valuator_mask_isset(mask, 0) && !valuator_mask_get_double(mask, 0))
+            valuator_mask_unset(mask, 0);
+        if (valuator_mask_isset(mask, 1) && !valuator_mask_get_double(mask, 1))
+            valuator_mask_unset(mask, 1);
+        return;
+    }
+
     valuator_mask_fetch_double(mask, 0, &x);
     valuator_mask_fetch_double(mask, 1, &y);
 
@@ -1193,12 +1231,33 @@ transformAbsolute(DeviceIntPtr dev, ValuatorMask *mask)
     double x, y, ox = 0.0, oy = 0.0;
     int has_x, has_y;
 
+    if (dev->scale_and_transform_identity)
+        return;
+
     has_x = valuator_mask_isset(mask, 0);
     has_y = valuator_mask_isset(mask, 1);
 
     if (!has_x && !has_y)
         return;
 
+    /* Scale/translate-only matrices transform x and y independently, so
+     * each present axis can be mapped directly and the expensive
+     * invert-last-event dance for partial masks is not needed.
+     */
+    if (dev->scale_and_transform_st) {
+        const struct pixman_f_transform *m = &dev->scale_and_transform;
+
+        if (has_x) {
+            x = m->m[0][0] * valuator_mask_get_double(mask, 0) + m->m[0][2];
+            valuator_mask_set_double(mask, 0, x);
+        }
+        if (has_y) {
+            y = m->m[1][1] * valuator_mask_get_double(mask, 1) + m->m[1][2];
+            valuator_mask_set_double(mask, 1, y);
+        }
+        return;
+    }
+
     if (!has_x || !has_y) {
         struct pixman_f_transform invert;
 
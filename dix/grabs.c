@@ -72,6 +72,11 @@ SOFTWARE.
                                    modifier combinations, but only
                                    3 buttons. */
 
+/* Invalidates the per-device negative CheckDeviceGrabs() memo; bumped
+ * here on every passive grab list mutation and from XkbComputeDerivedState
+ * when a device's grab modifier state actually changes. */
+CARD32 dixPassiveGrabGeneration = 1;
+
 #define BITMASK(i) (((Mask)1) << ((i) & 31))
 #define MASKIDX(i) ((i) >> 5)
 #define MASKWORD(buf, i) buf[MASKIDX(i)]
@@ -79,6 +84,67 @@ SOFTWARE.
 #define BITCLEAR(buf, i) MASKWORD(buf, i) &= ~BITMASK(i)
 #define GETBIT(buf, i) (MASKWORD(buf, i) & BITMASK(i))
 
+/*
+ * Passive grab matching walks every grab on every window of the event's
+ * ancestry.  To keep that walk cheap when nothing can match, each window
+ * summarizes the detail (keycode/button) values its grabs claim in a
+ * bitmap; a press whose detail has no bit set can skip the window without
+ * even allocating the comparison grab.  The summary is conservative:
+ * AnyKey/AnyButton grabs without a detail mask set passiveGrabAnyDetail,
+ * which disables the filter for that window.
+ */
+static void
+RecomputePassiveGrabDetails(WindowPtr pWin)
+{
+    WindowOptPtr optional = pWin->optional;
+
+    if (!optional)
+        return;
+
+    memset(optional->passiveGrabDetails, 0,
+           sizeof(optional->passiveGrabDetails));
+    optional->passiveGrabAnyDetail = FALSE;
+
+    for (GrabPtr grab = optional->passiveGrabs; grab; grab = grab->next) {
+        if (grab->detail.exact == (unsigned int) AnyKey) {
+            if (!grab->detail.pMask) {
+                optional->passiveGrabAnyDetail = TRUE;
+                return;
+            }
+            for (int i = 0; i < MasksPerDetailMask; i++)
+                optional->passiveGrabDetails[i] |= grab->detail.pMask[i];
+        }
+        else if (grab->detail.exact < 32 * MasksPerDetailMask)
+            BITSET(optional->passiveGrabDetails, grab->detail.exact);
+        else {
+            optional->passiveGrabAnyDetail = TRUE;
+            return;
+        }
+    }
+}
+
+Bool
+PassiveGrabsMayMatchDetail(WindowPtr pWin, unsigned int detail)
+{
+    WindowOptPtr optional = pWin->optional;
+
+    if (!optional || optional->passiveGrabAnyDetail ||
+        detail == 0 || detail >= 32 * MasksPerDetailMask)
+        return TRUE;
+    return GETBIT(optional->passiveGrabDetails, detail) != 0;
+}
+
+Bool
+GrabMayMatchDetail(GrabPtr grab, unsigned int detail)
+{
+    if (detail == 0 || detail >= 32 * MasksPerDetailMask ||
+        grab->detail.exact == detail)
+        return TRUE;
+    if (grab->detail.exact != (unsigned int) AnyKey)
+        return FALSE;
+    return !grab->detail.pMask || GETBIT(grab->detail.pMask, detail) != 0;
+}
+
 void
 PrintDeviceGrabInfo(DeviceIntPtr dev)
 {
@@ -333,6 +399,8 @@ DeletePassiveGrab(void *value, XID id)
                 prev->next = g->next;
             else if (!(pGrab->window->optional->passiveGrabs = g->next))
                 CheckWindowOptionalNeed(pGrab->window);
+            dixPassiveGrabGeneration++;
+            RecomputePassiveGrabDetails(pGrab->window);
             break;
         }
         prev = g;
@@ -563,6 +631,8 @@ AddPassiveGrabToList(ClientPtr client, GrabPtr pGrab)
 
     pGrab->next = pGrab->window->optional->passiveGrabs;
     pGrab->window->optional->passiveGrabs = pGrab;
+    dixPassiveGrabGeneration++;
+    RecomputePassiveGrabDetails(pGrab->window);
     if (AddResource(pGrab->resource, X11_RESTYPE_PASSIVEGRAB, (void *) pGrab))
         return Success;
     return BadAlloc;
@@ -691,6 +761,8 @@ DeletePassiveGrabFromList(GrabPtr pMinuendGrab)
             free(*updates[j]);
             *updates[j] = details[j];
         }
+        dixPassiveGrabGeneration++;
+        RecomputePassiveGrabDetails(pMinuendGrab->window);
     }
     free(details);
     free(updates);
@@ -107,6 +107,11 @@ InternalEvent *UpdateFromMaster(InternalEvent *events,
                                 int type,
                                 int *num_events);
 
+/* hand out / hand back the device's preallocated scratch event list
+   (GetMaximumEventsNum() entries); falls back to the heap on nested use */
+InternalEvent *AcquireEventList(DeviceIntPtr dev);
+void ReleaseEventList(DeviceIntPtr dev, InternalEvent *list);
+
 void PostSyntheticMotion(DeviceIntPtr pDev,
                          int x,
                          int y,
@@ -366,6 +371,8 @@ void input_constrain_cursor(DeviceIntPtr pDev,
 void InputThreadPreInit(void);
 void InputThreadInit(void);
 void InputThreadFini(void);
+void InputThreadPrepareSleep(void);
+void InputThreadFinishSleep(void);
 
 int InputThreadRegisterDev(int fd,
                            NotifyFdProcPtr readInputProc,
@@ -0,0 +1,174 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * per-device input event latency tracking
+ *
+ * every event is stamped with the monotonic clock when it enters the mi
+ * event queue.  two deltas are accounted per originating device: queue
+ * (enqueue until mieqProcessInputEvents() dequeues the event) and
+ * delivery (enqueue until the first resulting wire event is written to a
+ * client).  the counters feed log2 histograms so the SIGUSR2 statistics
+ * dump can report average, approximate 99th percentile and worst case
+ * without storing individual samples - a regression in the input
+ * pipeline shows up in the log instead of in support tickets.
+ */
+#include <dix-config.h>
+
+#include <string.h>
+
+#include "dix/inputlatency_priv.h"
+#include "dix/reqprof_priv.h"
+
+#include "inputstr.h"
+#include "misc.h"
+#include "os.h"
+
+/* log2 buckets of microseconds: < 1us up to >= 0.25s */
+#define LATENCY_BUCKETS 19
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[LATENCY_BUCKETS];
+} LatencyStage;
+
+typedef struct {
+    Bool used;
+    char name[64];              /* snapshot; the device may be gone at dump time */
+    LatencyStage queue;
+    LatencyStage delivery;
+} LatencyDev;
+
+static LatencyDev devLatency[MAXDEVICES];
+
+/* event currently being processed by mieqProcessInputEvents() */
+static int currentDevice = -1;
+static uint64_t currentEnqueueNs;
+static Bool currentDelivered;
+
+static void
+recordStage(LatencyStage *stage, uint64_t delta_ns)
+{
+    uint64_t us = delta_ns / 1000;
+    int bucket = 0;
+
+    while (us > 1 && bucket < LATENCY_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+
+    stage->count++;
+    stage->total_ns += delta_ns;
+    if (delta_ns > stage->max_ns)
+        stage->max_ns = delta_ns;
+    stage->buckets[bucket]++;
+}
+
+static LatencyDev *
+latencyDevFor(DeviceIntPtr dev)
+{
+    LatencyDev *slot;
+
+    if (!dev || dev->id >= MAXDEVICES)
+        return NULL;
+
+    slot = &devLatency[dev->id];
+    if (!slot->used) {
+        slot->used = TRUE;
+        snprintf(slot->name, sizeof(slot->name), "%s",
+                 dev->name ? dev->name : "?");
+    }
+    return slot;
+}
+
+void
+InputLatencyRecordQueued(DeviceIntPtr dev, uint64_t enqueue_ns)
+{
+    LatencyDev *slot = latencyDevFor(dev);
+
+    if (!slot || !enqueue_ns)
+        return;
+    recordStage(&slot->queue, RequestProfileNow() - enqueue_ns);
+}
+
+void
+InputLatencyBeginProcessing(DeviceIntPtr dev, uint64_t enqueue_ns)
+{
+    if (!dev || dev->id >= MAXDEVICES || !enqueue_ns)
+        return;
+    currentDevice = dev->id;
+    currentEnqueueNs = enqueue_ns;
+    currentDelivered = FALSE;
+}
+
+void
+InputLatencyEndProcessing(void)
+{
+    currentDevice = -1;
+}
+
+void
+InputLatencyRecordDelivery(void)
+{
+    /* an event may fan out to many clients; the first write is the
+       latency a user would perceive */
+    if (currentDevice < 0 || currentDelivered)
+        return;
+    currentDelivered = TRUE;
+    recordStage(&devLatency[currentDevice].delivery,
+                RequestProfileNow() - currentEnqueueNs);
+}
+
+static uint64_t
+stageP99Us(const LatencyStage *stage)
+{
+    uint64_t below = stage->count - stage->count / 100;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += stage->buckets[i];
+        if (seen >= below)
+            return (uint64_t) 1 << i;
+    }
+    return (uint64_t) 1 << (LATENCY_BUCKETS - 1);
+}
+
+static void
+dumpStage(const char *name, const char *label, const LatencyStage *stage)
+{
+    if (!stage->count)
+        return;
+    LogMessage(X_NONE,
+               "  %-28s %-9s %10lu %8lu %8lu %8lu\n",
+               name, label,
+               (unsigned long) stage->count,
+               (unsigned long) (stage->total_ns / stage->count / 1000),
+               (unsigned long) stageP99Us(stage),
+               (unsigned long) (stage->max_ns / 1000));
+}
+
+void
+InputLatencyDump(void)
+{
+    Bool any = FALSE;
+
+    for (int i = 0; i < MAXDEVICES; i++)
+        if (devLatency[i].queue.count || devLatency[i].delivery.count)
+            any = TRUE;
+    if (!any)
+        return;
+
+    LogMessage(X_INFO, "input event latency since last dump:\n");
+    LogMessage(X_NONE,
+               "  %-28s %-9s %10s %8s %8s %8s\n",
+               "device", "stage", "events", "avg-us", "p99-us", "max-us");
+
+    for (int i = 0; i < MAXDEVICES; i++) {
+        dumpStage(devLatency[i].name, "queue", &devLatency[i].queue);
+        dumpStage(devLatency[i].name, "delivery", &devLatency[i].delivery);
+    }
+
+    /* start a fresh measurement window; names are re-captured on the
+       next recorded event */
+    memset(devLatency, 0, sizeof(devLatency));
+}
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * per-device input event latency tracking
+ */
+#ifndef _XSERVER_DIX_INPUTLATENCY_PRIV_H
+#define _XSERVER_DIX_INPUTLATENCY_PRIV_H
+
+#include <stdint.h>
+
+#include "include/input.h"
+
+/* account the time @dev's event spent in the mi event queue; @enqueue_ns
+   is the stamp taken by mieqEnqueue() */
+void InputLatencyRecordQueued(DeviceIntPtr dev, uint64_t enqueue_ns);
+
+/* bracket the processing of one dequeued event so deliveries can be
+   attributed back to it */
+void InputLatencyBeginProcessing(DeviceIntPtr dev, uint64_t enqueue_ns);
+void InputLatencyEndProcessing(void);
+
+/* called from WriteEventsToClient(); accounts enqueue-to-client-write
+   latency for the event currently being processed, once per event */
+void InputLatencyRecordDelivery(void);
+
+/* dump the per-device histograms to the log and reset them */
+void InputLatencyDump(void);
+
+#endif /* _XSERVER_DIX_INPUTLATENCY_PRIV_H */
@@ -86,6 +86,7 @@ Equipment Corporation.
 
 #include "config/hotplug_priv.h"
 #include "dix/atom_priv.h"
+#include "dix/bootprof_priv.h"
 #include "dix/callback_priv.h"
 #include "dix/cursor_priv.h"
 #include "dix/dix_priv.h"
@@ -152,7 +153,9 @@ dix_main(int argc, char *argv[], char *envp[])
 
         InitBlockAndWakeupHandlers();
         /* Perform any operating system dependent initializations you'd like */
+        BootPhaseBegin("os init");
         OsInit();
+        BootPhaseEnd();
 
             CreateWellKnownSockets();
             for (int i = 1; i < LimitClients; i++)
@@ -188,17 +191,25 @@ dix_main(int argc, char *argv[], char *envp[])
         InitEvents();
         xfont2_init_glyph_caching();
         dixResetRegistry();
+        BootPhaseBegin("font init");
         InitFonts();
+        BootPhaseEnd();
         InitCallbackManager();
+        BootPhaseBegin("output init");
         InitOutput(argc, argv);
+        BootPhaseEnd();
 
         if (screenInfo.numScreens < 1)
             FatalError("no screens found");
         LogMessageVerb(X_INFO, 1, "Output(s) initialized\n");
 
+        BootPhaseBegin("extension init");
         InitExtensions(argc, argv);
+        BootPhaseEnd();
         LogMessageVerb(X_INFO, 1, "Extensions initialized\n");
 
+        BootPhaseBegin("screen setup");
+
         DIX_FOR_EACH_GPU_SCREEN({
             if (!PixmapScreenInit(walkScreen))
                 FatalError("failed to create screen pixmap properties");
@@ -254,11 +265,14 @@ dix_main(int argc, char *argv[], char *envp[])
             CallCallbacks(&PostInitRootWindowCallback, walkScreen);
         });
 
+        BootPhaseEnd();
         LogMessageVerb(X_INFO, 1, "Screen(s) initialized\n");
 
+        BootPhaseBegin("input init");
         InitCoreDevices();
         InitInput(argc, argv);
         InitAndStartDevices();
+        BootPhaseEnd();
         LogMessageVerb(X_INFO, 1, "Input(s) initialized\n");
 
         ReserveClientIds(serverClient);
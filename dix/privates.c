@@ -148,8 +148,12 @@ dixReallocPrivates(PrivatePtr *privates, int old_offset, unsigned bytes)
 static Bool
 dixMovePrivates(PrivatePtr *privates, int new_offset, unsigned bytes)
 {
-    memmove((char *) *privates + bytes, *privates, new_offset - bytes);
-    memset(*privates, '\0', bytes);
+    /* the fixed slots below DIX_FIXED_PRIVATE_RESERVED stay put; only
+     * the keyed region above them shifts up */
+    memmove((char *) *privates + DIX_FIXED_PRIVATE_RESERVED + bytes,
+            (char *) *privates + DIX_FIXED_PRIVATE_RESERVED,
+            new_offset - DIX_FIXED_PRIVATE_RESERVED - bytes);
+    memset((char *) *privates + DIX_FIXED_PRIVATE_RESERVED, '\0', bytes);
     return TRUE;
 }
 
@@ -354,7 +358,7 @@ dixRegisterPrivateKey(DevPrivateKey key, DevPrivateType type, unsigned size)
 
         }
 
-        offset = 0;
+        offset = DIX_FIXED_PRIVATE_RESERVED;
     }
     else {
         /* Resize if we can, or make sure nothing's allocated if we can't */
@@ -748,7 +752,9 @@ dixResetPrivates(void)
             dixPrivateUsage();
         }
         global_keys[t].key = NULL;
-        global_keys[t].offset = 0;
+        /* keyed offsets start above the fixed private slots */
+        global_keys[t].offset = (t == PRIVATE_XSELINUX) ?
+            0 : DIX_FIXED_PRIVATE_RESERVED;
         global_keys[t].created = 0;
         global_keys[t].allocated = 0;
     }
@@ -97,21 +97,78 @@ int
 dixLookupProperty(PropertyPtr *result, WindowPtr pWin, Atom propertyName,
                   ClientPtr client, Mask access_mode)
 {
-    PropertyPtr pProp;
+    PropertyPtr pProp, prevProp = NULL;
     int rc = BadMatch;
 
     client->errorValue = propertyName;
 
-    for (pProp = pWin->properties; pProp; pProp = pProp->next)
+    for (pProp = pWin->properties; pProp; prevProp = pProp, pProp = pProp->next)
         if (pProp->propertyName == propertyName)
             break;
 
+    /* move the hit to the head of the list: clients tend to hammer the
+       same few properties (EWMH hints), so repeat lookups become O(1) */
+    if (pProp && prevProp) {
+        prevProp->next = pProp->next;
+        pProp->next = pWin->properties;
+        pWin->properties = pProp;
+    }
+
     if (pProp)
         rc = XaceHookPropertyAccess(client, pWin, &pProp, access_mode);
     *result = pProp;
     return rc;
 }
 
+/* Heap property payloads carry a reference count in a hidden header so
+ * GetProperty can splice them into a reply by reference (see the rpcbuf
+ * segment machinery) while a ChangeProperty/Delete that lands before the
+ * output flush stays safe: every mutation path swaps in a fresh buffer
+ * and drops the old reference, it never modifies a heap payload in
+ * place, so a pinned buffer simply outlives the property.
+ */
+typedef struct {
+    uint32_t refcnt;
+    uint32_t pad;               /* keep the payload 8-byte aligned */
+} PropDataHdr;
+
+#define PROP_DATA_HDR(data) (((PropDataHdr *) (data)) - 1)
+
+/* values at least this many bytes are sent by reference; below that a
+   plain copy through the rpcbuf is cheaper than iovec juggling */
+#define PROP_SENDREF_MIN 4096
+
+static void *
+propAllocData(size_t totalSize)
+{
+    PropDataHdr *hdr = calloc(1, sizeof(PropDataHdr) + totalSize);
+
+    if (!hdr)
+        return NULL;
+    hdr->refcnt = 1;
+    return hdr + 1;
+}
+
+/* WriteVecDoneProcPtr-compatible: also fired by the output layer once a
+   by-reference reply segment has left the server */
+static void
+propDataRelease(void *data)
+{
+    PropDataHdr *hdr = PROP_DATA_HDR(data);
+
+    if (--hdr->refcnt == 0)
+        free(hdr);
+}
+
+/* small values live in the PropertyRec itself (see propertyst.h); only
+   buffers that were actually heap-allocated are reference-counted */
+static inline void
+propFreeData(PropertyPtr pProp, void *data)
+{
+    if (data != pProp->inlineData)
+        propDataRelease(data);
+}
+
 static void
 setVRRMode(WindowPtr pWin, WindowVRRMode mode)
 {
@@ -158,6 +215,12 @@ static void
 deliverPropertyNotifyEvent(WindowPtr pWin, int state, PropertyPtr pProp)
 {
     xEvent event;
+
+    /* PropertyNotify never propagates, so if nobody selected for it on
+       this window there is no point building and filtering the event */
+    if (!((pWin->eventMask | wOtherEventMasks(pWin)) & PropertyChangeMask))
+        return;
+
     UpdateCurrentTimeIf();
     event = (xEvent) {
         .u.property.window = pWin->drawable.id,
@@ -253,7 +316,15 @@ ProcRotateProperties(ClientPtr client)
             props[j]->type = saved[i].type;
             props[j]->format = saved[i].format;
             props[j]->size = saved[i].size;
-            props[j]->data = saved[i].data;
+            if (saved[i].data == props[i]->inlineData) {
+                /* inline values cannot move by pointer; the bytes were
+                   snapshotted into saved[i] and always fit the target */
+                memcpy(props[j]->inlineData, saved[i].inlineData,
+                       (saved[i].format >> 3) * saved[i].size);
+                props[j]->data = props[j]->inlineData;
+            }
+            else
+                props[j]->data = saved[i].data;
         }
     }
  out:
@@ -367,7 +438,11 @@ dixChangeWindowProperty(ClientPtr pClient, WindowPtr pWin, Atom property,
         pProp = dixAllocateObjectWithPrivates(PropertyRec, PRIVATE_PROPERTY);
         if (!pProp)
             return BadAlloc;
-        unsigned char *data = calloc(1, totalSize);
+        unsigned char *data;
+        if (totalSize <= PROP_INLINE_MAX)
+            data = (unsigned char *) pProp->inlineData;
+        else
+            data = propAllocData(totalSize);
         if (totalSize) {
             if (!data) {
                 dixFreeObjectWithPrivates(pProp, PRIVATE_PROPERTY);
@@ -383,7 +458,7 @@ dixChangeWindowProperty(ClientPtr pClient, WindowPtr pWin, Atom property,
         rc = XaceHookPropertyAccess(pClient, pWin, &pProp,
                                     DixCreateAccess | DixWriteAccess);
         if (rc != Success) {
-            free(data);
+            propFreeData(pProp, data);
             dixFreeObjectWithPrivates(pProp, PRIVATE_PROPERTY);
             pClient->errorValue = property;
             return rc;
@@ -406,7 +481,11 @@ dixChangeWindowProperty(ClientPtr pClient, WindowPtr pWin, Atom property,
         savedProp = *pProp;
 
         if (mode == PropModeReplace) {
-            unsigned char *data = calloc(1, totalSize);
+            unsigned char *data;
+            if (totalSize <= PROP_INLINE_MAX)
+                data = (unsigned char *) pProp->inlineData;
+            else
+                data = propAllocData(totalSize);
             if (totalSize) {
                 if (!data)
                     return BadAlloc;
@@ -421,7 +500,8 @@ dixChangeWindowProperty(ClientPtr pClient, WindowPtr pWin, Atom property,
             /* do nothing */
         }
         else if (mode == PropModeAppend) {
-            unsigned char *data = calloc(pProp->size + len, sizeInBytes);
+            unsigned char *data =
+                propAllocData(((size_t) pProp->size + len) * sizeInBytes);
             if (!data)
                 return BadAlloc;
             memcpy(data, pProp->data, pProp->size * sizeInBytes);
@@ -430,7 +510,8 @@ dixChangeWindowProperty(ClientPtr pClient, WindowPtr pWin, Atom property,
             pProp->size += len;
         }
         else if (mode == PropModePrepend) {
-            unsigned char *data = calloc(len + pProp->size, sizeInBytes);
+            unsigned char *data =
+                propAllocData(((size_t) len + pProp->size) * sizeInBytes);
             if (!data)
                 return BadAlloc;
             memcpy(data + totalSize, pProp->data, pProp->size * sizeInBytes);
@@ -444,11 +525,11 @@ dixChangeWindowProperty(ClientPtr pClient, WindowPtr pWin, Atom property,
         rc = XaceHookPropertyAccess(pClient, pWin, &pProp, access_mode);
         if (rc == Success) {
             if (savedProp.data != pProp->data)
-                free(savedProp.data);
+                propFreeData(pProp, savedProp.data);
         }
         else {
             if (savedProp.data != pProp->data)
-                free(pProp->data);
+                propFreeData(pProp, pProp->data);
             *pProp = savedProp;
             return rc;
         }
@@ -490,7 +571,7 @@ DeleteProperty(ClientPtr client, WindowPtr pWin, Atom propName)
 
         deliverPropertyNotifyEvent(pWin, PropertyDelete, pProp);
         notifyVRRMode(client, pWin, PropertyDelete, pProp);
-        free(pProp->data);
+        propFreeData(pProp, pProp->data);
         dixFreeObjectWithPrivates(pProp, PRIVATE_PROPERTY);
     }
     return rc;
@@ -504,7 +585,7 @@ DeleteAllWindowProperties(WindowPtr pWin)
     while (pProp) {
         deliverPropertyNotifyEvent(pWin, PropertyDelete, pProp);
         PropertyPtr pNextProp = pProp->next;
-        free(pProp->data);
+        propFreeData(pProp, pProp->data);
         dixFreeObjectWithPrivates(pProp, PRIVATE_PROPERTY);
         pProp = pNextProp;
     }
@@ -632,10 +713,41 @@ ProcGetProperty(ClientPtr client)
         notifyVRRMode(client, pWin, PropertyDelete, pProp);
     }
 
-    const char *dataptr = ((char*)pProp->data) + ind;
+    char *dataptr = ((char*)pProp->data) + ind;
 
     x_rpcbuf_t rpcbuf = { .swapped = client->swapped, .err_clear = TRUE };
-    switch (pProp->format) {
+
+    if (p.delete && (reply.bytesAfter == 0) &&
+        (pProp->data != pProp->inlineData)) {
+        /* the property is deleted below anyway: steal its heap buffer
+           and send it by reference instead of copying it through the
+           rpcbuf -- selection transfers (clipboard, drag-and-drop) move
+           their payload exactly this way and can be many MB large.
+           byte-swapping may be done in place, the buffer is ours now. */
+        void *stolen = pProp->data;
+        pProp->data = pProp->inlineData;
+        pProp->size = 0;
+        if (client->swapped) {
+            if (pProp->format == 32)
+                SwapLongs((CARD32*)dataptr, len / 4);
+            else if (pProp->format == 16)
+                SwapShorts((short*)dataptr, len / 2);
+        }
+        x_rpcbuf_write_ref_pad(&rpcbuf, dataptr, len, propDataRelease, stolen);
+    }
+    else if (!client->swapped && len >= PROP_SENDREF_MIN &&
+             (pProp->data != pProp->inlineData)) {
+        /* large value for a same-endian client: pin the payload with an
+           extra reference and splice it into the reply instead of
+           copying it -- session managers poll multi-MB _NET state this
+           way on every query.  a ChangeProperty racing with the output
+           flush swaps in a new buffer, so the pinned one stays intact
+           until the done callback drops the reference. */
+        PROP_DATA_HDR(pProp->data)->refcnt++;
+        x_rpcbuf_write_ref_pad(&rpcbuf, dataptr, len, propDataRelease,
+                               pProp->data);
+    }
+    else switch (pProp->format) {
         case 32:
             x_rpcbuf_write_CARD32s(&rpcbuf, (CARD32*)dataptr, len / 4);
         break;
@@ -666,7 +778,7 @@ ProcGetProperty(ClientPtr client)
             prevProp->next = pProp->next;
         }
 
-        free(pProp->data);
+        propFreeData(pProp, pProp->data);
         dixFreeObjectWithPrivates(pProp, PRIVATE_PROPERTY);
     }
 
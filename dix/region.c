@@ -77,7 +77,11 @@ Equipment Corporation.
 
 #include <dix-config.h>
 
+#include "dix/cachestats_priv.h"
+#include "dix/dix_priv.h"
+
 #include "regionstr.h"
+#include "os.h"
 #include <X11/Xprotostr.h>
 #include <X11/Xfuncproto.h>
 #include "gc.h"
@@ -167,6 +171,122 @@ Equipment Corporation.
         ((r1)->y1 <= (r2)->y1) && \
         ((r1)->y2 >= (r2)->y2) )
 
+/* Pools for RegionRec headers and RegData rectangle arrays.  Region
+ * arithmetic creates and destroys regions at very high rates (XFixes
+ * region ops, temporary regions in exposure/validation and the damage
+ * layer), so both allocations are recycled instead of hitting the heap
+ * every time.  Region arithmetic only happens from the dispatch thread,
+ * so no locking is needed and one pool serves everyone.  RegionPoolTrim()
+ * releases excess entries at dispatch-cycle boundaries so input bursts
+ * don't pin memory for the rest of the session.
+ */
+#define REGION_HEADER_POOL_MAX  64
+#define REGION_HEADER_POOL_KEEP 16
+static RegionPtr regionHeaderPool;      /* chained through ->data */
+static int regionHeaderPoolCount;
+static CacheStatsRec regionHeaderStats;
+
+/* data block size classes in rectangles; blocks above the largest class
+   go straight back to the allocator */
+#define REGION_DATA_POOL_CLASSES 4
+#define REGION_DATA_POOL_MAX    32
+#define REGION_DATA_POOL_KEEP    8
+static const int regionDataPoolCaps[REGION_DATA_POOL_CLASSES] =
+    { 8, 32, 128, 512 };
+static RegDataPtr regionDataPool[REGION_DATA_POOL_CLASSES];
+static int regionDataPoolCount[REGION_DATA_POOL_CLASSES];
+static CacheStatsRec regionDataStats;
+
+/* pooled data blocks chain through their (unused) first box */
+#define regionDataNext(data) (*(RegDataPtr *) ((data) + 1))
+
+static RegDataPtr
+regionDataAlloc(int n)
+{
+    RegDataPtr data;
+    size_t rgnSize;
+
+    CacheStatsRegister(&regionDataStats, "region-data");
+
+    for (int c = 0; c < REGION_DATA_POOL_CLASSES; c++) {
+        if (n > regionDataPoolCaps[c])
+            continue;
+        if (regionDataPool[c]) {
+            data = regionDataPool[c];
+            regionDataPool[c] = regionDataNext(data);
+            regionDataPoolCount[c]--;
+            CacheStatsHit(&regionDataStats);
+            /* data->size still holds the block's real capacity */
+            return data;
+        }
+        /* round small requests up to the class so the block is
+           reusable for the whole class later */
+        n = regionDataPoolCaps[c];
+        break;
+    }
+
+    CacheStatsMiss(&regionDataStats);
+    rgnSize = RegionSizeof(n);
+    data = (rgnSize > 0) ? calloc(1, rgnSize) : NULL;
+    if (data)
+        data->size = n;
+    return data;
+}
+
+static void
+regionDataFree(RegDataPtr data)
+{
+    for (int c = REGION_DATA_POOL_CLASSES - 1; c >= 0; c--) {
+        if ((long) data->size < regionDataPoolCaps[c])
+            continue;
+        if (regionDataPoolCount[c] < REGION_DATA_POOL_MAX) {
+            regionDataNext(data) = regionDataPool[c];
+            regionDataPool[c] = data;
+            regionDataPoolCount[c]++;
+            return;
+        }
+        CacheStatsEvict(&regionDataStats);
+        break;
+    }
+    free(data);
+}
+
+void
+RegionPoolTrim(void)
+{
+    while (regionHeaderPoolCount > REGION_HEADER_POOL_KEEP) {
+        RegionPtr pReg = regionHeaderPool;
+
+        regionHeaderPool = (RegionPtr) pReg->data;
+        regionHeaderPoolCount--;
+        CacheStatsEvict(&regionHeaderStats);
+        free(pReg);
+    }
+    for (int c = 0; c < REGION_DATA_POOL_CLASSES; c++) {
+        while (regionDataPoolCount[c] > REGION_DATA_POOL_KEEP) {
+            RegDataPtr data = regionDataPool[c];
+
+            regionDataPool[c] = regionDataNext(data);
+            regionDataPoolCount[c]--;
+            CacheStatsEvict(&regionDataStats);
+            free(data);
+        }
+    }
+}
+
+void
+RegionPoolStatsDump(void)
+{
+    char occ[64];
+    int off = 0;
+
+    for (int c = 0; c < REGION_DATA_POOL_CLASSES; c++)
+        off += snprintf(occ + off, sizeof(occ) - off, " %d:%d",
+                        regionDataPoolCaps[c], regionDataPoolCount[c]);
+    LogMessage(X_INFO, "region pool occupancy: %d headers, data%s\n",
+               regionHeaderPoolCount, occ);
+}
+
 // note: we really need to check for size, because when it's zero, then data
 // might point to RegionBrokenData (.data segment), which we must not free()
 // (this also can create analyzer false alarms)
@@ -174,7 +294,7 @@ static inline void xfreeData(RegionPtr reg) {
     if (reg && reg->data && reg->data->size &&
         reg->data != &RegionBrokenData &&
         reg->data != &RegionEmptyData)
-            free(reg->data);
+            regionDataFree(reg->data);
 }
 
 #define RECTALLOC_BAIL(pReg,n,bail) \
@@ -235,16 +355,27 @@ InitRegions(void)
 
 /*****************************************************************
  *   RegionCreate(rect, size)
- *     This routine does a simple calloc to make a structure of
- *     REGION of "size" number of rectangles.
+ *     This routine makes a structure of REGION of "size" number
+ *     of rectangles, reusing a pooled header when one is available.
  *****************************************************************/
 
 RegionPtr
 RegionCreate(BoxPtr rect, int size)
 {
-    RegionPtr pReg = calloc(1, sizeof(RegionRec));
-    if (!pReg)
-        return &RegionBrokenRegion;
+    RegionPtr pReg = regionHeaderPool;
+
+    CacheStatsRegister(&regionHeaderStats, "region-header");
+
+    if (pReg) {
+        regionHeaderPool = (RegionPtr) pReg->data;
+        regionHeaderPoolCount--;
+        CacheStatsHit(&regionHeaderStats);
+    }
+    else {
+        CacheStatsMiss(&regionHeaderStats);
+        if (!(pReg = calloc(1, sizeof(RegionRec))))
+            return &RegionBrokenRegion;
+    }
 
     RegionInit(pReg, rect, size);
 
@@ -254,9 +385,24 @@ RegionCreate(BoxPtr rect, int size)
 void
 RegionDestroy(RegionPtr pReg)
 {
-    pixman_region_fini(pReg);
-    if (pReg != &RegionBrokenRegion)
+    if (pReg == &RegionBrokenRegion) {
+        pixman_region_fini(pReg);
+        return;
+    }
+
+    /* recycle the data block instead of letting pixman free() it */
+    xfreeData(pReg);
+    pReg->data = NULL;
+
+    if (regionHeaderPoolCount < REGION_HEADER_POOL_MAX) {
+        pReg->data = (RegDataPtr) regionHeaderPool;
+        regionHeaderPool = pReg;
+        regionHeaderPoolCount++;
+    }
+    else {
+        CacheStatsEvict(&regionHeaderStats);
         free(pReg);
+    }
 }
 
 RegionPtr
@@ -352,16 +498,14 @@ RegionRectAlloc(RegionPtr pRgn, int n)
 
     if (!pRgn->data) {
         n++;
-        rgnSize = RegionSizeof(n);
-        pRgn->data = (rgnSize > 0) ? calloc(1, rgnSize) : NULL;
+        pRgn->data = regionDataAlloc(n);
         if (!pRgn->data)
             return RegionBreak(pRgn);
         pRgn->data->numRects = 1;
         *RegionBoxptr(pRgn) = pRgn->extents;
     }
     else if (!pRgn->data->size) {
-        rgnSize = RegionSizeof(n);
-        pRgn->data = (rgnSize > 0) ? calloc(1, rgnSize) : NULL;
+        pRgn->data = regionDataAlloc(n);
         if (!pRgn->data)
             return RegionBreak(pRgn);
         pRgn->data->numRects = 0;
@@ -378,8 +522,8 @@ RegionRectAlloc(RegionPtr pRgn, int n)
         if (!data)
             return RegionBreak(pRgn);
         pRgn->data = data;
+        pRgn->data->size = n;
     }
-    pRgn->data->size = n;
     return TRUE;
 }
 
@@ -771,7 +915,8 @@ RegionOp(RegionPtr newReg,      /* Place to store result         */
         AppendRegions(newReg, r2BandEnd, r2End);
     }
 
-    free(oldData);
+    if (oldData && oldData->size)
+        regionDataFree(oldData);
 
     if (!(numRects = newReg->data->numRects)) {
         xfreeData(newReg);
@@ -1149,6 +1294,7 @@ RegionValidate(RegionPtr badreg, Bool *pOverlap)
     int numRects;               /* Original numRects for badreg         */
     int numRI;                  /* Number of entries used in ri         */
     int sizeRI;                 /* Number of entries available in ri    */
+    RegionInfo stackRI[4];      /* enough for almost every validation   */
     RegionInfo *rit;            /* &ri[j]                                */
     RegionPtr reg;              /* ri[j].reg                     */
     BoxPtr box;                 /* Current box in rects                 */
@@ -1187,9 +1333,7 @@ RegionValidate(RegionPtr badreg, Bool *pOverlap)
 
     /* Set up the first region to be the first rectangle in badreg */
     /* Note that step 2 code will never overflow the ri[0].reg rects array */
-    RegionInfo *ri = calloc(4, sizeof(RegionInfo));
-    if (!ri)
-        return RegionBreak(badreg);
+    RegionInfo *ri = stackRI;
     sizeRI = 4;
     numRI = 1;
     ri[0].prevBand = 0;
@@ -1249,7 +1393,14 @@ RegionValidate(RegionPtr badreg, Bool *pOverlap)
         if (sizeRI == numRI) {
             /* Oops, allocate space for new region information */
             sizeRI <<= 1;
-            rit = (RegionInfo *) reallocarray(ri, sizeRI, sizeof(RegionInfo));
+            if (ri == stackRI) {
+                rit = malloc(sizeRI * sizeof(RegionInfo));
+                if (rit)
+                    memcpy(rit, stackRI, numRI * sizeof(RegionInfo));
+            }
+            else
+                rit = (RegionInfo *) reallocarray(ri, sizeRI,
+                                                  sizeof(RegionInfo));
             if (!rit)
                 goto bail;
             ri = rit;
@@ -1304,13 +1455,15 @@ RegionValidate(RegionPtr badreg, Bool *pOverlap)
         numRI -= half;
     }
     *badreg = ri[0].reg;
-    free(ri);
+    if (ri != stackRI)
+        free(ri);
     good(badreg);
     return ret;
  bail:
     for (int i = 0; i < numRI; i++)
         xfreeData(&ri[i].reg);
-    free(ri);
+    if (ri != stackRI)
+        free(ri);
     return RegionBreak(badreg);
 }
 
@@ -1319,7 +1472,6 @@ RegionFromRects(int nrects, xRectangle *prect, int ctype)
 {
 
     RegionPtr pRgn;
-    size_t rgnSize;
     BoxPtr pBox;
     int x1, y1, x2, y2;
 
@@ -1344,8 +1496,7 @@ RegionFromRects(int nrects, xRectangle *prect, int ctype)
         }
         return pRgn;
     }
-    rgnSize = RegionSizeof(nrects);
-    RegDataPtr pData = (rgnSize > 0) ? calloc(1, rgnSize) : NULL;
+    RegDataPtr pData = regionDataAlloc(nrects);
     if (!pData) {
         RegionBreak(pRgn);
         return pRgn;
@@ -1367,7 +1518,7 @@ RegionFromRects(int nrects, xRectangle *prect, int ctype)
         }
     }
     if (pBox != (BoxPtr) (pData + 1)) {
-        pData->size = nrects;
+        /* pData->size was set by regionDataAlloc() */
         pData->numRects = pBox - (BoxPtr) (pData + 1);
         pRgn->data = pData;
         if (ctype != CT_YXBANDED) {
@@ -1381,7 +1532,7 @@ RegionFromRects(int nrects, xRectangle *prect, int ctype)
         good(pRgn);
     }
     else {
-        free(pData);
+        regionDataFree(pData);
     }
     return pRgn;
 }
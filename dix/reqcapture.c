@@ -0,0 +1,138 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * request stream capture for offline performance replay
+ *
+ * when the server is started with -requestcapture <file>, every request
+ * entering the dispatch loop is appended to the file together with a
+ * millisecond timestamp and the originating client slot, and client
+ * lifecycle records carry each client's resource id base/mask.  the
+ * resulting stream can be fed back through the dispatch path by the
+ * xreplay tool (test/xreplay.c) at original or maximum speed, which
+ * makes real WM/compositor workloads reproducible against candidate
+ * builds.  see reqcapture_priv.h for the file format.
+ */
+#include <dix-config.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dix/dix_priv.h"
+#include "dix/reqcapture_priv.h"
+#include "dix/resource_priv.h"
+
+#include "dixstruct.h"
+#include "os.h"
+
+const char *RequestCaptureFile;
+Bool RequestCaptureActive;
+
+static FILE *capFile;
+static CARD32 capStartMs;
+static Bool capCallbackInstalled;
+
+static void
+writeRecord(CARD16 clientIndex, CARD8 type, const void *payload, size_t len)
+{
+    xReqCapRecord rec = {
+        .delta_ms = GetTimeInMillis() - capStartMs,
+        .clientIndex = clientIndex,
+        .type = type,
+        .length = (CARD32) len,
+    };
+
+    if (fwrite(&rec, sizeof(rec), 1, capFile) != 1 ||
+        (len && fwrite(payload, len, 1, capFile) != 1)) {
+        ErrorF("request capture: write failed, stopping capture\n");
+        RequestCaptureFini();
+    }
+}
+
+static void
+captureClientCallback(CallbackListPtr *pcbl, void *closure, void *calldata)
+{
+    NewClientInfoRec *clientinfo = calldata;
+    ClientPtr client = clientinfo->client;
+
+    if (!RequestCaptureActive || client == serverClient)
+        return;
+
+    switch (client->clientState) {
+    case ClientStateRunning:
+    {
+        xReqCapClientInfo info = {
+            .ridBase = client->clientAsMask,
+            .ridMask = RESOURCE_ID_MASK,
+            .swapped = client->swapped,
+        };
+        writeRecord(client->index, XREQCAP_REC_CLIENT_RUN,
+                    &info, sizeof(info));
+        break;
+    }
+    case ClientStateGone:
+    case ClientStateRetained:
+        writeRecord(client->index, XREQCAP_REC_CLIENT_GONE, NULL, 0);
+        break;
+    default:
+        return;
+    }
+
+    /* lifecycle records are rare; keep the file current so a capture
+       survives a server crash */
+    fflush(capFile);
+}
+
+void
+RequestCaptureInit(void)
+{
+    if ((!RequestCaptureFile) || capFile)
+        return;
+
+    capFile = fopen(RequestCaptureFile, "wb");
+    if (!capFile) {
+        ErrorF("request capture: can't open %s\n", RequestCaptureFile);
+        return;
+    }
+
+    capStartMs = GetTimeInMillis();
+
+    xReqCapHeader hdr = {
+        .version = XREQCAP_VERSION,
+        .start_ms = capStartMs,
+    };
+    memcpy(hdr.magic, XREQCAP_MAGIC, sizeof(hdr.magic));
+
+    if (fwrite(&hdr, sizeof(hdr), 1, capFile) != 1) {
+        ErrorF("request capture: can't write %s\n", RequestCaptureFile);
+        fclose(capFile);
+        capFile = NULL;
+        return;
+    }
+
+    if (!capCallbackInstalled)
+        capCallbackInstalled =
+            AddCallback(&ClientStateCallback, captureClientCallback, NULL);
+
+    RequestCaptureActive = TRUE;
+    LogMessage(X_INFO, "capturing request stream to %s\n",
+               RequestCaptureFile);
+}
+
+void
+RequestCaptureRequest(ClientPtr client, const void *buf, size_t len)
+{
+    if (!RequestCaptureActive)
+        return;
+
+    writeRecord(client->index, XREQCAP_REC_REQUEST, buf, len);
+}
+
+void
+RequestCaptureFini(void)
+{
+    RequestCaptureActive = FALSE;
+
+    if (capFile) {
+        fclose(capFile);
+        capFile = NULL;
+    }
+}
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * request stream capture for offline performance replay
+ */
+#ifndef _XSERVER_DIX_REQCAPTURE_PRIV_H
+#define _XSERVER_DIX_REQCAPTURE_PRIV_H
+
+#include <stddef.h>
+#include <X11/Xmd.h>
+
+#include "include/dix.h"
+
+/*
+ * capture file format (host endian):
+ *
+ * the file starts with one xReqCapHeader, followed by a stream of
+ * xReqCapRecord entries, each followed by `length` payload bytes.
+ * record types:
+ *
+ *   XREQCAP_REC_REQUEST      raw request bytes, exactly as read from
+ *                            the client (body unswapped)
+ *   XREQCAP_REC_CLIENT_RUN   client entered the running state; payload
+ *                            is one xReqCapClientInfo, carrying the
+ *                            resource id base/mask so a replay driver
+ *                            can translate XIDs onto its own id range
+ *   XREQCAP_REC_CLIENT_GONE  client disconnected, no payload
+ *
+ * timestamps are milliseconds since the start_ms in the file header,
+ * taken from GetTimeInMillis(), so a replay driver can reproduce the
+ * original pacing.
+ */
+
+#define XREQCAP_MAGIC    "XREQCAP1"
+#define XREQCAP_VERSION  1
+
+#define XREQCAP_REC_REQUEST      0
+#define XREQCAP_REC_CLIENT_RUN   1
+#define XREQCAP_REC_CLIENT_GONE  2
+
+typedef struct {
+    char magic[8];              /* XREQCAP_MAGIC, not 0-terminated */
+    CARD32 version;             /* XREQCAP_VERSION */
+    CARD32 pad;
+    CARD32 start_ms;            /* GetTimeInMillis() at capture start */
+    CARD32 pad2;
+} xReqCapHeader;
+
+typedef struct {
+    CARD32 delta_ms;            /* milliseconds since header start_ms */
+    CARD16 clientIndex;
+    CARD8 type;                 /* XREQCAP_REC_* */
+    CARD8 pad;
+    CARD32 length;              /* payload bytes following this record */
+} xReqCapRecord;
+
+typedef struct {
+    CARD32 ridBase;             /* client's resource id base */
+    CARD32 ridMask;             /* client's resource id mask */
+    CARD8 swapped;              /* client runs with swapped byte order */
+    CARD8 pad[3];
+} xReqCapClientInfo;
+
+/* capture file name (from the -requestcapture command line option),
+   NULL when capture is disabled */
+extern const char *RequestCaptureFile;
+
+/* TRUE while a capture file is open; cheap guard for the dispatch loop */
+extern Bool RequestCaptureActive;
+
+/* open the capture file and hook client lifecycle tracking;
+   no-op unless RequestCaptureFile is set */
+void RequestCaptureInit(void);
+
+/* append one raw request to the capture stream */
+void RequestCaptureRequest(ClientPtr client, const void *buf, size_t len);
+
+/* flush and close the capture file */
+void RequestCaptureFini(void);
+
+#endif /* _XSERVER_DIX_REQCAPTURE_PRIV_H */
@@ -0,0 +1,186 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * per-opcode request profiling for the dispatch loop
+ *
+ * with -requestprofile the dispatch loop wraps every request in a
+ * monotonic clock delta and accounts it under its major (and, for
+ * extension requests, minor) opcode: call count, accumulated time and
+ * worst-case latency.  sending the server SIGUSR2 dumps the table to
+ * the log sorted by accumulated time and resets it, so a production
+ * server can be asked "what dominates dispatch right now" without
+ * attaching perf.  when the option is absent the only cost is one
+ * predictable branch per request.
+ */
+#include <dix-config.h>
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dix/cachestats_priv.h"
+#include "dix/dix_priv.h"
+#include "dix/inputlatency_priv.h"
+#include "dix/registry_priv.h"
+#include "dix/reqprof_priv.h"
+#include "os/osdep.h"
+
+#include "misc.h"
+#include "os.h"
+
+Bool RequestProfileActive;
+
+/* modules with their own statistics (damage heatmap, ...) hook the
+   SIGUSR2 dump here; called with NULL calldata */
+CallbackListPtr StatsDumpCallback;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} ReqProfEntry;
+
+#define REQPROF_MAJORS  256
+#define REQPROF_MINORS  256
+
+static ReqProfEntry majors[REQPROF_MAJORS];
+/* minor breakdown, allocated lazily per extension major */
+static ReqProfEntry *minors[REQPROF_MAJORS];
+static uint64_t profStartNs;
+
+static volatile sig_atomic_t dumpRequested;
+
+static void
+sigusr2Handler(int sig)
+{
+    dumpRequested = 1;
+}
+
+void
+RequestProfileInit(void)
+{
+    /* SIGUSR2 also dumps the cache effectiveness counters, so the
+       trigger is installed whether or not profiling is enabled */
+    OsSignal(SIGUSR2, sigusr2Handler);
+
+    if (!RequestProfileActive)
+        return;
+
+    profStartNs = RequestProfileNow();
+    LogMessage(X_INFO,
+               "request profiling enabled, dump with SIGUSR2\n");
+}
+
+static void
+accountEntry(ReqProfEntry *entry, uint64_t delta)
+{
+    entry->calls++;
+    entry->total_ns += delta;
+    if (delta > entry->max_ns)
+        entry->max_ns = delta;
+}
+
+void
+RequestProfileRecord(int major, int minor, uint64_t start_ns)
+{
+    uint64_t delta = RequestProfileNow() - start_ns;
+
+    major &= REQPROF_MAJORS - 1;
+    accountEntry(&majors[major], delta);
+
+    if (major >= EXTENSION_BASE) {
+        if (!minors[major])
+            minors[major] = calloc(REQPROF_MINORS, sizeof(ReqProfEntry));
+        if (minors[major])
+            accountEntry(&minors[major][minor & (REQPROF_MINORS - 1)], delta);
+    }
+}
+
+typedef struct {
+    int major;
+    int minor;                  /* -1 for core requests */
+    const ReqProfEntry *entry;
+} ReqProfRow;
+
+static int
+compareRows(const void *a, const void *b)
+{
+    const ReqProfRow *ra = a, *rb = b;
+
+    if (ra->entry->total_ns == rb->entry->total_ns)
+        return 0;
+    return (ra->entry->total_ns < rb->entry->total_ns) ? 1 : -1;
+}
+
+void
+RequestProfileDump(void)
+{
+    ReqProfRow rows[REQPROF_MAJORS + REQPROF_MAJORS];
+    int nrows = 0;
+
+    for (int major = 0; major < REQPROF_MAJORS; major++) {
+        if (!majors[major].calls)
+            continue;
+        if (minors[major]) {
+            /* report extension requests per minor opcode */
+            for (int minor = 0; minor < REQPROF_MINORS; minor++) {
+                if (!minors[major][minor].calls)
+                    continue;
+                if (nrows < (int) ARRAY_SIZE(rows))
+                    rows[nrows++] = (ReqProfRow) {
+                        major, minor, &minors[major][minor] };
+            }
+        }
+        else if (nrows < (int) ARRAY_SIZE(rows)) {
+            rows[nrows++] = (ReqProfRow) { major, -1, &majors[major] };
+        }
+    }
+
+    qsort(rows, nrows, sizeof(rows[0]), compareRows);
+
+    uint64_t elapsed = RequestProfileNow() - profStartNs;
+
+    LogMessage(X_INFO, "request profile over %lu ms:\n",
+               (unsigned long) (elapsed / 1000000));
+    LogMessage(X_NONE,
+               "  %-40s %12s %12s %10s %10s\n",
+               "request", "calls", "total-us", "avg-us", "max-us");
+
+    for (int i = 0; i < nrows; i++) {
+        const ReqProfEntry *entry = rows[i].entry;
+        const char *name = (rows[i].minor < 0)
+            ? LookupMajorName(rows[i].major)
+            : LookupRequestName(rows[i].major, rows[i].minor);
+
+        LogMessage(X_NONE,
+                   "  %-40s %12lu %12lu %10lu %10lu\n",
+                   name ? name : "?",
+                   (unsigned long) entry->calls,
+                   (unsigned long) (entry->total_ns / 1000),
+                   (unsigned long) (entry->total_ns / entry->calls / 1000),
+                   (unsigned long) (entry->max_ns / 1000));
+    }
+
+    /* start a fresh measurement window */
+    memset(majors, 0, sizeof(majors));
+    for (int major = 0; major < REQPROF_MAJORS; major++)
+        if (minors[major])
+            memset(minors[major], 0,
+                   REQPROF_MINORS * sizeof(ReqProfEntry));
+    profStartNs = RequestProfileNow();
+}
+
+void
+RequestProfileCheckDump(void)
+{
+    if (!dumpRequested)
+        return;
+
+    dumpRequested = 0;
+    if (RequestProfileActive)
+        RequestProfileDump();
+    CacheStatsDump();
+    RegionPoolStatsDump();
+    DispatchStatsDump();
+    InputLatencyDump();
+    CallCallbacks(&StatsDumpCallback, NULL);
+}
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * per-opcode request profiling for the dispatch loop
+ */
+#ifndef _XSERVER_DIX_REQPROF_PRIV_H
+#define _XSERVER_DIX_REQPROF_PRIV_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include "include/dix.h"
+
+/* TRUE while profiling is enabled (the -requestprofile command line
+   option); the dispatch loop checks nothing else when it is FALSE */
+extern Bool RequestProfileActive;
+
+/* SIGUSR2 statistics dump hook for modules with their own counters;
+   called with NULL calldata after the built-in dumps */
+extern CallbackListPtr StatsDumpCallback;
+
+/* install the SIGUSR2 dump trigger (shared with the cache stats dump) */
+void RequestProfileInit(void);
+
+/* account one dispatched request under its major/minor opcode */
+void RequestProfileRecord(int major, int minor, uint64_t start_ns);
+
+/* dump the profile table and cache stats to the log if SIGUSR2 arrived
+   since the last check; called once per dispatch round */
+void RequestProfileCheckDump(void);
+
+/* dump unconditionally and reset the table */
+void RequestProfileDump(void);
+
+static inline uint64_t RequestProfileNow(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+#endif /* _XSERVER_DIX_REQPROF_PRIV_H */
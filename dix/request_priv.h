@@ -24,9 +24,32 @@ static inline ssize_t WriteRpcbufToClient(ClientPtr pClient,
                                           x_rpcbuf_t *rpcbuf) {
     /* explicitly casting between (s)size_t and int - should be safe,
        since payloads are always small enough to easily fit into int. */
-    ssize_t ret = WriteToClient(pClient,
-                                (int)rpcbuf->wpos,
-                                rpcbuf->buffer);
+    ssize_t ret = 0;
+    size_t sent = 0;
+
+    /* interleave owned byte ranges with referenced segments: the owned
+       bytes go through the copying path, the segments are queued by
+       reference and flushed via writev() -- see WriteToClientVec() */
+    x_rpcbuf_seg_t *seg = rpcbuf->segs;
+    while (seg) {
+        x_rpcbuf_seg_t *next = seg->next;
+        if (seg->at > sent)
+            WriteToClient(pClient, (int)(seg->at - sent),
+                          rpcbuf->buffer + sent);
+        sent = seg->at;
+        ret = WriteToClientVec(pClient, (int)seg->len, seg->data,
+                               seg->done, seg->closure);
+        free(seg);
+        seg = next;
+    }
+    /* payload ownership moved to the output layer, don't fire `done`
+       again from x_rpcbuf_clear() */
+    rpcbuf->segs = rpcbuf->segs_tail = NULL;
+    rpcbuf->seg_bytes = 0;
+
+    if (rpcbuf->wpos > sent)
+        ret = WriteToClient(pClient, (int)(rpcbuf->wpos - sent),
+                            rpcbuf->buffer + sent);
     x_rpcbuf_clear(rpcbuf);
     return ret;
 }
@@ -43,8 +66,10 @@ static inline ssize_t WriteRpcbufToClient(ClientPtr pClient,
 static inline int __write_reply_hdr_and_rpcbuf(
     ClientPtr pClient, void *hdrData, size_t hdrLen, x_rpcbuf_t *rpcbuf)
 {
-    if (rpcbuf->error)
+    if (rpcbuf->error) {
+        x_rpcbuf_clear(rpcbuf); /* releases any queued segments */
         return BadAlloc;
+    }
 
     xGenericReply *reply = hdrData;
     reply->type = X_Reply;
@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * per-client resource memory accounting
+ *
+ * hooks the resource state callback to keep a live per-client byte
+ * estimate, using the same size functions the XRes extension queries
+ * on demand (pixmap data dominates, so the estimate tracks real usage
+ * closely).  when a client crosses the -clientmemwarn threshold a
+ * warning naming the client lands in the log, so a ballooning server
+ * can be attributed to its leaky client before the OOM killer hits.
+ */
+#include <dix-config.h>
+
+#include "dix/dix_priv.h"
+#include "dix/resacct_priv.h"
+#include "dix/resource_priv.h"
+#include "os/client_priv.h"
+
+#include "dixstruct.h"
+#include "os.h"
+
+/* warn at 1 GB by default; memory this size in one client is almost
+   always a leak rather than a working set */
+long ResourceAccountWarnMB = 1024;
+
+static void
+warnIfOverThreshold(ClientPtr owner)
+{
+    if (ResourceAccountWarnMB <= 0)
+        return;
+
+    unsigned long threshold = (unsigned long) ResourceAccountWarnMB << 20;
+
+    if (!owner->resourceBytesWarned && owner->resourceBytes > threshold) {
+        const char *cmd = GetClientCmdName(owner);
+
+        owner->resourceBytesWarned = TRUE;
+        LogMessage(X_WARNING,
+                   "client %d (%s, pid %d) holds an estimated %lu MB of "
+                   "resource memory\n",
+                   owner->index, cmd ? cmd : "unknown",
+                   (int) GetClientPid(owner),
+                   owner->resourceBytes >> 20);
+    }
+    else if (owner->resourceBytesWarned &&
+             owner->resourceBytes < threshold / 2) {
+        /* re-arm once the client has given most of it back */
+        owner->resourceBytesWarned = FALSE;
+    }
+}
+
+static void
+accountResourceState(CallbackListPtr *pcbl, void *closure, void *calldata)
+{
+    ResourceStateInfoRec *rsi = calldata;
+    int cid = dixClientIdForXID(rsi->id);
+    ClientPtr owner;
+
+    if (cid >= currentMaxClients || !(owner = clients[cid]))
+        return;
+
+    SizeType sizeFunc = GetResourceTypeSizeFunc(rsi->type & TypeMask);
+    ResourceSizeRec size = { 0, 0, 0 };
+
+    sizeFunc(rsi->value, rsi->id, &size);
+
+    switch (rsi->state) {
+    case ResourceStateAdding:
+        owner->resourceBytes += size.resourceSize;
+        warnIfOverThreshold(owner);
+        break;
+    case ResourceStateFreeing:
+        if (size.resourceSize < owner->resourceBytes)
+            owner->resourceBytes -= size.resourceSize;
+        else
+            owner->resourceBytes = 0;
+        warnIfOverThreshold(owner);
+        break;
+    default:
+        break;
+    }
+}
+
+void
+ResourceAccountInit(void)
+{
+    if (!AddCallback(&ResourceStateCallback, accountResourceState, NULL))
+        ErrorF("[dix] can't register resource accounting callback\n");
+}
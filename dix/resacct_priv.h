@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * per-client resource memory accounting
+ */
+#ifndef _XSERVER_DIX_RESACCT_PRIV_H
+#define _XSERVER_DIX_RESACCT_PRIV_H
+
+#include "include/dix.h"
+
+/* log a warning when a client's estimated resource memory crosses this
+   many megabytes (the -clientmemwarn command line option); 0 disables
+   the warning but the per-client counters stay maintained */
+extern long ResourceAccountWarnMB;
+
+/* hook resource creation/destruction for accounting; registered once
+   per server generation from the dispatch loop */
+void ResourceAccountInit(void);
+
+#endif /* _XSERVER_DIX_RESACCT_PRIV_H */
@@ -145,6 +145,7 @@ Equipment Corporation.
 #include "cursor.h"
 #include "xace.h"
 #include <assert.h>
+#include <stdlib.h>
 #include "gcstruct.h"
 
 #ifdef XSERVER_DTRACE
@@ -159,22 +160,40 @@ static void RebuildTable(int    /*client */
 
 #define INITBUCKETS 64
 #define INITHASHSIZE 6
-#define MAXHASHSIZE 16
+
+/* seq values below SEQ_LIVEBASE mark slots that hold no resource;
+ * SEQ_DELETED keeps linear probe runs intact across deletions */
+#define SEQ_EMPTY    0
+#define SEQ_DELETED  1
+#define SEQ_LIVEBASE 2
+
+#define ResourceSlotLive(res) ((res)->seq >= SEQ_LIVEBASE)
 
 typedef struct _Resource {
-    struct _Resource *next;
     XID id;
     RESTYPE type;
     void *value;
+    CARD64 seq;                 /* slot state + per-client insertion counter */
 } ResourceRec, *ResourcePtr;
 
+/* Open-addressing hash table of one client's resources.  Entries are
+ * stored flat and probed linearly from HashResourceID(), so a lookup
+ * touches a couple of adjacent cache lines instead of chasing list
+ * pointers.  seq doubles as the slot state and as an insertion counter,
+ * which FreeClientResources uses to tear resources down in the opposite
+ * order they were added.
+ */
 typedef struct _ClientResource {
-    ResourcePtr *resources;
-    int elements;
+    ResourcePtr slots;
+    int elements;               /* live entries */
+    int occupied;               /* live entries plus deleted slots */
     int buckets;
     int hashsize;               /* log(2)(buckets) */
+    CARD64 nextSeq;
     XID fakeID;
     XID endFakeID;
+    int *typeCounts;            /* live entries per type, see typeCounts helpers */
+    int numTypeCounts;
 } ClientResourceRec;
 
 RESTYPE lastResourceType;
@@ -655,13 +674,15 @@ InitClientResources(ClientPtr client)
             return FALSE;
         memcpy(resourceTypes, predefTypes, sizeof(predefTypes));
     }
-    clientTable[i = client->index].resources =
-        calloc(INITBUCKETS, sizeof(ResourcePtr));
-    if (!clientTable[i].resources)
+    clientTable[i = client->index].slots =
+        calloc(INITBUCKETS, sizeof(ResourceRec));
+    if (!clientTable[i].slots)
         return FALSE;
     clientTable[i].buckets = INITBUCKETS;
     clientTable[i].elements = 0;
+    clientTable[i].occupied = 0;
     clientTable[i].hashsize = INITHASHSIZE;
+    clientTable[i].nextSeq = SEQ_LIVEBASE;
     /* Many IDs allocated from the server client are visible to clients,
      * so we don't use the SERVER_BIT for them, but we have to start
      * past the magic value constants used in the protocol.  For normal
@@ -670,9 +691,6 @@ InitClientResources(ClientPtr client)
     clientTable[i].fakeID = client->clientAsMask |
         (client->index ? SERVER_BIT : SERVER_MINID);
     clientTable[i].endFakeID = (clientTable[i].fakeID | RESOURCE_ID_MASK) + 1;
-    for (int j = 0; j < INITBUCKETS; j++) {
-        clientTable[i].resources[j] = NULL;
-    }
     return TRUE;
 }
 
@@ -689,18 +707,30 @@ HashResourceID(XID id, unsigned int numBits)
     return (id ^ (id >> numBits)) & ~((~0U) << numBits);
 }
 
+static Bool
+ResourceIDInUse(ClientResourceRec *rrec, XID id)
+{
+    int mask = rrec->buckets - 1;
+    int i = HashResourceID(id, rrec->hashsize);
+
+    for (int probes = rrec->buckets; probes > 0; probes--, i = (i + 1) & mask) {
+        ResourcePtr res = &rrec->slots[i];
+
+        if (res->seq == SEQ_EMPTY)
+            break;
+        if (ResourceSlotLive(res) && res->id == id)
+            return TRUE;
+    }
+    return FALSE;
+}
+
 static XID
 AvailableID(int client, XID id, XID maxid, XID goodid)
 {
-    ResourcePtr res;
-
     if ((goodid >= id) && (goodid <= maxid))
         return goodid;
     for (; id <= maxid; id++) {
-        res = clientTable[client].resources[HashResourceID(id, clientTable[client].hashsize)];
-        while (res && (res->id != id))
-            res = res->next;
-        if (!res)
+        if (!ResourceIDInUse(&clientTable[client], id))
             return id;
     }
     return 0;
@@ -717,18 +747,18 @@ GetXIDRange(int client, Bool server, XID *minp, XID *maxp)
         id |= client ? SERVER_BIT : SERVER_MINID;
     maxid = id | RESOURCE_ID_MASK;
     goodid = 0;
-    ResourcePtr *resp = clientTable[client].resources;
-    for (int i = clientTable[client].buckets; --i >= 0;) {
-        for (ResourcePtr res = *resp++; res; res = res->next) {
-            if ((res->id < id) || (res->id > maxid))
-                continue;
-            if (((res->id - id) >= (maxid - res->id)) ?
-                (goodid = AvailableID(client, id, res->id - 1, goodid)) :
-                !(goodid = AvailableID(client, res->id + 1, maxid, goodid)))
-                maxid = res->id - 1;
-            else
-                id = res->id + 1;
-        }
+    ResourcePtr res = clientTable[client].slots;
+    for (int i = clientTable[client].buckets; --i >= 0; res++) {
+        if (!ResourceSlotLive(res))
+            continue;
+        if ((res->id < id) || (res->id > maxid))
+            continue;
+        if (((res->id - id) >= (maxid - res->id)) ?
+            (goodid = AvailableID(client, id, res->id - 1, goodid)) :
+            !(goodid = AvailableID(client, res->id + 1, maxid, goodid)))
+            maxid = res->id - 1;
+        else
+            id = res->id + 1;
     }
     if (id > maxid)
         id = maxid = 0;
@@ -811,12 +841,57 @@ FakeClientID(int client)
     return id;
 }
 
+/* Per-type live counters, kept in step with rrec->elements so the XRes
+ * QueryClientResources handler can read its answer directly instead of
+ * walking the whole table.  The array is indexed by (type & TypeMask) - 1
+ * and grown on demand, since extensions keep registering resource types
+ * well after the first clients have connected.
+ */
+static void
+ResourceTypeCountIncr(ClientResourceRec *rrec, RESTYPE type)
+{
+    int idx = (int) (type & TypeMask) - 1;
+
+    if (idx < 0)
+        return;
+    if (idx >= rrec->numTypeCounts) {
+        int num = (int) lastResourceType;
+
+        if (num <= idx)
+            num = idx + 1;
+        rrec->typeCounts = XNFreallocarray(rrec->typeCounts, num, sizeof(int));
+        memset(rrec->typeCounts + rrec->numTypeCounts, 0,
+               (num - rrec->numTypeCounts) * sizeof(int));
+        rrec->numTypeCounts = num;
+    }
+    rrec->typeCounts[idx]++;
+}
+
+static void
+ResourceTypeCountDecr(ClientResourceRec *rrec, RESTYPE type)
+{
+    int idx = (int) (type & TypeMask) - 1;
+
+    if (idx >= 0 && idx < rrec->numTypeCounts && rrec->typeCounts[idx] > 0)
+        rrec->typeCounts[idx]--;
+}
+
+const int *
+dixClientResourceTypeCounts(ClientPtr client, int *numTypes)
+{
+    ClientResourceRec *rrec = &clientTable[client->index];
+
+    *numTypes = rrec->numTypeCounts;
+    return rrec->typeCounts;
+}
+
 Bool
 AddResource(XID id, RESTYPE type, void *value)
 {
     int client;
     ClientResourceRec *rrec;
-    ResourcePtr *head;
+    ResourcePtr res;
+    int mask, i;
 
 #ifdef XSERVER_DTRACE
     XSERVER_RESOURCE_ALLOC(id, type, value, TypeNameString(type));
@@ -828,20 +903,28 @@ AddResource(XID id, RESTYPE type, void *value)
                (unsigned long) id, type, (unsigned long) value, client);
         FatalError("client not in use\n");
     }
-    if ((rrec->elements >= 4 * rrec->buckets) && (rrec->hashsize < MAXHASHSIZE))
+    if (4 * rrec->occupied >= 3 * rrec->buckets)
         RebuildTable(client);
-    head = &rrec->resources[HashResourceID(id, clientTable[client].hashsize)];
-    ResourcePtr res = calloc(1, sizeof(ResourceRec));
-    if (!res) {
+    if (rrec->occupied == rrec->buckets) {
+        /* the rebuild failed and every slot is taken */
         (*resourceTypes[type & TypeMask].deleteFunc) (value, id);
         return FALSE;
     }
-    res->next = *head;
+    /* duplicate ids with different types are allowed, so just take the
+     * first free slot on the probe path */
+    mask = rrec->buckets - 1;
+    i = HashResourceID(id, rrec->hashsize);
+    while (ResourceSlotLive(&rrec->slots[i]))
+        i = (i + 1) & mask;
+    res = &rrec->slots[i];
+    if (res->seq == SEQ_EMPTY)
+        rrec->occupied++;
     res->id = id;
     res->type = type;
     res->value = value;
-    *head = res;
+    res->seq = rrec->nextSeq++;
     rrec->elements++;
+    ResourceTypeCountIncr(rrec, type);
     CallResourceStateCallback(ResourceStateAdding, res);
     return TRUE;
 }
@@ -849,87 +932,94 @@ AddResource(XID id, RESTYPE type, void *value)
 static void
 RebuildTable(int client)
 {
-    int j;
-    ResourcePtr **tails, *resources;
+    ClientResourceRec *rrec = &clientTable[client];
+    int hashsize = rrec->hashsize;
+    int buckets;
+    ResourcePtr slots;
 
     /*
-     * For now, preserve insertion order, since some ddx layers depend
-     * on resources being free in the opposite order they are added.
+     * Grow when the live load is high; otherwise rehash at the same size
+     * just to flush out the deleted slots that linear probing leaves
+     * behind.  Insertion order survives either way in the seq counters,
+     * since some ddx layers depend on resources being freed in the
+     * opposite order they are added.
      */
-
-    j = 2 * clientTable[client].buckets;
-    tails =  calloc(j, sizeof(ResourcePtr *));
-    if (!tails)
+    if (2 * rrec->elements >= rrec->buckets)
+        hashsize++;
+    buckets = 1 << hashsize;
+    slots = calloc(buckets, sizeof(ResourceRec));
+    if (!slots)
         return;
-    resources =  calloc(j, sizeof(ResourcePtr));
-    if (!resources) {
-        free(tails);
-        return;
-    }
-    for (ResourcePtr *rptr = resources, **tptr = tails; --j >= 0; rptr++, tptr++) {
-        *rptr = NULL;
-        *tptr = rptr;
+    for (int j = 0; j < rrec->buckets; j++) {
+        ResourcePtr res = &rrec->slots[j];
+        int mask = buckets - 1;
+        int i;
+
+        if (!ResourceSlotLive(res))
+            continue;
+        i = HashResourceID(res->id, hashsize);
+        while (slots[i].seq != SEQ_EMPTY)
+            i = (i + 1) & mask;
+        slots[i] = *res;
     }
-    clientTable[client].hashsize++;
-    j = clientTable[client].buckets;
-    for (ResourcePtr *rptr = clientTable[client].resources, **tptr; --j >= 0; rptr++) {
-        for (ResourcePtr res = *rptr, next; res; res = next) {
-            next = res->next;
-            res->next = NULL;
-            tptr = &tails[HashResourceID(res->id, clientTable[client].hashsize)];
-            **tptr = res;
-            *tptr = &res->next;
-        }
-    }
-    free(tails);
-    clientTable[client].buckets *= 2;
-    free(clientTable[client].resources);
-    clientTable[client].resources = resources;
+    free(rrec->slots);
+    rrec->slots = slots;
+    rrec->buckets = buckets;
+    rrec->hashsize = hashsize;
+    rrec->occupied = rrec->elements;
 }
 
 static void
 doFreeResource(ResourcePtr res, Bool skip)
 {
+    dixLookupCacheGeneration++;
+
     CallResourceStateCallback(ResourceStateFreeing, res);
 
     if (!skip)
         resourceTypes[res->type & TypeMask].deleteFunc(res->value, res->id);
-
-    free(res);
 }
 
 void
 FreeResource(XID id, RESTYPE skipDeleteFuncType)
 {
     int cid;
-    ResourcePtr res;
-    ResourcePtr *prev, *head;
-    int *eltptr;
-    int elements;
 
     if (((cid = dixClientIdForXID(id)) < LimitClients) && clientTable[cid].buckets) {
-        head = &clientTable[cid].resources[HashResourceID(id, clientTable[cid].hashsize)];
-        eltptr = &clientTable[cid].elements;
+        ClientResourceRec *rrec = &clientTable[cid];
+        Bool again = TRUE;
+
+        /* a delete func may add or free other entries and thereby rehash
+           the table, so restart the probe from scratch after each hit */
+        while (again) {
+            int mask = rrec->buckets - 1;
+            int i = HashResourceID(id, rrec->hashsize);
 
-        prev = head;
-        while ((res = *prev)) {
-            if (res->id == id) {
-                RESTYPE rtype = res->type;
+            again = FALSE;
+            for (int probes = rrec->buckets; probes > 0;
+                 probes--, i = (i + 1) & mask) {
+                ResourcePtr res = &rrec->slots[i];
+
+                if (res->seq == SEQ_EMPTY)
+                    break;
+                if (!ResourceSlotLive(res) || res->id != id)
+                    continue;
+
+                ResourceRec entry = *res;
 
 #ifdef XSERVER_DTRACE
-                XSERVER_RESOURCE_FREE(res->id, res->type,
-                                      res->value, TypeNameString(res->type));
+                XSERVER_RESOURCE_FREE(entry.id, entry.type,
+                                      entry.value, TypeNameString(entry.type));
 #endif
-                *prev = res->next;
-                elements = --*eltptr;
+                res->seq = SEQ_DELETED;
+                rrec->elements--;
+                ResourceTypeCountDecr(rrec, entry.type);
 
-                doFreeResource(res, rtype == skipDeleteFuncType);
+                doFreeResource(&entry, entry.type == skipDeleteFuncType);
 
-                if (*eltptr != elements)
-                    prev = head;        /* prev may no longer be valid */
+                again = TRUE;
+                break;
             }
-            else
-                prev = &res->next;
         }
     }
 }
@@ -938,28 +1028,34 @@ void
 FreeResourceByType(XID id, RESTYPE type, Bool skipFree)
 {
     int cid;
-    ResourcePtr res;
-    ResourcePtr *prev, *head;
 
     if (((cid = dixClientIdForXID(id)) < LimitClients) && clientTable[cid].buckets) {
-        head = &clientTable[cid].resources[HashResourceID(id, clientTable[cid].hashsize)];
+        ClientResourceRec *rrec = &clientTable[cid];
+        int mask = rrec->buckets - 1;
+        int i = HashResourceID(id, rrec->hashsize);
+
+        for (int probes = rrec->buckets; probes > 0;
+             probes--, i = (i + 1) & mask) {
+            ResourcePtr res = &rrec->slots[i];
+
+            if (res->seq == SEQ_EMPTY)
+                break;
+            if (!ResourceSlotLive(res) || res->id != id || res->type != type)
+                continue;
+
+            ResourceRec entry = *res;
 
-        prev = head;
-        while ((res = *prev)) {
-            if (res->id == id && res->type == type) {
 #ifdef XSERVER_DTRACE
-                XSERVER_RESOURCE_FREE(res->id, res->type,
-                                      res->value, TypeNameString(res->type));
+            XSERVER_RESOURCE_FREE(entry.id, entry.type,
+                                  entry.value, TypeNameString(entry.type));
 #endif
-                *prev = res->next;
-                clientTable[cid].elements--;
+            res->seq = SEQ_DELETED;
+            rrec->elements--;
+            ResourceTypeCountDecr(rrec, entry.type);
 
-                doFreeResource(res, skipFree);
+            doFreeResource(&entry, skipFree);
 
-                break;
-            }
-            else
-                prev = &res->next;
+            break;
         }
     }
 }
@@ -976,12 +1072,23 @@ ChangeResourceValue(XID id, RESTYPE rtype, void *value)
     int cid;
 
     if (((cid = dixClientIdForXID(id)) < LimitClients) && clientTable[cid].buckets) {
-        for (ResourcePtr res = clientTable[cid].resources[HashResourceID(id, clientTable[cid].hashsize)];
-            res; res = res->next)
-            if ((res->id == id) && (res->type == rtype)) {
+        ClientResourceRec *rrec = &clientTable[cid];
+        int mask = rrec->buckets - 1;
+        int i = HashResourceID(id, rrec->hashsize);
+
+        for (int probes = rrec->buckets; probes > 0;
+             probes--, i = (i + 1) & mask) {
+            ResourcePtr res = &rrec->slots[i];
+
+            if (res->seq == SEQ_EMPTY)
+                break;
+            if (ResourceSlotLive(res) && (res->id == id) &&
+                (res->type == rtype)) {
                 res->value = value;
+                dixLookupCacheGeneration++;
                 return TRUE;
             }
+        }
     }
     return FALSE;
 }
@@ -996,25 +1103,21 @@ void
 FindClientResourcesByType(ClientPtr client,
                           RESTYPE type, FindResType func, void *cdata)
 {
-    ResourcePtr *resources;
-    int elements;
-    int *eltptr;
+    ClientResourceRec *rrec;
 
     if (!client)
         client = serverClient;
 
-    resources = clientTable[client->index].resources;
-    eltptr = &clientTable[client->index].elements;
-    for (int i = 0; i < clientTable[client->index].buckets; i++) {
-        for (ResourcePtr this = resources[i], next; this; this = next) {
-            next = this->next;
-            if (!type || this->type == type) {
-                elements = *eltptr;
-                (*func) (this->value, this->id, cdata);
-                if (*eltptr != elements)
-                    next = resources[i];        /* start over */
-            }
-        }
+    /* func may rehash the table via AddResource, so re-read the slot
+       array on every step rather than caching it */
+    rrec = &clientTable[client->index];
+    for (int i = 0; i < rrec->buckets; i++) {
+        ResourcePtr res = &rrec->slots[i];
+
+        if (!ResourceSlotLive(res))
+            continue;
+        if (!type || res->type == type)
+            (*func) (res->value, res->id, cdata);
     }
 }
 
@@ -1030,23 +1133,18 @@ void FindSubResources(void *resource,
 void
 FindAllClientResources(ClientPtr client, FindAllRes func, void *cdata)
 {
-    ResourcePtr *resources;
-    int elements;
-    int *eltptr;
+    ClientResourceRec *rrec;
 
     if (!client)
         client = serverClient;
 
-    resources = clientTable[client->index].resources;
-    eltptr = &clientTable[client->index].elements;
-    for (int i = 0; i < clientTable[client->index].buckets; i++) {
-        for (ResourcePtr this = resources[i], next; this; this = next) {
-            next = this->next;
-            elements = *eltptr;
-            (*func) (this->value, this->id, this->type, cdata);
-            if (*eltptr != elements)
-                next = resources[i];    /* start over */
-        }
+    rrec = &clientTable[client->index];
+    for (int i = 0; i < rrec->buckets; i++) {
+        ResourcePtr res = &rrec->slots[i];
+
+        if (!ResourceSlotLive(res))
+            continue;
+        (*func) (res->value, res->id, res->type, cdata);
     }
 }
 
@@ -1055,22 +1153,23 @@ LookupClientResourceComplex(ClientPtr client,
                             RESTYPE type,
                             FindComplexResType func, void *cdata)
 {
-    ResourcePtr *resources;
+    ClientResourceRec *rrec;
     void *value;
 
     if (!client)
         client = serverClient;
 
-    resources = clientTable[client->index].resources;
-    for (int i = 0; i < clientTable[client->index].buckets; i++) {
-        for (ResourcePtr this = resources[i], next; this; this = next) {
-            next = this->next;
-            if (!type || this->type == type) {
-                /* workaround func freeing the type as DRI1 does */
-                value = this->value;
-                if ((*func) (value, this->id, cdata))
-                    return value;
-            }
+    rrec = &clientTable[client->index];
+    for (int i = 0; i < rrec->buckets; i++) {
+        ResourcePtr res = &rrec->slots[i];
+
+        if (!ResourceSlotLive(res))
+            continue;
+        if (!type || res->type == type) {
+            /* workaround func freeing the type as DRI1 does */
+            value = res->value;
+            if ((*func) (value, res->id, cdata))
+                return value;
         }
     }
     return NULL;
@@ -1079,46 +1178,60 @@ LookupClientResourceComplex(ClientPtr client,
 void
 FreeClientNeverRetainResources(ClientPtr client)
 {
-    ResourcePtr *resources;
-    ResourcePtr this;
-    ResourcePtr *prev;
+    ClientResourceRec *rrec;
     int elements;
-    int *eltptr;
 
     if (!client)
         return;
 
-    resources = clientTable[client->index].resources;
-    eltptr = &clientTable[client->index].elements;
-    for (int j = 0; j < clientTable[client->index].buckets; j++) {
-        prev = &resources[j];
-        while ((this = *prev)) {
-            RESTYPE rtype = this->type;
+    rrec = &clientTable[client->index];
+    for (int i = 0; i < rrec->buckets; i++) {
+        ResourcePtr res = &rrec->slots[i];
+
+        if (!ResourceSlotLive(res) || !(res->type & RC_NEVERRETAIN))
+            continue;
+
+        ResourceRec entry = *res;
 
-            if (rtype & RC_NEVERRETAIN) {
 #ifdef XSERVER_DTRACE
-                XSERVER_RESOURCE_FREE(this->id, this->type,
-                                      this->value, TypeNameString(this->type));
+        XSERVER_RESOURCE_FREE(entry.id, entry.type,
+                              entry.value, TypeNameString(entry.type));
 #endif
-                *prev = this->next;
-                clientTable[client->index].elements--;
-                elements = *eltptr;
+        res->seq = SEQ_DELETED;
+        elements = --rrec->elements;
 
-                doFreeResource(this, FALSE);
+        doFreeResource(&entry, FALSE);
 
-                if (*eltptr != elements)
-                    prev = &resources[j];       /* prev may no longer be valid */
-            }
-            else
-                prev = &this->next;
-        }
+        if (rrec->elements != elements)
+            i = -1;             /* table changed under us; rescan */
     }
 }
 
+/* snapshot of a live slot, by index rather than pointer since a delete
+ * func may rehash the table and reallocate the slot array */
+typedef struct {
+    int slot;
+    CARD64 seq;
+} ResourceSlotRef;
+
+/* sort newest insertion first, so resources come down in the opposite
+ * order they were added */
+static int
+CompareSlotRefs(const void *a, const void *b)
+{
+    const ResourceSlotRef *ra = a, *rb = b;
+
+    if (ra->seq < rb->seq)
+        return 1;
+    if (ra->seq > rb->seq)
+        return -1;
+    return 0;
+}
+
 void
 FreeClientResources(ClientPtr client)
 {
-    ResourcePtr *resources;
+    ClientResourceRec *rrec;
 
     /* This routine shouldn't be called with a null client, but just in
        case ... */
@@ -1128,35 +1241,94 @@ FreeClientResources(ClientPtr client)
 
     HandleSaveSet(client);
 
-    resources = clientTable[client->index].resources;
-    for (int j = 0; j < clientTable[client->index].buckets; j++) {
-        /* It may seem silly to update the head of this resource list as
-           we delete the members, since the entire list will be deleted any way,
-           but there are some resource deletion functions "FreeClientPixels" for
-           one which do a LookupID on another resource id (a Colormap id in this
-           case), so the resource list must be kept valid up to the point that
-           it is deleted, so every time we delete a resource, we must update the
-           head, just like in FreeResource. I hope that this doesn't slow down
-           mass deletion appreciably. PRH */
+    rrec = &clientTable[client->index];
+
+    /* Delete funcs may look up, free or even add other resources of this
+       client ("FreeClientPixels" for one does a LookupID on a Colormap id),
+       so the table must stay valid throughout the teardown.  Walk a sorted
+       snapshot of the live slots and recheck each one by its seq before
+       freeing it; whatever a delete func added behind our back is picked
+       up by another pass. */
+    while (rrec->elements > 0) {
+        ResourceSlotRef *refs = calloc(rrec->elements, sizeof(ResourceSlotRef));
+        int n = 0;
+
+        if (!refs)
+            break;
+        for (int j = 0; j < rrec->buckets && n < rrec->elements; j++) {
+            if (ResourceSlotLive(&rrec->slots[j])) {
+                refs[n].slot = j;
+                refs[n].seq = rrec->slots[j].seq;
+                n++;
+            }
+        }
+        if (!n) {
+            free(refs);
+            break;
+        }
+        qsort(refs, n, sizeof(ResourceSlotRef), CompareSlotRefs);
+        for (int j = 0; j < n; j++) {
+            ResourcePtr res;
 
-        ResourcePtr *head;
+            /* skip slots a delete func already freed or a rehash moved */
+            if (refs[j].slot >= rrec->buckets)
+                continue;
+            res = &rrec->slots[refs[j].slot];
+            if (res->seq != refs[j].seq)
+                continue;
 
-        head = &resources[j];
+            ResourceRec entry = *res;
 
-        for (ResourcePtr this = *head; this; this = *head) {
 #ifdef XSERVER_DTRACE
-            XSERVER_RESOURCE_FREE(this->id, this->type,
-                                  this->value, TypeNameString(this->type));
+            XSERVER_RESOURCE_FREE(entry.id, entry.type,
+                                  entry.value, TypeNameString(entry.type));
 #endif
-            *head = this->next;
-            clientTable[client->index].elements--;
+            res->seq = SEQ_DELETED;
+            rrec->elements--;
+            ResourceTypeCountDecr(rrec, entry.type);
 
-            doFreeResource(this, FALSE);
+            doFreeResource(&entry, FALSE);
         }
+        free(refs);
     }
-    free(clientTable[client->index].resources);
-    clientTable[client->index].resources = NULL;
-    clientTable[client->index].buckets = 0;
+
+    /* only reached with elements left if the snapshot alloc failed; free
+       in slot order then, correctness over ordering at this point */
+    while (rrec->elements > 0) {
+        Bool progress = FALSE;
+
+        for (int j = 0; j < rrec->buckets; j++) {
+            ResourcePtr res = &rrec->slots[j];
+
+            if (!ResourceSlotLive(res))
+                continue;
+
+            ResourceRec entry = *res;
+
+#ifdef XSERVER_DTRACE
+            XSERVER_RESOURCE_FREE(entry.id, entry.type,
+                                  entry.value, TypeNameString(entry.type));
+#endif
+            res->seq = SEQ_DELETED;
+            rrec->elements--;
+            ResourceTypeCountDecr(rrec, entry.type);
+
+            doFreeResource(&entry, FALSE);
+
+            progress = TRUE;
+        }
+        if (!progress)
+            break;
+    }
+
+    free(rrec->slots);
+    rrec->slots = NULL;
+    rrec->buckets = 0;
+    rrec->elements = 0;
+    rrec->occupied = 0;
+    free(rrec->typeCounts);
+    rrec->typeCounts = NULL;
+    rrec->numTypeCounts = 0;
 }
 
 void
@@ -1198,35 +1370,51 @@ dixLookupResourceByType(void **result, XID id, RESTYPE rtype,
                         ClientPtr client, Mask mode)
 {
     int cid = dixClientIdForXID(id);
-    ResourcePtr res = NULL;
+    RESTYPE ftype = 0;
+    void *fvalue = NULL;
+    Bool found = FALSE;
 
     *result = NULL;
     if ((rtype & TypeMask) > lastResourceType)
         return BadImplementation;
 
     if ((cid < LimitClients) && clientTable[cid].buckets) {
-        res = clientTable[cid].resources[HashResourceID(id, clientTable[cid].hashsize)];
+        ClientResourceRec *rrec = &clientTable[cid];
+        int mask = rrec->buckets - 1;
+        int i = HashResourceID(id, rrec->hashsize);
+
+        for (int probes = rrec->buckets; probes > 0;
+             probes--, i = (i + 1) & mask) {
+            ResourcePtr res = &rrec->slots[i];
 
-        for (; res; res = res->next)
-            if (res->id == id && res->type == rtype)
+            if (res->seq == SEQ_EMPTY)
+                break;
+            if (ResourceSlotLive(res) && res->id == id && res->type == rtype) {
+                /* copy out before the hook below; it may free the
+                   resource and recycle the slot */
+                ftype = res->type;
+                fvalue = res->value;
+                found = TRUE;
                 break;
+            }
+        }
     }
     if (client) {
         client->errorValue = id;
     }
-    if (!res)
+    if (!found)
         return resourceTypes[rtype & TypeMask].errorValue;
 
     if (client) {
-        cid = XaceHookResourceAccess(client, id, res->type,
-                       res->value, X11_RESTYPE_NONE, NULL, mode);
+        cid = XaceHookResourceAccess(client, id, ftype,
+                       fvalue, X11_RESTYPE_NONE, NULL, mode);
         if (cid == BadValue)
             return resourceTypes[rtype & TypeMask].errorValue;
         if (cid != Success)
             return cid;
     }
 
-    *result = res->value;
+    *result = fvalue;
     return Success;
 }
 
@@ -1235,31 +1423,46 @@ dixLookupResourceByClass(void **result, XID id, RESTYPE rclass,
                          ClientPtr client, Mask mode)
 {
     int cid = dixClientIdForXID(id);
-    ResourcePtr res = NULL;
+    RESTYPE ftype = 0;
+    void *fvalue = NULL;
+    Bool found = FALSE;
 
     *result = NULL;
 
     if ((cid < LimitClients) && clientTable[cid].buckets) {
-        res = clientTable[cid].resources[HashResourceID(id, clientTable[cid].hashsize)];
+        ClientResourceRec *rrec = &clientTable[cid];
+        int mask = rrec->buckets - 1;
+        int i = HashResourceID(id, rrec->hashsize);
+
+        for (int probes = rrec->buckets; probes > 0;
+             probes--, i = (i + 1) & mask) {
+            ResourcePtr res = &rrec->slots[i];
 
-        for (; res; res = res->next)
-            if (res->id == id && (res->type & rclass))
+            if (res->seq == SEQ_EMPTY)
                 break;
+            if (ResourceSlotLive(res) && res->id == id &&
+                (res->type & rclass)) {
+                ftype = res->type;
+                fvalue = res->value;
+                found = TRUE;
+                break;
+            }
+        }
     }
     if (client) {
         client->errorValue = id;
     }
-    if (!res)
+    if (!found)
         return BadValue;
 
     if (client) {
-        cid = XaceHookResourceAccess(client, id, res->type,
-                       res->value, X11_RESTYPE_NONE, NULL, mode);
+        cid = XaceHookResourceAccess(client, id, ftype,
+                       fvalue, X11_RESTYPE_NONE, NULL, mode);
         if (cid != Success)
             return cid;
     }
 
-    *result = res->value;
+    *result = fvalue;
     return Success;
 }
 
@@ -157,6 +157,22 @@ void GetXIDRange(int client,
                  XID *minp,
                  XID *maxp);
 
+/*
+ * @brief read the per-type live resource counts of given client
+ *
+ * The resource table keeps a running count of live resources per type,
+ * indexed by (type & TypeMask) - 1.  This lets the XRes extension answer
+ * QueryClientResources without walking the client's whole table.
+ *
+ * The returned array is owned by the resource table and only valid until
+ * the next resource is added or freed; it may be NULL when numTypes is 0.
+ *
+ * @param client the client whose counters shall be read
+ * @param numTypes buffer receiving the number of entries in the array
+ * @return pointer to the counter array
+ */
+const int *dixClientResourceTypeCounts(ClientPtr client, int *numTypes);
+
 /* Resource state callback */
 extern CallbackListPtr ResourceStateCallback;
 
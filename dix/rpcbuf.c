@@ -23,6 +23,20 @@ static inline Bool __x_rpcbuf_write_bin_pad(
     return TRUE;
 }
 
+void x_rpcbuf_drop_segs(x_rpcbuf_t *rpcbuf)
+{
+    x_rpcbuf_seg_t *seg = rpcbuf->segs;
+    while (seg) {
+        x_rpcbuf_seg_t *next = seg->next;
+        if (seg->done)
+            seg->done(seg->closure);
+        free(seg);
+        seg = next;
+    }
+    rpcbuf->segs = rpcbuf->segs_tail = NULL;
+    rpcbuf->seg_bytes = 0;
+}
+
 Bool x_rpcbuf_makeroom(x_rpcbuf_t *rpcbuf, size_t needed)
 {
     /* break out of alreay in error state */
@@ -50,6 +64,7 @@ err:
     if (rpcbuf->err_clear) {
         free(rpcbuf->buffer);
         rpcbuf->buffer = NULL;
+        x_rpcbuf_drop_segs(rpcbuf);
     }
     return FALSE;
 }
@@ -57,12 +72,15 @@ err:
 _X_EXPORT /* only for GLX, not part of public ABI */
 void x_rpcbuf_clear(x_rpcbuf_t *rpcbuf)
 {
+    x_rpcbuf_drop_segs(rpcbuf);
     free(rpcbuf->buffer);
     memset(rpcbuf, 0, sizeof(x_rpcbuf_t));
 }
 
 void x_rpcbuf_reset(x_rpcbuf_t *rpcbuf)
 {
+    x_rpcbuf_drop_segs(rpcbuf);
+
     /* no need to reset if never been actually written to */
     if ((!rpcbuf->buffer) || (!rpcbuf->size) || (!rpcbuf->wpos))
         return;
@@ -244,3 +262,48 @@ Bool x_rpcbuf_write_binary_pad(x_rpcbuf_t *rpcbuf, const void *values,
 
     return __x_rpcbuf_write_bin_pad(rpcbuf, values, size);
 }
+
+Bool x_rpcbuf_write_ref_pad(x_rpcbuf_t *rpcbuf, const void *data, size_t len,
+                            WriteVecDoneProcPtr done, void *closure)
+{
+    if ((!data) || (!len) || rpcbuf->error)
+        goto release;
+
+    /* keep the segment on a protocol unit boundary, like the copying
+       variant does for its payload */
+    x_rpcbuf_pad(rpcbuf);
+    if (rpcbuf->error)
+        goto release;
+
+    x_rpcbuf_seg_t *seg = calloc(1, sizeof(x_rpcbuf_seg_t));
+    if (!seg) {
+        rpcbuf->error = TRUE;
+        if (rpcbuf->err_clear) {
+            free(rpcbuf->buffer);
+            rpcbuf->buffer = NULL;
+            x_rpcbuf_drop_segs(rpcbuf);
+        }
+        goto release;
+    }
+
+    seg->at = rpcbuf->wpos;
+    seg->data = data;
+    seg->len = len;
+    seg->done = done;
+    seg->closure = closure;
+
+    if (rpcbuf->segs_tail)
+        rpcbuf->segs_tail->next = seg;
+    else
+        rpcbuf->segs = seg;
+    rpcbuf->segs_tail = seg;
+    rpcbuf->seg_bytes += pad_to_int32(len);
+
+    return TRUE;
+
+release:
+    /* ownership passed to us in any case: release the payload now */
+    if (done)
+        done(closure);
+    return (!rpcbuf->error);
+}
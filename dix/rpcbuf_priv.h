@@ -27,6 +27,26 @@
  * x_rpcbuf_clear(&buf);
  */
 
+/*
+ * payload segment referenced by the buffer instead of being copied into it.
+ *
+ * the segment is spliced into the outgoing byte stream at owned-buffer
+ * offset `at` (always 4-byte aligned) and padded to full protocol units
+ * on the wire. ownership of the payload passes to the rpcbuf: `done` is
+ * fired (with `closure`) once the server is finished with the bytes --
+ * after the writev() flush, or immediately on any abort path.
+ *
+ * see x_rpcbuf_write_ref_pad()
+ */
+typedef struct x_rpcbuf_seg {
+    struct x_rpcbuf_seg *next;
+    size_t at;                /* owned-buffer offset the segment sits at */
+    const void *data;         /* borrowed payload bytes */
+    size_t len;               /* unpadded length in bytes */
+    WriteVecDoneProcPtr done; /* release callback, may be NULL */
+    void *closure;
+} x_rpcbuf_seg_t;
+
 typedef struct x_rpcbuf {
     size_t size;    /* total size of buffer */
     size_t wpos;    /* length of data inside the buffer / next write position */
@@ -34,6 +54,9 @@ typedef struct x_rpcbuf {
     Bool swapped;   /* TRUE when typed write operation shall byte-swap */
     Bool error;     /* TRUE when the last allocation failed */
     Bool err_clear; /* set to TRUE if should automatically clear on error */
+    x_rpcbuf_seg_t *segs;      /* referenced payload segments, in order */
+    x_rpcbuf_seg_t *segs_tail; /* tail of the segment list */
+    size_t seg_bytes;          /* padded total size of all segments */
 } x_rpcbuf_t;
 
 #define XLIBRE_RPCBUF_CHUNK_SIZE 4096
@@ -140,6 +163,40 @@ Bool x_rpcbuf_write_string_0t_pad(x_rpcbuf_t *rpcbuf, const char *str)
 Bool x_rpcbuf_write_binary_pad(x_rpcbuf_t *rpcbuf, const void *data,
                                size_t count) _X_ATTRIBUTE_NONNULL_ARG(1);
 
+/*
+ * write binary data to rpc buffer by reference (padded), without copying.
+ *
+ * instead of copying the bytes, a segment record is queued; the reply
+ * send path hands it to WriteToClientVec(), so large payloads travel via
+ * writev() with no intermediate copy. the buffer takes ownership of the
+ * payload: `done` fires (with `closure`) once the server is finished with
+ * the bytes, also on all error and abort paths. the data is written as-is
+ * -- no byte-swapping is applied, exactly like x_rpcbuf_write_binary_pad().
+ * if given data is NULL or size is zero, only `done` is fired.
+ *
+ * the owned buffer is padded to a 4-byte boundary before the segment is
+ * queued, so the wire layout matches the copying variant.
+ *
+ * @param rpcbuf    pointer to x_rpcbuf_t to operate on
+ * @param data      payload bytes, kept alive by the caller until `done`
+ * @param len       unpadded length of the payload in bytes
+ * @param done      release callback, may be NULL
+ * @param closure   opaque argument passed to `done`
+ * @return          TRUE on success, FALSE on allocation failure
+ */
+Bool x_rpcbuf_write_ref_pad(x_rpcbuf_t *rpcbuf, const void *data, size_t len,
+                            WriteVecDoneProcPtr done, void *closure)
+    _X_ATTRIBUTE_NONNULL_ARG(1);
+
+/*
+ * release all queued payload segments: fire their `done` callbacks and
+ * free the segment records. the owned buffer is left untouched.
+ *
+ * @param rpcbuf    pointer to x_rpcbuf_t to operate on
+ */
+void x_rpcbuf_drop_segs(x_rpcbuf_t *rpcbuf)
+    _X_ATTRIBUTE_NONNULL_ARG(1);
+
 /*
  * write a CARD8
  *
@@ -325,7 +382,8 @@ Bool x_rpcbuf_write_CARD64s(x_rpcbuf_t *rpcbuf, const CARD64 *values,
  * @return          number of 4-byte units (w/ padding) written into the buffer
  */
 static inline CARD32 x_rpcbuf_wsize_units(x_rpcbuf_t *rpcbuf) {
-    return (CARD32)((rpcbuf->wpos + 3) / 4);
+    /* seg_bytes is already padded */
+    return (CARD32)(((rpcbuf->wpos + 3) / 4) + (rpcbuf->seg_bytes / 4));
 }
 
 /*
@@ -376,9 +434,28 @@ static inline void x_rpcbuf_write_rpcbuf_pad(
         if (rpcbuf->err_clear) {
             free(rpcbuf->buffer);
             rpcbuf->buffer = NULL;
+            x_rpcbuf_drop_segs(rpcbuf);
         }
     } else {
+        if (source->segs)
+            x_rpcbuf_pad(rpcbuf); /* segment offsets are 4-byte aligned */
+        const size_t base = rpcbuf->wpos;
         x_rpcbuf_write_binary_pad(rpcbuf, source->buffer, source->wpos);
+        if (!rpcbuf->error && source->segs) {
+            /* splice the referenced segments over, shifted by our own
+               write position -- the interleaving is preserved since the
+               owned bytes were copied contiguously */
+            for (x_rpcbuf_seg_t *seg = source->segs; seg; seg = seg->next)
+                seg->at += base;
+            if (rpcbuf->segs_tail)
+                rpcbuf->segs_tail->next = source->segs;
+            else
+                rpcbuf->segs = source->segs;
+            rpcbuf->segs_tail = source->segs_tail;
+            rpcbuf->seg_bytes += source->seg_bytes;
+            source->segs = source->segs_tail = NULL;
+            source->seg_bytes = 0;
+        }
     }
     x_rpcbuf_clear(source);
 }
@@ -648,6 +648,8 @@ TouchAddListener(TouchPointInfoPtr ti, XID resource, int resource_type,
     ti->listeners[ti->num_listeners].type = type;
     ti->listeners[ti->num_listeners].window = window;
     ti->listeners[ti->num_listeners].grab = g;
+    ti->listeners[ti->num_listeners].resolveInterestGen = 0;
+    ti->listeners[ti->num_listeners].resolveTreeGen = 0;
     if (grab)
         ti->num_grabs++;
     ti->num_listeners++;
@@ -950,7 +952,7 @@ TouchListenerAcceptReject(DeviceIntPtr dev, TouchPointInfoPtr ti, int listener,
         return Success;
     }
 
-    events = InitEventList(GetMaximumEventsNum());
+    events = AcquireEventList(dev);
     BUG_RETURN_VAL_MSG(!events, BadAlloc, "Failed to allocate touch ownership events\n");
 
     nev = GetTouchOwnershipEvents(events, dev, ti, mode,
@@ -960,7 +962,7 @@ TouchListenerAcceptReject(DeviceIntPtr dev, TouchPointInfoPtr ti, int listener,
     for (int i = 0; i < nev; i++)
         mieqProcessDeviceEvent(dev, events + i, NULL);
 
-    FreeEventList(events, GetMaximumEventsNum());
+    ReleaseEventList(dev, events);
 
     return nev ? Success : BadMatch;
 }
@@ -1000,7 +1002,7 @@ TouchAcceptReject(ClientPtr client, DeviceIntPtr dev, int mode,
 void
 TouchEndPhysicallyActiveTouches(DeviceIntPtr dev)
 {
-    InternalEvent *eventlist = InitEventList(GetMaximumEventsNum());
+    InternalEvent *eventlist = AcquireEventList(dev);
 
     input_lock();
     mieqProcessInputEvents();
@@ -1017,7 +1019,7 @@ TouchEndPhysicallyActiveTouches(DeviceIntPtr dev)
     }
     input_unlock();
 
-    FreeEventList(eventlist, GetMaximumEventsNum());
+    ReleaseEventList(dev, eventlist);
 }
 
 /**
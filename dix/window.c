@@ -447,6 +447,132 @@ TraverseTree(WindowPtr pWin, VisitWindowProcPtr func, void *data)
     return WT_NOMATCH;
 }
 
+/*
+ * Flattened preorder view of each screen's window tree.  Full-tree scans
+ * (WalkTree is used by most extensions) chase pointers through thousands
+ * of scattered WindowRecs on busy desktops; iterating a compact array is
+ * considerably kinder to the cache.  The snapshot is rebuilt lazily: every
+ * restructure of any tree bumps dixWindowTreeGeneration and the next WalkTree
+ * on a stale screen rebuilds its view.  Each entry records the size of the
+ * window's subtree so WT_DONTWALKCHILDREN can skip ahead in the array.
+ */
+typedef struct {
+    WindowPtr win;
+    int subtree;                /* windows in this subtree, including self */
+} FlatTreeEntry;
+
+typedef struct {
+    FlatTreeEntry *entries;
+    int count;
+    int size;
+    CARD32 generation;
+} FlatTreeRec;
+
+static FlatTreeRec flatTree[MAXSCREENS];
+CARD32 dixWindowTreeGeneration = 1;
+
+/* called whenever a window is linked, unlinked, restacked or freed */
+static inline void
+MarkTreeRestructured(void)
+{
+    dixWindowTreeGeneration++;
+}
+
+static Bool
+RebuildFlatTree(ScreenPtr pScreen)
+{
+    FlatTreeRec *ft = &flatTree[pScreen->myNum];
+    WindowPtr pWin = pScreen->root;
+    WindowPtr pChild;
+    int *parentIdx;
+    int count, i, parent;
+
+    count = 0;
+    pChild = pWin;
+    while (1) {
+        count++;
+        if (pChild->firstChild) {
+            pChild = pChild->firstChild;
+            continue;
+        }
+        while (!pChild->nextSib && (pChild != pWin))
+            pChild = pChild->parent;
+        if (pChild == pWin)
+            break;
+        pChild = pChild->nextSib;
+    }
+
+    if (count > ft->size) {
+        FlatTreeEntry *entries = realloc(ft->entries,
+                                         count * sizeof(FlatTreeEntry));
+        if (!entries)
+            return FALSE;
+        ft->entries = entries;
+        ft->size = count;
+    }
+    parentIdx = calloc(count, sizeof(int));
+    if (!parentIdx)
+        return FALSE;
+
+    i = 0;
+    parent = -1;
+    pChild = pWin;
+    while (1) {
+        ft->entries[i].win = pChild;
+        ft->entries[i].subtree = 1;
+        parentIdx[i] = parent;
+        if (pChild->firstChild) {
+            parent = i++;
+            pChild = pChild->firstChild;
+            continue;
+        }
+        i++;
+        while (!pChild->nextSib && (pChild != pWin)) {
+            pChild = pChild->parent;
+            parent = parentIdx[parent];
+        }
+        if (pChild == pWin)
+            break;
+        pChild = pChild->nextSib;
+    }
+    /* children follow their parents in preorder, so one backward pass
+       accumulates the subtree sizes */
+    for (i = count - 1; i > 0; i--)
+        ft->entries[parentIdx[i]].subtree += ft->entries[i].subtree;
+    free(parentIdx);
+
+    ft->count = count;
+    ft->generation = dixWindowTreeGeneration;
+    return TRUE;
+}
+
+/*
+ * Resume a pointer-chasing traversal at pChild (whose visit just returned
+ * result); used when a WalkTree visitor restructures the tree and the
+ * flattened snapshot can no longer be trusted.
+ */
+static int
+TraverseTreeContinue(WindowPtr pWin, WindowPtr pChild, int result,
+                     VisitWindowProcPtr func, void *data)
+{
+    while (1) {
+        if ((result == WT_WALKCHILDREN) && pChild->firstChild) {
+            pChild = pChild->firstChild;
+        }
+        else {
+            while (!pChild->nextSib && (pChild != pWin))
+                pChild = pChild->parent;
+            if (pChild == pWin)
+                break;
+            pChild = pChild->nextSib;
+        }
+        result = (*func) (pChild, data);
+        if (result == WT_STOPWALKING)
+            return WT_STOPWALKING;
+    }
+    return WT_NOMATCH;
+}
+
 /*****
  * WalkTree
  *   Walk the window tree, for SCREEN, performing FUNC(pWin, data) on
@@ -458,7 +584,26 @@ TraverseTree(WindowPtr pWin, VisitWindowProcPtr func, void *data)
 int
 WalkTree(ScreenPtr pScreen, VisitWindowProcPtr func, void *data)
 {
-    return (TraverseTree(pScreen->root, func, data));
+    FlatTreeRec *ft = &flatTree[pScreen->myNum];
+    int i, result;
+
+    if (!pScreen->root)
+        return WT_NOMATCH;
+    if (ft->generation != dixWindowTreeGeneration && !RebuildFlatTree(pScreen))
+        return TraverseTree(pScreen->root, func, data);
+
+    for (i = 0; i < ft->count;) {
+        FlatTreeEntry *e = &ft->entries[i];
+
+        result = (*func) (e->win, data);
+        if (result == WT_STOPWALKING)
+            return WT_STOPWALKING;
+        if (ft->generation != dixWindowTreeGeneration)
+            return TraverseTreeContinue(pScreen->root, e->win, result,
+                                        func, data);
+        i += (result == WT_WALKCHILDREN) ? 1 : e->subtree;
+    }
+    return WT_NOMATCH;
 }
 
 /* hack to force no backing store */
@@ -564,6 +709,7 @@ CreateRootWindow(ScreenPtr pScreen)
     screenIsSaved = SCREEN_SAVER_OFF;
 
     pScreen->root = pWin;
+    MarkTreeRestructured();
 
     pWin->drawable.pScreen = pScreen;
     pWin->drawable.type = DRAWABLE_WINDOW;
@@ -576,6 +722,7 @@ CreateRootWindow(ScreenPtr pScreen)
     pWin->drawable.serialNumber = NEXT_SERIAL_NUMBER;
 
     pWin->parent = NullWindow;
+    pWin->treeDepth = 0;
     SetWindowToDefaults(pWin);
 
     pWin->optional = calloc(1, sizeof(WindowOptRec));
@@ -586,6 +733,9 @@ CreateRootWindow(ScreenPtr pScreen)
     pWin->optional->otherEventMasks = 0;
     pWin->optional->otherClients = NULL;
     pWin->optional->passiveGrabs = NULL;
+    memset(pWin->optional->passiveGrabDetails, 0,
+           sizeof(pWin->optional->passiveGrabDetails));
+    pWin->optional->passiveGrabAnyDetail = FALSE;
     pWin->optional->backingBitPlanes = ~0L;
     pWin->optional->backingPixel = 0;
     pWin->optional->boundingShape = NULL;
@@ -826,6 +976,7 @@ dixCreateWindow(Window wid, WindowPtr pParent, int x, int y, unsigned w,
     pWin->drawable.class = class;
 
     pWin->parent = pParent;
+    pWin->treeDepth = pParent->treeDepth + 1;
     SetWindowToDefaults(pWin);
 
     if (visual != ancwopt->visual) {
@@ -889,6 +1040,7 @@ dixCreateWindow(Window wid, WindowPtr pParent, int x, int y, unsigned w,
             pParent->lastChild = pWin;
         pParent->firstChild = pWin;
     }
+    MarkTreeRestructured();
 
     SetWinSize(pWin);
     SetBorderSize(pWin);
@@ -1025,6 +1177,7 @@ CrushTree(WindowPtr pWin)
             }
             FreeWindowResources(pChild);
             dixFreeObjectWithPrivates(pChild, PRIVATE_WINDOW);
+            MarkTreeRestructured();
             if ((pChild = pSib))
                 break;
             pChild = pParent;
@@ -1073,6 +1226,7 @@ DeleteWindow(void *value, XID wid)
     else
         pWin->drawable.pScreen->root = NULL;
     dixFreeObjectWithPrivates(pWin, PRIVATE_WINDOW);
+    MarkTreeRestructured();
     return Success;
 }
 
@@ -1622,6 +1776,8 @@ MoveWindowInStack(WindowPtr pWin, WindowPtr pNextSib)
     if (pWin->nextSib != pNextSib) {
         WindowPtr pOldNextSib = pWin->nextSib;
 
+        MarkTreeRestructured();
+
         if (!pNextSib) {        /* move to bottom */
             if (pParent->firstChild == pWin)
                 pParent->firstChild = pWin->nextSib;
@@ -2473,6 +2629,13 @@ CompareWIDs(WindowPtr pWin, void *value)
         return WT_WALKCHILDREN;
 }
 
+static int
+AdjustTreeDepth(WindowPtr pWin, void *value)
+{                               /* must conform to VisitWindowProcPtr */
+    pWin->treeDepth += *(int *) value;
+    return WT_WALKCHILDREN;
+}
+
 /*****
  *  ReparentWindow
  *****/
@@ -2485,6 +2648,7 @@ ReparentWindow(WindowPtr pWin, WindowPtr pParent,
     Bool WasMapped = (Bool) (pWin->mapped);
     xEvent event;
     int bw = wBorderWidth(pWin);
+    int depthDelta;
     ScreenPtr pScreen;
 
     pScreen = pWin->drawable.pScreen;
@@ -2529,6 +2693,9 @@ ReparentWindow(WindowPtr pWin, WindowPtr pParent,
 
     /* insert at beginning of pParent */
     pWin->parent = pParent;
+    depthDelta = (pParent->treeDepth + 1) - pWin->treeDepth;
+    if (depthDelta)
+        TraverseTree(pWin, AdjustTreeDepth, &depthDelta);
     pPrev = RealChildHead(pParent);
     if (pPrev) {
         pWin->nextSib = pPrev->nextSib;
@@ -2548,6 +2715,7 @@ ReparentWindow(WindowPtr pWin, WindowPtr pParent,
             pParent->lastChild = pWin;
         pParent->firstChild = pWin;
     }
+    MarkTreeRestructured();
 
     pWin->origin.x = x + bw;
     pWin->origin.y = y + bw;
@@ -3379,6 +3547,8 @@ MakeWindowOptional(WindowPtr pWin)
     optional->otherEventMasks = 0;
     optional->otherClients = NULL;
     optional->passiveGrabs = NULL;
+    memset(optional->passiveGrabDetails, 0, sizeof(optional->passiveGrabDetails));
+    optional->passiveGrabAnyDetail = FALSE;
     optional->backingBitPlanes = ~0L;
     optional->backingPixel = 0;
     optional->boundingShape = NULL;
@@ -33,10 +33,17 @@ DevPrivateKeyRec dri3_screen_private_key;
 
 static x_server_generation_t dri3_screen_generation;
 
+static void dri3_pixmap_destroy(CallbackListPtr *pcbl, ScreenPtr screen, PixmapPtr pixmap)
+{
+    dri3_import_cache_remove_pixmap(screen, pixmap);
+}
+
 static void dri3_screen_close(CallbackListPtr *pcbl, ScreenPtr screen, void *unused)
 {
     dri3_screen_priv_ptr screen_priv = dri3_screen_priv(screen);
     dixScreenUnhookClose(screen, dri3_screen_close);
+    dixScreenUnhookPixmapDestroy(screen, dri3_pixmap_destroy);
+    dri3_invalidate_modifiers(screen);
     free(screen_priv);
 }
 
@@ -54,6 +61,7 @@ dri3_screen_init(ScreenPtr screen, const dri3_screen_info_rec *info)
             return FALSE;
 
         dixScreenHookClose(screen, dri3_screen_close);
+        dixScreenHookPixmapDestroy(screen, dri3_pixmap_destroy);
 
         screen_priv->info = info;
 
@@ -128,4 +128,7 @@ typedef struct dri3_screen_info {
 extern _X_EXPORT Bool
 dri3_screen_init(ScreenPtr screen, const dri3_screen_info_rec *info);
 
+extern _X_EXPORT void
+dri3_invalidate_modifiers(ScreenPtr screen);
+
 #endif /* _DRI3_H_ */
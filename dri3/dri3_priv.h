@@ -42,6 +42,31 @@ typedef struct dri3_dmabuf_format {
     uint64_t                   *modifiers;
 } dri3_dmabuf_format_rec, *dri3_dmabuf_format_ptr;
 
+#define DRI3_IMPORT_CACHE_SIZE  8
+
+/*
+ * Identity of an imported buffer set.  Compared with memcmp, so
+ * dri3_import_cache_key() zeroes the whole struct before filling it.
+ */
+typedef struct dri3_import_key {
+    CARD8                       num_bufs;
+    CARD8                       depth;
+    CARD8                       bpp;
+    CARD16                      width;
+    CARD16                      height;
+    CARD64                      modifier;
+    dev_t                       dev;
+    ino_t                       ino[4];
+    CARD32                      strides[4];
+    CARD32                      offsets[4];
+} dri3_import_key_rec, *dri3_import_key_ptr;
+
+typedef struct dri3_import_cache_entry {
+    PixmapPtr                   pixmap;         /* weak; cleared on pixmap destroy */
+    CARD32                      serial;         /* for LRU eviction */
+    dri3_import_key_rec         key;
+} dri3_import_cache_entry_rec, *dri3_import_cache_entry_ptr;
+
 typedef struct dri3_screen_priv {
     ConfigNotifyProcPtr         ConfigNotify;
 
@@ -49,9 +74,15 @@ typedef struct dri3_screen_priv {
     CARD32                      num_formats;
     dri3_dmabuf_format_ptr      formats;
 
+    dri3_import_cache_entry_rec import_cache[DRI3_IMPORT_CACHE_SIZE];
+    CARD32                      import_cache_serial;
+
     const dri3_screen_info_rec *info;
 } dri3_screen_priv_rec, *dri3_screen_priv_ptr;
 
+void
+dri3_import_cache_remove_pixmap(ScreenPtr screen, PixmapPtr pixmap);
+
 #define wrap(priv,real,mem,func) {\
     priv->mem = real->mem; \
     real->mem = func; \
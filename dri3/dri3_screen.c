@@ -29,6 +29,7 @@
 #include <drm_fourcc.h>
 #include <unistd.h>
 #include <assert.h>
+#include <sys/stat.h>
 
 int
 dri3_open(ClientPtr client, ScreenPtr screen, RRProviderPtr provider, int *fd)
@@ -47,6 +48,102 @@ dri3_open(ClientPtr client, ScreenPtr screen, RRProviderPtr provider, int *fd)
     return BadMatch;
 }
 
+/*
+ * Build the identity key for an import request.  A dmabuf is
+ * identified by its device/inode pair; on kernels old enough to hand
+ * out the shared anonymous inode (st_size reads back as zero there)
+ * buffers can't be told apart, so report the import as uncacheable.
+ */
+static Bool
+dri3_import_cache_key(dri3_import_key_ptr key,
+                      CARD8 num_fds, const int *fds,
+                      CARD16 width, CARD16 height,
+                      const CARD32 *strides, const CARD32 *offsets,
+                      CARD8 depth, CARD8 bpp, CARD64 modifier)
+{
+    struct stat                 st;
+    int                         i;
+
+    memset(key, 0, sizeof(*key));
+
+    for (i = 0; i < num_fds; i++) {
+        if (fstat(fds[i], &st) != 0 || st.st_size == 0)
+            return FALSE;
+        if (i == 0)
+            key->dev = st.st_dev;
+        else if (st.st_dev != key->dev)
+            return FALSE;
+        key->ino[i] = st.st_ino;
+        key->strides[i] = strides[i];
+        key->offsets[i] = offsets[i];
+    }
+
+    key->num_bufs = num_fds;
+    key->depth = depth;
+    key->bpp = bpp;
+    key->width = width;
+    key->height = height;
+    key->modifier = modifier;
+
+    return TRUE;
+}
+
+static PixmapPtr
+dri3_import_cache_get(dri3_screen_priv_ptr ds, const dri3_import_key_ptr key)
+{
+    int                         i;
+
+    for (i = 0; i < DRI3_IMPORT_CACHE_SIZE; i++) {
+        dri3_import_cache_entry_ptr entry = &ds->import_cache[i];
+
+        if (entry->pixmap && !memcmp(&entry->key, key, sizeof(*key))) {
+            entry->serial = ++ds->import_cache_serial;
+            return entry->pixmap;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+dri3_import_cache_put(dri3_screen_priv_ptr ds, const dri3_import_key_ptr key,
+                      PixmapPtr pixmap)
+{
+    dri3_import_cache_entry_ptr victim = &ds->import_cache[0];
+    int                         i;
+
+    for (i = 1; i < DRI3_IMPORT_CACHE_SIZE; i++) {
+        dri3_import_cache_entry_ptr entry = &ds->import_cache[i];
+
+        if (!entry->pixmap) {
+            victim = entry;
+            break;
+        }
+        if ((INT32) (entry->serial - victim->serial) < 0)
+            victim = entry;
+    }
+
+    /* Entries are weak references, so eviction is a plain overwrite */
+    victim->key = *key;
+    victim->serial = ++ds->import_cache_serial;
+    victim->pixmap = pixmap;
+}
+
+void
+dri3_import_cache_remove_pixmap(ScreenPtr screen, PixmapPtr pixmap)
+{
+    dri3_screen_priv_ptr        ds = dri3_screen_priv(screen);
+    int                         i;
+
+    if (!ds)
+        return;
+
+    for (i = 0; i < DRI3_IMPORT_CACHE_SIZE; i++) {
+        if (ds->import_cache[i].pixmap == pixmap)
+            ds->import_cache[i].pixmap = NULL;
+    }
+}
+
 int
 dri3_pixmap_from_fds(PixmapPtr *ppixmap, ScreenPtr screen,
                      CARD8 num_fds, const int *fds,
@@ -56,11 +153,29 @@ dri3_pixmap_from_fds(PixmapPtr *ppixmap, ScreenPtr screen,
 {
     dri3_screen_priv_ptr        ds = dri3_screen_priv(screen);
     const dri3_screen_info_rec *info = ds->info;
+    dri3_import_key_rec         key;
+    Bool                        cacheable;
     PixmapPtr                   pixmap;
 
     if (!info)
         return BadImplementation;
 
+    /* Re-importing a dmabuf that is already backing a live pixmap just
+     * hands out another reference to that pixmap, so a client cycling
+     * a fixed buffer pool through PixmapFromBuffers doesn't allocate
+     * (or build new driver state) in steady state.
+     */
+    cacheable = dri3_import_cache_key(&key, num_fds, fds, width, height,
+                                      strides, offsets, depth, bpp, modifier);
+    if (cacheable) {
+        pixmap = dri3_import_cache_get(ds, &key);
+        if (pixmap) {
+            pixmap->refcnt++;
+            *ppixmap = pixmap;
+            return Success;
+        }
+    }
+
     if (info->version >= 2 && info->pixmap_from_fds != NULL) {
         pixmap = (*info->pixmap_from_fds) (screen, num_fds, fds, width, height,
                                            strides, offsets, depth, bpp, modifier);
@@ -74,6 +189,9 @@ dri3_pixmap_from_fds(PixmapPtr *ppixmap, ScreenPtr screen,
     if (!pixmap)
         return BadAlloc;
 
+    if (cacheable)
+        dri3_import_cache_put(ds, &key, pixmap);
+
     *ppixmap = pixmap;
     return Success;
 }
@@ -151,6 +269,33 @@ dri3_fd_from_pixmap(PixmapPtr pixmap, CARD16 *stride, CARD32 *size)
     return fds[0];
 }
 
+/*
+ * Drop the cached format/modifier lists so the next negotiation
+ * re-queries the driver.  Called from RandR when a crtc is
+ * reconfigured, since scanout constraints (and with them the
+ * modifiers a driver advertises) can change with the mode.
+ */
+void
+dri3_invalidate_modifiers(ScreenPtr screen)
+{
+    dri3_screen_priv_ptr        ds;
+    int                         i;
+
+    if (!dixPrivateKeyRegistered(&dri3_screen_private_key))
+        return;
+
+    ds = dri3_screen_priv(screen);
+    if (!ds || !ds->formats_cached)
+        return;
+
+    for (i = 0; i < ds->num_formats; i++)
+        free(ds->formats[i].modifiers);
+    free(ds->formats);
+    ds->formats = NULL;
+    ds->num_formats = 0;
+    ds->formats_cached = FALSE;
+}
+
 static int
 cache_formats_and_modifiers(ScreenPtr screen)
 {
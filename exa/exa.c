@@ -713,6 +713,17 @@ static void exaCloseScreen(CallbackListPtr *pcbl, ScreenPtr pScreen, void *unuse
     dixScreenUnhookClose(pScreen, exaCloseScreen);
     dixScreenUnhookPostCreateResources(pScreen, exaCreateScreenResources);
 
+    /* Report how hard the migration heuristic worked, so deployments can
+     * tune the migration scheme when pixmaps ping-pong between system and
+     * card memory.
+     */
+    if (pExaScr->numMigrationsIn || pExaScr->numMigrationsOut)
+        LogMessageVerb(X_INFO, 3,
+                       "EXA(%d): migrations in %u, out %u, thrashed %u\n",
+                       pScreen->myNum, pExaScr->numMigrationsIn,
+                       pExaScr->numMigrationsOut,
+                       pExaScr->numMigrationThrashes);
+
     /* doesn't matter which one actually was registered */
     dixScreenUnhookPixmapDestroy(pScreen, exaPixmapDestroy_classic);
     dixScreenUnhookPixmapDestroy(pScreen, exaPixmapDestroy_driver);
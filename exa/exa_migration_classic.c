@@ -39,6 +39,15 @@
 #define DBG_MIGRATE(a)
 #endif
 
+/* Halve a pixmap's accumulated score for every 16 migration calls it sat
+ * idle, so old history decays instead of holding the pixmap on the wrong
+ * side of the move-in/move-out thresholds when the workload changes.
+ */
+#define EXA_SCORE_DECAY_INTERVAL_SHIFT 4
+
+/* A move-in this soon after a move-out of the same pixmap counts as thrash. */
+#define EXA_MIGRATION_THRASH_WINDOW 64
+
 /**
  * The fallback path for UTS/DFS failing is to just memcpy.  exaCopyDirtyToSys
  * and exaCopyDirtyToFb both needed to do this loop.
@@ -370,6 +379,12 @@ exaDoMoveInPixmap(ExaMigrationPtr migrate)
 
     pExaPixmap->use_gpu_copy = TRUE;
 
+    pExaScr->numMigrationsIn++;
+    if (pExaPixmap->last_moveout_tick != 0 &&
+        pExaScr->migrationTick - pExaPixmap->last_moveout_tick <=
+        EXA_MIGRATION_THRASH_WINDOW)
+        pExaScr->numMigrationThrashes++;
+
     pPixmap->devKind = pExaPixmap->fb_pitch;
     pPixmap->drawable.serialNumber = NEXT_SERIAL_NUMBER;
 }
@@ -394,6 +409,7 @@ exaDoMoveOutPixmap(ExaMigrationPtr migrate)
 {
     PixmapPtr pPixmap = migrate->pPix;
 
+    ExaScreenPriv(pPixmap->drawable.pScreen);
     ExaPixmapPriv(pPixmap);
 
     if (!pExaPixmap->area || exaPixmapIsPinned(pPixmap))
@@ -412,6 +428,9 @@ exaDoMoveOutPixmap(ExaMigrationPtr migrate)
 
         pExaPixmap->use_gpu_copy = FALSE;
 
+        pExaScr->numMigrationsOut++;
+        pExaPixmap->last_moveout_tick = pExaScr->migrationTick;
+
         pPixmap->devKind = pExaPixmap->sys_pitch;
         pPixmap->drawable.serialNumber = NEXT_SERIAL_NUMBER;
     }
@@ -450,6 +469,19 @@ exaPixmapSave(ScreenPtr pScreen, ExaOffscreenArea * area)
     RegionEmpty(&pExaPixmap->validFB);
 }
 
+static void
+exaDecayPixmapScore(PixmapPtr pPixmap)
+{
+    ExaScreenPriv(pPixmap->drawable.pScreen);
+    ExaPixmapPriv(pPixmap);
+    unsigned idle = (pExaScr->migrationTick - pExaPixmap->last_score_tick)
+        >> EXA_SCORE_DECAY_INTERVAL_SHIFT;
+
+    pExaPixmap->last_score_tick = pExaScr->migrationTick;
+    for (; idle > 0 && pExaPixmap->score != 0; idle--)
+        pExaPixmap->score /= 2;
+}
+
 /**
  * For the "greedy" migration scheme, pushes the pixmap toward being located in
  * framebuffer memory.
@@ -475,6 +507,8 @@ exaMigrateTowardFb(ExaMigrationPtr migrate)
         pExaPixmap->score = 0;
     }
 
+    exaDecayPixmapScore(pPixmap);
+
     if (pExaPixmap->score < EXA_PIXMAP_SCORE_MAX)
         pExaPixmap->score++;
 
@@ -511,6 +545,8 @@ exaMigrateTowardSys(ExaMigrationPtr migrate)
     if (pExaPixmap->score == EXA_PIXMAP_SCORE_INIT)
         pExaPixmap->score = 0;
 
+    exaDecayPixmapScore(pPixmap);
+
     if (pExaPixmap->score > EXA_PIXMAP_SCORE_MIN)
         pExaPixmap->score--;
 
@@ -614,6 +650,8 @@ exaDoMigration_classic(ExaMigrationPtr pixmaps, int npixmaps, Bool can_accel)
     ExaScreenPriv(pScreen);
     int i, j;
 
+    pExaScr->migrationTick++;
+
     /* If this debugging flag is set, check each pixmap for whether it is marked
      * as clean, and if so, actually check if that's the case.  This should help
      * catch issues with failing to mark a drawable as dirty.  While it will
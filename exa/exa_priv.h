@@ -171,6 +171,13 @@ typedef struct {
 
     Bool swappedOut;
     enum ExaMigrationHeuristic migration;
+    /* Bumped once per migration call; drives score decay and thrash
+     * accounting in exa_migration_classic.c.
+     */
+    unsigned migrationTick;
+    unsigned numMigrationsIn;
+    unsigned numMigrationsOut;
+    unsigned numMigrationThrashes;
     Bool checkDirtyCorrectness;
     unsigned disableFbCount;
     Bool optimize_migration;
@@ -274,6 +281,8 @@ extern DevPrivateKeyRec exaScreenPrivateKeyRec;
 typedef struct {
     ExaOffscreenArea *area;
     int score;                  /**< score for the move-in vs move-out heuristic */
+    unsigned last_score_tick;   /**< migration tick of the last score update */
+    unsigned last_moveout_tick; /**< migration tick of the last move-out */
     Bool use_gpu_copy;
 
     CARD8 *sys_ptr;             /**< pointer to pixmap data in system memory */
@@ -248,8 +248,10 @@ typedef void (*FinishWrapProcPtr) (DrawablePtr pDraw);
 
 #endif
 
-extern _X_EXPORT DevPrivateKey
-fbGetScreenPrivateKey(void);
+/* pooled pixmap allocations, size-classed by total block size:
+ * 1KB << class, retained FB_PIXMAP_POOL_DEPTH deep per class */
+#define FB_PIXMAP_POOL_CLASSES  7
+#define FB_PIXMAP_POOL_DEPTH    16
 
 /* private field of a screen */
 typedef struct {
@@ -258,11 +260,13 @@ typedef struct {
     FinishWrapProcPtr finishWrap; /* driver hook to clean up pixmap access wrapping */
 #endif
     DevPrivateKeyRec    gcPrivateKeyRec;
-    DevPrivateKeyRec    winPrivateKeyRec;
+    void *pixmapPool[FB_PIXMAP_POOL_CLASSES];  /* free blocks, linked
+                                                  through their first word */
+    int pixmapPoolCount[FB_PIXMAP_POOL_CLASSES];
 } FbScreenPrivRec, *FbScreenPrivPtr;
 
 #define fbGetScreenPrivate(pScreen) ((FbScreenPrivPtr) \
-				     dixLookupPrivate(&(pScreen)->devPrivates, fbGetScreenPrivateKey()))
+				     dixGetFixedPrivate(&(pScreen)->devPrivates, FIXED_PRIVATE_FB))
 
 /* private field of GC */
 typedef struct {
@@ -274,10 +278,8 @@ typedef struct {
 
 #define fbGetCompositeClip(pGC) ((pGC)->pCompositeClip)
 
-#define fbGetWinPrivateKey(pWin)        (&fbGetScreenPrivate(((DrawablePtr) (pWin))->pScreen)->winPrivateKeyRec)
-
 #define fbGetWindowPixmap(pWin)	((PixmapPtr)\
-				 dixLookupPrivate(&((WindowPtr)(pWin))->devPrivates, fbGetWinPrivateKey(pWin)))
+				 dixGetFixedPrivate(&((WindowPtr)(pWin))->devPrivates, FIXED_PRIVATE_FB))
 
 #define __fbPixDrawableX(pPix)	((pPix)->drawable.x)
 #define __fbPixDrawableY(pPix)	((pPix)->drawable.y)
@@ -779,6 +781,9 @@ extern _X_EXPORT Bool
 extern _X_EXPORT void
 fbDestroyGlyphCache(void);
 
+extern _X_EXPORT void
+fbDestroySourceCache(void);
+
 /*
  * fbpixmap.c
  */
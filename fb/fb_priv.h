@@ -37,4 +37,24 @@ static inline void fbValidateDrawable(DrawablePtr d) {}
 Bool fbAllocatePrivates(ScreenPtr pScreen);
 int  fbListInstalledColormaps(ScreenPtr pScreen, Colormap* pmaps);
 
+/* Solid fill of one clipped box against already-fetched drawable state,
+ * using the GC's reduced and/xor from fbValidateGC; shared by the
+ * batched rect and span loops so they dispatch once per call instead of
+ * once per box.
+ */
+static inline void
+fbFillBoxSolid(FbBits * dst, FbStride dstStride, int dstBpp,
+               int dstXoff, int dstYoff, FbBits and, FbBits xor,
+               int x, int y, int width, int height)
+{
+#ifndef FB_ACCESS_WRAPPER
+    if (!and && pixman_fill((uint32_t *) dst, dstStride, dstBpp,
+                            x + dstXoff, y + dstYoff, width, height, xor))
+        return;
+#endif
+    fbSolid(dst + (y + dstYoff) * dstStride,
+            dstStride, (x + dstXoff) * dstBpp,
+            dstBpp, width * dstBpp, height, and, xor);
+}
+
 #endif /* XORG_FB_PRIV_H */
@@ -24,14 +24,6 @@
 
 #include "fb/fb_priv.h"
 
-static DevPrivateKeyRec fbScreenPrivateKeyRec;
-
-DevPrivateKey
-fbGetScreenPrivateKey(void)
-{
-    return &fbScreenPrivateKeyRec;
-}
-
 DevPrivateKey
 fbGetGCPrivateKey(GCPtr pGC)
 {
@@ -43,16 +35,16 @@ fbAllocatePrivates(ScreenPtr pScreen)
 {
     FbScreenPrivPtr     pScrPriv;
 
-    if (!dixRegisterPrivateKey
-        (&fbScreenPrivateKeyRec, PRIVATE_SCREEN, sizeof(FbScreenPrivRec)))
-        return FALSE;
-
     pScrPriv = fbGetScreenPrivate(pScreen);
+    if (!pScrPriv) {
+        pScrPriv = calloc(1, sizeof(FbScreenPrivRec));
+        if (!pScrPriv)
+            return FALSE;
+        dixSetFixedPrivate(&pScreen->devPrivates, FIXED_PRIVATE_FB, pScrPriv);
+    }
 
     if (!dixRegisterScreenSpecificPrivateKey (pScreen, &pScrPriv->gcPrivateKeyRec, PRIVATE_GC, sizeof(FbGCPrivRec)))
         return FALSE;
-    if (!dixRegisterScreenSpecificPrivateKey (pScreen, &pScrPriv->winPrivateKeyRec, PRIVATE_WINDOW, 0))
-        return FALSE;
 
     return TRUE;
 }
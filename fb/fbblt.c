@@ -115,6 +115,31 @@ fbBlt(FbBits * srcLine,
 
             return;
         }
+#ifndef FB_ACCESS_WRAPPER
+        /* Overlapping rows: the caller has already picked a row order
+         * (upsidedown) that keeps unread source rows intact, and within
+         * a row memmove is defined for any overlap.  Like memcpy it
+         * resolves to the platform's vectorized implementation, which
+         * beats the shift/mask word loop below by a wide margin on
+         * scrolling blts.
+         */
+        else {
+            int i;
+
+            if (!upsidedown)
+                for (i = 0; i < height; i++)
+                    memmove(dst_byte + i * dst_byte_stride,
+                            src_byte + i * src_byte_stride,
+                            width_byte);
+            else
+                for (i = height - 1; i >= 0; i--)
+                    memmove(dst_byte + i * dst_byte_stride,
+                            src_byte + i * src_byte_stride,
+                            width_byte);
+
+            return;
+        }
+#endif
     }
 
     FbInitializeMergeRop(alu, pm);
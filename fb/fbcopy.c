@@ -24,8 +24,71 @@
 
 #include <stdlib.h>
 
+#include "include/threadpool.h"
+
 #include "fb/fb_priv.h"
 
+#ifndef FB_ACCESS_WRAPPER
+
+/* Copies at least this large (in pixels) are worth fanning out over the
+ * worker pool; smaller ones lose more to the fork-join barrier than the
+ * extra cores return.  A full-screen 4k scroll is ~8M pixels.
+ */
+#define FB_PARALLEL_COPY_PIXELS (1024 * 1024)
+
+typedef struct {
+    FbBits *src;
+    FbBits *dst;
+    FbStride srcStride;
+    FbStride dstStride;
+    int srcBpp;
+    int dstBpp;
+    int srcXoff, srcYoff;
+    int dstXoff, dstYoff;
+    int dx, dy;
+    BoxPtr pbox;
+    int nbox;
+    int nslot;
+} fbCopyBandRec;
+
+/* Each slot copies its share of rows of every box; bands never overlap,
+ * so no locking is needed between slots.
+ */
+static void
+fbCopyBandWorker(void *arg, int slot)
+{
+    fbCopyBandRec *band = arg;
+    BoxPtr pbox = band->pbox;
+    int nbox = band->nbox;
+
+    while (nbox--) {
+        int h = pbox->y2 - pbox->y1;
+        int y1 = pbox->y1 + (h * slot) / band->nslot;
+        int y2 = pbox->y1 + (h * (slot + 1)) / band->nslot;
+
+        if (y2 > y1 &&
+            !pixman_blt((uint32_t *) band->src, (uint32_t *) band->dst,
+                        band->srcStride, band->dstStride,
+                        band->srcBpp, band->dstBpp,
+                        (pbox->x1 + band->dx + band->srcXoff),
+                        (y1 + band->dy + band->srcYoff),
+                        (pbox->x1 + band->dstXoff),
+                        (y1 + band->dstYoff),
+                        (pbox->x2 - pbox->x1), (y2 - y1)))
+            fbBlt(band->src + (y1 + band->dy + band->srcYoff) * band->srcStride,
+                  band->srcStride,
+                  (pbox->x1 + band->dx + band->srcXoff) * band->srcBpp,
+                  band->dst + (y1 + band->dstYoff) * band->dstStride,
+                  band->dstStride,
+                  (pbox->x1 + band->dstXoff) * band->dstBpp,
+                  (pbox->x2 - pbox->x1) * band->dstBpp,
+                  (y2 - y1), GXcopy, FB_ALLONES, band->dstBpp, FALSE, FALSE);
+        pbox++;
+    }
+}
+
+#endif /* !FB_ACCESS_WRAPPER */
+
 void
 fbCopyNtoN(DrawablePtr pSrcDrawable,
            DrawablePtr pDstDrawable,
@@ -49,6 +112,39 @@ fbCopyNtoN(DrawablePtr pSrcDrawable,
     fbGetDrawable(pSrcDrawable, src, srcStride, srcBpp, srcXoff, srcYoff);
     fbGetDrawable(pDstDrawable, dst, dstStride, dstBpp, dstXoff, dstYoff);
 
+#ifndef FB_ACCESS_WRAPPER
+    /* Large non-overlapping straight copies: split the rows across the
+     * worker pool.  Overlapping blits (reverse/upsidedown set by
+     * miCopyRegion) keep the ordered single-threaded path.
+     */
+    if (pm == FB_ALLONES && alu == GXcopy && !reverse && !upsidedown &&
+        ThreadPoolWorkers() > 1) {
+        long area = 0;
+        int i;
+
+        for (i = 0; i < nbox; i++)
+            area += (long) (pbox[i].x2 - pbox[i].x1) *
+                    (pbox[i].y2 - pbox[i].y1);
+        if (area >= FB_PARALLEL_COPY_PIXELS) {
+            fbCopyBandRec band = {
+                .src = src, .dst = dst,
+                .srcStride = srcStride, .dstStride = dstStride,
+                .srcBpp = srcBpp, .dstBpp = dstBpp,
+                .srcXoff = srcXoff, .srcYoff = srcYoff,
+                .dstXoff = dstXoff, .dstYoff = dstYoff,
+                .dx = dx, .dy = dy,
+                .pbox = pbox, .nbox = nbox,
+                .nslot = ThreadPoolWorkers(),
+            };
+
+            ThreadPoolRun(fbCopyBandWorker, &band, band.nslot);
+            fbFinishAccess(pDstDrawable);
+            fbFinishAccess(pSrcDrawable);
+            return;
+        }
+    }
+#endif
+
     while (nbox--) {
 #ifndef FB_ACCESS_WRAPPER       /* pixman_blt() doesn't support accessors yet */
         if (pm == FB_ALLONES && alu == GXcopy && !reverse && !upsidedown) {
@@ -22,7 +22,7 @@
 
 #include <dix-config.h>
 
-#include "fb.h"
+#include "fb/fb_priv.h"
 
 void
 fbPolyFillRect(DrawablePtr pDrawable, GCPtr pGC, int nrect, xRectangle *prect)
@@ -35,6 +35,19 @@ fbPolyFillRect(DrawablePtr pDrawable, GCPtr pGC, int nrect, xRectangle *prect)
     int partX1, partX2, partY1, partY2;
     int xorg, yorg;
     int n;
+    Bool solid = pGC->fillStyle == FillSolid;
+    FbGCPrivPtr pPriv = fbGetGCPrivate(pGC);
+    FbBits *dst = NULL;
+    FbStride dstStride = 0;
+    int dstBpp = 0;
+    int dstXoff = 0, dstYoff = 0;
+
+    /* Toolkits clear backgrounds with thousands of small solid rects
+     * per frame; fetch the drawable state once here instead of once
+     * per rect inside fbFill.
+     */
+    if (solid)
+        fbGetDrawable(pDrawable, dst, dstStride, dstBpp, dstXoff, dstYoff);
 
     xorg = pDrawable->x;
     yorg = pDrawable->y;
@@ -67,8 +80,14 @@ fbPolyFillRect(DrawablePtr pDrawable, GCPtr pGC, int nrect, xRectangle *prect)
             continue;
         n = RegionNumRects(pClip);
         if (n == 1) {
-            fbFill(pDrawable,
-                   pGC, fullX1, fullY1, fullX2 - fullX1, fullY2 - fullY1);
+            if (solid)
+                fbFillBoxSolid(dst, dstStride, dstBpp, dstXoff, dstYoff,
+                               pPriv->and, pPriv->xor,
+                               fullX1, fullY1,
+                               fullX2 - fullX1, fullY2 - fullY1);
+            else
+                fbFill(pDrawable,
+                       pGC, fullX1, fullY1, fullX2 - fullX1, fullY2 - fullY1);
         }
         else {
             pbox = RegionRects(pClip);
@@ -92,10 +111,21 @@ fbPolyFillRect(DrawablePtr pDrawable, GCPtr pGC, int nrect, xRectangle *prect)
 
                 pbox++;
 
-                if (partX1 < partX2 && partY1 < partY2)
-                    fbFill(pDrawable, pGC,
-                           partX1, partY1, partX2 - partX1, partY2 - partY1);
+                if (partX1 < partX2 && partY1 < partY2) {
+                    if (solid)
+                        fbFillBoxSolid(dst, dstStride, dstBpp,
+                                       dstXoff, dstYoff,
+                                       pPriv->and, pPriv->xor,
+                                       partX1, partY1,
+                                       partX2 - partX1, partY2 - partY1);
+                    else
+                        fbFill(pDrawable, pGC,
+                               partX1, partY1,
+                               partX2 - partX1, partY2 - partY1);
+                }
             }
         }
     }
+    if (solid)
+        fbFinishAccess(pDrawable);
 }
@@ -22,7 +22,7 @@
 
 #include <dix-config.h>
 
-#include "fb.h"
+#include "fb/fb_priv.h"
 
 void
 fbFillSpans(DrawablePtr pDrawable,
@@ -34,6 +34,17 @@ fbFillSpans(DrawablePtr pDrawable,
     int extentX1, extentX2, extentY1, extentY2;
     int fullX1, fullX2, fullY1;
     int partX1, partX2;
+    Bool solid = pGC->fillStyle == FillSolid;
+    FbGCPrivPtr pPriv = fbGetGCPrivate(pGC);
+    FbBits *dst = NULL;
+    FbStride dstStride = 0;
+    int dstBpp = 0;
+    int dstXoff = 0, dstYoff = 0;
+
+    /* spans come thousands at a time from the scan converter; resolve
+     * the drawable and the GC's reduced rop once instead of per span */
+    if (solid)
+        fbGetDrawable(pDrawable, dst, dstStride, dstBpp, dstXoff, dstYoff);
 
     pextent = RegionExtents(pClip);
     extentX1 = pextent->x1;
@@ -61,7 +72,12 @@ fbFillSpans(DrawablePtr pDrawable,
 
         nbox = RegionNumRects(pClip);
         if (nbox == 1) {
-            fbFill(pDrawable, pGC, fullX1, fullY1, fullX2 - fullX1, 1);
+            if (solid)
+                fbFillBoxSolid(dst, dstStride, dstBpp, dstXoff, dstYoff,
+                               pPriv->and, pPriv->xor,
+                               fullX1, fullY1, fullX2 - fullX1, 1);
+            else
+                fbFill(pDrawable, pGC, fullX1, fullY1, fullX2 - fullX1, 1);
         }
         else {
             pbox = RegionRects(pClip);
@@ -74,12 +90,20 @@ fbFillSpans(DrawablePtr pDrawable,
                     if (partX2 > fullX2)
                         partX2 = fullX2;
                     if (partX2 > partX1) {
-                        fbFill(pDrawable, pGC,
-                               partX1, fullY1, partX2 - partX1, 1);
+                        if (solid)
+                            fbFillBoxSolid(dst, dstStride, dstBpp,
+                                           dstXoff, dstYoff,
+                                           pPriv->and, pPriv->xor,
+                                           partX1, fullY1, partX2 - partX1, 1);
+                        else
+                            fbFill(pDrawable, pGC,
+                                   partX1, fullY1, partX2 - partX1, 1);
                     }
                 }
                 pbox++;
             }
         }
     }
+    if (solid)
+        fbFinishAccess(pDrawable);
 }
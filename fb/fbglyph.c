@@ -23,6 +23,8 @@
 
 #include <dix-config.h>
 
+#include <limits.h>
+
 #include <X11/fonts/fontstruct.h>
 
 #include "fb/fb_priv.h"
@@ -52,6 +54,42 @@ fbGlyphIn(RegionPtr pRegion, int x, int y, int width, int height)
     return RegionContainsRect(pRegion, &box) == rgnIN;
 }
 
+/*
+ * One containment test for a whole text run: when the union of the
+ * glyph boxes sits inside the clip, the per-glyph fbGlyphIn calls can
+ * be skipped, which is the common case for terminal repaints.
+ */
+static Bool
+fbGlyphRunIn(RegionPtr pRegion, int x, int y,
+             unsigned int nglyph, CharInfoPtr * ppci)
+{
+    int x1 = INT_MAX, y1 = INT_MAX, x2 = INT_MIN, y2 = INT_MIN;
+
+    while (nglyph--) {
+        CharInfoPtr pci = *ppci++;
+        int gWidth = GLYPHWIDTHPIXELS(pci);
+        int gHeight = GLYPHHEIGHTPIXELS(pci);
+
+        if (gWidth && gHeight) {
+            int gx = x + pci->metrics.leftSideBearing;
+            int gy = y - pci->metrics.ascent;
+
+            if (gx < x1)
+                x1 = gx;
+            if (gy < y1)
+                y1 = gy;
+            if (gx + gWidth > x2)
+                x2 = gx + gWidth;
+            if (gy + gHeight > y2)
+                y2 = gy + gHeight;
+        }
+        x += pci->metrics.characterWidth;
+    }
+    if (x2 <= x1)
+        return FALSE;
+    return fbGlyphIn(pRegion, x1, y1, x2 - x1, y2 - y1);
+}
+
 void
 fbPolyGlyphBlt(DrawablePtr pDrawable,
                GCPtr pGC,
@@ -70,6 +108,8 @@ fbPolyGlyphBlt(DrawablePtr pDrawable,
     FbStride dstStride = 0;
     int dstBpp = 0;
     int dstXoff = 0, dstYoff = 0;
+    RegionPtr pClip;
+    Bool runIn = FALSE;
 
     glyph = 0;
     if (pGC->fillStyle == FillSolid && pPriv->and == 0) {
@@ -89,6 +129,10 @@ fbPolyGlyphBlt(DrawablePtr pDrawable,
     x += pDrawable->x;
     y += pDrawable->y;
 
+    pClip = fbGetCompositeClip(pGC);
+    if (glyph)
+        runIn = fbGlyphRunIn(pClip, x, y, nglyph, ppci);
+
     while (nglyph--) {
         pci = *ppci++;
         pglyph = FONTGLYPHBITS(pglyphBase, pci);
@@ -98,12 +142,22 @@ fbPolyGlyphBlt(DrawablePtr pDrawable,
             gx = x + pci->metrics.leftSideBearing;
             gy = y - pci->metrics.ascent;
             if (glyph && gWidth <= sizeof(FbStip) * 8 &&
-                fbGlyphIn(fbGetCompositeClip(pGC), gx, gy, gWidth, gHeight)) {
+                (runIn || fbGlyphIn(pClip, gx, gy, gWidth, gHeight))) {
+                /* with accessors the wrap must bracket each write so it
+                 * can't straddle fbPushImage's own prepare/finish */
+#ifdef FB_ACCESS_WRAPPER
                 fbGetDrawable(pDrawable, dst, dstStride, dstBpp, dstXoff,
                               dstYoff);
+#else
+                if (!dst)
+                    fbGetDrawable(pDrawable, dst, dstStride, dstBpp, dstXoff,
+                                  dstYoff);
+#endif
                 (*glyph) (dst + (gy + dstYoff) * dstStride, dstStride, dstBpp,
                           (FbStip *) pglyph, pPriv->xor, gx + dstXoff, gHeight);
+#ifdef FB_ACCESS_WRAPPER
                 fbFinishAccess(pDrawable);
+#endif
             }
             else {
                 gStride = GLYPHWIDTHBYTESPADDED(pci) / sizeof(FbStip);
@@ -138,6 +192,8 @@ fbImageGlyphBlt(DrawablePtr pDrawable,
     FbStride dstStride = 0;
     int dstBpp = 0;
     int dstXoff = 0, dstYoff = 0;
+    RegionPtr pClip;
+    Bool runIn = FALSE;
 
     glyph = 0;
     if (pPriv->and == 0) {
@@ -158,6 +214,10 @@ fbImageGlyphBlt(DrawablePtr pDrawable,
     x += pDrawable->x;
     y += pDrawable->y;
 
+    pClip = fbGetCompositeClip(pGC);
+    if (glyph)
+        runIn = fbGlyphRunIn(pClip, x, y, nglyph, ppciInit);
+
     if (TERMINALFONT(pGC->font)
         && !glyph) {
         opaque = TRUE;
@@ -180,7 +240,7 @@ fbImageGlyphBlt(DrawablePtr pDrawable,
         yBack = y - FONTASCENT(pGC->font);
         heightBack = FONTASCENT(pGC->font) + FONTDESCENT(pGC->font);
         fbSolidBoxClipped(pDrawable,
-                          fbGetCompositeClip(pGC),
+                          pClip,
                           xBack,
                           yBack,
                           xBack + widthBack,
@@ -200,17 +260,25 @@ fbImageGlyphBlt(DrawablePtr pDrawable,
             gx = x + pci->metrics.leftSideBearing;
             gy = y - pci->metrics.ascent;
             if (glyph && gWidth <= sizeof(FbStip) * 8 &&
-                fbGlyphIn(fbGetCompositeClip(pGC), gx, gy, gWidth, gHeight)) {
+                (runIn || fbGlyphIn(pClip, gx, gy, gWidth, gHeight))) {
+#ifdef FB_ACCESS_WRAPPER
                 fbGetDrawable(pDrawable, dst, dstStride, dstBpp, dstXoff,
                               dstYoff);
+#else
+                if (!dst)
+                    fbGetDrawable(pDrawable, dst, dstStride, dstBpp, dstXoff,
+                                  dstYoff);
+#endif
                 (*glyph) (dst + (gy + dstYoff) * dstStride, dstStride, dstBpp,
                           (FbStip *) pglyph, pPriv->fg, gx + dstXoff, gHeight);
+#ifdef FB_ACCESS_WRAPPER
                 fbFinishAccess(pDrawable);
+#endif
             }
             else {
                 gStride = GLYPHWIDTHBYTESPADDED(pci) / sizeof(FbStip);
                 fbPutXYImage(pDrawable,
-                             fbGetCompositeClip(pGC),
+                             pClip,
                              pPriv->fg,
                              pPriv->bg,
                              pPriv->pm,
@@ -106,6 +106,23 @@ fbPutZImage(DrawablePtr pDrawable,
             y2 = pbox->y2;
         if (x1 >= x2 || y1 >= y2)
             continue;
+#ifndef FB_ACCESS_WRAPPER       /* pixman_blt() doesn't support accessors yet */
+        /* straight same-depth stores direct from the source buffer -
+         * for ShmPutImage that's a single vectorized copy out of the
+         * client's segment with no staging */
+        if (alu == GXcopy && pm == FB_ALLONES &&
+            (dstBpp == 8 || dstBpp == 16 || dstBpp == 32)) {
+            if (!pixman_blt((uint32_t *) src, (uint32_t *) dst,
+                            srcStride, dstStride, dstBpp, dstBpp,
+                            (x1 - x), (y1 - y),
+                            (x1 + dstXoff), (y1 + dstYoff),
+                            (x2 - x1), (y2 - y1)))
+                goto fallback;
+            else
+                continue;
+        }
+ fallback:
+#endif
         fbBltStip(src + (y1 - y) * srcStride,
                   srcStride,
                   (x1 - x) * dstBpp,
@@ -59,7 +59,7 @@ fbOverlayCreateWindow(WindowPtr pWin)
     for (i = 0; i < pScrPriv->nlayers; i++) {
         pPixmap = pScrPriv->layer[i].u.run.pixmap;
         if (pWin->drawable.depth == pPixmap->drawable.depth) {
-            dixSetPrivate(&pWin->devPrivates, fbGetWinPrivateKey(pWin), pPixmap);
+            dixSetFixedPrivate(&pWin->devPrivates, FIXED_PRIVATE_FB, pPixmap);
             /*
              * Make sure layer keys are written correctly by
              * having non-root layers set to full while the
@@ -99,7 +99,7 @@ fbOverlayWindowLayer(WindowPtr pWin)
     int i;
 
     for (i = 0; i < pScrPriv->nlayers; i++)
-        if (dixLookupPrivate(&pWin->devPrivates, fbGetWinPrivateKey(pWin)) ==
+        if (dixGetFixedPrivate(&pWin->devPrivates, FIXED_PRIVATE_FB) ==
             (void *) pScrPriv->layer[i].u.run.pixmap)
             return i;
     return 0;
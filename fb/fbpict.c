@@ -27,6 +27,8 @@
 
 #include <string.h>
 
+#include "include/threadpool.h"
+
 #include "fb/fbpict_priv.h"
 
 #include "fb.h"
@@ -34,6 +36,57 @@
 #include "picturestr.h"
 #include "mipict.h"
 
+/* destination area at which banding a filtered composite pays off */
+#define FB_PARALLEL_FILTER_PIXELS (128 * 1024)
+
+typedef struct {
+    CARD8 op;
+    pixman_image_t *src, *mask, *dest;
+    int xSrc, ySrc;
+    int xMask, yMask;
+    int xDst, yDst;
+    int width, height;
+    int nslot;
+} fbCompositeBandRec;
+
+/* Bands partition the destination rows, so any operator is safe; the
+ * source and mask offsets shift with the band, which keeps the
+ * transform mapping identical to the single whole-area composite.
+ */
+static void
+fbCompositeBandWorker(void *arg, int slot)
+{
+    fbCompositeBandRec *band = arg;
+    int y1 = (band->height * slot) / band->nslot;
+    int y2 = (band->height * (slot + 1)) / band->nslot;
+
+    if (y2 > y1)
+        pixman_image_composite(band->op, band->src, band->mask, band->dest,
+                               band->xSrc, band->ySrc + y1,
+                               band->xMask, band->yMask + y1,
+                               band->xDst, band->yDst + y1,
+                               band->width, y2 - y1);
+}
+
+/* transformed or convolved pictures run pixman's general path, which
+ * is where large fallback composites burn their time; an integer
+ * translation still hits the blit fast paths and is not worth banding */
+static Bool
+fbCompositeIsExpensive(PicturePtr pict)
+{
+    if (!pict)
+        return FALSE;
+    if (pict->filter == PictFilterConvolution)
+        return TRUE;
+    if (!pict->transform)
+        return FALSE;
+    if (pict->transformType == PictTransformTypeTranslate &&
+        !pixman_fixed_frac(pict->transform->matrix[0][2]) &&
+        !pixman_fixed_frac(pict->transform->matrix[1][2]))
+        return FALSE;
+    return TRUE;
+}
+
 void
 fbComposite(CARD8 op,
             PicturePtr pSrc,
@@ -58,6 +111,30 @@ fbComposite(CARD8 op,
     dest = image_from_pict(pDst, TRUE, &dst_xoff, &dst_yoff);
 
     if (src && dest && !(pMask && !mask)) {
+#ifndef FB_ACCESS_WRAPPER
+        if (ThreadPoolWorkers() > 1 &&
+            (long) width * height >= FB_PARALLEL_FILTER_PIXELS &&
+            (fbCompositeIsExpensive(pSrc) || fbCompositeIsExpensive(pMask))) {
+            fbCompositeBandRec band = {
+                .op = op,
+                .src = src, .mask = mask, .dest = dest,
+                .xSrc = xSrc + src_xoff, .ySrc = ySrc + src_yoff,
+                .xMask = xMask + msk_xoff, .yMask = yMask + msk_yoff,
+                .xDst = xDst + dst_xoff, .yDst = yDst + dst_yoff,
+                .width = width, .height = height,
+                .nslot = ThreadPoolWorkers(),
+            };
+
+            /* Degenerate composite: makes pixman evaluate the lazy
+             * per-image state (flags, fast-path selection inputs) on
+             * this thread, so the band workers only read it.
+             */
+            pixman_image_composite(op, src, mask, dest,
+                                   0, 0, 0, 0, 0, 0, 0, 0);
+            ThreadPoolRun(fbCompositeBandWorker, &band, band.nslot);
+        }
+        else
+#endif
         pixman_image_composite(op, src, mask, dest,
                                xSrc + src_xoff, ySrc + src_yoff,
                                xMask + msk_xoff, yMask + msk_yoff,
@@ -175,6 +252,10 @@ fbGlyphs(CARD8 op,
 	list++;
     }
 
+    /* runs of blank glyphs (spaces) leave nothing to composite */
+    if (!n_glyphs)
+	goto out;
+
     if (!(srcImage = image_from_pict(pSrc, FALSE, &srcXoff, &srcYoff)))
 	goto out;
 
@@ -215,6 +296,50 @@ out:
 	free(pglyphs);
 }
 
+/* The mi fallback turns each blended rectangle into a CompositePicture
+ * call, re-creating the solid source and destination images every time.
+ * Build both once and loop the per-rectangle composites inside pixman;
+ * Src/Clear (and opaque Over) still take mi's GC fill path, which
+ * beats compositing entirely.
+ */
+static void
+fbCompositeRects(CARD8 op,
+                 PicturePtr pDst,
+                 xRenderColor * color, int nRect, xRectangle *rects)
+{
+    pixman_image_t *solid, *dest;
+    int dst_xoff, dst_yoff;
+    int i;
+
+    if (color->alpha == 0xffff && op == PictOpOver)
+        op = PictOpSrc;
+
+    if (op == PictOpSrc || op == PictOpClear) {
+        miCompositeRects(op, pDst, color, nRect, rects);
+        return;
+    }
+    if (op == PictOpDst)
+        return;
+
+    /* pixman_color_t and xRenderColor have the same layout */
+    solid = pixman_image_create_solid_fill((pixman_color_t *) color);
+    if (!solid)
+        return;
+
+    dest = image_from_pict(pDst, TRUE, &dst_xoff, &dst_yoff);
+    if (dest) {
+        for (i = 0; i < nRect; i++)
+            pixman_image_composite(op, solid, NULL, dest,
+                                   0, 0, 0, 0,
+                                   rects[i].x + dst_xoff,
+                                   rects[i].y + dst_yoff,
+                                   rects[i].width, rects[i].height);
+        free_pixman_pict(pDst, dest);
+    }
+
+    pixman_image_unref(solid);
+}
+
 static pixman_image_t *
 create_solid_fill_image(PicturePtr pict)
 {
@@ -277,6 +402,161 @@ create_conical_gradient_image(PictGradient * gradient)
                                                 gradient->nstops);
 }
 
+/* Toolkits create and destroy identical solid and gradient pictures on
+ * every widget paint, so the pixman source image gets rebuilt - stops
+ * copied and all - for each composite.  Keep a small MRU list of
+ * realized source images keyed by the pattern parameters and stop
+ * vector.  An entry is only shared while it is idle: properties
+ * (transform, repeat, filter) are reapplied per checkout, so two
+ * simultaneous users could trample each other.  free_pixman_pict() is
+ * the one release path in fb, which is where checkouts are returned.
+ */
+#define FB_SOURCE_CACHE_SIZE 32
+
+typedef struct fb_source_cache_entry {
+    struct fb_source_cache_entry *next;
+    unsigned char *key;
+    size_t keylen;
+    pixman_image_t *image;
+    int out;                    /* handed-out references */
+} fb_source_cache_entry;
+
+static fb_source_cache_entry *sourceCache;
+
+static unsigned char *
+source_pict_key(SourcePict * sp, size_t *keylen)
+{
+    PictGradient *gradient = &sp->gradient;
+    const void *params;
+    size_t paramlen, stoplen = 0;
+    unsigned char *key;
+    CARD32 type = sp->type;
+
+    switch (sp->type) {
+    case SourcePictTypeSolidFill:
+        params = &sp->solidFill.fullcolor;
+        paramlen = sizeof(sp->solidFill.fullcolor);
+        break;
+    case SourcePictTypeLinear:
+        params = &sp->linear.p1;
+        paramlen = sizeof(sp->linear.p1) + sizeof(sp->linear.p2);
+        break;
+    case SourcePictTypeRadial:
+        params = &sp->radial.c1;
+        paramlen = sizeof(sp->radial.c1) + sizeof(sp->radial.c2);
+        break;
+    case SourcePictTypeConical:
+        params = &sp->conical.center;
+        paramlen = sizeof(sp->conical.center) + sizeof(sp->conical.angle);
+        break;
+    default:
+        return NULL;
+    }
+
+    if (sp->type != SourcePictTypeSolidFill)
+        stoplen = gradient->nstops * sizeof(PictGradientStop);
+
+    *keylen = sizeof(type) + paramlen + stoplen;
+    key = malloc(*keylen);
+    if (!key)
+        return NULL;
+    memcpy(key, &type, sizeof(type));
+    memcpy(key + sizeof(type), params, paramlen);
+    if (stoplen)
+        memcpy(key + sizeof(type) + paramlen, gradient->stops, stoplen);
+    return key;
+}
+
+static void
+source_cache_trim(void)
+{
+    fb_source_cache_entry **prev = &sourceCache;
+    int n = 0;
+
+    while (*prev) {
+        if (++n > FB_SOURCE_CACHE_SIZE && !(*prev)->out) {
+            fb_source_cache_entry *e = *prev;
+
+            *prev = e->next;
+            pixman_image_unref(e->image);
+            free(e->key);
+            free(e);
+        }
+        else
+            prev = &(*prev)->next;
+    }
+}
+
+static pixman_image_t *
+create_source_image(PicturePtr pict)
+{
+    SourcePict *sp = pict->pSourcePict;
+
+    if (sp->type == SourcePictTypeSolidFill)
+        return create_solid_fill_image(pict);
+    if (sp->type == SourcePictTypeLinear)
+        return create_linear_gradient_image(&sp->gradient);
+    if (sp->type == SourcePictTypeRadial)
+        return create_radial_gradient_image(&sp->gradient);
+    if (sp->type == SourcePictTypeConical)
+        return create_conical_gradient_image(&sp->gradient);
+    return NULL;
+}
+
+static pixman_image_t *
+source_image_from_pict(PicturePtr pict)
+{
+    fb_source_cache_entry **prev, *e;
+    pixman_image_t *image;
+    unsigned char *key;
+    size_t keylen;
+
+    key = source_pict_key(pict->pSourcePict, &keylen);
+    if (key) {
+        for (prev = &sourceCache; (e = *prev); prev = &e->next) {
+            if (e->out || e->keylen != keylen || memcmp(e->key, key, keylen))
+                continue;
+            *prev = e->next;
+            e->next = sourceCache;
+            sourceCache = e;
+            e->out++;
+            free(key);
+            return pixman_image_ref(e->image);
+        }
+    }
+
+    image = create_source_image(pict);
+    if (image && key) {
+        e = calloc(1, sizeof(*e));
+        if (e) {
+            e->key = key;
+            e->keylen = keylen;
+            e->image = pixman_image_ref(image);
+            e->out = 1;
+            e->next = sourceCache;
+            sourceCache = e;
+            source_cache_trim();
+            return image;
+        }
+    }
+    free(key);
+    return image;
+}
+
+void
+fbDestroySourceCache(void)
+{
+    fb_source_cache_entry *e, *next;
+
+    for (e = sourceCache; e; e = next) {
+        next = e->next;
+        pixman_image_unref(e->image);
+        free(e->key);
+        free(e);
+    }
+    sourceCache = NULL;
+}
+
 static pixman_image_t *
 create_bits_picture(PicturePtr pict, Bool has_clip, int *xoff, int *yoff)
 {
@@ -367,6 +647,10 @@ set_image_properties(pixman_image_t * image, PicturePtr pict, Bool has_clip,
         else
             pixman_image_set_transform(image, pict->transform);
     }
+    else {
+        /* cached source images may carry a previous user's transform */
+        pixman_image_set_transform(image, NULL);
+    }
 
     switch (pict->repeatType) {
     default:
@@ -403,6 +687,8 @@ set_image_properties(pixman_image_t * image, PicturePtr pict, Bool has_clip,
 
         free_pixman_pict(pict->alphaMap, alpha_map);
     }
+    else
+        pixman_image_set_alpha_map(image, NULL, 0, 0);
 
     pixman_image_set_component_alpha(image, pict->componentAlpha);
 
@@ -446,21 +732,7 @@ image_from_pict_internal(PicturePtr pict, Bool has_clip, int *xoff, int *yoff,
         image = create_bits_picture(pict, has_clip, xoff, yoff);
     }
     else if (pict->pSourcePict) {
-        SourcePict *sp = pict->pSourcePict;
-
-        if (sp->type == SourcePictTypeSolidFill) {
-            image = create_solid_fill_image(pict);
-        }
-        else {
-            PictGradient *gradient = &pict->pSourcePict->gradient;
-
-            if (sp->type == SourcePictTypeLinear)
-                image = create_linear_gradient_image(gradient);
-            else if (sp->type == SourcePictTypeRadial)
-                image = create_radial_gradient_image(gradient);
-            else if (sp->type == SourcePictTypeConical)
-                image = create_conical_gradient_image(gradient);
-        }
+        image = source_image_from_pict(pict);
         *xoff = *yoff = 0;
     }
 
@@ -479,8 +751,22 @@ image_from_pict(PicturePtr pict, Bool has_clip, int *xoff, int *yoff)
 void
 free_pixman_pict(PicturePtr pict, pixman_image_t * image)
 {
-    if (image)
-        pixman_image_unref(image);
+    fb_source_cache_entry *e;
+
+    if (!image)
+        return;
+
+    /* return a cached source image so it can be shared again */
+    if (pict && !pict->pDrawable && pict->pSourcePict) {
+        for (e = sourceCache; e; e = e->next) {
+            if (e->image == image && e->out) {
+                e->out--;
+                break;
+            }
+        }
+    }
+
+    pixman_image_unref(image);
 }
 
 Bool
@@ -495,7 +781,7 @@ fbPictureInit(ScreenPtr pScreen, PictFormatPtr formats, int nformats)
     ps->Composite = fbComposite;
     ps->Glyphs = fbGlyphs;
     ps->UnrealizeGlyph = fbUnrealizeGlyph;
-    ps->CompositeRects = miCompositeRects;
+    ps->CompositeRects = fbCompositeRects;
     ps->RasterizeTrapezoid = fbRasterizeTrapezoid;
     ps->Trapezoids = fbTrapezoids;
     ps->AddTraps = fbAddTraps;
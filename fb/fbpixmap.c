@@ -30,6 +30,31 @@
 static void fbInitializeDrawable(DrawablePtr pDrawable);
 #endif
 
+/* pixel data alignment; matches the widest vector stores the blt
+ * kernels can issue */
+#define FB_DATA_ALIGN   64
+
+#ifndef FB_DEBUG
+
+#define FB_PIXMAP_POOL_MIN 1024
+
+/* size class whose block (FB_PIXMAP_POOL_MIN << class) holds `total`
+ * bytes, or -1 when the allocation is too large to pool */
+static int
+fbPixmapPoolClass(size_t total)
+{
+    size_t size = FB_PIXMAP_POOL_MIN;
+    int class = 0;
+
+    while (size < total && class < FB_PIXMAP_POOL_CLASSES) {
+        size <<= 1;
+        class++;
+    }
+    return class < FB_PIXMAP_POOL_CLASSES ? class : -1;
+}
+
+#endif /* !FB_DEBUG */
+
 PixmapPtr
 fbCreatePixmap(ScreenPtr pScreen, int width, int height, int depth,
                unsigned usage_hint)
@@ -37,25 +62,49 @@ fbCreatePixmap(ScreenPtr pScreen, int width, int height, int depth,
     PixmapPtr pPixmap;
     size_t datasize;
     size_t paddedWidth;
-    int adjust;
     int base;
     int bpp = BitsPerPixel(depth);
 
     paddedWidth = ((width * bpp + FB_MASK) >> FB_SHIFT) * sizeof(FbBits);
     if (paddedWidth / 4 > 32767 || height > 32767)
         return NullPixmap;
-    datasize = height * paddedWidth;
+    datasize = height * paddedWidth + FB_DATA_ALIGN;
     base = pScreen->totalPixmapSize;
-    adjust = 0;
-    if (base & 7)
-        adjust = 8 - (base & 7);
-    datasize += adjust;
 #ifdef FB_DEBUG
     datasize += 2 * paddedWidth;
-#endif
     pPixmap = AllocatePixmap(pScreen, datasize);
     if (!pPixmap)
         return NullPixmap;
+#else
+    {
+        int class = fbPixmapPoolClass(base + datasize);
+        FbScreenPrivPtr pScrPriv = fbGetScreenPrivate(pScreen);
+
+        pPixmap = NULL;
+        if (class >= 0) {
+            size_t total = (size_t) FB_PIXMAP_POOL_MIN << class;
+
+            if (pScrPriv && pScrPriv->pixmapPool[class]) {
+                /* compositors churn thousands of short-lived small
+                 * pixmaps per second; recycle the block, reinitialize
+                 * only the header and leave the pixel data as-is
+                 * (pixmap contents are undefined at creation) */
+                pPixmap = pScrPriv->pixmapPool[class];
+                pScrPriv->pixmapPool[class] = *(void **) pPixmap;
+                pScrPriv->pixmapPoolCount[class]--;
+                memset(pPixmap, 0, base);
+                dixInitScreenPrivates(pScreen, pPixmap, pPixmap + 1,
+                                      PRIVATE_PIXMAP);
+            }
+            else
+                pPixmap = AllocatePixmap(pScreen, total - base);
+        }
+        else
+            pPixmap = AllocatePixmap(pScreen, datasize);
+        if (!pPixmap)
+            return NullPixmap;
+    }
+#endif
     pPixmap->drawable.type = DRAWABLE_PIXMAP;
     pPixmap->drawable.pScreen = pScreen;
     pPixmap->drawable.depth = depth;
@@ -65,7 +114,11 @@ fbCreatePixmap(ScreenPtr pScreen, int width, int height, int depth,
     pPixmap->drawable.height = height;
     pPixmap->devKind = paddedWidth;
     pPixmap->refcnt = 1;
-    pPixmap->devPrivate.ptr = (void *) ((char *) pPixmap + base + adjust);
+    /* align the pixel data so the vector blt/fill kernels see aligned
+     * rows whenever the stride allows */
+    pPixmap->devPrivate.ptr = (void *)
+        (((uintptr_t) pPixmap + base + FB_DATA_ALIGN - 1) &
+         ~((uintptr_t) (FB_DATA_ALIGN - 1)));
     pPixmap->primary_pixmap = NULL;
 
 #ifdef FB_DEBUG
@@ -84,6 +137,32 @@ fbDestroyPixmap(PixmapPtr pPixmap)
 {
     if (--pPixmap->refcnt)
         return TRUE;
+#ifndef FB_DEBUG
+    {
+        ScreenPtr pScreen = pPixmap->drawable.pScreen;
+        FbScreenPrivPtr pScrPriv = fbGetScreenPrivate(pScreen);
+        int base = pScreen->totalPixmapSize;
+        size_t datasize = (size_t) pPixmap->drawable.height *
+            pPixmap->devKind + FB_DATA_ALIGN;
+        int class = fbPixmapPoolClass(base + datasize);
+        void *expected = (void *)
+            (((uintptr_t) pPixmap + base + FB_DATA_ALIGN - 1) &
+             ~((uintptr_t) (FB_DATA_ALIGN - 1)));
+
+        /* only blocks still carrying their original self-contained
+         * layout are recycled; header-modified pixmaps (SHM segments,
+         * driver-backed storage) take the normal free */
+        if (class >= 0 && pScrPriv &&
+            pScrPriv->pixmapPoolCount[class] < FB_PIXMAP_POOL_DEPTH &&
+            pPixmap->devPrivate.ptr == expected) {
+            dixFiniPrivates(pPixmap, PRIVATE_PIXMAP);
+            *(void **) pPixmap = pScrPriv->pixmapPool[class];
+            pScrPriv->pixmapPool[class] = pPixmap;
+            pScrPriv->pixmapPoolCount[class]++;
+            return TRUE;
+        }
+    }
+#endif
     FreePixmap(pPixmap);
     return TRUE;
 }
@@ -34,12 +34,30 @@ fbCloseScreen(ScreenPtr pScreen)
     DepthPtr depths = pScreen->allowedDepths;
 
     fbDestroyGlyphCache();
+    fbDestroySourceCache();
     for (d = 0; d < pScreen->numDepths; d++)
         free(depths[d].vids);
     free(depths);
     free(pScreen->visuals);
     if (pScreen->devPrivate)
         FreePixmap((PixmapPtr)pScreen->devPrivate);
+    {
+        FbScreenPrivPtr pScrPriv = fbGetScreenPrivate(pScreen);
+        int c;
+
+        for (c = 0; c < FB_PIXMAP_POOL_CLASSES; c++) {
+            void *block = pScrPriv->pixmapPool[c];
+
+            while (block) {
+                void *next = *(void **) block;
+
+                free(block);
+                block = next;
+            }
+        }
+    }
+    free(fbGetScreenPrivate(pScreen));
+    dixSetFixedPrivate(&pScreen->devPrivates, FIXED_PRIVATE_FB, NULL);
     return TRUE;
 }
 
@@ -88,7 +106,7 @@ _fbGetWindowPixmap(WindowPtr pWindow)
 void
 _fbSetWindowPixmap(WindowPtr pWindow, PixmapPtr pPixmap)
 {
-    dixSetPrivate(&pWindow->devPrivates, fbGetWinPrivateKey(pWindow), pPixmap);
+    dixSetFixedPrivate(&pWindow->devPrivates, FIXED_PRIVATE_FB, pPixmap);
 }
 
 Bool
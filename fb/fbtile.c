@@ -140,6 +140,65 @@ fbOddTile(FbBits * dst,
     }
 }
 
+#ifndef FB_ACCESS_WRAPPER
+
+/* Width-expansion bounds for fbExpandTile: expand narrow tiles up to
+ * roughly this many bits per row, and never allocate more than
+ * FB_EXPAND_MAX_WORDS for the whole expansion.
+ */
+#define FB_EXPAND_MIN_BITS  1024
+#define FB_EXPAND_MAX_WORDS 8192
+
+static int
+fbGcd(int a, int b)
+{
+    while (b) {
+        int t = a % b;
+
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*
+ * Replicate a narrow tile into a row buffer whose width is a multiple
+ * of both the tile width and FB_UNIT.  fbOddTile then blits big aligned
+ * chunks instead of one shift-and-mask fbBlt per tile repeat, which is
+ * what repeated window-background fills were spending their time on.
+ * Expanding per call instead of caching on the tile pixmap keeps this
+ * correct: nothing reliably bumps a pixmap's serial when Render or SHM
+ * writes to it behind the GC's back.
+ */
+static FbBits *
+fbExpandTile(FbBits * tile,
+             FbStride tileStride,
+             int tileWidth, int tileHeight, int width, int bpp, int *expBits)
+{
+    int period = tileWidth * (FB_UNIT / fbGcd(tileWidth, FB_UNIT));
+    int bits = period;
+    FbStride expStride;
+    FbBits *exp;
+    int i;
+
+    while (bits < FB_EXPAND_MIN_BITS && bits < width)
+        bits += period;
+    expStride = bits >> FB_SHIFT;
+    if (expStride * tileHeight > FB_EXPAND_MAX_WORDS)
+        return NULL;
+    exp = malloc(expStride * tileHeight * sizeof(FbBits));
+    if (!exp)
+        return NULL;
+    for (i = 0; i < bits / tileWidth; i++)
+        fbBlt(tile, tileStride, 0,
+              exp, expStride, i * tileWidth,
+              tileWidth, tileHeight, GXcopy, FB_ALLONES, bpp, FALSE, FALSE);
+    *expBits = bits;
+    return exp;
+}
+
+#endif /* !FB_ACCESS_WRAPPER */
+
 void
 fbTile(FbBits * dst,
        FbStride dstStride,
@@ -154,8 +213,26 @@ fbTile(FbBits * dst,
     if (FbEvenTile(tileWidth))
         fbEvenTile(dst, dstStride, dstX, width, height,
                    tile, tileStride, tileHeight, alu, pm, xRot, yRot);
-    else
+    else {
+#ifndef FB_ACCESS_WRAPPER
+        /* the expanded width is an exact multiple of the tile width, so
+         * the rotation arithmetic in fbOddTile is unchanged */
+        if (tileWidth < FB_EXPAND_MIN_BITS && width >= tileWidth * 4) {
+            int expBits;
+            FbBits *exp = fbExpandTile(tile, tileStride, tileWidth,
+                                       tileHeight, width, bpp, &expBits);
+
+            if (exp) {
+                fbOddTile(dst, dstStride, dstX, width, height,
+                          exp, expBits >> FB_SHIFT, expBits, tileHeight,
+                          alu, pm, bpp, xRot, yRot);
+                free(exp);
+                return;
+            }
+        }
+#endif
         fbOddTile(dst, dstStride, dstX, width, height,
                   tile, tileStride, tileWidth, tileHeight,
                   alu, pm, bpp, xRot, yRot);
+    }
 }
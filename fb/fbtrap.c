@@ -22,6 +22,8 @@
 
 #include <dix-config.h>
 
+#include "include/threadpool.h"
+
 #include "fb/fbpict_priv.h"
 
 #include "fb.h"
@@ -30,6 +32,9 @@
 #include "mipict.h"
 #include "damage.h"
 
+/* trap count at which banded rasterization pays for the pool dispatch */
+#define FB_PARALLEL_TRAPS   32
+
 void
 fbAddTraps(PicturePtr pPicture,
            INT16 x_off, INT16 y_off, int ntrap, xTrap * traps)
@@ -112,18 +117,44 @@ fbShapes(CompositeShapesFunc composite,
 
         if (!maskFormat) {
             int i;
+            Bool batched = FALSE;
 
             if (pDst->polyEdge == PolyEdgeSharp)
                 format = PIXMAN_a1;
             else
                 format = PIXMAN_a8;
 
-            for (i = 0; i < nshapes; ++i) {
-                composite(op, src, dst, format,
-                          xSrc + src_xoff,
-                          ySrc + src_yoff,
-                          dst_xoff, dst_yoff, 1, shapes + i * shape_size);
+            /* Without a maskFormat each shape composites independently,
+             * which normally forces one full clip/setup pass per shape.
+             * When the trapezoids touch pairwise disjoint pixel rows -
+             * the usual output of scan-converting rasterizers - no pixel
+             * sees more than one shape, so for OVER and ADD a single
+             * batched pass produces identical results.
+             */
+            if ((op == PIXMAN_OP_OVER || op == PIXMAN_OP_ADD) &&
+                shape_size == sizeof(xTrapezoid)) {
+                const xTrapezoid *t = (const xTrapezoid *) shapes;
+
+                for (i = 1; i < nshapes; i++)
+                    if (pixman_fixed_to_int(t[i].top) <=
+                        pixman_fixed_to_int(t[i - 1].bottom - pixman_fixed_e))
+                        break;
+                if (i == nshapes) {
+                    composite(op, src, dst, format,
+                              xSrc + src_xoff,
+                              ySrc + src_yoff,
+                              dst_xoff, dst_yoff, nshapes, shapes);
+                    batched = TRUE;
+                }
             }
+
+            if (!batched)
+                for (i = 0; i < nshapes; ++i) {
+                    composite(op, src, dst, format,
+                              xSrc + src_xoff,
+                              ySrc + src_yoff,
+                              dst_xoff, dst_yoff, 1, shapes + i * shape_size);
+                }
         }
         else {
             switch (PIXMAN_FORMAT_A(maskFormat->format)) {
@@ -153,6 +184,138 @@ fbShapes(CompositeShapesFunc composite,
     free_pixman_pict(pDst, dst);
 }
 
+typedef struct {
+    unsigned char *bits;        /* shared a8 mask */
+    int stride;                 /* bytes */
+    int width;
+    int height;
+    int x1, y1;                 /* mask origin in drawable space */
+    int ntrap;
+    const xTrapezoid *traps;
+    int nslot;
+} fbTrapBandRec;
+
+/* Each slot owns a horizontal band of the shared mask and rasterizes
+ * every trapezoid that touches it; bands never overlap, so the workers
+ * write disjoint rows.  The fixed-point edge stepping itself stays in
+ * pixman, which already carries the platform SIMD paths for it.
+ */
+static void
+fbTrapBandWorker(void *arg, int slot)
+{
+    fbTrapBandRec *band = arg;
+    int y1 = (band->height * slot) / band->nslot;
+    int y2 = (band->height * (slot + 1)) / band->nslot;
+    pixman_image_t *image;
+    int i;
+
+    if (y2 <= y1)
+        return;
+
+    image = pixman_image_create_bits(PIXMAN_a8, band->width, y2 - y1,
+                                     (uint32_t *) (band->bits +
+                                                   (size_t) y1 * band->stride),
+                                     band->stride);
+    if (!image)
+        return;
+
+    for (i = 0; i < band->ntrap; i++) {
+        const xTrapezoid *trap = &band->traps[i];
+
+        if (!xTrapezoidValid(trap))
+            continue;
+        if (xFixedToInt(xFixedCeil(trap->bottom)) <= band->y1 + y1 ||
+            xFixedToInt(trap->top) >= band->y1 + y2)
+            continue;
+        pixman_rasterize_trapezoid(image, (pixman_trapezoid_t *) trap,
+                                   -band->x1, -(band->y1 + y1));
+    }
+
+    pixman_image_unref(image);
+}
+
+/* Banded replica of the pixman_composite_trapezoids mask path: build the
+ * whole a8 mask with the worker pool, then composite it in one pass.
+ * Returns FALSE to decline (caller falls back to the serial path);
+ * TRUE means the operation is done, including the fully-clipped case.
+ */
+static Bool
+fbTrapezoidsBanded(CARD8 op,
+                   PicturePtr pSrc,
+                   PicturePtr pDst,
+                   INT16 xSrc, INT16 ySrc, int ntrap, xTrapezoid * traps)
+{
+    pixman_image_t *src, *dst, *mask;
+    int src_xoff, src_yoff;
+    int dst_xoff, dst_yoff;
+    BoxRec bounds;
+    BoxPtr clip = RegionExtents(pDst->pCompositeClip);
+    int width, height, stride;
+    unsigned char *bits;
+    fbTrapBandRec band;
+
+    miTrapezoidBounds(ntrap, traps, &bounds);
+    if (bounds.x1 < clip->x1)
+        bounds.x1 = clip->x1;
+    if (bounds.y1 < clip->y1)
+        bounds.y1 = clip->y1;
+    if (bounds.x2 > clip->x2)
+        bounds.x2 = clip->x2;
+    if (bounds.y2 > clip->y2)
+        bounds.y2 = clip->y2;
+
+    width = bounds.x2 - bounds.x1;
+    height = bounds.y2 - bounds.y1;
+    if (width <= 0 || height <= 0)
+        return TRUE;
+
+    stride = (width + 3) & ~3;
+    bits = calloc(height, stride);
+    if (!bits)
+        return FALSE;
+
+    band = (fbTrapBandRec) {
+        .bits = bits,
+        .stride = stride,
+        .width = width,
+        .height = height,
+        .x1 = bounds.x1,
+        .y1 = bounds.y1,
+        .ntrap = ntrap,
+        .traps = traps,
+        .nslot = ThreadPoolWorkers(),
+    };
+    ThreadPoolRun(fbTrapBandWorker, &band, band.nslot);
+
+    mask = pixman_image_create_bits(PIXMAN_a8, width, height,
+                                    (uint32_t *) bits, stride);
+
+    miCompositeSourceValidate(pSrc);
+
+    src = image_from_pict(pSrc, FALSE, &src_xoff, &src_yoff);
+    dst = image_from_pict(pDst, TRUE, &dst_xoff, &dst_yoff);
+
+    if (src && dst && mask) {
+        DamageRegionAppend(pDst->pDrawable, pDst->pCompositeClip);
+
+        pixman_image_composite(op, src, mask, dst,
+                               xSrc + src_xoff + bounds.x1,
+                               ySrc + src_yoff + bounds.y1,
+                               0, 0,
+                               dst_xoff + bounds.x1,
+                               dst_yoff + bounds.y1, width, height);
+
+        DamageRegionProcessPending(pDst->pDrawable);
+    }
+
+    free_pixman_pict(pSrc, src);
+    free_pixman_pict(pDst, dst);
+    if (mask)
+        pixman_image_unref(mask);
+    free(bits);
+    return TRUE;
+}
+
 void
 fbTrapezoids(CARD8 op,
              PicturePtr pSrc,
@@ -163,6 +326,15 @@ fbTrapezoids(CARD8 op,
     xSrc -= (traps[0].left.p1.x >> 16);
     ySrc -= (traps[0].left.p1.y >> 16);
 
+    /* Large batches from vector-graphics clients spend nearly all of
+     * their time scan-converting into the intermediate mask; spread
+     * that over the worker pool when an 8-bit mask was requested.
+     */
+    if (maskFormat && PIXMAN_FORMAT_A(maskFormat->format) == 8 &&
+        ntrap >= FB_PARALLEL_TRAPS && ThreadPoolWorkers() > 1 &&
+        fbTrapezoidsBanded(op, pSrc, pDst, xSrc, ySrc, ntrap, traps))
+        return;
+
     fbShapes((CompositeShapesFunc) pixman_composite_trapezoids,
              op, pSrc, pDst, maskFormat,
              xSrc, ySrc, ntrap, sizeof(xTrapezoid), (const uint8_t *) traps);
@@ -29,8 +29,8 @@
 Bool
 fbCreateWindow(WindowPtr pWin)
 {
-    dixSetPrivate(&pWin->devPrivates, fbGetWinPrivateKey(pWin),
-                  fbGetScreenPixmap(pWin->drawable.pScreen));
+    dixSetFixedPrivate(&pWin->devPrivates, FIXED_PRIVATE_FB,
+                       fbGetScreenPixmap(pWin->drawable.pScreen));
     return TRUE;
 }
 
@@ -68,33 +68,12 @@ fbCopyWindowProc(DrawablePtr pSrcDrawable,
                  int dy,
                  Bool reverse, Bool upsidedown, Pixel bitplane, void *closure)
 {
-    FbBits *src;
-    FbStride srcStride;
-    int srcBpp;
-    int srcXoff, srcYoff;
-    FbBits *dst;
-    FbStride dstStride;
-    int dstBpp;
-    int dstXoff, dstYoff;
-
-    fbGetDrawable(pSrcDrawable, src, srcStride, srcBpp, srcXoff, srcYoff);
-    fbGetDrawable(pDstDrawable, dst, dstStride, dstBpp, dstXoff, dstYoff);
-
-    while (nbox--) {
-        fbBlt(src + (pbox->y1 + dy + srcYoff) * srcStride,
-              srcStride,
-              (pbox->x1 + dx + srcXoff) * srcBpp,
-              dst + (pbox->y1 + dstYoff) * dstStride,
-              dstStride,
-              (pbox->x1 + dstXoff) * dstBpp,
-              (pbox->x2 - pbox->x1) * dstBpp,
-              (pbox->y2 - pbox->y1),
-              GXcopy, FB_ALLONES, dstBpp, reverse, upsidedown);
-        pbox++;
-    }
-
-    fbFinishAccess(pDstDrawable);
-    fbFinishAccess(pSrcDrawable);
+    /* A windowless GXcopy/FB_ALLONES copy is exactly fbCopyNtoN with no
+     * GC; going through it lets window moves use the same accelerated
+     * paths as CopyArea instead of a private fbBlt loop.
+     */
+    fbCopyNtoN(pSrcDrawable, pDstDrawable, 0, pbox, nbox, dx, dy,
+               reverse, upsidedown, bitplane, closure);
 }
 
 void
@@ -108,6 +87,15 @@ fbCopyWindow(WindowPtr pWin, DDXPointRec ptOldOrg, RegionPtr prgnSrc)
 
     dx = ptOldOrg.x - pWin->drawable.x;
     dy = ptOldOrg.y - pWin->drawable.y;
+
+    /* Gravity-preserving resizes and restacks come through here with no
+     * net displacement; every pixel would be copied onto itself.
+     */
+    if (!dx && !dy) {
+        fbValidateDrawable(&pWin->drawable);
+        return;
+    }
+
     RegionTranslate(prgnSrc, -dx, -dy);
 
     RegionNull(&rgnDst);
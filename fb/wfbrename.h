@@ -39,6 +39,7 @@
 #define fbCreatePixmap wfbCreatePixmap
 #define fbCreateWindow wfbCreateWindow
 #define fbDestroyGlyphCache wfbDestroyGlyphCache
+#define fbDestroySourceCache wfbDestroySourceCache
 #define fbDestroyPixmap wfbDestroyPixmap
 #define fbDestroyWindow wfbDestroyWindow
 #define fbDoCopy wfbDoCopy
@@ -56,7 +57,6 @@
 #define fbGCOps wfbGCOps
 #define fbGetGCPrivateKey wfbGetGCPrivateKey
 #define fbGetImage wfbGetImage
-#define fbGetScreenPrivateKey wfbGetScreenPrivateKey
 #define fbGetSpans wfbGetSpans
 #define _fbGetWindowPixmap _wfbGetWindowPixmap
 #define fbGlyph16 wfbGlyph16
@@ -101,7 +101,6 @@
 #define fbRealizeFont wfbRealizeFont
 #define fbReplicatePixel wfbReplicatePixel
 #define fbResolveColor wfbResolveColor
-#define fbScreenPrivateKeyRec wfbScreenPrivateKeyRec
 #define fbSegment wfbSegment
 #define fbSelectBres wfbSelectBres
 #define fbSetSpans wfbSetSpans
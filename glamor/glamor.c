@@ -38,8 +38,10 @@
 
 #include "dix/screen_hooks_priv.h"
 #include "os/bug_priv.h"
+#include "os/probes_priv.h"
 
 #include "glamor_priv.h"
+#include "glamor_transfer.h"
 #include "mipict.h"
 
 DevPrivateKeyRec glamor_screen_private_key;
@@ -294,7 +296,13 @@ _glamor_block_handler(ScreenPtr screen, void *timeout)
 {
     glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
 
+#ifdef XSERVER_DTRACE
+    if (XSERVER_GLAMOR_FLUSH_ENABLED())
+        XSERVER_GLAMOR_FLUSH(screen->myNum);
+#endif
     glamor_flush(glamor_priv);
+    glamor_transfer_poll(screen);
+    glamor_fbo_expire(glamor_priv);
 
     screen->BlockHandler = glamor_priv->saved_procs.block_handler;
     screen->BlockHandler(screen, timeout);
@@ -663,6 +671,7 @@ glamor_init(ScreenPtr screen, unsigned int flags)
     }
 
     glamor_set_screen_private(screen, glamor_priv);
+    glamor_fbo_init(screen);
 
     if (!dixRegisterPrivateKey(&glamor_pixmap_private_key, PRIVATE_PIXMAP,
                                sizeof(struct glamor_pixmap_private))) {
@@ -767,6 +776,7 @@ glamor_init(ScreenPtr screen, unsigned int flags)
     glamor_priv->has_pack_invert =
         epoxy_has_gl_extension("GL_MESA_pack_invert");
     glamor_priv->has_fbo_blit =
+        gl_version >= 30 ||
         epoxy_has_gl_extension("GL_EXT_framebuffer_blit");
     glamor_priv->has_map_buffer_range =
         epoxy_has_gl_extension("GL_ARB_map_buffer_range") ||
@@ -793,6 +803,12 @@ glamor_init(ScreenPtr screen, unsigned int flags)
     glamor_priv->has_clear_texture =
         epoxy_gl_version() >= 44 ||
         epoxy_has_gl_extension("GL_ARB_clear_texture");
+    glamor_priv->has_sync =
+        (glamor_priv->is_gles ? gl_version >= 30 : gl_version >= 32) ||
+        epoxy_has_gl_extension("GL_ARB_sync");
+    glamor_priv->has_meminfo_ati = epoxy_has_gl_extension("GL_ATI_meminfo");
+    glamor_priv->has_meminfo_nvx =
+        epoxy_has_gl_extension("GL_NVX_gpu_memory_info");
     /* GL_EXT_texture_rg is part of GLES3 core */
     glamor_priv->has_rg =
         (glamor_priv->is_gles && epoxy_gl_version() >= 30) ||
@@ -828,6 +844,8 @@ glamor_init(ScreenPtr screen, unsigned int flags)
         (epoxy_has_gl_extension("GL_ARB_texture_swizzle") ||
          (glamor_priv->is_gles && gl_version >= 30));
 
+    glamor_program_cache_init(screen);
+
     glamor_setup_formats(screen);
 
     glamor_set_debug_level(&glamor_debug_level);
@@ -919,7 +937,10 @@ glamor_release_screen_priv(ScreenPtr screen)
 
     glamor_priv = glamor_get_screen_private(screen);
     glamor_fini_vbo(screen);
+    glamor_fbo_fini(screen);
     glamor_pixmap_fini(screen);
+    glamor_program_cache_fini(screen);
+    free(glamor_priv->render_batch.verts);
     free(glamor_priv);
 
     glamor_set_screen_private(screen, NULL);
@@ -931,7 +952,10 @@ static void glamor_close_screen(CallbackListPtr *pcbl, ScreenPtr screen, void *u
     PixmapPtr screen_pixmap;
 
     glamor_priv = glamor_get_screen_private(screen);
+    glamor_render_batch_flush(glamor_priv);
+    glamor_transfer_finish(screen);
     glamor_sync_close(screen);
+    glamor_gradient_fini(screen);
     glamor_composite_glyphs_fini(screen);
     glamor_set_glvnd_vendor(screen, NULL);
 
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "dix/cachestats_priv.h"
 #include "os/bug_priv.h"
 
 #include "Xprintf.h"
@@ -36,21 +37,43 @@
 
 #define DEFAULT_ATLAS_DIM       1024
 
+/* Pages per atlas.  When all are full the least recently used page is
+ * recycled, so only the glyphs on that one page fall out of the cache.
+ */
+#define GLAMOR_GLYPH_ATLAS_PAGES 4
+
 static DevPrivateKeyRec        glamor_glyph_private_key;
 
+struct glamor_glyph_page;
+
 struct glamor_glyph_private {
     int16_t     x;
     int16_t     y;
     uint32_t    serial;
+    struct glamor_glyph_page *page;
 };
 
-struct glamor_glyph_atlas {
-    PixmapPtr           atlas;
-    PictFormatPtr       format;
+/* One texture page of an atlas.  Pages are never freed before screen
+ * close, so glyph privates may safely keep pointers to them; a recycled
+ * page gets a fresh serial which invalidates those references instead.
+ */
+struct glamor_glyph_page {
+    struct glamor_glyph_page *next;
+    PixmapPtr           pixmap;
     int                 x, y;
     int                 row_height;
     int                 nglyph;
     uint32_t            serial;
+    uint32_t            last_use;
+};
+
+struct glamor_glyph_atlas {
+    struct glamor_glyph_page *pages;
+    struct glamor_glyph_page *current;
+    int                 npages;
+    PictFormatPtr       format;
+    uint32_t            next_serial;
+    uint32_t            use_count;
 };
 
 static inline struct glamor_glyph_private *glamor_get_glyph_private(PixmapPtr pixmap) {
@@ -124,41 +147,74 @@ glamor_copy_glyph(PixmapPtr     glyph_pixmap,
         glamor_destroy_pixmap(upload_pixmap);
 }
 
+/* atlas residency of glyphs drawn through the fast path; one eviction
+ * per glyph dropped when a page is recycled */
+static CacheStatsRec glyphAtlasStats;
+
+/* Make atlas->current a page with room for more glyphs: grow the atlas
+ * until it has GLAMOR_GLYPH_ATLAS_PAGES pages, then recycle the least
+ * recently used page, invalidating only the glyphs cached on it.
+ */
 static Bool
-glamor_glyph_atlas_init(ScreenPtr screen, struct glamor_glyph_atlas *atlas)
+glamor_glyph_atlas_new_page(ScreenPtr screen, struct glamor_glyph_atlas *atlas)
 {
     BUG_RETURN_VAL(!atlas, FALSE);
 
     glamor_screen_private       *glamor_priv = glamor_get_screen_private(screen);
-    PictFormatPtr               format = atlas->format;
-
-    atlas->atlas = glamor_create_pixmap(screen, glamor_priv->glyph_atlas_dim,
-                                        glamor_priv->glyph_atlas_dim, format->depth,
-                                        GLAMOR_CREATE_FBO_NO_FBO);
-    if (!glamor_pixmap_has_fbo(atlas->atlas)) {
-        glamor_destroy_pixmap(atlas->atlas);
-        atlas->atlas = NULL;
+    struct glamor_glyph_page    *page = NULL;
+    struct glamor_glyph_page    *p;
+
+    if (atlas->npages < GLAMOR_GLYPH_ATLAS_PAGES) {
+        page = calloc(1, sizeof (struct glamor_glyph_page));
+        if (page) {
+            page->pixmap = glamor_create_pixmap(screen,
+                                                glamor_priv->glyph_atlas_dim,
+                                                glamor_priv->glyph_atlas_dim,
+                                                atlas->format->depth,
+                                                GLAMOR_CREATE_FBO_NO_FBO);
+            if (!glamor_pixmap_has_fbo(page->pixmap)) {
+                glamor_destroy_pixmap(page->pixmap);
+                free(page);
+                page = NULL;
+            } else {
+                page->next = atlas->pages;
+                atlas->pages = page;
+                atlas->npages++;
+            }
+        }
     }
-    atlas->x = 0;
-    atlas->y = 0;
-    atlas->row_height = 0;
-    atlas->serial++;
-    atlas->nglyph = 0;
+
+    if (!page) {
+        /* Recycle the least recently used page */
+        for (p = atlas->pages; p; p = p->next)
+            if (!page || (int32_t) (p->last_use - page->last_use) < 0)
+                page = p;
+        if (!page)
+            return FALSE;
+        glyphAtlasStats.evictions += page->nglyph;
+    }
+
+    page->x = 0;
+    page->y = 0;
+    page->row_height = 0;
+    page->nglyph = 0;
+    page->serial = ++atlas->next_serial;
+    atlas->current = page;
     return TRUE;
 }
 
 static Bool
-glamor_glyph_can_add(struct glamor_glyph_atlas *atlas, int dim, DrawablePtr glyph_draw)
+glamor_glyph_can_add(struct glamor_glyph_page *page, int dim, DrawablePtr glyph_draw)
 {
     /* Step down */
-    if (atlas->x + glyph_draw->width > dim) {
-        atlas->x = 0;
-        atlas->y += atlas->row_height;
-        atlas->row_height = 0;
+    if (page->x + glyph_draw->width > dim) {
+        page->x = 0;
+        page->y += page->row_height;
+        page->row_height = 0;
     }
 
     /* Check for overfull */
-    if (atlas->y + glyph_draw->height > dim)
+    if (page->y + glyph_draw->height > dim)
         return FALSE;
 
     return TRUE;
@@ -169,18 +225,20 @@ glamor_glyph_add(struct glamor_glyph_atlas *atlas, DrawablePtr glyph_draw)
 {
     PixmapPtr                   glyph_pixmap = (PixmapPtr) glyph_draw;
     struct glamor_glyph_private *glyph_priv = glamor_get_glyph_private(glyph_pixmap);
+    struct glamor_glyph_page    *page = atlas->current;
 
-    glamor_copy_glyph(glyph_pixmap, &atlas->atlas->drawable, atlas->x, atlas->y);
+    glamor_copy_glyph(glyph_pixmap, &page->pixmap->drawable, page->x, page->y);
 
-    glyph_priv->x = atlas->x;
-    glyph_priv->y = atlas->y;
-    glyph_priv->serial = atlas->serial;
+    glyph_priv->x = page->x;
+    glyph_priv->y = page->y;
+    glyph_priv->serial = page->serial;
+    glyph_priv->page = page;
 
-    atlas->x += glyph_draw->width;
-    if (atlas->row_height < glyph_draw->height)
-        atlas->row_height = glyph_draw->height;
+    page->x += glyph_draw->width;
+    if (page->row_height < glyph_draw->height)
+        page->row_height = glyph_draw->height;
 
-    atlas->nglyph++;
+    page->nglyph++;
 
     return TRUE;
 }
@@ -269,11 +327,11 @@ glamor_glyphs_fini_facet(ScreenPtr screen)
 static void
 glamor_glyphs_flush(CARD8 op, PicturePtr src, PicturePtr dst,
                    glamor_program *prog,
-                   struct glamor_glyph_atlas *atlas, int nglyph)
+                   struct glamor_glyph_page *page, int nglyph)
 {
     DrawablePtr drawable = dst->pDrawable;
     glamor_screen_private *glamor_priv = glamor_get_screen_private(drawable->pScreen);
-    PixmapPtr atlas_pixmap = atlas->atlas;
+    PixmapPtr atlas_pixmap = page->pixmap;
     glamor_pixmap_private *atlas_priv = glamor_get_pixmap_private(atlas_pixmap);
     glamor_pixmap_fbo *atlas_fbo = glamor_pixmap_fbo_at(atlas_priv, 0);
     PixmapPtr pixmap = glamor_get_drawable_pixmap(drawable);
@@ -396,6 +454,7 @@ glamor_composite_glyphs(CARD8 op,
     glamor_program *prog = NULL;
     glamor_program_render       *glyphs_program = &glamor_priv->glyphs_program;
     struct glamor_glyph_atlas    *glyph_atlas = NULL;
+    struct glamor_glyph_page     *batch_page = NULL;
     int x = 0, y = 0;
     int n;
     int glyph_atlas_dim = glamor_priv->glyph_atlas_dim;
@@ -431,7 +490,7 @@ glamor_composite_glyphs(CARD8 op,
                                 !glamor_pixmap_is_memory((PixmapPtr)glyph_draw)))
                 {
                     if (glyphs_queued) {
-                        glamor_glyphs_flush(op, src, dst, prog, glyph_atlas, glyphs_queued);
+                        glamor_glyphs_flush(op, src, dst, prog, batch_page, glyphs_queued);
                         glyphs_queued = 0;
                     }
                 bail_one:
@@ -442,41 +501,47 @@ glamor_composite_glyphs(CARD8 op,
                                      glyph_draw->width, glyph_draw->height);
                 } else {
                     struct glamor_glyph_private *glyph_priv = glamor_get_glyph_private((PixmapPtr)(glyph_draw));
-                    struct glamor_glyph_atlas *next_atlas = glamor_atlas_for_glyph(glamor_priv, glyph_draw);
 
-                    /* Switching source glyph format?
-                     */
-                    if (_X_UNLIKELY(next_atlas != glyph_atlas)) {
-                        if (glyphs_queued) {
-                            glamor_glyphs_flush(op, src, dst, prog, glyph_atlas, glyphs_queued);
-                            glyphs_queued = 0;
-                        }
-                        glyph_atlas = next_atlas;
-                    }
+                    glyph_atlas = glamor_atlas_for_glyph(glamor_priv, glyph_draw);
+                    BUG_RETURN(!glyph_atlas);
 
-                    /* Glyph not cached in current atlas?
+                    CacheStatsRegister(&glyphAtlasStats, "glamor-glyph-atlas");
+
+                    /* Glyph not cached in a live atlas page?
                      */
-                    BUG_RETURN(!glyph_atlas);
-                    if (_X_UNLIKELY(glyph_priv->serial != glyph_atlas->serial)) {
-                        if (!glamor_glyph_can_add(glyph_atlas, glyph_atlas_dim, glyph_draw)) {
+                    if (_X_UNLIKELY(!glyph_priv->page ||
+                                    glyph_priv->serial != glyph_priv->page->serial)) {
+                        CacheStatsMiss(&glyphAtlasStats);
+                        if (!glyph_atlas->current ||
+                            !glamor_glyph_can_add(glyph_atlas->current, glyph_atlas_dim, glyph_draw)) {
+                            /* Opening a page may recycle one that queued
+                             * glyphs are sourced from, so flush first
+                             */
                             if (glyphs_queued) {
-                                glamor_glyphs_flush(op, src, dst, prog, glyph_atlas, glyphs_queued);
+                                glamor_glyphs_flush(op, src, dst, prog, batch_page, glyphs_queued);
                                 glyphs_queued = 0;
                             }
-                            if (glyph_atlas->atlas) {
-                                dixDestroyPixmap(glyph_atlas->atlas, 0);
-                                glyph_atlas->atlas = NULL;
-                            }
-                        }
-                        if (!glyph_atlas->atlas) {
-                            glamor_glyph_atlas_init(screen, glyph_atlas);
-                            if (!glyph_atlas->atlas)
+                            if (!glamor_glyph_atlas_new_page(screen, glyph_atlas))
                                 goto bail_one;
                         }
                         glamor_glyph_add(glyph_atlas, glyph_draw);
+                    } else {
+                        CacheStatsHit(&glyphAtlasStats);
                     }
 
-                    /* First glyph in the current atlas?
+                    /* All glyphs in a batch are drawn from one page;
+                     * switching page (or atlas) ends the batch
+                     */
+                    if (_X_UNLIKELY(glyph_priv->page != batch_page)) {
+                        if (glyphs_queued) {
+                            glamor_glyphs_flush(op, src, dst, prog, batch_page, glyphs_queued);
+                            glyphs_queued = 0;
+                        }
+                        batch_page = glyph_priv->page;
+                    }
+                    batch_page->last_use = ++glyph_atlas->use_count;
+
+                    /* First glyph in the current batch?
                      */
                     if (_X_UNLIKELY(glyphs_queued == 0)) {
                         if (glamor_glsl_has_ints(glamor_priv))
@@ -544,7 +609,7 @@ glamor_composite_glyphs(CARD8 op,
     }
 
     if (glyphs_queued)
-        glamor_glyphs_flush(op, src, dst, prog, glyph_atlas, glyphs_queued);
+        glamor_glyphs_flush(op, src, dst, prog, batch_page, glyphs_queued);
 
     return;
 }
@@ -562,7 +627,7 @@ glamor_alloc_glyph_atlas(ScreenPtr screen, int depth, CARD32 f)
     if (!glyph_atlas)
         return NULL;
     glyph_atlas->format = format;
-    glyph_atlas->serial = 1;
+    glyph_atlas->next_serial = 1;
 
     return glyph_atlas;
 }
@@ -599,9 +664,15 @@ glamor_composite_glyphs_init(ScreenPtr screen)
 static void
 glamor_free_glyph_atlas(struct glamor_glyph_atlas *atlas)
 {
+    struct glamor_glyph_page *page, *next;
+
     if (!atlas)
         return;
-    dixDestroyPixmap(atlas->atlas, 0);
+    for (page = atlas->pages; page; page = next) {
+        next = page->next;
+        dixDestroyPixmap(page->pixmap, 0);
+        free (page);
+    }
     free (atlas);
 }
 
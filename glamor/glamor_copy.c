@@ -21,6 +21,8 @@
  */
 #include <dix-config.h>
 
+#include <stdlib.h>
+
 #include "os/bug_priv.h"
 
 #include "glamor_priv.h"
@@ -156,6 +158,36 @@ static const glamor_facet glamor_facet_copyplane = {
     .use = use_copyplane,
 };
 
+/*
+ * Prepare only the extents of the boxes a copy fallback touches,
+ * offset by (dx, dy) to move between destination and source space.
+ * The boxes are in drawable coordinates including drawable->x/y.
+ */
+static Bool
+glamor_copy_prepare_boxes(DrawablePtr drawable, glamor_access_t access,
+                          BoxPtr box, int nbox, int dx, int dy)
+{
+    BoxRec extents;
+    int n;
+
+    if (!nbox)
+        return glamor_prepare_access_box(drawable, access, 0, 0, 0, 0);
+
+    extents = box[0];
+    for (n = 1; n < nbox; n++) {
+        extents.x1 = MIN(extents.x1, box[n].x1);
+        extents.y1 = MIN(extents.y1, box[n].y1);
+        extents.x2 = MAX(extents.x2, box[n].x2);
+        extents.y2 = MAX(extents.y2, box[n].y2);
+    }
+
+    return glamor_prepare_access_box(drawable, access,
+                                     extents.x1 + dx - drawable->x,
+                                     extents.y1 + dy - drawable->y,
+                                     extents.x2 - extents.x1,
+                                     extents.y2 - extents.y1);
+}
+
 /*
  * When all else fails, pull the bits out of the GPU and do the
  * operation with fb
@@ -174,7 +206,8 @@ glamor_copy_bail(DrawablePtr src,
                  Pixel bitplane,
                  void *closure)
 {
-    if (glamor_prepare_access(dst, GLAMOR_ACCESS_RW) && glamor_prepare_access(src, GLAMOR_ACCESS_RO)) {
+    if (glamor_copy_prepare_boxes(dst, GLAMOR_ACCESS_RW, box, nbox, 0, 0) &&
+        glamor_copy_prepare_boxes(src, GLAMOR_ACCESS_RO, box, nbox, dx, dy)) {
         if (bitplane) {
             if (src->bitsPerPixel > 1)
                 fbCopyNto1(src, dst, gc, box, nbox, dx, dy,
@@ -225,7 +258,7 @@ glamor_copy_cpu_fbo(DrawablePtr src,
 
     glamor_make_current(glamor_priv);
 
-    if (!glamor_prepare_access(src, GLAMOR_ACCESS_RO))
+    if (!glamor_copy_prepare_boxes(src, GLAMOR_ACCESS_RO, box, nbox, dx, dy))
         goto bail;
 
     glamor_get_drawable_deltas(dst, dst_pixmap, &dst_xoff, &dst_yoff);
@@ -315,7 +348,7 @@ glamor_copy_fbo_cpu(DrawablePtr src,
 
     glamor_make_current(glamor_priv);
 
-    if (!glamor_prepare_access(dst, GLAMOR_ACCESS_RW))
+    if (!glamor_copy_prepare_boxes(dst, GLAMOR_ACCESS_RW, box, nbox, 0, 0))
         goto bail;
 
     glamor_get_drawable_deltas(src, src_pixmap, &src_xoff, &src_yoff);
@@ -499,6 +532,130 @@ bail_ctx:
     return ret;
 }
 
+/* Bail to the temporary-pixmap path rather than issue silly numbers of
+ * blits for tiny scroll distances.
+ */
+#define GLAMOR_COPY_BLIT_MAX_BANDS      64
+
+/*
+ * Overlapping copy within one FBO using glBlitFramebuffer, without the
+ * temporary pixmap glamor_copy_fbo_fbo_temp() allocates.
+ *
+ * A single blit whose source and destination rectangles overlap is
+ * undefined, so the copy is split into bands no larger than the shift
+ * along the dominant axis: each band's source and destination are then
+ * disjoint, and walking the bands against the shift direction
+ * guarantees every band reads pixels no earlier band has written.
+ */
+static Bool
+glamor_copy_fbo_fbo_blit(DrawablePtr src,
+                         DrawablePtr dst,
+                         GCPtr gc,
+                         BoxPtr box,
+                         int nbox,
+                         int dx,
+                         int dy,
+                         Pixel bitplane)
+{
+    ScreenPtr screen = dst->pScreen;
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    PixmapPtr pixmap = glamor_get_drawable_pixmap(dst);
+    glamor_pixmap_private *priv = glamor_get_pixmap_private(pixmap);
+    int src_off_x, src_off_y;
+    int dst_off_x, dst_off_y;
+    int shift_x, shift_y;
+    BoxRec bounds;
+    int band, nband, n;
+    Bool vertical;
+
+    if (nbox == 0)
+        return TRUE;
+
+    if (!glamor_priv->has_fbo_blit)
+        return FALSE;
+
+    if (bitplane)
+        return FALSE;
+
+    if (gc && (gc->alu != GXcopy ||
+               !glamor_pm_is_solid(gc->depth, gc->planemask)))
+        return FALSE;
+
+    if (glamor_pixmap_priv_is_large(priv))
+        return FALSE;
+
+    glamor_get_drawable_deltas(src, pixmap, &src_off_x, &src_off_y);
+    glamor_get_drawable_deltas(dst, pixmap, &dst_off_x, &dst_off_y);
+
+    /* Pixmap-space translation: dst pixel = src pixel + shift */
+    shift_x = dst_off_x - (dx + src_off_x);
+    shift_y = dst_off_y - (dy + src_off_y);
+
+    if (shift_x == 0 && shift_y == 0)
+        return TRUE;
+
+    /* Destination bounds, in pixmap coordinates */
+    bounds = box[0];
+    for (n = 1; n < nbox; n++) {
+        bounds.x1 = min(bounds.x1, box[n].x1);
+        bounds.y1 = min(bounds.y1, box[n].y1);
+        bounds.x2 = max(bounds.x2, box[n].x2);
+        bounds.y2 = max(bounds.y2, box[n].y2);
+    }
+    bounds.x1 += dst_off_x;
+    bounds.x2 += dst_off_x;
+    bounds.y1 += dst_off_y;
+    bounds.y2 += dst_off_y;
+
+    vertical = abs(shift_y) >= abs(shift_x);
+    if (vertical)
+        nband = (bounds.y2 - bounds.y1 + abs(shift_y) - 1) / abs(shift_y);
+    else
+        nband = (bounds.x2 - bounds.x1 + abs(shift_x) - 1) / abs(shift_x);
+
+    if (nband > GLAMOR_COPY_BLIT_MAX_BANDS)
+        return FALSE;
+
+    glamor_make_current(glamor_priv);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, priv->fbo->fb);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, priv->fbo->fb);
+
+    for (band = 0; band < nband; band++) {
+        /* Walk bands against the shift direction */
+        int b = (vertical ? shift_y : shift_x) > 0 ? nband - 1 - band : band;
+        BoxRec strip = bounds;
+
+        if (vertical) {
+            strip.y1 = bounds.y1 + b * abs(shift_y);
+            strip.y2 = min(strip.y1 + abs(shift_y), bounds.y2);
+        } else {
+            strip.x1 = bounds.x1 + b * abs(shift_x);
+            strip.x2 = min(strip.x1 + abs(shift_x), bounds.x2);
+        }
+
+        for (n = 0; n < nbox; n++) {
+            BoxRec piece = {
+                .x1 = max(box[n].x1 + dst_off_x, strip.x1),
+                .y1 = max(box[n].y1 + dst_off_y, strip.y1),
+                .x2 = min(box[n].x2 + dst_off_x, strip.x2),
+                .y2 = min(box[n].y2 + dst_off_y, strip.y2),
+            };
+
+            if (piece.x1 >= piece.x2 || piece.y1 >= piece.y2)
+                continue;
+
+            glBlitFramebuffer(piece.x1 - shift_x, piece.y1 - shift_y,
+                              piece.x2 - shift_x, piece.y2 - shift_y,
+                              piece.x1, piece.y1,
+                              piece.x2, piece.y2,
+                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+    }
+
+    return TRUE;
+}
+
 /**
  * Copies from the GPU to the GPU using a temporary pixmap in between,
  * to correctly handle overlapping copies.
@@ -713,9 +870,13 @@ glamor_copy_gl(DrawablePtr src,
 
     if (GLAMOR_PIXMAP_PRIV_HAS_FBO(dst_priv)) {
         if (GLAMOR_PIXMAP_PRIV_HAS_FBO(src_priv)) {
-            if (glamor_copy_needs_temp(src, dst, box, nbox, dx, dy))
+            if (glamor_copy_needs_temp(src, dst, box, nbox, dx, dy)) {
+                if (glamor_copy_fbo_fbo_blit(src, dst, gc, box, nbox, dx, dy,
+                                             bitplane))
+                    return TRUE;
                 return glamor_copy_fbo_fbo_temp(src, dst, gc, box, nbox, dx, dy,
                                                 reverse, upsidedown, bitplane, closure);
+            }
             else
                 return glamor_copy_fbo_fbo_draw(src, dst, gc, box, nbox, dx, dy,
                                                 reverse, upsidedown, bitplane, closure);
@@ -41,6 +41,7 @@
 #include <gbm.h>
 #include <drm_fourcc.h>
 
+#include "dix/bootprof_priv.h"
 #include "dix/screen_hooks_priv.h"
 #include "glamor/glamor_priv.h"
 #include "os/bug_priv.h"
@@ -1196,8 +1197,8 @@ static const OptionInfoRec GlamorEGLOptions[] = {
     { -1, NULL, OPTV_NONE, {0}, FALSE },
 };
 
-Bool
-glamor_egl_init(ScrnInfoPtr scrn, int fd)
+static Bool
+glamor_egl_init_impl(ScrnInfoPtr scrn, int fd)
 {
     struct glamor_egl_screen_private *glamor_egl;
     const GLubyte *renderer;
@@ -1348,6 +1349,17 @@ error:
     return FALSE;
 }
 
+Bool
+glamor_egl_init(ScrnInfoPtr scrn, int fd)
+{
+    Bool ret;
+
+    BootPhaseBegin("glamor egl init");
+    ret = glamor_egl_init_impl(scrn, fd);
+    BootPhaseEnd();
+    return ret;
+}
+
 /** Stub to retain compatibility with pre-server-1.16 ABI. */
 Bool
 glamor_egl_init_textured_pixmap(ScreenPtr screen)
@@ -30,12 +30,31 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#include "dix/cachestats_priv.h"
 #include "glamor/glamor_priv.h"
 #include "os/bug_priv.h"
 
-void
-glamor_destroy_fbo(glamor_screen_private *glamor_priv,
-                   glamor_pixmap_fbo *fbo)
+/* How much idle FBO storage to keep around for reuse. */
+#define GLAMOR_FBO_CACHE_MAX_BYTES      (64 * 1024 * 1024)
+
+/* Cached entries idle for this many block handler ticks are freed. */
+#define GLAMOR_FBO_EXPIRE_TICKS         100
+
+/* Trim the cache when the driver reports less free VRAM than this (KB). */
+#define GLAMOR_FBO_CACHE_LOW_VRAM_KB    (256 * 1024)
+
+/* reuse effectiveness of the idle-FBO cache, all screens combined */
+static CacheStatsRec fboCacheStats;
+
+#ifndef GL_TEXTURE_FREE_MEMORY_ATI
+#define GL_TEXTURE_FREE_MEMORY_ATI 0x87FC
+#endif
+#ifndef GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#endif
+
+static void
+glamor_fbo_destroy(glamor_screen_private *glamor_priv, glamor_pixmap_fbo *fbo)
 {
     glamor_make_current(glamor_priv);
 
@@ -47,6 +66,199 @@ glamor_destroy_fbo(glamor_screen_private *glamor_priv,
     free(fbo);
 }
 
+/*
+ * Size classes collapse nearby allocation sizes into one cache bucket,
+ * so the odd sizes window resizing produces probe a single short list
+ * instead of missing a per-size slot.
+ */
+static unsigned
+glamor_fbo_size_class(int size)
+{
+    unsigned class = 0;
+
+    while (size > 32) {
+        size >>= 1;
+        class++;
+    }
+    return class;
+}
+
+static struct xorg_list *
+glamor_fbo_cache_bucket(glamor_screen_private *glamor_priv,
+                        GLenum internalformat, int w, int h)
+{
+    unsigned hash = (unsigned) internalformat +
+        glamor_fbo_size_class(w) * 7 +
+        glamor_fbo_size_class(h) * 13;
+
+    return &glamor_priv->fbo_cache[hash % GLAMOR_FBO_CACHE_BUCKETS];
+}
+
+static void
+glamor_fbo_cache_remove(glamor_screen_private *glamor_priv,
+                        glamor_pixmap_fbo *fbo)
+{
+    xorg_list_del(&fbo->list);
+    glamor_priv->fbo_cache_bytes -= fbo->bytes;
+}
+
+static glamor_pixmap_fbo *
+glamor_fbo_cache_get(glamor_screen_private *glamor_priv,
+                     GLenum internalformat, Bool is_red, int w, int h)
+{
+    struct xorg_list *bucket;
+    glamor_pixmap_fbo *fbo;
+
+    CacheStatsRegister(&fboCacheStats, "glamor-fbo");
+
+    bucket = glamor_fbo_cache_bucket(glamor_priv, internalformat, w, h);
+    xorg_list_for_each_entry(fbo, bucket, list) {
+        if (fbo->width == w && fbo->height == h &&
+            fbo->internalformat == internalformat && fbo->is_red == is_red) {
+            glamor_fbo_cache_remove(glamor_priv, fbo);
+            CacheStatsHit(&fboCacheStats);
+
+            /* Restore the filters _glamor_create_tex would have set;
+             * the previous owner may have sampled with GL_LINEAR.
+             */
+            glamor_make_current(glamor_priv);
+            glBindTexture(GL_TEXTURE_2D, fbo->tex);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            return fbo;
+        }
+    }
+    CacheStatsMiss(&fboCacheStats);
+    return NULL;
+}
+
+/* Evict least recently cached entries until at most target bytes remain. */
+static void
+glamor_fbo_cache_trim(glamor_screen_private *glamor_priv, size_t target)
+{
+    while (glamor_priv->fbo_cache_bytes > target) {
+        glamor_pixmap_fbo *oldest = NULL;
+        int i;
+
+        for (i = 0; i < GLAMOR_FBO_CACHE_BUCKETS; i++) {
+            glamor_pixmap_fbo *fbo;
+
+            if (xorg_list_is_empty(&glamor_priv->fbo_cache[i]))
+                continue;
+            fbo = xorg_list_last_entry(&glamor_priv->fbo_cache[i],
+                                       glamor_pixmap_fbo, list);
+            if (!oldest || (int32_t) (oldest->expire - fbo->expire) > 0)
+                oldest = fbo;
+        }
+        if (!oldest)
+            break;
+        glamor_fbo_cache_remove(glamor_priv, oldest);
+        glamor_fbo_destroy(glamor_priv, oldest);
+        CacheStatsEvict(&fboCacheStats);
+    }
+}
+
+static Bool
+glamor_fbo_vram_low(glamor_screen_private *glamor_priv)
+{
+    GLint info[4] = { -1, -1, -1, -1 };
+
+    if (!glamor_priv->has_meminfo_ati && !glamor_priv->has_meminfo_nvx)
+        return FALSE;
+
+    glamor_make_current(glamor_priv);
+
+    if (glamor_priv->has_meminfo_ati)
+        glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, info);
+    else if (glamor_priv->has_meminfo_nvx)
+        glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, info);
+    else
+        return FALSE;
+
+    return info[0] >= 0 && info[0] < GLAMOR_FBO_CACHE_LOW_VRAM_KB;
+}
+
+static Bool
+glamor_fbo_cache_put(glamor_screen_private *glamor_priv,
+                     glamor_pixmap_fbo *fbo)
+{
+    if (!fbo->cacheable || !fbo->tex)
+        return FALSE;
+
+    /* Don't let one oversized pixmap monopolize the cache. */
+    if (fbo->bytes > GLAMOR_FBO_CACHE_MAX_BYTES / 4)
+        return FALSE;
+
+    fbo->expire = glamor_priv->fbo_cache_tick;
+    xorg_list_add(&fbo->list,
+                  glamor_fbo_cache_bucket(glamor_priv, fbo->internalformat,
+                                          fbo->width, fbo->height));
+    glamor_priv->fbo_cache_bytes += fbo->bytes;
+    glamor_fbo_cache_trim(glamor_priv, glamor_priv->fbo_cache_max_bytes);
+    return TRUE;
+}
+
+/*
+ * Called once per block handler invocation: age out idle entries and,
+ * when the driver can report free VRAM and it is running low, trim the
+ * cache ahead of the allocation failure.
+ */
+void
+glamor_fbo_expire(glamor_screen_private *glamor_priv)
+{
+    glamor_pixmap_fbo *fbo, *tmp;
+    int i;
+
+    glamor_priv->fbo_cache_tick++;
+
+    if (!glamor_priv->fbo_cache_bytes)
+        return;
+
+    for (i = 0; i < GLAMOR_FBO_CACHE_BUCKETS; i++) {
+        xorg_list_for_each_entry_safe(fbo, tmp, &glamor_priv->fbo_cache[i],
+                                      list) {
+            if ((int32_t) (glamor_priv->fbo_cache_tick - fbo->expire) >
+                GLAMOR_FBO_EXPIRE_TICKS) {
+                glamor_fbo_cache_remove(glamor_priv, fbo);
+                glamor_fbo_destroy(glamor_priv, fbo);
+                CacheStatsEvict(&fboCacheStats);
+            }
+        }
+    }
+
+    if (glamor_fbo_vram_low(glamor_priv))
+        glamor_fbo_cache_trim(glamor_priv, glamor_priv->fbo_cache_bytes / 2);
+}
+
+void
+glamor_fbo_init(ScreenPtr screen)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    int i;
+
+    for (i = 0; i < GLAMOR_FBO_CACHE_BUCKETS; i++)
+        xorg_list_init(&glamor_priv->fbo_cache[i]);
+    glamor_priv->fbo_cache_max_bytes = GLAMOR_FBO_CACHE_MAX_BYTES;
+}
+
+void
+glamor_fbo_fini(ScreenPtr screen)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+
+    glamor_fbo_cache_trim(glamor_priv, 0);
+}
+
+void
+glamor_destroy_fbo(glamor_screen_private *glamor_priv,
+                   glamor_pixmap_fbo *fbo)
+{
+    if (glamor_fbo_cache_put(glamor_priv, fbo))
+        return;
+
+    glamor_fbo_destroy(glamor_priv, fbo);
+}
+
 static int
 glamor_pixmap_ensure_fb(glamor_screen_private *glamor_priv,
                         glamor_pixmap_fbo *fbo)
@@ -111,6 +323,9 @@ glamor_create_fbo_from_tex(glamor_screen_private *glamor_priv,
     fbo->width = w;
     fbo->height = h;
     fbo->is_red = f->format == GL_RED;
+    fbo->internalformat = f->internalformat;
+    fbo->bytes = (size_t) w * h *
+        ((pixmap->drawable.bitsPerPixel + 7) / 8);
 
     if (flag != GLAMOR_CREATE_FBO_NO_FBO) {
         if (glamor_pixmap_ensure_fb(glamor_priv, fbo) != 0) {
@@ -160,13 +375,38 @@ glamor_pixmap_fbo *
 glamor_create_fbo(glamor_screen_private *glamor_priv,
                   PixmapPtr pixmap, int w, int h, int flag)
 {
-    GLint tex = _glamor_create_tex(glamor_priv, pixmap, w, h);
+    const struct glamor_format *f = glamor_format_for_pixmap(pixmap);
+    glamor_pixmap_fbo *fbo;
+    GLint tex;
+
+    fbo = glamor_fbo_cache_get(glamor_priv, f->internalformat,
+                               f->format == GL_RED, w, h);
+    if (fbo) {
+        if (flag != GLAMOR_CREATE_FBO_NO_FBO && fbo->fb == 0 &&
+            glamor_pixmap_ensure_fb(glamor_priv, fbo) != 0)
+            glamor_fbo_destroy(glamor_priv, fbo);
+        else
+            return fbo;
+    }
 
-    if (!tex) /* Texture creation failed due to GL_OUT_OF_MEMORY */
-        return NULL;
+    tex = _glamor_create_tex(glamor_priv, pixmap, w, h);
+
+    if (!tex) { /* Texture creation failed due to GL_OUT_OF_MEMORY */
+        /* Retry once with the idle cache released back to the driver. */
+        if (!glamor_priv->fbo_cache_bytes)
+            return NULL;
+        glamor_fbo_cache_trim(glamor_priv, 0);
+        tex = _glamor_create_tex(glamor_priv, pixmap, w, h);
+        if (!tex)
+            return NULL;
+    }
+
+    fbo = glamor_create_fbo_from_tex(glamor_priv, pixmap, w, h,
+                                     tex, flag);
+    if (fbo)
+        fbo->cacheable = TRUE;
 
-    return glamor_create_fbo_from_tex(glamor_priv, pixmap, w, h,
-                                      tex, flag);
+    return fbo;
 }
 
 /**
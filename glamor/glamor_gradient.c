@@ -565,6 +565,127 @@ _glamor_create_linear_gradient_program(ScreenPtr screen, int stops_count,
     return TRUE;
 }
 
+/*
+ * Small cache of realized gradient pictures.  Toolkits tend to repeat
+ * the same gradient for every widget of a kind, so re-uploading stops
+ * and re-rendering the ramp each Composite is pure waste: remember the
+ * rendered picture keyed by everything it depends on and hand out an
+ * extra reference on a hit.  The cache holds its own picture reference,
+ * so the caller's FreePicture() just drops back to ours.
+ */
+
+static Bool
+glamor_gradient_key_init(struct glamor_gradient_key *key,
+                         PicturePtr src_picture,
+                         int x_source, int y_source,
+                         int width, int height,
+                         pixman_format_code_t format)
+{
+    PictGradient *pgradient = &src_picture->pSourcePict->gradient;
+
+    if (pgradient->nstops > GLAMOR_GRADIENT_CACHE_STOPS)
+        return FALSE;
+
+    memset(key, 0, sizeof(*key));
+    key->type = src_picture->pSourcePict->type;
+    key->repeat_type = src_picture->repeatType;
+    if (src_picture->transform) {
+        key->has_transform = TRUE;
+        key->transform = *src_picture->transform;
+    }
+    key->x_source = x_source;
+    key->y_source = y_source;
+    key->width = width;
+    key->height = height;
+    key->format = format;
+
+    if (key->type == SourcePictTypeLinear) {
+        key->p1 = src_picture->pSourcePict->linear.p1;
+        key->p2 = src_picture->pSourcePict->linear.p2;
+    }
+    else {
+        key->p1.x = src_picture->pSourcePict->radial.c1.x;
+        key->p1.y = src_picture->pSourcePict->radial.c1.y;
+        key->p2.x = src_picture->pSourcePict->radial.c2.x;
+        key->p2.y = src_picture->pSourcePict->radial.c2.y;
+        key->r1 = src_picture->pSourcePict->radial.c1.radius;
+        key->r2 = src_picture->pSourcePict->radial.c2.radius;
+    }
+
+    key->nstops = pgradient->nstops;
+    memcpy(key->stops, pgradient->stops,
+           pgradient->nstops * sizeof(PictGradientStop));
+
+    return TRUE;
+}
+
+static PicturePtr
+glamor_gradient_cache_get(glamor_screen_private *glamor_priv,
+                          const struct glamor_gradient_key *key)
+{
+    int i;
+
+    for (i = 0; i < GLAMOR_GRADIENT_CACHE_SIZE; i++) {
+        struct glamor_gradient_cache_entry *entry =
+            &glamor_priv->gradient_cache[i];
+
+        if (entry->picture && !memcmp(&entry->key, key, sizeof(*key))) {
+            entry->serial = ++glamor_priv->gradient_cache_serial;
+            entry->picture->refcnt++;
+            return entry->picture;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+glamor_gradient_cache_put(glamor_screen_private *glamor_priv,
+                          const struct glamor_gradient_key *key,
+                          PicturePtr picture)
+{
+    struct glamor_gradient_cache_entry *victim =
+        &glamor_priv->gradient_cache[0];
+    int i;
+
+    for (i = 1; i < GLAMOR_GRADIENT_CACHE_SIZE; i++) {
+        struct glamor_gradient_cache_entry *entry =
+            &glamor_priv->gradient_cache[i];
+
+        if (!entry->picture) {
+            victim = entry;
+            break;
+        }
+        if ((INT32) (entry->serial - victim->serial) < 0)
+            victim = entry;
+    }
+
+    if (victim->picture)
+        FreePicture(victim->picture, 0);
+
+    victim->key = *key;
+    victim->serial = ++glamor_priv->gradient_cache_serial;
+    victim->picture = picture;
+    picture->refcnt++;
+}
+
+void
+glamor_gradient_fini(ScreenPtr screen)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    int i;
+
+    for (i = 0; i < GLAMOR_GRADIENT_CACHE_SIZE; i++) {
+        struct glamor_gradient_cache_entry *entry =
+            &glamor_priv->gradient_cache[i];
+
+        if (entry->picture) {
+            FreePicture(entry->picture, 0);
+            entry->picture = NULL;
+        }
+    }
+}
+
 Bool
 glamor_init_gradient_shader(ScreenPtr screen)
 {
@@ -844,6 +965,8 @@ glamor_generate_radial_gradient_picture(ScreenPtr screen,
     };
     GLfloat stop_colors_st[RADIAL_SMALL_STOPS * 4];
     GLfloat n_stops_st[RADIAL_SMALL_STOPS];
+    struct glamor_gradient_key cache_key;
+    Bool cacheable;
     GLfloat A_value;
     GLfloat cxy[4];
     float c1x, c1y, c2x, c2y, r1, r2;
@@ -876,6 +999,16 @@ glamor_generate_radial_gradient_picture(ScreenPtr screen,
     GLint r2_uniform_location = 0;
 
     glamor_priv = glamor_get_screen_private(screen);
+
+    cacheable = glamor_gradient_key_init(&cache_key, src_picture,
+                                         x_source, y_source,
+                                         width, height, format);
+    if (cacheable) {
+        dst_picture = glamor_gradient_cache_get(glamor_priv, &cache_key);
+        if (dst_picture)
+            return dst_picture;
+    }
+
     glamor_make_current(glamor_priv);
 
     /* Create a pixmap with VBO. */
@@ -1108,6 +1241,9 @@ glamor_generate_radial_gradient_picture(ScreenPtr screen,
     glDisableVertexAttribArray(GLAMOR_VERTEX_POS);
     glDisableVertexAttribArray(GLAMOR_VERTEX_SOURCE);
 
+    if (cacheable)
+        glamor_gradient_cache_put(glamor_priv, &cache_key, dst_picture);
+
     return dst_picture;
 
  GRADIENT_FAIL:
@@ -1154,6 +1290,8 @@ glamor_generate_linear_gradient_picture(ScreenPtr screen,
     };
     GLfloat stop_colors_st[LINEAR_SMALL_STOPS * 4];
     GLfloat n_stops_st[LINEAR_SMALL_STOPS];
+    struct glamor_gradient_key cache_key;
+    Bool cacheable;
 
     GLint transform_mat_uniform_location = 0;
     GLint n_stop_uniform_location = 0;
@@ -1183,6 +1321,16 @@ glamor_generate_linear_gradient_picture(ScreenPtr screen,
     GLint pt_distance_uniform_location = 0;
 
     glamor_priv = glamor_get_screen_private(screen);
+
+    cacheable = glamor_gradient_key_init(&cache_key, src_picture,
+                                         x_source, y_source,
+                                         width, height, format);
+    if (cacheable) {
+        dst_picture = glamor_gradient_cache_get(glamor_priv, &cache_key);
+        if (dst_picture)
+            return dst_picture;
+    }
+
     glamor_make_current(glamor_priv);
 
     /* Create a pixmap with VBO. */
@@ -1450,6 +1598,9 @@ glamor_generate_linear_gradient_picture(ScreenPtr screen,
     glDisableVertexAttribArray(GLAMOR_VERTEX_POS);
     glDisableVertexAttribArray(GLAMOR_VERTEX_SOURCE);
 
+    if (cacheable)
+        glamor_gradient_cache_put(glamor_priv, &cache_key, dst_picture);
+
     return dst_picture;
 
  GRADIENT_FAIL:
@@ -25,6 +25,12 @@
 #include "glamor_transfer.h"
 #include "glamor_transform.h"
 
+/* Reads at least this many pixels go through the async PBO path, which
+ * queues all of the clipped glReadPixels before waiting once, instead
+ * of stalling the GPU queue per read
+ */
+#define GLAMOR_ASYNC_DOWNLOAD_PIXELS    (256 * 1024)
+
 /*
  * PutImage. Only does ZPixmap right now as other formats are quite a bit harder
  */
@@ -125,10 +131,17 @@ glamor_get_image_gl(DrawablePtr drawable, int x, int y, int w, int h,
     box.x2 = x + w;
     box.y1 = y;
     box.y2 = y + h;
-    glamor_download_boxes(drawable, &box, 1,
-                          drawable->x + off_x, drawable->y + off_y,
-                          -x, -y,
-                          (uint8_t *) d, byte_stride);
+    if ((uint32_t) w * h >= GLAMOR_ASYNC_DOWNLOAD_PIXELS &&
+        glamor_download_boxes_async(drawable, &box, 1,
+                                    drawable->x + off_x, drawable->y + off_y,
+                                    -x, -y,
+                                    (uint8_t *) d, byte_stride, NULL, NULL))
+        glamor_transfer_finish(drawable->pScreen);
+    else
+        glamor_download_boxes(drawable, &box, 1,
+                              drawable->x + off_x, drawable->y + off_y,
+                              -x, -y,
+                              (uint8_t *) d, byte_stride);
 
     if (!glamor_pm_is_solid(glamor_drawable_effective_depth(drawable), plane_mask)) {
         FbStip pm = fbReplicatePixel(plane_mask, drawable->bitsPerPixel);
@@ -1088,6 +1088,30 @@ glamor_composite_largepixmap_region(CARD8 op,
         return FALSE;
     }
 
+    /* A copy-equivalent composite (the panning case) can skip the tile
+     * decomposition below entirely: glamor_copy walks the FBO tiles of
+     * large source and destination pixmaps itself, with one program and
+     * vertex buffer setup shared by every tile sub-copy, instead of
+     * re-running the full composite state setup per tile pair.
+     */
+    {
+        BoxPtr extents = RegionExtents(region);
+
+        if (glamor_composite_is_copy(op, source, mask, dest,
+                                     x_source, y_source,
+                                     extents->x2 - extents->x1,
+                                     extents->y2 - extents->y1)) {
+            glamor_copy(source->pDrawable, dest->pDrawable, NULL,
+                        RegionRects(region), RegionNumRects(region),
+                        (x_source + source->pDrawable->x) -
+                        (x_dest + dest->pDrawable->x),
+                        (y_source + source->pDrawable->y) -
+                        (y_dest + dest->pDrawable->y),
+                        FALSE, FALSE, 0, NULL);
+            return TRUE;
+        }
+    }
+
     if (source->repeat)
         source_repeat_type = source->repeatType;
     else
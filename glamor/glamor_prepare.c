@@ -226,6 +226,29 @@ glamor_prepare_access_box(DrawablePtr drawable, glamor_access_t access,
     return glamor_prep_drawable_box(drawable, access, &box);
 }
 
+/*
+ * Prepare only the area a clipped fb fallback can touch.  The clip is
+ * in drawable coordinates including drawable->x/y, the way
+ * gc->pCompositeClip is kept, so a small window on a large screen
+ * pixmap downloads kilobytes instead of the whole screen.
+ */
+Bool
+glamor_prepare_access_clip(DrawablePtr drawable, glamor_access_t access,
+                           RegionPtr clip)
+{
+    BoxPtr extents;
+
+    if (!clip)
+        return glamor_prepare_access(drawable, access);
+
+    extents = RegionExtents(clip);
+    return glamor_prepare_access_box(drawable, access,
+                                     extents->x1 - drawable->x,
+                                     extents->y1 - drawable->y,
+                                     extents->x2 - extents->x1,
+                                     extents->y2 - extents->y1);
+}
+
 /*
  * Make a picture ready to use with fb.
  */
@@ -30,6 +30,10 @@ Bool
 glamor_prepare_access_box(DrawablePtr drawable, glamor_access_t access,
                          int x, int y, int w, int h);
 
+Bool
+glamor_prepare_access_clip(DrawablePtr drawable, glamor_access_t access,
+                           RegionPtr clip);
+
 void
 glamor_finish_access(DrawablePtr drawable);
 
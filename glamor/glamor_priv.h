@@ -205,6 +205,83 @@ struct glamor_format {
     Bool texture_only;
 };
 
+/*
+ * Snapshot of the Render state a pending composite batch was keyed on.
+ * Compared with memcmp, so glamor_render_batch_state() zeroes the whole
+ * struct before filling it in.
+ */
+struct glamor_render_batch_pict {
+    PicturePtr picture;
+    PixmapPtr pixmap;
+    CARD32 format;
+    CARD32 solid_color;
+    int filter;
+    CARD8 repeat_type;
+    Bool component_alpha;
+    Bool has_transform;
+    PictTransform transform;
+    PicturePtr alpha_map;
+};
+
+struct glamor_render_batch_state {
+    CARD8 op;
+    struct glamor_render_batch_pict source;
+    struct glamor_render_batch_pict mask;
+    struct glamor_render_batch_pict dest;
+};
+
+/*
+ * Vertex data accumulated across consecutive Composite requests that
+ * share all GL state (program, textures, uniforms, blend).  Flushed
+ * from glamor_make_current() before anything else touches GL.
+ */
+struct glamor_render_batch {
+    Bool valid;
+    struct glamor_render_batch_state state;
+    Bool has_source_coords;
+    Bool has_mask_coords;
+    Bool restore_colormask;
+    int vb_stride;              /* floats per vertex */
+    int nquads;
+    BoxRec bounds;              /* dest pixmap coordinates */
+    float *verts;
+    int verts_alloc;            /* capacity of verts, in floats */
+};
+
+#define GLAMOR_GRADIENT_CACHE_SIZE      16
+#define GLAMOR_GRADIENT_CACHE_STOPS     16
+
+/*
+ * Everything a realized gradient picture depends on, captured by value.
+ * Compared with memcmp, so glamor_gradient_key_init() zeroes the whole
+ * struct before filling it in.  Gradient stop vectors are immutable
+ * after CreatePicture and the transform/repeat are part of the key, so
+ * cached entries never need invalidating.
+ */
+struct glamor_gradient_key {
+    unsigned int type;
+    CARD8 repeat_type;
+    Bool has_transform;
+    PictTransform transform;
+    INT16 x_source;
+    INT16 y_source;
+    CARD16 width;
+    CARD16 height;
+    CARD32 format;
+    xPointFixed p1;             /* linear points or radial centres */
+    xPointFixed p2;
+    xFixed r1;                  /* radial radii, zero for linear */
+    xFixed r2;
+    int nstops;
+    PictGradientStop stops[GLAMOR_GRADIENT_CACHE_STOPS];
+};
+
+struct glamor_gradient_cache_entry {
+    PicturePtr picture;
+    CARD32 serial;              /* for LRU eviction */
+    struct glamor_gradient_key key;
+};
+
 struct glamor_saved_procs {
     CreateGCProcPtr create_gc;
     CreatePixmapProcPtr create_pixmap;
@@ -243,12 +320,22 @@ typedef struct glamor_screen_private {
     Bool has_clear_texture;
     Bool has_texture_swizzle;
     Bool has_rg;
+    Bool has_program_binary;
+    Bool has_sync;
+    Bool has_meminfo_ati;
+    Bool has_meminfo_nvx;
     Bool is_core_profile;
     Bool can_copyplane;
     Bool use_gpu_shader4;
     int max_fbo_size;
     Bool enable_gradient_shader;
 
+    /* program binary disk cache directory, NULL when disabled */
+    char *program_cache_dir;
+
+    /* pending asynchronous PBO downloads, oldest first */
+    struct glamor_transfer *transfers;
+
     /**
      * Stores information about supported formats. Note, that this list contains all
      * supported pixel formats, including these that are not supported on GL side
@@ -303,6 +390,14 @@ typedef struct glamor_screen_private {
     int vbo_offset;
     int vbo_size;
     Bool vbo_mapped;
+    /**
+     * Ring state for the persistently-mapped (ARB_buffer_storage) VBO:
+     * one fence per ring segment, created when the write head leaves
+     * the segment and waited on before the next lap reuses it.
+     */
+#define GLAMOR_VBO_RING_SEGMENTS 4
+    GLsync vbo_fences[GLAMOR_VBO_RING_SEGMENTS];
+    int vbo_fence_segment;
     /**
      * Pointer to glamor_get_vbo_space()'s current VBO mapping.
      *
@@ -321,6 +416,13 @@ typedef struct glamor_screen_private {
 
     Bool has_source_coords, has_mask_coords;
     int render_nr_quads;
+    struct glamor_render_batch render_batch;
+
+    /* FBO cache (glamor_fbo.c): LRU of idle framebuffer storage. */
+    struct xorg_list fbo_cache[GLAMOR_FBO_CACHE_BUCKETS];
+    size_t fbo_cache_bytes;
+    size_t fbo_cache_max_bytes;
+    CARD32 fbo_cache_tick;
     glamor_composite_shader composite_shader[SHADER_SOURCE_COUNT]
         [SHADER_MASK_COUNT]
         [glamor_program_alpha_count]
@@ -331,6 +433,9 @@ typedef struct glamor_screen_private {
     GLint gradient_prog[SHADER_GRADIENT_COUNT][3];
     int linear_max_nstops;
     int radial_max_nstops;
+    struct glamor_gradient_cache_entry
+        gradient_cache[GLAMOR_GRADIENT_CACHE_SIZE];
+    CARD32 gradient_cache_serial;
 
     struct glamor_saved_procs saved_procs;
     GetDrawableModifiersFuncPtr get_drawable_modifiers;
@@ -365,7 +470,20 @@ enum glamor_fbo_state {
     GLAMOR_FBO_NORMAL,
 };
 
+/** Number of size/format buckets in the FBO cache. */
+#define GLAMOR_FBO_CACHE_BUCKETS 16
+
 typedef struct glamor_pixmap_fbo {
+    /** Entry in a glamor_screen_private::fbo_cache bucket while cached. */
+    struct xorg_list list;
+    /** fbo_cache_tick value when this entry was cached. */
+    CARD32 expire;
+    /** Approximate texture size in bytes, for cache accounting. */
+    size_t bytes;
+    /** GL internalformat the texture was allocated with. */
+    GLenum internalformat;
+    /** Whether glamor allocated the texture itself (so it may be cached). */
+    Bool cacheable;
     GLuint tex; /**< GL texture name */
     GLuint fb; /**< GL FBO name */
     int width; /**< width in pixels */
@@ -622,6 +740,9 @@ glamor_pixmap_fbo *glamor_create_fbo(glamor_screen_private *glamor_priv,
                                      PixmapPtr pixmap, int w, int h, int flag);
 void glamor_destroy_fbo(glamor_screen_private *glamor_priv,
                         glamor_pixmap_fbo *fbo);
+void glamor_fbo_init(ScreenPtr screen);
+void glamor_fbo_fini(ScreenPtr screen);
+void glamor_fbo_expire(glamor_screen_private *glamor_priv);
 void glamor_pixmap_destroy_fbo(PixmapPtr pixmap);
 Bool glamor_pixmap_fbo_fixup(ScreenPtr screen, PixmapPtr pixmap);
 void glamor_pixmap_clear_fbo(glamor_screen_private *glamor_priv, glamor_pixmap_fbo *fbo,
@@ -664,6 +785,14 @@ void glamor_get_drawable_deltas(DrawablePtr drawable, PixmapPtr pixmap,
 GLint glamor_compile_glsl_prog(GLenum type, const char *source);
 Bool glamor_link_glsl_prog(ScreenPtr screen, GLint prog,
                            const char *format, ...) _X_ATTRIBUTE_PRINTF(3,4);
+
+/* glamor_program_cache.c */
+void glamor_program_cache_init(ScreenPtr screen);
+void glamor_program_cache_fini(ScreenPtr screen);
+Bool glamor_program_cache_load(ScreenPtr screen, GLuint prog,
+                               const char *vs, const char *fs);
+void glamor_program_cache_store(ScreenPtr screen, GLuint prog,
+                                const char *vs, const char *fs);
 void glamor_get_color_4f_from_pixel(PixmapPtr pixmap,
                                     unsigned long fg_pixel, GLfloat *color);
 
@@ -684,6 +813,15 @@ void
 glamor_track_stipple(GCPtr gc);
 
 /* glamor_render.c */
+void glamor_render_batch_flush(glamor_screen_private *glamor_priv);
+
+Bool glamor_composite_is_copy(CARD8 op,
+                              PicturePtr source,
+                              PicturePtr mask,
+                              PicturePtr dest,
+                              int x_source, int y_source,
+                              int width, int height);
+
 Bool glamor_composite_clipped_region(CARD8 op,
                                      PicturePtr source,
                                      PicturePtr mask,
@@ -719,6 +857,7 @@ void glamor_trapezoids(CARD8 op,
 
 /* glamor_gradient.c */
 Bool glamor_init_gradient_shader(ScreenPtr screen);
+void glamor_gradient_fini(ScreenPtr screen);
 PicturePtr glamor_generate_linear_gradient_picture(ScreenPtr screen,
                                                    PicturePtr src_picture,
                                                    int x_source, int y_source,
@@ -358,6 +358,13 @@ glamor_build_program(ScreenPtr          screen,
     prog->fill_use = fill->use;
     prog->fill_use_render = fill->use_render;
 
+    /* Cache hit loads a ready-linked binary; attribute and frag data
+     * bindings are baked into it from the original link.
+     */
+    if (glamor_program_cache_load(screen, prog->prog,
+                                  vs_prog_string, fs_prog_string))
+        goto linked;
+
     vs_prog = glamor_compile_glsl_prog(GL_VERTEX_SHADER, vs_prog_string);
     fs_prog = glamor_compile_glsl_prog(GL_FRAGMENT_SHADER, fs_prog_string);
     glAttachShader(prog->prog, vs_prog);
@@ -377,9 +384,17 @@ glamor_build_program(ScreenPtr          screen,
         glBindFragDataLocationIndexed(prog->prog, 0, 1, "color1");
     }
 
+    if (glamor_priv->has_program_binary)
+        glProgramParameteri(prog->prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+
     if (!glamor_link_glsl_prog(screen, prog->prog, "%s_%s", prim->name, fill->name))
         goto fail;
 
+    glamor_program_cache_store(screen, prog->prog,
+                               vs_prog_string, fs_prog_string);
+
+linked:
     prog->matrix_uniform = glamor_get_uniform(prog, glamor_program_location_none, "v_matrix");
     prog->fg_uniform = glamor_get_uniform(prog, glamor_program_location_fg, "fg");
     prog->bg_uniform = glamor_get_uniform(prog, glamor_program_location_bg, "bg");
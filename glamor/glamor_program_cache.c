@@ -0,0 +1,284 @@
+/*
+ * Copyright © 2014 Keith Packard
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+/** @file glamor_program_cache.c
+ *
+ * On-disk cache of linked GL program binaries, so warm server starts
+ * reload programs with glProgramBinary() instead of recompiling GLSL.
+ *
+ * Entries are keyed by a SHA1 of the driver identification strings and
+ * the exact vertex and fragment shader source, so a driver update or a
+ * shader change simply misses and falls back to source compilation.  A
+ * stale or corrupt binary is rejected by the driver (GL_LINK_STATUS) and
+ * likewise falls back, so the cache is purely advisory.
+ */
+#include <dix-config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "glamor_priv.h"
+#include "os/xsha1.h"
+
+#define GLAMOR_PROGRAM_CACHE_MAGIC      0x474c5043      /* "GLPC" */
+
+/* Reject obviously damaged headers before trusting the length field */
+#define GLAMOR_PROGRAM_CACHE_MAX_BINARY (16 * 1024 * 1024)
+
+struct glamor_program_cache_header {
+    uint32_t magic;
+    uint32_t format;            /* GL program binary format token */
+    uint32_t length;            /* payload length in bytes */
+};
+
+/* Hash the driver identity and shader source into a cache file name */
+static Bool
+glamor_program_cache_name(const char *vs, const char *fs, char name[41])
+{
+    GLenum ids[4] = { GL_VENDOR, GL_RENDERER, GL_VERSION,
+                      GL_SHADING_LANGUAGE_VERSION };
+    unsigned char digest[20];
+    void *ctx;
+    int i;
+
+    ctx = x_sha1_init();
+    if (!ctx)
+        return FALSE;
+
+    for (i = 0; i < ARRAY_SIZE(ids); i++) {
+        const char *s = (const char *) glGetString(ids[i]);
+
+        if (s && !x_sha1_update(ctx, (void *) s, strlen(s) + 1))
+            goto fail;
+    }
+    if (!x_sha1_update(ctx, (void *) vs, strlen(vs) + 1) ||
+        !x_sha1_update(ctx, (void *) fs, strlen(fs) + 1))
+        goto fail;
+    if (!x_sha1_final(ctx, digest))
+        return FALSE;
+
+    for (i = 0; i < 20; i++)
+        sprintf(name + i * 2, "%02x", digest[i]);
+    return TRUE;
+
+ fail:
+    x_sha1_final(ctx, digest);
+    return FALSE;
+}
+
+static char *
+glamor_program_cache_path(glamor_screen_private *glamor_priv,
+                          const char *vs, const char *fs)
+{
+    char name[41];
+    char *path;
+
+    if (!glamor_program_cache_name(vs, fs, name))
+        return NULL;
+    if (asprintf(&path, "%s/%s.bin", glamor_priv->program_cache_dir,
+                 name) < 0)
+        return NULL;
+    return path;
+}
+
+void
+glamor_program_cache_init(ScreenPtr screen)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    GLint num_formats = 0;
+    const char *env;
+    char *dir = NULL;
+
+    glamor_priv->has_program_binary =
+        epoxy_has_gl_extension("GL_ARB_get_program_binary") ||
+        (glamor_priv->is_gles && epoxy_gl_version() >= 30);
+    if (!glamor_priv->has_program_binary)
+        return;
+
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    if (num_formats < 1) {
+        glamor_priv->has_program_binary = FALSE;
+        return;
+    }
+
+    /* GLAMOR_SHADER_CACHE_DIR overrides the location; setting it to the
+     * empty string disables the disk cache entirely.
+     */
+    env = getenv("GLAMOR_SHADER_CACHE_DIR");
+    if (env) {
+        if (*env)
+            dir = strdup(env);
+    }
+    else if ((env = getenv("XDG_CACHE_HOME")) && env[0] == '/') {
+        if (asprintf(&dir, "%s/xorg-glamor", env) < 0)
+            dir = NULL;
+    }
+    else if ((env = getenv("HOME")) && env[0] == '/') {
+        if (asprintf(&dir, "%s/.cache/xorg-glamor", env) < 0)
+            dir = NULL;
+    }
+    if (!dir)
+        return;
+
+    if (mkdir(dir, 0700) < 0 && errno != EEXIST) {
+        LogMessage(X_WARNING,
+                   "glamor%d: Cannot create shader cache directory %s: %s\n",
+                   screen->myNum, dir, strerror(errno));
+        free(dir);
+        return;
+    }
+
+    glamor_priv->program_cache_dir = dir;
+}
+
+void
+glamor_program_cache_fini(ScreenPtr screen)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+
+    free(glamor_priv->program_cache_dir);
+    glamor_priv->program_cache_dir = NULL;
+}
+
+/**
+ * Try to populate @prog from a cached binary for the given shader
+ * source.  Returns TRUE if the program linked from the binary and is
+ * ready to use; on FALSE the caller compiles from source as usual.
+ */
+Bool
+glamor_program_cache_load(ScreenPtr screen, GLuint prog,
+                          const char *vs, const char *fs)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    struct glamor_program_cache_header header;
+    char *path;
+    FILE *f;
+    void *data = NULL;
+    GLint ok = 0;
+
+    if (!glamor_priv->program_cache_dir)
+        return FALSE;
+
+    path = glamor_program_cache_path(glamor_priv, vs, fs);
+    if (!path)
+        return FALSE;
+
+    f = fopen(path, "rb");
+    free(path);
+    if (!f)
+        return FALSE;
+
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        header.magic != GLAMOR_PROGRAM_CACHE_MAGIC ||
+        header.length == 0 ||
+        header.length > GLAMOR_PROGRAM_CACHE_MAX_BINARY)
+        goto bail;
+
+    data = malloc(header.length);
+    if (!data || fread(data, header.length, 1, f) != 1)
+        goto bail;
+    fclose(f);
+
+    glProgramBinary(prog, header.format, data, header.length);
+    free(data);
+
+    /* An unrecognized format or stale binary leaves the program
+     * unlinked (and may raise a GL error); drain it so it can't trip
+     * later error checks, and fall back to source compilation.
+     */
+    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok)
+        while (glGetError() != GL_NO_ERROR);
+    return !!ok;
+
+ bail:
+    free(data);
+    fclose(f);
+    return FALSE;
+}
+
+/**
+ * Save the binary for a freshly linked @prog.  Failures here only cost
+ * us the next warm start, so they are silently ignored beyond cleanup.
+ */
+void
+glamor_program_cache_store(ScreenPtr screen, GLuint prog,
+                           const char *vs, const char *fs)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    struct glamor_program_cache_header header;
+    char *path, *tmp = NULL;
+    void *data = NULL;
+    GLint length = 0;
+    GLsizei written = 0;
+    GLenum format = 0;
+    FILE *f = NULL;
+
+    if (!glamor_priv->program_cache_dir)
+        return;
+
+    glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || length > GLAMOR_PROGRAM_CACHE_MAX_BINARY)
+        return;
+
+    data = malloc(length);
+    if (!data)
+        return;
+    glGetProgramBinary(prog, length, &written, &format, data);
+    if (written <= 0 || written > length)
+        goto bail;
+
+    path = glamor_program_cache_path(glamor_priv, vs, fs);
+    if (!path)
+        goto bail;
+
+    /* Write to a private temporary and rename, so a concurrent server
+     * never reads a half-written entry.
+     */
+    if (asprintf(&tmp, "%s.%d.tmp", path, getpid()) < 0) {
+        free(path);
+        goto bail;
+    }
+
+    f = fopen(tmp, "wb");
+    if (f) {
+        Bool ok;
+
+        header.magic = GLAMOR_PROGRAM_CACHE_MAGIC;
+        header.format = format;
+        header.length = written;
+        ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+             fwrite(data, written, 1, f) == 1;
+        if (fclose(f) != 0)
+            ok = FALSE;
+        if (!ok || rename(tmp, path) < 0)
+            unlink(tmp);
+    }
+
+    free(tmp);
+    free(path);
+ bail:
+    free(data);
+}
@@ -184,7 +184,8 @@ glamor_poly_fill_rect_bail(DrawablePtr drawable,
 {
     glamor_fallback("to %p (%c)\n", drawable,
                     glamor_get_drawable_location(drawable));
-    if (glamor_prepare_access(drawable, GLAMOR_ACCESS_RW) &&
+    if (glamor_prepare_access_clip(drawable, GLAMOR_ACCESS_RW,
+                                   gc->pCompositeClip) &&
         glamor_prepare_access_gc(gc)) {
         fbPolyFillRect(drawable, gc, nrect, prect);
     }
@@ -1210,6 +1210,309 @@ glamor_composite_set_shader_blend(glamor_screen_private *glamor_priv,
     }
 }
 
+static void
+glamor_render_batch_state_pict(struct glamor_render_batch_pict *bp,
+                               PicturePtr picture, PixmapPtr pixmap)
+{
+    if (!picture)
+        return;
+
+    bp->picture = picture;
+    bp->pixmap = pixmap;
+    bp->format = picture->format;
+    bp->filter = picture->filter;
+    bp->repeat_type = picture->repeatType;
+    bp->component_alpha = picture->componentAlpha;
+    bp->alpha_map = picture->alphaMap;
+    if (picture->transform) {
+        bp->has_transform = TRUE;
+        bp->transform = *picture->transform;
+    }
+    if (!picture->pDrawable && picture->pSourcePict &&
+        picture->pSourcePict->type == SourcePictTypeSolidFill)
+        bp->solid_color = picture->pSourcePict->solidFill.color;
+}
+
+static void
+glamor_render_batch_state(struct glamor_render_batch_state *state,
+                          CARD8 op,
+                          PicturePtr source, PicturePtr mask, PicturePtr dest,
+                          PixmapPtr source_pixmap, PixmapPtr mask_pixmap)
+{
+    memset(state, 0, sizeof(*state));
+    state->op = op;
+    glamor_render_batch_state_pict(&state->source, source, source_pixmap);
+    glamor_render_batch_state_pict(&state->mask, mask, mask_pixmap);
+    glamor_render_batch_state_pict(&state->dest, dest,
+                                   glamor_get_drawable_pixmap(dest->pDrawable));
+}
+
+/*
+ * Emit vertex data for nrect composite rects into the pending batch.
+ * Offsets, scales and transforms are recomputed from the pictures here
+ * rather than carried in the batch: they are pure CPU state, so they
+ * can change between appends (e.g. a window move) without any GL call
+ * flushing the batch first.
+ */
+static Bool
+glamor_render_batch_emit(glamor_screen_private *glamor_priv,
+                         PicturePtr source, PicturePtr mask, PicturePtr dest,
+                         PixmapPtr source_pixmap, PixmapPtr mask_pixmap,
+                         int nrect, glamor_composite_rect_t *rects)
+{
+    struct glamor_render_batch *batch = &glamor_priv->render_batch;
+    PixmapPtr dest_pixmap = glamor_get_drawable_pixmap(dest->pDrawable);
+    glamor_pixmap_private *dest_pixmap_priv = glamor_get_pixmap_private(dest_pixmap);
+    glamor_pixmap_private *source_pixmap_priv = NULL;
+    glamor_pixmap_private *mask_pixmap_priv = NULL;
+    GLfloat dst_xscale, dst_yscale;
+    GLfloat mask_xscale = 1, mask_yscale = 1, src_xscale = 1, src_yscale = 1;
+    int dest_x_off, dest_y_off;
+    int source_x_off = 0, source_y_off = 0;
+    int mask_x_off = 0, mask_y_off = 0;
+    float src_matrix[9], mask_matrix[9];
+    float *psrc_matrix = NULL, *pmask_matrix = NULL;
+    int vb_stride = batch->vb_stride;
+    int need = (batch->nquads + nrect) * 4 * vb_stride;
+    float *vertices;
+
+    if (need > batch->verts_alloc) {
+        float *verts = realloc(batch->verts, need * sizeof(float));
+
+        if (!verts)
+            return FALSE;
+        batch->verts = verts;
+        batch->verts_alloc = need;
+    }
+    vertices = batch->verts + batch->nquads * 4 * vb_stride;
+
+    glamor_get_drawable_deltas(dest->pDrawable, dest_pixmap,
+                               &dest_x_off, &dest_y_off);
+    pixmap_priv_get_dest_scale(dest_pixmap, dest_pixmap_priv,
+                               &dst_xscale, &dst_yscale);
+
+    if (batch->has_source_coords) {
+        source_pixmap_priv = glamor_get_pixmap_private(source_pixmap);
+        glamor_get_drawable_deltas(source->pDrawable,
+                                   source_pixmap, &source_x_off, &source_y_off);
+        pixmap_priv_get_scale(source_pixmap_priv, &src_xscale, &src_yscale);
+        if (source->transform) {
+            psrc_matrix = src_matrix;
+            glamor_picture_get_matrixf(source, psrc_matrix);
+        }
+    }
+
+    if (batch->has_mask_coords) {
+        mask_pixmap_priv = glamor_get_pixmap_private(mask_pixmap);
+        glamor_get_drawable_deltas(mask->pDrawable, mask_pixmap,
+                                   &mask_x_off, &mask_y_off);
+        pixmap_priv_get_scale(mask_pixmap_priv, &mask_xscale, &mask_yscale);
+        if (mask->transform) {
+            pmask_matrix = mask_matrix;
+            glamor_picture_get_matrixf(mask, pmask_matrix);
+        }
+    }
+
+    while (nrect--) {
+        INT16 x_dest = rects->x_dst + dest_x_off;
+        INT16 y_dest = rects->y_dst + dest_y_off;
+        INT16 x_source = rects->x_src + source_x_off;
+        INT16 y_source = rects->y_src + source_y_off;
+        INT16 x_mask = rects->x_mask + mask_x_off;
+        INT16 y_mask = rects->y_mask + mask_y_off;
+        CARD16 width = rects->width;
+        CARD16 height = rects->height;
+        BoxRec box = {
+            .x1 = x_dest,
+            .y1 = y_dest,
+            .x2 = x_dest + width,
+            .y2 = y_dest + height,
+        };
+
+        glamor_bounds_union_box(&batch->bounds, &box);
+
+        glamor_set_normalize_vcoords_ext(dest_pixmap_priv, dst_xscale,
+                                         dst_yscale, x_dest, y_dest,
+                                         x_dest + width, y_dest + height,
+                                         vertices,
+                                         vb_stride);
+        vertices += 2;
+        if (batch->has_source_coords) {
+            glamor_set_normalize_tcoords_generic(source_pixmap,
+                                                 source_pixmap_priv,
+                                                 source->repeatType,
+                                                 psrc_matrix, src_xscale,
+                                                 src_yscale, x_source,
+                                                 y_source, x_source + width,
+                                                 y_source + height,
+                                                 vertices, vb_stride);
+            vertices += 2;
+        }
+        if (batch->has_mask_coords) {
+            glamor_set_normalize_tcoords_generic(mask_pixmap,
+                                                 mask_pixmap_priv,
+                                                 mask->repeatType,
+                                                 pmask_matrix, mask_xscale,
+                                                 mask_yscale, x_mask,
+                                                 y_mask, x_mask + width,
+                                                 y_mask + height,
+                                                 vertices, vb_stride);
+            vertices += 2;
+        }
+        batch->nquads++;
+        rects++;
+
+        /* We've incremented by one of our 4 verts, now do the other 3. */
+        vertices += 3 * vb_stride;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Fast path for a composite whose GL state the pending batch already
+ * has configured: emit vertices and return without touching GL.  A
+ * mismatch just returns FALSE; the immediate path's first
+ * glamor_make_current() then flushes the stale batch.
+ */
+static Bool
+glamor_render_batch_append(glamor_screen_private *glamor_priv,
+                           CARD8 op,
+                           PicturePtr source, PicturePtr mask, PicturePtr dest,
+                           PixmapPtr source_pixmap, PixmapPtr mask_pixmap,
+                           int nrect, glamor_composite_rect_t *rects,
+                           enum ca_state ca_state)
+{
+    struct glamor_render_batch *batch = &glamor_priv->render_batch;
+    struct glamor_render_batch_state state;
+
+    if (!batch->valid || ca_state != CA_NONE || nrect <= 0)
+        return FALSE;
+
+    if (batch->nquads + nrect > GLAMOR_COMPOSITE_VBO_VERT_CNT / 4)
+        return FALSE;
+
+    glamor_render_batch_state(&state, op, source, mask, dest,
+                              source_pixmap, mask_pixmap);
+    if (memcmp(&state, &batch->state, sizeof(state)) != 0)
+        return FALSE;
+
+    return glamor_render_batch_emit(glamor_priv, source, mask, dest,
+                                    source_pixmap, mask_pixmap, nrect, rects);
+}
+
+/*
+ * Start a new pending batch off a composite whose GL state has just
+ * been fully configured.  Memory pixmaps are excluded because their
+ * temporary FBOs are destroyed when the composite returns, and large
+ * pixmaps because they need a draw per FBO tile.
+ */
+static Bool
+glamor_render_batch_capture(glamor_screen_private *glamor_priv,
+                            CARD8 op,
+                            PicturePtr source, PicturePtr mask, PicturePtr dest,
+                            PixmapPtr source_pixmap, PixmapPtr mask_pixmap,
+                            glamor_pixmap_private *source_pixmap_priv,
+                            glamor_pixmap_private *mask_pixmap_priv,
+                            glamor_pixmap_private *dest_pixmap_priv,
+                            Bool restore_colormask,
+                            int nrect, glamor_composite_rect_t *rects)
+{
+    struct glamor_render_batch *batch = &glamor_priv->render_batch;
+
+    if (batch->valid)
+        return FALSE;
+
+    if (nrect <= 0 || nrect > GLAMOR_COMPOSITE_VBO_VERT_CNT / 4)
+        return FALSE;
+
+    if (glamor_pixmap_priv_is_large(dest_pixmap_priv))
+        return FALSE;
+
+    if (source_pixmap &&
+        (glamor_pixmap_is_memory(source_pixmap) ||
+         glamor_pixmap_priv_is_large(source_pixmap_priv)))
+        return FALSE;
+
+    if (mask_pixmap &&
+        (glamor_pixmap_is_memory(mask_pixmap) ||
+         glamor_pixmap_priv_is_large(mask_pixmap_priv)))
+        return FALSE;
+
+    if (source && !source->pDrawable &&
+        source->pSourcePict->type != SourcePictTypeSolidFill)
+        return FALSE;
+
+    if (mask && !mask->pDrawable &&
+        mask->pSourcePict->type != SourcePictTypeSolidFill)
+        return FALSE;
+
+    glamor_render_batch_state(&batch->state, op, source, mask, dest,
+                              source_pixmap, mask_pixmap);
+    batch->has_source_coords = glamor_priv->has_source_coords;
+    batch->has_mask_coords = glamor_priv->has_mask_coords;
+    batch->vb_stride = 2 + (batch->has_source_coords ? 2 : 0) +
+        (batch->has_mask_coords ? 2 : 0);
+    batch->restore_colormask = restore_colormask;
+    batch->nquads = 0;
+    batch->bounds = glamor_start_rendering_bounds();
+
+    if (!glamor_render_batch_emit(glamor_priv, source, mask, dest,
+                                  source_pixmap, mask_pixmap, nrect, rects))
+        return FALSE;
+
+    batch->valid = TRUE;
+    return TRUE;
+}
+
+/*
+ * Draw the pending batch with the GL state still configured from
+ * capture time, then tear that state down the way the immediate path
+ * would have.  Called from glamor_make_current(); clearing valid up
+ * front keeps the make_current calls below from recursing.
+ */
+void
+glamor_render_batch_flush(glamor_screen_private *glamor_priv)
+{
+    struct glamor_render_batch *batch = &glamor_priv->render_batch;
+    ScreenPtr screen = glamor_priv->screen;
+
+    if (!batch->valid)
+        return;
+    batch->valid = FALSE;
+
+    if (batch->nquads &&
+        batch->bounds.x1 < batch->bounds.x2 &&
+        batch->bounds.y1 < batch->bounds.y2) {
+        float *vertices;
+
+        glamor_priv->has_source_coords = batch->has_source_coords;
+        glamor_priv->has_mask_coords = batch->has_mask_coords;
+        vertices = glamor_setup_composite_vbo(screen, batch->nquads * 4);
+        memcpy(vertices, batch->verts,
+               batch->nquads * 4 * batch->vb_stride * sizeof(float));
+        glamor_priv->render_nr_quads = batch->nquads;
+        glamor_put_vbo_space(screen);
+
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(batch->bounds.x1,
+                  batch->bounds.y1,
+                  batch->bounds.x2 - batch->bounds.x1,
+                  batch->bounds.y2 - batch->bounds.y1);
+        glamor_flush_composite_rects(screen);
+        glDisable(GL_SCISSOR_TEST);
+    }
+
+    if (batch->restore_colormask)
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDisableVertexAttribArray(GLAMOR_VERTEX_POS);
+    glDisableVertexAttribArray(GLAMOR_VERTEX_SOURCE);
+    glDisableVertexAttribArray(GLAMOR_VERTEX_MASK);
+    glDisable(GL_BLEND);
+
+    batch->nquads = 0;
+}
+
 static Bool
 glamor_composite_with_shader(CARD8 op,
                              PicturePtr source,
@@ -1241,6 +1544,11 @@ glamor_composite_with_shader(CARD8 op,
     struct blendinfo op_info, op_info_ca;
     Bool restore_colormask = FALSE;
 
+    if (glamor_render_batch_append(glamor_priv, op, source, mask, dest,
+                                   source_pixmap, mask_pixmap,
+                                   nrect, rects, ca_state))
+        return TRUE;
+
     if (!glamor_composite_choose_shader(op, source, mask, dest,
                                         source_pixmap, mask_pixmap, dest_pixmap,
                                         source_pixmap_priv, mask_pixmap_priv,
@@ -1280,6 +1588,23 @@ glamor_composite_with_shader(CARD8 op,
     glamor_priv->has_mask_coords = (key.mask != SHADER_MASK_NONE &&
                                     key.mask != SHADER_MASK_SOLID);
 
+    /* With the GL state now fully configured, try parking the vertex
+     * data in the pending batch instead of drawing: follow-up
+     * composites sharing this state append to it, and the batch is
+     * flushed from glamor_make_current() before anything else can
+     * touch GL.
+     */
+    if (ca_state == CA_NONE &&
+        glamor_render_batch_capture(glamor_priv, op, source, mask, dest,
+                                    source_pixmap, mask_pixmap,
+                                    source_pixmap_priv, mask_pixmap_priv,
+                                    dest_pixmap_priv, restore_colormask,
+                                    nrect, rects)) {
+        if (saved_source_format)
+            source->format = saved_source_format;
+        return TRUE;
+    }
+
     dest_pixmap = glamor_get_drawable_pixmap(dest->pDrawable);
     dest_pixmap_priv = glamor_get_pixmap_private(dest_pixmap);
     glamor_get_drawable_deltas(dest->pDrawable, dest_pixmap,
@@ -1497,6 +1822,41 @@ glamor_convert_gradient_picture(ScreenPtr screen,
     return dst;
 }
 
+/**
+ * Returns whether compositing width x height pixels read from
+ * (x_source, y_source) is equivalent to a plain copy of the region
+ * from source to dest.
+ */
+Bool
+glamor_composite_is_copy(CARD8 op,
+                         PicturePtr source,
+                         PicturePtr mask,
+                         PicturePtr dest,
+                         int x_source, int y_source, int width, int height)
+{
+    return source &&
+        !mask && !source->alphaMap && !dest->alphaMap
+        && source->pDrawable && !source->transform
+        /* CopyArea is only defined with matching depths. */
+        && dest->pDrawable->depth == source->pDrawable->depth
+        && ((op == PictOpSrc
+             && (source->format == dest->format
+                 || (PIXMAN_FORMAT_COLOR(dest->format)
+                     && PIXMAN_FORMAT_COLOR(source->format)
+                     && dest->format == PIXMAN_FORMAT(PIXMAN_FORMAT_BPP(source->format),
+                                                    PIXMAN_FORMAT_TYPE(source->format),
+                                                    0,
+                                                    PIXMAN_FORMAT_R(source->format),
+                                                    PIXMAN_FORMAT_G(source->format),
+                                                    PIXMAN_FORMAT_B(source->format)))))
+            || (op == PictOpOver
+                && source->format == dest->format
+                && !PIXMAN_FORMAT_A(source->format)))
+        && x_source >= 0 && y_source >= 0
+        && (x_source + width) <= source->pDrawable->width
+        && (y_source + height) <= source->pDrawable->height;
+}
+
 Bool
 glamor_composite_clipped_region(CARD8 op,
                                 PicturePtr source,
@@ -1548,27 +1908,8 @@ glamor_composite_clipped_region(CARD8 op,
            x_source, y_source, x_mask, y_mask, x_dest, y_dest, width, height);
 
     /* Is the composite operation equivalent to a copy? */
-    if (source &&
-        !mask && !source->alphaMap && !dest->alphaMap
-        && source->pDrawable && !source->transform
-        /* CopyArea is only defined with matching depths. */
-        && dest->pDrawable->depth == source->pDrawable->depth
-        && ((op == PictOpSrc
-             && (source->format == dest->format
-                 || (PIXMAN_FORMAT_COLOR(dest->format)
-                     && PIXMAN_FORMAT_COLOR(source->format)
-                     && dest->format == PIXMAN_FORMAT(PIXMAN_FORMAT_BPP(source->format),
-                                                    PIXMAN_FORMAT_TYPE(source->format),
-                                                    0,
-                                                    PIXMAN_FORMAT_R(source->format),
-                                                    PIXMAN_FORMAT_G(source->format),
-                                                    PIXMAN_FORMAT_B(source->format)))))
-            || (op == PictOpOver
-                && source->format == dest->format
-                && !PIXMAN_FORMAT_A(source->format)))
-        && x_source >= 0 && y_source >= 0
-        && (x_source + width) <= source->pDrawable->width
-        && (y_source + height) <= source->pDrawable->height) {
+    if (glamor_composite_is_copy(op, source, mask, dest,
+                                 x_source, y_source, width, height)) {
         x_source += source->pDrawable->x;
         y_source += source->pDrawable->y;
         x_dest += dest->pDrawable->x;
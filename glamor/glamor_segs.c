@@ -150,7 +150,8 @@ glamor_poly_segment_bail(DrawablePtr drawable, GCPtr gc,
                     glamor_get_drawable_location(drawable));
 
     if (gc->lineWidth == 0) {
-        if (glamor_prepare_access(drawable, GLAMOR_ACCESS_RW) &&
+        if (glamor_prepare_access_clip(drawable, GLAMOR_ACCESS_RW,
+                                       gc->pCompositeClip) &&
             glamor_prepare_access_gc(gc)) {
             fbPolySegment(drawable, gc, nseg, segs);
         }
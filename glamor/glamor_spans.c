@@ -159,7 +159,8 @@ glamor_fill_spans_bail(DrawablePtr drawable,
                        GCPtr gc,
                        int n, DDXPointPtr points, int *widths, int sorted)
 {
-    if (glamor_prepare_access(drawable, GLAMOR_ACCESS_RW) &&
+    if (glamor_prepare_access_clip(drawable, GLAMOR_ACCESS_RW,
+                                   gc->pCompositeClip) &&
         glamor_prepare_access_gc(gc)) {
         fbFillSpans(drawable, gc, n, points, widths, sorted);
     }
@@ -362,7 +363,9 @@ static void
 glamor_set_spans_bail(DrawablePtr drawable, GCPtr gc, char *src,
                       DDXPointPtr points, int *widths, int numPoints, int sorted)
 {
-    if (glamor_prepare_access(drawable, GLAMOR_ACCESS_RW) && glamor_prepare_access_gc(gc))
+    if (glamor_prepare_access_clip(drawable, GLAMOR_ACCESS_RW,
+                                   gc->pCompositeClip) &&
+        glamor_prepare_access_gc(gc))
         fbSetSpans(drawable, gc, src, points, widths, numPoints, sorted);
     glamor_finish_access_gc(gc);
     glamor_finish_access(drawable);
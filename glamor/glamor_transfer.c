@@ -200,3 +200,257 @@ glamor_download_boxes(DrawablePtr drawable, BoxPtr in_boxes, int in_nbox,
     if (glamor_priv->has_pack_subimage)
         glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 }
+
+/*
+ * Asynchronous downloads: glReadPixels into a pixel pack buffer returns
+ * as soon as the commands are queued, so the GPU can DMA the pixels out
+ * while the server keeps working.  A fence marks completion; once it
+ * signals, the rows are copied from the mapped PBO into the caller's
+ * destination and the completion callback runs.  Pending transfers are
+ * polled from the screen block handler.
+ */
+
+/* one clipped box worth of rows, tightly packed in the PBO */
+struct glamor_transfer_seg {
+    size_t              pbo_ofs;
+    size_t              dst_ofs;
+    uint32_t            row_bytes;
+    uint32_t            rows;
+    uint32_t            pbo_stride;
+};
+
+struct glamor_transfer {
+    struct glamor_transfer *next;
+    GLuint              pbo;
+    GLsync              fence;
+    uint8_t             *bits;
+    uint32_t            dst_stride;
+    int                 nseg;
+    struct glamor_transfer_seg *segs;
+    glamor_transfer_callback callback;
+    void                *closure;
+};
+
+static void
+glamor_transfer_complete(struct glamor_transfer *transfer)
+{
+    uint8_t *pbo_bits;
+    int i;
+
+    glDeleteSync(transfer->fence);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, transfer->pbo);
+    pbo_bits = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pbo_bits) {
+        for (i = 0; i < transfer->nseg; i++) {
+            struct glamor_transfer_seg *seg = &transfer->segs[i];
+            uint8_t *src = pbo_bits + seg->pbo_ofs;
+            uint8_t *dst = transfer->bits + seg->dst_ofs;
+            uint32_t row;
+
+            for (row = 0; row < seg->rows; row++) {
+                memcpy(dst, src, seg->row_bytes);
+                src += seg->pbo_stride;
+                dst += transfer->dst_stride;
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glDeleteBuffers(1, &transfer->pbo);
+
+    if (transfer->callback)
+        transfer->callback(transfer->closure);
+    free(transfer->segs);
+    free(transfer);
+}
+
+Bool
+glamor_download_boxes_async(DrawablePtr drawable, BoxPtr in_boxes, int in_nbox,
+                            int dx_src, int dy_src,
+                            int dx_dst, int dy_dst,
+                            uint8_t *bits, uint32_t byte_stride,
+                            glamor_transfer_callback callback, void *closure)
+{
+    ScreenPtr screen = drawable->pScreen;
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    PixmapPtr pixmap = glamor_get_drawable_pixmap(drawable);
+    glamor_pixmap_private *priv = glamor_get_pixmap_private(pixmap);
+    const struct glamor_format *f = glamor_format_for_pixmap(pixmap);
+    int bytes_per_pixel = PIXMAN_FORMAT_BPP(f->render_format) >> 3;
+    struct glamor_transfer *transfer, **prev;
+    struct glamor_transfer_seg *seg;
+    size_t pbo_size = 0;
+    int box_index;
+    int nseg = 0;
+
+    if (!glamor_priv->has_rw_pbo || !glamor_priv->has_sync)
+        return FALSE;
+
+    BUG_RETURN_VAL(!priv, FALSE);
+
+    if (!GLAMOR_PIXMAP_PRIV_HAS_FBO(priv))
+        return FALSE;
+
+    /* Count the clipped boxes and total up the PBO space they need */
+    glamor_pixmap_loop(priv, box_index) {
+        BoxPtr                  box = glamor_pixmap_box_at(priv, box_index);
+        BoxPtr                  boxes = in_boxes;
+        int                     nbox = in_nbox;
+
+        while (nbox--) {
+            int x1 = MAX(boxes->x1 + dx_src, box->x1);
+            int x2 = MIN(boxes->x2 + dx_src, box->x2);
+            int y1 = MAX(boxes->y1 + dy_src, box->y1);
+            int y2 = MIN(boxes->y2 + dy_src, box->y2);
+
+            boxes++;
+            if (x2 <= x1 || y2 <= y1)
+                continue;
+
+            pbo_size += (size_t) (((x2 - x1) * bytes_per_pixel + 3) & ~3) *
+                (y2 - y1);
+            nseg++;
+        }
+    }
+
+    if (!nseg)
+        goto done;
+
+    transfer = calloc(1, sizeof (struct glamor_transfer));
+    if (!transfer)
+        return FALSE;
+    transfer->segs = calloc(nseg, sizeof (struct glamor_transfer_seg));
+    if (!transfer->segs) {
+        free(transfer);
+        return FALSE;
+    }
+    transfer->bits = bits;
+    transfer->dst_stride = byte_stride;
+    transfer->nseg = nseg;
+
+    glamor_make_current(glamor_priv);
+
+    glGenBuffers(1, &transfer->pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, transfer->pbo);
+
+    glamor_priv->suppress_gl_out_of_memory_logging = true;
+    glBufferData(GL_PIXEL_PACK_BUFFER, pbo_size, NULL, GL_STREAM_READ);
+    glamor_priv->suppress_gl_out_of_memory_logging = false;
+
+    if (glGetError() == GL_OUT_OF_MEMORY) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glDeleteBuffers(1, &transfer->pbo);
+        free(transfer->segs);
+        free(transfer);
+        return FALSE;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    if (glamor_priv->has_pack_subimage)
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+    seg = transfer->segs;
+    pbo_size = 0;
+
+    glamor_pixmap_loop(priv, box_index) {
+        BoxPtr                  box = glamor_pixmap_box_at(priv, box_index);
+        glamor_pixmap_fbo       *fbo = glamor_pixmap_fbo_at(priv, box_index);
+        BoxPtr                  boxes = in_boxes;
+        int                     nbox = in_nbox;
+
+        assert(fbo->fb);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo->fb);
+
+        while (nbox--) {
+            int x1 = MAX(boxes->x1 + dx_src, box->x1);
+            int x2 = MIN(boxes->x2 + dx_src, box->x2);
+            int y1 = MAX(boxes->y1 + dy_src, box->y1);
+            int y2 = MIN(boxes->y2 + dy_src, box->y2);
+
+            boxes++;
+            if (x2 <= x1 || y2 <= y1)
+                continue;
+
+            seg->pbo_ofs = pbo_size;
+            seg->dst_ofs = (size_t) (y1 - dy_src + dy_dst) * byte_stride +
+                (x1 - dx_src + dx_dst) * bytes_per_pixel;
+            seg->row_bytes = (x2 - x1) * bytes_per_pixel;
+            seg->rows = y2 - y1;
+            seg->pbo_stride = (seg->row_bytes + 3) & ~3;
+
+            glReadPixels(x1 - box->x1, y1 - box->y1, x2 - x1, y2 - y1,
+                         f->format, f->type,
+                         (void *) (uintptr_t) seg->pbo_ofs);
+
+            pbo_size += (size_t) seg->pbo_stride * seg->rows;
+            seg++;
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    transfer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    for (prev = &glamor_priv->transfers; *prev; prev = &(*prev)->next);
+    *prev = transfer;
+    return TRUE;
+
+ done:
+    if (callback)
+        callback(closure);
+    return TRUE;
+}
+
+/*
+ * Complete any transfers whose fence has signalled, oldest first so
+ * callbacks run in submission order
+ */
+void
+glamor_transfer_poll(ScreenPtr screen)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    struct glamor_transfer *transfer;
+
+    if (!glamor_priv->transfers)
+        return;
+
+    glamor_make_current(glamor_priv);
+
+    while ((transfer = glamor_priv->transfers)) {
+        GLint status = GL_UNSIGNALED;
+
+        glGetSynciv(transfer->fence, GL_SYNC_STATUS, 1, NULL, &status);
+        if (status != GL_SIGNALED)
+            break;
+
+        glamor_priv->transfers = transfer->next;
+        glamor_transfer_complete(transfer);
+    }
+}
+
+/*
+ * Drain all pending transfers, blocking until their data has landed
+ */
+void
+glamor_transfer_finish(ScreenPtr screen)
+{
+    glamor_screen_private *glamor_priv = glamor_get_screen_private(screen);
+    struct glamor_transfer *transfer;
+
+    if (!glamor_priv->transfers)
+        return;
+
+    glamor_make_current(glamor_priv);
+
+    while ((transfer = glamor_priv->transfers)) {
+        GLenum status;
+
+        status = glClientWaitSync(transfer->fence,
+                                  GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (status == GL_TIMEOUT_EXPIRED)
+            status = glClientWaitSync(transfer->fence, 0, 1000 * 1000 * 1000);
+
+        glamor_priv->transfers = transfer->next;
+        glamor_transfer_complete(transfer);
+    }
+}
@@ -40,4 +40,22 @@ glamor_download_boxes(DrawablePtr drawable, BoxPtr in_boxes, int in_nbox,
                       int dx_dst, int dy_dst,
                       uint8_t *bits, uint32_t byte_stride);
 
+/* Called once the downloaded pixels have been copied into the
+ * destination passed to glamor_download_boxes_async()
+ */
+typedef void (*glamor_transfer_callback)(void *closure);
+
+Bool
+glamor_download_boxes_async(DrawablePtr drawable, BoxPtr in_boxes, int in_nbox,
+                            int dx_src, int dy_src,
+                            int dx_dst, int dy_dst,
+                            uint8_t *bits, uint32_t byte_stride,
+                            glamor_transfer_callback callback, void *closure);
+
+void
+glamor_transfer_poll(ScreenPtr screen);
+
+void
+glamor_transfer_finish(ScreenPtr screen);
+
 #endif /* _GLAMOR_TRANSFER_H_ */
@@ -679,6 +679,14 @@ glamor_make_current(glamor_screen_private *glamor_priv)
         glamor_priv->ctx.make_current(&glamor_priv->ctx);
     }
     glamor_priv->dirty = TRUE;
+
+    /* Every GL or CPU-access path enters through here, so the pending
+     * composite batch is drawn before its deferred state can be
+     * disturbed.  Flushing clears valid first, keeping the nested
+     * glamor_make_current() calls made while flushing inert.
+     */
+    if (glamor_priv->render_batch.valid)
+        glamor_render_batch_flush(glamor_priv);
 }
 
 static inline void
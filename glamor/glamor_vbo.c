@@ -39,6 +39,53 @@
  */
 #define GLAMOR_VBO_SIZE (512 * 1024)
 
+static int
+glamor_vbo_segment_size(glamor_screen_private *glamor_priv)
+{
+    return glamor_priv->vbo_size / GLAMOR_VBO_RING_SEGMENTS;
+}
+
+/* created when the write head leaves a segment, so it lands after the
+ * draws that sourced the segment's vertices */
+static void
+glamor_vbo_fence_segment(glamor_screen_private *glamor_priv, int seg)
+{
+    if (glamor_priv->vbo_fences[seg])
+        glDeleteSync(glamor_priv->vbo_fences[seg]);
+    glamor_priv->vbo_fences[seg] =
+        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+static void
+glamor_vbo_wait_segment(glamor_screen_private *glamor_priv, int seg)
+{
+    GLsync fence = glamor_priv->vbo_fences[seg];
+    GLenum status;
+
+    if (!fence)
+        return;
+
+    status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (status == GL_TIMEOUT_EXPIRED)
+        status = glClientWaitSync(fence, 0, 1000 * 1000 * 1000);
+
+    glDeleteSync(fence);
+    glamor_priv->vbo_fences[seg] = NULL;
+}
+
+static void
+glamor_vbo_drop_fences(glamor_screen_private *glamor_priv)
+{
+    int seg;
+
+    for (seg = 0; seg < GLAMOR_VBO_RING_SEGMENTS; seg++) {
+        if (glamor_priv->vbo_fences[seg]) {
+            glDeleteSync(glamor_priv->vbo_fences[seg]);
+            glamor_priv->vbo_fences[seg] = NULL;
+        }
+    }
+}
+
 /**
  * Returns a pointer to @size bytes of VBO storage, which should be
  * accessed by the GL using vbo_offset within the VBO.
@@ -54,45 +101,78 @@ glamor_get_vbo_space(ScreenPtr screen, unsigned size, char **vbo_offset)
     glBindBuffer(GL_ARRAY_BUFFER, glamor_priv->vbo);
 
     if (glamor_priv->has_buffer_storage) {
-        if (glamor_priv->vbo_size < glamor_priv->vbo_offset + size) {
-            if (glamor_priv->vbo_size)
+        int seg_size, s0, s1, s;
+
+        if (size > glamor_priv->vbo_size || !glamor_priv->vbo_size) {
+            if (glamor_priv->vbo_size) {
+                glamor_vbo_drop_fences(glamor_priv);
                 glUnmapBuffer(GL_ARRAY_BUFFER);
+            }
+
+            /* round up so the ring divides into equal segments */
+            glamor_priv->vbo_size = MAX(GLAMOR_VBO_SIZE, size);
+            glamor_priv->vbo_size =
+                (glamor_priv->vbo_size + GLAMOR_VBO_RING_SEGMENTS - 1) &
+                ~(GLAMOR_VBO_RING_SEGMENTS - 1);
 
-            if (size > glamor_priv->vbo_size) {
-                glamor_priv->vbo_size = MAX(GLAMOR_VBO_SIZE, size);
+            /* We aren't allowed to resize glBufferStorage()
+             * buffers, so we need to gen a new one.
+             */
+            glDeleteBuffers(1, &glamor_priv->vbo);
+            glGenBuffers(1, &glamor_priv->vbo);
+            glBindBuffer(GL_ARRAY_BUFFER, glamor_priv->vbo);
 
-                /* We aren't allowed to resize glBufferStorage()
-                 * buffers, so we need to gen a new one.
+            assert(glGetError() == GL_NO_ERROR);
+            glBufferStorage(GL_ARRAY_BUFFER, glamor_priv->vbo_size, NULL,
+                            GL_MAP_WRITE_BIT |
+                            GL_MAP_PERSISTENT_BIT |
+                            GL_MAP_COHERENT_BIT);
+
+            if (glGetError() != GL_NO_ERROR) {
+                /* If the driver failed our coherent mapping, fall
+                 * back to the ARB_mbr path.
                  */
-                glDeleteBuffers(1, &glamor_priv->vbo);
-                glGenBuffers(1, &glamor_priv->vbo);
-                glBindBuffer(GL_ARRAY_BUFFER, glamor_priv->vbo);
+                glamor_priv->has_buffer_storage = false;
+                glamor_priv->vbo_size = 0;
 
-                assert(glGetError() == GL_NO_ERROR);
-                glBufferStorage(GL_ARRAY_BUFFER, glamor_priv->vbo_size, NULL,
-                                GL_MAP_WRITE_BIT |
-                                GL_MAP_PERSISTENT_BIT |
-                                GL_MAP_COHERENT_BIT);
-
-                if (glGetError() != GL_NO_ERROR) {
-                    /* If the driver failed our coherent mapping, fall
-                     * back to the ARB_mbr path.
-                     */
-                    glamor_priv->has_buffer_storage = false;
-                    glamor_priv->vbo_size = 0;
-
-                    return glamor_get_vbo_space(screen, size, vbo_offset);
-                }
+                return glamor_get_vbo_space(screen, size, vbo_offset);
             }
 
-            glamor_priv->vbo_offset = 0;
+            /* The mapping is persistent: set up once here and never
+             * unmapped or invalidated while the ring lives.
+             */
             glamor_priv->vb = glMapBufferRange(GL_ARRAY_BUFFER,
                                                0, glamor_priv->vbo_size,
                                                GL_MAP_WRITE_BIT |
-                                               GL_MAP_INVALIDATE_BUFFER_BIT |
                                                GL_MAP_PERSISTENT_BIT |
                                                GL_MAP_COHERENT_BIT);
+            glamor_priv->vbo_offset = 0;
+            glamor_priv->vbo_fence_segment = 0;
         }
+
+        seg_size = glamor_vbo_segment_size(glamor_priv);
+
+        if (glamor_priv->vbo_offset + size > glamor_priv->vbo_size) {
+            /* wrap: close out the lap by fencing everything written
+             * since the last fence, partial segment included */
+            for (s = glamor_priv->vbo_fence_segment;
+                 s < GLAMOR_VBO_RING_SEGMENTS; s++)
+                glamor_vbo_fence_segment(glamor_priv, s);
+            glamor_priv->vbo_offset = 0;
+            glamor_priv->vbo_fence_segment = 0;
+        }
+
+        /* reclaim the segments this allocation touches: wait for the
+         * previous lap's draws out of them to finish */
+        if (size) {
+            s0 = glamor_priv->vbo_offset / seg_size;
+            s1 = (glamor_priv->vbo_offset + (int) size - 1) / seg_size;
+            if (s1 >= GLAMOR_VBO_RING_SEGMENTS)
+                s1 = GLAMOR_VBO_RING_SEGMENTS - 1;
+            for (s = s0; s <= s1; s++)
+                glamor_vbo_wait_segment(glamor_priv, s);
+        }
+
         *vbo_offset = (void *)(uintptr_t)glamor_priv->vbo_offset;
         data = glamor_priv->vb + glamor_priv->vbo_offset;
         glamor_priv->vbo_offset += size;
@@ -150,10 +230,22 @@ glamor_put_vbo_space(ScreenPtr screen)
     glamor_make_current(glamor_priv);
 
     if (glamor_priv->has_buffer_storage) {
-        /* If we're in the ARB_buffer_storage path, we have a
-         * persistent mapping, so we can leave it around until we
-         * reach the end of the buffer.
+        /* The persistent mapping stays in place; fence the ring
+         * segments the write head has moved past, now that the draws
+         * sourcing them have been issued.
          */
+        if (glamor_priv->vbo_size) {
+            int seg_size = glamor_vbo_segment_size(glamor_priv);
+            int head_seg = glamor_priv->vbo_offset / seg_size;
+            int s;
+
+            if (head_seg > GLAMOR_VBO_RING_SEGMENTS)
+                head_seg = GLAMOR_VBO_RING_SEGMENTS;
+            for (s = glamor_priv->vbo_fence_segment; s < head_seg; s++)
+                glamor_vbo_fence_segment(glamor_priv, s);
+            if (head_seg > glamor_priv->vbo_fence_segment)
+                glamor_priv->vbo_fence_segment = head_seg;
+        }
     } else if (glamor_priv->has_map_buffer_range) {
         if (glamor_priv->vbo_mapped) {
             glUnmapBuffer(GL_ARRAY_BUFFER);
@@ -186,6 +278,8 @@ glamor_fini_vbo(ScreenPtr screen)
 
     glamor_make_current(glamor_priv);
 
+    if (glamor_priv->has_buffer_storage)
+        glamor_vbo_drop_fences(glamor_priv);
     glDeleteVertexArrays(1, &glamor_priv->vao);
     glamor_priv->vao = 0;
     if (!glamor_priv->has_map_buffer_range)
@@ -637,6 +637,20 @@ xorgGlxMakeCurrent(ClientPtr client, GLXContextTag tag, XID drawId, XID readId,
         }
     }
 
+    /*
+     * Re-binding the current context to the same drawables is a no-op as
+     * far as the GL is concerned; clients (and some toolkits) do this on
+     * every frame.  Skip the flush/unbind/rebind cycle and just move the
+     * binding to the new tag.
+     */
+    if (prevglxc && prevglxc == glxc &&
+        (glxc->isDirect ||
+         (glxc->drawPriv == drawPriv && glxc->readPriv == readPriv))) {
+        glxServer.setContextTagPrivate(client, newContextTag, glxc);
+        glxc->currentClient = client;
+        return Success;
+    }
+
     if (prevglxc) {
         /* Flush the previous context if needed. */
         Bool need_flush = !prevglxc->isDirect;
@@ -988,37 +1002,10 @@ __glXDisp_GetVisualConfigs(__GLXclientState * cl, GLbyte * pc)
  * is the same, so this routine pulls double duty.
  */
 
-static int
-DoGetFBConfigs(__GLXclientState * cl, unsigned screen)
+static void
+writeFBConfigAttribs(__GLXconfig * modes, CARD32 *buf)
 {
-    ClientPtr client = cl->client;
-    __GLXscreen *pGlxScreen;
-    CARD32 buf[__GLX_FBCONFIG_ATTRIBS_LENGTH];
-    int p, err;
-    __GLXconfig *modes;
-
-    if (!validGlxScreen(cl->client, screen, &pGlxScreen, &err))
-        return err;
-
-    xGLXGetFBConfigsReply reply = {
-        .type = X_Reply,
-        .sequenceNumber = client->sequence,
-        .length = __GLX_FBCONFIG_ATTRIBS_LENGTH * pGlxScreen->numFBConfigs,
-        .numFBConfigs = pGlxScreen->numFBConfigs,
-        .numAttribs = __GLX_TOTAL_FBCONFIG_ATTRIBS
-    };
-
-    if (client->swapped) {
-        swaps(&reply.sequenceNumber);
-        swapl(&reply.length);
-        swapl(&reply.numFBConfigs);
-        swapl(&reply.numAttribs);
-    }
-
-    WriteToClient(client, sizeof(xGLXGetFBConfigsReply), &reply);
-
-    for (modes = pGlxScreen->fbconfigs; modes != NULL; modes = modes->next) {
-        p = 0;
+    int p = 0;
 
 #define WRITE_PAIR(tag,value) \
     do { buf[p++] = tag ; buf[p++] = value ; } while( 0 )
@@ -1087,10 +1074,71 @@ DoGetFBConfigs(__GLXclientState * cl, unsigned screen)
             WRITE_PAIR(0, 0);
         }
         assert(p == __GLX_FBCONFIG_ATTRIBS_LENGTH);
+#undef WRITE_PAIR
+}
 
-        if (client->swapped) {
-            SwapLongs((CARD32*)buf, __GLX_FBCONFIG_ATTRIBS_LENGTH);
+static int
+DoGetFBConfigs(__GLXclientState * cl, unsigned screen)
+{
+    ClientPtr client = cl->client;
+    __GLXscreen *pGlxScreen;
+    int i, err;
+    __GLXconfig *modes;
+
+    if (!validGlxScreen(cl->client, screen, &pGlxScreen, &err))
+        return err;
+
+    xGLXGetFBConfigsReply reply = {
+        .type = X_Reply,
+        .sequenceNumber = client->sequence,
+        .length = __GLX_FBCONFIG_ATTRIBS_LENGTH * pGlxScreen->numFBConfigs,
+        .numFBConfigs = pGlxScreen->numFBConfigs,
+        .numAttribs = __GLX_TOTAL_FBCONFIG_ATTRIBS
+    };
+
+    if (client->swapped) {
+        swaps(&reply.sequenceNumber);
+        swapl(&reply.length);
+        swapl(&reply.numFBConfigs);
+        swapl(&reply.numAttribs);
+    }
+
+    WriteToClient(client, sizeof(xGLXGetFBConfigsReply), &reply);
+
+    /* The fbconfig list is static once the screen is up, and sessions with
+       many GL clients issue this request over and over, so the serialized
+       attribute block is built once per screen and then served as-is. */
+    if (!pGlxScreen->fbconfigsWire) {
+        CARD32 *wire = calloc(pGlxScreen->numFBConfigs,
+                              __GLX_SIZE_CARD32 * __GLX_FBCONFIG_ATTRIBS_LENGTH);
+
+        if (wire) {
+            i = 0;
+            for (modes = pGlxScreen->fbconfigs; modes != NULL;
+                 modes = modes->next)
+                writeFBConfigAttribs(modes,
+                                     wire +
+                                     i++ * __GLX_FBCONFIG_ATTRIBS_LENGTH);
+            pGlxScreen->fbconfigsWire = wire;
         }
+    }
+
+    if (pGlxScreen->fbconfigsWire && !client->swapped) {
+        WriteToClient(client,
+                      __GLX_SIZE_CARD32 * __GLX_FBCONFIG_ATTRIBS_LENGTH *
+                      pGlxScreen->numFBConfigs,
+                      (char *) pGlxScreen->fbconfigsWire);
+        return Success;
+    }
+
+    /* Swapped clients (and the unlikely case that the cache allocation
+       failed) still get the per-config path. */
+    for (modes = pGlxScreen->fbconfigs; modes != NULL; modes = modes->next) {
+        CARD32 buf[__GLX_FBCONFIG_ATTRIBS_LENGTH];
+
+        writeFBConfigAttribs(modes, buf);
+        if (client->swapped)
+            SwapLongs(buf, __GLX_FBCONFIG_ATTRIBS_LENGTH);
         WriteToClient(client, __GLX_SIZE_CARD32 * __GLX_FBCONFIG_ATTRIBS_LENGTH,
                       (char *) buf);
     }
@@ -428,6 +428,7 @@ __glXScreenDestroy(__GLXscreen * screen)
     free(screen->GLXextensions);
     free(screen->GLextensions);
     free(screen->visuals);
+    free(screen->fbconfigsWire);
 
     for (config = screen->fbconfigs; config != NULL; config = next) {
         next = config->next;
@@ -139,6 +139,11 @@ struct __GLXscreen {
     __GLXconfig **visuals;
     GLint numVisuals;
 
+    /* Wire-format attribute block for glXGetFBConfigs, built on first
+       query and reused afterwards (the fbconfig list is static once the
+       screen is initialized).  NULL until then, or if allocation failed. */
+    CARD32 *fbconfigsWire;
+
     char *GLextensions;
     char *GLXextensions;
     char *glvnd;
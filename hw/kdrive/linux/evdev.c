@@ -54,65 +54,51 @@ typedef struct _kevdev {
     int max_rel;
     int max_abs;
 
+    /* evdev button code -> KD_BUTTON_* flag, precomputed at enable time */
+    unsigned long btnmap[BTN_JOYSTICK - BTN_MOUSE];
+
     int fd;
 } Kevdev;
 
 static void
 EvdevPtrBtn(KdPointerInfo * pi, struct input_event *ev)
 {
+    Kevdev *ke = pi->driverPrivate;
     int flags = KD_MOUSE_DELTA | pi->buttonState;
+    unsigned long button;
 
-    if (ev->code >= BTN_MOUSE && ev->code < BTN_JOYSTICK) {
-        switch (ev->code) {
-        case BTN_LEFT:
-            if (ev->value == 1)
-                flags |= KD_BUTTON_1;
-            else
-                flags &= ~KD_BUTTON_1;
-            break;
-        case BTN_MIDDLE:
-            if (ev->value == 1)
-                flags |= KD_BUTTON_2;
-            else
-                flags &= ~KD_BUTTON_2;
-            break;
-        case BTN_RIGHT:
-            if (ev->value == 1)
-                flags |= KD_BUTTON_3;
-            else
-                flags &= ~KD_BUTTON_3;
-            break;
-        default:
-            /* Unknow button */
-            break;
-        }
+    if (ev->code < BTN_MOUSE || ev->code >= BTN_JOYSTICK)
+        return;
 
-        KdEnqueuePointerEvent(pi, flags, 0, 0, 0);
-    }
+    button = ke->btnmap[ev->code - BTN_MOUSE];
+    if (!button)
+        return;
+
+    if (ev->value)
+        flags |= button;
+    else
+        flags &= ~button;
+
+    KdEnqueuePointerEvent(pi, flags, 0, 0, 0);
 }
 
+/*
+ * Deliver the motion accumulated since the last SYN report as a single
+ * pointer event, rather than one event per axis per input_event.
+ */
 static void
-EvdevPtrMotion(KdPointerInfo * pi, struct input_event *ev)
+EvdevPtrFlush(KdPointerInfo * pi)
 {
     Kevdev *ke = pi->driverPrivate;
     int i;
     int flags = KD_MOUSE_DELTA | pi->buttonState;
 
-    for (i = 0; i <= ke->max_rel; i++)
-        if (ke->rel[i]) {
-            int a;
+    if (ke->rel[REL_X] || ke->rel[REL_Y]) {
+        KdEnqueuePointerEvent(pi, flags, ke->rel[REL_X], ke->rel[REL_Y], 0);
+        ke->rel[REL_X] = 0;
+        ke->rel[REL_Y] = 0;
+    }
 
-            for (a = 0; a <= ke->max_rel; a++) {
-                if (ISBITSET(ke->relbits, a)) {
-                    if (a == 0)
-                        KdEnqueuePointerEvent(pi, flags, ke->rel[a], 0, 0);
-                    else if (a == 1)
-                        KdEnqueuePointerEvent(pi, flags, 0, ke->rel[a], 0);
-                }
-                ke->rel[a] = 0;
-            }
-            break;
-        }
     for (i = 0; i < ke->max_abs; i++)
         if (ke->abs[i] != ke->prevabs[i]) {
             int a;
@@ -127,16 +113,19 @@ EvdevPtrMotion(KdPointerInfo * pi, struct input_event *ev)
             break;
         }
 
-    if (ev->code == REL_WHEEL) {
-        for (i = 0; i < abs(ev->value); i++) {
-            if (ev->value > 0)
+    if (ke->rel[REL_WHEEL]) {
+        int value = ke->rel[REL_WHEEL];
+
+        ke->rel[REL_WHEEL] = 0;
+        for (i = 0; i < abs(value); i++) {
+            if (value > 0)
                 flags |= KD_BUTTON_4;
             else
                 flags |= KD_BUTTON_5;
 
             KdEnqueuePointerEvent(pi, flags, 0, 0, 0);
 
-            if (ev->value > 0)
+            if (value > 0)
                 flags &= ~KD_BUTTON_4;
             else
                 flags &= ~KD_BUTTON_5;
@@ -145,6 +134,9 @@ EvdevPtrMotion(KdPointerInfo * pi, struct input_event *ev)
         }
     }
 
+    /* Discard anything accumulated on axes we don't deliver */
+    for (i = 0; i <= ke->max_rel; i++)
+        ke->rel[i] = 0;
 }
 
 static void
@@ -167,20 +159,24 @@ EvdevPtrRead(int evdevPort, void *closure)
     for (i = 0; i < n; i++) {
         switch (events[i].type) {
         case EV_SYN:
+            EvdevPtrFlush(pi);
             break;
         case EV_KEY:
+            /* Keep button changes ordered with respect to motion */
+            EvdevPtrFlush(pi);
             EvdevPtrBtn(pi, &events[i]);
             break;
         case EV_REL:
             ke->rel[events[i].code] += events[i].value;
-            EvdevPtrMotion(pi, &events[i]);
             break;
         case EV_ABS:
             ke->abs[events[i].code] = events[i].value;
-            EvdevPtrMotion(pi, &events[i]);
             break;
         }
     }
+
+    /* Catch devices which predate SYN_REPORT and partial reads */
+    EvdevPtrFlush(pi);
 }
 
 const char *kdefaultEvdev[] = {
@@ -295,6 +291,12 @@ EvdevPtrEnable(KdPointerInfo * pi)
             return BadValue;
         }
     }
+    /* Precompute the button dispatch table so the read path is a plain
+       array lookup; unmapped codes stay zero and are ignored */
+    ke->btnmap[BTN_LEFT - BTN_MOUSE] = KD_BUTTON_1;
+    ke->btnmap[BTN_MIDDLE - BTN_MOUSE] = KD_BUTTON_2;
+    ke->btnmap[BTN_RIGHT - BTN_MOUSE] = KD_BUTTON_3;
+
     if (!KdRegisterFd(fd, EvdevPtrRead, pi)) {
         free(ke);
         close(fd);
@@ -72,6 +72,12 @@ from The Open Group.
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #endif /* CONFIG-MITSHM */
+#ifdef HAVE_MEMFD_CREATE
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "damage.h"
+#endif /* HAVE_MEMFD_CREATE */
 #include "dix.h"
 #include "miline.h"
 #include "glx_extinit.h"
@@ -94,6 +100,23 @@ typedef struct {
     int numOutputs;
 } vfbCrtcInfo, *vfbCrtcInfoPtr;
 
+#ifdef HAVE_MEMFD_CREATE
+/*
+ * Appended to the end of an exported (-fbexport) framebuffer memfd.
+ * External scrapers map the fd read-only (e.g. via /proc/<pid>/fd/<n>),
+ * locate the trailer in the last sizeof(vfbExportTrailer) bytes of the
+ * file, and use the classic seqlock handshake: read an even sequence,
+ * copy the rows inside the damage box, re-read the sequence, and retry
+ * if it changed or was odd.  The box covers everything damaged since
+ * the previous sequence bump, so pollers that saw the previous value
+ * only need to copy those rows instead of the whole framebuffer.
+ */
+typedef struct {
+    CARD32 sequence;
+    CARD32 x1, y1, x2, y2;
+} vfbExportTrailer;
+#endif /* HAVE_MEMFD_CREATE */
+
 typedef struct {
     int width;
     int paddedBytesWidth;
@@ -121,6 +144,12 @@ typedef struct {
 #ifdef CONFIG_MITSHM
     int shmid;
 #endif /* CONFIG_MITSHM */
+
+#ifdef HAVE_MEMFD_CREATE
+    int memfd;
+    DamagePtr exportDamage;
+    vfbExportTrailer *exportTrailer;
+#endif /* HAVE_MEMFD_CREATE */
 } vfbScreenInfo, *vfbScreenInfoPtr;
 
 static int vfbNumScreens;
@@ -140,7 +169,9 @@ static Bool vfbPixmapDepths[33];
 #ifdef HAVE_MMAP
 static char *pfbdir = NULL;
 #endif
-typedef enum { NORMAL_MEMORY_FB, SHARED_MEMORY_FB, MMAPPED_FILE_FB } fbMemType;
+typedef enum { NORMAL_MEMORY_FB, SHARED_MEMORY_FB, MMAPPED_FILE_FB,
+    MEMFD_FB
+} fbMemType;
 static fbMemType fbmemtype = NORMAL_MEMORY_FB;
 static char needswap = 0;
 static Bool Render = TRUE;
@@ -242,6 +273,19 @@ freeScreenInfo(vfbScreenInfoPtr pvfb)
         break;
 #endif /* CONFIG_MITSHM */
 
+#ifdef HAVE_MEMFD_CREATE
+    case MEMFD_FB:
+        if (pvfb->pXWDHeader)
+            munmap(pvfb->pXWDHeader,
+                   pvfb->sizeInBytes + sizeof(vfbExportTrailer));
+        if (pvfb->memfd >= 0)
+            close(pvfb->memfd);
+        break;
+#else /* HAVE_MEMFD_CREATE */
+    case MEMFD_FB:
+        break;
+#endif /* HAVE_MEMFD_CREATE */
+
     case NORMAL_MEMORY_FB:
         free(pvfb->pXWDHeader);
         break;
@@ -300,6 +344,11 @@ ddxUseMsg(void)
     ErrorF("-shmem                 put framebuffers in shared memory\n");
 #endif /* CONFIG_MITSHM */
 
+#ifdef HAVE_MEMFD_CREATE
+    ErrorF("-fbexport              put framebuffers in sealed memfds with "
+           "damage trailers\n");
+#endif /* HAVE_MEMFD_CREATE */
+
     ErrorF("-crtcs n               number of CRTCs per screen (default: %d)\n",
            VFB_DEFAULT_NUM_CRTCS);
 }
@@ -420,6 +469,13 @@ ddxProcessArgument(int argc, char *argv[], int i)
     }
 #endif /* CONFIG_MITSHM */
 
+#ifdef HAVE_MEMFD_CREATE
+    if (strcmp(argv[i], "-fbexport") == 0) {    /* -fbexport */
+        fbmemtype = MEMFD_FB;
+        return 1;
+    }
+#endif /* HAVE_MEMFD_CREATE */
+
     if (strcmp(argv[i], "-crtcs") == 0) {       /* -crtcs n */
         int numCrtcs;
 
@@ -631,6 +687,106 @@ vfbAllocateSharedMemoryFramebuffer(vfbScreenInfoPtr pvfb)
 }
 #endif /* CONFIG_MITSHM */
 
+#ifdef HAVE_MEMFD_CREATE
+static void
+vfbExportBlockHandler(void *blockData, void *pTimeout)
+{
+    int i;
+
+    for (i = 0; i < vfbNumScreens; i++) {
+        vfbScreenInfoPtr pvfb = &vfbScreens[i];
+        ScreenPtr pScreen = screenInfo.screens[i];
+        vfbExportTrailer *tr = pvfb->exportTrailer;
+        RegionPtr damaged;
+        BoxPtr box;
+        CARD32 seq;
+
+        if (!tr || !pScreen)
+            continue;
+
+        /* the screen pixmap doesn't exist yet when the framebuffer is
+         * allocated, so hook up damage tracking on first use */
+        if (!pvfb->exportDamage) {
+            pvfb->exportDamage = DamageCreate(NULL, NULL, DamageReportNone,
+                                              TRUE, pScreen, NULL);
+            if (!pvfb->exportDamage)
+                continue;
+            DamageRegister(&(*pScreen->GetScreenPixmap) (pScreen)->drawable,
+                           pvfb->exportDamage);
+        }
+
+        damaged = DamageRegion(pvfb->exportDamage);
+        if (!RegionNotEmpty(damaged))
+            continue;
+
+        /* seqlock write side: odd while the box is inconsistent */
+        box = RegionExtents(damaged);
+        seq = tr->sequence + 1;
+        __atomic_store_n(&tr->sequence, seq, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        tr->x1 = box->x1;
+        tr->y1 = box->y1;
+        tr->x2 = box->x2;
+        tr->y2 = box->y2;
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        __atomic_store_n(&tr->sequence, seq + 1, __ATOMIC_RELAXED);
+        DamageEmpty(pvfb->exportDamage);
+    }
+}
+
+static void
+vfbAllocateMemfdFramebuffer(vfbScreenInfoPtr pvfb)
+{
+    static Bool handlerRegistered = FALSE;
+    size_t total = pvfb->sizeInBytes + sizeof(vfbExportTrailer);
+    int fd;
+    void *map;
+
+    pvfb->memfd = -1;
+
+    fd = memfd_create("Xvfb-screen", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        perror("memfd_create");
+        ErrorF("memfd_create failed, %s", strerror(errno));
+        return;
+    }
+
+    if (ftruncate(fd, total) < 0) {
+        perror("ftruncate");
+        ErrorF("ftruncate %zu bytes failed, %s", total, strerror(errno));
+        close(fd);
+        return;
+    }
+
+    /* let readers trust the file size for locating the trailer */
+    fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW);
+
+    map = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        ErrorF("mmap failed, %s", strerror(errno));
+        close(fd);
+        return;
+    }
+
+    pvfb->memfd = fd;
+    pvfb->pXWDHeader = (XWDFileHeader *) map;
+    pvfb->exportTrailer =
+        (vfbExportTrailer *) ((char *) map + pvfb->sizeInBytes);
+
+    ErrorF("screen %d memfd %d (map via /proc/%d/fd/%d, damage trailer in "
+           "the last %d bytes)\n", (int) (pvfb - vfbScreens), fd,
+           (int) getpid(), fd, (int) sizeof(vfbExportTrailer));
+
+    if (!handlerRegistered) {
+        handlerRegistered =
+            RegisterBlockAndWakeupHandlers(vfbExportBlockHandler,
+                                           (ServerWakeupHandlerProcPtr)
+                                           NoopDDA, NULL);
+    }
+}
+#endif /* HAVE_MEMFD_CREATE */
+
 static char *
 vfbAllocateFramebufferMemory(vfbScreenInfoPtr pvfb)
 {
@@ -681,6 +837,15 @@ vfbAllocateFramebufferMemory(vfbScreenInfoPtr pvfb)
         break;
 #endif /* CONFIG_MITSHM */
 
+#ifdef HAVE_MEMFD_CREATE
+    case MEMFD_FB:
+        vfbAllocateMemfdFramebuffer(pvfb);
+        break;
+#else /* HAVE_MEMFD_CREATE */
+    case MEMFD_FB:
+        break;
+#endif /* HAVE_MEMFD_CREATE */
+
     case NORMAL_MEMORY_FB:
         pvfb->pXWDHeader = (XWDFileHeader *) calloc(1, pvfb->sizeInBytes);
         break;
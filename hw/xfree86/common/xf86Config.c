@@ -856,6 +856,10 @@ configServerFlags(XF86ConfFlagsPtr flagsconf, XF86OptionPtr layoutopts)
                 LogMessageVerb(X_CONFIG, 1, "Syncing logfile enabled\n");
                 xorgLogSync = TRUE;
             }
+            else if (!xf86NameCmp(s, "async")) {
+                LogMessageVerb(X_CONFIG, 1, "Asynchronous logfile writes enabled\n");
+                xorgLogAsync = TRUE;
+            }
             else {
                 LogMessageVerb(X_WARNING, 1, "Unknown Log option\n");
             }
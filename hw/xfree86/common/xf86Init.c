@@ -53,6 +53,7 @@
 
 #include "config/dbus-core.h"
 #include "config/hotplug_priv.h"
+#include "dix/bootprof_priv.h"
 #include "dix/input_priv.h"
 #include "dix/screenint_priv.h"
 #include "mi/mi_priv.h"
@@ -339,7 +340,9 @@ InitOutput(int argc, char **argv)
         systemd_logind_init();
 
         /* Do a general bus probe.  This will be a PCI probe for x86 platforms */
+        BootPhaseBegin("bus probe");
         xf86BusProbe();
+        BootPhaseEnd();
 
         if (xf86DoConfigure)
             DoConfigure();
@@ -472,9 +475,11 @@ InitOutput(int argc, char **argv)
         for (i = 0; i < xf86NumScreens; i++) {
             xf86VGAarbiterScrnInit(xf86Screens[i]);
             xf86VGAarbiterLock(xf86Screens[i]);
+            BootPhaseBegin("%s preinit", xf86Screens[i]->driverName);
             if (xf86Screens[i]->PreInit &&
                 xf86Screens[i]->PreInit(xf86Screens[i], 0))
                 xf86Screens[i]->configured = TRUE;
+            BootPhaseEnd();
             xf86VGAarbiterUnlock(xf86Screens[i]);
         }
         for (i = 0; i < xf86NumScreens; i++)
@@ -1266,6 +1271,23 @@ xf86LoadModules(const char **list, void **optlist)
     if (!list)
         return TRUE;
 
+    /*
+     * Resolve every module file and hint it to the kernel before any of
+     * the serial loads below, so the disk reads overlap with module
+     * initialization instead of happening one dlopen() at a time.
+     */
+    for (i = 0; list[i] != NULL; i++) {
+        name = xf86NormalizeName(list[i]);
+        if (name == NULL || *name == '\0') {
+            free(name);
+            continue;
+        }
+        if (!xf86NameCmp(name, "keyboard"))
+            strcpy(name, "kbd");
+        LoaderPrefetch(name);
+        free(name);
+    }
+
     for (i = 0; list[i] != NULL; i++) {
 
         /* Normalise the module name */
@@ -1287,10 +1309,12 @@ xf86LoadModules(const char **list, void **optlist)
         else
             opt = NULL;
 
+        BootPhaseBegin("module %s", name);
         if (!LoadModule(name, opt, NULL, &errmaj)) {
             LoaderErrorMsg(NULL, name, errmaj, 0);
             failed = TRUE;
         }
+        BootPhaseEnd();
         free(name);
     }
     return !failed;
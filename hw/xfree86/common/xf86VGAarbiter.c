@@ -64,6 +64,45 @@ static DevPrivateKeyRec VGAarbiterScreenKeyRec;
 static DevPrivateKeyRec VGAarbiterGCKeyRec;
 
 static int vga_no_arb = 0;
+
+/*
+ * Device the kernel arbiter lock is currently held for on behalf of the
+ * wrapped operations, or NULL when it isn't held.  Locking per drawing
+ * operation costs two kernel round trips each; instead the lock is kept
+ * across runs of operations against the same card and only dropped when
+ * another card needs the bus, when a driver takes the lock explicitly,
+ * or when the server goes idle in the BlockHandler.
+ */
+static struct pci_device *vga_batch_dev = NULL;
+
+static void
+VGAarbiterBatchRelease(void)
+{
+    if (vga_batch_dev == NULL)
+        return;
+    pci_device_vgaarb_unlock();
+    vga_batch_dev = NULL;
+}
+
+void
+VGAGet(ScreenPtr pScreen)
+{
+    struct pci_device *dev = xf86ScreenToScrn(pScreen)->vgaDev;
+
+    if (vga_batch_dev == dev)
+        return;
+    VGAarbiterBatchRelease();
+    pci_device_vgaarb_set_target(dev);
+    pci_device_vgaarb_lock();
+    vga_batch_dev = dev;
+}
+
+void
+VGAPut(void)
+{
+    /* keep the lock until the target changes or the server goes idle */
+}
+
 void
 xf86VGAarbiterInit(void)
 {
@@ -79,6 +118,7 @@ xf86VGAarbiterFini(void)
 {
     if (vga_no_arb)
         return;
+    VGAarbiterBatchRelease();
     pci_device_vgaarb_fini();
 }
 
@@ -87,6 +127,7 @@ xf86VGAarbiterLock(ScrnInfoPtr pScrn)
 {
     if (vga_no_arb)
         return;
+    VGAarbiterBatchRelease();
     pci_device_vgaarb_set_target(pScrn->vgaDev);
     pci_device_vgaarb_lock();
 }
@@ -261,6 +302,8 @@ VGAarbiterBlockHandler(ScreenPtr pScreen, void *pTimeout)
     VGAGet(pScreen);
     pScreen->BlockHandler(pScreen, pTimeout);
     VGAPut();
+    /* about to go idle - let the other cards have the bus */
+    VGAarbiterBatchRelease();
     SCREEN_EPILOG(BlockHandler, VGAarbiterBlockHandler);
 }
 
@@ -104,18 +104,13 @@
     (VGAarbiterGCPtr)dixLookupPrivate(&(x)->devPrivates, &VGAarbiterGCKeyRec);\
     (x)->ops = pGCPriv->wrapOps; (x)->funcs = pGCPriv->wrapFuncs;
 
-static inline void
-VGAGet(ScreenPtr pScreen)
-{
-    pci_device_vgaarb_set_target(xf86ScreenToScrn(pScreen)->vgaDev);
-    pci_device_vgaarb_lock();
-}
-
-static inline void
-VGAPut(void)
-{
-    pci_device_vgaarb_unlock();
-}
+/*
+ * Batched arbitration around wrapped operations: VGAGet only talks to
+ * the kernel when the lock isn't already held for the right card, and
+ * VGAPut leaves it held for the next operation.  See xf86VGAarbiter.c.
+ */
+void VGAGet(ScreenPtr pScreen);
+void VGAPut(void);
 
 typedef struct _VGAarbiterScreen {
     CreateGCProcPtr CreateGC;
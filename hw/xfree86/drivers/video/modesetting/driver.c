@@ -608,6 +608,9 @@ rotate_clip(PixmapPtr pixmap, xf86CrtcPtr crtc, BoxPtr rect, drmModeClip *clip,
     return 0;
 }
 
+/* the kernel's DRM_MODE_FB_DIRTY_MAX_CLIPS */
+#define MS_DIRTY_MAX_CLIPS 256
+
 static int
 dispatch_damages(ScrnInfoPtr scrn, xf86CrtcPtr crtc, RegionPtr dirty,
                  PixmapPtr pixmap, DamagePtr damage, int fb_id, int x, int y)
@@ -620,11 +623,23 @@ dispatch_damages(ScrnInfoPtr scrn, xf86CrtcPtr crtc, RegionPtr dirty,
         return 0;
 
     if (num_cliprects) {
-        drmModeClip *clip = calloc(num_cliprects, sizeof(drmModeClip));
-        BoxPtr rect = REGION_RECTS(dirty);
+        drmModeClip *clip;
+        BoxPtr rect;
         int i;
         int c = 0;
 
+        /* The kernel rejects DirtyFB calls with more than 256 clips, and
+         * a storm of tiny rectangles costs more per-rect overhead on USB
+         * links than one bounding update, so collapse such storms to the
+         * damage extents.
+         */
+        if (num_cliprects > MS_DIRTY_MAX_CLIPS) {
+            rect = RegionExtents(dirty);
+            num_cliprects = 1;
+        } else
+            rect = REGION_RECTS(dirty);
+
+        clip = calloc(num_cliprects, sizeof(drmModeClip));
         if (!clip)
             return -ENOMEM;
 
@@ -823,6 +838,23 @@ redisplay_dirty(ScreenPtr screen, PixmapDirtyUpdatePtr dirty, int *timeout)
     RegionRec pixregion;
 
     PixmapRegionInit(&pixregion, dirty->secondary_dst);
+
+    /* Only report the actually damaged area downstream: the secondary
+     * ships every rectangle it is handed over its link, so full-pixmap
+     * updates waste most of the bandwidth of USB and virtual displays.
+     * Rotated secondaries keep the full area; the damage would need to
+     * be transformed to map it into their coordinate space.
+     */
+    if (dirty->rotation == RR_Rotate_0) {
+        RegionRec damagereg;
+
+        RegionInit(&damagereg, NullBox, 0);
+        RegionCopy(&damagereg, DamageRegion(dirty->damage));
+        RegionTranslate(&damagereg, -dirty->x, -dirty->y);
+        RegionIntersect(&pixregion, &pixregion, &damagereg);
+        RegionUninit(&damagereg);
+    }
+
     DamageRegionAppend(&dirty->secondary_dst->drawable, &pixregion);
     PixmapSyncDirtyHelper(dirty);
 
@@ -861,8 +893,11 @@ ms_dirty_update(ScreenPtr screen, int *timeout)
     xorg_list_for_each_entry(ent, &screen->pixmap_dirty_list, ent) {
         region = DamageRegion(ent->damage);
         if (RegionNotEmpty(region)) {
+            msPixmapPrivPtr ppriv = NULL;
+            CARD32 now = 0;
+
             if (!screen->isGPU) {
-                   msPixmapPrivPtr ppriv =
+                ppriv =
                     msGetPixmapPriv(&ms->drmmode, ent->secondary_dst->primary_pixmap);
 
                 if (ppriv->notify_on_damage) {
@@ -875,10 +910,30 @@ ms_dirty_update(ScreenPtr screen, int *timeout)
                 /* Requested manual updating */
                 if (ppriv->defer_dirty_update)
                     continue;
+
+                /* Adaptive rate limiting: when the previous update took
+                 * long the link is saturated, so hold off for as long as
+                 * that update took and let the damage accumulate instead
+                 * of queueing ever more transfers. Fast links never wait.
+                 */
+                now = GetTimeInMillis();
+                if ((int) (ppriv->dirty_hold_until - now) > 0) {
+                    int remain = (int) (ppriv->dirty_hold_until - now);
+
+                    if (timeout && (*timeout < 0 || *timeout > remain))
+                        *timeout = remain;
+                    continue;
+                }
             }
 
             redisplay_dirty(screen, ent, timeout);
             DamageEmpty(ent->damage);
+
+            if (ppriv) {
+                CARD32 cost = GetTimeInMillis() - now;
+
+                ppriv->dirty_hold_until = cost > 5 ? now + cost : 0;
+            }
         }
     }
 }
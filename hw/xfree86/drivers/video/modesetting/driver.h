@@ -207,6 +207,12 @@ uint32_t ms_drm_queue_alloc(xf86CrtcPtr crtc,
                             ms_drm_handler_proc handler,
                             ms_drm_abort_proc abort);
 
+uint32_t ms_drm_queue_alloc_shared(xf86CrtcPtr crtc,
+                                   void *data,
+                                   ms_drm_handler_proc handler,
+                                   ms_drm_abort_proc abort,
+                                   uint32_t seq);
+
 typedef enum ms_queue_flag {
     MS_QUEUE_ABSOLUTE = 0,
     MS_QUEUE_RELATIVE = 1,
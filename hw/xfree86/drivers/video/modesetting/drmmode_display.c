@@ -1080,6 +1080,143 @@ drmmode_crtc_flip(xf86CrtcPtr crtc, uint32_t fb_id, int x, int y,
                            fb_id, flags, data);
 }
 
+/*
+ * Batched flips: collect the plane updates for several CRTCs into one
+ * atomic request so all heads flip in the same commit, then land it
+ * with a single drmModeAtomicCommit. Only usable with atomic
+ * modesetting; the commit flags apply to the request as a whole.
+ */
+drmModeAtomicReq *
+drmmode_flip_batch_alloc(void)
+{
+    return drmModeAtomicAlloc();
+}
+
+void
+drmmode_flip_batch_free(drmModeAtomicReq *req)
+{
+    drmModeAtomicFree(req);
+}
+
+int
+drmmode_crtc_flip_add(xf86CrtcPtr crtc, drmModeAtomicReq *req,
+                      uint32_t fb_id, int x, int y)
+{
+    drmmode_crtc_private_ptr drmmode_crtc = crtc->driver_private;
+
+    /* Virtual CRTCs don't have real DRM CRTCs, so page flipping is not supported */
+    if (!drmmode_crtc->mode_crtc)
+        return -1;
+
+    return plane_add_props(req, crtc, fb_id, x, y);
+}
+
+int
+drmmode_flip_batch_commit(ScrnInfoPtr scrn, drmModeAtomicReq *req,
+                          uint32_t flags, void *data)
+{
+    modesettingPtr ms = modesettingPTR(scrn);
+
+    assert(ms->atomic_modeset);
+
+    return drmModeAtomicCommit(ms->fd, req, flags | DRM_MODE_ATOMIC_NONBLOCK,
+                               data);
+}
+
+/*
+ * Overlay plane offload: scan out a video surface framebuffer directly
+ * on the CRTC's reserved overlay plane instead of compositing it into
+ * the primary framebuffer through the GPU.
+ */
+Bool
+drmmode_crtc_overlay_supported(xf86CrtcPtr crtc, uint32_t format)
+{
+    drmmode_crtc_private_ptr drmmode_crtc = crtc->driver_private;
+    uint32_t i;
+
+    if (!drmmode_crtc->overlay_plane_id)
+        return FALSE;
+
+    for (i = 0; i < drmmode_crtc->num_overlay_formats; i++)
+        if (drmmode_crtc->overlay_formats[i].format == format)
+            return TRUE;
+
+    return FALSE;
+}
+
+static int
+overlay_add_prop(drmModeAtomicReq *req, drmmode_crtc_private_ptr drmmode_crtc,
+                 enum drmmode_plane_property prop, uint64_t val)
+{
+    drmmode_prop_info_ptr info = &drmmode_crtc->props_overlay[prop];
+    int ret;
+
+    if (!info->prop_id)
+        return -1;
+
+    ret = drmModeAtomicAddProperty(req, drmmode_crtc->overlay_plane_id,
+                                   info->prop_id, val);
+    return (ret <= 0) ? -1 : 0;
+}
+
+int
+drmmode_crtc_overlay_set(xf86CrtcPtr crtc, uint32_t fb_id,
+                         int src_x, int src_y, int src_w, int src_h,
+                         int crtc_x, int crtc_y, int crtc_w, int crtc_h)
+{
+    modesettingPtr ms = modesettingPTR(crtc->scrn);
+    drmmode_crtc_private_ptr drmmode_crtc = crtc->driver_private;
+    int ret = 0;
+
+    if (!drmmode_crtc->overlay_plane_id || !drmmode_crtc->mode_crtc)
+        return -1;
+
+    if (ms->atomic_modeset) {
+        drmModeAtomicReq *req = drmModeAtomicAlloc();
+
+        if (!req)
+            return 1;
+
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_FB_ID, fb_id);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_CRTC_ID,
+                                fb_id ? drmmode_crtc->mode_crtc->crtc_id : 0);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_SRC_X,
+                                src_x << 16);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_SRC_Y,
+                                src_y << 16);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_SRC_W,
+                                src_w << 16);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_SRC_H,
+                                src_h << 16);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_CRTC_X,
+                                crtc_x);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_CRTC_Y,
+                                crtc_y);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_CRTC_W,
+                                crtc_w);
+        ret |= overlay_add_prop(req, drmmode_crtc, DRMMODE_PLANE_CRTC_H,
+                                crtc_h);
+
+        if (ret == 0)
+            ret = drmModeAtomicCommit(ms->fd, req, DRM_MODE_ATOMIC_NONBLOCK,
+                                      NULL);
+        drmModeAtomicFree(req);
+        return ret;
+    }
+
+    return drmModeSetPlane(ms->fd, drmmode_crtc->overlay_plane_id,
+                           drmmode_crtc->mode_crtc->crtc_id, fb_id, 0,
+                           crtc_x, crtc_y, crtc_w, crtc_h,
+                           src_x << 16, src_y << 16,
+                           src_w << 16, src_h << 16);
+}
+
+int
+drmmode_crtc_overlay_disable(xf86CrtcPtr crtc)
+{
+    return drmmode_crtc_overlay_set(crtc, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+}
+
 void
 drmmode_bo_destroy(drmmode_ptr drmmode, drmmode_bo *bo)
 {
@@ -2163,9 +2300,32 @@ drmmode_set_gamma_lut(drmmode_crtc_private_ptr drmmode_crtc,
         return;
     }
 
+    /* LUT-only update: commit just the GAMMA_LUT property, without
+     * ALLOW_MODESET so the kernel skips full modeset validation, and
+     * non-blocking so a gamma ramp step doesn't stall dispatch until
+     * the next vblank. Falls back to the legacy property set if the
+     * commit can't be queued (e.g. a previous one is still pending).
+     */
+    if (modesettingPTR(drmmode->scrn)->atomic_modeset) {
+        drmModeAtomicReq *req = drmModeAtomicAlloc();
+        int ret = -1;
+
+        if (req) {
+            if (drmModeAtomicAddProperty(req, crtc_id,
+                                         gamma_lut_info->prop_id,
+                                         blob_id) > 0)
+                ret = drmModeAtomicCommit(drmmode->fd, req,
+                                          DRM_MODE_ATOMIC_NONBLOCK, NULL);
+            drmModeAtomicFree(req);
+        }
+        if (ret == 0)
+            goto out_blob;
+    }
+
     drmModeObjectSetProperty(drmmode->fd, crtc_id, DRM_MODE_OBJECT_CRTC,
                              gamma_lut_info->prop_id, blob_id);
 
+ out_blob:
     drmModeDestroyPropertyBlob(drmmode->fd, blob_id);
     free(lut);
 }
@@ -2493,6 +2653,8 @@ drmmode_crtc_destroy(xf86CrtcPtr crtc)
         return;
 
     drmmode_prop_info_free(drmmode_crtc->props_plane, DRMMODE_PLANE__COUNT);
+    drmmode_prop_info_free(drmmode_crtc->props_overlay, DRMMODE_PLANE__COUNT);
+    free(drmmode_crtc->overlay_formats);
     xorg_list_for_each_entry_safe(iterator, next, &drmmode_crtc->mode_list, entry) {
         drm_mode_destroy(crtc, iterator);
     }
@@ -2535,7 +2697,8 @@ is_plane_assigned(ScrnInfoPtr scrn, int plane_id)
     for (c = 0; c < xf86_config->num_crtc; c++) {
         xf86CrtcPtr iter = xf86_config->crtc[c];
         drmmode_crtc_private_ptr drmmode_crtc = iter->driver_private;
-        if (drmmode_crtc->plane_id == plane_id)
+        if (drmmode_crtc->plane_id == plane_id ||
+            drmmode_crtc->overlay_plane_id == plane_id)
             return TRUE;
     }
 
@@ -2800,6 +2963,35 @@ drmmode_crtc_create_planes(xf86CrtcPtr crtc, int num)
         }
         case DRMMODE_PLANE_TYPE_OVERLAY:
         {
+            uint32_t overlay_blob_id;
+
+            /* Reserve one overlay plane per CRTC for scanout offload of
+             * video surfaces; further overlays are left to the kernel.
+             */
+            if (drmmode_crtc->overlay_plane_id) {
+                drmModeFreePlane(kplane);
+                drmModeFreeObjectProperties(props);
+                continue;
+            }
+
+            drmmode_crtc->overlay_plane_id = plane_id;
+            drmmode_prop_info_copy(drmmode_crtc->props_overlay, tmp_props,
+                                   DRMMODE_PLANE__COUNT, 1);
+            overlay_blob_id =
+                drmmode_prop_get_value(&tmp_props[DRMMODE_PLANE_IN_FORMATS],
+                                       props, 0);
+            drmmode_crtc->overlay_formats = calloc(kplane->count_formats,
+                                                   sizeof(drmmode_format_rec));
+            if (drmmode_crtc->overlay_formats) {
+                drmmode_crtc->num_overlay_formats = kplane->count_formats;
+                if (!populate_format_modifiers(crtc, kplane,
+                                               drmmode_crtc->overlay_formats,
+                                               overlay_blob_id)) {
+                    for (int f = 0; f < kplane->count_formats; f++)
+                        drmmode_crtc->overlay_formats[f].format =
+                            kplane->formats[f];
+                }
+            }
             drmModeFreePlane(kplane);
             drmModeFreeObjectProperties(props);
             continue;
@@ -4044,6 +4236,52 @@ drmmode_glamor_handle_new_screen_pixmap(drmmode_ptr drmmode)
     return TRUE;
 }
 
+/*
+ * Repoint an enabled CRTC's primary plane at the (reallocated) shared
+ * front buffer without a modeset, so heads whose mode did not change
+ * don't blank during a screen resize. Only possible with atomic
+ * modesetting and for CRTCs scanning the shared front buffer directly;
+ * returns FALSE when the caller needs to do a full modeset instead.
+ */
+static Bool
+drmmode_crtc_repoint_front(xf86CrtcPtr crtc)
+{
+    modesettingPtr ms = modesettingPTR(crtc->scrn);
+    drmmode_crtc_private_ptr drmmode_crtc = crtc->driver_private;
+    drmmode_ptr drmmode = drmmode_crtc->drmmode;
+    drmmode_tearfree_ptr trf = &drmmode_crtc->tearfree;
+    drmModeAtomicReq *req;
+    int ret;
+
+    if (!ms->atomic_modeset || !drmmode_crtc->mode_crtc)
+        return FALSE;
+
+    if (drmmode_crtc->prime_pixmap || drmmode_crtc->rotate_fb_id ||
+        trf->buf[0].px || trf->buf[1].px)
+        return FALSE;
+
+    if (!drmmode->fb_id &&
+        drmmode_bo_import(drmmode, &drmmode->front_bo, &drmmode->fb_id) < 0)
+        return FALSE;
+
+    req = drmModeAtomicAlloc();
+    if (!req)
+        return FALSE;
+
+    /* No ALLOW_MODESET: if this can't be done as a plane-only update,
+     * the kernel refuses and the caller falls back to the modeset.
+     */
+    ret = plane_add_props(req, crtc, drmmode->fb_id, crtc->x, crtc->y);
+    if (ret == 0)
+        ret = drmModeAtomicCommit(ms->fd, req, 0, NULL);
+    drmModeAtomicFree(req);
+
+    if (ret == 0)
+        drmmode_crtc_update_output_fb_id(crtc);
+
+    return ret == 0;
+}
+
 static Bool
 drmmode_xf86crtc_resize(ScrnInfoPtr scrn, int width, int height)
 {
@@ -4118,6 +4356,13 @@ drmmode_xf86crtc_resize(ScrnInfoPtr scrn, int width, int height)
         if (!crtc->enabled)
             continue;
 
+        /* The mode on unaffected heads is unchanged - only the scanout
+         * buffer moved. Repoint the plane where possible so those heads
+         * don't blank, with the full modeset as fallback.
+         */
+        if (drmmode_crtc_repoint_front(crtc))
+            continue;
+
         drmmode_set_mode_major(crtc, &crtc->mode,
                                crtc->rotation, crtc->x, crtc->y);
     }
@@ -216,6 +216,12 @@ typedef struct {
     drmmode_format_rec *formats;
     drmmode_format_rec *formats_async;
 
+    /* Overlay plane reserved for scanout offload of video surfaces */
+    drmmode_prop_info_rec props_overlay[DRMMODE_PLANE__COUNT];
+    uint32_t overlay_plane_id;
+    uint32_t num_overlay_formats;
+    drmmode_format_rec *overlay_formats;
+
     drmmode_bo rotate_bo;
     unsigned rotate_fb_id;
     drmmode_tearfree_rec tearfree;
@@ -306,6 +312,7 @@ typedef struct _msPixmapPriv {
     PixmapDirtyUpdatePtr dirty; /* cached dirty ent to avoid searching list */
     DrawablePtr secondary_src; /* if we exported shared pixmap, dirty tracking src */
     Bool notify_on_damage; /* if sink has requested damage notification */
+    CARD32 dirty_hold_until; /* earliest ms for the next dirty update */
 } msPixmapPrivRec, *msPixmapPrivPtr;
 
 #define msGetPixmapPriv(drmmode, p) ((msPixmapPrivPtr)dixGetPrivateAddr(&(p)->devPrivates, &(drmmode)->pixmapPrivateKeyRec))
@@ -364,6 +371,21 @@ void drmmode_copy_damage(xf86CrtcPtr crtc, PixmapPtr dst, RegionPtr damage,
 int drmmode_crtc_flip(xf86CrtcPtr crtc, uint32_t fb_id, int x, int y,
                       uint32_t flags, void *data);
 
+/* Merge flips for several CRTCs into one atomic commit (atomic only) */
+drmModeAtomicReq *drmmode_flip_batch_alloc(void);
+void drmmode_flip_batch_free(drmModeAtomicReq *req);
+int drmmode_crtc_flip_add(xf86CrtcPtr crtc, drmModeAtomicReq *req,
+                          uint32_t fb_id, int x, int y);
+int drmmode_flip_batch_commit(ScrnInfoPtr scrn, drmModeAtomicReq *req,
+                              uint32_t flags, void *data);
+
+/* Scan out a surface on the CRTC's reserved overlay plane */
+Bool drmmode_crtc_overlay_supported(xf86CrtcPtr crtc, uint32_t format);
+int drmmode_crtc_overlay_set(xf86CrtcPtr crtc, uint32_t fb_id,
+                             int src_x, int src_y, int src_w, int src_h,
+                             int crtc_x, int crtc_y, int crtc_w, int crtc_h);
+int drmmode_crtc_overlay_disable(xf86CrtcPtr crtc);
+
 Bool drmmode_crtc_get_fb_id(xf86CrtcPtr crtc, uint32_t *fb_id, int *x, int *y);
 
 void drmmode_set_dpms(ScrnInfoPtr scrn, int PowerManagementMode, int flags);
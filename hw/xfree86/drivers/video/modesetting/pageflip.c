@@ -250,6 +250,96 @@ queue_flip_on_crtc(ScreenPtr screen, xf86CrtcPtr crtc,
     return QUEUE_FLIP_SUCCESS;
 }
 
+/**
+ * Queue the flips for all enabled CRTCs as a single atomic commit.
+ *
+ * A commit per CRTC can land the individual flips in different vblanks,
+ * which shows up as tearing between genlocked heads; one merged commit
+ * makes the kernel apply every plane update in the same vblank. The
+ * kernel still delivers one page flip event per CRTC, so each CRTC gets
+ * its own drm queue entry; the entries share one sequence number and
+ * are matched by the CRTC id reported with the event.
+ *
+ * Returns FALSE with all queue entries cleaned up if the commit could
+ * not be queued, in which case the caller can fall back to per-CRTC
+ * flips.
+ */
+static Bool
+queue_flips_atomic(ScreenPtr screen, struct ms_flipdata *flipdata,
+                   xf86CrtcPtr ref_crtc, uint32_t flags)
+{
+    ScrnInfoPtr scrn = xf86ScreenToScrn(screen);
+    modesettingPtr ms = modesettingPTR(scrn);
+    xf86CrtcConfigPtr config = XF86_CRTC_CONFIG_PTR(scrn);
+    drmModeAtomicReq *req;
+    uint32_t seq = 0;
+    int queued = 0;
+    int i;
+
+    req = drmmode_flip_batch_alloc();
+    if (!req)
+        return FALSE;
+
+    for (i = 0; i < config->num_crtc; i++) {
+        xf86CrtcPtr crtc = config->crtc[i];
+        struct ms_crtc_pageflip *flip;
+        uint32_t ret;
+
+        if (!xf86_crtc_on(crtc))
+            continue;
+
+        if (drmmode_crtc_flip_add(crtc, req, ms->drmmode.fb_id,
+                                  crtc->x, crtc->y))
+            goto bail;
+
+        flip = calloc(1, sizeof(struct ms_crtc_pageflip));
+        if (flip == NULL)
+            goto bail;
+
+        flip->on_reference_crtc = crtc == ref_crtc;
+        flip->flipdata = flipdata;
+
+        ret = ms_drm_queue_alloc_shared(crtc, flip, ms_pageflip_handler,
+                                        ms_pageflip_abort, seq);
+        if (!ret) {
+            free(flip);
+            goto bail;
+        }
+        seq = ret;
+
+        /* take a reference on flipdata for use in flip */
+        flipdata->flip_count++;
+        queued++;
+    }
+
+    if (queued == 0)
+        goto bail;
+
+    while (drmmode_flip_batch_commit(scrn, req, flags,
+                                     (void *) (uintptr_t) seq)) {
+        /* We may have failed because the event queue was full, so flush
+         * it and retry; if there was nothing to flush the commit failed
+         * for some other reason.
+         */
+        if (ms_flush_drm_events(screen) <= 0)
+            goto bail;
+
+        xf86DrvMsg(scrn->scrnIndex, X_WARNING, "flip batch retry\n");
+    }
+
+    drmmode_flip_batch_free(req);
+    return TRUE;
+
+bail:
+    /* Aborting an entry removes it from the queue, so each call drops
+     * the next entry of the shared sequence.
+     */
+    for (i = 0; i < queued; i++)
+        ms_drm_abort_seq(scrn, seq);
+    drmmode_flip_batch_free(req);
+    return FALSE;
+}
+
 
 #define MS_ASYNC_FLIP_LOG_ENABLE_LOGS_INTERVAL_MS 10000
 #define MS_ASYNC_FLIP_LOG_FREQUENT_LOGS_INTERVAL_MS 1000
@@ -474,6 +564,24 @@ ms_do_pageflip(ScreenPtr screen,
      * Also, flips queued on disabled or incorrectly configured displays
      * may never complete; this is a configuration error.
      */
+    /* With atomic modesetting, all CRTC flips for this frame can go into
+     * one commit so every head flips in the same vblank. The commit
+     * flags apply to the request as a whole, so the merge is skipped
+     * when secondary CRTCs are to be flipped async while the reference
+     * CRTC is not; and if the merged commit cannot be queued, fall back
+     * to per-CRTC commits below.
+     */
+    if (ms->atomic_modeset &&
+        !(ms->drmmode.can_async_flip && ms->drmmode.async_flip_secondaries &&
+          ref_crtc && !async)) {
+        flags = DRM_MODE_PAGE_FLIP_EVENT;
+        if (ms->drmmode.can_async_flip && async)
+            flags |= DRM_MODE_PAGE_FLIP_ASYNC;
+
+        if (queue_flips_atomic(screen, flipdata, ref_crtc, flags))
+            goto flips_queued;
+    }
+
     for (i = 0; i < config->num_crtc; i++) {
         enum queue_flip_status flip_status;
         xf86CrtcPtr crtc = config->crtc[i];
@@ -522,6 +630,7 @@ ms_do_pageflip(ScreenPtr screen,
         }
     }
 
+ flips_queued:
     drmmode_bo_destroy(&ms->drmmode, &new_front_bo);
 
     /*
@@ -478,6 +478,24 @@ ms_drm_queue_alloc(xf86CrtcPtr crtc,
                    void *data,
                    ms_drm_handler_proc handler,
                    ms_drm_abort_proc abort)
+{
+    return ms_drm_queue_alloc_shared(crtc, data, handler, abort, 0);
+}
+
+/*
+ * Like ms_drm_queue_alloc, but for entries sharing one sequence number.
+ * A merged atomic commit generates one page flip event per CRTC, all
+ * carrying the same user data, so the entries of such a commit share
+ * the sequence number and are told apart by the CRTC id the kernel
+ * reports with each event. Pass seq 0 to start a new group and the
+ * returned value for the remaining CRTCs.
+ */
+uint32_t
+ms_drm_queue_alloc_shared(xf86CrtcPtr crtc,
+                          void *data,
+                          ms_drm_handler_proc handler,
+                          ms_drm_abort_proc abort,
+                          uint32_t seq)
 {
     ScreenPtr screen = crtc->randr_crtc->pScreen;
     ScrnInfoPtr scrn = xf86ScreenToScrn(screen);
@@ -487,9 +505,12 @@ ms_drm_queue_alloc(xf86CrtcPtr crtc,
 
     if (!q)
         return 0;
-    if (!ms_drm_seq)
-        ++ms_drm_seq;
-    q->seq = ms_drm_seq++;
+    if (!seq) {
+        if (!ms_drm_seq)
+            ++ms_drm_seq;
+        seq = ms_drm_seq++;
+    }
+    q->seq = seq;
     q->msc = UINT64_MAX;
     q->scrn = scrn;
     q->crtc = crtc;
@@ -574,12 +595,27 @@ ms_drm_abort(ScrnInfoPtr scrn, Bool (*match)(void *data, void *match_data),
     }
 }
 
+/*
+ * DRM object id of the CRTC a queue entry was filed for, for matching
+ * against the CRTC id the kernel reports with page flip events.
+ */
+static uint32_t
+ms_drm_queue_crtc_id(xf86CrtcPtr crtc)
+{
+    drmmode_crtc_private_ptr drmmode_crtc = crtc->driver_private;
+
+    return drmmode_crtc->mode_crtc ? drmmode_crtc->mode_crtc->crtc_id : 0;
+}
+
 /*
  * General DRM kernel handler. Looks for the matching sequence number in the
- * drm event queue and calls the handler for it.
+ * drm event queue and calls the handler for it. Entries of a merged atomic
+ * commit share a sequence number, so when the kernel told us which CRTC the
+ * event is for (crtc_id != 0) it disambiguates the match.
  */
 static void
-ms_drm_sequence_handler(int fd, uint64_t frame, uint64_t ns, Bool is64bit, uint64_t user_data)
+ms_drm_sequence_handler(int fd, uint64_t frame, uint64_t ns, Bool is64bit,
+                        uint32_t crtc_id, uint64_t user_data)
 {
     struct ms_drm_queue *q, *tmp;
     uint32_t seq = (uint32_t) user_data;
@@ -589,7 +625,8 @@ ms_drm_sequence_handler(int fd, uint64_t frame, uint64_t ns, Bool is64bit, uint6
 
     /* Handle the seq for this event first in order to get the CRTC */
     xorg_list_for_each_entry(q, &ms_drm_queue, list) {
-        if (q->seq == seq) {
+        if (q->seq == seq &&
+            (crtc_id == 0 || ms_drm_queue_crtc_id(q->crtc) == crtc_id)) {
             crtc = q->crtc;
             msc = ms_kernel_msc_to_crtc_msc(crtc, frame, is64bit);
 
@@ -649,7 +686,7 @@ static void
 ms_drm_sequence_handler_64bit(int fd, uint64_t frame, uint64_t ns, uint64_t user_data)
 {
     /* frame is true 64 bit wrapped into 64 bit */
-    ms_drm_sequence_handler(fd, frame, ns, TRUE, user_data);
+    ms_drm_sequence_handler(fd, frame, ns, TRUE, 0, user_data);
 }
 
 static void
@@ -658,7 +695,15 @@ ms_drm_handler(int fd, uint32_t frame, uint32_t sec, uint32_t usec,
 {
     /* frame is 32 bit wrapped into 64 bit */
     ms_drm_sequence_handler(fd, frame, ((uint64_t) sec * 1000000 + usec) * 1000,
-                            FALSE, (uint32_t) (uintptr_t) user_ptr);
+                            FALSE, 0, (uint32_t) (uintptr_t) user_ptr);
+}
+
+static void
+ms_drm_flip_handler2(int fd, unsigned int frame, unsigned int sec,
+                     unsigned int usec, unsigned int crtc_id, void *user_ptr)
+{
+    ms_drm_sequence_handler(fd, frame, ((uint64_t) sec * 1000000 + usec) * 1000,
+                            FALSE, crtc_id, (uint32_t) (uintptr_t) user_ptr);
 }
 
 Bool
@@ -678,6 +723,7 @@ ms_vblank_screen_init(ScreenPtr screen)
     ms->event_context.version = 4;
     ms->event_context.vblank_handler = ms_drm_handler;
     ms->event_context.page_flip_handler = ms_drm_handler;
+    ms->event_context.page_flip_handler2 = ms_drm_flip_handler2;
     ms->event_context.sequence_handler = ms_drm_sequence_handler_64bit;
 
     /* We need to re-register the DRM fd for the synchronisation
@@ -19,6 +19,7 @@
 #include "xf86int10_priv.h"
 #include "int10Defines.h"
 #include "Pci.h"
+#include <x86emu.h>
 
 #define ALLOC_ENTRIES(x) ((V_RAM / x) - 1)
 
@@ -93,6 +94,7 @@ int10MemRec genericMem = {
 
 static void MapVRam(xf86Int10InfoPtr pInt);
 static void UnmapVRam(xf86Int10InfoPtr pInt);
+static void setupFetchWindows(xf86Int10InfoPtr pInt);
 
 static void *sysMem = NULL;
 
@@ -313,7 +315,7 @@ UnmapVRam(xf86Int10InfoPtr pInt)
 Bool
 MapCurrentInt10(xf86Int10InfoPtr pInt)
 {
-    /* nothing to do here */
+    setupFetchWindows(pInt);
     return TRUE;
 }
 
@@ -325,8 +327,13 @@ xf86FreeInt10(xf86Int10InfoPtr pInt)
 #if defined (_PC)
     xf86Int10SaveRestoreBIOSVars(pInt, FALSE);
 #endif
-    if (Int10Current == pInt)
+    if (Int10Current == pInt) {
+        int i;
+
+        for (i = 0; i < X86EMU_FETCH_WINDOWS; i++)
+            X86EMU_setupFetchWindow(i, 0, 0, NULL);
         Int10Current = NULL;
+    }
     free(INTPriv(pInt)->base);
     UnmapVRam(pInt);
     free(INTPriv(pInt)->alloc);
@@ -417,6 +424,33 @@ xf86Int10FreePages(xf86Int10InfoPtr pInt, void *pbase, int num)
 	else \
 	    stl_u(val,(void *)(V_ADDR(addr)));
 
+/*
+ * Publish the linearly mapped parts of the int10 address space to the
+ * emulator so that instruction fetches can skip the Mem_rb/read_b double
+ * indirection (two indirect calls per code byte).  The VRAM aperture is
+ * left unpublished: chipsets can map MMIO registers behind it and code is
+ * never fetched from there anyway, so those accesses keep going through
+ * the read/write hooks.
+ */
+static void
+setupFetchWindows(xf86Int10InfoPtr pInt)
+{
+    uint32_t mid = V_RAM + VRAM_SIZE;
+
+    X86EMU_setupFetchWindow(0, 0, V_RAM, INTPriv(pInt)->base);
+    X86EMU_setupFetchWindow(1, mid,
+                            HIGH_OFFSET > mid ? HIGH_OFFSET - mid : 0,
+                            (char *) INTPriv(pInt)->base + mid);
+    if (INTPriv(pInt)->sysMem)
+        X86EMU_setupFetchWindow(2, HIGH_OFFSET,
+                                SYS_BIOS + BIOS_SIZE - HIGH_OFFSET,
+                                (char *) INTPriv(pInt)->sysMem +
+                                (HIGH_OFFSET - HIGH_BASE));
+    else
+        X86EMU_setupFetchWindow(2, 0, 0, NULL);
+    X86EMU_setupFetchWindow(3, 0, 0, NULL);
+}
+
 static uint8_t
 read_b(xf86Int10InfoPtr pInt, int addr)
 {
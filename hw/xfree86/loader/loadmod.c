@@ -59,9 +59,11 @@
 
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <fcntl.h>
 #include <regex.h>
 #include <dirent.h>
 #include <limits.h>
+#include <unistd.h>
 
 typedef struct _pattern {
     const char *pattern;
@@ -761,6 +763,60 @@ static const char *compiled_in_modules[] = {
     NULL
 };
 
+/*
+ * LoaderPrefetch: resolve a module to its file and hint the kernel to
+ * start reading it.  A cold server start spends most of its time in the
+ * serial dlopen() of each module faulting its file in from disk; hinting
+ * every file up front lets the kernel fetch them in the background while
+ * earlier modules initialize, without touching the load/init order.
+ * Failures are silent - this is only a hint, and LoadModule will report
+ * any real problem when it does the actual load.
+ */
+void
+LoaderPrefetch(const char *module)
+{
+    PatternPtr patterns;
+    char *name;
+    char *found = NULL;
+    char **pathlist;
+    char **path_elem;
+    const char **cim;
+
+    patterns = InitPatterns(NULL);
+    name = LoaderGetCanonicalName(module, patterns);
+    if (!name)
+        goto out;
+
+    for (cim = compiled_in_modules; *cim; cim++)
+        if (!strcmp(name, *cim))
+            goto out;
+
+    pathlist = LoaderGetPath(name);
+    if (!pathlist)
+        goto out;
+
+    if (PathIsAbsolute(module))
+        found = Xstrdup(module);
+    for (path_elem = pathlist; !found && *path_elem != NULL; path_elem++)
+        found = FindModule(name, *path_elem, patterns);
+
+    if (found) {
+        int fd = open(found, O_RDONLY | O_CLOEXEC);
+
+        if (fd >= 0) {
+#ifdef POSIX_FADV_WILLNEED
+            posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+            close(fd);
+        }
+    }
+
+ out:
+    FreePatterns(patterns);
+    free(found);
+    free(name);
+}
+
 /*
  * LoadModule: load a module
  *
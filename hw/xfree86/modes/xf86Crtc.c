@@ -1631,6 +1631,48 @@ handle_detailed_monrec(struct detailed_monitor_section *det_mon, void *data)
     }
 }
 
+/*
+ * Memoized mode validation: digest all inputs that determine an output's
+ * validated mode list. When a re-probe yields the same digest - common
+ * during dock/undock storms, where unrelated outputs are re-probed with
+ * identical EDID over and over - the previously validated, pruned and
+ * sorted probed_modes list is reused as-is.
+ */
+static uint64_t
+modeProbeHashBytes(uint64_t h, const void *data, int len)
+{
+    const unsigned char *c = data;
+
+    while (len-- > 0) {
+        h ^= *c++;
+        h *= 0x100000001b3ULL;      /* FNV-1a */
+    }
+    return h;
+}
+
+static uint64_t
+modeProbeHashModes(uint64_t h, DisplayModePtr modes)
+{
+    DisplayModePtr mode;
+
+    for (mode = modes; mode; mode = mode->next) {
+        h = modeProbeHashBytes(h, &mode->Clock, sizeof(mode->Clock));
+        h = modeProbeHashBytes(h, &mode->HDisplay, sizeof(mode->HDisplay));
+        h = modeProbeHashBytes(h, &mode->HSyncStart, sizeof(mode->HSyncStart));
+        h = modeProbeHashBytes(h, &mode->HSyncEnd, sizeof(mode->HSyncEnd));
+        h = modeProbeHashBytes(h, &mode->HTotal, sizeof(mode->HTotal));
+        h = modeProbeHashBytes(h, &mode->VDisplay, sizeof(mode->VDisplay));
+        h = modeProbeHashBytes(h, &mode->VSyncStart, sizeof(mode->VSyncStart));
+        h = modeProbeHashBytes(h, &mode->VSyncEnd, sizeof(mode->VSyncEnd));
+        h = modeProbeHashBytes(h, &mode->VTotal, sizeof(mode->VTotal));
+        h = modeProbeHashBytes(h, &mode->Flags, sizeof(mode->Flags));
+        h = modeProbeHashBytes(h, &mode->type, sizeof(mode->type));
+        if (mode->name)
+            h = modeProbeHashBytes(h, mode->name, strlen(mode->name) + 1);
+    }
+    return h;
+}
+
 void
 xf86ProbeOutputModes(ScrnInfoPtr scrn, int maxX, int maxY)
 {
@@ -1662,9 +1704,7 @@ xf86ProbeOutputModes(ScrnInfoPtr scrn, int maxX, int maxY)
         Bool add_default_modes;
         Bool debug_modes = config->debug_modes || xf86Initialising;
         enum det_monrec_source sync_source = sync_default;
-
-        while (output->probed_modes != NULL)
-            xf86DeleteMode(&output->probed_modes, output->probed_modes);
+        uint64_t probe_hash;
 
         /*
          * Check connection status
@@ -1674,6 +1714,9 @@ xf86ProbeOutputModes(ScrnInfoPtr scrn, int maxX, int maxY)
         if (output->status == XF86OutputStatusDisconnected &&
             !xf86ReturnOptValBool(output->options, OPTION_ENABLE, FALSE)) {
             xf86OutputSetEDID(output, NULL);
+            while (output->probed_modes != NULL)
+                xf86DeleteMode(&output->probed_modes, output->probed_modes);
+            output->probed_modes_hash = 0;
             continue;
         }
 
@@ -1769,6 +1812,48 @@ xf86ProbeOutputModes(ScrnInfoPtr scrn, int maxX, int maxY)
             mon_rec.nVrefresh = 1;
         }
 
+        /*
+         * Everything that determines the validated list is known now:
+         * digest it and keep the previous probed_modes when nothing
+         * changed, skipping validation, pruning and sorting entirely.
+         */
+        probe_hash = 0xcbf29ce484222325ULL;
+        probe_hash = modeProbeHashBytes(probe_hash, &maxX, sizeof(maxX));
+        probe_hash = modeProbeHashBytes(probe_hash, &maxY, sizeof(maxY));
+        probe_hash = modeProbeHashBytes(probe_hash, &min_clock,
+                                        sizeof(min_clock));
+        probe_hash = modeProbeHashBytes(probe_hash, &max_clock,
+                                        sizeof(max_clock));
+        probe_hash = modeProbeHashBytes(probe_hash, &mon_rec, sizeof(mon_rec));
+        probe_hash = modeProbeHashBytes(probe_hash, &sync_source,
+                                        sizeof(sync_source));
+        probe_hash = modeProbeHashBytes(probe_hash, &add_default_modes,
+                                        sizeof(add_default_modes));
+        if (edid_monitor && edid_monitor->rawData)
+            probe_hash = modeProbeHashBytes(probe_hash,
+                                            edid_monitor->rawData,
+                                            128 * (edid_monitor->no_sections + 1));
+        probe_hash = modeProbeHashModes(probe_hash, config_modes);
+        probe_hash = modeProbeHashModes(probe_hash, output_modes);
+
+        if (output->probed_modes != NULL &&
+            probe_hash == output->probed_modes_hash) {
+            while (output_modes != NULL)
+                xf86DeleteMode(&output_modes, output_modes);
+            while (config_modes != NULL)
+                xf86DeleteMode(&config_modes, config_modes);
+            if (debug_modes)
+                xf86DrvMsg(scrn->scrnIndex, X_INFO,
+                           "Keeping validated modes for output %s (unchanged)
+",
+                           output->name);
+            continue;
+        }
+        output->probed_modes_hash = probe_hash;
+
+        while (output->probed_modes != NULL)
+            xf86DeleteMode(&output->probed_modes, output->probed_modes);
+
         if (add_default_modes)
             default_modes = xf86GetDefaultModes();
 
@@ -653,6 +653,12 @@ struct _xf86Output {
     INT16 initialBorder[4];
 
     struct xf86CrtcTileInfo tile_info;
+
+    /**
+     * Digest of the inputs that produced probed_modes, so re-probes with
+     * unchanged EDID and constraints can keep the validated list
+     */
+    uint64_t probed_modes_hash;
 };
 
 typedef struct _xf86ProviderFuncs {
@@ -85,6 +85,32 @@ x86emu_intr_raise(u8 intrnum)
     M.x86.intr |= INTR_SYNCH;
 }
 
+/****************************************************************************
+PARAMETERS:
+addr	- Emulated address the instruction bytes are fetched from
+len	- Number of consecutive bytes that will be read
+
+REMARKS:
+Returns a host pointer for 'len' instruction bytes at 'addr' when the
+environment has published a direct fetch window covering them (see
+X86EMU_setupFetchWindow), or NULL when the fetch has to go through the
+sys_rdX function pointers.  BIOS POST is dominated by tight loops whose
+code lives in plain host memory; fetching those bytes directly avoids
+two indirect calls per instruction byte.
+****************************************************************************/
+static u8 *
+fetch_window_ptr(u32 addr, u32 len)
+{
+    int i;
+
+    for (i = 0; i < X86EMU_FETCH_WINDOWS; i++) {
+        if (M.fetch_win[i].size >= len &&
+            addr - M.fetch_win[i].start <= M.fetch_win[i].size - len)
+            return M.fetch_win[i].host + (addr - M.fetch_win[i].start);
+    }
+    return NULL;
+}
+
 /****************************************************************************
 REMARKS:
 Main execution loop for the emulator. We return from here when the system
@@ -95,6 +121,8 @@ void
 X86EMU_exec(void)
 {
     u8 op1;
+    u8 *ip;
+    u32 addr;
 
     M.x86.intr = 0;
     DB(x86emu_end_instr();
@@ -122,7 +150,9 @@ X86EMU_exec(void)
                 x86emu_intr_handle();
             }
         }
-        op1 = (*sys_rdb) (((u32) M.x86.R_CS << 4) + (M.x86.R_IP++));
+        addr = ((u32) M.x86.R_CS << 4) + (M.x86.R_IP++);
+        ip = fetch_window_ptr(addr, 1);
+        op1 = ip ? *ip : (*sys_rdb) (addr);
         (*x86emu_optab[op1]) (op1);
         if (M.x86.debug & DEBUG_EXIT) {
             M.x86.debug &= ~DEBUG_EXIT;
@@ -157,10 +187,14 @@ void
 fetch_decode_modrm(int *mod, int *regh, int *regl)
 {
     int fetched;
+    u32 addr;
+    u8 *ip;
 
     DB(if (CHECK_IP_FETCH())
        x86emu_check_ip_access();)
-        fetched = (*sys_rdb) (((u32) M.x86.R_CS << 4) + (M.x86.R_IP++));
+        addr = ((u32) M.x86.R_CS << 4) + (M.x86.R_IP++);
+    ip = fetch_window_ptr(addr, 1);
+    fetched = ip ? *ip : (*sys_rdb) (addr);
     INC_DECODED_INST_LEN(1);
     *mod = (fetched >> 6) & 0x03;
     *regh = (fetched >> 3) & 0x07;
@@ -181,10 +215,14 @@ u8
 fetch_byte_imm(void)
 {
     u8 fetched;
+    u32 addr;
+    u8 *ip;
 
     DB(if (CHECK_IP_FETCH())
        x86emu_check_ip_access();)
-        fetched = (*sys_rdb) (((u32) M.x86.R_CS << 4) + (M.x86.R_IP++));
+        addr = ((u32) M.x86.R_CS << 4) + (M.x86.R_IP++);
+    ip = fetch_window_ptr(addr, 1);
+    fetched = ip ? *ip : (*sys_rdb) (addr);
     INC_DECODED_INST_LEN(1);
     return fetched;
 }
@@ -203,10 +241,17 @@ u16
 fetch_word_imm(void)
 {
     u16 fetched;
+    u32 addr;
+    u8 *ip;
 
     DB(if (CHECK_IP_FETCH())
        x86emu_check_ip_access();)
-        fetched = (*sys_rdw) (((u32) M.x86.R_CS << 4) + (M.x86.R_IP));
+        addr = ((u32) M.x86.R_CS << 4) + (M.x86.R_IP);
+    ip = fetch_window_ptr(addr, 2);
+    if (ip)
+        fetched = ip[0] | ((u16) ip[1] << 8);
+    else
+        fetched = (*sys_rdw) (addr);
     M.x86.R_IP += 2;
     INC_DECODED_INST_LEN(2);
     return fetched;
@@ -226,10 +271,18 @@ u32
 fetch_long_imm(void)
 {
     u32 fetched;
+    u32 addr;
+    u8 *ip;
 
     DB(if (CHECK_IP_FETCH())
        x86emu_check_ip_access();)
-        fetched = (*sys_rdl) (((u32) M.x86.R_CS << 4) + (M.x86.R_IP));
+        addr = ((u32) M.x86.R_CS << 4) + (M.x86.R_IP);
+    ip = fetch_window_ptr(addr, 4);
+    if (ip)
+        fetched = ip[0] | ((u32) ip[1] << 8) |
+            ((u32) ip[2] << 16) | ((u32) ip[3] << 24);
+    else
+        fetched = (*sys_rdl) (addr);
     M.x86.R_IP += 4;
     INC_DECODED_INST_LEN(4);
     return fetched;
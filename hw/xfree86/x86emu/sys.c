@@ -445,6 +445,31 @@ X86EMU_setupMemFuncs(X86EMU_memFuncs * funcs)
     sys_wrl = funcs->wrl;
 }
 
+/****************************************************************************
+PARAMETERS:
+window	- Fetch window slot to set up (0 .. X86EMU_FETCH_WINDOWS-1)
+start	- First emulated address covered by the window
+size	- Number of bytes covered by the window (0 disables the slot)
+host	- Host pointer for 'start' (NULL disables the slot)
+
+REMARKS:
+Publishes a range of emulated addresses whose backing store is plain host
+memory, so that the instruction decoder can fetch code bytes directly
+instead of going through the sys_rdX function pointers for every byte.
+The environment must keep the mapping valid until the window is disabled
+and must disable it before the backing memory goes away.  Data accesses
+are not affected.
+****************************************************************************/
+void
+X86EMU_setupFetchWindow(int window, u32 start, u32 size, void *host)
+{
+    if (window < 0 || window >= X86EMU_FETCH_WINDOWS)
+        return;
+    M.fetch_win[window].start = start;
+    M.fetch_win[window].size = host ? size : 0;
+    M.fetch_win[window].host = host;
+}
+
 /****************************************************************************
 PARAMETERS:
 funcs	- New programmed I/O function pointers to make active
@@ -291,12 +291,27 @@ MEMBERS:
 mem_base		- Base real mode memory for the emulator
 mem_size		- Size of the real mode memory block for the emulator
 private			- private data pointer
+fetch_win		- Optional direct instruction fetch windows
 x86			- X86 registers
 ****************************************************************************/
+#define X86EMU_FETCH_WINDOWS	4
+
 typedef struct {
     unsigned long mem_base;
     unsigned long mem_size;
     void *private;
+    /*
+     * When the bytes behind a range of emulated addresses live in plain
+     * host memory, the environment can publish the mapping here (see
+     * X86EMU_setupFetchWindow) and the decoder reads instruction bytes
+     * directly instead of making two indirect calls per byte.  Data
+     * accesses and unpublished ranges still go through the rdX hooks.
+     */
+    struct {
+        u32 start;
+        u32 size;
+        u8 *host;
+    } fetch_win[X86EMU_FETCH_WINDOWS];
     X86EMU_regs x86;
 } X86EMU_sysEnv;
 
@@ -182,11 +182,55 @@ xnestChangeGC(GCPtr pGC, unsigned long mask)
     if (mask & GCArcMode)
         values.arc_mode = pGC->arcMode;
 
-    if (mask)
-        xcb_aux_change_gc(xnestUpstreamInfo.conn,
-                          xnest_upstream_gc(pGC),
-                          mask,
-                          &values);
+    /* Clients ping-ponging between GCs or re-setting the same foreground
+     * before every operation make DIX hand us masks whose values the
+     * parent server already has; strip those so they don't turn into
+     * ChangeGC churn on the wire. */
+    {
+        xnestPrivGC *priv = xnestGCPriv(pGC);
+
+#define ELIDE_UNCHANGED(bit, field)                             \
+        do {                                                    \
+            if (mask & (bit)) {                                 \
+                if ((priv->last_valid & (bit)) &&               \
+                    priv->last.field == values.field)           \
+                    mask &= ~(bit);                             \
+                else                                            \
+                    priv->last.field = values.field;            \
+            }                                                   \
+        } while (0)
+
+        ELIDE_UNCHANGED(GCFunction, function);
+        ELIDE_UNCHANGED(GCPlaneMask, plane_mask);
+        ELIDE_UNCHANGED(GCForeground, foreground);
+        ELIDE_UNCHANGED(GCBackground, background);
+        ELIDE_UNCHANGED(GCLineWidth, line_width);
+        ELIDE_UNCHANGED(GCLineStyle, line_style);
+        ELIDE_UNCHANGED(GCCapStyle, cap_style);
+        ELIDE_UNCHANGED(GCJoinStyle, join_style);
+        ELIDE_UNCHANGED(GCFillStyle, fill_style);
+        ELIDE_UNCHANGED(GCFillRule, fill_rule);
+        ELIDE_UNCHANGED(GCTile, tile);
+        ELIDE_UNCHANGED(GCStipple, stipple);
+        ELIDE_UNCHANGED(GCTileStipXOrigin, tile_stipple_origin_x);
+        ELIDE_UNCHANGED(GCTileStipYOrigin, tile_stipple_origin_y);
+        ELIDE_UNCHANGED(GCFont, font);
+        ELIDE_UNCHANGED(GCSubwindowMode, subwindow_mode);
+        ELIDE_UNCHANGED(GCGraphicsExposures, graphics_exposures);
+        ELIDE_UNCHANGED(GCClipXOrigin, clip_originX);
+        ELIDE_UNCHANGED(GCClipYOrigin, clip_originY);
+        ELIDE_UNCHANGED(GCDashOffset, dash_offset);
+        ELIDE_UNCHANGED(GCArcMode, arc_mode);
+#undef ELIDE_UNCHANGED
+
+        if (mask) {
+            xcb_aux_change_gc(xnestUpstreamInfo.conn,
+                              xnest_upstream_gc(pGC),
+                              mask,
+                              &values);
+            priv->last_valid |= mask;
+        }
+    }
 }
 
 void
@@ -196,6 +240,8 @@ xnestCopyGC(GCPtr pGCSrc, unsigned long mask, GCPtr pGCDst)
                 xnestGC(pGCSrc),
                 xnestGC(pGCDst),
                 mask);
+    /* the copy changed the destination behind the shadow's back */
+    xnestGCPriv(pGCDst)->last_valid &= ~mask;
 }
 
 void
@@ -209,6 +255,10 @@ xnestChangeClip(GCPtr pGC, int type, void *pValue, int nRects)
 {
     xnestDestroyClip(pGC);
 
+    /* SetClipRectangles carries its own clip origin upstream, so the
+     * shadow kept by xnestChangeGC no longer matches */
+    xnestGCPriv(pGC)->last_valid &= ~(GCClipXOrigin | GCClipYOrigin);
+
     switch (type) {
     case CT_NONE:
         {
@@ -17,11 +17,21 @@ is" without express or implied warranty.
 
 #include <X11/Xdefs.h>
 
+#include <xcb/xcb_aux.h>
+
 #include "include/gcstruct.h"
 #include "include/privates.h"
 
 typedef struct {
     uint32_t gc;
+    /*
+     * Shadow of the values last forwarded to the parent server, used to
+     * elide redundant ChangeGC requests: DIX revalidation frequently
+     * hands us masks whose values the parent already has.  A bit in
+     * last_valid is set once the matching field of last was forwarded.
+     */
+    uint32_t last_valid;
+    xcb_params_gc_t last;
 } xnestPrivGC;
 
 extern DevPrivateKeyRec xnestGCPrivateKeyRec;
@@ -455,6 +455,10 @@ typedef struct _winPrivScreenRec {
     HWND hwndScreen;
     BITMAPINFOHEADER *pbmih;
 
+    /* Copy of the shadow bitmap as of the last update, used to skip
+       unchanged scanlines inside damage boxes; NULL if unavailable */
+    char *pShadowCopy;
+
     /* Privates used by shadow fb DirectDraw Nonlocking engine */
     LPDIRECTDRAW pdd;
     LPDIRECTDRAW4 pdd4;
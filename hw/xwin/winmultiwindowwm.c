@@ -146,6 +146,11 @@ static void
 
 static WMMsgNodePtr PopMessage(WMMsgQueuePtr pQueue, WMInfoPtr pWMInfo);
 
+static WMMsgNodePtr TryPopMessage(WMMsgQueuePtr pQueue);
+
+static Bool
+ LaterMessageQueued(WMMsgQueuePtr pQueue, UINT msg, xcb_window_t iWindow);
+
 static Bool
  InitQueue(WMMsgQueuePtr pQueue);
 
@@ -303,24 +308,60 @@ PopMessage(WMMsgQueuePtr pQueue, WMInfoPtr pWMInfo)
     return pNode;
 }
 
-#if 0
 /*
- * HaveMessage -
+ * TryPopMessage - Pop a message from the queue, without blocking
+ */
+
+static WMMsgNodePtr
+TryPopMessage(WMMsgQueuePtr pQueue)
+{
+    WMMsgNodePtr pNode;
+
+    /* Lock the queue mutex */
+    pthread_mutex_lock(&pQueue->pmMutex);
+
+    pNode = pQueue->pHead;
+    if (pNode != NULL) {
+        pQueue->pHead = pNode->pNext;
+
+        if (pQueue->pTail == pNode) {
+            pQueue->pTail = NULL;
+        }
+    }
+
+    /* Release the queue mutex */
+    pthread_mutex_unlock(&pQueue->pmMutex);
+
+    return pNode;
+}
+
+/*
+ * LaterMessageQueued - Is another message of the same type for the same
+ * window still waiting in the queue?  If so, the work for the current
+ * message is about to be redone and can be skipped.
  */
 
 static Bool
-HaveMessage(WMMsgQueuePtr pQueue, UINT msg, xcb_window_t iWindow)
+LaterMessageQueued(WMMsgQueuePtr pQueue, UINT msg, xcb_window_t iWindow)
 {
     WMMsgNodePtr pNode;
+    Bool found = FALSE;
+
+    /* Lock the queue mutex */
+    pthread_mutex_lock(&pQueue->pmMutex);
 
     for (pNode = pQueue->pHead; pNode != NULL; pNode = pNode->pNext) {
-        if (pNode->msg.msg == msg && pNode->msg.iWindow == iWindow)
-            return True;
+        if (pNode->msg.msg == msg && pNode->msg.iWindow == iWindow) {
+            found = TRUE;
+            break;
+        }
     }
 
-    return False;
+    /* Release the queue mutex */
+    pthread_mutex_unlock(&pQueue->pmMutex);
+
+    return found;
 }
-#endif
 
 /*
  * InitQueue - Initialize the Window Manager message queue
@@ -807,6 +848,14 @@ winMultiWindowWMProc(void *pArg)
             pthread_exit(NULL);
         }
 
+        /*
+          Process this message and everything queued behind it before
+          flushing, so that a burst of messages (e.g. a session restoring
+          dozens of windows at once) goes out as one batch of requests
+          rather than being flushed one reply-sized piece at a time.
+        */
+        do {
+
 #if ENABLE_DEBUG
         ErrorF("winMultiWindowWMProc - MSG: %s (%d) ID: %d\n",
                MessageName(&(pNode->msg)), (int)pNode->msg.msg, (int)pNode->msg.dwID);
@@ -935,15 +984,26 @@ winMultiWindowWMProc(void *pArg)
             break;
 
         case WM_WM_NAME_EVENT:
-            UpdateName(pWMInfo, pNode->msg.iWindow);
+            /* Skip the update if a queued message will redo it anyway */
+            if (!LaterMessageQueued(&pWMInfo->wmMsgQueue, WM_WM_NAME_EVENT,
+                                    pNode->msg.iWindow))
+                UpdateName(pWMInfo, pNode->msg.iWindow);
             break;
 
         case WM_WM_ICON_EVENT:
-            UpdateIcon(pWMInfo, pNode->msg.iWindow);
+            /* Skip the update if a queued message will redo it anyway */
+            if (!LaterMessageQueued(&pWMInfo->wmMsgQueue, WM_WM_ICON_EVENT,
+                                    pNode->msg.iWindow))
+                UpdateIcon(pWMInfo, pNode->msg.iWindow);
             break;
 
         case WM_WM_HINTS_EVENT:
             {
+            /* Skip the update if a queued message will redo it anyway */
+            if (LaterMessageQueued(&pWMInfo->wmMsgQueue, WM_WM_HINTS_EVENT,
+                                   pNode->msg.iWindow))
+              break;
+
             /* Don't do anything if this is an override-redirect window */
             if (IsOverrideRedirect(pWMInfo->conn, pNode->msg.iWindow))
               break;
@@ -965,6 +1025,9 @@ winMultiWindowWMProc(void *pArg)
         /* Free the retrieved message */
         free(pNode);
 
+        /* Keep going while more messages are already waiting */
+        } while ((pNode = TryPopMessage(&pWMInfo->wmMsgQueue)) != NULL);
+
         /* Flush any pending events on our display */
         xcb_flush(pWMInfo->conn);
 
@@ -403,6 +403,19 @@ winAllocateFBShadowGDI(ScreenPtr pScreen)
              (int) pScreenInfo->dwStride);
 #endif
 
+    /* Allocate a copy of the shadow bitmap for scanline delta updates.
+       If the allocation fails we simply blit whole damage boxes, as
+       before.  Multi-window mode paints through WM_PAINT instead of
+       winShadowUpdateGDI, so it has no use for the copy. */
+    free(pScreenPriv->pShadowCopy);
+    pScreenPriv->pShadowCopy = NULL;
+    if (!pScreenInfo->fMultiWindow) {
+        pScreenPriv->pShadowCopy = malloc(dibsection.dsBmih.biSizeImage);
+        if (pScreenPriv->pShadowCopy)
+            memcpy(pScreenPriv->pShadowCopy, pScreenInfo->pfb,
+                   dibsection.dsBmih.biSizeImage);
+    }
+
     /* Redraw all windows */
     if (pScreenInfo->fMultiWindow)
         EnumThreadWindows(g_dwCurrentThreadID, winRedrawAllProcShadowGDI, 0);
@@ -419,10 +432,83 @@ winFreeFBShadowGDI(ScreenPtr pScreen)
     /* Free the shadow bitmap */
     DeleteObject(pScreenPriv->hbmpShadow);
 
+    /* Free the copy used for scanline delta updates */
+    free(pScreenPriv->pShadowCopy);
+    pScreenPriv->pShadowCopy = NULL;
+
     /* Invalidate the ScreenInfo's fb pointer */
     pScreenInfo->pfb = NULL;
 }
 
+/*
+ * Number of consecutive unchanged scanlines to include in a blit rather
+ * than paying the fixed cost of starting another one.  Each BitBlt
+ * becomes a separate drawing order on a remote desktop connection, so a
+ * small gap of unchanged scanlines (which the protocol's bitmap caching
+ * deduplicates anyway) is cheaper to resend than to split around.
+ */
+#define SHADOW_DELTA_MERGE_ROWS 4
+
+/*
+ * Blit one damage box, skipping the scanlines whose pixels have not
+ * changed since the last update, and bring the shadow copy up to date
+ * for the scanlines actually sent.
+ */
+
+static void
+winShadowUpdateBoxDelta(winPrivScreenPtr pScreenPriv, BoxPtr pBox)
+{
+    winScreenInfo *pScreenInfo = pScreenPriv->pScreenInfo;
+    DWORD dwStrideBytes = (pScreenInfo->dwStride * pScreenInfo->dwBPP) / 8;
+    DWORD dwLeft = (pBox->x1 * pScreenInfo->dwBPP) / 8;
+    DWORD dwRight = ((pBox->x2 * pScreenInfo->dwBPP) + 7) / 8;
+    DWORD cbRow = dwRight - dwLeft;
+    char *pShadow = (char *) pScreenInfo->pfb;
+    char *pCopy = pScreenPriv->pShadowCopy;
+    int y = pBox->y1;
+
+#define SHADOW_ROW_CHANGED(yy) \
+    (memcmp(pShadow + (yy) * dwStrideBytes + dwLeft, \
+            pCopy + (yy) * dwStrideBytes + dwLeft, cbRow) != 0)
+
+    while (y < pBox->y2) {
+        int yStart, yEnd, yy;
+        int iGap;
+
+        /* Find the next changed scanline */
+        while (y < pBox->y2 && !SHADOW_ROW_CHANGED(y))
+            ++y;
+        if (y == pBox->y2)
+            break;
+        yStart = y;
+
+        /* Extend the run of changed scanlines, absorbing gaps of
+           unchanged ones shorter than the cost of a separate blit */
+        yEnd = ++y;
+        iGap = 0;
+        while (y < pBox->y2 && iGap < SHADOW_DELTA_MERGE_ROWS) {
+            if (SHADOW_ROW_CHANGED(y)) {
+                yEnd = y + 1;
+                iGap = 0;
+            }
+            else
+                ++iGap;
+            ++y;
+        }
+
+        BitBlt(pScreenPriv->hdcScreen,
+               pBox->x1, yStart, pBox->x2 - pBox->x1, yEnd - yStart,
+               pScreenPriv->hdcShadow, pBox->x1, yStart, SRCCOPY);
+
+        /* Remember what the screen now shows */
+        for (yy = yStart; yy < yEnd; ++yy)
+            memcpy(pCopy + yy * dwStrideBytes + dwLeft,
+                   pShadow + yy * dwStrideBytes + dwLeft, cbRow);
+    }
+
+#undef SHADOW_ROW_CHANGED
+}
+
 /*
  * Blit the damaged regions of the shadow fb to the screen
  */
@@ -480,17 +566,23 @@ winShadowUpdateGDI(ScreenPtr pScreen, shadowBufPtr pBuf)
          dwBox < pScreenInfo->dwClipUpdatesNBoxes)) {
         /* Loop through all boxes in the damaged region */
         while (dwBox--) {
-            /*
-             * Calculate x offset, y offset, width, and height for
-             * current damage box
-             */
-            x = pBox->x1;
-            y = pBox->y1;
-            w = pBox->x2 - pBox->x1;
-            h = pBox->y2 - pBox->y1;
-
-            BitBlt(pScreenPriv->hdcScreen,
-                   x, y, w, h, pScreenPriv->hdcShadow, x, y, SRCCOPY);
+            if (pScreenPriv->pShadowCopy) {
+                /* Blit only the scanlines which actually changed */
+                winShadowUpdateBoxDelta(pScreenPriv, pBox);
+            }
+            else {
+                /*
+                 * Calculate x offset, y offset, width, and height for
+                 * current damage box
+                 */
+                x = pBox->x1;
+                y = pBox->y1;
+                w = pBox->x2 - pBox->x1;
+                h = pBox->y2 - pBox->y1;
+
+                BitBlt(pScreenPriv->hdcScreen,
+                       x, y, w, h, pScreenPriv->hdcShadow, x, y, SRCCOPY);
+            }
 
             /* Get a pointer to the next box */
             ++pBox;
@@ -521,6 +613,19 @@ winShadowUpdateGDI(ScreenPtr pScreen, shadowBufPtr pBuf)
 
         /* Reset the clip region */
         SelectClipRgn(pScreenPriv->hdcScreen, NULL);
+
+        /* Keep the shadow copy coherent with what was just displayed */
+        if (pScreenPriv->pShadowCopy) {
+            DWORD dwStrideBytes =
+                (pScreenInfo->dwStride * pScreenInfo->dwBPP) / 8;
+            DWORD dwLeft = (pBoxExtents->x1 * pScreenInfo->dwBPP) / 8;
+            DWORD dwRight = ((pBoxExtents->x2 * pScreenInfo->dwBPP) + 7) / 8;
+
+            for (y = pBoxExtents->y1; y < pBoxExtents->y2; ++y)
+                memcpy(pScreenPriv->pShadowCopy + y * dwStrideBytes + dwLeft,
+                       (char *) pScreenInfo->pfb + y * dwStrideBytes + dwLeft,
+                       dwRight - dwLeft);
+        }
     }
 
     /* Redraw all multiwindow windows */
@@ -74,6 +74,16 @@ typedef struct _saveSet {
 
 struct _ClientId;
 
+/* MRU cache of validated drawable lookups; entries are dropped whenever
+   dixLookupCacheGeneration moves past their generation */
+#define DIX_LOOKUP_CACHE_SIZE 4
+
+typedef struct _DrawableLookupCacheEntry {
+    XID id;
+    struct _Drawable *pDraw;
+    CARD32 generation;
+} DrawableLookupCacheEntry;
+
 typedef struct _Client {
     void *requestBuffer;
     void *osPrivate;             /* for OS layer, including scheduler */
@@ -108,10 +118,18 @@ typedef struct _Client {
 
     int smart_start_tick;
     int smart_stop_tick;
+    int smart_ready_tick;       /* when the client last became ready (or
+                                   was last aged while waiting) */
 
     DeviceIntPtr clientPtr;
     struct _ClientId *clientIds;
     int req_fds;
+    DrawableLookupCacheEntry lookupCache[DIX_LOOKUP_CACHE_SIZE];
+
+    /* live estimate of resource memory held by this client, maintained
+       by dix/resacct.c from the XRes size functions */
+    unsigned long resourceBytes;
+    Bool resourceBytesWarned;
 } ClientRec;
 
 extern _X_EXPORT TimeStamp currentTime;
@@ -226,6 +226,13 @@ typedef struct _SpriteRec {
     int spriteTraceSize;
     int spriteTraceGood;
 
+    /* XYToWindow() fast path: while the hit-geometry generation matches
+     * and the hot point stays inside traceBox, the cached spriteTrace is
+     * still the correct containment answer and no descent is needed */
+    BoxRec traceBox;
+    CARD32 traceGeneration;
+    ScreenPtr traceScreen;
+
     /* Due to delays between event generation and event processing, it is
      * possible that the pointer has crossed screen boundaries between the
      * time in which it begins generating events and the time when
@@ -298,6 +305,15 @@ typedef struct _TouchListener {
     enum InputLevel level;  /* matters only for emulating touches */
     WindowPtr window;
     GrabPtr grab;
+    /* memoized delivery resolution for non-grab listeners; valid while
+       the generations match and the same event type is being delivered */
+    CARD32 resolveInterestGen;
+    CARD32 resolveTreeGen;
+    CARD8 resolveEvtype;
+    CARD8 resolveEmulated;
+    WindowPtr resolveWin;
+    ClientPtr resolveClient;
+    struct _XI2Mask *resolveMask;
 } TouchListener;
 
 typedef struct _TouchPointInfo {
@@ -337,6 +353,13 @@ typedef struct _GestureListener {
     enum GestureListenerType type;
     WindowPtr window;
     GrabPtr grab;
+    /* memoized delivery resolution for non-grab listeners; valid while
+       the generations match and the same event type is being delivered */
+    CARD32 resolveInterestGen;
+    CARD32 resolveTreeGen;
+    CARD8 resolveEvtype;
+    WindowPtr resolveWin;
+    ClientPtr resolveClient;
 } GestureListener;
 
 typedef struct _GestureInfo {
@@ -512,6 +535,7 @@ typedef struct _SpriteInfoRec {
         CursorPtr pCursor;
         ScreenPtr pScreen;
         int elt;
+        CARD32 time;            /* next frame deadline, in ms */
     } anim;
 } SpriteInfoRec, *SpriteInfoPtr;
 
@@ -591,6 +615,13 @@ typedef struct _DeviceIntRec {
     /* scale matrix for absolute devices, this is the combined matrix of
        [1/scale] . [transform] . [scale]. See DeviceSetTransform */
     struct pixman_f_transform scale_and_transform;
+    /* both matrices are almost always identity (XTest devices always);
+       precomputed so per-event transforms can be skipped entirely */
+    Bool relative_transform_identity;
+    Bool scale_and_transform_identity;
+    /* scale_and_transform has no rotation/shear/projective part, so x and
+       y can be transformed independently of each other */
+    Bool scale_and_transform_st;
 
     /* XTest related master device id */
     int xtest_master_id;
@@ -599,6 +630,21 @@ typedef struct _DeviceIntRec {
     struct _SyncCounter *idle_counter;
 
     Bool ignoreXkbActionsBehaviors; /* TRUE if keys don't trigger behaviors and actions */
+
+    /* preallocated GetMaximumEventsNum()-sized event list, handed out by
+       AcquireEventList() so per-device event assembly stays off the heap */
+    InternalEvent *scratchEvents;
+    Bool scratchEventsInUse;
+
+    /* memoized negative CheckDeviceGrabs() result: the last press that
+       walked the passive grab lists and activated nothing; valid while
+       the grab and window-tree generations are unchanged */
+    CARD32 noGrabGeneration;
+    CARD32 noGrabTreeGeneration;
+    CARD32 noGrabDetail;
+    CARD16 noGrabEvtype;
+    WindowPtr noGrabSpriteWin;
+    WindowPtr noGrabFocusWin;
 } DeviceIntRec;
 
 typedef struct {
@@ -107,6 +107,28 @@ extern _X_EXPORT int ReadFdFromClient(ClientPtr client);
 extern _X_EXPORT int WriteToClient(ClientPtr /*who */ , int /*count */ ,
                                    const void * /*buf */ );
 
+/* called once the server is done with a buffer handed to WriteToClientVec() */
+typedef void (*WriteVecDoneProcPtr)(void *closure);
+
+extern _X_EXPORT int WriteToClientVec(ClientPtr who, int count,
+                                      const void *buf,
+                                      WriteVecDoneProcPtr done,
+                                      void *closure);
+
+/* Streamed consumption of very large requests (see os/io.c).  A check
+ * proc inspects the fixed part of an incoming request and decides
+ * whether its payload may be delivered incrementally; a streaming-aware
+ * request proc then consumes chunks via StreamedRequestConsume() and
+ * re-queues itself with ResetCurrentRequest() until done. */
+typedef Bool (*StreamRequestCheckProcPtr) (ClientPtr client, const void *req);
+
+extern _X_EXPORT void RegisterStreamableRequest(int majorOp, int hdrLen,
+                                                StreamRequestCheckProcPtr check);
+extern _X_EXPORT int StreamedRequestAvail(ClientPtr client);
+extern _X_EXPORT CARD32 StreamedRequestDone(ClientPtr client);
+extern _X_EXPORT void StreamedRequestConsume(ClientPtr client, int count);
+extern _X_EXPORT void StreamedRequestAbort(ClientPtr client);
+
 typedef void (*NotifyFdProcPtr)(int fd, int ready, void *data);
 
 #include "fd_notify.h"
@@ -285,6 +307,16 @@ _X_ATTRIBUTE_PRINTF(1, 2);
 extern _X_EXPORT void
 xorg_backtrace(void);
 
+/* Async-signal-safe capture of raw frame addresses into a preallocated
+ * buffer; pair with xorg_backtrace_symbolize() outside signal context. */
+extern _X_EXPORT void
+xorg_backtrace_capture(void);
+
+/* Symbolize and log the frames recorded by xorg_backtrace_capture();
+ * no-op if nothing was captured since the last call. */
+extern _X_EXPORT void
+xorg_backtrace_symbolize(void);
+
 /* should not be used anymore, just for backwards compat with drivers */
 #define LogVMessageVerbSigSafe(...) LogVMessageVerb(__VA_ARGS__)
 #define LogMessageVerbSigSafe(...) LogMessageVerb(__VA_ARGS__)
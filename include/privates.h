@@ -195,6 +195,44 @@ dixLookupPrivateAddr(PrivatePtr *privates, const DevPrivateKey key)
     return (void **) dixGetPrivateAddr(privates, key);
 }
 
+/*
+ * Fixed private slots: compile-time offsets for the handful of core
+ * consumers whose privates are probed on nearly every request (fb,
+ * damage, composite, glamor).  The first DIX_FIXED_PRIVATE_NUM pointers
+ * of every private area are reserved for these slots and
+ * dixRegisterPrivateKey hands out dynamic offsets above them, so fixed
+ * and keyed privates coexist in the same allocation.  A slot holds a
+ * single pointer, is NULL until its owner stores something, and resolves
+ * without touching any key structure.
+ */
+typedef enum {
+    FIXED_PRIVATE_FB,           /* fb screen state / window pixmap */
+    FIXED_PRIVATE_DAMAGE,       /* miext/damage screen/window/pixmap state */
+    FIXED_PRIVATE_COMPOSITE,    /* composite extension state */
+    FIXED_PRIVATE_GLAMOR,       /* glamor acceleration state */
+    DIX_FIXED_PRIVATE_NUM
+} DixFixedPrivateSlot;
+
+#define DIX_FIXED_PRIVATE_RESERVED (DIX_FIXED_PRIVATE_NUM * sizeof(void *))
+
+static inline void **
+dixGetFixedPrivateAddr(PrivatePtr *privates, DixFixedPrivateSlot slot)
+{
+    return ((void **) *privates) + slot;
+}
+
+static inline void *
+dixGetFixedPrivate(PrivatePtr *privates, DixFixedPrivateSlot slot)
+{
+    return *dixGetFixedPrivateAddr(privates, slot);
+}
+
+static inline void
+dixSetFixedPrivate(PrivatePtr *privates, DixFixedPrivateSlot slot, void *val)
+{
+    *dixGetFixedPrivateAddr(privates, slot) = val;
+}
+
 extern _X_EXPORT Bool
 
 dixRegisterScreenPrivateKey(DevScreenPrivateKeyPtr key, ScreenPtr pScreen,
@@ -53,6 +53,10 @@ SOFTWARE.
  *   PROPERTY -- property element
  */
 
+/* values up to this many bytes are stored in the PropertyRec itself
+   rather than in a separate heap allocation */
+#define PROP_INLINE_MAX 64
+
 typedef struct _Property {
     struct _Property *next;
     ATOM propertyName;
@@ -60,6 +64,7 @@ typedef struct _Property {
     uint32_t format;            /* format of data for swapping - 8,16,32 */
     uint32_t size;              /* size of data in (format/8) bytes */
     void *data;                 /* private to client */
+    char inlineData[PROP_INLINE_MAX];   /* small values; data points here */
     PrivateRec *devPrivates;
 } PropertyRec;
 
@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * Shared fork-join worker pool for data-parallel server work.
+ *
+ * Request execution in DIX stays single-threaded: the resource database,
+ * devPrivates and the screen structures are all unlocked global state, so
+ * per-client work is serialized by construction.  What can be spread over
+ * cores is the data-parallel inner work of a single request (tiled blits,
+ * scan conversion, shadow updates, ...).  ThreadPoolRun() hands `count`
+ * job slots to the pool and returns once all of them have completed, so
+ * callers keep their single-threaded view of the world.
+ */
+#ifndef _XSERVER_THREADPOOL_H_
+#define _XSERVER_THREADPOOL_H_
+
+#include <X11/Xdefs.h>
+#include <stddef.h>
+
+/* job callback; `slot` runs from 0 to count-1 */
+typedef void (*ThreadPoolFunc) (void *arg, int slot);
+
+/* number of usable workers; 0 means jobs run inline on the caller */
+int ThreadPoolWorkers(void);
+
+/* Run `count` slots of `func` across the pool and wait for completion.
+ * Falls back to running everything inline when no workers are available,
+ * so callers need no fallback path of their own.
+ */
+void ThreadPoolRun(ThreadPoolFunc func, void *arg, int count);
+
+#endif /* _XSERVER_THREADPOOL_H_ */
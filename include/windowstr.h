@@ -75,6 +75,11 @@ typedef struct _WindowOpt {
     Mask otherEventMasks;       /* default: 0 */
     struct _OtherClients *otherClients; /* default: NULL */
     struct _GrabRec *passiveGrabs;      /* default: NULL */
+    Mask passiveGrabDetails[8]; /* default: 0; bitmap of detail (keycode/
+                                   button) values claimed by passiveGrabs,
+                                   maintained by dix/grabs.c */
+    Bool passiveGrabAnyDetail;  /* default: FALSE; set when the bitmap
+                                   cannot summarize the list */
     CARD32 backingBitPlanes;    /* default: ~0L */
     CARD32 backingPixel;        /* default: 0 */
     RegionPtr boundingShape;    /* default: NULL */
@@ -131,6 +136,13 @@ typedef struct _Window {
     unsigned short borderWidth;
     unsigned short deliverableEvents;   /* all masks from all clients */
     Mask eventMask;             /* mask from the creating client */
+    /* memoized EventIsDeliverable() result; stale whenever
+       interestGeneration no longer matches dixEventInterestGeneration */
+    CARD32 interestGeneration;
+    CARD16 interestDevice;
+    CARD8 interestEvtype;
+    CARD8 interestMask;
+    CARD16 treeDepth;           /* generations below root (root = 0) */
     PixUnion background;
     PixUnion border;
     WindowOptPtr optional;
@@ -223,8 +223,37 @@ typedef struct {
     miArcSpan *spans;
     int count1, count2, k;
     char top, bot, hole;
+    char cached;                /* owned by the geometry cache, don't free */
 } miArcSpanData;
 
+/*
+ * Computed wide ellipse geometry depends only on the line width and the
+ * ellipse axes: the angles are sliced off at draw time and dashing walks
+ * the same span set segment by segment.  Clients that redraw the same
+ * gauges and dials every frame therefore hit this small LRU cache
+ * instead of rerunning the span computation per request.  Oversized
+ * ellipses are drawn but not cached to bound the memory held here.
+ */
+#define ARC_CACHE_SIZE	25
+#define ARC_CACHE_SPANS	1024
+
+typedef struct {
+    unsigned long lru;
+    int lw;
+    unsigned short width, height;
+    miArcSpanData *spdata;
+} miArcCacheRec;
+
+static miArcCacheRec miArcCache[ARC_CACHE_SIZE];
+static unsigned long miArcCacheLru;
+
+static void
+miFreeArcSpans(miArcSpanData * spdata)
+{
+    if (spdata && !spdata->cached)
+        free(spdata);
+}
+
 static void fillSpans(DrawablePtr pDrawable, GCPtr pGC);
 static void newFinalSpan(int y, int xmin, int xmax);
 static miArcSpanData *drawArc(xArc * tarc, int l, int a0, int a1,
@@ -747,10 +776,21 @@ tailX(double K,
 static miArcSpanData *
 miComputeWideEllipse(int lw, xArc * parc)
 {
+    miArcCacheRec *cent, *lru;
     int k;
 
     if (!lw)
         lw = 1;
+    lru = miArcCache;
+    for (cent = miArcCache; cent < miArcCache + ARC_CACHE_SIZE; cent++) {
+        if (cent->spdata && cent->lw == lw &&
+            cent->width == parc->width && cent->height == parc->height) {
+            cent->lru = ++miArcCacheLru;
+            return cent->spdata;
+        }
+        if (cent->lru < lru->lru)
+            lru = cent;
+    }
     k = (parc->height >> 1) + ((lw - 1) >> 1);
     miArcSpanData *spdata = calloc(1, sizeof(miArcSpanData) + sizeof(miArcSpan) * (k + 2));
     if (!spdata)
@@ -763,6 +803,15 @@ miComputeWideEllipse(int lw, xArc * parc)
         miComputeCircleSpans(lw, parc, spdata);
     else
         miComputeEllipseSpans(lw, parc, spdata);
+    if (k + 2 <= ARC_CACHE_SPANS) {
+        free(lru->spdata);
+        lru->spdata = spdata;
+        lru->lw = lw;
+        lru->width = parc->width;
+        lru->height = parc->height;
+        lru->lru = ++miArcCacheLru;
+        spdata->cached = TRUE;
+    }
     return spdata;
 }
 
@@ -866,7 +915,7 @@ miFillWideEllipse(DrawablePtr pDraw, GCPtr pGC, xArc * parc)
             wids += 2;
         }
     }
-    free(spdata);
+    miFreeArcSpans(spdata);
     (*pGC->ops->FillSpans) (pDraw, pGC, pts - points, points, widths, FALSE);
 
     free(widths);
@@ -907,7 +956,7 @@ miWideArc(DrawablePtr pDraw, GCPtr pGC, int narcs, xArc * parcs)
         for (i = narcs, parc = parcs; --i >= 0; parc++) {
             miArcSpanData *spdata;
             spdata = miArcSegment(pDraw, pGC, *parc, NULL, NULL, NULL);
-            free(spdata);
+            miFreeArcSpans(spdata);
         }
         fillSpans(pDraw, pGC);
         return;
@@ -1039,7 +1088,7 @@ miWideArc(DrawablePtr pDraw, GCPtr pGC, int narcs, xArc * parcs)
             if (spdata) {
                 if (lastArc.width != arcData->arc.width ||
                     lastArc.height != arcData->arc.height) {
-                    free(spdata);
+                    miFreeArcSpans(spdata);
                     spdata = NULL;
                 }
             }
@@ -1103,7 +1152,7 @@ miWideArc(DrawablePtr pDraw, GCPtr pGC, int narcs, xArc * parcs)
                 }
             }
         }
-        free(spdata);
+        miFreeArcSpans(spdata);
         spdata = NULL;
     }
     miFreeArcs(polyArcs, pGC);
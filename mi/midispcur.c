@@ -33,6 +33,7 @@ in this Software without prior written authorization from The Open Group.
 
 #include   <X11/X.h>
 
+#include   "dix/cachestats_priv.h"
 #include   "dix/dix_priv.h"
 #include   "dix/gc_priv.h"
 #include   "dix/screen_hooks_priv.h"
@@ -84,7 +85,9 @@ typedef struct {
     PixmapPtr sourceBits;       /* source bits */
     PixmapPtr maskBits;         /* mask bits */
     PicturePtr pPicture;
-    CursorPtr pCursor;
+    CursorBitsPtr pBits;        /* image the slot was realized from; keyed
+                                 * on the bits so cursors sharing one
+                                 * image (animated frames) hit the slot */
 } miDCScreenRec, *miDCScreenPtr;
 
 #define miGetDCScreen(s)	((miDCScreenPtr)(dixLookupPrivate(&(s)->devPrivates, miDCScreenKey)))
@@ -114,7 +117,7 @@ miDCInitialize(ScreenPtr pScreen, miPointerScreenFuncPtr screenFuncs)
 }
 
 static void
-miDCSwitchScreenCursor(ScreenPtr pScreen, CursorPtr pCursor, PixmapPtr sourceBits, PixmapPtr maskBits, PicturePtr pPicture)
+miDCSwitchScreenCursor(ScreenPtr pScreen, CursorBitsPtr pBits, PixmapPtr sourceBits, PixmapPtr maskBits, PicturePtr pPicture)
 {
     miDCScreenPtr pScreenPriv = dixLookupPrivate(&pScreen->devPrivates, miDCScreenKey);
     if (!pScreenPriv)
@@ -131,7 +134,7 @@ miDCSwitchScreenCursor(ScreenPtr pScreen, CursorPtr pCursor, PixmapPtr sourceBit
         FreePicture(pScreenPriv->pPicture, 0);
     pScreenPriv->pPicture = pPicture;
 
-    pScreenPriv->pCursor = pCursor;
+    pScreenPriv->pBits = pBits;
 }
 
 static void miDCCloseScreen(CallbackListPtr *pcbl, ScreenPtr pScreen, void *unused)
@@ -172,6 +175,9 @@ miDCMakePicture(PicturePtr * ppPicture, DrawablePtr pDraw, WindowPtr pWin)
     return pPicture;
 }
 
+/* effectiveness of the per-screen realized-cursor slot */
+static CacheStatsRec miDCRealizeStats;
+
 static Bool
 miDCRealize(ScreenPtr pScreen, CursorPtr pCursor)
 {
@@ -180,8 +186,16 @@ miDCRealize(ScreenPtr pScreen, CursorPtr pCursor)
     ChangeGCVal gcvals;
     PixmapPtr   sourceBits, maskBits;
 
-    if (pScreenPriv->pCursor == pCursor)
+    CacheStatsRegister(&miDCRealizeStats, "midc-realized-cursor");
+
+    if (pScreenPriv->pBits == pCursor->bits) {
+        CacheStatsHit(&miDCRealizeStats);
         return TRUE;
+    }
+
+    CacheStatsMiss(&miDCRealizeStats);
+    if (pScreenPriv->pBits)
+        CacheStatsEvict(&miDCRealizeStats);
 
     if (pCursor->bits->argb) {
         PixmapPtr pPixmap;
@@ -216,7 +230,7 @@ miDCRealize(ScreenPtr pScreen, CursorPtr pCursor)
         if (!pPicture)
             return FALSE;
 
-        miDCSwitchScreenCursor(pScreen, pCursor, NULL, NULL, pPicture);
+        miDCSwitchScreenCursor(pScreen, pCursor->bits, NULL, NULL, pPicture);
         return TRUE;
     }
 
@@ -267,7 +281,7 @@ miDCRealize(ScreenPtr pScreen, CursorPtr pCursor)
                            0, XYPixmap, (char *) pCursor->bits->source);
     FreeScratchGC(pGC);
 
-    miDCSwitchScreenCursor(pScreen, pCursor, sourceBits, maskBits, NULL);
+    miDCSwitchScreenCursor(pScreen, pCursor->bits, sourceBits, maskBits, NULL);
     return TRUE;
 }
 
@@ -276,7 +290,7 @@ miDCUnrealizeCursor(ScreenPtr pScreen, CursorPtr pCursor)
 {
     miDCScreenPtr pScreenPriv = dixLookupPrivate(&pScreen->devPrivates, miDCScreenKey);
 
-    if (pCursor == pScreenPriv->pCursor)
+    if (pCursor->bits == pScreenPriv->pBits)
         miDCSwitchScreenCursor(pScreen, NULL, NULL, NULL, NULL);
     return TRUE;
 }
@@ -44,11 +44,14 @@ in this Software without prior written authorization from The Open Group.
 #include   "dix/cursor_priv.h"
 #include   "dix/dix_priv.h"
 #include   "dix/input_priv.h"
+#include   "dix/inputlatency_priv.h"
 #include   "dix/inpututils_priv.h"
+#include   "dix/reqprof_priv.h"
 #include   "dix/screensaver_priv.h"
 #include   "mi/mi_priv.h"
 #include   "mi/mipointer_priv.h"
 #include   "os/bug_priv.h"
+#include   "os/probes_priv.h"
 #include   "os/screensaver.h"
 
 #include   "misc.h"
@@ -78,20 +81,33 @@ typedef struct _Event {
     InternalEvent *events;
     ScreenPtr pScreen;
     DeviceIntPtr pDev;          /* device this event _originated_ from */
+    uint64_t enqueue_ns;        /* monotonic stamp for latency tracking */
 } EventRec, *EventPtr;
 
 typedef struct _EventQueue {
     HWEventQueueType head, tail;        /* long for SetInputCheck */
     CARD32 lastEventTime;       /* to avoid time running backwards */
-    int lastMotion;             /* device ID if last event motion? */
     EventRec *events;           /* our queue as an array */
     size_t nevents;             /* the number of buckets in our queue */
     size_t dropped;             /* counter for number of consecutive dropped events */
+    Bool draining;              /* consumer inside mieqProcessInputEvents()?
+                                 * guarded by input_lock */
     mieqHandler handlers[128];  /* custom event handler */
 } EventQueueRec, *EventQueuePtr;
 
 static EventQueueRec miEventQueue;
 
+/* The ring is single-producer/single-consumer at any instant: enqueuers are
+ * serialized by input_lock, and only the dispatch thread dequeues.  Slots
+ * between head and tail belong to the consumer, everything else to the
+ * producer, so the hand-off needs no lock - the producer publishes a filled
+ * slot with a release store of `tail`, the consumer returns a drained slot
+ * with a release store of `head`.  input_lock is only taken to fence the
+ * array swap in mieqGrowQueue() against a concurrent drain.
+ */
+#define mieqLoadIndex(idx)       __atomic_load_n(&(idx), __ATOMIC_ACQUIRE)
+#define mieqStoreIndex(idx, val) __atomic_store_n(&(idx), (val), __ATOMIC_RELEASE)
+
 static CallbackListPtr miCallbacksWhenDrained = NULL;
 
 static size_t
@@ -197,38 +213,43 @@ mieqFini(void)
 
 /*
  * Must be reentrant with ProcessInputEvents.  Assumption: mieqEnqueue
- * will never be interrupted. Must be called with input_lock held
+ * will never be interrupted. Must be called with input_lock held.
+ *
+ * A slot is handed to the consumer by the release store of `tail` and may
+ * not be touched afterwards, so consecutive motion events are no longer
+ * merged in place here - mieqProcessInputEvents() coalesces them on the
+ * dequeue side instead.
  */
 
 void
 mieqEnqueue(DeviceIntPtr pDev, InternalEvent *e)
 {
-    unsigned int oldtail = miEventQueue.tail;
+    HWEventQueueType oldtail = miEventQueue.tail;       /* sole writer */
+    HWEventQueueType head = mieqLoadIndex(miEventQueue.head);
     InternalEvent *evt;
-    int isMotion = 0;
     int evlen;
     Time time;
     size_t n_enqueued;
 
     verify_internal_event(e);
 
-    n_enqueued = mieqNumEnqueued(&miEventQueue);
+    n_enqueued = oldtail - head + miEventQueue.nevents;
+    if (n_enqueued >= miEventQueue.nevents)
+        n_enqueued -= miEventQueue.nevents;
 
-    /* avoid merging events from different devices */
-    if (e->any.type == ET_Motion)
-        isMotion = pDev->id;
-
-    if (isMotion && isMotion == miEventQueue.lastMotion &&
-        oldtail != miEventQueue.head) {
-        oldtail = (oldtail - 1) % miEventQueue.nevents;
-    }
-    else if (n_enqueued + 1 == miEventQueue.nevents) {
-        if (!mieqGrowQueue(&miEventQueue, miEventQueue.nevents << 1)) {
+    if (n_enqueued + 1 == miEventQueue.nevents) {
+        /* Growing swaps out the slot array, which is only safe while the
+         * dispatch thread isn't scanning it. */
+        if (miEventQueue.draining ||
+            miEventQueue.nevents >= QUEUE_MAXIMUM_SIZE ||
+            !mieqGrowQueue(&miEventQueue, miEventQueue.nevents << 1)) {
             /* Toss events which come in late.  Usually this means your server's
              * stuck in an infinite loop in the main thread.
              */
-            miEventQueue.dropped++;
-            if (miEventQueue.dropped == 1) {
+            size_t dropped =
+                __atomic_add_fetch(&miEventQueue.dropped, 1, __ATOMIC_RELAXED);
+
+            if (dropped == 1) {
                 ErrorF("[mi] EQ overflowing.  Additional events will be "
                        "discarded until existing events are processed.\n");
                 xorg_backtrace();
@@ -236,12 +257,12 @@ mieqEnqueue(DeviceIntPtr pDev, InternalEvent *e)
                        "a culprit higher up the stack.\n");
                 ErrorF("[mi] mieq is *NOT* the cause.  It is a victim.\n");
             }
-            else if (miEventQueue.dropped % QUEUE_DROP_BACKTRACE_FREQUENCY == 0 &&
-                     miEventQueue.dropped / QUEUE_DROP_BACKTRACE_FREQUENCY <=
+            else if (dropped % QUEUE_DROP_BACKTRACE_FREQUENCY == 0 &&
+                     dropped / QUEUE_DROP_BACKTRACE_FREQUENCY <=
                      QUEUE_DROP_BACKTRACE_MAX) {
                 ErrorF("[mi] EQ overflow continuing. %lu events have been "
-                       "dropped.\n", (unsigned long)miEventQueue.dropped);
-                if (miEventQueue.dropped / QUEUE_DROP_BACKTRACE_FREQUENCY ==
+                       "dropped.\n", (unsigned long) dropped);
+                if (dropped / QUEUE_DROP_BACKTRACE_FREQUENCY ==
                     QUEUE_DROP_BACKTRACE_MAX) {
                     ErrorF("[mi] No further overflow reports will be "
                            "reported until the clog is cleared.\n");
@@ -267,9 +288,15 @@ mieqEnqueue(DeviceIntPtr pDev, InternalEvent *e)
     miEventQueue.lastEventTime = evt->any.time;
     miEventQueue.events[oldtail].pScreen = pDev ? EnqueueScreen(pDev) : NULL;
     miEventQueue.events[oldtail].pDev = pDev;
+    miEventQueue.events[oldtail].enqueue_ns = RequestProfileNow();
+
+    mieqStoreIndex(miEventQueue.tail, (oldtail + 1) % miEventQueue.nevents);
 
-    miEventQueue.lastMotion = isMotion;
-    miEventQueue.tail = (oldtail + 1) % miEventQueue.nevents;
+#ifdef XSERVER_DTRACE
+    if (XSERVER_MIEQ_ENQUEUE_ENABLED())
+        XSERVER_MIEQ_ENQUEUE(pDev ? pDev->id : -1, e->any.type,
+                             (int) (n_enqueued + 1));
+#endif
 }
 
 /**
@@ -525,8 +552,13 @@ mieqProcessInputEvents(void)
     ScreenPtr screen;
     InternalEvent event;
     DeviceIntPtr dev = NULL, master = NULL;
+    EventRec *queue;
+    size_t nevents, dropped;
+    HWEventQueueType head, tail;
     static Bool inProcessInputEvents = FALSE;
 
+    /* Pin the slot array against concurrent growth, then drain without
+     * touching input_lock again so enqueuers never wait on us. */
     input_lock();
 
     /*
@@ -537,27 +569,29 @@ mieqProcessInputEvents(void)
     BUG_WARN_MSG(inProcessInputEvents, "[mi] mieqProcessInputEvents() called recursively.\n");
     inProcessInputEvents = TRUE;
 
-    if (miEventQueue.dropped) {
+    queue = miEventQueue.events;
+    nevents = miEventQueue.nevents;
+    miEventQueue.draining = TRUE;
+
+    input_unlock();
+
+    dropped = __atomic_exchange_n(&miEventQueue.dropped, 0, __ATOMIC_RELAXED);
+    if (dropped) {
         ErrorF("[mi] EQ processing has resumed after %lu dropped events.\n",
-               (unsigned long) miEventQueue.dropped);
+               (unsigned long) dropped);
         ErrorF
             ("[mi] This may be caused by a misbehaving driver monopolizing the server's resources.\n");
-        miEventQueue.dropped = 0;
     }
 
-    while (miEventQueue.head != miEventQueue.tail) {
-        e = &miEventQueue.events[miEventQueue.head];
-
-        event = *e->events;
-        dev = e->pDev;
-        screen = e->pScreen;
-
-        miEventQueue.head = (miEventQueue.head + 1) % miEventQueue.nevents;
-
-        input_unlock();
-
-        master = (dev) ? GetMaster(dev, MASTER_ATTACHED) : NULL;
+    head = miEventQueue.head;   /* sole writer */
+    tail = mieqLoadIndex(miEventQueue.tail);
 
+    /* Wake the screen once per drain instead of once per event: anything
+     * in the queue counts as user activity, and after the first event has
+     * undone the saver / restored DPMS power the per-event checks were
+     * no-ops anyway.  At high input rates that keeps the saver bookkeeping
+     * out of the event loop entirely. */
+    if (head != tail) {
         if (screenIsSaved == SCREEN_SAVER_ON)
             dixSaveScreens(serverClient, SCREEN_SAVER_OFF, ScreenSaverReset);
 #ifdef DPMSExtension
@@ -567,20 +601,81 @@ mieqProcessInputEvents(void)
         if (DPMSPowerLevel != DPMSModeOn)
             DPMSSet(serverClient, DPMSModeOn);
 #endif
+    }
+
+    while (head != tail) {
+        uint64_t enqueue_ns;
+
+        e = &queue[head];
+
+        event = *e->events;
+        dev = e->pDev;
+        screen = e->pScreen;
+        enqueue_ns = e->enqueue_ns;
+
+        head = (head + 1) % nevents;
+
+        /* Coalesce runs of motion events from the same device down to the
+         * most recent one; every slot up to tail is ours to inspect.
+         * Each cooked motion is preceded in the queue by its raw event,
+         * so raw motions interleaved with the run are processed
+         * individually - XI2 raw listeners keep the device's full
+         * resolution while everyone else sees only the newest position. */
+        if (event.any.type == ET_Motion && dev) {
+            if (head == tail)
+                tail = mieqLoadIndex(miEventQueue.tail);
+            while (head != tail && queue[head].pDev == dev) {
+                if (queue[head].events->any.type == ET_Motion) {
+                    e = &queue[head];
+                    event = *e->events;
+                    screen = e->pScreen;
+                    enqueue_ns = e->enqueue_ns;
+                }
+                else if (queue[head].events->any.type == ET_RawMotion) {
+                    /* raw events don't move the sprite; deliver in place */
+                    InternalEvent raw = *queue[head].events;
+
+                    InputLatencyRecordQueued(dev, queue[head].enqueue_ns);
+                    InputLatencyBeginProcessing(dev, queue[head].enqueue_ns);
+                    mieqProcessDeviceEvent(dev, &raw, queue[head].pScreen);
+                    InputLatencyEndProcessing();
+                }
+                else
+                    break;
+                head = (head + 1) % nevents;
+                if (head == tail)
+                    tail = mieqLoadIndex(miEventQueue.tail);
+            }
+        }
 
+        mieqStoreIndex(miEventQueue.head, head);
+
+        master = (dev) ? GetMaster(dev, MASTER_ATTACHED) : NULL;
+
+        InputLatencyRecordQueued(dev, enqueue_ns);
+        InputLatencyBeginProcessing(dev, enqueue_ns);
         mieqProcessDeviceEvent(dev, &event, screen);
+        InputLatencyEndProcessing();
 
-        /* Update the sprite now. Next event may be from different device. */
+        /* Mark the sprite for repaint; the actual repaint happens once
+         * after the drain so interleaved events from several devices
+         * don't repaint the cursor more than once per dispatch cycle. */
         if (master &&
             (event.any.type == ET_Motion ||
              ((event.any.type == ET_TouchBegin ||
                event.any.type == ET_TouchUpdate) &&
               event.device_event.flags & TOUCH_POINTER_EMULATED)))
-            miPointerUpdateSprite(dev);
+            miPointerDeferUpdateSprite(dev);
 
-        input_lock();
+        if (head == tail)
+            tail = mieqLoadIndex(miEventQueue.tail);
     }
 
+    miPointerFlushDeferredSprites();
+
+    input_lock();
+
+    miEventQueue.draining = FALSE;
     inProcessInputEvents = FALSE;
 
     CallCallbacks(&miCallbacksWhenDrained, NULL);
@@ -105,6 +105,12 @@ the region package can call this.
 #define RECTLIMIT 25            /* pick a number, any number > 8 */
 #endif
 
+/* Restack and configure storms expose many windows in one validate pass;
+ * regions past RECTLIMIT collapse to their extents, so per-window scratch
+ * sized a little above that covers nearly every exposure without malloc.
+ */
+#define EXPOSE_STACK_RECTS 32
+
 /* miHandleExposures
     generate a region for exposures for areas that were copied from obscured or
 non-existent areas to non-obscured areas of the destination.  Paint the
@@ -303,12 +309,17 @@ miSendExposures(WindowPtr pWin, RegionPtr pRgn, int dx, int dy)
 {
     BoxPtr pBox;
     int numRects;
+    xEvent stackEvents[EXPOSE_STACK_RECTS];
     xEvent *pEvent, *pe;
     int i;
 
     pBox = RegionRects(pRgn);
     numRects = RegionNumRects(pRgn);
-    if (!(pEvent = calloc(1, numRects * sizeof(xEvent))))
+    if (numRects <= EXPOSE_STACK_RECTS) {
+        memset(stackEvents, 0, numRects * sizeof(xEvent));
+        pEvent = stackEvents;
+    }
+    else if (!(pEvent = calloc(numRects, sizeof(xEvent))))
         return;
 
     for (i = numRects, pe = pEvent; --i >= 0; pe++, pBox++) {
@@ -339,7 +350,8 @@ miSendExposures(WindowPtr pWin, RegionPtr pRgn, int dx, int dy)
             win = PanoramiXFindIDByScrnum(XRT_WINDOW,
                                           pWin->drawable.id, scrnum);
             if (!win) {
-                free(pEvent);
+                if (pEvent != stackEvents)
+                    free(pEvent);
                 return;
             }
             realWin = win->info[0].id;
@@ -356,7 +368,8 @@ miSendExposures(WindowPtr pWin, RegionPtr pRgn, int dx, int dy)
 
     DeliverEvents(pWin, pEvent, numRects, NullWindow);
 
-    free(pEvent);
+    if (pEvent != stackEvents)
+        free(pEvent);
 }
 
 void
@@ -401,6 +414,7 @@ miPaintWindow(WindowPtr pWin, RegionPtr prgn, int what)
     GCPtr pGC;
     int i;
     BoxPtr pbox;
+    xRectangle stackRects[EXPOSE_STACK_RECTS];
     xRectangle *prect;
     int numRects, regionnumrects;
 
@@ -522,13 +536,15 @@ miPaintWindow(WindowPtr pWin, RegionPtr prgn, int what)
     regionnumrects = RegionNumRects(prgn);
     if (regionnumrects == 0)
         return;
-    prect = calloc(regionnumrects, sizeof(xRectangle));
-    if (!prect)
+    if (regionnumrects <= EXPOSE_STACK_RECTS)
+        prect = stackRects;
+    else if (!(prect = calloc(regionnumrects, sizeof(xRectangle))))
         return;
 
     pGC = GetScratchGC(drawable->depth, drawable->pScreen);
     if (!pGC) {
-        free(prect);
+        if (prect != stackRects)
+            free(prect);
         return;
     }
 
@@ -545,7 +561,8 @@ miPaintWindow(WindowPtr pWin, RegionPtr prgn, int what)
     }
     prect -= numRects;
     (*pGC->ops->PolyFillRect) (drawable, pGC, numRects, prect);
-    free(prect);
+    if (prect != stackRects)
+        free(prect);
 
     FreeScratchGC(pGC);
 }
@@ -668,24 +668,55 @@ miPolyFillArc(DrawablePtr pDraw, GCPtr pGC, int narcs_all, xArc * parcs)
         pts = points = calloc(1, sizeof (DDXPointRec) * nspans +
                                sizeof(int) * nspans);
         if (points) {
+            xArc *prevArc = NULL;
+            int prevStart = 0, prevN = 0;
+
             wids = widths = (int *) (points + nspans);
 
             for (i = 0, arc = parcs; i < narcs; arc++, i++) {
                 if (miFillArcEmpty(arc))
                     continue;
-                if ((arc->angle2 >= FULLCIRCLE) || (arc->angle2 <= -FULLCIRCLE))
-                {
-                    if (miCanFillArc(arc))
-                        n = miFillEllipseI(pDraw, pGC, arc, pts, wids);
-                    else
-                        n = miFillEllipseD(pDraw, pGC, arc, pts, wids);
+                if (prevN &&
+                    arc->width == prevArc->width &&
+                    arc->height == prevArc->height &&
+                    arc->angle1 == prevArc->angle1 &&
+                    arc->angle2 == prevArc->angle2) {
+                    /* Same geometry as the arc just computed: every span
+                     * position is linear in the arc origin, so translate
+                     * the previous span set instead of stepping the
+                     * scanline recurrences all over again.  Dashboards
+                     * filling runs of equal ellipses hit this constantly.
+                     */
+                    int tx = arc->x - prevArc->x;
+                    int ty = arc->y - prevArc->y;
+                    DDXPointPtr prevPts = points + prevStart;
+
+                    for (n = 0; n < prevN; n++) {
+                        pts[n].x = prevPts[n].x + tx;
+                        pts[n].y = prevPts[n].y + ty;
+                    }
+                    memcpy(wids, widths + prevStart, prevN * sizeof(int));
+                    n = prevN;
                 }
-                else
-                {
-                    if (miCanFillArc(arc))
-                        n = miFillArcSliceI(pDraw, pGC, arc, pts, wids);
+                else {
+                    if ((arc->angle2 >= FULLCIRCLE) ||
+                        (arc->angle2 <= -FULLCIRCLE))
+                    {
+                        if (miCanFillArc(arc))
+                            n = miFillEllipseI(pDraw, pGC, arc, pts, wids);
+                        else
+                            n = miFillEllipseD(pDraw, pGC, arc, pts, wids);
+                    }
                     else
-                        n = miFillArcSliceD(pDraw, pGC, arc, pts, wids);
+                    {
+                        if (miCanFillArc(arc))
+                            n = miFillArcSliceI(pDraw, pGC, arc, pts, wids);
+                        else
+                            n = miFillArcSliceD(pDraw, pGC, arc, pts, wids);
+                    }
+                    prevArc = arc;
+                    prevStart = pts - points;
+                    prevN = n;
                 }
                 pts += n;
                 wids += n;
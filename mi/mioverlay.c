@@ -67,6 +67,7 @@ static DevPrivateKeyRec miOverlayScreenKeyRec;
 #define miOverlayScreenKey (&miOverlayScreenKeyRec)
 
 static void RebuildTree(WindowPtr);
+static void RebuildTreeFrom(WindowPtr);
 static Bool HasUnderlayChildren(WindowPtr);
 static void MarkUnderlayWindow(WindowPtr);
 static Bool CollectUnderlayChildrenRegions(WindowPtr, RegionPtr);
@@ -314,8 +315,24 @@ static void
 miOverlayReparentWindow(WindowPtr pWin, WindowPtr pPriorParent)
 {
     if (IN_UNDERLAY(pWin) || HasUnderlayChildren(pWin)) {
-        /* This could probably be more optimal */
-        RebuildTree(pWin->drawable.pScreen->root->firstChild);
+        WindowPtr pOld = pPriorParent;
+        WindowPtr pNew = pWin->parent;
+
+        /* Only the underlay subtrees the window left and joined can have
+         * changed; rebuilding those is equivalent to rebuilding from the
+         * root but doesn't walk every window on the screen.
+         */
+        while (IN_OVERLAY(pNew))
+            pNew = pNew->parent;
+
+        RebuildTreeFrom(pNew);
+
+        if (pOld) {
+            while (IN_OVERLAY(pOld))
+                pOld = pOld->parent;
+            if (pOld != pNew)
+                RebuildTreeFrom(pOld);
+        }
     }
 }
 
@@ -1737,24 +1754,27 @@ DoLeaf(WindowPtr pWin, miOverlayTreePtr parent, miOverlayTreePtr prevSib)
     return pTree;
 }
 
+/* Relink the underlay tree below pWin, which must itself be in the
+ * underlay.  Only the subtree is touched, so callers that know which
+ * underlay ancestor their change is confined to can avoid walking the
+ * whole screen.
+ */
 static void
-RebuildTree(WindowPtr pWin)
+RebuildTreeFrom(WindowPtr pWin)
 {
     miOverlayTreePtr parent, prevSib, tChild;
     WindowPtr pChild;
 
     prevSib = tChild = NULL;
 
-    pWin = pWin->parent;
-
-    while (IN_OVERLAY(pWin))
-        pWin = pWin->parent;
-
     parent = MIOVERLAY_GET_WINDOW_TREE(pWin);
 
     pChild = pWin->firstChild;
     parent->firstChild = parent->lastChild = NULL;
 
+    if (!pChild)
+        return;
+
     while (1) {
         if (IN_UNDERLAY(pChild))
             prevSib = tChild = DoLeaf(pChild, parent, prevSib);
@@ -1782,6 +1802,17 @@ RebuildTree(WindowPtr pWin)
     }
 }
 
+static void
+RebuildTree(WindowPtr pWin)
+{
+    pWin = pWin->parent;
+
+    while (IN_OVERLAY(pWin))
+        pWin = pWin->parent;
+
+    RebuildTreeFrom(pWin);
+}
+
 static Bool
 HasUnderlayChildren(WindowPtr pWin)
 {
@@ -81,6 +81,7 @@ typedef struct {
     int x, y;                   /* hot spot location */
     int devx, devy;             /* sprite position */
     Bool generateEvent;         /* generate an event during warping? */
+    Bool spriteDirty;           /* deferred repaint pending */
 } miPointerRec, *miPointerPtr;
 
 DevPrivateKeyRec miPointerScreenKeyRec;
@@ -506,6 +507,52 @@ miPointerUpdateSprite(DeviceIntPtr pDev)
     }
 }
 
+/**
+ * Mark the device's sprite for repaint without touching the screen.
+ * Called instead of miPointerUpdateSprite() from the event queue drain,
+ * where several events for the same sprite can arrive in one dispatch
+ * cycle; the repaint happens once in miPointerFlushDeferredSprites()
+ * with whatever position the pointer ended up at.
+ *
+ * @param pDev The device whose sprite needs a repaint
+ */
+void
+miPointerDeferUpdateSprite(DeviceIntPtr pDev)
+{
+    miPointerPtr pPointer;
+
+    if (!pDev || !pDev->coreEvents)
+        return;
+
+    pPointer = MIPOINTER(pDev);
+    if (!pPointer)
+        return;
+
+    /* slaves of the same master share the record, so a drain with
+       events from several slaves still repaints once */
+    pPointer->spriteDirty = TRUE;
+}
+
+/**
+ * Repaint all sprites marked by miPointerDeferUpdateSprite(); called
+ * once at the end of each event queue drain.
+ */
+void
+miPointerFlushDeferredSprites(void)
+{
+    for (DeviceIntPtr pDev = inputInfo.devices; pDev; pDev = pDev->next) {
+        miPointerPtr pPointer;
+
+        if (!pDev->coreEvents)
+            continue;
+        pPointer = MIPOINTER(pDev);
+        if (pPointer && pPointer->spriteDirty) {
+            pPointer->spriteDirty = FALSE;
+            miPointerUpdateSprite(pDev);
+        }
+    }
+}
+
 /**
  * Invalidate the current sprite and force it to be reloaded on next cursor setting
  * operation
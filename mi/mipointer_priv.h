@@ -15,6 +15,14 @@ void miPointerWarpCursor(DeviceIntPtr pDev, ScreenPtr pScreen, int x, int y);
 void miPointerSetScreen(DeviceIntPtr pDev, int screen_num, int x, int y);
 void miPointerUpdateSprite(DeviceIntPtr pDev);
 
+/* Mark the device's sprite for repaint instead of repainting right away;
+ * the event queue drain flushes all marked sprites once, so a burst of
+ * motion events within one dispatch cycle repaints the cursor once at
+ * its final position.
+ */
+void miPointerDeferUpdateSprite(DeviceIntPtr pDev);
+void miPointerFlushDeferredSprites(void);
+
  /* Invalidate current sprite, forcing reload on next
   * sprite setting (window crossing, grab action, etc)
   */
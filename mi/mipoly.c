@@ -59,6 +59,21 @@ SOFTWARE.
 #include "mipoly.h"
 #include "regionstr.h"
 
+/*
+ * Scratch storage recycled across polygon fills.  Mapping and CAD
+ * clients fill thousands of polygons per frame, and the per-fill
+ * edge-table calloc/free showed up ahead of the scan conversion
+ * itself.  The dispatch loop is single threaded, so statics suffice.
+ */
+#define ETE_POOL_MAX	4096    /* EdgeTableEntry slots kept resident */
+#define SLL_POOL_MAX	16      /* ScanLineListBlocks kept resident   */
+#define SPAN_BATCH	8192    /* spans per FillSpans for big fills  */
+
+static EdgeTableEntry *etePool;
+static int etePoolSize;
+static ScanLineListBlock *sllPool;
+static int sllPoolCount;
+
 /*
  * Insert the given edge into the edge table.  First we must find the correct
  * bucket in the Edge table, then find the right slot in the bucket.  Finally,
@@ -87,8 +102,12 @@ miInsertEdgeInET(EdgeTable * ET, EdgeTableEntry * ETE, int scanline,
      */
     if ((!pSLL) || (pSLL->scanline > scanline)) {
         if (*iSLLBlock > SLLSPERBLOCK - 1) {
-            tmpSLLBlock = calloc(1, sizeof(ScanLineListBlock));
-            if (!tmpSLLBlock)
+            if (sllPool) {
+                tmpSLLBlock = sllPool;
+                sllPool = sllPool->next;
+                sllPoolCount--;
+            }
+            else if (!(tmpSLLBlock = calloc(1, sizeof(ScanLineListBlock))))
                 return FALSE;
             (*SLLBlock)->next = tmpSLLBlock;
             tmpSLLBlock->next = NULL;
@@ -128,7 +147,13 @@ miFreeStorage(ScanLineListBlock * pSLLBlock)
 
     while (pSLLBlock) {
         tmpSLLBlock = pSLLBlock->next;
-        free(pSLLBlock);
+        if (sllPoolCount < SLL_POOL_MAX) {
+            pSLLBlock->next = sllPool;
+            sllPool = pSLLBlock;
+            sllPoolCount++;
+        }
+        else
+            free(pSLLBlock);
         pSLLBlock = tmpSLLBlock;
     }
 }
@@ -530,8 +555,12 @@ miFillGeneralPoly(DrawablePtr dst, GCPtr pgc, int count, DDXPointPtr ptsIn)
     ScanLineList *pSLL;         /* Current ScanLineList    */
     DDXPointPtr ptsOut;         /* ptr to output buffers   */
     int *width;
-    DDXPointRec FirstPoint[NUMPTSTOBUFFER];     /* the output buffers */
-    int FirstWidth[NUMPTSTOBUFFER];
+    DDXPointRec stackPoints[NUMPTSTOBUFFER];    /* the output buffers */
+    int stackWidths[NUMPTSTOBUFFER];
+    DDXPointPtr FirstPoint = stackPoints;
+    int *FirstWidth = stackWidths;
+    DDXPointPtr heapPoints = NULL;
+    int nPtsMax = NUMPTSTOBUFFER;
     EdgeTableEntry *pPrevAET;   /* previous AET entry      */
     EdgeTable ET;               /* Edge Table header node  */
     EdgeTableEntry AET;         /* Active ET header node   */
@@ -542,16 +571,40 @@ miFillGeneralPoly(DrawablePtr dst, GCPtr pgc, int count, DDXPointPtr ptsIn)
     if (count < 3)
         return TRUE;
 
-    if (!(pETEs = calloc(count, sizeof(EdgeTableEntry))))
+    if (count <= etePoolSize)
+        pETEs = memset(etePool, 0, count * sizeof(EdgeTableEntry));
+    else if (count <= ETE_POOL_MAX) {
+        free(etePool);
+        etePool = calloc(count, sizeof(EdgeTableEntry));
+        etePoolSize = etePool ? count : 0;
+        pETEs = etePool;
+    }
+    else
+        pETEs = calloc(count, sizeof(EdgeTableEntry));
+    if (!pETEs)
         return FALSE;
-    ptsOut = FirstPoint;
-    width = FirstWidth;
     if (!miCreateETandAET(count, ptsIn, &ET, &AET, pETEs, &SLLBlock)) {
-        free(pETEs);
+        if (pETEs != etePool)
+            free(pETEs);
         return FALSE;
     }
     pSLL = ET.scanlines.next;
 
+    /* Tall fills would otherwise flush NUMPTSTOBUFFER spans at a time;
+     * a larger heap batch amortizes FillSpans dispatch across the whole
+     * polygon.  Falls back to the stack buffer when memory is tight. */
+    if (ET.ymax - ET.ymin > NUMPTSTOBUFFER) {
+        heapPoints = malloc(SPAN_BATCH *
+                            (sizeof(DDXPointRec) + sizeof(int)));
+        if (heapPoints) {
+            FirstPoint = heapPoints;
+            FirstWidth = (int *) (heapPoints + SPAN_BATCH);
+            nPtsMax = SPAN_BATCH;
+        }
+    }
+    ptsOut = FirstPoint;
+    width = FirstWidth;
+
     if (pgc->fillRule == EvenOddRule) {
         /*
          *  for each scanline
@@ -580,7 +633,7 @@ miFillGeneralPoly(DrawablePtr dst, GCPtr pgc, int count, DDXPointPtr ptsIn)
                 /*
                  *  send out the buffer when its full
                  */
-                if (nPts == NUMPTSTOBUFFER) {
+                if (nPts == nPtsMax) {
                     (*pgc->ops->FillSpans) (dst, pgc,
                                             nPts, FirstPoint, FirstWidth, 1);
                     ptsOut = FirstPoint;
@@ -632,7 +685,7 @@ miFillGeneralPoly(DrawablePtr dst, GCPtr pgc, int count, DDXPointPtr ptsIn)
                     /*
                      *  send out the buffer
                      */
-                    if (nPts == NUMPTSTOBUFFER) {
+                    if (nPts == nPtsMax) {
                         (*pgc->ops->FillSpans) (dst, pgc, nPts, FirstPoint,
                                                 FirstWidth, 1);
                         ptsOut = FirstPoint;
@@ -663,7 +716,9 @@ miFillGeneralPoly(DrawablePtr dst, GCPtr pgc, int count, DDXPointPtr ptsIn)
      *     Get any spans that we missed by buffering
      */
     (*pgc->ops->FillSpans) (dst, pgc, nPts, FirstPoint, FirstWidth, 1);
-    free(pETEs);
+    free(heapPoints);
+    if (pETEs != etePool)
+        free(pETEs);
     miFreeStorage(SLLBlock.next);
     return TRUE;
 }
@@ -671,9 +671,15 @@ miSpriteSetCursor(DeviceIntPtr pDev, ScreenPtr pScreen,
     }
 
     if (!pPointer->isUp && pPointer->pCursor) {
-        SPRITE_DEBUG(("SetCursor restore %d\n", pDev->id));
-        miSpriteSaveUnderCursor(pDev, pScreen);
-        miSpriteRestoreCursor(pDev, pScreen);
+        /* Defer the repaint to the block handler, which runs once the
+         * whole input/request burst has been processed.  A stream of
+         * motion events then costs a single restore blit up front and
+         * one save + put before the server blocks, instead of three
+         * blits per event.
+         */
+        SPRITE_DEBUG(("SetCursor defer restore %d\n", pDev->id));
+        pPointer->pScreen = pScreen;
+        miSpriteRegisterBlockHandler(pScreen, pScreenPriv);
     }
 
 }
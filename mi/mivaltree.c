@@ -172,6 +172,61 @@ miShapedWindowIn(RegionPtr universe, RegionPtr bounding,
 				    HasBorder(w) && \
 				    (w)->backgroundState == ParentRelative)
 
+/*
+ * Marking casts a wide net: miMarkOverlappedWindows tests sibling subtrees
+ * against the extents box of the configured window, so a ConfigureWindow on
+ * one window routinely marks large unrelated subtrees.  A marked window
+ * whose own geometry is untouched and whose freshly computed universe comes
+ * out identical to its existing borderClip cannot change anywhere below
+ * either - the children's universes derive purely from it.  Drop the marks
+ * from such a subtree and leave its clip state alone, so the region work
+ * done per validation is proportional to the windows actually affected.
+ *
+ * Operation targets are always direct children of the window being
+ * validated, so an unchanged subtree never hides a moved or resized
+ * descendant; blindly-marked descendants of a moved target carry a nonzero
+ * displacement and fail the geometry test themselves.
+ */
+static Bool
+miPruneUnchangedSubtree(WindowPtr pParent, RegionPtr universe, VTKind kind)
+{
+    WindowPtr pChild;
+
+    if (kind == VTBroken)
+        return FALSE;
+    if (pParent->redirectDraw != RedirectDrawNone)
+        return FALSE;
+    if (pParent->valdata->before.resized ||
+        pParent->valdata->before.borderVisible ||
+        pParent->drawable.x != pParent->valdata->before.oldAbsCorner.x ||
+        pParent->drawable.y != pParent->valdata->before.oldAbsCorner.y)
+        return FALSE;
+    if (!RegionEqual(universe, &pParent->borderClip))
+        return FALSE;
+
+    pChild = pParent;
+    while (1) {
+        if (pChild->viewable) {
+            if (pChild->valdata) {
+                if (pChild->valdata->before.borderVisible)
+                    RegionDestroy(pChild->valdata->before.borderVisible);
+                free(pChild->valdata);
+                pChild->valdata = NULL;
+            }
+            if (pChild->firstChild) {
+                pChild = pChild->firstChild;
+                continue;
+            }
+        }
+        while (!pChild->nextSib && (pChild != pParent))
+            pChild = pChild->parent;
+        if (pChild == pParent)
+            break;
+        pChild = pChild->nextSib;
+    }
+    return TRUE;
+}
+
 /*
  *-----------------------------------------------------------------------
  * miComputeClips --
@@ -202,6 +257,9 @@ miComputeClips(WindowPtr pParent,
     Bool overlap;
     RegionPtr borderVisible;
 
+    if (miPruneUnchangedSubtree(pParent, universe, kind))
+        return;
+
     /*
      * Figure out the new visibility of this window.
      * The extent of the universe should be the same as the extent of
@@ -88,6 +88,11 @@ typedef struct {
 #define miSpansCarefulRop(rop)	(((rop) & 0xc) == 0x8 || ((rop) & 0x3) == 0x2)
 #define miSpansEasyRop(rop)	(!miSpansCarefulRop(rop))
 
+/* True only when the touch-each-pixel-once machinery is in use; easy
+ * rops keep their immediate-drawing shortcuts even when spans are being
+ * batched through the arena. */
+#define miSpansCareful(spanData) ((spanData) && (spanData)->careful)
+
 /*
 
 These routines maintain lists of Spans, in order to implement the
@@ -574,10 +579,75 @@ InitSpans(Spans * spans, size_t nspans)
  * interface data to span-merging polygon filler
  */
 
+/* Spans buffered per FillSpans flush in the easy-rop arena; 8K spans
+ * keeps the working set around 64KB while turning a 100k-segment
+ * polyline into a few dozen FillSpans calls instead of one per segment.
+ */
+#define SPAN_ARENA_SIZE 8192
+
 typedef struct _SpanData {
     SpanGroup fgGroup, bgGroup;
+    Bool careful;               /* rop demands touch-each-pixel-once groups */
+    DDXPointPtr arenaPoints;    /* flat batching arena for easy rops */
+    int *arenaWidths;
+    int arenaCount;
+    unsigned long arenaPixel;
 } SpanDataRec, *SpanDataPtr;
 
+static void
+miFlushSpanArena(DrawablePtr pDrawable, GCPtr pGC, SpanDataPtr spanData)
+{
+    ChangeGCVal oldPixel, tmpPixel;
+
+    if (!spanData->arenaCount)
+        return;
+    oldPixel.val = pGC->fgPixel;
+    if (spanData->arenaPixel != oldPixel.val) {
+        tmpPixel.val = (XID) spanData->arenaPixel;
+        ChangeGC(NULL, pGC, GCForeground, &tmpPixel);
+        ValidateGC(pDrawable, pGC);
+    }
+    (*pGC->ops->FillSpans) (pDrawable, pGC, spanData->arenaCount,
+                            spanData->arenaPoints, spanData->arenaWidths,
+                            FALSE);
+    spanData->arenaCount = 0;
+    if (spanData->arenaPixel != oldPixel.val) {
+        ChangeGC(NULL, pGC, GCForeground, &oldPixel);
+        ValidateGC(pDrawable, pGC);
+    }
+}
+
+static void
+miArenaAppendSpans(DrawablePtr pDrawable, GCPtr pGC, unsigned long pixel,
+                   Spans * spans, SpanDataPtr spanData)
+{
+    int done = 0;
+
+    /* Easy rops are idempotent, so spans of one pixel value may land in
+     * any order; flushing whenever the pixel changes preserves drawing
+     * order where double-dash fg/bg caps and joins overlap. */
+    if (pixel != spanData->arenaPixel) {
+        miFlushSpanArena(pDrawable, pGC, spanData);
+        spanData->arenaPixel = pixel;
+    }
+    while (done < spans->count) {
+        int n = spans->count - done;
+
+        if (n > SPAN_ARENA_SIZE - spanData->arenaCount)
+            n = SPAN_ARENA_SIZE - spanData->arenaCount;
+        memcpy(spanData->arenaPoints + spanData->arenaCount,
+               spans->points + done, n * sizeof(DDXPointRec));
+        memcpy(spanData->arenaWidths + spanData->arenaCount,
+               spans->widths + done, n * sizeof(int));
+        spanData->arenaCount += n;
+        done += n;
+        if (spanData->arenaCount == SPAN_ARENA_SIZE)
+            miFlushSpanArena(pDrawable, pGC, spanData);
+    }
+    free(spans->points);
+    free(spans->widths);
+}
+
 static void
 AppendSpanGroup(GCPtr pGC, unsigned long pixel, Spans * spanPtr,
                 SpanDataPtr spanData)
@@ -628,6 +698,8 @@ fillSpans(DrawablePtr pDrawable, GCPtr pGC, unsigned long pixel, Spans * spans,
             ValidateGC(pDrawable, pGC);
         }
     }
+    else if (!spanData->careful)
+        miArenaAppendSpans(pDrawable, pGC, pixel, spans, spanData);
     else
         AppendSpanGroup(pGC, pixel, spans, spanData);
 }
@@ -773,7 +845,10 @@ miFillRectPolyHelper(DrawablePtr pDrawable,
             y++;
         }
         spanRec.count = ppt - spanRec.points;
-        AppendSpanGroup(pGC, pixel, &spanRec, spanData);
+        if (!spanData->careful)
+            miArenaAppendSpans(pDrawable, pGC, pixel, &spanRec, spanData);
+        else
+            AppendSpanGroup(pGC, pixel, &spanRec, spanData);
     }
 }
 
@@ -976,7 +1051,7 @@ miLineJoin(DrawablePtr pDrawable,
     int joinStyle = pGC->joinStyle;
     int lw = pGC->lineWidth;
 
-    if (lw == 1 && !spanData) {
+    if (lw == 1 && !miSpansCareful(spanData)) {
         /* See if one of the lines will draw the joining pixel */
         if (pLeft->dx > 0 || (pLeft->dx == 0 && pLeft->dy > 0))
             return;
@@ -1853,8 +1928,27 @@ miWideSegment(DrawablePtr pDrawable,
 static SpanDataPtr
 miSetupSpanData(GCPtr pGC, SpanDataPtr spanData, int npt)
 {
-    if ((npt < 3 && pGC->capStyle != CapRound) || miSpansEasyRop(pGC->alu))
+    if (miSpansEasyRop(pGC->alu)) {
+        /* No touch-once bookkeeping needed, but long polylines are worth
+         * batching through the arena to amortize FillSpans dispatch.
+         * Short ones (and arena allocation failure) keep the immediate
+         * per-segment path. */
+        if (npt < 8)
+            return (SpanDataPtr) NULL;
+        spanData->arenaPoints = malloc(SPAN_ARENA_SIZE *
+                                       (sizeof(DDXPointRec) + sizeof(int)));
+        if (!spanData->arenaPoints)
+            return (SpanDataPtr) NULL;
+        spanData->arenaWidths =
+            (int *) (spanData->arenaPoints + SPAN_ARENA_SIZE);
+        spanData->arenaCount = 0;
+        spanData->arenaPixel = pGC->fgPixel;
+        spanData->careful = FALSE;
+        return spanData;
+    }
+    if (npt < 3 && pGC->capStyle != CapRound)
         return (SpanDataPtr) NULL;
+    spanData->careful = TRUE;
     if (pGC->lineStyle == LineDoubleDash)
         miInitSpanGroup(&spanData->bgGroup);
     miInitSpanGroup(&spanData->fgGroup);
@@ -1864,6 +1958,11 @@ miSetupSpanData(GCPtr pGC, SpanDataPtr spanData, int npt)
 static void
 miCleanupSpanData(DrawablePtr pDrawable, GCPtr pGC, SpanDataPtr spanData)
 {
+    if (!spanData->careful) {
+        miFlushSpanArena(pDrawable, pGC, spanData);
+        free(spanData->arenaPoints);
+        return;
+    }
     if (pGC->lineStyle == LineDoubleDash) {
         ChangeGCVal oldPixel, pixel;
 
@@ -1948,7 +2047,7 @@ miWideLine(DrawablePtr pDrawable, GCPtr pGC,
                 if (selfJoin)
                     firstFace = leftFace;
                 else if (pGC->capStyle == CapRound) {
-                    if (pGC->lineWidth == 1 && !spanData)
+                    if (pGC->lineWidth == 1 && !miSpansCareful(spanData))
                         miLineOnePoint(pDrawable, pGC, pixel, spanData, x1, y1);
                     else
                         miLineArc(pDrawable, pGC, pixel, spanData,
@@ -1969,7 +2068,7 @@ miWideLine(DrawablePtr pDrawable, GCPtr pGC,
                 miLineJoin(pDrawable, pGC, pixel, spanData, &firstFace,
                            &rightFace);
             else if (pGC->capStyle == CapRound) {
-                if (pGC->lineWidth == 1 && !spanData)
+                if (pGC->lineWidth == 1 && !miSpansCareful(spanData))
                     miLineOnePoint(pDrawable, pGC, pixel, spanData, x2, y2);
                 else
                     miLineArc(pDrawable, pGC, pixel, spanData,
@@ -2003,6 +2102,173 @@ miWideLine(DrawablePtr pDrawable, GCPtr pGC,
 #define V_BOTTOM    2
 #define V_LEFT	    3
 
+/* Dashed one-pixel-wide butt-capped orthogonal segments dominate the
+ * dashed work CAD-style clients generate, and miZeroDashLine lands here
+ * too since it draws with lineWidth forced to 1.  Every dash of such a
+ * segment is an axis-aligned rectangle one pixel high (or wide), and
+ * dash boundaries stay on integer coordinates, so the runs can be
+ * written straight into the span machinery without the per-dash polygon
+ * build and scan conversion of miWideDashSegment.  Returns FALSE when
+ * the segment doesn't qualify and the caller must take the general
+ * path; the emitted pixels and the dash state and face results are
+ * identical between the two.
+ */
+static Bool
+miWideDashThinSegment(DrawablePtr pDrawable,
+                      GCPtr pGC,
+                      SpanDataPtr spanData,
+                      int *pDashOffset,
+                      int *pDashIndex,
+                      int x1,
+                      int y1,
+                      int x2,
+                      int y2, LineFacePtr leftFace, LineFacePtr rightFace)
+{
+    int dashIndex, dashRemain;
+    unsigned char *pDash = pGC->dash;
+    int dx = x2 - x1;
+    int dy = y2 - y1;
+    int len, pos, n, i;
+    int xorg = 0, yorg = 0;
+    double rdx, rdy, k;
+    Bool doubleDash = (pGC->lineStyle == LineDoubleDash);
+    Spans fgSpans, bgSpans;
+    DDXPointPtr fgPt, bgPt;
+    int *fgWid, *bgWid;
+
+    if (pGC->lineWidth != 1 || pGC->capStyle != CapButt || (dx && dy))
+        return FALSE;
+
+    len = dx ? abs(dx) : abs(dy);
+
+    if (!InitSpans(&fgSpans, len))
+        return FALSE;
+    bgSpans.points = NULL;
+    bgSpans.widths = NULL;
+    if (doubleDash && !InitSpans(&bgSpans, len)) {
+        free(fgSpans.points);
+        free(fgSpans.widths);
+        return FALSE;
+    }
+    fgPt = fgSpans.points;
+    fgWid = fgSpans.widths;
+    bgPt = bgSpans.points;
+    bgWid = bgSpans.widths;
+
+    if (pGC->miTranslate) {
+        xorg = pDrawable->x;
+        yorg = pDrawable->y;
+    }
+
+    dashIndex = *pDashIndex;
+    dashRemain = pDash[dashIndex] - *pDashOffset;
+
+    pos = 0;
+    while (pos < len) {
+        n = dashRemain;
+        if (n > len - pos)
+            n = len - pos;
+
+        if (doubleDash || !(dashIndex & 1)) {
+            DDXPointPtr *ppt = (dashIndex & 1) ? &bgPt : &fgPt;
+            int **pwid = (dashIndex & 1) ? &bgWid : &fgWid;
+
+            if (dx) {
+                /* the dash covers the half-open interval [pos, pos+n) */
+                (*ppt)->x = ((dx > 0) ? x1 + pos : x1 - pos - n) + xorg;
+                (*ppt)->y = y1 + yorg;
+                ++*ppt;
+                *(*pwid)++ = n;
+            }
+            else {
+                for (i = 0; i < n; i++) {
+                    (*ppt)->x = x1 + xorg;
+                    (*ppt)->y = ((dy > 0) ? y1 + pos + i :
+                                 y1 - pos - i - 1) + yorg;
+                    ++*ppt;
+                    *(*pwid)++ = 1;
+                }
+            }
+        }
+
+        pos += n;
+        dashRemain -= n;
+        if (!dashRemain) {
+            if (++dashIndex == pGC->numInDashList)
+                dashIndex = 0;
+            dashRemain = pDash[dashIndex];
+        }
+    }
+
+    fgSpans.count = fgPt - fgSpans.points;
+    bgSpans.count = doubleDash ? bgPt - bgSpans.points : 0;
+
+    /* walking a leftward or upward segment emitted spans in descending
+     * order; the span consumers want them y- (and x-) ascending
+     */
+    if (dx < 0 || dy < 0) {
+        for (i = 0, n = fgSpans.count - 1; i < n; i++, n--) {
+            DDXPointRec tpt = fgSpans.points[i];
+            int tw = fgSpans.widths[i];
+
+            fgSpans.points[i] = fgSpans.points[n];
+            fgSpans.widths[i] = fgSpans.widths[n];
+            fgSpans.points[n] = tpt;
+            fgSpans.widths[n] = tw;
+        }
+        for (i = 0, n = bgSpans.count - 1; i < n; i++, n--) {
+            DDXPointRec tpt = bgSpans.points[i];
+            int tw = bgSpans.widths[i];
+
+            bgSpans.points[i] = bgSpans.points[n];
+            bgSpans.widths[i] = bgSpans.widths[n];
+            bgSpans.points[n] = tpt;
+            bgSpans.widths[n] = tw;
+        }
+    }
+
+    fillSpans(pDrawable, pGC, pGC->fgPixel, &fgSpans, spanData);
+    if (doubleDash) {
+        unsigned long bgPixel = pGC->bgPixel;
+
+        if (pGC->fillStyle == FillOpaqueStippled ||
+            pGC->fillStyle == FillTiled)
+            bgPixel = pGC->fgPixel;
+        fillSpans(pDrawable, pGC, bgPixel, &bgSpans, spanData);
+    }
+
+    if (dx) {
+        rdx = (dx < 0) ? -0.5 : 0.5;
+        rdy = 0.0;
+    }
+    else {
+        rdx = 0.0;
+        rdy = (dy < 0) ? -0.5 : 0.5;
+    }
+    k = 0.5 * len;
+
+    leftFace->x = x1;
+    leftFace->y = y1;
+    leftFace->dx = dx;
+    leftFace->dy = dy;
+    leftFace->xa = rdy;
+    leftFace->ya = -rdx;
+    leftFace->k = k;
+
+    rightFace->x = x2;
+    rightFace->y = y2;
+    rightFace->dx = -dx;
+    rightFace->dy = -dy;
+    rightFace->xa = -rdy;
+    rightFace->ya = rdx;
+    rightFace->k = k;
+
+    *pDashIndex = dashIndex;
+    *pDashOffset = pDash[dashIndex] - dashRemain;
+
+    return TRUE;
+}
+
 static void
 miWideDashSegment(DrawablePtr pDrawable,
                   GCPtr pGC,
@@ -2403,9 +2669,15 @@ miWideDash(DrawablePtr pDrawable, GCPtr pGC,
                 (!selfJoin || !firstIsFg))
                 projectRight = TRUE;
             prevDashIndex = dashIndex;
-            miWideDashSegment(pDrawable, pGC, spanData, &dashOffset, &dashIndex,
-                              x1, y1, x2, y2,
-                              projectLeft, projectRight, &leftFace, &rightFace);
+            if (!miWideDashThinSegment(pDrawable, pGC, spanData,
+                                       &dashOffset, &dashIndex,
+                                       x1, y1, x2, y2,
+                                       &leftFace, &rightFace))
+                miWideDashSegment(pDrawable, pGC, spanData,
+                                  &dashOffset, &dashIndex,
+                                  x1, y1, x2, y2,
+                                  projectLeft, projectRight,
+                                  &leftFace, &rightFace);
             startIsFg = !(prevDashIndex & 1);
             endIsFg = (dashIndex & 1) ^ (dashOffset != 0);
             if (pGC->lineStyle == LineDoubleDash || startIsFg) {
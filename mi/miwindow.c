@@ -786,6 +786,82 @@ miSpriteTrace(SpritePtr pSprite, int x, int y)
     return DeepestSpriteWin(pSprite);
 }
 
+/**
+ * Compute the box within which the spriteTrace just produced by
+ * miSpriteTrace() stays the correct answer: the intersection of the
+ * traced windows' extents, abandoned as soon as any shaped trace
+ * window, overlapping higher sibling or child of the leaf could flip
+ * the containment answer. While the pointer stays inside this box and
+ * no window geometry changes, miXYToWindow() can skip the descent.
+ */
+static void
+miComputeTraceBox(SpritePtr pSprite, ScreenPtr pScreen, int x, int y)
+{
+    WindowPtr pLeaf = pSprite->spriteTrace[pSprite->spriteTraceGood - 1];
+    BoxRec box;
+    int i;
+
+    pSprite->traceGeneration = 0;       /* assume no usable box */
+
+    if (wBoundingShape(pLeaf) || wInputShape(pLeaf))
+        return;
+
+    box.x1 = pLeaf->drawable.x - wBorderWidth(pLeaf);
+    box.y1 = pLeaf->drawable.y - wBorderWidth(pLeaf);
+    box.x2 = pLeaf->drawable.x + (int) pLeaf->drawable.width +
+        wBorderWidth(pLeaf);
+    box.y2 = pLeaf->drawable.y + (int) pLeaf->drawable.height +
+        wBorderWidth(pLeaf);
+
+    for (i = 1; i < pSprite->spriteTraceGood; i++) {
+        WindowPtr pWin = pSprite->spriteTrace[i];
+        WindowPtr pSib;
+
+        /* inside a shape, the extent box over-approximates the hit area */
+        if (wBoundingShape(pWin) || wInputShape(pWin))
+            return;
+
+        box.x1 = max(box.x1, pWin->drawable.x - wBorderWidth(pWin));
+        box.y1 = max(box.y1, pWin->drawable.y - wBorderWidth(pWin));
+        box.x2 = min(box.x2, pWin->drawable.x +
+                     (int) pWin->drawable.width + wBorderWidth(pWin));
+        box.y2 = min(box.y2, pWin->drawable.y +
+                     (int) pWin->drawable.height + wBorderWidth(pWin));
+
+        /* a higher sibling reaching into the box could win the hit test
+         * for part of it */
+        for (pSib = pWin->parent->firstChild; pSib != pWin;
+             pSib = pSib->nextSib) {
+            if (!pSib->mapped || pSib->unhittable)
+                continue;
+            if (pSib->drawable.x - wBorderWidth(pSib) < box.x2 &&
+                pSib->drawable.x + (int) pSib->drawable.width +
+                wBorderWidth(pSib) > box.x1 &&
+                pSib->drawable.y - wBorderWidth(pSib) < box.y2 &&
+                pSib->drawable.y + (int) pSib->drawable.height +
+                wBorderWidth(pSib) > box.y1)
+                return;
+        }
+    }
+
+    /* a child of the leaf reaching into the box would take over the hit */
+    for (pLeaf = pLeaf->firstChild; pLeaf; pLeaf = pLeaf->nextSib) {
+        if (!pLeaf->mapped || pLeaf->unhittable)
+            continue;
+        if (pLeaf->drawable.x - wBorderWidth(pLeaf) < box.x2 &&
+            pLeaf->drawable.x + (int) pLeaf->drawable.width +
+            wBorderWidth(pLeaf) > box.x1 &&
+            pLeaf->drawable.y - wBorderWidth(pLeaf) < box.y2 &&
+            pLeaf->drawable.y + (int) pLeaf->drawable.height +
+            wBorderWidth(pLeaf) > box.y1)
+            return;
+    }
+
+    pSprite->traceBox = box;
+    pSprite->traceScreen = pScreen;
+    pSprite->traceGeneration = dixHitGeometryGeneration;
+}
+
 /**
  * Traversed from the root window to the window at the position x/y. While
  * traversing, it sets up the traversal history in the spriteTrace array.
@@ -800,6 +876,20 @@ miSpriteTrace(SpritePtr pSprite, int x, int y)
 WindowPtr
 miXYToWindow(ScreenPtr pScreen, SpritePtr pSprite, int x, int y)
 {
+    WindowPtr pWin;
+
+    /* common case: the pointer moved but stayed inside the box for which
+     * the previous descent's answer is known to hold */
+    if (pSprite->traceGeneration == dixHitGeometryGeneration &&
+        pSprite->traceScreen == pScreen &&
+        pSprite->spriteTraceGood > 0 &&
+        pSprite->spriteTrace[0] == pScreen->root &&
+        x >= pSprite->traceBox.x1 && x < pSprite->traceBox.x2 &&
+        y >= pSprite->traceBox.y1 && y < pSprite->traceBox.y2)
+        return DeepestSpriteWin(pSprite);
+
     pSprite->spriteTraceGood = 1;       /* root window still there */
-    return miSpriteTrace(pSprite, x, y);
+    pWin = miSpriteTrace(pSprite, x, y);
+    miComputeTraceBox(pSprite, pScreen, x, y);
+    return pWin;
 }
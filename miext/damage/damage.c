@@ -24,8 +24,10 @@
 
 #include <stdlib.h>
 
+#include "dix/reqprof_priv.h"
 #include "dix/screen_hooks_priv.h"
 #include "os/osdep.h"
+#include "os/probes_priv.h"
 
 #include    <X11/X.h>
 #include    "scrnintstr.h"
@@ -67,22 +69,13 @@
 #endif
 
 #define getPixmapDamageRef(pPixmap) ((DamagePtr *) \
-    dixLookupPrivateAddr(&(pPixmap)->devPrivates, damagePixPrivateKey))
+    dixGetFixedPrivateAddr(&(pPixmap)->devPrivates, FIXED_PRIVATE_DAMAGE))
 
 #define pixmapDamage(pPixmap)		damagePixPriv(pPixmap)
 
-static DevPrivateKeyRec damageScrPrivateKeyRec;
-
-#define damageScrPrivateKey (&damageScrPrivateKeyRec)
-static DevPrivateKeyRec damagePixPrivateKeyRec;
-
-#define damagePixPrivateKey (&damagePixPrivateKeyRec)
 static DevPrivateKeyRec damageGCPrivateKeyRec;
 
 #define damageGCPrivateKey (&damageGCPrivateKeyRec)
-static DevPrivateKeyRec damageWinPrivateKeyRec;
-
-#define damageWinPrivateKey (&damageWinPrivateKeyRec)
 
 static DamagePtr *
 getDrawableDamageRef(DrawablePtr pDrawable)
@@ -121,7 +114,97 @@ getDrawableDamageRef(DrawablePtr pDrawable)
 
 #define winDamageRef(pWindow) \
     DamagePtr	*pPrev = (DamagePtr *) \
-	dixLookupPrivateAddr(&(pWindow)->devPrivates, damageWinPrivateKey)
+	dixGetFixedPrivateAddr(&(pWindow)->devPrivates, FIXED_PRIVATE_DAMAGE)
+
+/*
+ * Round the region out to the damage's coalescing grid, if one is
+ * configured.  Tile-aligned boxes merge readily when unioned, which
+ * keeps accumulated damage from fragmenting into hundreds of small
+ * rectangles under text-heavy workloads.  Returns pRegion untouched
+ * when no coalescing applies, else pCoalesced filled with the rounded
+ * region.
+ */
+static RegionPtr
+damageCoalesceRegion(DamagePtr pDamage, RegionPtr pRegion,
+                     RegionPtr pCoalesced)
+{
+    int tile = pDamage->coalesceTile;
+    BoxRec stackBoxes[16];
+    BoxPtr boxes = stackBoxes;
+    BoxPtr pBoxes;
+    int nBoxes;
+
+    if (!tile)
+        return pRegion;
+
+    nBoxes = RegionNumRects(pRegion);
+    if (!nBoxes)
+        return pRegion;
+
+    if (nBoxes > ARRAY_SIZE(stackBoxes)) {
+        boxes = calloc(nBoxes, sizeof(BoxRec));
+        if (!boxes)
+            return pRegion;
+    }
+
+    pBoxes = RegionRects(pRegion);
+    for (int i = 0; i < nBoxes; i++) {
+        boxes[i].x1 = pBoxes[i].x1 & ~(tile - 1);
+        boxes[i].y1 = pBoxes[i].y1 & ~(tile - 1);
+        boxes[i].x2 = (pBoxes[i].x2 + tile - 1) & ~(tile - 1);
+        boxes[i].y2 = (pBoxes[i].y2 + tile - 1) & ~(tile - 1);
+    }
+
+    RegionUninit(pCoalesced);
+    if (!RegionInitBoxes(pCoalesced, boxes, nBoxes)) {
+        RegionNull(pCoalesced);
+        pCoalesced = pRegion;
+    }
+    if (boxes != stackBoxes)
+        free(boxes);
+    return pCoalesced;
+}
+
+static Bool
+damageReportDeferred(ClientPtr pClient, void *closure)
+{
+    ScreenPtr pScreen = closure;
+    DamagePtr pDamage;
+
+    damageScrPriv(pScreen);
+
+    while ((pDamage = pScrPriv->pDeferredDamages)) {
+        pScrPriv->pDeferredDamages = pDamage->pNextDeferred;
+        pDamage->pNextDeferred = NULL;
+        pDamage->deferredPending = FALSE;
+        if (pDamage->damageReport && RegionNotEmpty(&pDamage->damage))
+            (*pDamage->damageReport) (pDamage, &pDamage->damage,
+                                      pDamage->closure);
+    }
+
+    /* Next deferred report will queue the worker again */
+    pScrPriv->deferredQueued = FALSE;
+    return TRUE;
+}
+
+static void
+damageQueueDeferredReport(DamagePtr pDamage)
+{
+    ScreenPtr pScreen = pDamage->pScreen;
+
+    damageScrPriv(pScreen);
+
+    if (pDamage->deferredPending)
+        return;
+    pDamage->deferredPending = TRUE;
+    pDamage->pNextDeferred = pScrPriv->pDeferredDamages;
+    pScrPriv->pDeferredDamages = pDamage;
+
+    if (!pScrPriv->deferredQueued) {
+        QueueWorkProc(damageReportDeferred, serverClient, pScreen);
+        pScrPriv->deferredQueued = TRUE;
+    }
+}
 
 #if DAMAGE_DEBUG_ENABLE
 static void
@@ -140,7 +223,9 @@ damageRegionAppend(DrawablePtr pDrawable, RegionPtr pRegion, Bool clip,
     drawableDamage(pDrawable);
     DamagePtr pNext;
     RegionRec clippedRec;
+    RegionRec coalescedRec;
     RegionPtr pDamageRegion;
+    RegionPtr pReportRegion;
     RegionRec pixClip;
     int draw_x, draw_y;
 
@@ -179,6 +264,7 @@ damageRegionAppend(DrawablePtr pDrawable, RegionPtr pRegion, Bool clip,
     }
 
     RegionNull(&clippedRec);
+    RegionNull(&coalescedRec);
     for (; pDamage; pDamage = pNext) {
         pNext = pDamage->pNext;
         /*
@@ -251,17 +337,21 @@ damageRegionAppend(DrawablePtr pDrawable, RegionPtr pRegion, Bool clip,
         if (draw_x || draw_y)
             RegionTranslate(pDamageRegion, -draw_x, -draw_y);
 
+        /* Round out to the damage's coalescing grid, if configured */
+        pReportRegion = damageCoalesceRegion(pDamage, pDamageRegion,
+                                             &coalescedRec);
+
         /* Store damage region if needed after submission. */
         if (pDamage->reportAfter)
             RegionUnion(&pDamage->pendingDamage,
-                        &pDamage->pendingDamage, pDamageRegion);
+                        &pDamage->pendingDamage, pReportRegion);
 
         /* Report damage now, if desired. */
         if (!pDamage->reportAfter) {
             if (pDamage->damageReport)
-                DamageReportDamage(pDamage, pDamageRegion);
+                DamageReportDamage(pDamage, pReportRegion);
             else
-                RegionUnion(&pDamage->damage, &pDamage->damage, pDamageRegion);
+                RegionUnion(&pDamage->damage, &pDamage->damage, pReportRegion);
         }
 
         /*
@@ -274,6 +364,7 @@ damageRegionAppend(DrawablePtr pDrawable, RegionPtr pRegion, Bool clip,
         RegionTranslate(pRegion, -screen_x, -screen_y);
 
     RegionUninit(&clippedRec);
+    RegionUninit(&coalescedRec);
 }
 
 static void
@@ -1567,6 +1658,104 @@ damageWindowDestroy(CallbackListPtr *pcbl, ScreenPtr pScreen, WindowPtr pWindow)
     }
 }
 
+/*
+ * -damageheatmap: count how often each screen tile is damaged, so
+ * over-rendering clients can be shown exactly which areas repaint at
+ * 60Hz for no reason.  The counters accumulate from every reported
+ * damage region; the SIGUSR2 statistics dump renders them as a scaled
+ * character grid and starts a fresh window.
+ */
+Bool DamageHeatmapActive;
+
+#define DAMAGE_HEATMAP_SHIFT    6       /* 64x64 pixel tiles */
+#define DAMAGE_HEATMAP_MAX_COLS 256     /* dump line clamp */
+
+static void
+damageHeatmapAccumulate(DrawablePtr pDrawable, RegionPtr pRegion)
+{
+    ScreenPtr pScreen = pDrawable->pScreen;
+    damageScrPriv(pScreen);
+    int cols = (pScreen->width >> DAMAGE_HEATMAP_SHIFT) + 1;
+    int rows = (pScreen->height >> DAMAGE_HEATMAP_SHIFT) + 1;
+    BoxPtr box = RegionRects(pRegion);
+    int nbox = RegionNumRects(pRegion);
+
+    if (!pScrPriv)
+        return;
+
+    /* first use, or the screen was resized: start a fresh grid */
+    if (pScrPriv->heatmap &&
+        (pScrPriv->heatmapWidth != cols || pScrPriv->heatmapHeight != rows)) {
+        free(pScrPriv->heatmap);
+        pScrPriv->heatmap = NULL;
+    }
+    if (!pScrPriv->heatmap) {
+        pScrPriv->heatmap = calloc((size_t) cols * rows, sizeof(uint32_t));
+        if (!pScrPriv->heatmap)
+            return;
+        pScrPriv->heatmapWidth = cols;
+        pScrPriv->heatmapHeight = rows;
+    }
+
+    /* regions arrive drawable-relative; move to screen tiles */
+    for (; nbox--; box++) {
+        int tx1 = (box->x1 + pDrawable->x) >> DAMAGE_HEATMAP_SHIFT;
+        int ty1 = (box->y1 + pDrawable->y) >> DAMAGE_HEATMAP_SHIFT;
+        int tx2 = (box->x2 - 1 + pDrawable->x) >> DAMAGE_HEATMAP_SHIFT;
+        int ty2 = (box->y2 - 1 + pDrawable->y) >> DAMAGE_HEATMAP_SHIFT;
+
+        tx1 = min(max(tx1, 0), cols - 1);
+        ty1 = min(max(ty1, 0), rows - 1);
+        tx2 = min(max(tx2, 0), cols - 1);
+        ty2 = min(max(ty2, 0), rows - 1);
+
+        for (int ty = ty1; ty <= ty2; ty++)
+            for (int tx = tx1; tx <= tx2; tx++)
+                pScrPriv->heatmap[(size_t) ty * cols + tx]++;
+    }
+}
+
+static void
+damageHeatmapDump(CallbackListPtr *pcbl, void *closure, void *calldata)
+{
+    ScreenPtr pScreen = closure;
+    damageScrPriv(pScreen);
+    char line[DAMAGE_HEATMAP_MAX_COLS + 1];
+    uint32_t maxCount = 0;
+    int cols, rows;
+
+    if (!pScrPriv || !pScrPriv->heatmap)
+        return;
+
+    cols = min(pScrPriv->heatmapWidth, DAMAGE_HEATMAP_MAX_COLS);
+    rows = pScrPriv->heatmapHeight;
+
+    for (int i = 0; i < pScrPriv->heatmapWidth * rows; i++)
+        if (pScrPriv->heatmap[i] > maxCount)
+            maxCount = pScrPriv->heatmap[i];
+    if (!maxCount)
+        return;
+
+    LogMessage(X_INFO,
+               "damage heatmap screen %d (%d px tiles, max %u hits):\n",
+               pScreen->myNum, 1 << DAMAGE_HEATMAP_SHIFT, maxCount);
+
+    for (int ty = 0; ty < rows; ty++) {
+        for (int tx = 0; tx < cols; tx++) {
+            uint32_t count =
+                pScrPriv->heatmap[(size_t) ty * pScrPriv->heatmapWidth + tx];
+
+            line[tx] = count ? '1' + (int) ((uint64_t) (count - 1) * 8 / maxCount)
+                             : '.';
+        }
+        line[cols] = '\0';
+        LogMessage(X_NONE, "  %s\n", line);
+    }
+
+    memset(pScrPriv->heatmap, 0,
+           (size_t) pScrPriv->heatmapWidth * rows * sizeof(uint32_t));
+}
+
 static void damageCloseScreen(CallbackListPtr *pcbl, ScreenPtr pScreen, void *unused)
 {
     dixScreenUnhookPostClose(pScreen, damageCloseScreen);
@@ -1580,7 +1769,11 @@ static void damageCloseScreen(CallbackListPtr *pcbl, ScreenPtr pScreen, void *un
     unwrap(pScrPriv, pScreen, CreateGC);
     unwrap(pScrPriv, pScreen, CopyWindow);
 
-    dixSetPrivate(&pScreen->devPrivates, damageScrPrivateKey, NULL);
+    if (DamageHeatmapActive)
+        DeleteCallback(&StatsDumpCallback, damageHeatmapDump, pScreen);
+    free(pScrPriv->heatmap);
+
+    dixSetFixedPrivate(&pScreen->devPrivates, FIXED_PRIVATE_DAMAGE, NULL);
     free(pScrPriv);
 }
 
@@ -1644,22 +1837,13 @@ DamageSetup(ScreenPtr pScreen)
         miDamageCreate, miDamageRegister, miDamageUnregister, miDamageDestroy
     };
 
-    if (!dixRegisterPrivateKey(&damageScrPrivateKeyRec, PRIVATE_SCREEN, 0))
-        return FALSE;
-
-    if (dixLookupPrivate(&pScreen->devPrivates, damageScrPrivateKey))
+    if (dixGetFixedPrivate(&pScreen->devPrivates, FIXED_PRIVATE_DAMAGE))
         return TRUE;
 
     if (!dixRegisterPrivateKey
         (&damageGCPrivateKeyRec, PRIVATE_GC, sizeof(DamageGCPrivRec)))
         return FALSE;
 
-    if (!dixRegisterPrivateKey(&damagePixPrivateKeyRec, PRIVATE_PIXMAP, 0))
-        return FALSE;
-
-    if (!dixRegisterPrivateKey(&damageWinPrivateKeyRec, PRIVATE_WINDOW, 0))
-        return FALSE;
-
     DamageScrPrivPtr pScrPriv = calloc(1, sizeof(DamageScrPrivRec));
     if (!pScrPriv)
         return FALSE;
@@ -1671,6 +1855,9 @@ DamageSetup(ScreenPtr pScreen)
     dixScreenHookWindowDestroy(pScreen, damageWindowDestroy);
     dixScreenHookPixmapDestroy(pScreen, damagePixmapDestroy);
 
+    if (DamageHeatmapActive)
+        AddCallback(&StatsDumpCallback, damageHeatmapDump, pScreen);
+
     wrap(pScrPriv, pScreen, CreateGC, damageCreateGC);
     wrap(pScrPriv, pScreen, SetWindowPixmap, damageSetWindowPixmap);
     wrap(pScrPriv, pScreen, CopyWindow, damageCopyWindow);
@@ -1682,7 +1869,7 @@ DamageSetup(ScreenPtr pScreen)
 
     pScrPriv->funcs = miFuncs;
 
-    dixSetPrivate(&pScreen->devPrivates, damageScrPrivateKey, pScrPriv);
+    dixSetFixedPrivate(&pScreen->devPrivates, FIXED_PRIVATE_DAMAGE, pScrPriv);
     return TRUE;
 }
 
@@ -1821,6 +2008,15 @@ DamageDestroy(DamagePtr pDamage)
     if (pDamage->damageDestroy)
         (*pDamage->damageDestroy) (pDamage, pDamage->closure);
 
+    if (pDamage->deferredPending) {
+        DamagePtr *pPrev = &pScrPriv->pDeferredDamages;
+
+        while (*pPrev && *pPrev != pDamage)
+            pPrev = &(*pPrev)->pNextDeferred;
+        if (*pPrev)
+            *pPrev = pDamage->pNextDeferred;
+    }
+
     if (pScrPriv->funcs.Destroy)
         pScrPriv->funcs.Destroy (pDamage);
 
@@ -1908,6 +2104,18 @@ DamageSetReportAfterOp(DamagePtr pDamage, Bool reportAfter)
     pDamage->reportAfter = reportAfter;
 }
 
+void
+DamageSetCoalesceTile(DamagePtr pDamage, int tileSize)
+{
+    pDamage->coalesceTile = tileSize;
+}
+
+void
+DamageSetDeferredReport(DamagePtr pDamage, Bool deferred)
+{
+    pDamage->deferredReport = deferred;
+}
+
 DamageScreenFuncsPtr
 DamageGetScreenFuncs(ScreenPtr pScreen)
 {
@@ -1922,6 +2130,28 @@ DamageReportDamage(DamagePtr pDamage, RegionPtr pDamageRegion)
     RegionRec tmpRegion;
     Bool was_empty;
 
+#ifdef XSERVER_DTRACE
+    if (XSERVER_DAMAGE_REPORT_ENABLED())
+        XSERVER_DAMAGE_REPORT(pDamage->pDrawable ? pDamage->pDrawable->id : 0,
+                              RegionNumRects(pDamageRegion),
+                              pDamage->damageLevel);
+#endif
+
+    if (DamageHeatmapActive && pDamage->pDrawable &&
+        pDamage->pDrawable->type == DRAWABLE_WINDOW)
+        damageHeatmapAccumulate(pDamage->pDrawable, pDamageRegion);
+
+    /*
+     * Deferred damages accumulate silently and report the whole
+     * region once per dispatch cycle from a queued work proc; the
+     * report level's immediate-notification semantics don't apply.
+     */
+    if (pDamage->deferredReport) {
+        RegionUnion(&pDamage->damage, &pDamage->damage, pDamageRegion);
+        damageQueueDeferredReport(pDamage);
+        return;
+    }
+
     switch (pDamage->damageLevel) {
     case DamageReportRawRegion:
         RegionUnion(&pDamage->damage, &pDamage->damage, pDamageRegion);
@@ -125,6 +125,20 @@ extern _X_EXPORT void
 extern _X_EXPORT void
  DamageSetReportAfterOp(DamagePtr pDamage, Bool reportAfter);
 
+/* Round accumulated and reported damage out to a tileSize-aligned grid
+ * (tileSize must be a power of two; 0 disables coalescing).  Coarser
+ * damage merges better and keeps region arithmetic cheap for consumers
+ * that repaint whole tiles anyway, such as shadow framebuffers. */
+extern _X_EXPORT void
+ DamageSetCoalesceTile(DamagePtr pDamage, int tileSize);
+
+/* Batch report callbacks at dispatch-cycle boundaries: damage
+ * accumulates silently and the report function is called once with the
+ * whole region from a queued work proc.  The report level's
+ * immediate-notification semantics don't apply while this is set. */
+extern _X_EXPORT void
+ DamageSetDeferredReport(DamagePtr pDamage, Bool deferred);
+
 extern _X_EXPORT DamageScreenFuncsPtr DamageGetScreenFuncs(ScreenPtr);
 
 #endif                          /* _DAMAGE_H_ */
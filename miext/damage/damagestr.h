@@ -49,6 +49,11 @@ typedef struct _damage {
     Bool reportAfter;
     RegionRec pendingDamage;    /* will be flushed post submission at the latest */
     ScreenPtr pScreen;
+
+    int coalesceTile;           /* round damage out to this grid; 0 = off */
+    Bool deferredReport;        /* batch reports at dispatch-cycle boundaries */
+    Bool deferredPending;       /* on the screen's deferred-report list */
+    DamagePtr pNextDeferred;
 } DamageRec;
 
 typedef struct _damageScrPriv {
@@ -72,8 +77,21 @@ typedef struct _damageScrPriv {
 
     /* Table of wrappable function pointers */
     DamageScreenFuncsRec funcs;
+
+    /* Damages with batched reports waiting for the next dispatch cycle */
+    DamagePtr pDeferredDamages;
+    Bool deferredQueued;
+
+    /* -damageheatmap: per-tile damage frequency counters */
+    uint32_t *heatmap;
+    int heatmapWidth;
+    int heatmapHeight;
 } DamageScrPrivRec, *DamageScrPrivPtr;
 
+/* TRUE with -damageheatmap: accumulate per-tile damage frequency per
+   screen and dump it from the SIGUSR2 statistics dump */
+extern Bool DamageHeatmapActive;
+
 typedef struct _damageGCPriv {
     const GCOps *ops;
     const GCFuncs *funcs;
@@ -81,16 +99,16 @@ typedef struct _damageGCPriv {
 
 /* XXX should move these into damage.c, damageScrPrivateIndex is static */
 #define damageGetScrPriv(pScr) ((DamageScrPrivPtr) \
-    dixLookupPrivate(&(pScr)->devPrivates, damageScrPrivateKey))
+    dixGetFixedPrivate(&(pScr)->devPrivates, FIXED_PRIVATE_DAMAGE))
 
 #define damageScrPriv(pScr) \
     DamageScrPrivPtr    pScrPriv = damageGetScrPriv(pScr)
 
 #define damageGetPixPriv(pPix) \
-    dixLookupPrivate(&(pPix)->devPrivates, damagePixPrivateKey)
+    dixGetFixedPrivate(&(pPix)->devPrivates, FIXED_PRIVATE_DAMAGE)
 
 #define damgeSetPixPriv(pPix,v) \
-    dixSetPrivate(&(pPix)->devPrivates, damagePixPrivateKey, v)
+    dixSetFixedPrivate(&(pPix)->devPrivates, FIXED_PRIVATE_DAMAGE, v)
 
 #define damagePixPriv(pPix) \
     DamagePtr	    pDamage = damageGetPixPriv(pPix)
@@ -102,9 +120,9 @@ typedef struct _damageGCPriv {
     DamageGCPrivPtr  pGCPriv = damageGetGCPriv(pGC)
 
 #define damageGetWinPriv(pWin) \
-    ((DamagePtr)dixLookupPrivate(&(pWin)->devPrivates, damageWinPrivateKey))
+    ((DamagePtr)dixGetFixedPrivate(&(pWin)->devPrivates, FIXED_PRIVATE_DAMAGE))
 
 #define damageSetWinPriv(pWin,d) \
-    dixSetPrivate(&(pWin)->devPrivates, damageWinPrivateKey, d)
+    dixSetFixedPrivate(&(pWin)->devPrivates, FIXED_PRIVATE_DAMAGE, d)
 
 #endif                          /* _DAMAGESTR_H_ */
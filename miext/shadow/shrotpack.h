@@ -176,6 +176,15 @@ FUNC(ScreenPtr pScreen, shadowBufPtr pBuf)
                     ("   |   |   |-> Writing Line - Metrics: win=%x, sha=%x\n",
                      win, sha);
 #endif
+#if !defined(ROTATE) || ROTATE == 0
+                /*
+                 * Source pixels are contiguous when not rotating; one
+                 * memcpy beats the per-pixel loop and lets the
+                 * compiler/libc use wide vector copies.
+                 */
+                memcpy(win, sha, i * sizeof(Data));
+                sha += i;
+#else
                 while (i--) {
 #if(DANDEBUG > 6)
                     ErrorF
@@ -185,6 +194,7 @@ FUNC(ScreenPtr pScreen, shadowBufPtr pBuf)
                     *win++ = *sha;
                     sha += SHASTEPX(shaStride);
                 }               /*  i */
+#endif
             }                   /*  width */
             shaLine += SHASTEPY(shaStride);
             NEXTY(x, y, w, h);
@@ -56,6 +56,10 @@ SOFTWARE.
 
 #include <errno.h>
 #include <stdio.h>
+#ifdef HAVE_TIMERFD_CREATE
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
 #ifdef WIN32
 #include <X11/Xwinsock.h>
 #endif
@@ -63,6 +67,7 @@ SOFTWARE.
 #include <X11/X.h>
 
 #include "dix/dix_priv.h"
+#include "dix/input_priv.h"
 #include "dix/screensaver_priv.h"
 #include "os/busfault.h"
 #include "os/client_priv.h"
@@ -99,7 +104,8 @@ SOFTWARE.
 #endif
 
 struct _OsTimerRec {
-    struct xorg_list list;
+    int heapPos;                /* index into timerHeap, -1 when not pending */
+    CARD32 seq;                 /* insertion order, breaks expiry ties */
     CARD32 expires;
     CARD32 delta;
     OsTimerCallback callback;
@@ -108,17 +114,213 @@ struct _OsTimerRec {
 
 static void DoTimer(OsTimerPtr timer, CARD32 now);
 static void CheckAllTimers(void);
-static volatile struct xorg_list timers;
+
+/* Why the server woke from ospoll_wait.  A wake counts in every class
+ * that has work pending when it returns, so the columns can sum to
+ * more than the total; an idle server waking 300 times a second shows
+ * up here without strace. */
+static struct {
+    uint64_t total;             /* blocking waits that returned */
+    uint64_t timer;             /* a timer expired */
+    uint64_t client;            /* client request data ready */
+    uint64_t input;             /* input events pending */
+    uint64_t notify_fd;         /* some other notify fd (device, DRM, ...) */
+    uint64_t error;             /* poll error, mostly EINTR */
+} wakeupStats;
+
+/* set by timer expiry callbacks running inside the wait */
+static Bool wakeupTimerFired;
+
+void
+WakeupStatsDump(void)
+{
+    LogMessage(X_INFO,
+               "wakeups: %lu total (timer %lu, client %lu, input %lu, "
+               "other-fd %lu, error %lu)\n",
+               (unsigned long) wakeupStats.total,
+               (unsigned long) wakeupStats.timer,
+               (unsigned long) wakeupStats.client,
+               (unsigned long) wakeupStats.input,
+               (unsigned long) wakeupStats.notify_fd,
+               (unsigned long) wakeupStats.error);
+    memset(&wakeupStats, 0, sizeof(wakeupStats));
+}
+
+/* Pending timers live in a binary min-heap keyed on expiry time, so
+ * TimerSet is O(log n) instead of an O(n) sorted-list insert.  The heap
+ * is mutated only under input_lock(); timerHeapUsed is volatile so the
+ * unlocked peek in check_timers always reloads it. */
+static OsTimerPtr *timerHeap;
+static volatile int timerHeapUsed;
+static int timerHeapSize;
+static CARD32 timerSeq;
+
+static inline Bool
+timer_before(OsTimerPtr a, OsTimerPtr b)
+{
+    if (a->expires != b->expires)
+        return (int) (a->expires - b->expires) < 0;
+    return (int) (a->seq - b->seq) < 0;
+}
+
+static void
+timer_heap_up(int pos)
+{
+    OsTimerPtr timer = timerHeap[pos];
+
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+
+        if (!timer_before(timer, timerHeap[parent]))
+            break;
+        timerHeap[pos] = timerHeap[parent];
+        timerHeap[pos]->heapPos = pos;
+        pos = parent;
+    }
+    timerHeap[pos] = timer;
+    timer->heapPos = pos;
+}
+
+static void
+timer_heap_down(int pos)
+{
+    OsTimerPtr timer = timerHeap[pos];
+
+    for (;;) {
+        int child = 2 * pos + 1;
+
+        if (child >= timerHeapUsed)
+            break;
+        if (child + 1 < timerHeapUsed &&
+            timer_before(timerHeap[child + 1], timerHeap[child]))
+            child++;
+        if (!timer_before(timerHeap[child], timer))
+            break;
+        timerHeap[pos] = timerHeap[child];
+        timerHeap[pos]->heapPos = pos;
+        pos = child;
+    }
+    timerHeap[pos] = timer;
+    timer->heapPos = pos;
+}
+
+static void
+timer_heap_insert(OsTimerPtr timer)
+{
+    if (timerHeapUsed == timerHeapSize) {
+        timerHeapSize = timerHeapSize ? 2 * timerHeapSize : 16;
+        timerHeap = XNFreallocarray(timerHeap, timerHeapSize,
+                                    sizeof(OsTimerPtr));
+    }
+    timer->seq = timerSeq++;
+    timerHeap[timerHeapUsed] = timer;
+    timer->heapPos = timerHeapUsed++;
+    timer_heap_up(timer->heapPos);
+}
+
+static void
+timer_heap_remove(OsTimerPtr timer)
+{
+    int pos = timer->heapPos;
+    OsTimerPtr last = timerHeap[--timerHeapUsed];
+
+    timer->heapPos = -1;
+    if (last == timer)
+        return;
+    timerHeap[pos] = last;
+    last->heapPos = pos;
+    timer_heap_up(pos);
+    timer_heap_down(last->heapPos);
+}
 
 static inline OsTimerPtr
 first_timer(void)
 {
-    /* inline xorg_list_is_empty which can't handle volatile */
-    if (timers.next == &timers)
-        return NULL;
-    return xorg_list_first_entry(&timers, struct _OsTimerRec, list);
+    return timerHeapUsed ? timerHeap[0] : NULL;
+}
+
+#ifdef HAVE_TIMERFD_CREATE
+
+/*
+ * Tickless timer expiry: instead of recomputing the poll timeout from
+ * the earliest deadline on every WaitForSomething iteration, program a
+ * timerfd whenever the earliest deadline actually changes and let ospoll
+ * deliver the expiry like any other fd.  The wakeup path then does no
+ * deadline arithmetic at all; re-arming happens at the TimerSet /
+ * TimerCancel mutation points, which also picks up timers armed from
+ * the input thread while the main thread is blocked in ospoll_wait.
+ * If the fd cannot be set up, the poll-timeout path below keeps working.
+ */
+static int timerFd = -1;
+static Bool timerFdTried;
+static Bool timerFdArmed;
+static CARD32 timerFdExpires;   /* deadline currently programmed */
+
+/* Program the timerfd to the earliest pending deadline, if it moved. */
+static void
+timer_fd_rearm(void)
+{
+    OsTimerPtr timer = first_timer();
+    struct itimerspec it = { 0 };
+
+    if (timerFd < 0)
+        return;
+    if (timer) {
+        int timeout;
+
+        if (timerFdArmed && timer->expires == timerFdExpires)
+            return;
+        timeout = timer->expires - GetTimeInMillis();
+        if (timeout <= 0)
+            timeout = 1;        /* overdue, expire immediately */
+        it.it_value.tv_sec = timeout / 1000;
+        it.it_value.tv_nsec = (timeout % 1000) * 1000000L;
+        timerFdArmed = TRUE;
+        timerFdExpires = timer->expires;
+    }
+    else {
+        if (!timerFdArmed)
+            return;
+        timerFdArmed = FALSE;
+    }
+    timerfd_settime(timerFd, 0, &it, NULL);
+}
+
+static void
+TimerFdNotify(int fd, int ready, void *data)
+{
+    CARD64 expirations;
+
+    if (read(fd, &expirations, sizeof(expirations)) < 0 && errno == EAGAIN)
+        return;
+    timerFdArmed = FALSE;
+    wakeupTimerFired = TRUE;
+    DoTimers(GetTimeInMillis());
+}
+
+static void
+timer_fd_init(void)
+{
+    timerFdTried = TRUE;
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0)
+        return;
+    if (!SetNotifyFd(timerFd, TimerFdNotify, X_NOTIFY_READ, NULL)) {
+        close(timerFd);
+        timerFd = -1;
+        return;
+    }
+    input_lock();
+    timer_fd_rearm();
+    input_unlock();
 }
 
+#else
+
+#define timer_fd_rearm()        /* poll timeout carries the deadline */
+
+#endif /* HAVE_TIMERFD_CREATE */
+
 /*
  * Compute timeout until next timer, running
  * any expired timers
@@ -128,6 +330,13 @@ check_timers(void)
 {
     OsTimerPtr timer;
 
+#ifdef HAVE_TIMERFD_CREATE
+    if (!timerFdTried)
+        timer_fd_init();
+    if (timerFd >= 0)
+        return -1;              /* expiry arrives via the timerfd */
+#endif
+
     if ((timer = first_timer()) != NULL) {
         CARD32 now = GetTimeInMillis();
         int timeout = timer->expires - now;
@@ -171,17 +380,6 @@ WaitForSomething(Bool are_ready)
     int i;
     int timeout;
     int pollerr;
-    static Bool were_ready;
-    Bool timer_is_running;
-
-    timer_is_running = were_ready;
-
-    if (were_ready && !are_ready) {
-        timer_is_running = FALSE;
-        SmartScheduleStopTimer();
-    }
-
-    were_ready = FALSE;
 
     busfault_check();
 
@@ -203,8 +401,47 @@ WaitForSomething(Bool are_ready)
         /* keep this check close to select() call to minimize race */
         if (dispatchException)
             i = -1;
-        else
-            i = ospoll_wait(server_poll, timeout);
+        else {
+            /* The input thread only writes its wake-up pipe while we are
+             * flagged as sleeping, so re-check for events enqueued just
+             * before the flag became visible rather than blocking. */
+            InputThreadPrepareSleep();
+            if (InputCheckPending())
+                i = 0;
+            else {
+                wakeupTimerFired = FALSE;
+                i = ospoll_wait(server_poll, timeout);
+                /* classify why we woke; zero-timeout polls are not
+                 * sleeps and are left out */
+                if (timeout != 0) {
+                    Bool classified = wakeupTimerFired;
+
+                    wakeupStats.total++;
+                    if (wakeupTimerFired)
+                        wakeupStats.timer++;
+                    if (i < 0) {
+                        wakeupStats.error++;
+                    }
+                    else if (i > 0) {
+                        if (clients_are_ready()) {
+                            wakeupStats.client++;
+                            classified = TRUE;
+                        }
+                        if (InputCheckPending()) {
+                            wakeupStats.input++;
+                            classified = TRUE;
+                        }
+                        if (!classified)
+                            wakeupStats.notify_fd++;
+                    }
+                    else if (!wakeupTimerFired) {
+                        /* poll timeout carried the earliest deadline */
+                        wakeupStats.timer++;
+                    }
+                }
+            }
+            InputThreadFinishSleep();
+        }
         pollerr = GetErrno();
         WakeupHandler(i);
         if (i <= 0) {           /* An error or timeout occurred */
@@ -222,12 +459,8 @@ WaitForSomething(Bool are_ready)
         if (InputCheckPending())
             return FALSE;
 
-        if (are_ready) {
-            were_ready = TRUE;
-            if (!timer_is_running)
-                SmartScheduleStartTimer();
+        if (are_ready)
             return TRUE;
-        }
     }
 }
 
@@ -242,27 +475,30 @@ AdjustWaitForDelay(void *waitTime, int newdelay)
 }
 
 static inline Bool timer_pending(OsTimerPtr timer) {
-    return !xorg_list_is_empty(&timer->list);
+    return timer->heapPos >= 0;
 }
 
 /* If time has rewound, re-run every affected timer.
- * Timers might drop out of the list, so we have to restart every time. */
+ * Timers might drop out of the heap, so we have to restart every time. */
 static void
 CheckAllTimers(void)
 {
-    OsTimerPtr timer;
     CARD32 now;
+    int i;
 
     input_lock();
  start:
     now = GetTimeInMillis();
 
-    xorg_list_for_each_entry(timer, &timers, list) {
+    for (i = 0; i < timerHeapUsed; i++) {
+        OsTimerPtr timer = timerHeap[i];
+
         if (timer->expires - now > timer->delta + 250) {
             DoTimer(timer, now);
             goto start;
         }
     }
+    timer_fd_rearm();
     input_unlock();
 }
 
@@ -271,7 +507,7 @@ DoTimer(OsTimerPtr timer, CARD32 now)
 {
     CARD32 newTime;
 
-    xorg_list_del(&timer->list);
+    timer_heap_remove(timer);
     newTime = (*timer->callback) (timer, now, timer->arg);
     if (newTime)
         TimerSet(timer, 0, newTime, timer->callback, timer->arg);
@@ -287,6 +523,7 @@ void DoTimers(CARD32 now)
             break;
         DoTimer(timer, now);
     }
+    timer_fd_rearm();
     input_unlock();
 }
 
@@ -294,21 +531,21 @@ OsTimerPtr
 TimerSet(OsTimerPtr timer, int flags, CARD32 millis,
          OsTimerCallback func, void *arg)
 {
-    OsTimerPtr existing;
     CARD32 now = GetTimeInMillis();
 
     if (!timer) {
         timer = calloc(1, sizeof(struct _OsTimerRec));
         if (!timer)
             return NULL;
-        xorg_list_init(&timer->list);
+        timer->heapPos = -1;
     }
     else {
         input_lock();
         if (timer_pending(timer)) {
-            xorg_list_del(&timer->list);
+            timer_heap_remove(timer);
             if (flags & TimerForceOld)
                 (void) (*timer->callback) (timer, now, timer->arg);
+            timer_fd_rearm();
         }
         input_unlock();
     }
@@ -326,17 +563,13 @@ TimerSet(OsTimerPtr timer, int flags, CARD32 millis,
     timer->arg = arg;
     input_lock();
 
-    /* Sort into list */
-    xorg_list_for_each_entry(existing, &timers, list)
-        if ((int) (existing->expires - millis) > 0)
-            break;
-    /* This even works at the end of the list -- existing->list will be timers */
-    xorg_list_append(&timer->list, &existing->list);
+    timer_heap_insert(timer);
 
     /* Check to see if the timer is ready to run now */
     if ((int) (millis - now) <= 0)
         DoTimer(timer, now);
 
+    timer_fd_rearm();
     input_unlock();
     return timer;
 }
@@ -348,8 +581,10 @@ TimerForce(OsTimerPtr timer)
 
     input_lock();
     pending = timer_pending(timer);
-    if (pending)
+    if (pending) {
         DoTimer(timer, GetTimeInMillis());
+        timer_fd_rearm();
+    }
     input_unlock();
     return pending;
 }
@@ -360,7 +595,10 @@ TimerCancel(OsTimerPtr timer)
     if (!timer)
         return;
     input_lock();
-    xorg_list_del(&timer->list);
+    if (timer_pending(timer)) {
+        timer_heap_remove(timer);
+        timer_fd_rearm();
+    }
     input_unlock();
 }
 
@@ -376,18 +614,13 @@ TimerFree(OsTimerPtr timer)
 void
 TimerInit(void)
 {
-    static Bool been_here;
-    OsTimerPtr timer, tmp;
-
-    if (!been_here) {
-        been_here = TRUE;
-        xorg_list_init((struct xorg_list*) &timers);
-    }
+    while (timerHeapUsed) {
+        OsTimerPtr timer = timerHeap[0];
 
-    xorg_list_for_each_entry_safe(timer, tmp, &timers, list) {
-        xorg_list_del(&timer->list);
+        timer_heap_remove(timer);
         free(timer);
     }
+    timer_fd_rearm();
 }
 
 #ifdef DPMSExtension
@@ -51,6 +51,9 @@ from The Open Group.
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
+#ifndef WIN32
+#include <sys/uio.h>
+#endif
 #ifdef HAVE_SYSTEMD_DAEMON
 #include <systemd/sd-daemon.h>
 #endif
@@ -685,6 +688,28 @@ ssize_t _XSERVTransWrite (XtransConnInfo ciptr, const char *buf, size_t size)
     return ciptr->transptr->Write (ciptr, buf, size);
 }
 
+ssize_t _XSERVTransWritev (XtransConnInfo ciptr, const struct iovec *iov, int iovcnt)
+{
+#ifndef WIN32
+    return writev (ciptr->fd, iov, iovcnt);
+#else
+    /* no scatter-gather write available, send the segments one by one */
+    ssize_t total = 0;
+    int i;
+
+    for (i = 0; i < iovcnt; i++) {
+	ssize_t len = ciptr->transptr->Write (ciptr, iov[i].iov_base,
+					      iov[i].iov_len);
+	if (len < 0)
+	    return total ? total : len;
+	total += len;
+	if ((size_t) len < iov[i].iov_len)
+	    break;
+    }
+    return total;
+#endif
+}
+
 #if XTRANS_SEND_FDS
 int _XSERVTransSendFd (XtransConnInfo ciptr, int fd, int do_close)
 {
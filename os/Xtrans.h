@@ -197,6 +197,21 @@ ssize_t _XSERVTransWrite (
     size_t		/* size */
 );
 
+#ifdef WIN32
+struct iovec {
+    void *iov_base;
+    size_t iov_len;
+};
+#else
+struct iovec;
+#endif
+
+ssize_t _XSERVTransWritev (
+    XtransConnInfo,	/* ciptr */
+    const struct iovec *, /* iov */
+    int			/* iovcnt */
+);
+
 int _XSERVTransSendFd (XtransConnInfo ciptr, int fd, int do_close);
 
 int _XSERVTransRecvFd (XtransConnInfo ciptr);
@@ -1006,6 +1006,22 @@ static int _XSERVTransSocketUNIXResetListener (XtransConnInfo ciptr)
 #endif /* UNIXCONN */
 
 
+/*
+ * Accept with close-on-exec and non-blocking set atomically where the
+ * platform allows.  Handing out non-blocking connections up front lets
+ * the server drain a whole listen backlog from a single readable
+ * notification instead of one accept per main-loop wakeup.
+ */
+static int _XSERVTransSocketAccept (int fd, struct sockaddr *addr,
+			     SOCKLEN_T *addrlen)
+{
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+    return accept4 (fd, addr, (void *) addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+    return accept (fd, addr, (void *) addrlen);
+#endif
+}
+
 static XtransConnInfo _XSERVTransSocketINETAccept (
     XtransConnInfo ciptr)
 {
@@ -1021,8 +1037,8 @@ static XtransConnInfo _XSERVTransSocketINETAccept (
 	return NULL;
     }
 
-    if ((newciptr->fd = accept (ciptr->fd,
-	(struct sockaddr *) &sockname, (void *)&namelen)) < 0)
+    if ((newciptr->fd = _XSERVTransSocketAccept (ciptr->fd,
+	(struct sockaddr *) &sockname, &namelen)) < 0)
     {
 #ifdef WIN32
 	errno = WSAGetLastError();
@@ -1087,8 +1103,8 @@ static XtransConnInfo _XSERVTransSocketUNIXAccept (
 	return NULL;
     }
 
-    if ((newciptr->fd = accept (ciptr->fd,
-	(struct sockaddr *) &sockname, (void *)&namelen)) < 0)
+    if ((newciptr->fd = _XSERVTransSocketAccept (ciptr->fd,
+	(struct sockaddr *) &sockname, &namelen)) < 0)
     {
 	prmsg (1, "SocketUNIXAccept: accept() failed\n");
 	free (newciptr);
@@ -217,17 +217,78 @@ typedef struct _host {
     short len;
     unsigned char *addr;
     struct _host *next;
+    struct _host *hashNext;     /* chain within hostHashTable bucket */
     int requested;
 } HOST;
 
+static Bool hostIndexDirty = TRUE;
+
 #define MakeHost(h,l)	(h)=calloc(1, sizeof *(h)+(l));\
 			if (h) { \
 			   (h)->addr=(unsigned char *) ((h) + 1);\
 			   (h)->requested = FALSE; \
+			   hostIndexDirty = TRUE; \
 			}
 #define FreeHost(h)	free(h)
 static HOST *selfhosts = NULL;
 static HOST *validhosts = NULL;
+
+/*
+ * Exact-match index over validhosts so connection storms don't scan the
+ * whole access list per accept.  FamilyServerInterpreted entries can't
+ * be matched by hashing and are only counted; whether any of our own
+ * addresses appears in the access list (which implicitly admits local
+ * connections) is folded into a flag.  Rebuilt lazily after any change
+ * to either host list.
+ */
+#define HOST_HASH_SIZE 256
+static HOST *hostHashTable[HOST_HASH_SIZE];
+static int siHostCount;
+static Bool anySelfValid;
+
+static unsigned
+hostHash(int family, const unsigned char *addr, int len)
+{
+    unsigned h = (unsigned) family;
+
+    for (int i = 0; i < len; i++)
+        h = h * 31 + addr[i];
+    return h & (HOST_HASH_SIZE - 1);
+}
+
+static void
+UpdateHostIndex(void)
+{
+    HOST *host, *self;
+
+    memset(hostHashTable, 0, sizeof(hostHashTable));
+    siHostCount = 0;
+    anySelfValid = FALSE;
+
+    for (host = validhosts; host; host = host->next) {
+        if (host->family == FamilyServerInterpreted) {
+            siHostCount++;
+        }
+        else {
+            unsigned bucket = hostHash(host->family, host->addr, host->len);
+
+            host->hashNext = hostHashTable[bucket];
+            hostHashTable[bucket] = host;
+        }
+    }
+
+    for (self = selfhosts; self && !anySelfValid; self = self->next) {
+        for (host = validhosts; host; host = host->next) {
+            if (addrEqual(self->family, self->addr, self->len, host)) {
+                anySelfValid = TRUE;
+                break;
+            }
+        }
+    }
+
+    hostIndexDirty = FALSE;
+}
+
 static int AccessEnabled = TRUE;
 static int LocalHostEnabled = FALSE;
 static int LocalHostRequested = FALSE;
@@ -905,6 +966,7 @@ ResetHosts(const char *display)
         validhosts = host->next;
         FreeHost(host);
     }
+    hostIndexDirty = TRUE;
 
 #if defined WIN32 && defined __MINGW32__
 #define ETC_HOST_PREFIX "X"
@@ -1088,14 +1150,12 @@ ComputeLocalClient(ClientPtr client)
 }
 
 /*
- * Return the uid and all gids of a connected local client
- * Allocates a LocalClientCredRec - caller must call FreeLocalClientCreds
- *
- * Used by localuser & localgroup ServerInterpreted access control forms below
- * Used by AuthAudit to log who local connections came from
+ * Query the OS for the uid and all gids of a connected local client.
+ * Called once per connection via GetLocalClientCreds below, which caches
+ * the result on the OsComm.
  */
-int
-GetLocalClientCreds(ClientPtr client, LocalClientCredRec ** lccp)
+static int
+DetermineLocalClientCreds(ClientPtr client, LocalClientCredRec ** lccp)
 {
 #if defined(HAVE_GETPEEREID) || defined(HAVE_GETPEERUCRED) || defined(SO_PEERCRED) || defined(LOCAL_PEERCRED)
     int fd;
@@ -1228,6 +1288,54 @@ GetLocalClientCreds(ClientPtr client, LocalClientCredRec ** lccp)
 #endif
 }
 
+/*
+ * Return the uid and all gids of a connected local client
+ * Allocates a LocalClientCredRec - caller must call FreeLocalClientCreds
+ *
+ * Used by localuser & localgroup ServerInterpreted access control forms below
+ * Used by AuthAudit to log who local connections came from
+ *
+ * Peer credentials cannot change over the lifetime of a socket (the
+ * kernel snapshots them when the connection is established), so they are
+ * resolved once per connection and callers get copies of the cached
+ * record; repeated XRes queries and per-request ServerInterpreted host
+ * checks no longer pay a kernel round trip each time.
+ */
+int
+GetLocalClientCreds(ClientPtr client, LocalClientCredRec ** lccp)
+{
+    OsCommPtr oc;
+    LocalClientCredRec *lcc;
+
+    if (client == NULL || client->osPrivate == NULL)
+        return -1;
+    oc = (OsCommPtr) client->osPrivate;
+
+    if (!oc->peerCredsTried) {
+        oc->peerCredsTried = TRUE;
+        if (DetermineLocalClientCreds(client, &oc->peerCreds) == -1)
+            oc->peerCreds = NULL;
+    }
+    if (!oc->peerCreds)
+        return -1;
+
+    *lccp = calloc(1, sizeof(LocalClientCredRec));
+    if (*lccp == NULL)
+        return -1;
+    lcc = *lccp;
+
+    *lcc = *oc->peerCreds;
+    if (lcc->nSuppGids > 0) {
+        lcc->pSuppGids = calloc(lcc->nSuppGids, sizeof(int));
+        if (lcc->pSuppGids == NULL)
+            lcc->nSuppGids = 0;
+        else
+            memcpy(lcc->pSuppGids, oc->peerCreds->pSuppGids,
+                   lcc->nSuppGids * sizeof(int));
+    }
+    return 0;
+}
+
 void
 FreeLocalClientCreds(LocalClientCredRec * lcc)
 {
@@ -1380,6 +1488,7 @@ RemoveHost(ClientPtr client, int family, unsigned length,       /* of bytes in p
     if (host) {
         *prev = host->next;
         FreeHost(host);
+        hostIndexDirty = TRUE;
     }
     return Success;
 }
@@ -1466,41 +1575,34 @@ InvalidHost(register struct sockaddr *saddr, int len, ClientPtr client)
 {
     int family;
     void *addr = NULL;
-    register HOST *selfhost, *host;
+    register HOST *host;
 
     if (!AccessEnabled)         /* just let them in */
         return 0;
     family = ConvertAddr(saddr, &len, (void **) &addr);
     if (family == -1)
         return 1;
+    if (hostIndexDirty)
+        UpdateHostIndex();
     if (family == FamilyLocal) {
-        if (!LocalHostEnabled) {
-            /*
-             * check to see if any local address is enabled.  This
-             * implicitly enables local connections.
-             */
-            for (selfhost = selfhosts; selfhost; selfhost = selfhost->next) {
-                for (host = validhosts; host; host = host->next) {
-                    if (addrEqual(selfhost->family, selfhost->addr,
-                                  selfhost->len, host))
-                        return 0;
-                }
-            }
-        }
-        else
+        /* any of our own addresses in the access list implicitly
+         * enables local connections */
+        if (LocalHostEnabled || anySelfValid)
             return 0;
     }
-    for (host = validhosts; host; host = host->next) {
-        if (host->family == FamilyServerInterpreted) {
-            if (siAddrMatch(family, addr, len, host, client)) {
+    if (addr) {
+        for (host = hostHashTable[hostHash(family, addr, len)]; host;
+             host = host->hashNext) {
+            if (addrEqual(family, addr, len, host))
                 return 0;
-            }
         }
-        else {
-            if (addr && addrEqual(family, addr, len, host))
+    }
+    if (siHostCount) {
+        for (host = validhosts; host; host = host->next) {
+            if (host->family == FamilyServerInterpreted &&
+                siAddrMatch(family, addr, len, host, client))
                 return 0;
         }
-
     }
     return 1;
 }
@@ -63,6 +63,7 @@ struct protocol {
     AuthFromIDFunc FromID;      /* convert ID to cookie */
     AuthRemCFunc Remove;        /* remove a specific cookie */
     AuthGenCFunc Generate;
+    Bool CacheCheck;            /* Check verdict depends only on (name, data) */
 };
 
 static struct protocol protocols[] = {
@@ -73,7 +74,8 @@ static struct protocol protocols[] = {
         .Reset = MitResetCookie,
         .FromID = MitFromID,
         .Remove = MitRemoveCookie,
-        .Generate = MitGenerateCookie
+        .Generate = MitGenerateCookie,
+        .CacheCheck = TRUE
     },
 #ifdef HASXDMAUTH
     {
@@ -98,6 +100,96 @@ static const char *authorization_file = NULL;
 
 static Bool ShouldLoadAuth = TRUE;
 
+/*
+ * Cache of recently accepted credentials, so display managers that
+ * reconnect helper clients in quick succession skip the per-protocol
+ * cookie list scans.  Only successful verdicts of protocols marked
+ * CacheCheck are stored (XDM-AUTHORIZATION-1 verdicts also depend on
+ * the client address and time, so they must not be cached), and the
+ * cookie compare on a hit stays timing safe so the cache cannot be
+ * used as a byte-wise oracle against an accepted cookie.  The cache
+ * is flushed whenever the set of valid credentials may change.
+ */
+
+#define AUTH_CACHE_ENTRIES  8
+#define AUTH_CACHE_NAME_MAX 32
+#define AUTH_CACHE_DATA_MAX 64
+
+static struct auth_cache_entry {
+    Bool valid;
+    CARD32 hash;
+    unsigned short name_length;
+    unsigned short data_length;
+    char name[AUTH_CACHE_NAME_MAX];
+    char data[AUTH_CACHE_DATA_MAX];
+    XID id;
+} authCache[AUTH_CACHE_ENTRIES];
+static int authCacheNext;
+
+static CARD32
+AuthCacheHash(unsigned int name_length, const char *name,
+              unsigned int data_length, const char *data)
+{
+    CARD32 hash = 2166136261u;  /* FNV-1a */
+    unsigned int i;
+
+    for (i = 0; i < name_length; i++)
+        hash = (hash ^ (unsigned char) name[i]) * 16777619u;
+    for (i = 0; i < data_length; i++)
+        hash = (hash ^ (unsigned char) data[i]) * 16777619u;
+    return hash;
+}
+
+static void
+AuthCacheFlush(void)
+{
+    int i;
+
+    for (i = 0; i < AUTH_CACHE_ENTRIES; i++)
+        authCache[i].valid = FALSE;
+}
+
+static XID
+AuthCacheLookup(unsigned int name_length, const char *name,
+                unsigned int data_length, const char *data, CARD32 hash)
+{
+    int i;
+
+    for (i = 0; i < AUTH_CACHE_ENTRIES; i++) {
+        struct auth_cache_entry *entry = &authCache[i];
+
+        if (entry->valid && entry->hash == hash &&
+            entry->name_length == name_length &&
+            entry->data_length == data_length &&
+            memcmp(entry->name, name, name_length) == 0 &&
+            timingsafe_memcmp(entry->data, data, (int) data_length) == 0)
+            return entry->id;
+    }
+    return (XID) ~0L;
+}
+
+static void
+AuthCacheStore(unsigned int name_length, const char *name,
+               unsigned int data_length, const char *data,
+               CARD32 hash, XID id)
+{
+    struct auth_cache_entry *entry;
+
+    if (name_length > AUTH_CACHE_NAME_MAX || data_length > AUTH_CACHE_DATA_MAX)
+        return;
+
+    entry = &authCache[authCacheNext];
+    authCacheNext = (authCacheNext + 1) % AUTH_CACHE_ENTRIES;
+
+    entry->valid = TRUE;
+    entry->hash = hash;
+    entry->name_length = name_length;
+    entry->data_length = data_length;
+    memcpy(entry->name, name, name_length);
+    memcpy(entry->data, data, data_length);
+    entry->id = id;
+}
+
 void
 InitAuthorization(const char *file_name)
 {
@@ -113,6 +205,7 @@ LoadAuthorization(void)
     int count = 0;
 
     ShouldLoadAuth = FALSE;
+    AuthCacheFlush();
     if (!authorization_file)
         return 0;
 
@@ -203,11 +296,20 @@ CheckAuthorization(unsigned int name_length,
             EnableLocalAccess();
     }
     if (name_length) {
+        CARD32 hash = AuthCacheHash(name_length, name, data_length, data);
+        XID id = AuthCacheLookup(name_length, name, data_length, data, hash);
+
+        if (id != (XID) ~0L)
+            return id;
+
         for (i = 0; i < NUM_AUTHORIZATION; i++) {
             if (strlen(protocols[i].name) == name_length &&
                 memcmp(protocols[i].name, name, (int) name_length) == 0) {
-                return (*protocols[i].Check) (data_length, data, client,
-                                              reason);
+                id = (*protocols[i].Check) (data_length, data, client, reason);
+                if (id != (XID) ~0L && protocols[i].CacheCheck)
+                    AuthCacheStore(name_length, name, data_length, data,
+                                   hash, id);
+                return id;
             }
             *reason = "Authorization protocol not supported by server\n";
         }
@@ -225,6 +327,7 @@ ResetAuthorization(void)
     for (i = 0; i < NUM_AUTHORIZATION; i++)
         if (protocols[i].Reset)
             (*protocols[i].Reset) ();
+    AuthCacheFlush();
     ShouldLoadAuth = TRUE;
 }
 
@@ -257,6 +360,7 @@ RemoveAuthorization(unsigned short name_length,
         if (strlen(protocols[i].name) == name_length &&
             memcmp(protocols[i].name, name, (int) name_length) == 0 &&
             protocols[i].Remove) {
+            AuthCacheFlush();
             return (*protocols[i].Remove) (data_length, data);
         }
     }
@@ -273,6 +377,7 @@ AddAuthorization(unsigned name_length, const char *name,
         if (strlen(protocols[i].name) == name_length &&
             memcmp(protocols[i].name, name, (int) name_length) == 0 &&
             protocols[i].Add) {
+            AuthCacheFlush();
             return protocols[i].Add(data_length, data);
         }
     }
@@ -33,6 +33,15 @@
 #include <sys/wait.h>
 #endif
 
+/* Raw frame addresses recorded by xorg_backtrace_capture() inside a
+ * signal handler, symbolized later by xorg_backtrace_symbolize() from
+ * normal context.  Preallocated so the capture path never allocates. */
+#define BT_CAPTURE_SIZE 64
+#if defined(HAVE_LIBUNWIND) || defined(HAVE_BACKTRACE)
+static void *bt_capture[BT_CAPTURE_SIZE];
+static volatile int bt_captured;
+#endif
+
 #ifdef HAVE_LIBUNWIND
 
 #define UNW_LOCAL_ONLY
@@ -176,6 +185,27 @@ xorg_backtrace(void)
 
     ErrorF("\n");
 }
+
+void
+xorg_backtrace_capture(void)
+{
+    unw_cursor_t cursor;
+    unw_context_t context;
+    unw_word_t ip;
+    int n = 0;
+
+    /* only local unwind primitives here: this runs in signal handlers */
+    if (unw_getcontext(&context))
+        return;
+    if (unw_init_local(&cursor, &context))
+        return;
+    while (n < BT_CAPTURE_SIZE && unw_step(&cursor) > 0) {
+        if (unw_get_reg(&cursor, UNW_REG_IP, &ip) < 0)
+            break;
+        bt_capture[n++] = (void *) (uintptr_t) ip;
+    }
+    bt_captured = n;
+}
 #else /* HAVE_LIBUNWIND */
 #ifdef HAVE_BACKTRACE
 #ifndef _GNU_SOURCE
@@ -226,6 +256,14 @@ xorg_backtrace(void)
     ErrorF("\n");
 }
 
+void
+xorg_backtrace_capture(void)
+{
+    /* backtrace() itself is safe in a handler once libgcc is loaded;
+     * busfault_init() primes it with a throwaway call at startup */
+    bt_captured = backtrace(bt_capture, BT_CAPTURE_SIZE);
+}
+
 #else                           /* not glibc or glibc < 2.1 */
 
 #if defined(__sun) && defined(__SVR4)
@@ -396,3 +434,51 @@ xorg_backtrace(void)
 #endif
 #endif
 #endif
+
+#if defined(HAVE_LIBUNWIND) || defined(HAVE_BACKTRACE)
+
+void
+xorg_backtrace_symbolize(void)
+{
+    const char *mod;
+    int count, i;
+    Dl_info info;
+
+    count = bt_captured;
+    bt_captured = 0;
+    if (!count)
+        return;
+
+    ErrorF("\n");
+    ErrorF("Backtrace:\n");
+    for (i = 0; i < count; i++) {
+        if (dladdr(bt_capture[i], &info) == 0) {
+            ErrorF("%u: ?? [%p]\n", i, bt_capture[i]);
+            continue;
+        }
+        mod = (info.dli_fname && *info.dli_fname) ? info.dli_fname : "(vdso)";
+        if (info.dli_saddr)
+            ErrorF("%u: %s (%s+0x%x) [%p]\n", i, mod, info.dli_sname,
+                   (unsigned int) ((char *) bt_capture[i] -
+                                   (char *) info.dli_saddr), bt_capture[i]);
+        else
+            ErrorF("%u: %s (%p+0x%x) [%p]\n", i, mod, info.dli_fbase,
+                   (unsigned int) ((char *) bt_capture[i] -
+                                   (char *) info.dli_fbase), bt_capture[i]);
+    }
+    ErrorF("\n");
+}
+
+#else
+
+void
+xorg_backtrace_capture(void)
+{
+}
+
+void
+xorg_backtrace_symbolize(void)
+{
+}
+
+#endif
@@ -90,6 +90,10 @@ busfault_check(void)
         if (!busfault->valid)
             (*busfault->notify)(busfault->context);
     }
+
+    /* log where the recovered fault hit, now that symbol resolution is
+     * safe and doesn't hold up the signal handler */
+    xorg_backtrace_symbolize();
 }
 
 static void (*previous_busfault_sigaction)(int sig, siginfo_t *info, void *param);
@@ -128,6 +132,10 @@ busfault_sigaction(int sig, siginfo_t *info, void *param)
     if (new_addr == MAP_FAILED)
         goto panic;
 
+    /* record raw frame addresses only; busfault_check() symbolizes them
+     * outside the handler */
+    xorg_backtrace_capture();
+
     return;
 panic:
     if (previous_busfault_sigaction)
@@ -148,5 +156,8 @@ busfault_init(void)
         return FALSE;
     previous_busfault_sigaction = old_act.sa_sigaction;
     xorg_list_init(&busfaults);
+    /* prime the unwinder outside signal context (glibc's backtrace()
+     * lazily loads libgcc on first use) */
+    xorg_backtrace_capture();
     return TRUE;
 }
@@ -91,6 +91,7 @@ SOFTWARE.
 #include <sys/uio.h>
 #endif
 
+#include "dix/bootprof_priv.h"
 #include "dix/dix_priv.h"
 #include "dix/dixgrabs_priv.h"
 #include "dix/server_priv.h"
@@ -287,6 +288,8 @@ CreateWellKnownSockets(void)
         int fd = _XSERVTransGetConnectionNumber(ListenTransConns[i]);
 
         ListenTransFds[i] = fd;
+        /* non-blocking, so EstablishNewConnections can drain the backlog */
+        _XSERVTransNonBlock(ListenTransConns[i]);
         SetNotifyFd(fd, EstablishNewConnections, X_NOTIFY_READ, NULL);
 
         if (!_XSERVTransIsLocal(ListenTransConns[i]))
@@ -587,6 +590,10 @@ AllocNewConnection(XtransConnInfo trans_conn, int fd, CARD32 conn_time)
         return NULL;
     }
     client->local = ComputeLocalClient(client);
+
+    /* startup is over once the first client gets in */
+    BootPhaseDone();
+
     ospoll_add(server_poll, fd,
                ospoll_trigger_edge,
                ClientReady,
@@ -610,6 +617,12 @@ AllocNewConnection(XtransConnInfo trans_conn, int fd, CARD32 conn_time)
  *    connections if they've stuck around for more than one minute.
  *****************/
 #define TimeOutValue 60 * MILLI_PER_SECOND
+
+/* Upper bound on accepts per wakeup; the listener stays readable so the
+ * remainder of a larger backlog is picked up on the next iteration
+ * without a connect flood starving request dispatch. */
+#define MAX_ACCEPT_PER_WAKEUP 64
+
 static void
 EstablishNewConnections(int curconn, int ready, void *data)
 {
@@ -635,20 +648,24 @@ EstablishNewConnections(int curconn, int ready, void *data)
     if ((trans_conn = lookup_trans_conn(curconn)) == NULL)
         return;
 
-    if ((new_trans_conn = _XSERVTransAccept(trans_conn)) == NULL)
-        return;
+    /* The listener is non-blocking: a session spawning dozens of clients
+     * at once gets its whole backlog accepted in one wakeup instead of
+     * bouncing through the main loop once per connection. */
+    for (i = 0; i < MAX_ACCEPT_PER_WAKEUP; i++) {
+        if ((new_trans_conn = _XSERVTransAccept(trans_conn)) == NULL)
+            return;
 
-    newconn = _XSERVTransGetConnectionNumber(new_trans_conn);
+        newconn = _XSERVTransGetConnectionNumber(new_trans_conn);
 
-    _XSERVTransNonBlock(new_trans_conn);
+        _XSERVTransNonBlock(new_trans_conn);
 
-    if (trans_conn->flags & TRANS_NOXAUTH)
-        new_trans_conn->flags = new_trans_conn->flags | TRANS_NOXAUTH;
+        if (trans_conn->flags & TRANS_NOXAUTH)
+            new_trans_conn->flags = new_trans_conn->flags | TRANS_NOXAUTH;
 
-    if (!AllocNewConnection(new_trans_conn, newconn, connect_time)) {
-        ErrorConnMax(new_trans_conn);
+        if (!AllocNewConnection(new_trans_conn, newconn, connect_time)) {
+            ErrorConnMax(new_trans_conn);
+        }
     }
-    return;
 }
 
 /************
@@ -737,6 +754,7 @@ CloseDownConnection(ClientPtr client)
 	FlushClient(client, oc);
     CloseDownFileDescriptor(oc);
     FreeOsBuffers(oc);
+    FreeLocalClientCreds(oc->peerCreds);
     free(client->osPrivate);
     client->osPrivate = (void *) NULL;
     if (auditTrailLevel > 1)
@@ -999,6 +1017,7 @@ ListenOnOpenFD(int fd, int noxauth)
     ListenTransConns[ListenTransCount] = ciptr;
     ListenTransFds[ListenTransCount] = fd;
 
+    _XSERVTransNonBlock(ciptr);
     SetNotifyFd(fd, EstablishNewConnections, X_NOTIFY_READ, NULL);
 
     /* Increment the count */
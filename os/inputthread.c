@@ -84,6 +84,17 @@ static InputThreadInfo *inputThreadInfo;
 static int hotplugPipeRead = -1;
 static int hotplugPipeWrite = -1;
 
+/*
+ * Set while the main thread is (about to be) blocked in its poll.  The
+ * input thread only writes the wake-up pipe when this is set: while the
+ * main thread is awake it re-checks the event queue indices before it
+ * blocks again, so a pipe write per input poll iteration would only burn
+ * a syscall and a spurious main thread wakeup.  The paired seq_cst
+ * fences in InputThreadPrepareSleep() and the input thread loop order
+ * the flag against the queue indices so a wakeup cannot be lost.
+ */
+static int input_main_sleeping;
+
 static int input_mutex_count;
 
 #ifdef PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
@@ -135,6 +146,40 @@ input_force_unlock(void)
     }
 }
 
+/**
+ * Tell the input thread that the main thread is about to block waiting
+ * for work, and so has to be woken through the pipe when input events
+ * come in.  The caller must re-check for pending input events after this
+ * and skip blocking if any are found, otherwise events enqueued just
+ * before the flag became visible could go unnoticed until the next
+ * wakeup.
+ *
+ * @see WaitForSomething()
+ */
+void
+InputThreadPrepareSleep(void)
+{
+    if (!inputThreadInfo)
+        return;
+    __atomic_store_n(&input_main_sleeping, 1, __ATOMIC_RELAXED);
+    /* order the flag store before the caller's pending-input re-check */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+ * Tell the input thread that the main thread is awake again and will
+ * notice new input events on its own.
+ *
+ * @see WaitForSomething()
+ */
+void
+InputThreadFinishSleep(void)
+{
+    if (!inputThreadInfo)
+        return;
+    __atomic_store_n(&input_main_sleeping, 0, __ATOMIC_RELAXED);
+}
+
 /**
  * Notify a thread about the availability of new asynchronously enqueued input
  * events.
@@ -376,9 +421,15 @@ InputThreadDoWork(void *arg)
                 ErrorF("input-thread: %s (%s)\n", __func__, strerror(errno));
         }
 
-        /* Kick main thread to process the generated input events and drain
-         * events from hotplug pipe */
-        InputThreadFillPipe(inputThreadInfo->writePipe);
+        /* Kick the main thread to process the generated input events and
+         * drain events from the hotplug pipe - but only when it may
+         * actually be asleep in its poll.  While it is awake it picks up
+         * new events through the queue indices before blocking again, so
+         * high-rate devices don't pay for a pipe write and a spurious
+         * main thread wakeup on every input poll iteration. */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&input_main_sleeping, __ATOMIC_RELAXED))
+            InputThreadFillPipe(inputThreadInfo->writePipe);
     }
 
     ospoll_remove(inputThreadInfo->fds, hotplugPipeRead);
@@ -544,6 +595,8 @@ void input_force_unlock(void) {}
 void InputThreadPreInit(void) {}
 void InputThreadInit(void) {}
 void InputThreadFini(void) {}
+void InputThreadPrepareSleep(void) {}
+void InputThreadFinishSleep(void) {}
 int in_input_thread(void) { return 0; }
 
 int InputThreadRegisterDev(int fd,
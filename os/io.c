@@ -78,6 +78,7 @@ SOFTWARE.
 #include "os/io_priv.h"
 #include "os/osdep.h"
 #include "os/ossock.h"
+#include "os/probes_priv.h"
 
 #include "os.h"
 #include "opaque.h"
@@ -87,6 +88,15 @@ SOFTWARE.
 CallbackListPtr ReplyCallback = NULL;
 CallbackListPtr FlushCallback;
 
+/* complete requests indexed ahead by one scan of the input buffer */
+#define REQINDEX_SIZE 64
+
+/* requests at least this large are candidates for streamed consumption */
+#define STREAM_REQ_THRESHOLD (256 * 1024)
+/* chunk granularity; also caps input buffer growth for streamed requests */
+#define STREAM_REQ_CHUNK (64 * 1024)
+#define STREAM_HDR_MAX 64
+
 typedef struct _connectionInput {
     struct _connectionInput *next;
     char *buffer;               /* contains current client input */
@@ -95,6 +105,14 @@ typedef struct _connectionInput {
     int lenLastReq;
     int size;
     unsigned int ignoreBytes;   /* bytes to ignore before the next request */
+    int reqIndex[REQINDEX_SIZE]; /* byte lengths of batch-parsed requests */
+    int reqIndexHead;
+    int reqIndexCount;
+    int streamHdrLen;           /* >0 while streaming a large request */
+    int streamChunk;            /* payload bytes in the delivered chunk */
+    CARD32 streamTotal;         /* total payload bytes of the request */
+    CARD32 streamDone;          /* payload bytes already consumed */
+    char streamHdr[STREAM_HDR_MAX]; /* pristine copy of the request header */
 } ConnectionInput;
 
 typedef struct _connectionOutput {
@@ -104,6 +122,17 @@ typedef struct _connectionOutput {
     int count;
 } ConnectionOutput;
 
+/* a reply segment queued for zero-copy writev(), see WriteToClientVec() */
+typedef struct _connectionVec {
+    struct _connectionVec *next;
+    const unsigned char *ptr;   /* unwritten payload bytes */
+    size_t len;
+    size_t pad;                 /* trailing pad bytes still to write */
+    unsigned char *ownedBuf;    /* free()d on completion if set */
+    WriteVecDoneProcPtr done;   /* completion callback, may be NULL */
+    void *closure;
+} ConnectionVec;
+
 static ConnectionInputPtr AllocateInputBuffer(void);
 static ConnectionOutputPtr AllocateOutputBuffer(void);
 
@@ -125,6 +154,85 @@ static OsCommPtr AvailableInput = (OsCommPtr) NULL;
 #define BUFSIZE 16384
 #define BUFWATERMARK 32768
 
+/* payloads at least this big skip the copy into oco->buf and are queued
+ * for a direct writev() instead */
+#define VECWRITE_THRESHOLD 4096
+
+/* segments handed to one writev() call: several queued payloads with
+ * their padding, plus the trailing copy buffer */
+#define VECWRITE_MAX_IOV 16
+
+static const char padZeros[4];
+
+/*
+ * Shared pool of connection buffers, size-classed so that buffer
+ * acquisition on the hot paths is a pointer pop.  Input and output
+ * buffers draw from the same pool; odd-sized buffers (grown by realloc
+ * for big requests) simply miss the pool and are freed.  Each class is
+ * capped so sessions with many connect/disconnect cycles don't pin
+ * memory: anything above the high-water mark goes back to the system.
+ */
+typedef struct _bufPoolEntry {
+    struct _bufPoolEntry *next;
+} BufPoolEntry;
+
+#define BUFPOOL_CLASSES 3
+#define BUFPOOL_HIWATER 32      /* retained buffers per class */
+
+static const int bufPoolSize[BUFPOOL_CLASSES] =
+    { BUFSIZE, 2 * BUFSIZE, 4 * BUFSIZE };
+static BufPoolEntry *bufPool[BUFPOOL_CLASSES];
+static int bufPoolCount[BUFPOOL_CLASSES];
+
+/* get a pooled buffer of exactly `size` bytes, or NULL on OOM */
+static void *
+ConnBufferGet(int size)
+{
+    for (int cls = 0; cls < BUFPOOL_CLASSES; cls++) {
+        if (bufPoolSize[cls] == size && bufPool[cls]) {
+            BufPoolEntry *entry = bufPool[cls];
+
+            bufPool[cls] = entry->next;
+            bufPoolCount[cls]--;
+            return entry;
+        }
+    }
+    return malloc(size);
+}
+
+/* hand a connection buffer of `size` bytes back to the pool */
+static void
+ConnBufferPut(void *buf, int size)
+{
+    if (!buf)
+        return;
+    for (int cls = 0; cls < BUFPOOL_CLASSES; cls++) {
+        if (bufPoolSize[cls] == size && bufPoolCount[cls] < BUFPOOL_HIWATER) {
+            BufPoolEntry *entry = buf;
+
+            entry->next = bufPool[cls];
+            bufPool[cls] = entry;
+            bufPoolCount[cls]++;
+            return;
+        }
+    }
+    free(buf);
+}
+
+static void
+ConnBufferTrim(void)
+{
+    for (int cls = 0; cls < BUFPOOL_CLASSES; cls++) {
+        BufPoolEntry *entry;
+
+        while ((entry = bufPool[cls])) {
+            bufPool[cls] = entry->next;
+            free(entry);
+        }
+        bufPoolCount[cls] = 0;
+    }
+}
+
 /*
  *   A lot of the code in this file manipulates a ConnectionInputPtr:
  *
@@ -216,7 +324,7 @@ NextAvailableInput(OsCommPtr oc)
             ConnectionInputPtr aci = AvailableInput->input;
 
             if (aci->size > BUFWATERMARK) {
-                free(aci->buffer);
+                ConnBufferPut(aci->buffer, aci->size);
                 free(aci);
             }
             else {
@@ -229,6 +337,221 @@ NextAvailableInput(OsCommPtr oc)
     }
 }
 
+/* One-pass scan of the buffered bytes following the current request.
+ * Every further complete request has its byte length recorded in the
+ * index, so subsequent ReadRequestFromClient() calls can pop them
+ * without redoing the buffer bookkeeping.  Stops at Big Requests and
+ * anything suspicious, which stay on the untouched slow path.
+ */
+static void
+ConnInputBatchScan(ConnectionInputPtr oci, ClientPtr client)
+{
+    char *ptr = oci->bufptr + oci->lenLastReq;
+    int avail = oci->bufcnt + oci->buffer - ptr;
+
+    oci->reqIndexHead = oci->reqIndexCount = 0;
+    while (oci->reqIndexCount < REQINDEX_SIZE && avail >= sizeof(xReq)) {
+        xReq *request = (xReq *) ptr;
+        int needed = get_req_len(request, client);
+
+        if (!needed)            /* Big Request (or garbage) */
+            break;
+        needed <<= 2;
+        if (avail < needed)
+            break;
+        oci->reqIndex[oci->reqIndexCount++] = needed;
+        ptr += needed;
+        avail -= needed;
+    }
+}
+
+/* Streamed consumption of very large requests.  Instead of buffering a
+ * multi-megabyte request in its entirety before dispatch, a registered
+ * request type is handed to its proc repeatedly with the saved request
+ * header followed by as much payload as has arrived; the proc consumes
+ * what it can and re-queues itself with ResetCurrentRequest() until the
+ * payload is complete.  This caps per-client input buffers at
+ * STREAM_REQ_CHUNK for such requests.
+ */
+static struct {
+    StreamRequestCheckProcPtr check;
+    int hdrLen;
+} streamableReqs[256];
+
+void
+RegisterStreamableRequest(int majorOp, int hdrLen,
+                          StreamRequestCheckProcPtr check)
+{
+    if (majorOp < 0 || majorOp > 255 || hdrLen > STREAM_HDR_MAX)
+        return;
+    streamableReqs[majorOp].check = check;
+    streamableReqs[majorOp].hdrLen = hdrLen;
+}
+
+static Bool
+StreamRequestStart(ClientPtr client, ConnectionInputPtr oci,
+                   unsigned int needed, Bool move_header)
+{
+    xReq *request = (xReq *) oci->bufptr;
+    StreamRequestCheckProcPtr check = streamableReqs[request->reqType].check;
+    int hdrlen = streamableReqs[request->reqType].hdrLen;
+    unsigned int gotnow = oci->bufcnt + oci->buffer - oci->bufptr;
+    unsigned int wirehdr = hdrlen +
+        (move_header ? sizeof(xBigReq) - sizeof(xReq) : 0);
+    char probe[STREAM_HDR_MAX];
+
+    if (!check || gotnow < wirehdr)
+        return FALSE;
+
+    /* present the header to the check in its dispatch shape (Big Request
+     * length word squeezed out) without committing any buffer changes */
+    if (move_header) {
+        memcpy(probe, oci->bufptr, sizeof(xReq));
+        memcpy(probe + sizeof(xReq), oci->bufptr + sizeof(xBigReq),
+               wirehdr - sizeof(xBigReq));
+    }
+    else
+        memcpy(probe, oci->bufptr, hdrlen);
+
+    if (!check(client, probe))
+        return FALSE;
+
+    if (oci->size < STREAM_REQ_CHUNK) {
+        char *ibuf = (char *) realloc(oci->buffer, STREAM_REQ_CHUNK);
+
+        if (!ibuf)              /* fall back to the buffering path */
+            return FALSE;
+        oci->bufptr = ibuf + (oci->bufptr - oci->buffer);
+        oci->buffer = ibuf;
+        oci->size = STREAM_REQ_CHUNK;
+    }
+
+    memcpy(oci->streamHdr, probe, hdrlen);
+    oci->streamHdrLen = hdrlen;
+    oci->streamTotal = needed - wirehdr;
+    oci->streamDone = 0;
+    oci->streamChunk = 0;
+    oci->reqIndexHead = oci->reqIndexCount = 0;
+
+    /* the wire header is consumed; the buffer now carries payload only */
+    oci->bufptr += wirehdr;
+    return TRUE;
+}
+
+static int
+StreamRequestContinue(ClientPtr client)
+{
+    OsCommPtr oc = (OsCommPtr) client->osPrivate;
+    ConnectionInputPtr oci = oc->input;
+    unsigned int have = oci->bufcnt + oci->buffer - oci->bufptr;
+    CARD32 left = oci->streamTotal - oci->streamDone;
+    unsigned int avail;
+    int result;
+
+    /* keep the payload at a fixed offset so the saved header can be
+     * re-materialized right in front of it */
+    if (oci->bufptr - oci->buffer != oci->streamHdrLen) {
+        if (have)
+            memmove(oci->buffer + oci->streamHdrLen, oci->bufptr, have);
+        oci->bufptr = oci->buffer + oci->streamHdrLen;
+        oci->bufcnt = oci->streamHdrLen + have;
+    }
+
+    avail = have < left ? have : left;
+    if (avail < left && oci->bufcnt < oci->size) {
+        if (!oc->trans_conn) {
+            YieldControlDeath();
+            return -1;
+        }
+        result = _XSERVTransRead(oc->trans_conn, oci->buffer + oci->bufcnt,
+                                 oci->size - oci->bufcnt);
+        if (result <= 0) {
+            if (!((result < 0) && ossock_wouldblock(errno))) {
+                YieldControlDeath();
+                return -1;
+            }
+        }
+        else {
+            oci->bufcnt += result;
+            have += result;
+            avail = have < left ? have : left;
+        }
+    }
+
+    if (avail == 0) {
+        mark_client_not_ready(client);
+        YieldControlNoInput(client);
+        return 0;
+    }
+
+    /* hand the proc the saved header with as much payload as we have */
+    oci->bufptr -= oci->streamHdrLen;
+    memcpy(oci->bufptr, oci->streamHdr, oci->streamHdrLen);
+    oci->streamChunk = avail;
+    oci->lenLastReq = 0;        /* advanced by StreamedRequestConsume() */
+    client->requestBuffer = (void *) oci->bufptr;
+    client->req_len = (oci->streamHdrLen + oci->streamTotal) >> 2;
+    return oci->streamHdrLen + oci->streamTotal;
+}
+
+/* payload bytes available in the current chunk, or -1 when the current
+ * request is not being streamed */
+int
+StreamedRequestAvail(ClientPtr client)
+{
+    OsCommPtr oc = (OsCommPtr) client->osPrivate;
+    ConnectionInputPtr oci;
+
+    if (!oc || !(oci = oc->input) || !oci->streamHdrLen)
+        return -1;
+    return oci->streamChunk;
+}
+
+/* payload bytes already consumed by earlier chunks of this request */
+CARD32
+StreamedRequestDone(ClientPtr client)
+{
+    OsCommPtr oc = (OsCommPtr) client->osPrivate;
+
+    return oc->input->streamDone;
+}
+
+void
+StreamedRequestConsume(ClientPtr client, int count)
+{
+    OsCommPtr oc = (OsCommPtr) client->osPrivate;
+    ConnectionInputPtr oci = oc->input;
+
+    oci->streamDone += count;
+    oci->streamChunk = 0;
+    /* skip the header copy plus the consumed payload on the next read */
+    oci->lenLastReq = oci->streamHdrLen + count;
+    if (oci->streamDone >= oci->streamTotal)
+        oci->streamHdrLen = 0;  /* complete; back to normal parsing */
+}
+
+/* Called by the dispatcher when a streamed request fails mid-payload:
+ * whatever the proc has not consumed is discarded through the regular
+ * ignoreBytes machinery so a single error is sent.
+ */
+void
+StreamedRequestAbort(ClientPtr client)
+{
+    OsCommPtr oc = (OsCommPtr) client->osPrivate;
+    ConnectionInputPtr oci;
+
+    if (!oc || !(oci = oc->input) || !oci->streamHdrLen)
+        return;
+    if (oci->lenLastReq)
+        oci->bufptr += oci->lenLastReq;
+    else
+        oci->bufptr += oci->streamHdrLen;
+    oci->lenLastReq = 0;
+    oci->ignoreBytes = oci->streamTotal - oci->streamDone;
+    oci->streamHdrLen = 0;
+    oci->streamChunk = 0;
+}
+
 int
 ReadRequestFromClient(ClientPtr client)
 {
@@ -240,6 +563,32 @@ ReadRequestFromClient(ClientPtr client)
     Bool need_header;
     Bool move_header;
 
+    /* batched fast path: pop straight off the parsed index */
+    if (oci && oci->reqIndexCount && !oci->ignoreBytes) {
+        if (AvailableInput == oc)
+            AvailableInput = NULL;
+#if XTRANS_SEND_FDS
+        /* Discard any unused file descriptors */
+        while (client->req_fds > 0) {
+            int req_fd = ReadFdFromClient(client);
+            if (req_fd >= 0)
+                close(req_fd);
+        }
+#endif
+        oci->bufptr += oci->lenLastReq;
+        needed = oci->reqIndex[oci->reqIndexHead++];
+        oci->reqIndexCount--;
+        oci->lenLastReq = needed;
+        client->req_len = needed >> 2;
+        client->requestBuffer = (void *) oci->bufptr;
+        if (!oci->reqIndexCount) {
+            gotnow = oci->bufcnt + oci->buffer - oci->bufptr - needed;
+            if (!gotnow)
+                AvailableInput = oc;
+        }
+        return needed;
+    }
+
     NextAvailableInput(oc);
 
     /* make sure we have an input buffer */
@@ -267,6 +616,12 @@ ReadRequestFromClient(ClientPtr client)
 
     oci->bufptr += oci->lenLastReq;
 
+    /* continue a partially-consumed streamed request */
+    if (oci->streamHdrLen) {
+        oci->lenLastReq = 0;
+        return StreamRequestContinue(client);
+    }
+
     need_header = FALSE;
     move_header = FALSE;
     gotnow = oci->bufcnt + oci->buffer - oci->bufptr;
@@ -326,6 +681,10 @@ ReadRequestFromClient(ClientPtr client)
             oci->lenLastReq = gotnow;
             return needed;
         }
+        if (needed >= STREAM_REQ_THRESHOLD && !need_header &&
+            !oci->ignoreBytes &&
+            StreamRequestStart(client, oci, needed, move_header))
+            return StreamRequestContinue(client);
         if ((gotnow == 0) || ((oci->bufptr - oci->buffer + needed) > oci->size)) {
             /* no data, or the request is too big to fit in the buffer */
 
@@ -447,6 +806,8 @@ ReadRequestFromClient(ClientPtr client)
     gotnow -= needed;
     if (!gotnow && !oci->ignoreBytes)
         AvailableInput = oc;
+    if (gotnow > 0 && !oci->ignoreBytes)
+        ConnInputBatchScan(oci, client);
     if (move_header) {
         if (client->req_len < bytes_to_int32(sizeof(xBigReq) - sizeof(xReq))) {
             YieldControlDeath();
@@ -525,6 +886,7 @@ InsertFakeRequest(ClientPtr client, char *data, int count)
     }
     oci->bufptr += oci->lenLastReq;
     oci->lenLastReq = 0;
+    oci->reqIndexHead = oci->reqIndexCount = 0;
     gotnow = oci->bufcnt + oci->buffer - oci->bufptr;
     if ((gotnow + count) > oci->size) {
         char *ibuf;
@@ -575,7 +937,25 @@ ResetCurrentRequest(ClientPtr client)
 
     if (AvailableInput == oc)
         AvailableInput = (OsCommPtr) NULL;
+
+    /* A streamed request stays current until its payload is complete; its
+     * bookkeeping advanced through StreamedRequestConsume(), so only work
+     * out whether the client needs to wait for more socket data. */
+    if (oci->streamHdrLen) {
+        oci->reqIndexHead = oci->reqIndexCount = 0;
+        gotnow = oci->bufcnt + oci->buffer - (oci->bufptr + oci->lenLastReq);
+        if (gotnow >= (int) (oci->streamTotal - oci->streamDone)) {
+            if (listen_to_client(client))
+                mark_client_ready(client);
+            YieldControl();
+        }
+        else
+            YieldControlNoInput(client);
+        return;
+    }
+
     oci->lenLastReq = 0;
+    oci->reqIndexHead = oci->reqIndexCount = 0;
     gotnow = oci->bufcnt + oci->buffer - oci->bufptr;
     if (gotnow < sizeof(xReq)) {
         YieldControlNoInput(client);
@@ -611,16 +991,30 @@ ResetCurrentRequest(ClientPtr client)
  *
  **********************/
 
+/* Adaptive corking for remote clients: when other clients are still
+ * ready, dispatch runs again before the server sleeps, so a sub-MTU
+ * output buffer is likely to gain more replies if we hold it for
+ * another pass instead of pushing a tiny TCP segment now.  Bounded so
+ * a quiet client's reply never lags more than a few dispatch passes,
+ * and bypassed entirely for critical (event) output.
+ */
+#define CORK_THRESHOLD  1400    /* typical TCP MSS */
+#define CORK_MAX_PASSES 2
+
 void
 FlushAllOutput(void)
 {
     OsCommPtr oc;
     register ClientPtr client, tmp;
     Bool newoutput = NewOutputPending;
+    Bool critical = CriticalOutputPending;
+    Bool more_work;
 
     if (!newoutput)
         return;
 
+    more_work = clients_are_ready();
+
     /*
      * It may be that some client still has critical output pending,
      * but he is not yet ready to receive it anyway, so we will
@@ -634,6 +1028,15 @@ FlushAllOutput(void)
             continue;
         if (!client_is_ready(client)) {
             oc = (OsCommPtr) client->osPrivate;
+            if (more_work && !critical && !client->local &&
+                !oc->vecHead && oc->output &&
+                oc->output->count < CORK_THRESHOLD &&
+                oc->corkPasses < CORK_MAX_PASSES) {
+                oc->corkPasses++;
+                NewOutputPending = TRUE;
+                continue;
+            }
+            oc->corkPasses = 0;
             FlushClient(client, oc);
         } else
             NewOutputPending = TRUE;
@@ -895,6 +1298,113 @@ WriteToClient(ClientPtr who, int count, const void *__buf)
     return count;
 }
 
+static void
+VecQueueAppend(OsCommPtr oc, ConnectionVecPtr vec)
+{
+    vec->next = NULL;
+    if (oc->vecTail)
+        oc->vecTail->next = vec;
+    else
+        oc->vecHead = vec;
+    oc->vecTail = vec;
+}
+
+static void
+VecEntryRelease(ConnectionVecPtr vec)
+{
+    if (vec->done)
+        vec->done(vec->closure);
+    free(vec->ownedBuf);
+    free(vec);
+}
+
+/* Move the bytes already staged in oco->buf into the zero-copy queue so
+ * that a payload queued afterwards stays ordered behind them.  Ownership
+ * of the buffer passes to the queue entry; oc->output is released.
+ */
+static Bool
+VecQueueDemoteOutput(OsCommPtr oc)
+{
+    ConnectionOutputPtr oco = oc->output;
+    ConnectionVecPtr vec;
+
+    if (!oco || !oco->count)
+        return TRUE;
+
+    vec = calloc(1, sizeof(ConnectionVec));
+    if (!vec)
+        return FALSE;
+
+    vec->ptr = oco->buf;
+    vec->len = oco->count;
+    vec->ownedBuf = oco->buf;
+    VecQueueAppend(oc, vec);
+
+    oc->output = NULL;
+    free(oco);
+    return TRUE;
+}
+
+/*****************
+ * WriteToClientVec
+ *    Like WriteToClient, but large payloads are queued by reference and
+ *    flushed directly via writev(), skipping the copy into the per-client
+ *    output buffer.  The caller keeps the buffer alive until `done` is
+ *    invoked (also on abort); small payloads are copied as usual and
+ *    `done` fires before returning.  Falls back to the copying path while
+ *    a ReplyCallback is registered so callback consumers keep seeing the
+ *    reply bytes in order.
+ *****************/
+
+int
+WriteToClientVec(ClientPtr who, int count, const void *buf,
+                 WriteVecDoneProcPtr done, void *closure)
+{
+    OsCommPtr oc;
+    ConnectionVecPtr vec;
+
+    BUG_RETURN_VAL_MSG(in_input_thread(), 0,
+                       "******** %s called from input thread *********\n", __func__);
+
+    if (!count || !who || who == serverClient || who->clientGone) {
+        if (done)
+            done(closure);
+        return 0;
+    }
+    oc = who->osPrivate;
+
+    if (count < VECWRITE_THRESHOLD || ReplyCallback || !oc->trans_conn) {
+        int ret = WriteToClient(who, count, buf);
+        if (done)
+            done(closure);
+        return ret;
+    }
+
+    if (!VecQueueDemoteOutput(oc) ||
+        !(vec = calloc(1, sizeof(ConnectionVec)))) {
+        AbortClient(who);
+        dixMarkClientException(who);
+        if (done)
+            done(closure);
+        return -1;
+    }
+
+    vec->ptr = buf;
+    vec->len = count;
+    vec->pad = padding_for_int32(count);
+    vec->done = done;
+    vec->closure = closure;
+    VecQueueAppend(oc, vec);
+
+    NewOutputPending = TRUE;
+    output_pending_mark(who);
+
+    /* large replies are worth pushing out right away */
+    if (FlushClient(who, oc) == -1)
+        return -1;
+    return count;
+}
+
  /********************
  * FlushClient()
  *    If the client isn't keeping up with us, then we try to continue
@@ -911,8 +1421,8 @@ FlushClient(ClientPtr who, OsCommPtr oc)
     ConnectionOutputPtr oco = oc->output;
     XtransConnInfo trans_conn = oc->trans_conn;
 
-    /* if no output buffer, then nothing to do */
-    if (!oco)
+    /* if no output buffer and no queued segments, then nothing to do */
+    if (!oco && !oc->vecHead)
 	return 0;
 
     if (!trans_conn) {
@@ -920,15 +1430,98 @@ FlushClient(ClientPtr who, OsCommPtr oc)
         goto abortClient;
     }
 
+    if ((oc->vecHead || (oco && oco->count)) && FlushCallback)
+        CallCallbacks(&FlushCallback, who);
+
+    /* Drain queued zero-copy segments straight from their owners' buffers
+     * via writev(), with the trailing copy buffer tacked onto the last
+     * batch.  Queue order is wire order.
+     */
+    while (oc->vecHead) {
+        struct iovec iov[VECWRITE_MAX_IOV];
+        int niov = 0;
+        size_t queued = 0;
+        ConnectionVecPtr vec;
+
+        for (vec = oc->vecHead; vec && niov < VECWRITE_MAX_IOV - 1;
+             vec = vec->next) {
+            if (vec->len) {
+                iov[niov].iov_base = (void *) vec->ptr;
+                iov[niov].iov_len = vec->len;
+                queued += vec->len;
+                niov++;
+            }
+            if (vec->pad) {
+                iov[niov].iov_base = (void *) padZeros;
+                iov[niov].iov_len = vec->pad;
+                queued += vec->pad;
+                niov++;
+            }
+        }
+        if (!vec && oco && oco->count && niov < VECWRITE_MAX_IOV) {
+            iov[niov].iov_base = oco->buf;
+            iov[niov].iov_len = oco->count;
+            queued += oco->count;
+            niov++;
+        }
+
+        errno = 0;
+        ssize_t len = _XSERVTransWritev(trans_conn, iov, niov);
+        if (len < 0) {
+            if (ossock_wouldblock(errno)) {
+                output_pending_mark(who);
+                ospoll_listen(server_poll, oc->fd, X_NOTIFY_WRITE);
+                return 0;
+            }
+            goto abortClient;
+        }
+
+#ifdef XSERVER_DTRACE
+        if (XSERVER_CLIENT_FLUSH_ENABLED())
+            XSERVER_CLIENT_FLUSH(who->index, (int) len);
+#endif
+
+        /* retire completed segments, in queue order */
+        while (len > 0 && (vec = oc->vecHead)) {
+            if (vec->len) {
+                size_t n = min((size_t) len, vec->len);
+                vec->ptr += n;
+                vec->len -= n;
+                len -= n;
+            }
+            if (len > 0 && vec->pad) {
+                size_t n = min((size_t) len, vec->pad);
+                vec->pad -= n;
+                len -= n;
+            }
+            if (!vec->len && !vec->pad) {
+                oc->vecHead = vec->next;
+                if (!oc->vecHead)
+                    oc->vecTail = NULL;
+                VecEntryRelease(vec);
+            }
+        }
+        if (len > 0 && oco) {
+            /* the remainder came out of the trailing copy buffer */
+            oco->count -= len;
+            if (oco->count)
+                memmove(oco->buf, oco->buf + len, oco->count);
+        }
+    }
+
+    if (!oco) {
+        output_pending_clear(who);
+        return 0;
+    }
+
     size_t written = 0;
     size_t notWritten = oco->count;
 
     /* do nothing if we haven't anything to write */
-    if (!notWritten)
+    if (!notWritten) {
+        output_pending_clear(who);
         return 0;
-
-    if (FlushCallback)
-        CallCallbacks(&FlushCallback, who);
+    }
 
     size_t todo = notWritten; /* trying to write that much this time */
     while (notWritten) {
@@ -970,11 +1563,15 @@ FlushClient(ClientPtr who, OsCommPtr oc)
     }
 
     /* everything was flushed out */
+#ifdef XSERVER_DTRACE
+    if (XSERVER_CLIENT_FLUSH_ENABLED())
+        XSERVER_CLIENT_FLUSH(who->index, (int) written);
+#endif
     oco->count = 0;
     output_pending_clear(who);
 
     if (oco->size > BUFWATERMARK) {
-        free(oco->buf);
+        ConnBufferPut(oco->buf, oco->size);
         free(oco);
     }
     else {
@@ -987,7 +1584,8 @@ FlushClient(ClientPtr who, OsCommPtr oc)
 abortClient:
     AbortClient(who);
     dixMarkClientException(who);
-    oco->count = 0;
+    if (oco)
+        oco->count = 0;
     return -1;
 }
 
@@ -997,7 +1595,7 @@ AllocateInputBuffer(void)
     ConnectionInputPtr oci = calloc(1, sizeof(ConnectionInput));
     if (!oci)
         return NULL;
-    oci->buffer = calloc(1, BUFSIZE);
+    oci->buffer = ConnBufferGet(BUFSIZE);
     if (!oci->buffer) {
         free(oci);
         return NULL;
@@ -1016,7 +1614,7 @@ AllocateOutputBuffer(void)
     ConnectionOutputPtr oco = calloc(1, sizeof(ConnectionOutput));
     if (!oco)
         return NULL;
-    oco->buf = calloc(1, BUFSIZE);
+    oco->buf = ConnBufferGet(BUFSIZE);
     if (!oco->buf) {
         free(oco);
         return NULL;
@@ -1031,12 +1629,18 @@ FreeOsBuffers(OsCommPtr oc)
 {
     ConnectionInputPtr oci;
     ConnectionOutputPtr oco;
+    ConnectionVecPtr vec;
 
+    while ((vec = oc->vecHead)) {
+        oc->vecHead = vec->next;
+        VecEntryRelease(vec);
+    }
+    oc->vecTail = NULL;
     if (AvailableInput == oc)
         AvailableInput = (OsCommPtr) NULL;
     if ((oci = oc->input)) {
         if (FreeInputs) {
-            free(oci->buffer);
+            ConnBufferPut(oci->buffer, oci->size);
             free(oci);
         }
         else {
@@ -1046,11 +1650,14 @@ FreeOsBuffers(OsCommPtr oc)
             oci->bufcnt = 0;
             oci->lenLastReq = 0;
             oci->ignoreBytes = 0;
+            oci->reqIndexHead = oci->reqIndexCount = 0;
+            oci->streamHdrLen = 0;
+            oci->streamChunk = 0;
         }
     }
     if ((oco = oc->output)) {
         if (FreeOutputs) {
-            free(oco->buf);
+            ConnBufferPut(oco->buf, oco->size);
             free(oco);
         }
         else {
@@ -1077,4 +1684,5 @@ ResetOsBuffers(void)
         free(oco->buf);
         free(oco);
     }
+    ConnBufferTrim();
 }
@@ -9,15 +9,23 @@
 
 #include "include/dix.h" /* ClientPtr */
 
+#include "os/auth.h" /* LocalClientCredRec */
+
 struct _XtransConnInfo;
 
 typedef struct _connectionInput *ConnectionInputPtr;
 typedef struct _connectionOutput *ConnectionOutputPtr;
+typedef struct _connectionVec *ConnectionVecPtr;
 
 typedef struct {
     int fd;
     ConnectionInputPtr input;
     ConnectionOutputPtr output;
+    ConnectionVecPtr vecHead;   /* queued zero-copy reply segments (FIFO) */
+    ConnectionVecPtr vecTail;
+    int corkPasses;             /* flush passes a sub-MTU buffer was held */
+    LocalClientCredRec *peerCreds;      /* resolved once per connection */
+    Bool peerCredsTried;
     XID auth_id;
     CARD32 conn_time;
     struct _XtransConnInfo *trans_conn;
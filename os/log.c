@@ -93,6 +93,11 @@ OR PERFORMANCE OF THIS SOFTWARE.
 #include <syslog.h>
 #endif
 
+#if INPUTTHREAD
+#include <pthread.h>
+#include <signal.h>
+#endif
+
 #include "dix/dix_priv.h"
 #include "dix/input_priv.h"
 #include "os/audit_priv.h"
@@ -117,8 +122,11 @@ OR PERFORMANCE OF THIS SOFTWARE.
 #define DEFAULT_LOG_FILE_VERBOSITY	3
 #define DEFAULT_SYSLOG_VERBOSITY	0
 
+#define LOG_MSG_BUF_SIZE 1024
+
 static int logFileFd = -1;
 Bool xorgLogSync = FALSE;
+Bool xorgLogAsync = FALSE;
 int xorgLogVerbosity = DEFAULT_LOG_VERBOSITY;
 int xorgLogFileVerbosity = DEFAULT_LOG_FILE_VERBOSITY;
 #ifdef CONFIG_SYSLOG
@@ -295,6 +303,197 @@ LogWrite(int fd, const void * buf, size_t len)
 
 }
 
+#if INPUTTHREAD
+
+/*
+ * Optional asynchronous log file writing (Option "Log" "async").
+ *
+ * With slow log storage (NFS homes, worn flash, busy spinning disks) the
+ * synchronous write() in LogSWrite can stall the thread producing the
+ * message -- usually the dispatch thread -- for tens of milliseconds.
+ * When async mode is enabled, log file writes are instead copied into a
+ * fixed ring of pre-sized entries and drained by a dedicated writer
+ * thread, so the producer only pays for a memcpy.
+ *
+ * The ring is a bounded MPSC queue: each entry carries a sequence ticket
+ * (Vyukov scheme), producers claim a slot with a compare-and-swap on the
+ * head index and publish it by advancing the ticket, and the writer thread
+ * is the only consumer.  When the ring is full the message is dropped and
+ * counted rather than blocking the producer; the writer logs the loss once
+ * there is room again.  FatalError and LogClose drain the ring and fall
+ * back to synchronous writes so the final messages reliably hit the disk.
+ * Signal-context messages bypass the ring entirely (see LogSWrite), since
+ * none of this machinery is async-signal-safe.
+ */
+
+#define LOG_RING_ENTRIES 128    /* power of two */
+#define LOG_RING_PAYLOAD (LOG_MSG_BUF_SIZE + 32)        /* message + timestamp */
+
+typedef struct {
+    CARD32 seq;                 /* sequence ticket, see above */
+    CARD16 len;
+    char buf[LOG_RING_PAYLOAD];
+} LogRingEntry;
+
+static LogRingEntry logRing[LOG_RING_ENTRIES];
+static CARD32 logRingHead;      /* next slot producers claim */
+static CARD32 logRingTail;      /* next slot the writer drains */
+static CARD32 logRingDropped;   /* messages lost to a full ring */
+static Bool logWriterRunning;
+static Bool logWriterIdle;
+static pthread_t logWriterThread;
+static pthread_mutex_t logRingMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t logRingWake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t logRingEmpty = PTHREAD_COND_INITIALIZER;
+
+static void *
+LogWriterThread(void *unused)
+{
+    sigset_t set;
+
+    /* leave signal handling to the main thread */
+    sigfillset(&set);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+#if defined(HAVE_PTHREAD_SETNAME_NP_WITH_TID)
+    pthread_setname_np(pthread_self(), "LogWriter");
+#elif defined(HAVE_PTHREAD_SETNAME_NP_WITHOUT_TID)
+    pthread_setname_np("LogWriter");
+#endif
+
+    for (;;) {
+        CARD32 tail = logRingTail;
+        LogRingEntry *entry = &logRing[tail & (LOG_RING_ENTRIES - 1)];
+        CARD32 dropped;
+
+        if (__atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE) == tail + 1) {
+            LogWrite(logFileFd, entry->buf, entry->len);
+            __atomic_store_n(&entry->seq, tail + LOG_RING_ENTRIES,
+                             __ATOMIC_RELEASE);
+            __atomic_store_n(&logRingTail, tail + 1, __ATOMIC_RELEASE);
+            if (xorgLogSync)
+                doLogSync();
+            continue;
+        }
+
+        /* account messages lost to overflow now that there is room again */
+        dropped = __atomic_exchange_n(&logRingDropped, 0, __ATOMIC_RELAXED);
+        if (dropped) {
+            char note[80];
+            int nlen = snprintf(note, sizeof(note),
+                                "(WW) async log ring overflowed, "
+                                "%u messages dropped\n", dropped);
+            LogWrite(logFileFd, note, nlen);
+            continue;
+        }
+
+        pthread_mutex_lock(&logRingMutex);
+        __atomic_store_n(&logWriterIdle, TRUE, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&logRing[logRingTail & (LOG_RING_ENTRIES - 1)].seq,
+                            __ATOMIC_ACQUIRE) != logRingTail + 1) {
+            pthread_cond_broadcast(&logRingEmpty);
+            pthread_cond_wait(&logRingWake, &logRingMutex);
+        }
+        __atomic_store_n(&logWriterIdle, FALSE, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&logRingMutex);
+    }
+    return NULL;
+}
+
+/* Start the writer thread on first use; FALSE means the caller must write
+ * synchronously. */
+static Bool
+LogAsyncStart(void)
+{
+    pthread_mutex_lock(&logRingMutex);
+    if (!logWriterRunning) {
+        int i;
+
+        for (i = 0; i < LOG_RING_ENTRIES; i++)
+            logRing[i].seq = i;
+        logRingHead = logRingTail = 0;
+
+        if (pthread_create(&logWriterThread, NULL, LogWriterThread, NULL) == 0)
+            logWriterRunning = TRUE;
+        else
+            xorgLogAsync = FALSE;       /* fall back to synchronous writes */
+    }
+    pthread_mutex_unlock(&logRingMutex);
+    return logWriterRunning;
+}
+
+/* Copy a log file write into the ring.  FALSE means the entry did not fit
+ * and the caller must write it synchronously; a dropped-on-overflow message
+ * still counts as consumed. */
+static Bool
+LogRingEnqueue(const char *prefix, size_t plen, const char *buf, size_t len)
+{
+    CARD32 head;
+    LogRingEntry *entry;
+
+    if (plen + len > LOG_RING_PAYLOAD)
+        return FALSE;
+
+    for (;;) {
+        CARD32 seq;
+
+        head = __atomic_load_n(&logRingHead, __ATOMIC_RELAXED);
+        entry = &logRing[head & (LOG_RING_ENTRIES - 1)];
+        seq = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE);
+        if (seq == head) {
+            if (__atomic_compare_exchange_n(&logRingHead, &head, head + 1,
+                                            FALSE, __ATOMIC_ACQ_REL,
+                                            __ATOMIC_RELAXED))
+                break;
+        }
+        else if ((INT32) (seq - head) < 0) {
+            /* ring full: count the loss rather than stall the producer */
+            __atomic_add_fetch(&logRingDropped, 1, __ATOMIC_RELAXED);
+            return TRUE;
+        }
+        /* else another producer claimed the slot under us, retry */
+    }
+
+    if (plen)
+        memcpy(entry->buf, prefix, plen);
+    memcpy(entry->buf + plen, buf, len);
+    entry->len = plen + len;
+    __atomic_store_n(&entry->seq, head + 1, __ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&logWriterIdle, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&logRingMutex);
+        pthread_cond_signal(&logRingWake);
+        pthread_mutex_unlock(&logRingMutex);
+    }
+    return TRUE;
+}
+
+/* Flush all queued writes and revert to synchronous logging.  Called before
+ * fatal messages and on log close; must not be called from signal context. */
+static void
+LogAsyncSuspend(void)
+{
+    if (!logWriterRunning)
+        return;
+
+    xorgLogAsync = FALSE;
+
+    pthread_mutex_lock(&logRingMutex);
+    while (__atomic_load_n(&logRingTail, __ATOMIC_ACQUIRE) !=
+           __atomic_load_n(&logRingHead, __ATOMIC_ACQUIRE) ||
+           __atomic_load_n(&logRingDropped, __ATOMIC_RELAXED)) {
+        pthread_cond_signal(&logRingWake);
+        pthread_cond_wait(&logRingEmpty, &logRingMutex);
+    }
+    pthread_mutex_unlock(&logRingMutex);
+}
+
+#else /* INPUTTHREAD */
+
+#define LogAsyncSuspend()       /* synchronous writes only */
+
+#endif /* INPUTTHREAD */
+
 /*
  * LogInit is called to start logging to a file.  It is also called (with
  * NULL arguments) when logging to a file is not wanted.  It must always be
@@ -390,6 +589,7 @@ LogSetDisplay(void)
 void
 LogClose(enum ExitCode error)
 {
+    LogAsyncSuspend();
     if (logFileFd != -1) {
         int msgtype = (error == EXIT_NO_ERROR) ? X_INFO : X_ERROR;
         LogMessageVerb(msgtype, -1,
@@ -664,11 +864,12 @@ LogSWrite(int verb, const char *buf, size_t len, Bool end_line)
             }
         }
         else if (!inSignalContext && logFileFd != -1) {
+            char fmt_tm[32];
+            size_t fmt_len = 0;
+
             if (newline) {
                 time_t t = time(NULL);
                 struct tm tm;
-                char fmt_tm[32];
-                size_t fmt_len;
 
                 localtime_r(&t, &tm);
                 fmt_len = strftime(
@@ -676,9 +877,15 @@ LogSWrite(int verb, const char *buf, size_t len, Bool end_line)
                                 sizeof(fmt_tm),
                                 "[%Y-%m-%d %H:%M:%S] ",
                                 &tm);
-                LogWrite(logFileFd, fmt_tm, fmt_len);
             }
             newline = end_line;
+#if INPUTTHREAD
+            if (xorgLogAsync && (logWriterRunning || LogAsyncStart()) &&
+                LogRingEnqueue(fmt_tm, fmt_len, buf, len))
+                return;
+#endif
+            if (fmt_len)
+                LogWrite(logFileFd, fmt_tm, fmt_len);
             LogWrite(logFileFd, buf, len);
             if (xorgLogSync) {
                 doLogSync();
@@ -741,8 +948,6 @@ LogMessageTypeVerbString(MessageType type, int verb)
     }
 }
 
-#define LOG_MSG_BUF_SIZE 1024
-
 static ssize_t prepMsgHdr(MessageType type, int verb, char *buf)
 {
     const char *type_str = LogMessageTypeVerbString(type, verb);
@@ -949,6 +1154,11 @@ FatalError(const char *f, ...)
     va_list args2;
     static Bool beenhere = FALSE;
 
+    /* flush queued log writes and revert to synchronous logging so the
+     * fatal message reliably reaches the log file */
+    if (!inSignalContext)
+        LogAsyncSuspend();
+
     if (beenhere)
         ErrorF("\nFatalError re-entered, aborting\n");
     else
@@ -72,6 +72,17 @@ extern int xorgLogFileVerbosity;
  */
 extern Bool xorgLogSync;
 
+/**
+ * @brief write log file messages from a dedicated thread
+ *
+ * If set to TRUE, log file writes are queued to a ring drained by a
+ * separate writer thread instead of blocking the caller, so slow log
+ * storage cannot stall the dispatch loop. Messages that don't fit into
+ * the ring are dropped (and the loss accounted in the log). Has no
+ * effect when the server is built without thread support.
+ */
+extern Bool xorgLogAsync;
+
 /**
  * @brief syslog verbosity
  *
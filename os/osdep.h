@@ -136,6 +136,10 @@ OsSigHandlerPtr OsSignal(int sig, OsSigHandlerPtr handler);
 
 void OsInit(void);
 
+/* log and reset the per-source wakeup counters kept by WaitForSomething;
+   part of the SIGUSR2 statistics dump */
+void WakeupStatsDump(void);
+
 _X_EXPORT /* needed by the int10 module, but should not be used by OOT drivers */
 void OsBlockSignals(void);
 
@@ -50,6 +50,15 @@
 #define HAVE_OSPOLL     1
 #endif
 
+#if !HAVE_OSPOLL && defined(HAVE_EPOLL_CREATE1) && defined(HAVE_LIBURING)
+#include <liburing.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#define URING           1
+#define EPOLL           1
+#define HAVE_OSPOLL     1
+#endif
+
 #if !HAVE_OSPOLL && defined(HAVE_EPOLL_CREATE1)
 #include <sys/epoll.h>
 #define EPOLL           1
@@ -93,6 +102,10 @@ struct ospollfd {
     void                (*callback)(int fd, int xevents, void *data);
     void                *data;
     struct xorg_list    deleted;
+#if URING
+    unsigned            inflight;       /* SQEs submitted, CQE not yet seen */
+    unsigned            polls;          /* outstanding single-shot polls */
+#endif
 };
 
 struct ospoll {
@@ -101,6 +114,10 @@ struct ospoll {
     int                 num;
     int                 size;
     struct xorg_list    deleted;
+#if URING
+    struct io_uring     ring;
+    bool                use_uring;
+#endif
 };
 
 #endif
@@ -163,12 +180,145 @@ ospoll_clean_deleted(struct ospoll *ospoll)
     struct ospollfd     *osfd, *tmp;
 
     xorg_list_for_each_entry_safe(osfd, tmp, &ospoll->deleted, deleted) {
+#if URING
+        /* completions for cancelled polls may still be in the ring */
+        if (osfd->inflight)
+            continue;
+#endif
         xorg_list_del(&osfd->deleted);
         free(osfd);
     }
 }
 #endif
 
+#if URING
+
+/* io_uring flavour of the epoll backend, selected at runtime.
+ *
+ * Readiness is collected through single-shot IORING_OP_POLL_ADD requests,
+ * so arming any number of fds and reaping all their completions costs a
+ * single io_uring_enter() per dispatch cycle instead of one epoll_ctl()
+ * per fd plus an epoll_wait().  Re-arming follows the same points where
+ * the epoll backend relies on EPOLLET: ospoll_listen(), ospoll_mute() and
+ * ospoll_reset_events() for edge-triggered fds, completion delivery for
+ * level-triggered ones.
+ */
+
+#define URING_ENTRIES   256
+
+/* poll-remove SQEs carry the osfd pointer tagged with this bit so their
+ * completions can be told apart from poll readiness */
+#define URING_TAG_REMOVE ((uintptr_t) 1)
+
+static struct io_uring_sqe *
+uring_get_sqe(struct ospoll *ospoll)
+{
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&ospoll->ring);
+
+    if (!sqe) {
+        io_uring_submit(&ospoll->ring);
+        sqe = io_uring_get_sqe(&ospoll->ring);
+    }
+    return sqe;
+}
+
+static unsigned
+uring_poll_mask(struct ospollfd *osfd)
+{
+    unsigned mask = 0;
+
+    if (osfd->xevents & X_NOTIFY_READ)
+        mask |= POLLIN;
+    if (osfd->xevents & X_NOTIFY_WRITE)
+        mask |= POLLOUT;
+    return mask;
+}
+
+/* Re-arm the single-shot poll for osfd to match osfd->xevents.  SQEs are
+ * only queued here; they are submitted in bulk by ospoll_wait().
+ */
+static void
+uring_update(struct ospoll *ospoll, struct ospollfd *osfd)
+{
+    struct io_uring_sqe *sqe;
+
+    if (osfd->polls) {
+        sqe = uring_get_sqe(ospoll);
+        if (!sqe)
+            return;
+        io_uring_prep_poll_remove(sqe, (uintptr_t) osfd);
+        io_uring_sqe_set_data(sqe, (void *) ((uintptr_t) osfd | URING_TAG_REMOVE));
+        osfd->inflight++;
+    }
+    if (uring_poll_mask(osfd)) {
+        sqe = uring_get_sqe(ospoll);
+        if (!sqe)
+            return;
+        io_uring_prep_poll_add(sqe, osfd->fd, uring_poll_mask(osfd));
+        io_uring_sqe_set_data(sqe, osfd);
+        osfd->inflight++;
+        osfd->polls++;
+    }
+}
+
+static int
+uring_wait(struct ospoll *ospoll, int timeout)
+{
+    struct __kernel_timespec ts = {
+        .tv_sec = timeout / 1000,
+        .tv_nsec = (timeout % 1000) * 1000000
+    };
+    struct io_uring_cqe *cqe;
+    unsigned head;
+    unsigned handled = 0;
+    int nready = 0;
+
+    (void) io_uring_submit_and_wait_timeout(&ospoll->ring, &cqe, 1,
+                                            timeout < 0 ? NULL : &ts, NULL);
+
+    io_uring_for_each_cqe(&ospoll->ring, head, cqe) {
+        uintptr_t data = (uintptr_t) io_uring_cqe_get_data(cqe);
+        struct ospollfd *osfd =
+            (struct ospollfd *) (data & ~URING_TAG_REMOVE);
+
+        handled++;
+        if (!osfd)
+            continue;
+        osfd->inflight--;
+        if (data & URING_TAG_REMOVE)
+            continue;
+
+        /* completion of a single-shot poll: armed no longer */
+        osfd->polls--;
+        if (cqe->res <= 0)
+            continue;
+
+        int revents = cqe->res;
+        int xevents = 0;
+
+        if (revents & POLLIN)
+            xevents |= X_NOTIFY_READ;
+        if (revents & POLLOUT)
+            xevents |= X_NOTIFY_WRITE;
+        if (revents & (~(POLLIN|POLLOUT)))
+            xevents |= X_NOTIFY_ERROR;
+
+        nready++;
+        if (osfd->callback)
+            osfd->callback(osfd->fd, xevents, osfd->data);
+
+        /* level-triggered fds behave as if re-armed by the kernel */
+        if (osfd->trigger == ospoll_trigger_level && osfd->callback)
+            uring_update(ospoll, osfd);
+    }
+    io_uring_cq_advance(&ospoll->ring, handled);
+
+    ospoll_clean_deleted(ospoll);
+    return nready;
+}
+
+#endif /* URING */
+
 /* Insert an element into an array
  *
  * base: base address of array
@@ -231,6 +381,17 @@ ospoll_create(void)
     struct ospoll *ospoll = calloc(1, sizeof (struct ospoll));
     if (ospoll == NULL)
         return NULL;
+#if URING
+    /* runtime selection: prefer io_uring, fall back to epoll when the
+     * kernel lacks it or the user opted out */
+    if (!getenv("XSERVER_NO_IO_URING") &&
+        io_uring_queue_init(URING_ENTRIES, &ospoll->ring, 0) == 0) {
+        ospoll->use_uring = true;
+        ospoll->epoll_fd = -1;
+        xorg_list_init(&ospoll->deleted);
+        return ospoll;
+    }
+#endif
     ospoll->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
     if (ospoll->epoll_fd < 0) {
         free (ospoll);
@@ -258,6 +419,17 @@ ospoll_destroy(struct ospoll *ospoll)
 #if EPOLL || PORT
     if (ospoll) {
         assert (ospoll->num == 0);
+#if URING
+        if (ospoll->use_uring) {
+            struct ospollfd *osfd, *tmp;
+
+            io_uring_queue_exit(&ospoll->ring);
+            /* the ring is gone, no completions are outstanding anymore */
+            xorg_list_for_each_entry_safe(osfd, tmp, &ospoll->deleted, deleted)
+                osfd->inflight = 0;
+        }
+        else
+#endif
         close(ospoll->epoll_fd);
         ospoll_clean_deleted(ospoll);
         free(ospoll->fds);
@@ -368,6 +540,10 @@ ospoll_add(struct ospoll *ospoll, int fd,
         ev.data.ptr = osfd;
         if (trigger == ospoll_trigger_edge)
             ev.events |= EPOLLET;
+#if URING
+        /* io_uring polls are armed on ospoll_listen() */
+        if (!ospoll->use_uring)
+#endif
         if (epoll_ctl(ospoll->epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
             free(osfd);
             return false;
@@ -451,6 +627,13 @@ ospoll_remove(struct ospoll *ospoll, int fd)
         struct epoll_event ev;
         ev.events = 0;
         ev.data.ptr = osfd;
+#if URING
+        if (ospoll->use_uring) {
+            osfd->xevents = 0;
+            uring_update(ospoll, osfd);
+        }
+        else
+#endif
         (void) epoll_ctl(ospoll->epoll_fd, EPOLL_CTL_DEL, fd, &ev);
 
         array_delete(ospoll->fds, ospoll->num, sizeof (ospoll->fds[0]), pos);
@@ -486,6 +669,12 @@ static void
 epoll_mod(struct ospoll *ospoll, struct ospollfd *osfd)
 {
     struct epoll_event ev;
+#if URING
+    if (ospoll->use_uring) {
+        uring_update(ospoll, osfd);
+        return;
+    }
+#endif
     ev.events = 0;
     if (osfd->xevents & X_NOTIFY_READ)
         ev.events |= EPOLLIN;
@@ -645,6 +834,10 @@ ospoll_wait(struct ospoll *ospoll, int timeout)
     struct epoll_event events[MAX_EVENTS];
     int i;
 
+#if URING
+    if (ospoll->use_uring)
+        return uring_wait(ospoll, timeout);
+#endif
     nready = epoll_wait(ospoll->epoll_fd, events, MAX_EVENTS, timeout);
     for (i = 0; i < nready; i++) {
         struct epoll_event *ev = &events[i];
@@ -718,6 +911,19 @@ ospoll_reset_events(struct ospoll *ospoll, int fd)
 
     epoll_mod(ospoll, ospoll->fds[pos]);
 #endif
+#if URING
+    /* edge-triggered fds disarm on completion; re-arm here, where the
+     * epoll backend relies on EPOLLET re-firing */
+    if (ospoll->use_uring) {
+        int pos = ospoll_find(ospoll, fd);
+
+        if (pos < 0)
+            return;
+
+        if (!ospoll->fds[pos]->polls)
+            uring_update(ospoll, ospoll->fds[pos]);
+    }
+#endif
 #if POLL
     int pos = ospoll_find(ospoll, fd);
 
@@ -55,3 +55,17 @@ int ossock_wouldblock(int err)
     return ((err == EAGAIN) || (err == EWOULDBLOCK));
 #endif
 }
+
+int ossock_nonblock(int fd)
+{
+#ifdef WIN32
+    u_long on = 1;
+    int ret = ioctlsocket(fd, FIONBIO, &on);
+    if (ret == SOCKET_ERROR)
+        errno = WSAGetLastError();
+    return ret;
+#else
+    int on = 1;
+    return ioctl(fd, FIONBIO, &on);
+#endif
+}
@@ -27,4 +27,9 @@ int ossock_close(int fd);
  */
 int ossock_wouldblock(int err);
 
+/*
+ * os specific switch of a socket into non-blocking mode
+ */
+int ossock_nonblock(int fd);
+
 #endif /* _XSERVER_OS_OSSOCK_H_ */
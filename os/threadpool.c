@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * Fork-join worker pool, see include/threadpool.h for the rationale.
+ */
+#include <dix-config.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#if INPUTTHREAD
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include "include/threadpool.h"
+#include "os/osdep.h"
+
+#if INPUTTHREAD
+
+/* keep a lid on wakeup cost for the small tile counts we hand out */
+#define THREADPOOL_MAX_WORKERS 8
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+
+static int pool_workers = -1;   /* -1: not yet initialized */
+
+/* current batch, all guarded by pool_mutex */
+static ThreadPoolFunc pool_func;
+static void *pool_arg;
+static int pool_count;          /* slots in the batch */
+static int pool_next;           /* next slot to hand out */
+static int pool_running;        /* slots currently executing */
+
+static void *
+ThreadPoolWorker(void *unused)
+{
+    sigset_t set;
+
+    /* leave signal handling to the main thread */
+    sigfillset(&set);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+#if defined(HAVE_PTHREAD_SETNAME_NP_WITH_TID)
+    pthread_setname_np(pthread_self(), "PoolWorker");
+#elif defined(HAVE_PTHREAD_SETNAME_NP_WITHOUT_TID)
+    pthread_setname_np("PoolWorker");
+#endif
+
+    pthread_mutex_lock(&pool_mutex);
+    for (;;) {
+        while (pool_next >= pool_count)
+            pthread_cond_wait(&pool_wake, &pool_mutex);
+
+        while (pool_next < pool_count) {
+            int slot = pool_next++;
+
+            pool_running++;
+            pthread_mutex_unlock(&pool_mutex);
+            pool_func(pool_arg, slot);
+            pthread_mutex_lock(&pool_mutex);
+            pool_running--;
+        }
+        if (!pool_running)
+            pthread_cond_broadcast(&pool_done);
+    }
+    return NULL;
+}
+
+static void
+ThreadPoolInit(void)
+{
+    long ncpu;
+
+    pool_workers = 0;
+    if (getenv("XSERVER_NO_THREADPOOL"))
+        return;
+
+    ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 2)
+        return;
+    if (ncpu > THREADPOOL_MAX_WORKERS)
+        ncpu = THREADPOOL_MAX_WORKERS;
+
+    for (long i = 0; i < ncpu; i++) {
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, ThreadPoolWorker, NULL) != 0)
+            break;
+        pool_workers++;
+    }
+}
+
+int
+ThreadPoolWorkers(void)
+{
+    if (pool_workers < 0)
+        ThreadPoolInit();
+    return pool_workers;
+}
+
+void
+ThreadPoolRun(ThreadPoolFunc func, void *arg, int count)
+{
+    if (count <= 0)
+        return;
+
+    if (ThreadPoolWorkers() == 0 || count == 1) {
+        for (int slot = 0; slot < count; slot++)
+            func(arg, slot);
+        return;
+    }
+
+    pthread_mutex_lock(&pool_mutex);
+    pool_func = func;
+    pool_arg = arg;
+    pool_count = count;
+    pool_next = 0;
+    pthread_cond_broadcast(&pool_wake);
+
+    /* chip in instead of idling */
+    while (pool_next < pool_count) {
+        int slot = pool_next++;
+
+        pool_running++;
+        pthread_mutex_unlock(&pool_mutex);
+        func(arg, slot);
+        pthread_mutex_lock(&pool_mutex);
+        pool_running--;
+    }
+    while (pool_running)
+        pthread_cond_wait(&pool_done, &pool_mutex);
+    pool_count = 0;
+    pthread_mutex_unlock(&pool_mutex);
+}
+
+#else /* !INPUTTHREAD */
+
+int
+ThreadPoolWorkers(void)
+{
+    return 0;
+}
+
+void
+ThreadPoolRun(ThreadPoolFunc func, void *arg, int count)
+{
+    for (int slot = 0; slot < count; slot++)
+        func(arg, slot);
+}
+
+#endif /* INPUTTHREAD */
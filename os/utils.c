@@ -104,6 +104,10 @@ __stdcall unsigned long GetTickCount(void);
 
 #include "dix/dix_priv.h"
 #include "dix/input_priv.h"
+#include "dix/reqcapture_priv.h"
+#include "dix/reqprof_priv.h"
+#include "dix/resacct_priv.h"
+#include "miext/damage/damagestr.h"
 #include "dix/settings_priv.h"
 #include "dix/screensaver_priv.h"
 #include "miext/extinit_priv.h"
@@ -323,6 +327,10 @@ UseMsg(void)
     ErrorF("-xinerama              Disable XINERAMA extension\n");
 #endif /* XINERAMA */
     ErrorF("-dumbSched             Disable smart scheduling and threaded input, enable old behavior\n");
+    ErrorF("-requestcapture file   capture the request stream for replay with xreplay\n");
+    ErrorF("-requestprofile        profile requests per opcode, dump with SIGUSR2\n");
+    ErrorF("-clientmemwarn MB      log clients holding more resource memory (0 disables)\n");
+    ErrorF("-damageheatmap         accumulate per-tile damage frequency, dump with SIGUSR2\n");
     ErrorF("-schedInterval int     Set scheduler interval in msec\n");
     ErrorF("+extension name        Enable extension\n");
     ErrorF("-extension name        Disable extension\n");
@@ -727,9 +735,24 @@ ProcessCommandLine(int argc, char *argv[])
 #endif
         else if (strcmp(argv[i], "-dumbSched") == 0) {
             InputThreadEnable = FALSE;
-#ifdef HAVE_SETITIMER
-            SmartScheduleSignalEnable = FALSE;
-#endif
+        }
+        else if (strcmp(argv[i], "-requestcapture") == 0) {
+            if (++i < argc)
+                RequestCaptureFile = argv[i];
+            else
+                UseMsg();
+        }
+        else if (strcmp(argv[i], "-requestprofile") == 0) {
+            RequestProfileActive = TRUE;
+        }
+        else if (strcmp(argv[i], "-clientmemwarn") == 0) {
+            if (++i < argc)
+                ResourceAccountWarnMB = atol(argv[i]);
+            else
+                UseMsg();
+        }
+        else if (strcmp(argv[i], "-damageheatmap") == 0) {
+            DamageHeatmapActive = TRUE;
         }
         else if (strcmp(argv[i], "-schedInterval") == 0) {
             if (++i < argc) {
@@ -854,92 +877,13 @@ set_font_authorizations(char **authorizations, int *authlen, void *client)
     return 1;
 }
 
-void
-SmartScheduleStopTimer(void)
-{
-#ifdef HAVE_SETITIMER
-    struct itimerval timer;
-
-    if (!SmartScheduleSignalEnable)
-        return;
-    timer.it_interval.tv_sec = 0;
-    timer.it_interval.tv_usec = 0;
-    timer.it_value.tv_sec = 0;
-    timer.it_value.tv_usec = 0;
-    (void) setitimer(ITIMER_REAL, &timer, 0);
-#endif
-}
-
-void
-SmartScheduleStartTimer(void)
-{
-#ifdef HAVE_SETITIMER
-    struct itimerval timer;
-
-    if (!SmartScheduleSignalEnable)
-        return;
-    timer.it_interval.tv_sec = 0;
-    timer.it_interval.tv_usec = SmartScheduleInterval * 1000;
-    timer.it_value.tv_sec = 0;
-    timer.it_value.tv_usec = SmartScheduleInterval * 1000;
-    setitimer(ITIMER_REAL, &timer, 0);
-#endif
-}
-
-#ifdef HAVE_SETITIMER
-static void
-SmartScheduleTimer(int sig)
-{
-    SmartScheduleTime += SmartScheduleInterval;
-}
-
-static int
-SmartScheduleEnable(void)
-{
-    int ret = 0;
-    struct sigaction act;
-
-    if (!SmartScheduleSignalEnable)
-        return 0;
-
-    memset((char *) &act, 0, sizeof(struct sigaction));
-
-    /* Set up the timer signal function */
-    act.sa_flags = SA_RESTART;
-    act.sa_handler = SmartScheduleTimer;
-    sigemptyset(&act.sa_mask);
-    sigaddset(&act.sa_mask, SIGALRM);
-    ret = sigaction(SIGALRM, &act, 0);
-    return ret;
-}
-
-static int
-SmartSchedulePause(void)
-{
-    int ret = 0;
-    struct sigaction act;
-
-    if (!SmartScheduleSignalEnable)
-        return 0;
-
-    memset((char *) &act, 0, sizeof(struct sigaction));
-
-    act.sa_handler = SIG_IGN;
-    sigemptyset(&act.sa_mask);
-    ret = sigaction(SIGALRM, &act, 0);
-    return ret;
-}
-#endif
-
 void
 SmartScheduleInit(void)
 {
-#ifdef HAVE_SETITIMER
-    if (SmartScheduleEnable() < 0) {
-        perror("sigaction for smart scheduler");
-        SmartScheduleSignalEnable = FALSE;
-    }
-#endif
+    /* Slice accounting is driven by monotonic clock reads in the
+     * Dispatch loop; no SIGALRM tick to install.  Just give the
+     * scheduler a sane starting timestamp. */
+    SmartScheduleTime = GetTimeInMillis();
 }
 
 #ifdef HAVE_SIGPROCMASK
@@ -1047,26 +991,11 @@ Popen(const char *command, const char *type)
         return NULL;
     }
 
-    /* Ignore the smart scheduler while this is going on */
-#ifdef HAVE_SETITIMER
-    if (SmartSchedulePause() < 0) {
-        close(pdes[0]);
-        close(pdes[1]);
-        free(cur);
-        perror("signal");
-        return NULL;
-    }
-#endif
-
     switch (pid = fork()) {
     case -1:                   /* error */
         close(pdes[0]);
         close(pdes[1]);
         free(cur);
-#ifdef HAVE_SETITIMER
-        if (SmartScheduleEnable() < 0)
-            perror("signal");
-#endif
         return NULL;
     case 0:                    /* child */
         if (setgid(getgid()) == -1)
@@ -1169,13 +1098,6 @@ Pclose(void *iop)
     /* allow EINTR again */
     OsReleaseSignals();
 
-#ifdef HAVE_SETITIMER
-    if (SmartScheduleEnable() < 0) {
-        perror("signal");
-        return -1;
-    }
-#endif
-
     return pid == -1 ? -1 : pstat;
 }
 
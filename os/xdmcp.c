@@ -184,7 +184,7 @@ static int get_mcast_options(int        argc,
                              int        i);
 #endif
 
-static void receive_packet(int socketfd);
+static Bool receive_packet(int socketfd);
 
 static void send_packet(void);
 
@@ -636,7 +636,10 @@ XdmcpSocketNotify(int fd, int ready, void *data)
 {
     if (state == XDM_OFF)
         return;
-    receive_packet(fd);
+    /* drain every queued datagram; broadcast/indirect queries can get
+     * several WILLING replies in one wakeup */
+    while (receive_packet(fd) && state != XDM_OFF)
+        ;
 }
 
 static CARD32
@@ -688,7 +691,7 @@ XdmcpAddHost(const struct sockaddr *from,
 
 static ARRAY8 UnwillingMessage = { (CARD8) 14, (CARD8 *) "Host unwilling" };
 
-static void
+static Bool
 receive_packet(int socketfd)
 {
 #if defined(IPv6)
@@ -699,18 +702,19 @@ receive_packet(int socketfd)
     int fromlen = sizeof(from);
     XdmcpHeader header;
 
-    /* read message off socket */
+    /* read message off socket; the socket is non-blocking, so this
+     * simply fails when the queue is drained */
     if (!XdmcpFill(socketfd, &buffer, (XdmcpNetaddr) &from, &fromlen))
-        return;
+        return FALSE;
 
     /* reset retransmission backoff */
     timeOutRtx = 0;
 
     if (!XdmcpReadHeader(&buffer, &header))
-        return;
+        return TRUE;
 
     if (header.version != XDM_PROTOCOL_VERSION)
-        return;
+        return TRUE;
 
     switch (header.opcode) {
     case WILLING:
@@ -735,6 +739,7 @@ receive_packet(int socketfd)
         recv_alive_msg(header.length);
         break;
     }
+    return TRUE;
 }
 
 /*
@@ -897,9 +902,13 @@ get_xdmcp_sock(void)
 #if defined(IPv6)
     if ((xdmcpSocket6 = socket(AF_INET6, SOCK_DGRAM, 0)) < 0)
         XdmcpWarning("INET6 UDP socket creation failed");
+    else if (ossock_nonblock(xdmcpSocket6) < 0)
+        XdmcpWarning("INET6 UDP set non-blocking failed");
 #endif
     if ((xdmcpSocket = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
         XdmcpWarning("UDP socket creation failed");
+    else if (ossock_nonblock(xdmcpSocket) < 0)
+        XdmcpWarning("UDP set non-blocking failed");
 #ifdef SO_BROADCAST
     else if (setsockopt(xdmcpSocket, SOL_SOCKET, SO_BROADCAST, (char *) &soopts,
                         sizeof(soopts)) < 0)
@@ -0,0 +1,129 @@
+/*
+ * SipHash-2-4-128, after the reference implementation by Jean-Philippe
+ * Aumasson and Daniel J. Bernstein (public domain / CC0).
+ */
+
+#include <dix-config.h>
+
+#include <string.h>
+
+#include "os/xsiphash.h"
+
+#define ROTL64(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v)                                                     \
+    do {                                                                \
+        v[0] += v[1]; v[1] = ROTL64(v[1], 13);                          \
+        v[1] ^= v[0]; v[0] = ROTL64(v[0], 32);                          \
+        v[2] += v[3]; v[3] = ROTL64(v[3], 16);                          \
+        v[3] ^= v[2];                                                   \
+        v[0] += v[3]; v[3] = ROTL64(v[3], 21);                          \
+        v[3] ^= v[0];                                                   \
+        v[2] += v[1]; v[1] = ROTL64(v[1], 17);                          \
+        v[1] ^= v[2]; v[2] = ROTL64(v[2], 32);                          \
+    } while (0)
+
+static inline uint64_t
+load_le64(const unsigned char *p)
+{
+    return (uint64_t) p[0] |
+        ((uint64_t) p[1] << 8) |
+        ((uint64_t) p[2] << 16) |
+        ((uint64_t) p[3] << 24) |
+        ((uint64_t) p[4] << 32) |
+        ((uint64_t) p[5] << 40) |
+        ((uint64_t) p[6] << 48) |
+        ((uint64_t) p[7] << 56);
+}
+
+static inline void
+store_le64(unsigned char *p, uint64_t x)
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+        p[i] = (unsigned char) (x >> (8 * i));
+}
+
+static inline void
+siphash_block(uint64_t v[4], uint64_t m)
+{
+    v[3] ^= m;
+    SIPROUND(v);
+    SIPROUND(v);
+    v[0] ^= m;
+}
+
+void
+x_siphash_init(x_siphash_ctx * ctx, const unsigned char key[16])
+{
+    uint64_t k0 = load_le64(key);
+    uint64_t k1 = load_le64(key + 8);
+
+    ctx->v[0] = UINT64_C(0x736f6d6570736575) ^ k0;
+    ctx->v[1] = UINT64_C(0x646f72616e646f6d) ^ k1;
+    ctx->v[2] = UINT64_C(0x6c7967656e657261) ^ k0;
+    ctx->v[3] = UINT64_C(0x7465646279746573) ^ k1;
+    ctx->v[1] ^= 0xee;          /* 128-bit output variant */
+    ctx->total = 0;
+    ctx->buflen = 0;
+}
+
+void
+x_siphash_update(x_siphash_ctx * ctx, const void *data, size_t size)
+{
+    const unsigned char *p = data;
+
+    ctx->total += size;
+
+    if (ctx->buflen) {
+        unsigned int fill = 8 - ctx->buflen;
+
+        if (fill > size)
+            fill = size;
+        memcpy(ctx->buf + ctx->buflen, p, fill);
+        ctx->buflen += fill;
+        p += fill;
+        size -= fill;
+        if (ctx->buflen < 8)
+            return;
+        siphash_block(ctx->v, load_le64(ctx->buf));
+        ctx->buflen = 0;
+    }
+
+    while (size >= 8) {
+        siphash_block(ctx->v, load_le64(p));
+        p += 8;
+        size -= 8;
+    }
+
+    if (size) {
+        memcpy(ctx->buf, p, size);
+        ctx->buflen = size;
+    }
+}
+
+void
+x_siphash_final(x_siphash_ctx * ctx, unsigned char result[16])
+{
+    uint64_t b = (uint64_t) (ctx->total & 0xff) << 56;
+    unsigned int i;
+
+    for (i = 0; i < ctx->buflen; i++)
+        b |= (uint64_t) ctx->buf[i] << (8 * i);
+    siphash_block(ctx->v, b);
+
+    ctx->v[2] ^= 0xee;
+    SIPROUND(ctx->v);
+    SIPROUND(ctx->v);
+    SIPROUND(ctx->v);
+    SIPROUND(ctx->v);
+    store_le64(result, ctx->v[0] ^ ctx->v[1] ^ ctx->v[2] ^ ctx->v[3]);
+
+    ctx->v[1] ^= 0xdd;
+    SIPROUND(ctx->v);
+    SIPROUND(ctx->v);
+    SIPROUND(ctx->v);
+    SIPROUND(ctx->v);
+    store_le64(result + 8, ctx->v[0] ^ ctx->v[1] ^ ctx->v[2] ^ ctx->v[3]);
+}
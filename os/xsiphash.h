@@ -0,0 +1,29 @@
+#ifndef XSIPHASH_H
+#define XSIPHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * SipHash-2-4 with 128-bit output.  A keyed hash: without knowledge of
+ * the key, collisions cannot be constructed, which makes it a fast
+ * substitute for cryptographic digests wherever the key stays inside
+ * the server.  The context lives on the caller's stack; no allocation
+ * is involved.
+ */
+
+typedef struct {
+    uint64_t v[4];
+    uint64_t total;
+    unsigned char buf[8];
+    unsigned int buflen;
+} x_siphash_ctx;
+
+void x_siphash_init(x_siphash_ctx * ctx, const unsigned char key[16]);
+
+void x_siphash_update(x_siphash_ctx * ctx, const void *data, size_t size);
+
+/* Place the 128-bit hash in result.  The context must not be reused. */
+void x_siphash_final(x_siphash_ctx * ctx, unsigned char result[16]);
+
+#endif
@@ -118,6 +118,17 @@ present_execute_copy(present_vblank_ptr vblank, uint64_t crtc_msc)
         return;
     }
 
+    /* Restrict the copy to the client's valid region: contents outside
+     * it are undefined, and for near-miss flip cases (window slightly
+     * smaller than the screen) it is much smaller than the pixmap.
+     */
+    if (vblank->valid) {
+        if (vblank->update)
+            RegionIntersect(vblank->update, vblank->update, vblank->valid);
+        else
+            vblank->update = RegionDuplicate(vblank->valid);
+    }
+
     present_copy_region(&window->drawable, vblank->pixmap, vblank->update, vblank->x_off, vblank->y_off);
 
     /* present_copy_region sticks the region into a scratch GC,
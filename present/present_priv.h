@@ -87,12 +87,15 @@ struct present_vblank {
     present_notify_ptr  notifies;
     int                 num_notifies;
     Bool                queued;         /* on present_exec_queue */
+    Bool                own_msc_event;  /* owns a kernel vblank event; others piggyback */
+    uint64_t            queued_msc;     /* MSC the kernel vblank event was queued for */
     Bool                flip;           /* planning on using flip */
     Bool                flip_ready;     /* wants to flip, but waiting for previous flip or unflip */
     Bool                sync_flip;      /* do flip synchronous to vblank */
     Bool                abort_flip;     /* aborting this flip */
     PresentFlipReason   reason;         /* reason for which flip is not possible */
     Bool                has_suboptimal; /* whether client can support SuboptimalCopy mode */
+    CARD32              submit_ms;      /* wall clock when the request arrived */
 #ifdef DRI3
     struct dri3_syncobj *acquire_syncobj;
     struct dri3_syncobj *release_syncobj;
@@ -105,6 +108,22 @@ struct present_vblank {
 typedef struct present_screen_priv present_screen_priv_rec, *present_screen_priv_ptr;
 typedef struct present_window_priv present_window_priv_rec, *present_window_priv_ptr;
 
+/*
+ * Why present_check_flip rejected a flip, counted per screen so the
+ * copy fallbacks can be diagnosed.  One count per check, not per
+ * presentation; a vblank may be checked more than once.
+ */
+typedef enum {
+    PRESENT_FLIP_REJECT_DRIVER,         /* driver check_flip refused */
+    PRESENT_FLIP_REJECT_REDIRECTED,     /* window redirected by Composite */
+    PRESENT_FLIP_REJECT_CLIP,           /* window doesn't cover the root */
+    PRESENT_FLIP_REJECT_OFFSET,         /* nonzero x_off/y_off */
+    PRESENT_FLIP_REJECT_VALID,          /* valid region short of the screen */
+    PRESENT_FLIP_REJECT_GEOMETRY,       /* pixmap doesn't match the window */
+    PRESENT_FLIP_REJECT_BUFFER_FORMAT,  /* driver refused the buffer format */
+    PRESENT_FLIP_REJECT_NUM
+} PresentFlipReject;
+
 /*
  * Mode hooks
  */
@@ -183,6 +202,9 @@ struct present_screen_priv {
 
     present_screen_info_ptr     info;
 
+    /* Why flips fell back to copy, logged at close screen */
+    uint64_t                    flip_reject_count[PRESENT_FLIP_REJECT_NUM];
+
     /* Mode hooks */
     present_priv_query_capabilities_ptr query_capabilities;
     present_priv_get_crtc_ptr           get_crtc;
@@ -231,6 +253,25 @@ typedef struct present_event {
     int mask;
 } present_event_rec;
 
+/*
+ * Completion record kept per window so missed frames can be diagnosed
+ * after the fact; one entry per completed presentation, oldest
+ * overwritten first.  MSC values are window-relative, matching what the
+ * client saw in its PresentCompleteNotify event.
+ */
+#define PRESENT_TIMING_RECORDS  32
+
+typedef struct present_timing_record {
+    CARD32              serial;
+    CARD8               kind;           /* PresentCompleteKind* */
+    CARD8               mode;           /* PresentCompleteMode* */
+    PresentFlipReason   reason;         /* why this present couldn't flip */
+    uint64_t            target_msc;
+    uint64_t            complete_msc;
+    uint64_t            complete_ust;
+    CARD32              queue_ms;       /* request arrival to completion */
+} present_timing_record;
+
 struct present_window_priv {
     WindowPtr              window;
     present_event_ptr      events;
@@ -239,6 +280,12 @@ struct present_window_priv {
     uint64_t               msc;         /* Last reported MSC from the current crtc */
     struct xorg_list       vblank;
     struct xorg_list       notifies;
+
+    /* ring of recent completions, timing_next is the slot to fill */
+    present_timing_record  timing[PRESENT_TIMING_RECORDS];
+    int                    timing_next;
+    uint64_t               timing_total;    /* completed presentations */
+    uint64_t               timing_missed;   /* completed after target MSC */
 };
 
 #define PresentCrtcNeverSet     ((RRCrtcPtr) 1)
@@ -469,6 +516,16 @@ present_screen_register_priv_keys(void);
 present_screen_priv_ptr
 present_screen_priv_init(ScreenPtr screen);
 
+/*
+ * present_telemetry.c
+ */
+void
+present_timing_record_complete(present_vblank_ptr vblank, CARD8 kind, CARD8 mode,
+                               uint64_t ust, uint64_t crtc_msc);
+
+void
+present_timing_dump_window(WindowPtr window);
+
 /*
  * present_vblank.c
  */
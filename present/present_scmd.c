@@ -22,6 +22,7 @@
 #include <dix-config.h>
 
 #include "dix/screenint_priv.h"
+#include "os/probes_priv.h"
 #include "present/present_priv.h"
 #include "randr/randrstr_priv.h"
 
@@ -59,7 +60,7 @@ present_flip_pending_pixmap(ScreenPtr screen)
 }
 
 static Bool
-present_check_flip(RRCrtcPtr            crtc,
+present_check_flip_impl(RRCrtcPtr            crtc,
                    WindowPtr            window,
                    PixmapPtr            pixmap,
                    Bool                 sync_flip,
@@ -104,12 +105,14 @@ present_check_flip(RRCrtcPtr            crtc,
             if (!reason || tmp_reason != PRESENT_FLIP_REASON_BUFFER_FORMAT) {
                 if (reason)
                     *reason = tmp_reason;
+                screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_DRIVER]++;
                 return FALSE;
             }
         }
     } else if (screen_priv->info->check_flip) {
         if (!(*screen_priv->info->check_flip) (crtc, window, pixmap, sync_flip)) {
             DebugPresent(("\td %08" PRIx32 " -> %08" PRIx32 "\n", window->drawable.id, pixmap ? pixmap->drawable.id : 0));
+            screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_DRIVER]++;
             return FALSE;
         }
     }
@@ -118,21 +121,26 @@ present_check_flip(RRCrtcPtr            crtc,
     window_pixmap = screen->GetWindowPixmap(window);
     if (window_pixmap != screen->GetScreenPixmap(screen) &&
         window_pixmap != screen_priv->flip_pixmap &&
-        window_pixmap != present_flip_pending_pixmap(screen))
+        window_pixmap != present_flip_pending_pixmap(screen)) {
+        screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_REDIRECTED]++;
         return FALSE;
+    }
 
     /* Check for full-screen window */
     if (!RegionEqual(&window->clipList, &root->winSize)) {
+        screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_CLIP]++;
         return FALSE;
     }
 
     /* Source pixmap must align with window exactly */
     if (x_off || y_off) {
+        screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_OFFSET]++;
         return FALSE;
     }
 
     /* Make sure the area marked as valid fills the screen */
     if (valid && !RegionEqual(valid, &root->winSize)) {
+        screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_VALID]++;
         return FALSE;
     }
 
@@ -141,18 +149,41 @@ present_check_flip(RRCrtcPtr            crtc,
         window->drawable.x != pixmap->screen_x || window->drawable.y != pixmap->screen_y ||
         window->drawable.width != pixmap->drawable.width ||
         window->drawable.height != pixmap->drawable.height) {
+        screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_GEOMETRY]++;
         return FALSE;
     }
 
     if (tmp_reason == PRESENT_FLIP_REASON_BUFFER_FORMAT) {
         if (reason)
             *reason = tmp_reason;
+        screen_priv->flip_reject_count[PRESENT_FLIP_REJECT_BUFFER_FORMAT]++;
         return FALSE;
     }
 
     return TRUE;
 }
 
+static Bool
+present_check_flip(RRCrtcPtr            crtc,
+                   WindowPtr            window,
+                   PixmapPtr            pixmap,
+                   Bool                 sync_flip,
+                   RegionPtr            valid,
+                   int16_t              x_off,
+                   int16_t              y_off,
+                   PresentFlipReason   *reason)
+{
+    Bool ret = present_check_flip_impl(crtc, window, pixmap, sync_flip,
+                                       valid, x_off, y_off, reason);
+
+#ifdef XSERVER_DTRACE
+    if (XSERVER_PRESENT_FLIP_CHECK_ENABLED())
+        XSERVER_PRESENT_FLIP_CHECK(window->drawable.id,
+                                   pixmap ? pixmap->drawable.id : 0, ret);
+#endif
+    return ret;
+}
+
 static Bool
 present_flip(RRCrtcPtr crtc,
              uint64_t event_id,
@@ -233,7 +264,30 @@ present_queue_vblank(ScreenPtr screen,
     else
     {
         present_screen_priv_ptr     screen_priv = present_screen_priv(crtc->pScreen);
+        present_vblank_ptr          vblank;
+
+        /* Batch same-MSC waiters behind a single kernel vblank event:
+         * when another queued presentation already owns an event for
+         * this crtc and msc, its arrival sweeps every due waiter, so
+         * don't subscribe again.
+         */
+        xorg_list_for_each_entry(vblank, &present_exec_queue, event_queue) {
+            if (vblank->queued && vblank->own_msc_event &&
+                vblank->crtc == crtc && vblank->queued_msc == msc &&
+                vblank->event_id != event_id)
+                return Success;
+        }
+
         ret = (*screen_priv->info->queue_vblank) (crtc, event_id, msc);
+        if (ret == Success) {
+            xorg_list_for_each_entry(vblank, &present_exec_queue, event_queue) {
+                if (vblank->event_id == event_id) {
+                    vblank->own_msc_event = TRUE;
+                    vblank->queued_msc = msc;
+                    break;
+                }
+            }
+        }
     }
     return ret;
 }
@@ -253,16 +307,125 @@ present_re_execute(present_vblank_ptr vblank)
     present_execute(vblank, ust, crtc_msc);
 }
 
+/*
+ * An event-owning entry is leaving the queue without its event having
+ * fired; hand the kernel subscription to one of the waiters that was
+ * piggybacking on it, or execute the waiter right away if the driver
+ * refuses (same fallback present_scmd_pixmap uses).
+ */
 static void
-present_flip_try_ready(ScreenPtr screen)
+present_promote_msc_event(present_vblank_ptr old)
 {
-    present_vblank_ptr  vblank;
+    present_screen_priv_ptr     screen_priv = present_screen_priv(old->crtc->pScreen);
+    present_vblank_ptr          vblank;
 
-    xorg_list_for_each_entry(vblank, &present_flip_queue, event_queue) {
-        if (vblank->queued) {
+    xorg_list_for_each_entry(vblank, &present_exec_queue, event_queue) {
+        if (!vblank->queued || vblank->own_msc_event ||
+            vblank->crtc != old->crtc || vblank->exec_msc != old->queued_msc)
+            continue;
+
+        if ((*screen_priv->info->queue_vblank) (old->crtc, vblank->event_id,
+                                                old->queued_msc) == Success) {
+            vblank->own_msc_event = TRUE;
+            vblank->queued_msc = old->queued_msc;
+        } else
             present_re_execute(vblank);
+        return;
+    }
+}
+
+/*
+ * Flip-ready presentations stack up behind the pending flip instead of
+ * degrading to copies, but the driver can only retire one flip per
+ * vblank.  Bound how deep that queue may grow for a window; anything
+ * beyond the limit can never be shown on time, so complete it right
+ * away and let the client reuse the buffer.
+ */
+#define PRESENT_FLIP_QUEUE_DEPTH        4
+
+static void
+present_flip_queue_bound(ScreenPtr screen, WindowPtr window)
+{
+    present_vblank_ptr  vblank, tmp;
+    int                 depth = 0;
+
+    xorg_list_for_each_entry(vblank, &present_flip_queue, event_queue) {
+        if (vblank->flip_ready && vblank->window == window)
+            depth++;
+    }
+
+    if (depth <= PRESENT_FLIP_QUEUE_DEPTH)
+        return;
+
+    /* Scrap the oldest flip-ready presentations first; the newer ones
+     * would overwrite them before they could be seen anyway.
+     */
+    xorg_list_for_each_entry_safe(vblank, tmp, &present_flip_queue, event_queue) {
+        if (!vblank->flip_ready || vblank->window != window || !vblank->pixmap)
+            continue;
+
+        present_vblank_scrap(vblank);
+        present_re_execute(vblank);
+        if (--depth <= PRESENT_FLIP_QUEUE_DEPTH)
             return;
+    }
+}
+
+/*
+ * Whether a newer full-frame presentation for the same window is also
+ * already due: if so, this one would be overwritten within a frame of
+ * becoming visible and isn't worth a flip slot.
+ */
+static Bool
+present_flip_superseded(present_vblank_ptr vblank, uint64_t crtc_msc)
+{
+    present_vblank_ptr  newer;
+    Bool                after = FALSE;
+
+    xorg_list_for_each_entry(newer, &present_flip_queue, event_queue) {
+        if (newer == vblank) {
+            after = TRUE;
+            continue;
+        }
+        if (!after || !newer->queued)
+            continue;
+        if (newer->window != vblank->window || newer->crtc != vblank->crtc)
+            continue;
+        if (newer->update || !newer->pixmap)
+            continue;
+        if (!msc_is_after(newer->exec_msc, crtc_msc))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void
+present_flip_try_ready(ScreenPtr screen)
+{
+    present_vblank_ptr  vblank, tmp;
+    uint64_t            ust = 0, crtc_msc = 0;
+
+    xorg_list_for_each_entry_safe(vblank, tmp, &present_flip_queue, event_queue) {
+        if (!vblank->queued)
+            continue;
+
+        /* Mailbox: when several queued flips are already due, only the
+         * newest one can still make its deadline.  Retire the stale
+         * ones without flipping so the queue drains in one vblank
+         * instead of one frame each.
+         */
+        if (vblank->flip_ready && vblank->pixmap && vblank->crtc &&
+            present_get_ust_msc(screen, vblank->crtc, &ust, &crtc_msc) == Success &&
+            !msc_is_after(vblank->exec_msc, crtc_msc) &&
+            present_flip_superseded(vblank, crtc_msc)) {
+            present_vblank_scrap(vblank);
+            present_re_execute(vblank);
+            continue;
         }
+
+        present_re_execute(vblank);
+        return;
     }
 }
 
@@ -395,7 +558,24 @@ present_event_notify(uint64_t event_id, uint64_t ust, uint64_t msc)
     xorg_list_for_each_entry(vblank, &present_exec_queue, event_queue) {
         int64_t match = event_id - vblank->event_id;
         if (match == 0) {
+            RRCrtcPtr           crtc = vblank->crtc;
+            present_vblank_ptr  other, tmp;
+
             present_execute(vblank, ust, msc);
+
+            /* Sweep every other waiter on this crtc that is due at
+             * this msc in the same dispatch pass, so piggybacked
+             * same-MSC waiters complete off a single kernel event and
+             * the replies go out in one flush instead of one wakeup
+             * per window.
+             */
+            if (crtc) {
+                xorg_list_for_each_entry_safe(other, tmp, &present_exec_queue, event_queue) {
+                    if (other->queued && other->crtc == crtc &&
+                        !msc_is_after(other->exec_msc, msc))
+                        present_execute(other, ust, msc);
+                }
+            }
             return;
         }
     }
@@ -566,6 +746,7 @@ present_execute(present_vblank_ptr vblank, uint64_t ust, uint64_t crtc_msc)
             xorg_list_del(&vblank->event_queue);
             xorg_list_append(&vblank->event_queue, &present_flip_queue);
             vblank->flip_ready = TRUE;
+            present_flip_queue_bound(screen, window);
             return;
         }
     }
@@ -892,6 +1073,11 @@ present_scmd_abort_vblank(ScreenPtr screen, WindowPtr window, RRCrtcPtr crtc, ui
         if (match == 0) {
             xorg_list_del(&vblank->event_queue);
             vblank->queued = FALSE;
+            /* Waiters piggybacking on this entry's kernel event still
+             * need a wakeup.
+             */
+            if (vblank->own_msc_event && vblank->crtc)
+                present_promote_msc_event(vblank);
             return;
         }
     }
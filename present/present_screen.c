@@ -55,12 +55,37 @@ present_get_window_priv(WindowPtr window, Bool create)
 /*
  * Hook the close screen function to clean up our screen private
  */
+static void
+present_log_flip_rejects(ScreenPtr screen, present_screen_priv_ptr screen_priv)
+{
+    static const char *const reject_names[PRESENT_FLIP_REJECT_NUM] = {
+        "driver", "redirected", "clipped", "offset", "valid-region",
+        "geometry", "buffer-format",
+    };
+    uint64_t total = 0;
+
+    for (int i = 0; i < PRESENT_FLIP_REJECT_NUM; i++)
+        total += screen_priv->flip_reject_count[i];
+    if (!total)
+        return;
+
+    ErrorF("present: screen %d: %" PRIu64 " flip checks fell back to copy:\n",
+           screen->myNum, total);
+    for (int i = 0; i < PRESENT_FLIP_REJECT_NUM; i++) {
+        if (screen_priv->flip_reject_count[i])
+            ErrorF("present:   %s: %" PRIu64 "\n", reject_names[i],
+                   screen_priv->flip_reject_count[i]);
+    }
+}
+
 static void present_close_screen(CallbackListPtr *pcbl, ScreenPtr screen, void *unused)
 {
     present_screen_priv_ptr screen_priv = present_screen_priv(screen);
     if (!screen_priv)
         return;
 
+    present_log_flip_rejects(screen, screen_priv);
+
     if (screen_priv->flip_destroy)
         screen_priv->flip_destroy(screen);
 
@@ -106,6 +131,7 @@ present_destroy_window(CallbackListPtr *pcbl, ScreenPtr pScreen, WindowPtr windo
                                PresentWindowDestroyed);
 
     if (window_priv) {
+        present_timing_dump_window(window);
         present_clear_window_notifies(window);
         present_free_events(window);
         present_free_window_vblank(window);
@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2013 Keith Packard
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+#include <dix-config.h>
+
+#include "present/present_priv.h"
+
+#include "os.h"
+
+/*
+ * Per-window timing telemetry.  Every completed presentation leaves a
+ * record in the window's ring; when a window that missed frames goes
+ * away, the ring is written to the log so missed-frame investigations
+ * have requested vs actual MSC, queue latency and the flip-reject
+ * reason without needing an instrumented build.  The client-facing
+ * side of the same data is the PresentCompleteNotify event, which
+ * already carries ust/msc/mode per presentation.
+ */
+
+static const char *
+present_timing_mode_name(CARD8 mode)
+{
+    switch (mode) {
+    case PresentCompleteModeCopy:           return "copy";
+    case PresentCompleteModeFlip:           return "flip";
+    case PresentCompleteModeSkip:           return "skip";
+    case PresentCompleteModeSuboptimalCopy: return "suboptimal-copy";
+    default:                                return "?";
+    }
+}
+
+void
+present_timing_record_complete(present_vblank_ptr vblank, CARD8 kind, CARD8 mode,
+                               uint64_t ust, uint64_t crtc_msc)
+{
+    present_window_priv_ptr window_priv = present_window_priv(vblank->window);
+    present_timing_record   *record;
+
+    if (!window_priv)
+        return;
+
+    record = &window_priv->timing[window_priv->timing_next];
+    window_priv->timing_next = (window_priv->timing_next + 1) % PRESENT_TIMING_RECORDS;
+
+    record->serial = vblank->serial;
+    record->kind = kind;
+    record->mode = mode;
+    record->reason = vblank->reason;
+    record->target_msc = vblank->target_msc - vblank->msc_offset;
+    record->complete_msc = crtc_msc - vblank->msc_offset;
+    record->complete_ust = ust;
+    record->queue_ms = GetTimeInMillis() - vblank->submit_ms;
+
+    window_priv->timing_total++;
+    if (kind == PresentCompleteKindPixmap &&
+        msc_is_after(crtc_msc, vblank->target_msc))
+        window_priv->timing_missed++;
+}
+
+void
+present_timing_dump_window(WindowPtr window)
+{
+    present_window_priv_ptr window_priv = present_window_priv(window);
+    int n;
+
+    if (!window_priv || !window_priv->timing_missed)
+        return;
+
+    ErrorF("present: window %08" PRIx32 ": %" PRIu64 " of %" PRIu64
+           " presentations completed after their target MSC:\n",
+           window->drawable.id, window_priv->timing_missed,
+           window_priv->timing_total);
+
+    /* oldest first; unfilled slots have no serial and no MSC */
+    for (n = 0; n < PRESENT_TIMING_RECORDS; n++) {
+        present_timing_record *record =
+            &window_priv->timing[(window_priv->timing_next + n) % PRESENT_TIMING_RECORDS];
+
+        if (!record->complete_ust)
+            continue;
+        ErrorF("present:   serial %u %s target %" PRIu64 " actual %" PRIu64
+               " queued %u ms reason %d\n",
+               record->serial, present_timing_mode_name(record->mode),
+               record->target_msc, record->complete_msc,
+               record->queue_ms, record->reason);
+    }
+}
@@ -30,8 +30,10 @@ present_vblank_notify(present_vblank_ptr vblank, CARD8 kind, CARD8 mode, uint64_
 {
     int n;
 
-    if (vblank->window)
+    if (vblank->window) {
+        present_timing_record_complete(vblank, kind, mode, ust, crtc_msc);
         present_send_complete_notify(vblank->window, kind, mode, vblank->serial, ust, crtc_msc - vblank->msc_offset);
+    }
     for (n = 0; n < vblank->num_notifies; n++) {
         WindowPtr   window = vblank->notifies[n].window;
         CARD32      serial = vblank->notifies[n].serial;
@@ -108,6 +110,7 @@ present_vblank_init(present_vblank_ptr vblank,
         vblank->kind = PresentCompleteKindNotifyMSC;
 
     vblank->serial = serial;
+    vblank->submit_ms = GetTimeInMillis();
 
     if (valid) {
         vblank->valid = RegionDuplicate(valid);
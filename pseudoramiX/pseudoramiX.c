@@ -5,6 +5,14 @@
  * already provides an abstracted view of multiple screens as one
  * large screen area.
  *
+ * Unlike the real PanoramiX, only the query half of the protocol
+ * exists here: there is a single protocol screen, requests execute
+ * against it exactly once, and the native window server splits the
+ * result across its monitors.  There is no per-screen redispatch of
+ * drawing requests in this path, so the per-screen fan-out costs of
+ * Xext/panoramiXprocs.c (and the screen-culling done there) have no
+ * counterpart in this file.
+ *
  * This code is largely based on panoramiX.c, which contains the
  * following copyright notice:
  */
@@ -83,6 +83,9 @@ RRClientCallback(CallbackListPtr *list, void *closure, void *data)
     });
 }
 
+static void rrDeferredTellChanged(void *blockData, void *timeout);
+static void rrDeferredWakeupHandler(void *blockData, int result);
+
 static void RRCloseScreen(CallbackListPtr *pcbl, ScreenPtr pScreen, void *unused)
 {
     rrScrPriv(pScreen);
@@ -91,6 +94,10 @@ static void RRCloseScreen(CallbackListPtr *pcbl, ScreenPtr pScreen, void *unused
 
     dixScreenUnhookClose(pScreen, RRCloseScreen);
 
+    if (pScrPriv->tellChangedPending)
+        RemoveBlockAndWakeupHandlers(rrDeferredTellChanged,
+                                     rrDeferredWakeupHandler, pScreen);
+
     xorg_list_for_each_entry_safe(lease, next, &pScrPriv->leases, list)
         RRTerminateLease(lease);
     for (j = pScrPriv->numCrtcs - 1; j >= 0; j--)
@@ -102,6 +109,8 @@ static void RRCloseScreen(CallbackListPtr *pcbl, ScreenPtr pScreen, void *unused
         RRProviderDestroy(pScrPriv->provider);
 
     RRMonitorClose(pScreen);
+    RRScreenResourcesCacheFlush(pScreen);
+    RRDropPendingPropertyEvents(pScreen);
 
     free(pScrPriv->crtcs);
     free(pScrPriv->outputs);
@@ -574,6 +583,7 @@ RRSetChanged(ScreenPtr pScreen)
     }
 
     primarysp->changed = TRUE;
+    primarysp->resourcesSerial++;
 }
 
 /*
@@ -653,6 +663,55 @@ RRTellChanged(ScreenPtr pScreen)
     }
 }
 
+/*
+ * A multi-head layout change arrives as several SetCrtcConfig requests in a
+ * row, and flushing events after each one makes every listener revalidate
+ * the layout once per crtc. Instead of sending the events right away,
+ * RRTellChangedDeferred() schedules a one-shot block handler which delivers
+ * one coalesced event set once the whole request burst has been processed.
+ * Any intervening synchronous RRTellChanged() simply flushes earlier; the
+ * deferred handler then finds nothing left to send.
+ */
+static void
+rrDeferredWakeupHandler(void *blockData, int result)
+{
+}
+
+static void
+rrDeferredTellChanged(void *blockData, void *timeout)
+{
+    ScreenPtr primary = blockData;
+    rrScrPrivPtr primarysp = rrGetScrPriv(primary);
+
+    RemoveBlockAndWakeupHandlers(rrDeferredTellChanged,
+                                 rrDeferredWakeupHandler, primary);
+    primarysp->tellChangedPending = FALSE;
+    RRTellChanged(primary);
+}
+
+void
+RRTellChangedDeferred(ScreenPtr pScreen)
+{
+    ScreenPtr primary = pScreen;
+    rrScrPrivPtr primarysp;
+
+    if (pScreen->isGPU) {
+        primary = pScreen->current_primary;
+        if (!primary)
+            return;
+    }
+    primarysp = rrGetScrPriv(primary);
+
+    if (primarysp->tellChangedPending)
+        return;
+    if (!RegisterBlockAndWakeupHandlers(rrDeferredTellChanged,
+                                        rrDeferredWakeupHandler, primary)) {
+        RRTellChanged(pScreen);
+        return;
+    }
+    primarysp->tellChangedPending = TRUE;
+}
+
 /*
  * Return the first output which is connected to an active CRTC
  * Used in emulating 1.0 behaviour
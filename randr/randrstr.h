@@ -371,6 +371,9 @@ typedef struct _rrScrPriv {
     Bool layoutChanged;         /* screen layout changed */
     Bool resourcesChanged;      /* screen resources change */
     Bool leasesChanged;         /* leases change */
+    unsigned long resourcesSerial;      /* bumped on every resource change */
+    Bool tellChangedPending;    /* deferred RRTellChanged registered */
+    CARD32 lastProbeTime;       /* ms of last forced output probe */
 
     CARD16 minWidth, minHeight;
     CARD16 maxWidth, maxHeight;
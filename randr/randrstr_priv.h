@@ -141,6 +141,32 @@ void RRDeliverScreenEvent(ClientPtr pClient, WindowPtr pWin, ScreenPtr pScreen);
  */
 void RRResourcesChanged(ScreenPtr pScreen);
 
+/*
+ * Like RRTellChanged(), but delay the event delivery until the server is
+ * about to block, so several configuration requests processed back-to-back
+ * produce one coalesced event set instead of one flush per request.
+ *
+ * @param pScreen the screen where changes occoured
+ */
+void RRTellChangedDeferred(ScreenPtr pScreen);
+
+/*
+ * Drop the cached GetScreenResources reply for given screen, if any.
+ *
+ * @param pScreen the screen whose cached reply shall be dropped
+ */
+void RRScreenResourcesCacheFlush(ScreenPtr pScreen);
+
+/*
+ * Like RRGetInfo(pScreen, TRUE), but rate limited for client queries:
+ * the (possibly slow) driver probe is skipped when a forced probe
+ * already ran a moment ago.
+ *
+ * @param pScreen the screen to poll
+ * @return TRUE on success
+ */
+Bool RRGetInfoPolled(ScreenPtr pScreen);
+
 /*
  * Initialize randr subsystem
  *
@@ -256,6 +282,15 @@ Bool RROutputIsLeased(RROutputPtr output);
  */
 RRModePtr *RRModesForScreen(ScreenPtr pScreen, int *num_ret);
 
+/*
+ * Query the serial number of the global mode list. It is bumped whenever
+ * a mode is created or destroyed, so callers can cheaply detect whether
+ * data derived from the mode list is still current.
+ *
+ * @return current mode list serial
+ */
+unsigned long RRModeListSerial(void);
+
 /*
  * Initialize mode resource type
  *
@@ -328,6 +363,15 @@ void RRPointerScreenConfigured(ScreenPtr pScreen);
  * Note: Declaration moved to randrstr.h (public API) - see there for declaration
  */
 
+/*
+ * Drop queued output property notify events referring to given screen.
+ * Called when the screen goes away, so the deferred delivery never walks
+ * a dead window tree.
+ *
+ * @param pScreen the screen being closed
+ */
+void RRDropPendingPropertyEvents(ScreenPtr pScreen);
+
 /*
  * Delete all properties on given output
  *
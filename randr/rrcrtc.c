@@ -35,6 +35,10 @@
 #include "swaprep.h"
 #include "mipointer.h"
 
+#ifdef DRI3
+#include "dri3.h"
+#endif
+
 /* xFixed is just `int`, so better check whether it's really 32bit */
 __size_assert(xFixed, sizeof(CARD32));
 
@@ -234,6 +238,13 @@ RRCrtcNotify(RRCrtcPtr crtc,
                            &crtc->transform, &crtc->f_transform,
                            &crtc->f_inverse);
     }
+#ifdef DRI3
+    /* Scanout constraints can change with the configuration; have DRI3
+     * re-query the driver's modifier lists on the next negotiation.
+     */
+    if (crtc->changed)
+        dri3_invalidate_modifiers(crtc->pScreen);
+#endif
     return TRUE;
 }
 
@@ -854,7 +865,7 @@ RRCrtcSet(RRCrtcPtr crtc,
         }
         if (ret) {
 
-            RRTellChanged(pScreen);
+            RRTellChangedDeferred(pScreen);
 
             for (o = 0; o < numOutputs; o++)
                 RRPostPendingProperties(outputs[o]);
@@ -945,6 +956,12 @@ RRCrtcGammaSet(RRCrtcPtr crtc, CARD16 *red, CARD16 *green, CARD16 *blue)
     ScreenPtr pScreen = crtc->pScreen;
 #endif
 
+    /* gamma ramp daemons re-send unchanged ramps; don't bother the driver */
+    if (memcmp(crtc->gammaRed, red, crtc->gammaSize * sizeof(CARD16)) == 0 &&
+        memcmp(crtc->gammaGreen, green, crtc->gammaSize * sizeof(CARD16)) == 0 &&
+        memcmp(crtc->gammaBlue, blue, crtc->gammaSize * sizeof(CARD16)) == 0)
+        return TRUE;
+
     memcpy(crtc->gammaRed, red, crtc->gammaSize * sizeof(CARD16));
     memcpy(crtc->gammaGreen, green, crtc->gammaSize * sizeof(CARD16));
     memcpy(crtc->gammaBlue, blue, crtc->gammaSize * sizeof(CARD16));
@@ -1119,6 +1136,7 @@ RRCrtcTransformSet(RRCrtcPtr crtc,
     crtc->client_pending_transform.transform = *transform;
     crtc->client_pending_transform.f_transform = *f_transform;
     crtc->client_pending_transform.f_inverse = *f_inverse;
+    crtc->client_pending_transform.kind = RRTransformClassify(transform);
     return Success;
 }
 
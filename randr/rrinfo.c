@@ -23,6 +23,9 @@
 
 #include "randr/randrstr_priv.h"
 
+/* how long (ms) the result of a forced probe satisfies client queries */
+#define RR_POLL_REUSE_MS 2000
+
 #ifdef RANDR_10_INTERFACE
 static RRModePtr
 RROldModeAdd(RROutputPtr output, RRScreenSizePtr size, int refresh)
@@ -197,6 +200,9 @@ RRGetInfo(ScreenPtr pScreen, Bool force_query)
     if (!(*pScrPriv->rrGetInfo) (pScreen, &rotations))
         return FALSE;
 
+    if (force_query)
+        pScrPriv->lastProbeTime = GetTimeInMillis();
+
 #if RANDR_10_INTERFACE
     if (pScrPriv->nSizes)
         RRScanOldConfig(pScreen, rotations);
@@ -205,6 +211,28 @@ RRGetInfo(ScreenPtr pScreen, Bool force_query)
     return TRUE;
 }
 
+/*
+ * Poll the driver for changed information on behalf of a client query.
+ *
+ * Client-requested probes are rate limited: when a full probe - either
+ * hotplug handling or an earlier query - ran within the last couple of
+ * seconds, the information on hand is current and the driver probe,
+ * which can block on EDID transfers, is skipped. Out-of-band changes
+ * are still picked up promptly because the hotplug paths probe
+ * unconditionally through RRGetInfo().
+ */
+Bool
+RRGetInfoPolled(ScreenPtr pScreen)
+{
+    rrScrPriv(pScreen);
+
+    if (pScrPriv->lastProbeTime != 0 &&
+        GetTimeInMillis() - pScrPriv->lastProbeTime < RR_POLL_REUSE_MS)
+        return TRUE;
+
+    return RRGetInfo(pScreen, TRUE);
+}
+
 /*
  * Register the range of sizes for the screen
  */
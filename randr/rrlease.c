@@ -185,6 +185,39 @@ RRTerminateLease(RRLeasePtr lease)
     scr_priv->rrTerminateLease(screen, lease);
 }
 
+/*
+ * Work queue entry for a lease termination requested over the wire.
+ *
+ * Revoking a lease can stall in the kernel while the lessee is torn
+ * down, so ProcRRFreeLease defers the driver call until the current
+ * batch of requests has been dispatched instead of blocking mid-burst.
+ * The lease may have been torn down by other means (client exit, screen
+ * close) while the entry sat on the queue, so only dereference it after
+ * finding it on a screen's lease list.
+ */
+static Bool
+RRTerminateLeaseWorkProc(ClientPtr clientUnused, void *closure)
+{
+    RRLeasePtr lease = closure;
+    int i;
+
+    for (i = 0; i < screenInfo.numScreens; i++) {
+        ScreenPtr screen = screenInfo.screens[i];
+        rrScrPrivPtr scr_priv = rrGetScrPriv(screen);
+        RRLeasePtr l;
+
+        if (!scr_priv)
+            continue;
+        xorg_list_for_each_entry(l, &scr_priv->leases, list) {
+            if (l == lease) {
+                RRTerminateLease(lease);
+                return TRUE;
+            }
+        }
+    }
+    return TRUE;
+}
+
 /*
  * Destroy a lease resource ID. All this
  * does is note that the lease no longer has an ID, and
@@ -365,8 +398,10 @@ ProcRRFreeLease(ClientPtr client)
     RRLeasePtr lease;
     VERIFY_RR_LEASE(stuff->lid, lease, DixDestroyAccess);
 
-    if (stuff->terminate)
-        RRTerminateLease(lease);
+    if (stuff->terminate) {
+        if (!QueueWorkProc(RRTerminateLeaseWorkProc, NULL, lease))
+            RRTerminateLease(lease);
+    }
     else
         /* Get rid of the resource database entry */
         FreeResource(stuff->lid, X11_RESTYPE_NONE);
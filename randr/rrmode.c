@@ -63,6 +63,13 @@ RRModeEqual(xRRModeInfo * a, xRRModeInfo * b)
  */
 static int num_modes;
 static RRModePtr *modes;
+static unsigned long mode_list_serial;
+
+unsigned long
+RRModeListSerial(void)
+{
+    return mode_list_serial;
+}
 
 static RRModePtr
 RRModeCreate(xRRModeInfo * modeInfo, const char *name, ScreenPtr userScreen)
@@ -99,6 +106,7 @@ RRModeCreate(xRRModeInfo * modeInfo, const char *name, ScreenPtr userScreen)
     }
     modes = newModes;
     modes[num_modes++] = mode;
+    mode_list_serial++;
 
     /*
      * give the caller a reference to this mode
@@ -242,6 +250,7 @@ RRModeDestroy(RRModePtr mode)
             memmove(modes + m, modes + m + 1,
                     (num_modes - m - 1) * sizeof(RRModePtr));
             num_modes--;
+            mode_list_serial++;
             if (!num_modes) {
                 free(modes);
                 modes = NULL;
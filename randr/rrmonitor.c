@@ -305,6 +305,71 @@ RRMonitorFiniList(RRMonitorListPtr list)
     free(list->server_crtc);
 }
 
+/* The protocol-visible monitor list is derived entirely from the screen's
+ * crtc/output configuration and the client-defined monitors, but clients
+ * tend to re-read it in bursts whenever the configuration settles. Keep the
+ * last computed list around, keyed on the serials of its inputs, so a storm
+ * of GetMonitors during reconfiguration recomputes the list at most once
+ * per actual change. lastSetTime is part of the key since panning changes
+ * affect the geometry without going through RRSetChanged.
+ */
+typedef struct {
+    ScreenPtr           screen;         /* NULL when the entry is empty */
+    Bool                get_active;
+    unsigned long       resourcesSerial;
+    unsigned long       clientSerial;
+    CARD32              lastSetTime;
+    RRMonitorPtr        monitors;
+    int                 nmon;
+} RRMonitorCacheRec;
+
+static RRMonitorCacheRec rrMonitorCache;
+static unsigned long rrMonitorClientSerial;
+
+static void
+RRMonitorCacheFlush(ScreenPtr screen)
+{
+    if (rrMonitorCache.screen == screen) {
+        RRMonitorFreeList(rrMonitorCache.monitors, rrMonitorCache.nmon);
+        rrMonitorCache = (RRMonitorCacheRec) { 0 };
+    }
+}
+
+static Bool
+RRMonitorCacheMatch(ScreenPtr screen, rrScrPrivPtr pScrPriv, Bool get_active)
+{
+    return rrMonitorCache.screen == screen &&
+        rrMonitorCache.get_active == get_active &&
+        rrMonitorCache.resourcesSerial == pScrPriv->resourcesSerial &&
+        rrMonitorCache.clientSerial == rrMonitorClientSerial &&
+        rrMonitorCache.lastSetTime == pScrPriv->lastSetTime.milliseconds;
+}
+
+static RRMonitorPtr
+RRMonitorListCopy(RRMonitorPtr monitors, int nmon)
+{
+    RRMonitorPtr        copy;
+    int                 m;
+
+    copy = calloc(nmon ? nmon : 1, sizeof(RRMonitorRec));
+    if (!copy)
+        return NULL;
+    for (m = 0; m < nmon; m++) {
+        copy[m] = monitors[m];
+        copy[m].outputs = NULL;
+        if (monitors[m].numOutputs) {
+            copy[m].outputs = calloc(monitors[m].numOutputs, sizeof(RROutput));
+            if (!copy[m].outputs) {
+                RRMonitorFreeList(copy, m);
+                return NULL;
+            }
+            memcpy(copy[m].outputs, monitors[m].outputs,
+                   monitors[m].numOutputs * sizeof(RROutput));
+        }
+    }
+    return copy;
+}
+
 /* Construct a complete list of protocol-visible monitors, including
  * the manually generated ones as well as those generated
  * automatically from the remaining CRCTs
@@ -322,6 +387,16 @@ RRMonitorMakeList(ScreenPtr screen, Bool get_active, RRMonitorPtr *monitors_ret,
     if (!pScrPriv)
         return FALSE;
 
+    if (RRMonitorCacheMatch(screen, pScrPriv, get_active)) {
+        monitors = RRMonitorListCopy(rrMonitorCache.monitors,
+                                     rrMonitorCache.nmon);
+        if (monitors) {
+            *monitors_ret = monitors;
+            *nmon_ret = rrMonitorCache.nmon;
+            return TRUE;
+        }
+    }
+
     if (!RRMonitorInitList(screen, &list, get_active))
         return FALSE;
 
@@ -386,15 +461,31 @@ RRMonitorMakeList(ScreenPtr screen, Bool get_active, RRMonitorPtr *monitors_ret,
     RRMonitorFiniList(&list);
     *nmon_ret = list.num_client + list.num_server;
     *monitors_ret = monitors;
+
+    if (rrMonitorCache.screen)
+        RRMonitorCacheFlush(rrMonitorCache.screen);
+    rrMonitorCache.monitors = RRMonitorListCopy(monitors, *nmon_ret);
+    if (rrMonitorCache.monitors) {
+        rrMonitorCache.screen = screen;
+        rrMonitorCache.get_active = get_active;
+        rrMonitorCache.resourcesSerial = pScrPriv->resourcesSerial;
+        rrMonitorCache.clientSerial = rrMonitorClientSerial;
+        rrMonitorCache.lastSetTime = pScrPriv->lastSetTime.milliseconds;
+        rrMonitorCache.nmon = *nmon_ret;
+    }
     return TRUE;
 }
 
 int
 RRMonitorCountList(ScreenPtr screen)
 {
+    rrScrPrivPtr        pScrPriv = rrGetScrPriv(screen);
     RRMonitorListRec    list;
     int                 nmon;
 
+    if (pScrPriv && RRMonitorCacheMatch(screen, pScrPriv, FALSE))
+        return rrMonitorCache.nmon;
+
     if (!RRMonitorInitList(screen, &list, FALSE))
         return -1;
     nmon = list.num_client + list.num_server;
@@ -439,6 +530,7 @@ RRMonitorDelete(ClientPtr client, ScreenPtr screen, Atom name)
                     (pScrPriv->numMonitors - (m + 1)) * sizeof (RRMonitorPtr));
             --pScrPriv->numMonitors;
             RRMonitorFree(monitor);
+            rrMonitorClientSerial++;
             return Success;
         }
     }
@@ -528,6 +620,7 @@ RRMonitorAdd(ClientPtr client, ScreenPtr screen, RRMonitorPtr monitor)
     /* Add the new one to the list
      */
     pScrPriv->monitors[pScrPriv->numMonitors++] = monitor;
+    rrMonitorClientSerial++;
 
     return Success;
 }
@@ -560,6 +653,8 @@ RRMonitorClose(ScreenPtr screen)
     rrScrPrivPtr        pScrPriv = rrGetScrPriv(screen);
     int                 m;
 
+    RRMonitorCacheFlush(screen);
+
     if (!pScrPriv)
         return;
 
@@ -60,6 +60,120 @@ RRDeliverPropertyEvent(ScreenPtr pScreen, xEvent *event)
         WalkTree(pScreen, DeliverPropertyEvent, event);
 }
 
+/*
+ * Output property updates tend to arrive in bursts (display daemons
+ * rewriting EDID/backlight/CTM properties back-to-back), and walking the
+ * window tree once per change wakes every RandR listener once per property.
+ * Instead of delivering right away, the notify events are queued and sent
+ * from a one-shot block handler once the current dispatch cycle has
+ * drained; repeated updates to the same property within one cycle collapse
+ * into a single event. The events only carry resource ids, so delivery
+ * after the output or property is gone is safe.
+ */
+typedef struct {
+    ScreenPtr pScreen;
+    xRROutputPropertyNotifyEvent event;
+} RRPendingPropertyEventRec;
+
+static RRPendingPropertyEventRec *rrPendingPropEvents;
+static int rrNumPendingPropEvents;
+static int rrSizePendingPropEvents;
+static Bool rrPropFlushRegistered;
+
+static void rrPropertyBlockHandler(void *blockData, void *timeout);
+
+static void
+rrPropertyWakeupHandler(void *blockData, int result)
+{
+}
+
+static void
+RRFlushPendingPropertyEvents(void)
+{
+    int i;
+
+    if (rrPropFlushRegistered) {
+        RemoveBlockAndWakeupHandlers(rrPropertyBlockHandler,
+                                     rrPropertyWakeupHandler, NULL);
+        rrPropFlushRegistered = FALSE;
+    }
+    for (i = 0; i < rrNumPendingPropEvents; i++)
+        RRDeliverPropertyEvent(rrPendingPropEvents[i].pScreen,
+                               (xEvent *) &rrPendingPropEvents[i].event);
+    rrNumPendingPropEvents = 0;
+}
+
+static void
+rrPropertyBlockHandler(void *blockData, void *timeout)
+{
+    RRFlushPendingPropertyEvents();
+}
+
+void
+RRDropPendingPropertyEvents(ScreenPtr pScreen)
+{
+    int i, kept = 0;
+
+    for (i = 0; i < rrNumPendingPropEvents; i++) {
+        if (rrPendingPropEvents[i].pScreen != pScreen)
+            rrPendingPropEvents[kept++] = rrPendingPropEvents[i];
+    }
+    rrNumPendingPropEvents = kept;
+
+    if (!kept && rrPropFlushRegistered) {
+        RemoveBlockAndWakeupHandlers(rrPropertyBlockHandler,
+                                     rrPropertyWakeupHandler, NULL);
+        rrPropFlushRegistered = FALSE;
+    }
+}
+
+static void
+RRQueuePropertyEvent(ScreenPtr pScreen, xRROutputPropertyNotifyEvent *event)
+{
+    int i;
+
+    for (i = 0; i < rrNumPendingPropEvents; i++) {
+        RRPendingPropertyEventRec *pending = &rrPendingPropEvents[i];
+
+        if (pending->pScreen == pScreen &&
+            pending->event.output == event->output &&
+            pending->event.atom == event->atom &&
+            pending->event.state == event->state) {
+            pending->event.timestamp = event->timestamp;
+            return;
+        }
+    }
+
+    if (rrNumPendingPropEvents == rrSizePendingPropEvents) {
+        int size = rrSizePendingPropEvents ? rrSizePendingPropEvents * 2 : 8;
+        RRPendingPropertyEventRec *resized =
+            reallocarray(rrPendingPropEvents, size,
+                         sizeof(RRPendingPropertyEventRec));
+
+        if (!resized) {
+            /* flush first so the immediate delivery stays in order */
+            RRFlushPendingPropertyEvents();
+            RRDeliverPropertyEvent(pScreen, (xEvent *) event);
+            return;
+        }
+        rrPendingPropEvents = resized;
+        rrSizePendingPropEvents = size;
+    }
+
+    if (!rrPropFlushRegistered) {
+        if (!RegisterBlockAndWakeupHandlers(rrPropertyBlockHandler,
+                                            rrPropertyWakeupHandler, NULL)) {
+            RRDeliverPropertyEvent(pScreen, (xEvent *) event);
+            return;
+        }
+        rrPropFlushRegistered = TRUE;
+    }
+
+    rrPendingPropEvents[rrNumPendingPropEvents].pScreen = pScreen;
+    rrPendingPropEvents[rrNumPendingPropEvents].event = *event;
+    rrNumPendingPropEvents++;
+}
+
 static void
 RRDestroyOutputProperty(RRPropertyPtr prop)
 {
@@ -81,7 +195,7 @@ RRDeleteProperty(RROutputRec * output, RRPropertyRec * prop)
         .timestamp = currentTime.milliseconds
     };
 
-    RRDeliverPropertyEvent(output->pScreen, (xEvent *) &event);
+    RRQueuePropertyEvent(output->pScreen, &event);
 
     RRDestroyOutputProperty(prop);
 }
@@ -275,7 +389,7 @@ RRChangeOutputProperty(RROutputPtr output, Atom property, Atom type,
             .atom = prop->propertyName,
             .timestamp = currentTime.milliseconds
         };
-        RRDeliverPropertyEvent(output->pScreen, (xEvent *) &event);
+        RRQueuePropertyEvent(output->pScreen, &event);
     }
     return Success;
 }
@@ -714,7 +828,7 @@ ProcRRGetOutputProperty(ClientPtr client)
             .atom = prop->propertyName,
             .timestamp = currentTime.milliseconds
         };
-        RRDeliverPropertyEvent(output->pScreen, (xEvent *) &event);
+        RRQueuePropertyEvent(output->pScreen, &event);
     }
 
     if (len) {
@@ -393,7 +393,7 @@ rrGetMultiScreenResources(ClientPtr client, Bool query, ScreenPtr pScreen)
     pScrPriv = rrGetScrPriv(pScreen);
 
     if (query && pScrPriv)
-        if (!RRGetInfo(pScreen, query))
+        if (!RRGetInfoPolled(pScreen))
             return BadAlloc;
 
     update_totals(pScreen, pScrPriv);
@@ -405,7 +405,7 @@ rrGetMultiScreenResources(ClientPtr client, Bool query, ScreenPtr pScreen)
         pScrPriv = rrGetScrPriv(iter);
 
         if (query)
-          if (!RRGetInfo(iter, query))
+          if (!RRGetInfoPolled(iter))
             return BadAlloc;
         update_totals(iter, pScrPriv);
     }
@@ -480,6 +480,36 @@ rrGetMultiScreenResources(ClientPtr client, Bool query, ScreenPtr pScreen)
     return X_SEND_REPLY_WITH_RPCBUF(client, reply, rpcbuf);
 }
 
+/*
+ * One-entry cache of the serialized GetScreenResources reply body. The body
+ * depends only on the screen's crtc/output/mode lists, which are tracked by
+ * rrScrPrivRec.resourcesSerial (bumped in RRSetChanged) and the global mode
+ * list serial, so repeated queries between configuration changes can reuse
+ * the wire data instead of walking all resources again. The timestamps may
+ * move independently of the resource lists, thus they are patched into the
+ * cached reply on every hit.
+ */
+typedef struct {
+    ScreenPtr pScreen;          /* NULL when the entry is empty */
+    unsigned long resourcesSerial;
+    unsigned long modeListSerial;
+    Bool swapped;
+    xRRGetScreenResourcesReply reply;   /* header fields in host order */
+    char *body;
+    unsigned long bodyLen;
+} RRResourcesCacheRec;
+
+static RRResourcesCacheRec rrResourcesCache;
+
+void
+RRScreenResourcesCacheFlush(ScreenPtr pScreen)
+{
+    if (rrResourcesCache.pScreen == pScreen) {
+        free(rrResourcesCache.body);
+        rrResourcesCache = (RRResourcesCacheRec) { 0 };
+    }
+}
+
 static int
 rrGetScreenResources(ClientPtr client, Bool query)
 {
@@ -505,7 +535,7 @@ rrGetScreenResources(ClientPtr client, Bool query)
     pScrPriv = rrGetScrPriv(pScreen);
 
     if (query && pScrPriv)
-        if (!RRGetInfo(pScreen, query))
+        if (!RRGetInfoPolled(pScreen))
             return BadAlloc;
 
     if (pScreen->output_secondarys)
@@ -519,6 +549,21 @@ rrGetScreenResources(ClientPtr client, Bool query)
             .configTimestamp = currentTime.milliseconds,
         };
     }
+    else if (rrResourcesCache.pScreen == pScreen &&
+             rrResourcesCache.resourcesSerial == pScrPriv->resourcesSerial &&
+             rrResourcesCache.modeListSerial == RRModeListSerial() &&
+             rrResourcesCache.swapped == client->swapped) {
+        reply = rrResourcesCache.reply;
+        reply.timestamp = pScrPriv->lastSetTime.milliseconds;
+        reply.configTimestamp = pScrPriv->lastConfigTime.milliseconds;
+        extraLen = rrResourcesCache.bodyLen;
+        if (extraLen) {
+            extra = x_rpcbuf_reserve(&rpcbuf, extraLen);
+            if (!extra)
+                return BadAlloc;
+            memcpy(extra, rrResourcesCache.body, extraLen);
+        }
+    }
     else {
         RRModePtr *modes;
         int num_modes;
@@ -607,6 +652,23 @@ rrGetScreenResources(ClientPtr client, Bool query)
         assert(bytes_to_int32((char *) names - (char *) extra) == reply.length);
 finish:
         free(modes);
+
+        free(rrResourcesCache.body);
+        rrResourcesCache = (RRResourcesCacheRec) {
+            .pScreen = pScreen,
+            .resourcesSerial = pScrPriv->resourcesSerial,
+            .modeListSerial = RRModeListSerial(),
+            .swapped = client->swapped,
+            .reply = reply,
+            .bodyLen = extraLen,
+        };
+        if (extraLen) {
+            rrResourcesCache.body = malloc(extraLen);
+            if (rrResourcesCache.body)
+                memcpy(rrResourcesCache.body, extra, extraLen);
+            else
+                rrResourcesCache.pScreen = NULL;
+        }
     }
 
     if (client->swapped) {
@@ -755,7 +817,7 @@ ProcRRGetScreenInfo(ClientPtr client)
     pScrPriv = rrGetScrPriv(pScreen);
 
     if (pScrPriv)
-        if (!RRGetInfo(pScreen, TRUE))
+        if (!RRGetInfoPolled(pScreen))
             return BadAlloc;
 
     output = RRFirstOutput(pScreen);
@@ -33,6 +33,24 @@ RRTransformInit(RRTransformPtr transform)
     transform->filter = NULL;
     transform->params = NULL;
     transform->nparams = 0;
+    transform->kind = RR_TRANSFORM_IDENTITY;
+}
+
+int
+RRTransformClassify(const PictTransform *transform)
+{
+    if (transform->matrix[2][0] != 0 ||
+        transform->matrix[2][1] != 0 ||
+        transform->matrix[2][2] != pixman_fixed_1 ||
+        transform->matrix[0][1] != 0 ||
+        transform->matrix[1][0] != 0)
+        return RR_TRANSFORM_GENERAL;
+    if (transform->matrix[0][0] != pixman_fixed_1 ||
+        transform->matrix[1][1] != pixman_fixed_1)
+        return RR_TRANSFORM_SCALE;
+    if (transform->matrix[0][2] != 0 || transform->matrix[1][2] != 0)
+        return RR_TRANSFORM_TRANSLATE;
+    return RR_TRANSFORM_IDENTITY;
 }
 
 Bool
@@ -95,6 +113,7 @@ RRTransformCopy(RRTransformPtr dst, RRTransformPtr src)
         dst->transform = src->transform;
         dst->f_transform = src->f_transform;
         dst->f_inverse = src->f_inverse;
+        dst->kind = RRTransformClassify(&src->transform);
     }
     else {
         if (!RRTransformSetFilter(dst, NULL, NULL, 0, 0, 0))
@@ -102,6 +121,7 @@ RRTransformCopy(RRTransformPtr dst, RRTransformPtr src)
         pixman_transform_init_identity(&dst->transform);
         pixman_f_transform_init_identity(&dst->f_transform);
         pixman_f_transform_init_identity(&dst->f_inverse);
+        dst->kind = RR_TRANSFORM_IDENTITY;
     }
     return TRUE;
 }
@@ -145,6 +165,27 @@ RRTransformCompute(int x,
     PictTransform t_transform, inverse;
     struct pixman_f_transform tf_transform, tf_inverse;
     Bool overflow = FALSE;
+    Bool identity_client = !rr_transform;
+
+#ifdef RANDR_12_INTERFACE
+    if (rr_transform && rr_transform->kind == RR_TRANSFORM_IDENTITY)
+        identity_client = TRUE;
+#endif
+
+    /* The overwhelmingly common case is an untransformed crtc: no rotation
+     * and an identity client transform. Emit the crtc offset translation
+     * directly instead of running the whole matrix algebra below just to
+     * find out the result is a translation.
+     */
+    if (rotation == RR_Rotate_0 && identity_client) {
+        if (transform)
+            pixman_transform_init_translate(transform, F(x), F(y));
+        if (f_transform)
+            pixman_f_transform_init_translate(f_transform, x, y);
+        if (f_inverse)
+            pixman_f_transform_init_translate(f_inverse, -x, -y);
+        return FALSE;
+    }
 
     if (!transform)
         transform = &t_transform;
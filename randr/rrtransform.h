@@ -37,8 +37,22 @@ struct _rrTransform {
     int nparams;
     int width;
     int height;
+    int kind;                   /* RR_TRANSFORM_* class of transform */
 };
 
+/*
+ * Classification of the transform matrix, cached in the kind field by
+ * RRTransformInit/RRTransformCopy so hot paths can branch on the shape
+ * of the matrix without inspecting it.
+ */
+#define RR_TRANSFORM_IDENTITY   0
+#define RR_TRANSFORM_TRANSLATE  1       /* translation only */
+#define RR_TRANSFORM_SCALE      2       /* diagonal scale, maybe translation */
+#define RR_TRANSFORM_GENERAL    3
+
+extern _X_EXPORT int
+RRTransformClassify(const PictTransform *transform);
+
 /*
  * Compute the complete transformation matrix including
  * client-specified transform, rotation/reflection values and the crtc
@@ -65,9 +65,12 @@ and Jim Haggerty of Metheus.
 static RESTYPE RTContext;       /* internal resource type for Record contexts */
 
 /* How many bytes of protocol data to buffer in a context. Don't set to less
- * than 32.
+ * than 32.  The buffer holds a sequence of complete EnableContext replies,
+ * so switching recorded client or category just opens a new reply in place
+ * instead of forcing a write to the recording client; everything goes out
+ * in one WriteToClient when the buffer fills or the FlushCallback fires.
  */
-#define REPLY_BUF_SIZE 1024
+#define REPLY_BUF_SIZE 8192
 
 /* Record Context structure */
 
@@ -80,6 +83,7 @@ typedef struct {
     char elemHeaders;           /* element header flags (time/seq no.) */
     char bufCategory;           /* category of protocol in replyBuffer */
     int numBufBytes;            /* number of bytes in replyBuffer */
+    int bufHeaderOffset;        /* start of the open reply in replyBuffer */
     char replyBuffer[REPLY_BUF_SIZE];   /* buffered recorded protocol */
     int inFlush;                /*  are we inside RecordFlushReplyBuffer */
 } RecordContextRec, *RecordContextPtr;
@@ -245,6 +249,7 @@ RecordFlushReplyBuffer(RecordContextPtr pContext,
         WriteToClient(pContext->pRecordingClient, pContext->numBufBytes,
                       pContext->replyBuffer);
     pContext->numBufBytes = 0;
+    pContext->bufHeaderOffset = 0;
     if (len1)
         WriteToClient(pContext->pRecordingClient, len1, data1);
     if (len2)
@@ -293,17 +298,24 @@ RecordAProtocolElement(RecordContextPtr pContext, ClientPtr pClient,
     int replylen;
 
     if (futurelen >= 0) {       /* start of new protocol element */
-        xRecordEnableContextReply *pRep = (xRecordEnableContextReply *)
-            pContext->replyBuffer;
+        xRecordEnableContextReply *pRep;
 
         if (pContext->pBufClient != pClient ||
             pContext->bufCategory != category) {
-            RecordFlushReplyBuffer(pContext, NULL, 0, NULL, 0);
+            /* close the open reply and start a new one behind it in the
+               same buffer; only flush if the header wouldn't fit */
+            if (REPLY_BUF_SIZE - pContext->numBufBytes <
+                SIZEOF(xRecordEnableContextReply))
+                RecordFlushReplyBuffer(pContext, NULL, 0, NULL, 0);
+            pContext->bufHeaderOffset = pContext->numBufBytes;
             pContext->pBufClient = pClient;
             pContext->bufCategory = category;
         }
 
-        if (!pContext->numBufBytes) {
+        pRep = (xRecordEnableContextReply *)
+            (pContext->replyBuffer + pContext->bufHeaderOffset);
+
+        if (pContext->numBufBytes == pContext->bufHeaderOffset) {
             serverTime = GetTimeInMillis();
             gotServerTime = TRUE;
             pRep->type = X_Reply;
@@ -333,7 +345,7 @@ RecordAProtocolElement(RecordContextPtr pContext, ClientPtr pClient,
                 swapl(&pRep->serverTime);
                 swapl(&pRep->recordedSequenceNumber);
             }
-            pContext->numBufBytes = SIZEOF(xRecordEnableContextReply);
+            pContext->numBufBytes += SIZEOF(xRecordEnableContextReply);
         }
 
         /* generate element headers if needed */
@@ -791,12 +803,10 @@ RecordADeviceEvent(CallbackListPtr *pcbl, void *nulldata, void *calldata)
                     EventToCore(pei->event, &core_events, &count);
                     RecordSendProtocolEvents(pRCAP, pContext, core_events,
                                              count);
-                    free(core_events);
                 }
 
                 EventToXI(pei->event, &xi_events, &count);
                 RecordSendProtocolEvents(pRCAP, pContext, xi_events, count);
-                free(xi_events);
             }                   /* end this RCAP selects device events */
         }                       /* end for each RCAP on this context */
     }                           /* end for each enabled context */
@@ -1881,6 +1891,7 @@ ProcRecordCreateContext(ClientPtr client)
     pContext->elemHeaders = 0;
     pContext->bufCategory = 0;
     pContext->numBufBytes = 0;
+    pContext->bufHeaderOffset = 0;
     pContext->pBufClient = NULL;
     pContext->continuedReply = 0;
     pContext->inFlush = 0;
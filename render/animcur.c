@@ -58,7 +58,6 @@ typedef struct _AnimCurElt {
 typedef struct _AnimCur {
     int nelt;                   /* number of elements in the elts array */
     AnimCurElt *elts;           /* actually allocated right after the structure */
-    OsTimerPtr timer;
 } AnimCurRec, *AnimCurPtr;
 
 typedef struct _AnimScrPriv {
@@ -120,44 +119,89 @@ AnimCurCursorLimits(DeviceIntPtr pDev,
 }
 
 /*
- * The cursor animation timer has expired, go display any relevant cursor changes
- * and compute a new timeout value
+ * All animated cursors share one timer; each device carries its own
+ * frame deadline and the timer is armed for the soonest of them.  The
+ * frames themselves were realized by the screen when the element
+ * cursors were created, so a tick is just a DisplayCursor of an
+ * already-realized cursor.
  */
 
+static OsTimerPtr animCurTimer;
+static CARD32 animCurNextTime;
+static Bool animCurArmed;
+
 static CARD32
 AnimCurTimerNotify(OsTimerPtr timer, CARD32 now, void *arg)
 {
-    DeviceIntPtr dev = arg;
-    ScreenPtr pScreen = dev->spriteInfo->anim.pScreen;
-    AnimCurScreenPtr as = GetAnimCurScreen(pScreen);
-
-    AnimCurPtr ac = GetAnimCur(dev->spriteInfo->sprite->current);
-    int elt = (dev->spriteInfo->anim.elt + 1) % ac->nelt;
-    DisplayCursorProcPtr DisplayCursor = pScreen->DisplayCursor;
-
-    /*
-     * Not a simple Unwrap/Wrap as this isn't called along the DisplayCursor
-     * wrapper chain.
-     */
-    pScreen->DisplayCursor = as->DisplayCursor;
-    (void) (*pScreen->DisplayCursor) (dev, pScreen, ac->elts[elt].pCursor);
-    as->DisplayCursor = pScreen->DisplayCursor;
-    pScreen->DisplayCursor = DisplayCursor;
+    DeviceIntPtr dev;
+    CARD32 soonest = ~(CARD32) 0;
+    Bool active = FALSE;
+
+    for (dev = inputInfo.devices; dev; dev = dev->next) {
+        ScreenPtr pScreen = dev->spriteInfo->anim.pScreen;
+        AnimCurScreenPtr as;
+        AnimCurPtr ac;
+        int elt;
+
+        if (!dev->spriteInfo->anim.pCursor || !pScreen)
+            continue;
+        if (!dev->spriteInfo->sprite ||
+            !IsAnimCur(dev->spriteInfo->sprite->current))
+            continue;
+
+        if ((INT32) (now - dev->spriteInfo->anim.time) >= 0) {
+            DisplayCursorProcPtr DisplayCursor = pScreen->DisplayCursor;
+
+            as = GetAnimCurScreen(pScreen);
+            ac = GetAnimCur(dev->spriteInfo->sprite->current);
+            elt = (dev->spriteInfo->anim.elt + 1) % ac->nelt;
+
+            /*
+             * Not a simple Unwrap/Wrap as this isn't called along the
+             * DisplayCursor wrapper chain.
+             */
+            pScreen->DisplayCursor = as->DisplayCursor;
+            (void) (*pScreen->DisplayCursor) (dev, pScreen,
+                                              ac->elts[elt].pCursor);
+            as->DisplayCursor = pScreen->DisplayCursor;
+            pScreen->DisplayCursor = DisplayCursor;
+
+            dev->spriteInfo->anim.elt = elt;
+            dev->spriteInfo->anim.pCursor = ac->elts[elt].pCursor;
+            dev->spriteInfo->anim.time = now + ac->elts[elt].delay;
+        }
 
-    dev->spriteInfo->anim.elt = elt;
-    dev->spriteInfo->anim.pCursor = ac->elts[elt].pCursor;
+        active = TRUE;
+        if (dev->spriteInfo->anim.time - now < soonest)
+            soonest = dev->spriteInfo->anim.time - now;
+    }
 
-    return ac->elts[elt].delay;
+    if (!active) {
+        /* returning 0 stops the timer; a device that stopped animating
+         * just leaves its fields cleared and lets this happen */
+        animCurArmed = FALSE;
+        return 0;
+    }
+    if (!soonest)
+        soonest = 1;
+    animCurNextTime = now + soonest;
+    return soonest;
 }
 
+/* pull the shared timer forward if this deadline is sooner than the one
+ * it is armed for */
 static void
-AnimCurCancelTimer(DeviceIntPtr pDev)
+AnimCurArm(CARD32 time)
 {
-    CursorPtr cur = pDev->spriteInfo->sprite ?
-                    pDev->spriteInfo->sprite->current : NULL;
-
-    if (IsAnimCur(cur))
-        TimerCancel(GetAnimCur(cur)->timer);
+    CARD32 now = GetTimeInMillis();
+
+    if (animCurArmed && (INT32) (time - animCurNextTime) >= 0)
+        return;
+    animCurTimer = TimerSet(animCurTimer, 0,
+                            (INT32) (time - now) > 0 ? time - now : 1,
+                            AnimCurTimerNotify, NULL);
+    animCurNextTime = time;
+    animCurArmed = TRUE;
 }
 
 static Bool
@@ -174,7 +218,6 @@ AnimCurDisplayCursor(DeviceIntPtr pDev, ScreenPtr pScreen, CursorPtr pCursor)
         if (pCursor != pDev->spriteInfo->sprite->current) {
             AnimCurPtr ac = GetAnimCur(pCursor);
 
-            AnimCurCancelTimer(pDev);
             ret = (*pScreen->DisplayCursor) (pDev, pScreen,
                                              ac->elts[0].pCursor);
 
@@ -182,14 +225,14 @@ AnimCurDisplayCursor(DeviceIntPtr pDev, ScreenPtr pScreen, CursorPtr pCursor)
                 pDev->spriteInfo->anim.elt = 0;
                 pDev->spriteInfo->anim.pCursor = pCursor;
                 pDev->spriteInfo->anim.pScreen = pScreen;
+                pDev->spriteInfo->anim.time =
+                    GetTimeInMillis() + ac->elts[0].delay;
 
-                ac->timer = TimerSet(ac->timer, 0, ac->elts[0].delay,
-                                     AnimCurTimerNotify, pDev);
+                AnimCurArm(pDev->spriteInfo->anim.time);
             }
         }
     }
     else {
-        AnimCurCancelTimer(pDev);
         pDev->spriteInfo->anim.pCursor = 0;
         pDev->spriteInfo->anim.pScreen = 0;
         ret = (*pScreen->DisplayCursor) (pDev, pScreen, pCursor);
@@ -334,15 +377,12 @@ AnimCursorCreate(CursorPtr *cursors, CARD32 *deltas, int ncursor,
     pCursor->id = cid;
 
     ac = GetAnimCur(pCursor);
-    ac->timer = TimerSet(NULL, 0, 0, AnimCurTimerNotify, NULL);
 
     /* security creation/labeling check */
-    if (ac->timer)
-        rc = XaceHookResourceAccess(client, cid, X11_RESTYPE_CURSOR, pCursor,
-                      X11_RESTYPE_NONE, NULL, DixCreateAccess);
+    rc = XaceHookResourceAccess(client, cid, X11_RESTYPE_CURSOR, pCursor,
+                  X11_RESTYPE_NONE, NULL, DixCreateAccess);
 
     if (rc != Success) {
-        TimerFree(ac->timer);
         dixFiniPrivates(pCursor, PRIVATE_CURSOR);
         free(pCursor);
         return rc;
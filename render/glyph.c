@@ -24,9 +24,10 @@
 
 #include <dix-config.h>
 
+#include "dix/cachestats_priv.h"
 #include "dix/screenint_priv.h"
 #include "os/bug_priv.h"
-#include "os/xsha1.h"
+#include "os/xsiphash.h"
 
 #include "misc.h"
 #include "scrnintstr.h"
@@ -81,6 +82,11 @@ static GlyphHashSetRec glyphHashSets[] = {
 
 static GlyphHashRec globalGlyphs[GlyphFormatNum];
 
+/* dedup effectiveness of the global glyph hash across all formats */
+static CacheStatsRec glyphCacheStats;
+
+static void MigrateGlyphHash(GlyphHashPtr hash, CARD32 chunk);
+
 void
 GlyphUninit(ScreenPtr pScreen)
 {
@@ -92,6 +98,7 @@ GlyphUninit(ScreenPtr pScreen)
         if (!globalGlyphs[fdepth].hashSet)
             continue;
 
+        MigrateGlyphHash(&globalGlyphs[fdepth], 0);
         for (i = 0; i < globalGlyphs[fdepth].hashSet->size; i++) {
             glyph = globalGlyphs[fdepth].table[i].glyph;
             if (glyph && glyph != DeletedGlyph) {
@@ -117,19 +124,14 @@ FindGlyphHashSet(CARD32 filled)
 }
 
 static GlyphRefPtr
-FindGlyphRef(GlyphHashPtr hash,
-             CARD32 signature, Bool match, unsigned char sha1[20])
+ProbeGlyphTable(GlyphRefPtr table, GlyphHashSetPtr hashSet,
+                CARD32 signature, Bool match, unsigned char sha1[20])
 {
     CARD32 elt, step, s;
     GlyphPtr glyph;
-    GlyphRefPtr table, gr, del;
+    GlyphRefPtr gr, del;
+    CARD32 tableSize = hashSet->size;
 
-    if ((hash == NULL) || (hash->hashSet == NULL))
-        return NULL;
-
-    CARD32 tableSize = hash->hashSet->size;
-
-    table = hash->table;
     elt = signature % tableSize;
     step = 0;
     del = 0;
@@ -153,7 +155,7 @@ FindGlyphRef(GlyphHashPtr hash,
             break;
         }
         if (!step) {
-            step = signature % hash->hashSet->rehash;
+            step = signature % hashSet->rehash;
             if (!step)
                 step = 1;
         }
@@ -164,25 +166,132 @@ FindGlyphRef(GlyphHashPtr hash,
     return gr;
 }
 
+static Bool
+GlyphRefMatches(GlyphRefPtr gr,
+                CARD32 signature, Bool match, unsigned char sha1[20])
+{
+    return gr->glyph && gr->glyph != DeletedGlyph &&
+        gr->signature == signature &&
+        (!match || memcmp(gr->glyph->sha1, sha1, 20) == 0);
+}
+
+/* Find the first free (or deleted) slot for a key known to be absent. */
+static GlyphRefPtr
+FreeGlyphSlot(GlyphRefPtr table, GlyphHashSetPtr hashSet, CARD32 signature)
+{
+    CARD32 elt, step;
+    GlyphRefPtr gr;
+    CARD32 tableSize = hashSet->size;
+
+    elt = signature % tableSize;
+    step = 0;
+    for (;;) {
+        gr = &table[elt];
+        if (!gr->glyph || gr->glyph == DeletedGlyph)
+            return gr;
+        if (!step) {
+            step = signature % hashSet->rehash;
+            if (!step)
+                step = 1;
+        }
+        elt += step;
+        if (elt >= tableSize)
+            elt -= tableSize;
+    }
+}
+
+/* Old-table slots drained per lookup while a rehash is pending; keeps
+ * resizes at a bounded cost per operation instead of one long stall
+ * when a browser dumps thousands of glyphs at once.
+ */
+#define GLYPH_MIGRATE_CHUNK 64
+
+static void
+MigrateGlyphHash(GlyphHashPtr hash, CARD32 chunk)
+{
+    CARD32 oldSize, i, limit;
+    GlyphRefPtr gr, slot;
+
+    if (!hash->oldTable)
+        return;
+
+    oldSize = hash->oldHashSet->size;
+    limit = chunk ? hash->migrated + chunk : oldSize;
+    if (limit > oldSize)
+        limit = oldSize;
+    for (i = hash->migrated; i < limit; i++) {
+        gr = &hash->oldTable[i];
+        if (gr->glyph && gr->glyph != DeletedGlyph) {
+            slot = FreeGlyphSlot(hash->table, hash->hashSet, gr->signature);
+            *slot = *gr;
+            /* leave a tombstone so probes for colliding keys still
+             * walk past this slot */
+            gr->glyph = DeletedGlyph;
+            gr->signature = 0;
+        }
+    }
+    hash->migrated = limit;
+    if (limit == oldSize) {
+        free(hash->oldTable);
+        hash->oldTable = NULL;
+        hash->oldHashSet = NULL;
+        hash->migrated = 0;
+    }
+}
+
+static GlyphRefPtr
+FindGlyphRef(GlyphHashPtr hash,
+             CARD32 signature, Bool match, unsigned char sha1[20])
+{
+    GlyphRefPtr gr, old;
+
+    if ((hash == NULL) || (hash->hashSet == NULL))
+        return NULL;
+
+    MigrateGlyphHash(hash, GLYPH_MIGRATE_CHUNK);
+
+    gr = ProbeGlyphTable(hash->table, hash->hashSet, signature, match, sha1);
+    if (GlyphRefMatches(gr, signature, match, sha1) || !hash->oldTable)
+        return gr;
+
+    old = ProbeGlyphTable(hash->oldTable, hash->oldHashSet,
+                          signature, match, sha1);
+    if (GlyphRefMatches(old, signature, match, sha1)) {
+        /* move it over now so the caller's slot is in the live table */
+        *gr = *old;
+        old->glyph = DeletedGlyph;
+        old->signature = 0;
+    }
+    return gr;
+}
+
 int
 HashGlyph(xGlyphInfo * gi,
           CARD8 *bits, unsigned long size, unsigned char sha1[20])
 {
-    void *ctx = x_sha1_init();
-    int success;
-
-    if (!ctx)
-        return BadAlloc;
-
-    success = x_sha1_update(ctx, gi, sizeof(xGlyphInfo));
-    if (!success)
-        return BadAlloc;
-    success = x_sha1_update(ctx, bits, size);
-    if (!success)
-        return BadAlloc;
-    success = x_sha1_final(ctx, sha1);
-    if (!success)
-        return BadAlloc;
+    /* Glyph identity used to be a SHA1 digest, which dominated the cost
+     * of uploading large glyph sets.  A keyed SipHash is much cheaper
+     * per byte and needs no per-glyph context allocation; keying it
+     * with random data drawn at first use keeps hostile clients from
+     * constructing colliding glyphs, since the key never leaves the
+     * server and identities only have to be stable within one server
+     * generation.  The digest field keeps its historical name and
+     * 20-byte size; the last four bytes are now zero.
+     */
+    static unsigned char glyphHashKey[16];
+    static Bool glyphHashKeyInitialized;
+    x_siphash_ctx ctx;
+
+    if (!glyphHashKeyInitialized) {
+        arc4random_buf(glyphHashKey, sizeof(glyphHashKey));
+        glyphHashKeyInitialized = TRUE;
+    }
+
+    x_siphash_init(&ctx, glyphHashKey);
+    x_siphash_update(&ctx, gi, sizeof(xGlyphInfo));
+    x_siphash_update(&ctx, bits, size);
+    memset(sha1, 0, 20);
+    x_siphash_final(&ctx, sha1);
     return Success;
 }
 
@@ -192,15 +301,23 @@ FindGlyphByHash(unsigned char sha1[20], int format)
     GlyphRefPtr gr;
     CARD32 signature = *(CARD32 *) sha1;
 
-    if (!globalGlyphs[format].hashSet)
+    CacheStatsRegister(&glyphCacheStats, "render-glyph");
+
+    if (!globalGlyphs[format].hashSet) {
+        CacheStatsMiss(&glyphCacheStats);
         return NULL;
+    }
 
     gr = FindGlyphRef(&globalGlyphs[format], signature, TRUE, sha1);
 
-    if (gr->glyph && gr->glyph != DeletedGlyph)
+    if (gr->glyph && gr->glyph != DeletedGlyph) {
+        CacheStatsHit(&glyphCacheStats);
         return gr->glyph;
-    else
+    }
+    else {
+        CacheStatsMiss(&glyphCacheStats);
         return NULL;
+    }
 }
 
 #ifdef CHECK_DUPLICATES
@@ -250,9 +367,11 @@ FreeGlyph(GlyphPtr glyph, int format)
     BUG_RETURN(glyph->refcnt == 0);
     if (--glyph->refcnt == 0) {
         GlyphRefPtr gr;
+        CARD32 signature;
+
+#ifdef CHECK_DUPLICATES
         int i;
         int first;
-        CARD32 signature;
 
         first = -1;
         for (i = 0; i < globalGlyphs[format].hashSet->size; i++)
@@ -261,15 +380,19 @@ FreeGlyph(GlyphPtr glyph, int format)
                     DuplicateRef(glyph, "FreeGlyph check");
                 first = i;
             }
+#endif
 
         signature = *(CARD32 *) glyph->sha1;
         gr = FindGlyphRef(&globalGlyphs[format], signature, TRUE, glyph->sha1);
+#ifdef CHECK_DUPLICATES
         if (gr - globalGlyphs[format].table != first)
             DuplicateRef(glyph, "Found wrong one");
+#endif
         if (gr && gr->glyph && gr->glyph != DeletedGlyph) {
             gr->glyph = DeletedGlyph;
             gr->signature = 0;
             globalGlyphs[format].tableEntries--;
+            CacheStatsEvict(&glyphCacheStats);
         }
 
         FreeGlyphPicture(glyph);
@@ -388,6 +511,9 @@ AllocateGlyphHash(GlyphHashPtr hash, GlyphHashSetPtr hashSet)
         return FALSE;
     hash->hashSet = hashSet;
     hash->tableEntries = 0;
+    hash->oldTable = NULL;
+    hash->oldHashSet = NULL;
+    hash->migrated = 0;
     return TRUE;
 }
 
@@ -396,12 +522,7 @@ ResizeGlyphHash(GlyphHashPtr hash, CARD32 change, Bool global)
 {
     CARD32 tableEntries;
     GlyphHashSetPtr hashSet;
-    GlyphHashRec newHash;
-    GlyphRefPtr gr;
-    GlyphPtr glyph;
-    int i;
-    int oldSize;
-    CARD32 s;
+    GlyphRefPtr newTable;
 
     tableEntries = hash->tableEntries + change;
     hashSet = FindGlyphHashSet(tableEntries);
@@ -409,26 +530,21 @@ ResizeGlyphHash(GlyphHashPtr hash, CARD32 change, Bool global)
         return TRUE;
     if (global)
         CheckDuplicates(hash, "ResizeGlyphHash top");
-    if (!AllocateGlyphHash(&newHash, hashSet))
+
+    /* at most one rehash can be in flight; drain any previous one
+     * before retiring the current table */
+    MigrateGlyphHash(hash, 0);
+
+    newTable = calloc(hashSet->size, sizeof(GlyphRefRec));
+    if (!newTable)
         return FALSE;
     if (hash->table) {
-        oldSize = hash->hashSet->size;
-        for (i = 0; i < oldSize; i++) {
-            glyph = hash->table[i].glyph;
-            if (glyph && glyph != DeletedGlyph) {
-                s = hash->table[i].signature;
-                if ((gr = FindGlyphRef(&newHash, s, global, glyph->sha1))) {
-                    gr->signature = s;
-                    gr->glyph = glyph;
-                }
-                ++newHash.tableEntries;
-            }
-        }
-        free(hash->table);
+        hash->oldTable = hash->table;
+        hash->oldHashSet = hash->hashSet;
+        hash->migrated = 0;
     }
-    *hash = newHash;
-    if (global)
-        CheckDuplicates(hash, "ResizeGlyphHash bottom");
+    hash->table = newTable;
+    hash->hashSet = hashSet;
     return TRUE;
 }
 
@@ -469,10 +585,14 @@ FreeGlyphSet(void *value, XID gid)
     GlyphSetPtr glyphSet = (GlyphSetPtr) value;
 
     if (--glyphSet->refcnt == 0) {
-        CARD32 i, tableSize = glyphSet->hash.hashSet->size;
-        GlyphRefPtr table = glyphSet->hash.table;
+        CARD32 i, tableSize;
+        GlyphRefPtr table;
         GlyphPtr glyph;
 
+        MigrateGlyphHash(&glyphSet->hash, 0);
+        tableSize = glyphSet->hash.hashSet->size;
+        table = glyphSet->hash.table;
+
         for (i = 0; i < tableSize; i++) {
             glyph = table[i].glyph;
             if (glyph && glyph != DeletedGlyph)
@@ -480,8 +600,12 @@ FreeGlyphSet(void *value, XID gid)
         }
         if (!globalGlyphs[glyphSet->fdepth].tableEntries) {
             free(globalGlyphs[glyphSet->fdepth].table);
+            free(globalGlyphs[glyphSet->fdepth].oldTable);
             globalGlyphs[glyphSet->fdepth].table = 0;
             globalGlyphs[glyphSet->fdepth].hashSet = 0;
+            globalGlyphs[glyphSet->fdepth].oldTable = 0;
+            globalGlyphs[glyphSet->fdepth].oldHashSet = 0;
+            globalGlyphs[glyphSet->fdepth].migrated = 0;
         }
         else
             ResizeGlyphHash(&globalGlyphs[glyphSet->fdepth], 0, TRUE);
@@ -33,6 +33,11 @@ typedef struct {
     GlyphRefPtr table;
     GlyphHashSetPtr hashSet;
     CARD32 tableEntries;
+    /* previous table while an incremental rehash is still draining;
+     * entries move over a chunk at a time on each lookup */
+    GlyphRefPtr oldTable;
+    GlyphHashSetPtr oldHashSet;
+    CARD32 migrated;
 } GlyphHashRec, *GlyphHashPtr;
 
 typedef struct {
@@ -70,10 +70,57 @@ xRenderTransform_from_PictTransform(xRenderTransform * render,
     render->matrix33 = pict->matrix[2][2];
 }
 
+int
+PictureTransformType(PictTransformPtr transform)
+{
+    if (!transform)
+        return PictTransformTypeIdentity;
+    if (transform->matrix[2][0] || transform->matrix[2][1] ||
+        transform->matrix[2][2] != pixman_fixed_1)
+        return PictTransformTypeGeneral;
+    if (transform->matrix[0][1] || transform->matrix[1][0])
+        return PictTransformTypeGeneral;
+    if (transform->matrix[0][0] != pixman_fixed_1 ||
+        transform->matrix[1][1] != pixman_fixed_1)
+        return PictTransformTypeScale;
+    return PictTransformTypeTranslate;
+}
+
+/* scale one coordinate, watching for fixed-point overflow the same way
+ * the generic pixman path does */
+static Bool
+transformScale1d(pixman_fixed_t scale, pixman_fixed_t off,
+                 pixman_fixed_48_16_t v, pixman_fixed_t *result)
+{
+    pixman_fixed_48_16_t t;
+
+    t = ((v * scale) >> 16) + off;
+    if (t != (pixman_fixed_t) t)
+        return FALSE;
+    *result = (pixman_fixed_t) t;
+    return TRUE;
+}
+
 Bool
 PictureTransformPoint(PictTransformPtr transform, PictVectorPtr vector)
 {
-    return pixman_transform_point(transform, vector);
+    switch (PictureTransformType(transform)) {
+    case PictTransformTypeIdentity:
+        return TRUE;
+    case PictTransformTypeTranslate:
+    case PictTransformTypeScale:
+        /* the generic path divides by w; only skip it for affine use */
+        if (vector->vector[2] == pixman_fixed_1)
+            return transformScale1d(transform->matrix[0][0],
+                                    transform->matrix[0][2],
+                                    vector->vector[0], &vector->vector[0]) &&
+                   transformScale1d(transform->matrix[1][1],
+                                    transform->matrix[1][2],
+                                    vector->vector[1], &vector->vector[1]);
+        /* fall through */
+    default:
+        return pixman_transform_point(transform, vector);
+    }
 }
 
 Bool
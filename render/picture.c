@@ -718,6 +718,7 @@ SetPictureToDefaults(PicturePtr pPicture)
     pPicture->clientClip = 0;
 
     pPicture->transform = 0;
+    pPicture->transformType = PictTransformTypeIdentity;
 
     pPicture->filter = PictureGetFilterId(FilterNearest, -1, TRUE);
     pPicture->filter_params = 0;
@@ -1331,6 +1332,7 @@ SetPictureTransform(PicturePtr pPicture, PictTransform * transform)
         free(pPicture->transform);
         pPicture->transform = NULL;
     }
+    pPicture->transformType = PictureTransformType(pPicture->transform);
     pPicture->serialNumber |= GC_CHANGE_SERIAL_BIT;
 
     if (pPicture->pDrawable != NULL) {
@@ -57,6 +57,12 @@ typedef struct _PictFormat {
 typedef struct pixman_vector PictVector, *PictVectorPtr;
 typedef struct pixman_transform PictTransform, *PictTransformPtr;
 
+/* transform classification, computed when the transform is set */
+#define PictTransformTypeIdentity   0   /* no transform */
+#define PictTransformTypeTranslate  1   /* pure translation */
+#define PictTransformTypeScale      2   /* axis-aligned scale + translation */
+#define PictTransformTypeGeneral    3
+
 #define SourcePictTypeSolidFill 0
 #define SourcePictTypeLinear 1
 #define SourcePictTypeRadial 2
@@ -134,7 +140,8 @@ typedef struct _Picture {
     unsigned int repeatType:2;
     unsigned int filter:3;
     unsigned int stateChanges:CPLastBit;
-    unsigned int unused:18 - CPLastBit;
+    unsigned int transformType:2;       /* PictTransformType* of 'transform' */
+    unsigned int unused:16 - CPLastBit;
 
     PicturePtr pNext;           /* chain on same drawable */
 
@@ -531,4 +538,7 @@ extern _X_EXPORT Bool
 extern _X_EXPORT Bool
  PictureTransformPoint3d(PictTransformPtr transform, PictVectorPtr vector);
 
+extern _X_EXPORT int
+ PictureTransformType(PictTransformPtr transform);
+
 #endif                          /* _PICTURESTR_H_ */
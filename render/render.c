@@ -1082,6 +1082,7 @@ SingleRenderCompositeGlyphs(ClientPtr client, xRenderCompositeGlyphsReq *stuff)
     GlyphPtr *glyphs, *glyphsBase;
     xGlyphElt *elt;
     CARD8 *buffer, *end;
+    char *arena;
     int nglyph;
     int nlist;
     int space;
@@ -1126,43 +1127,37 @@ SingleRenderCompositeGlyphs(ClientPtr client, xRenderCompositeGlyphsReq *stuff)
 
     buffer = (CARD8 *) (stuff + 1);
     end = (CARD8 *) stuff + (client->req_len << 2);
-    nglyph = 0;
-    nlist = 0;
-    while (buffer + sizeof(xGlyphElt) < end) {
-        elt = (xGlyphElt *) buffer;
-        buffer += sizeof(xGlyphElt);
 
-        if (elt->len == 0xff) {
-            buffer += 4;
-        }
-        else {
-            nlist++;
-            nglyph += elt->len;
-            space = size * elt->len;
-            if (space & 3)
-                space += 4 - (space & 3);
-            buffer += space;
-        }
-    }
-    if (nglyph <= NLOCALGLYPH)
+    /* Single pass over the wire data: bound the output arrays by what
+     * the request bytes could possibly encode, carve both out of one
+     * arena, then validate each elt's payload once up front so the
+     * glyph reads inside it need no per-glyph bounds checks.  The flat
+     * list/glyph arrays go to CompositeGlyphs unchanged - that layout
+     * is what both the fb and glamor glyph paths consume.
+     */
+    space = end - buffer;
+    if (space < 0)
+        return BadLength;
+    nglyph = space / size;
+    nlist = space / sizeof(xGlyphElt) + 1;
+
+    if (nglyph <= NLOCALGLYPH && nlist <= NLOCALDELTA) {
         glyphsBase = glyphsLocal;
-    else {
-        glyphsBase = calloc(nglyph, sizeof(GlyphPtr));
-        if (!glyphsBase)
-            return BadAlloc;
-    }
-    if (nlist <= NLOCALDELTA)
         listsBase = listsLocal;
+        arena = NULL;
+    }
     else {
-        listsBase = calloc(nlist, sizeof(GlyphListRec));
-        if (!listsBase) {
-            rc = BadAlloc;
-            goto bail;
-        }
+        arena = malloc(nglyph * sizeof(GlyphPtr) +
+                       nlist * sizeof(GlyphListRec));
+        if (!arena)
+            return BadAlloc;
+        glyphsBase = (GlyphPtr *) arena;
+        listsBase = (GlyphListPtr) (glyphsBase + nglyph);
     }
-    buffer = (CARD8 *) (stuff + 1);
+
     glyphs = glyphsBase;
     lists = listsBase;
+    nlist = 0;
     while (buffer + sizeof(xGlyphElt) < end) {
         elt = (xGlyphElt *) buffer;
         buffer += sizeof(xGlyphElt);
@@ -1179,42 +1174,43 @@ SingleRenderCompositeGlyphs(ClientPtr client, xRenderCompositeGlyphsReq *stuff)
             buffer += 4;
         }
         else {
+            space = size * elt->len;
+            if (space & 3)
+                space += 4 - (space & 3);
+            if (buffer + space > end) {
+                rc = BadLength;
+                goto bail;
+            }
+
             lists->xOff = elt->deltax;
             lists->yOff = elt->deltay;
             lists->format = glyphSet->format;
             lists->len = 0;
             n = elt->len;
             while (n--) {
-                if (buffer + size <= end) {
-                    switch (size) {
-                    case 1:
-                        glyph = *((CARD8 *) buffer);
-                        break;
-                    case 2:
-                        glyph = *((CARD16 *) buffer);
-                        break;
-                    case 4:
-                    default:
-                        glyph = *((CARD32 *) buffer);
-                        break;
-                    }
-                    if ((*glyphs = FindGlyph(glyphSet, glyph))) {
-                        lists->len++;
-                        glyphs++;
-                    }
+                switch (size) {
+                case 1:
+                    glyph = *((CARD8 *) buffer);
+                    break;
+                case 2:
+                    glyph = *((CARD16 *) buffer);
+                    break;
+                case 4:
+                default:
+                    glyph = *((CARD32 *) buffer);
+                    break;
+                }
+                if ((*glyphs = FindGlyph(glyphSet, glyph))) {
+                    lists->len++;
+                    glyphs++;
                 }
                 buffer += size;
             }
-            space = size * elt->len;
-            if (space & 3)
-                buffer += 4 - (space & 3);
+            buffer += space - size * elt->len;
             lists++;
+            nlist++;
         }
     }
-    if (buffer > end) {
-        rc = BadLength;
-        goto bail;
-    }
 
     CompositeGlyphs(stuff->op,
                     pSrc,
@@ -1224,10 +1220,7 @@ SingleRenderCompositeGlyphs(ClientPtr client, xRenderCompositeGlyphsReq *stuff)
     rc = Success;
 
  bail:
-    if (glyphsBase != glyphsLocal)
-        free(glyphsBase);
-    if (listsBase != listsLocal)
-        free(listsBase);
+    free(arena);
     return rc;
 }
 
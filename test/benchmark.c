@@ -0,0 +1,231 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * Micro-benchmarks for hot in-server kernels: region operations,
+ * fbBlt copy loops and the rpcbuf reply writer.
+ *
+ * Each benchmark is auto-calibrated to run long enough for a stable
+ * measurement and emits one machine-readable line on stdout:
+ *
+ *    BENCHMARK: <name> iters=<n> ns_per_op=<ns> mb_per_s=<rate>
+ *
+ * (mb_per_s is 0 for benchmarks without a meaningful byte count.)
+ * CI jobs can diff these numbers between commits to spot regressions;
+ * absolute values depend on the build machine and are not asserted on,
+ * so the binary always exits 0 unless a kernel misbehaves.
+ *
+ * End-to-end request dispatch and event delivery need a full server and
+ * remain covered by x11perf against Xvfb; these kernels are the pieces
+ * that can be measured hermetically in-process.
+ */
+
+/* Test relies on assert() */
+#undef NDEBUG
+
+#include <dix-config.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <X11/X.h>
+
+#include "dix/rpcbuf_priv.h"
+
+#include "misc.h"
+#include "regionstr.h"
+#include "fb.h"
+
+/* keep a run of the whole suite around a few seconds */
+#define BENCH_MIN_NSEC  (100 * 1000 * 1000)
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+typedef void (*benchfunc_t)(unsigned long iters);
+
+/* run `func` with growing iteration counts until it takes long enough
+   to measure, then report; `bytes_per_op` may be 0 */
+static void
+run_benchmark(const char *name, benchfunc_t func, size_t bytes_per_op)
+{
+    unsigned long iters = 1;
+    uint64_t elapsed;
+
+    for (;;) {
+        uint64_t start = now_ns();
+
+        func(iters);
+        elapsed = now_ns() - start;
+        if (elapsed >= BENCH_MIN_NSEC)
+            break;
+        iters *= 2;
+    }
+
+    double ns_per_op = (double) elapsed / iters;
+    double mb_per_s = 0.0;
+
+    if (bytes_per_op)
+        mb_per_s = ((double) bytes_per_op * iters * 1000.0) / elapsed;
+
+    printf("BENCHMARK: %s iters=%lu ns_per_op=%.2f mb_per_s=%.1f\n",
+           name, iters, ns_per_op, mb_per_s);
+}
+
+/* ---- region operations (dix/region.c) ---------------------------- */
+
+#define REGION_GRID  32         /* GRID x GRID disjoint boxes */
+
+static void
+make_grid_region(RegionPtr pReg, int offset)
+{
+    RegionInit(pReg, NullBox, 0);
+
+    for (int y = 0; y < REGION_GRID; y++) {
+        for (int x = 0; x < REGION_GRID; x++) {
+            BoxRec box = {
+                .x1 = x * 16 + offset,
+                .y1 = y * 16 + offset,
+                .x2 = x * 16 + offset + 8,
+                .y2 = y * 16 + offset + 8,
+            };
+            RegionRec tmp;
+
+            RegionInit(&tmp, &box, 1);
+            RegionUnion(pReg, pReg, &tmp);
+            RegionUninit(&tmp);
+        }
+    }
+}
+
+/* build a many-rectangle region box by box, the way damage tracking
+   accumulates it; one op is one full build */
+static void
+bench_region_union_grid(unsigned long iters)
+{
+    while (iters--) {
+        RegionRec reg;
+
+        make_grid_region(&reg, 0);
+        assert(RegionNumRects(&reg) == REGION_GRID * REGION_GRID);
+        RegionUninit(&reg);
+    }
+}
+
+static RegionRec bench_reg_a;
+static RegionRec bench_reg_b;
+
+static void
+bench_region_intersect(unsigned long iters)
+{
+    while (iters--) {
+        RegionRec res;
+
+        RegionInit(&res, NullBox, 0);
+        RegionIntersect(&res, &bench_reg_a, &bench_reg_b);
+        RegionUninit(&res);
+    }
+}
+
+/* ---- fbBlt copy kernels (fb/fbblt.c) ----------------------------- */
+
+#define BLT_WIDTH   1024        /* pixels, 32bpp */
+#define BLT_HEIGHT  256
+#define BLT_STRIDE  ((BLT_WIDTH * 32) / (8 * sizeof(FbBits)))
+
+static FbBits *blt_src;
+static FbBits *blt_dst;
+
+static void
+bench_fbblt_copy_aligned(unsigned long iters)
+{
+    while (iters--) {
+        fbBlt(blt_src, BLT_STRIDE, 0,
+              blt_dst, BLT_STRIDE, 0,
+              BLT_WIDTH * 32, BLT_HEIGHT, GXcopy, FB_ALLONES, 32,
+              FALSE, FALSE);
+    }
+}
+
+static void
+bench_fbblt_copy_shifted(unsigned long iters)
+{
+    /* source and destination at different pixel phases, so the copy
+       goes through the shifting loop instead of plain memcpy */
+    while (iters--) {
+        fbBlt(blt_src, BLT_STRIDE, 1 * 32,
+              blt_dst, BLT_STRIDE, 2 * 32,
+              (BLT_WIDTH - 4) * 32, BLT_HEIGHT, GXcopy, FB_ALLONES, 32,
+              FALSE, FALSE);
+    }
+}
+
+/* ---- rpcbuf reply writer (dix/rpcbuf.c) -------------------------- */
+
+#define RPCBUF_WORDS  4096      /* CARD32s per op */
+
+static void
+bench_rpcbuf_card32(unsigned long iters)
+{
+    x_rpcbuf_t rpcbuf = { 0 };
+
+    while (iters--) {
+        for (int i = 0; i < RPCBUF_WORDS; i++)
+            x_rpcbuf_write_CARD32(&rpcbuf, (CARD32) i);
+        assert(!rpcbuf.error);
+        x_rpcbuf_reset(&rpcbuf);
+    }
+    x_rpcbuf_clear(&rpcbuf);
+}
+
+static CARD32 rpcbuf_payload[RPCBUF_WORDS];
+
+static void
+bench_rpcbuf_card32s(unsigned long iters)
+{
+    x_rpcbuf_t rpcbuf = { 0 };
+
+    while (iters--) {
+        x_rpcbuf_write_CARD32s(&rpcbuf, rpcbuf_payload, RPCBUF_WORDS);
+        assert(!rpcbuf.error);
+        x_rpcbuf_reset(&rpcbuf);
+    }
+    x_rpcbuf_clear(&rpcbuf);
+}
+
+int
+main(int argc, char **argv)
+{
+    make_grid_region(&bench_reg_a, 0);
+    make_grid_region(&bench_reg_b, 4);
+
+    blt_src = calloc(BLT_HEIGHT, BLT_STRIDE * sizeof(FbBits));
+    blt_dst = calloc(BLT_HEIGHT, BLT_STRIDE * sizeof(FbBits));
+    assert(blt_src && blt_dst);
+
+    run_benchmark("region-union-grid", bench_region_union_grid, 0);
+    run_benchmark("region-intersect", bench_region_intersect, 0);
+    run_benchmark("fbblt-copy-aligned", bench_fbblt_copy_aligned,
+                  BLT_WIDTH * BLT_HEIGHT * 4);
+    run_benchmark("fbblt-copy-shifted", bench_fbblt_copy_shifted,
+                  (BLT_WIDTH - 4) * BLT_HEIGHT * 4);
+    run_benchmark("rpcbuf-card32", bench_rpcbuf_card32,
+                  RPCBUF_WORDS * 4);
+    run_benchmark("rpcbuf-card32s", bench_rpcbuf_card32s,
+                  RPCBUF_WORDS * 4);
+
+    free(blt_src);
+    free(blt_dst);
+    RegionUninit(&bench_reg_a);
+    RegionUninit(&bench_reg_b);
+
+    return 0;
+}
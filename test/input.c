@@ -288,7 +288,6 @@ dix_event_to_core(int type)
     ev.detail.key = 0;
     rc = EventToCore((InternalEvent *) &ev, &core, &count);
     test_event();
-    free(core);
 
     x = 1;
     y = 2;
@@ -296,7 +295,6 @@ dix_event_to_core(int type)
     ev.root_y = y;
     rc = EventToCore((InternalEvent *) &ev, &core, &count);
     test_event();
-    free(core);
 
     x = 0x7FFF;
     y = 0x7FFF;
@@ -304,7 +302,6 @@ dix_event_to_core(int type)
     ev.root_y = y;
     rc = EventToCore((InternalEvent *) &ev, &core, &count);
     test_event();
-    free(core);
 
     x = 0x8000;                 /* too high */
     y = 0x8000;                 /* too high */
@@ -316,7 +313,6 @@ dix_event_to_core(int type)
     assert(count == 1);
     assert(core->u.keyButtonPointer.rootX != x);
     assert(core->u.keyButtonPointer.rootY != y);
-    free(core);
 
     x = 0x7FFF;
     y = 0x7FFF;
@@ -326,19 +322,16 @@ dix_event_to_core(int type)
     ev.time = time;
     rc = EventToCore((InternalEvent *) &ev, &core, &count);
     test_event();
-    free(core);
 
     detail = 1;
     ev.detail.key = detail;
     rc = EventToCore((InternalEvent *) &ev, &core, &count);
     test_event();
-    free(core);
 
     detail = 0xFF;              /* highest value */
     ev.detail.key = detail;
     rc = EventToCore((InternalEvent *) &ev, &core, &count);
     test_event();
-    free(core);
 
     detail = 0xFFF;             /* too big */
     ev.detail.key = detail;
@@ -351,7 +344,6 @@ dix_event_to_core(int type)
     ev.corestate = state;
     rc = EventToCore((InternalEvent *) &ev, &core, &count);
     test_event();
-    free(core);
 
     state = 0x10000;            /* too big */
     ev.corestate = state;
@@ -361,7 +353,6 @@ dix_event_to_core(int type)
     assert(count == 1);
     assert(core->u.keyButtonPointer.state != state);
     assert(core->u.keyButtonPointer.state == (state & 0xFFFF));
-    free(core);
 
 #undef test_event
 }
@@ -432,7 +423,6 @@ _dix_test_xi_convert(DeviceEvent *ev, int expected_rc, int expected_count)
             assert(v->num_valuators <= 6);
         }
 
-        free(xi);
     }
 }
 
@@ -9,6 +9,7 @@ main(int argc, char **argv)
 {
     run_test(list_test);
     run_test(sha1_test);
+    run_test(siphash_test);
     run_test(string_test);
 
 #ifdef XORG_TESTS
@@ -30,6 +30,7 @@ const testfunc_t* list_test(void);
 const testfunc_t* misc_test(void);
 const testfunc_t* sha1_test(void);
 const testfunc_t* signal_logging_test(void);
+const testfunc_t* siphash_test(void);
 const testfunc_t* string_test(void);
 const testfunc_t* touch_test(void);
 const testfunc_t* xfree86_test(void);
@@ -154,7 +154,6 @@ test_XIRawEvent(RawDeviceEvent *in)
     XI2EventSwap((xGenericEvent *) out, (xGenericEvent *) swapped);
     test_values_XIRawEvent(in, swapped, TRUE);
 
-    free(out);
     free(swapped);
 }
 
@@ -411,7 +410,6 @@ test_XIDeviceEvent(DeviceEvent *in)
     XI2EventSwap((xGenericEvent *) out, (xGenericEvent *) swapped);
     test_values_XIDeviceEvent(in, swapped, TRUE);
 
-    free(out);
     free(swapped);
 }
 
@@ -764,7 +762,6 @@ test_XIDeviceChangedEvent(DeviceChangedEvent *in)
     XI2EventSwap((xGenericEvent *) out, (xGenericEvent *) swapped);
     test_values_XIDeviceChangedEvent(in, swapped, TRUE);
 
-    free(out);
     free(swapped);
 }
 
@@ -940,7 +937,6 @@ test_XITouchOwnershipEvent(TouchOwnershipEvent *in)
     swapped = calloc(1, sizeof(xEvent) + out->length * 4);
     XI2EventSwap((xGenericEvent *) out, (xGenericEvent *) swapped);
     test_values_XITouchOwnershipEvent(in, swapped, TRUE);
-    free(out);
     free(swapped);
 }
 
@@ -1052,7 +1048,6 @@ test_XIBarrierEvent(BarrierEvent *in)
     assert(memcmp(swapped, out, eventlen) == 0);
 
     free(swapped);
-    free(out);
 }
 
 static void
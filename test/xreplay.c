@@ -0,0 +1,332 @@
+/* SPDX-License-Identifier: MIT OR X11
+ *
+ * Replay a request stream captured with `Xorg -requestcapture <file>`
+ * (see dix/reqcapture.c) against a running server, at original pacing
+ * or at maximum speed:
+ *
+ *    xreplay [-display :N] [-max] <capture-file>
+ *
+ * One connection is opened per captured client slot.  XIDs that the
+ * captured client minted from its own resource id range are translated
+ * onto the replay connection's range by rewriting every 32-bit word in
+ * the request body whose high bits match the captured id base; that
+ * heuristic matches how clients actually use their id range, but can in
+ * principle rewrite a pixel value that happens to collide.  Requests
+ * from byte-swapped captured clients are skipped (and counted), since
+ * their bodies would need per-request swapping knowledge to translate.
+ *
+ * Replies and events are drained and discarded; the server must accept
+ * the connection without authorization (run it with -ac or use xhost).
+ * At the end one machine-readable line is printed:
+ *
+ *    REPLAY: requests=<n> skipped=<n> elapsed_ms=<ms> req_per_s=<rate>
+ */
+
+#include <dix-config.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <X11/X.h>
+#include <X11/Xproto.h>
+
+#include "dix/reqcapture_priv.h"
+
+#define MAX_CLIENT_SLOTS  (1 << 16)
+
+struct replay_conn {
+    int fd;                     /* -1 when not connected */
+    CARD32 myBase;              /* our resource id base on this connection */
+    CARD32 capBase;             /* captured client's resource id base */
+    CARD32 capMask;             /* captured client's resource id mask */
+    int swapped;                /* captured client was byte-swapped */
+};
+
+static struct replay_conn *conns[MAX_CLIENT_SLOTS];
+static const char *display_name;
+
+static uint64_t
+now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int
+write_all(int fd, const void *buf, size_t len)
+{
+    const char *p = buf;
+
+    while (len) {
+        ssize_t n = write(fd, p, len);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int
+read_all(int fd, void *buf, size_t len)
+{
+    char *p = buf;
+
+    while (len) {
+        ssize_t n = read(fd, p, len);
+
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* throw away whatever replies/events the server has queued for us */
+static void
+drain_fd(int fd)
+{
+    char scrap[8192];
+
+    while (recv(fd, scrap, sizeof(scrap), MSG_DONTWAIT) > 0)
+        ;
+}
+
+/* open a display connection the hard way and fetch our id base */
+static int
+connect_display(CARD32 *ridBase)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    int dpy = 0;
+    const char *colon = strrchr(display_name, ':');
+
+    if (colon)
+        dpy = atoi(colon + 1);
+    snprintf(addr.sun_path, sizeof(addr.sun_path),
+             "/tmp/.X11-unix/X%d", dpy);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0)
+        return -1;
+    if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0)
+        goto fail;
+
+    union { CARD32 v; char c[4]; } endian = { .v = 1 };
+    xConnClientPrefix prefix = {
+        .byteOrder = endian.c[0] ? 'l' : 'B',
+        .majorVersion = X_PROTOCOL,
+        .minorVersion = X_PROTOCOL_REVISION,
+    };
+    char pad[2] = { 0, 0 };
+
+    if (write_all(fd, &prefix, sizeof(prefix)) < 0 ||
+        write_all(fd, pad, sizeof(pad)) < 0)
+        goto fail;
+
+    xConnSetupPrefix setup_prefix;
+
+    if (read_all(fd, &setup_prefix, sizeof(setup_prefix)) < 0)
+        goto fail;
+    if (setup_prefix.success != 1) {
+        fprintf(stderr,
+                "xreplay: server refused the connection "
+                "(is it running with -ac?)\n");
+        goto fail;
+    }
+
+    size_t setuplen = setup_prefix.length * 4;
+    char *setupbuf = malloc(setuplen);
+
+    if (!setupbuf || read_all(fd, setupbuf, setuplen) < 0) {
+        free(setupbuf);
+        goto fail;
+    }
+
+    *ridBase = ((xConnSetup *) setupbuf)->ridBase;
+    free(setupbuf);
+    return fd;
+
+fail:
+    close(fd);
+    return -1;
+}
+
+/* translate XIDs minted from the captured client's id range onto ours */
+static void
+rewrite_xids(struct replay_conn *conn, char *buf, size_t len)
+{
+    xReq *req = (xReq *) buf;
+    /* skip the request header; with BigRequests (length == 0) the
+       extended length word follows it and must not be touched either */
+    size_t start = req->length ? 4 : 8;
+
+    for (size_t off = start; off + 4 <= len; off += 4) {
+        CARD32 word;
+
+        memcpy(&word, buf + off, 4);
+        if ((word & ~conn->capMask) == conn->capBase &&
+            (word & conn->capMask) != 0) {
+            word = conn->myBase | (word & conn->capMask);
+            memcpy(buf + off, &word, 4);
+        }
+    }
+}
+
+static void
+conn_close(int slot)
+{
+    if (conns[slot]) {
+        if (conns[slot]->fd >= 0)
+            close(conns[slot]->fd);
+        free(conns[slot]);
+        conns[slot] = NULL;
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *capname = NULL;
+    int max_speed = 0;
+
+    display_name = getenv("DISPLAY");
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-display") == 0 && i + 1 < argc)
+            display_name = argv[++i];
+        else if (strcmp(argv[i], "-max") == 0)
+            max_speed = 1;
+        else
+            capname = argv[i];
+    }
+    if (!capname || !display_name) {
+        fprintf(stderr,
+                "usage: xreplay [-display :N] [-max] <capture-file>\n");
+        return 1;
+    }
+
+    FILE *cap = fopen(capname, "rb");
+
+    if (!cap) {
+        fprintf(stderr, "xreplay: can't open %s\n", capname);
+        return 1;
+    }
+
+    xReqCapHeader hdr;
+
+    if (fread(&hdr, sizeof(hdr), 1, cap) != 1 ||
+        memcmp(hdr.magic, XREQCAP_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != XREQCAP_VERSION) {
+        fprintf(stderr, "xreplay: %s is not a capture file\n", capname);
+        return 1;
+    }
+
+    unsigned long requests = 0, skipped = 0;
+    uint64_t start = now_ms();
+    char *buf = NULL;
+    size_t bufsize = 0;
+    xReqCapRecord rec;
+
+    while (fread(&rec, sizeof(rec), 1, cap) == 1) {
+        if (rec.length > bufsize) {
+            bufsize = rec.length;
+            buf = realloc(buf, bufsize);
+            if (!buf) {
+                fprintf(stderr, "xreplay: out of memory\n");
+                return 1;
+            }
+        }
+        if (rec.length && fread(buf, rec.length, 1, cap) != 1) {
+            fprintf(stderr, "xreplay: truncated capture\n");
+            break;
+        }
+
+        if (!max_speed) {
+            uint64_t elapsed = now_ms() - start;
+
+            if (rec.delta_ms > elapsed)
+                usleep((rec.delta_ms - elapsed) * 1000);
+        }
+
+        struct replay_conn *conn = conns[rec.clientIndex];
+
+        switch (rec.type) {
+        case XREQCAP_REC_CLIENT_RUN:
+        {
+            xReqCapClientInfo *info = (xReqCapClientInfo *) buf;
+
+            conn_close(rec.clientIndex);
+            conn = calloc(1, sizeof(*conn));
+            if (!conn) {
+                fprintf(stderr, "xreplay: out of memory\n");
+                return 1;
+            }
+            conn->capBase = info->ridBase;
+            conn->capMask = info->ridMask;
+            conn->swapped = info->swapped;
+            conn->fd = conn->swapped ? -1 : connect_display(&conn->myBase);
+            if (!conn->swapped && conn->fd < 0) {
+                fprintf(stderr, "xreplay: can't connect to %s\n",
+                        display_name);
+                return 1;
+            }
+            conns[rec.clientIndex] = conn;
+            break;
+        }
+        case XREQCAP_REC_CLIENT_GONE:
+            conn_close(rec.clientIndex);
+            break;
+        case XREQCAP_REC_REQUEST:
+            if (!conn || conn->fd < 0) {
+                /* swapped client, or capture started mid-session */
+                skipped++;
+                break;
+            }
+            rewrite_xids(conn, buf, rec.length);
+            drain_fd(conn->fd);
+            if (write_all(conn->fd, buf, rec.length) < 0) {
+                fprintf(stderr, "xreplay: connection %u lost\n",
+                        rec.clientIndex);
+                conn_close(rec.clientIndex);
+                skipped++;
+                break;
+            }
+            requests++;
+            break;
+        }
+    }
+
+    /* let the last burst reach the server before tearing down */
+    for (int slot = 0; slot < MAX_CLIENT_SLOTS; slot++) {
+        if (conns[slot] && conns[slot]->fd >= 0)
+            drain_fd(conns[slot]->fd);
+        conn_close(slot);
+    }
+
+    uint64_t elapsed = now_ms() - start;
+
+    printf("REPLAY: requests=%lu skipped=%lu elapsed_ms=%llu req_per_s=%.0f\n",
+           requests, skipped, (unsigned long long) elapsed,
+           elapsed ? requests * 1000.0 / elapsed : 0.0);
+
+    free(buf);
+    fclose(cap);
+    return 0;
+}
@@ -339,8 +339,10 @@ XkbFreeKeyboard(XkbDescPtr xkb, unsigned which, Bool freeAll)
     }
     if (which & XkbControlsMask)
         XkbFreeControls(xkb, XkbAllControlsMask, TRUE);
-    if (freeAll)
+    if (freeAll) {
+        XkbKeymapContentForget(xkb);
         free(xkb);
+    }
     return;
 }
 
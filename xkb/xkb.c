@@ -1479,6 +1479,57 @@ static void XkbAssembleMap(ClientPtr client, XkbDescPtr xkb,
         XkbWriteVirtualModMap(xkb, rep.firstVModMapKey, rep.nVModMapKeys, rpcbuf);
 }
 
+/* Wire-format cache for XkbGetMap replies that request components in
+ * full (partial == 0), which is what every connecting client asks for.
+ * The reply body for a given keymap is identical across clients of the
+ * same byte order, so login storms would otherwise reserialize the same
+ * multi-KB map once per client.  Entries are keyed by the keymap's
+ * content id (see XkbKeymapContentId), so all devices sharing one
+ * layout answer from the same cached serialization. */
+typedef struct {
+    unsigned int    contentId;  /* 0 marks an empty slot */
+    CARD16          present;
+    Bool            swapped;
+    unsigned int    lastUsed;
+    xkbGetMapReply  rep;        /* as built, before byte-swapping */
+    char            *body;
+    size_t          len;
+} XkbGetMapCacheRec;
+
+#define XKB_GETMAP_CACHE_SIZE   8
+
+static XkbGetMapCacheRec xkbGetMapCache[XKB_GETMAP_CACHE_SIZE];
+static unsigned int xkbGetMapCacheClock;
+
+static XkbGetMapCacheRec *
+XkbGetMapCacheLookup(unsigned int contentId, CARD16 present, Bool swapped)
+{
+    for (int i = 0; i < XKB_GETMAP_CACHE_SIZE; i++) {
+        XkbGetMapCacheRec *entry = &xkbGetMapCache[i];
+
+        if (entry->contentId == contentId && entry->present == present &&
+            entry->swapped == swapped) {
+            entry->lastUsed = ++xkbGetMapCacheClock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static XkbGetMapCacheRec *
+XkbGetMapCacheEvict(void)
+{
+    XkbGetMapCacheRec *victim = &xkbGetMapCache[0];
+
+    for (int i = 1; i < XKB_GETMAP_CACHE_SIZE; i++) {
+        if (xkbGetMapCache[i].lastUsed < victim->lastUsed)
+            victim = &xkbGetMapCache[i];
+    }
+    free(victim->body);
+    victim->body = NULL;
+    return victim;
+}
+
 int
 ProcXkbGetMap(ClientPtr client)
 {
@@ -1503,6 +1554,30 @@ ProcXkbGetMap(ClientPtr client)
 
     XkbDescRec *xkb = dev->key->xkbInfo->desc;
 
+    unsigned int contentId = XkbKeymapContentId(xkb);
+    if (stuff->partial == 0) {
+        XkbGetMapCacheRec *hit = XkbGetMapCacheLookup(contentId, stuff->full,
+                                                      client->swapped);
+        if (hit) {
+            x_rpcbuf_t rpcbuf = { .swapped = client->swapped, .err_clear = TRUE };
+            void *body = x_rpcbuf_reserve(&rpcbuf, hit->len);
+
+            if (body) {
+                xkbGetMapReply cachedReply = hit->rep;
+
+                cachedReply.deviceID = dev->id;
+                memcpy(body, hit->body, hit->len);
+                if (client->swapped) {
+                    swaps(&cachedReply.present);
+                    swaps(&cachedReply.totalSyms);
+                    swaps(&cachedReply.totalActs);
+                }
+                return X_SEND_REPLY_WITH_RPCBUF(client, cachedReply, rpcbuf);
+            }
+            /* allocation failure: fall through to the regular path */
+        }
+    }
+
     xkbGetMapReply reply = {
         .deviceID = dev->id,
         .present = stuff->partial | stuff->full,
@@ -1600,6 +1675,23 @@ ProcXkbGetMap(ClientPtr client)
     if (rpcbuf.error)
         return BadAlloc;
 
+    if (stuff->partial == 0) {
+        XkbGetMapCacheRec *entry = XkbGetMapCacheEvict();
+
+        entry->body = malloc(rpcbuf.wpos);
+        if (entry->body) {
+            memcpy(entry->body, rpcbuf.buffer, rpcbuf.wpos);
+            entry->len = rpcbuf.wpos;
+            entry->contentId = contentId;
+            entry->present = stuff->full;
+            entry->swapped = client->swapped;
+            entry->lastUsed = ++xkbGetMapCacheClock;
+            entry->rep = reply;
+        }
+        else
+            entry->contentId = 0;
+    }
+
     if (client->swapped) {
         swaps(&reply.present);
         swaps(&reply.totalSyms);
@@ -2715,8 +2807,11 @@ _XkbSetMap(ClientPtr client, DeviceIntPtr dev, xkbSetMapReq * req, char *values)
     if (!sentNKN)
         XkbSendNotification(dev, &change, &cause);
 
+    XkbKeymapContentChanged(xkb);
+
     return Success;
  allocFailure:
+    XkbKeymapContentChanged(xkb);
     return BadAlloc;
 }
 
@@ -3087,6 +3182,8 @@ _XkbSetCompatMap(ClientPtr client, DeviceIntPtr dev,
                          &check, &cause);
         if (check)
             XkbCheckSecondaryEffects(xkbi, check, &change, &cause);
+        /* the recompute rewrote key actions served by XkbGetMap */
+        XkbKeymapContentChanged(xkb);
         XkbSendNotification(dev, &change, &cause);
     }
     return Success;
@@ -162,6 +162,52 @@ XkbGetKeyAction(XkbSrvInfoPtr xkbi, XkbStatePtr xkbState, CARD8 key)
     return fake;
 }
 
+/* Per-device cache of effective key actions.  XkbGetKeyAction resolves
+ * the group wrap and walks the key type's map on every key press, and
+ * _FixUpAction folds in the accessibility controls; none of that changes
+ * between presses unless the state (group or mods), the map contents or
+ * the relevant controls change, which key repeat and plain typing bursts
+ * never do.  Entries are filled lazily per key and the whole table is
+ * dropped when any input to the resolution changes. */
+typedef struct {
+    XkbDescPtr      xkb;
+    unsigned int    contentId;  /* see XkbKeymapContentId */
+    unsigned char   group;
+    unsigned char   mods;
+    unsigned int    enabledCtrls;
+    CARD16          axOptions;
+    unsigned char   valid[XkbMaxLegalKeyCode + 1];
+    XkbAction       acts[XkbMaxLegalKeyCode + 1];
+} XkbKeyActionCacheRec;
+
+static XkbKeyActionCacheRec xkbKeyActionCache[MAXDEVICES];
+
+static XkbAction
+XkbCachedKeyAction(DeviceIntPtr kbd, XkbSrvInfoPtr xkbi, CARD8 key)
+{
+    XkbKeyActionCacheRec *cache = &xkbKeyActionCache[kbd->id];
+    XkbDescPtr xkb = xkbi->desc;
+    unsigned int contentId = XkbKeymapContentId(xkb);
+
+    if (cache->xkb != xkb || cache->contentId != contentId ||
+        cache->group != xkbi->state.group || cache->mods != xkbi->state.mods ||
+        cache->enabledCtrls != xkb->ctrls->enabled_ctrls ||
+        cache->axOptions != xkb->ctrls->ax_options) {
+        memset(cache->valid, 0, sizeof(cache->valid));
+        cache->xkb = xkb;
+        cache->contentId = contentId;
+        cache->group = xkbi->state.group;
+        cache->mods = xkbi->state.mods;
+        cache->enabledCtrls = xkb->ctrls->enabled_ctrls;
+        cache->axOptions = xkb->ctrls->ax_options;
+    }
+    if (!cache->valid[key]) {
+        cache->acts[key] = XkbGetKeyAction(xkbi, &xkbi->state, key);
+        cache->valid[key] = 1;
+    }
+    return cache->acts[key];
+}
+
 static XkbAction
 XkbGetButtonAction(DeviceIntPtr kbd, DeviceIntPtr dev, int button)
 {
@@ -1379,7 +1425,7 @@ XkbHandleActions(DeviceIntPtr dev, DeviceIntPtr kbd, DeviceEvent *event)
             if (kbd->ignoreXkbActionsBehaviors)
                 act.type = XkbSA_NoAction;
             else
-                act = XkbGetKeyAction(xkbi, &xkbi->state, key);
+                act = XkbCachedKeyAction(kbd, xkbi, key);
         } else {
             act = XkbGetButtonAction(kbd, dev, key);
             key |= BTN_ACT_FLAG;
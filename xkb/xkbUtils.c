@@ -58,6 +58,7 @@ DEALINGS IN THE SOFTWARE.
 #define	XK_CYRILLIC
 #include <X11/keysym.h>
 
+#include "dix/dix_priv.h"
 #include "dix/input_priv.h"
 #include "os/log_priv.h"
 #include "xkb/xkbsrv_priv.h"
@@ -589,6 +590,8 @@ XkbApplyMappingChange(DeviceIntPtr kbd, KeySymsPtr map, KeyCode first_key,
             XkbCheckSecondaryEffects(kbd->key->xkbInfo, 1, &changes, &cause);
     }
 
+    XkbKeymapContentChanged(xkb);
+
     XkbSendNotification(kbd, &changes, &cause);
 }
 
@@ -599,6 +602,7 @@ XkbDisableComputedAutoRepeats(DeviceIntPtr dev, unsigned key)
     xkbMapNotify mn;
 
     xkbi->desc->server->explicit[key] |= XkbExplicitAutoRepeatMask;
+    XkbKeymapContentChanged(xkbi->desc);
     memset(&mn, 0, sizeof(mn));
     mn.changed = XkbExplicitComponentsMask;
     mn.firstKeyExplicit = key;
@@ -713,15 +717,21 @@ XkbComputeDerivedState(XkbSrvInfoPtr xkbi)
     XkbStatePtr state = &xkbi->state;
     XkbControlsPtr ctrls = xkbi->desc->ctrls;
     unsigned char grp;
+    unsigned char oldGrabMods;
 
     if (!state || !ctrls)
         return;
 
+    oldGrabMods = state->grab_mods;
     state->mods = (state->base_mods | state->latched_mods | state->locked_mods);
     state->lookup_mods = state->mods & (~ctrls->internal.mask);
     state->grab_mods = state->lookup_mods & (~ctrls->ignore_lock.mask);
     state->grab_mods |=
         ((state->base_mods | state->latched_mods) & ctrls->ignore_lock.mask);
+    /* passive grab matching keys off grab_mods; drop the memoized
+       no-grab decision when it moves */
+    if (state->grab_mods != oldGrabMods)
+        dixPassiveGrabGeneration++;
 
     grp = state->locked_group;
     if (grp >= ctrls->num_groups)
@@ -1975,6 +1985,66 @@ _XkbCopyControls(XkbDescPtr src, XkbDescPtr dst)
  *
  */
 
+/* Content tags for keymaps.  Devices that received their keymap from the
+ * same source via XkbCopyKeymap carry the same tag id, and modifying a
+ * keymap in place assigns it a fresh id, so equal ids mean equal map
+ * contents.  The GetMap wire cache in xkb.c keys on the id, letting a
+ * fleet of hotplugged devices with one shared layout answer from a
+ * single cached serialization.  The table is keyed by descriptor
+ * pointer; descriptors are untagged when XkbFreeKeyboard releases them,
+ * and running out of slots only costs a fresh id (a cache miss). */
+typedef struct {
+    XkbDescPtr      xkb;
+    unsigned int    id;
+} XkbContentTagRec;
+
+#define XKB_NUM_CONTENT_TAGS    (2 * MAXDEVICES)
+
+static XkbContentTagRec xkbContentTags[XKB_NUM_CONTENT_TAGS];
+static unsigned int xkbNextContentId = 1;
+static unsigned int xkbContentTagClock;
+
+static XkbContentTagRec *
+XkbFindContentTag(XkbDescPtr xkb)
+{
+    XkbContentTagRec *spare = NULL;
+
+    for (int i = 0; i < XKB_NUM_CONTENT_TAGS; i++) {
+        if (xkbContentTags[i].xkb == xkb)
+            return &xkbContentTags[i];
+        if (!spare && !xkbContentTags[i].xkb)
+            spare = &xkbContentTags[i];
+    }
+    if (!spare)
+        spare = &xkbContentTags[xkbContentTagClock++ % XKB_NUM_CONTENT_TAGS];
+    spare->xkb = xkb;
+    spare->id = xkbNextContentId++;
+    return spare;
+}
+
+unsigned int
+XkbKeymapContentId(XkbDescPtr xkb)
+{
+    return XkbFindContentTag(xkb)->id;
+}
+
+void
+XkbKeymapContentChanged(XkbDescPtr xkb)
+{
+    XkbFindContentTag(xkb)->id = xkbNextContentId++;
+}
+
+void
+XkbKeymapContentForget(XkbDescPtr xkb)
+{
+    for (int i = 0; i < XKB_NUM_CONTENT_TAGS; i++) {
+        if (xkbContentTags[i].xkb == xkb) {
+            xkbContentTags[i].xkb = NULL;
+            return;
+        }
+    }
+}
+
 Bool
 XkbCopyKeymap(XkbDescPtr dst, XkbDescPtr src)
 {
@@ -2019,6 +2089,9 @@ XkbCopyKeymap(XkbDescPtr dst, XkbDescPtr src)
     dst->min_key_code = src->min_key_code;
     dst->max_key_code = src->max_key_code;
 
+    /* dst now carries the same map contents as src */
+    XkbFindContentTag(dst)->id = XkbKeymapContentId(src);
+
     return TRUE;
 }
 
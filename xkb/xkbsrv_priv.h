@@ -108,6 +108,14 @@ void XkbPushLockedStateToSlaves(DeviceIntPtr master, int evtype, int key);
 
 Bool XkbCopyKeymap(XkbDescPtr dst, XkbDescPtr src);
 
+/* Content tags for keymaps: descriptors copied from the same source via
+ * XkbCopyKeymap share one id, an in-place modification assigns a fresh
+ * one, so equal ids mean equal map contents.  Used to share cached
+ * XkbGetMap wire replies across devices with the same layout. */
+unsigned int XkbKeymapContentId(XkbDescPtr xkb);
+void XkbKeymapContentChanged(XkbDescPtr xkb);
+void XkbKeymapContentForget(XkbDescPtr xkb);
+
 void XkbFilterEvents(ClientPtr pClient, int nEvents, xEvent *xE);
 
 int XkbGetEffectiveGroup(XkbSrvInfoPtr xkbi, XkbStatePtr xkbstate, CARD8 keycode);